@@ -50,6 +50,11 @@ ODE_API void dRandSetSeed (unsigned long s);
  */
 ODE_API int dRandInt (int n);
 
+/* same as dRandInt, but advances the given seed instead of the global one,
+ * so that every world can own its random sequence.
+ */
+ODE_API int dRandIntSeeded (unsigned long *seed, int n);
+
 /* return a random real number between 0..1 */
 ODE_API dReal dRandReal(void);
 
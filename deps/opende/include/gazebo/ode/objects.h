@@ -115,6 +115,13 @@ ODE_API void dWorldSetIslandThreads (dWorldID, int num_island_threads);
  */
 ODE_API void dWorldSetQuickStepThreads (dWorldID, int num_quickstep_threads);
 
+/**
+ * @brief Get the number of thread pool threads for quickstep
+ *
+ * @ingroup world
+ */
+ODE_API int dWorldGetQuickStepThreads (dWorldID);
+
 /**
  * @brief Get the gravity vector for a given world.
  * @ingroup world
@@ -587,6 +594,36 @@ ODE_API dReal dWorldGetQuickStepContactSORScalingFactor (dWorldID);
  */
 ODE_API bool dWorldGetQuickStepThreadPositionCorrection (dWorldID);
 
+/**
+ * @brief Get option to solve constraint rows in parallel by graph color.
+ * see dWorldSetQuickStepColoredRows for details.
+ * @ingroup world
+ */
+ODE_API bool dWorldGetQuickStepColoredRows (dWorldID);
+
+/**
+ * @brief Get option to use SIMD row kernels in the colored solver.
+ * see dWorldSetQuickStepVectorizedRows for details.
+ * @ingroup world
+ */
+ODE_API bool dWorldGetQuickStepVectorizedRows (dWorldID);
+
+/**
+ * @brief Get option to keep SIMD row kernels bitwise identical to the
+ * scalar row update.
+ * see dWorldSetQuickStepDeterministicRows for details.
+ * @ingroup world
+ */
+ODE_API bool dWorldGetQuickStepDeterministicRows (dWorldID);
+
+/**
+ * @brief Get the name of the row kernels selected for this CPU with the
+ * current options, e.g. "sse2", "avx", "avx_fma", or "none" when rows are
+ * updated one at a time.
+ * @ingroup world
+ */
+ODE_API const char *dWorldGetQuickStepRowKernels (dWorldID);
+
 /**
  * @brief Get option to turn on experimental row reordering.
  * see dWorldGetQuickStepExperimentalRowReordering for details.
@@ -600,6 +637,12 @@ ODE_API bool dWorldGetQuickStepExperimentalRowReordering (dWorldID);
  */
 ODE_API dReal dWorldGetQuickStepWarmStartFactor (dWorldID);
 
+/**
+ * @brief Get the seed of the QuickStep random row reordering.
+ * @ingroup world
+ */
+ODE_API unsigned long dWorldGetQuickStepRandSeed (dWorldID);
+
 /**
  * @brief Get extra friction constraint iterations within each time step.
  * @ingroup world
@@ -646,6 +689,48 @@ ODE_API void dWorldSetQuickStepContactSORScalingFactor (dWorldID, dReal contact_
  */
 ODE_API void dWorldSetQuickStepThreadPositionCorrection (dWorldID, bool thread);
 
+/**
+ * @brief Solve the PGS constraint rows by graph color.
+ * Rows are grouped into colors such that no two rows of a color act on
+ * the same body. Colors are swept in sequence and the rows of a color
+ * are split into fixed size blocks that run on the quickstep thread
+ * pool (see dWorldSetQuickStepThreads). The block layout and the order
+ * in which block results are reduced do not depend on the number of
+ * threads, so the solution is bitwise identical for any thread count.
+ * The sweep order differs from the default solver, so results are not
+ * identical to those obtained with colored rows turned off.
+ * Cone friction, which couples neighboring friction rows, always uses
+ * the default solver.
+ * @ingroup world
+ * @param colored set to true to solve rows by graph color
+ */
+ODE_API void dWorldSetQuickStepColoredRows (dWorldID, bool colored);
+
+/**
+ * @brief Use SIMD row kernels in the colored solver.
+ * The rows of a color are packed by groups of four, the kernels compute
+ * J*caccel and apply the caccel update of a whole group at once. Kernels
+ * are selected at run time from the instruction sets of the CPU (SSE2,
+ * AVX, FMA, NEON). Only used with dWorldSetQuickStepColoredRows; the
+ * default solver updates rows strictly in sequence. The row update is
+ * mostly bound by memory accesses to caccel, so the gain depends on the
+ * CPU and the size of the islands. Disabled by default.
+ * @ingroup world
+ * @param vectorized set to true to use the SIMD row kernels
+ */
+ODE_API void dWorldSetQuickStepVectorizedRows (dWorldID, bool vectorized);
+
+/**
+ * @brief Restrict the SIMD row kernels to ones that give bitwise the same
+ * result as the scalar row update, i.e. that add up products in the same
+ * order and do not use fused multiply-add. When false, faster kernels may
+ * be selected and results then depend on the CPU. Enabled by default.
+ * @ingroup world
+ * @param deterministic set to true for results identical to scalar code
+ */
+ODE_API void dWorldSetQuickStepDeterministicRows (dWorldID,
+  bool deterministic);
+
 /**
  * @brief Turn on experimental row reordering, so within one sweep,
  * following ordering of constraints are used:
@@ -669,6 +754,16 @@ ODE_API void dWorldSetQuickStepExperimentalRowReordering (dWorldID, bool order);
  */
 ODE_API void dWorldSetQuickStepWarmStartFactor (dWorldID, dReal warm);
 
+/**
+ * @brief Set the seed of the QuickStep random row reordering.
+ * @ingroup world
+ * @remarks
+ * Every world owns its seed, unlike dRandSetSeed, so that worlds stepped
+ * in parallel replay the same way as on their own.
+ * @param seed The default is 0.
+ */
+ODE_API void dWorldSetQuickStepRandSeed (dWorldID, unsigned long seed);
+
 /**
  * @brief Set extra friction constraint iterations within each time step,
  * to be done after initial sweeps.
@@ -1396,6 +1491,32 @@ ODE_API const dReal * dBodyGetForce (dBodyID);
  */
 ODE_API const dReal * dBodyGetTorque (dBodyID);
 
+/**
+ * @brief Number of values written by dBodyGetState.
+ * @ingroup bodies
+ */
+#define dBODY_STATE_SIZE 34
+
+/**
+ * @brief Copy the complete dynamic state of a body: position, quaternion,
+ * rotation matrix, linear and angular velocity, force and torque
+ * accumulators, auto-disable counters and enabled flag.
+ * @remarks
+ * Unlike the individual setters, dBodySetState restores the values
+ * exactly, without normalizing the orientation, so that a simulation
+ * resumed from a saved state is bit-identical to the original run.
+ * @param state array of dBODY_STATE_SIZE reals.
+ * @ingroup bodies
+ */
+ODE_API void dBodyGetState (dBodyID, dReal *state);
+
+/**
+ * @brief Restore a state written by dBodyGetState.
+ * @param state array of dBODY_STATE_SIZE reals.
+ * @ingroup bodies
+ */
+ODE_API void dBodySetState (dBodyID, const dReal *state);
+
 /**
  * @brief Set the body force accumulation vector.
  * @remarks
@@ -2131,6 +2252,27 @@ ODE_API void dJointSetFeedback (dJointID, dJointFeedback *);
  */
 ODE_API dJointFeedback *dJointGetFeedback (dJointID);
 
+/**
+ * @brief Number of values written by dJointGetWarmStart.
+ * @ingroup joints
+ */
+#define dJOINT_WARM_START_SIZE 12
+
+/**
+ * @brief Copy the constraint impulses of the last step, which quickstep
+ * uses to warm start the next one.
+ * @param lambda array of dJOINT_WARM_START_SIZE reals.
+ * @ingroup joints
+ */
+ODE_API void dJointGetWarmStart (dJointID, dReal *lambda);
+
+/**
+ * @brief Restore impulses written by dJointGetWarmStart.
+ * @param lambda array of dJOINT_WARM_START_SIZE reals.
+ * @ingroup joints
+ */
+ODE_API void dJointSetWarmStart (dJointID, const dReal *lambda);
+
 /**
  * @brief Set the joint anchor point.
  * @ingroup joints
@@ -64,12 +64,19 @@ int dTestRand()
 
 // adam's all-int straightforward(?) dRandInt (0..n-1)
 int dRandInt (int n)
+{
+  return dRandIntSeeded (&seed, n);
+}
+
+
+int dRandIntSeeded (unsigned long *s, int n)
 {
   // seems good; xor-fold and modulus
   const unsigned long un = n;
   // Since there is no memory barrier macro in ODE assign via volatile variable 
   // to prevent compiler reusing seed as value of `r'
-  volatile unsigned long raw_r = dRand();
+  *s = (1664525UL*(*s) + 1013904223UL) & 0xffffffff;
+  volatile unsigned long raw_r = *s;
   unsigned long r = raw_r;
   
   // note: probably more aggressive than it needs to be -- might be
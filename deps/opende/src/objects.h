@@ -120,9 +120,13 @@ struct dxQuickStepParameters {
   dReal smooth_contacts;  // control quickstep smoothing for contact solution.
   dReal contact_sor_scale;  // sor scaling factor for contacts only
   bool thread_position_correction;  // threaded position correction computations
+  bool colored_rows;  // solve rows in parallel by graph color
+  bool vectorized_rows;  // use SIMD row kernels in the colored solver
+  bool deterministic_rows;  // SIMD row kernels match the scalar code
   bool row_reorder1;  // control quickstep row reordering
   dReal warm_start;  // warm start factor, 0: no warm start, 1: full warm start
   int friction_iterations;  // extra quickstep iterations friction.
+  unsigned long rand_seed;  // seed of the random row reordering
   Friction_Model friction_model;  // friction model, enum type Friction_Model
   World_Solver_Type world_solver_type;  // world step solver, enum type World_Solver_Type.
 };
@@ -37,6 +37,7 @@
 #include "joints/joints.h"
 #include "step.h"
 #include "quickstep.h"
+#include "quickstep_row_kernels.h"
 #include "util.h"
 #include "odetls.h"
 #include "robuststep.h"
@@ -691,6 +692,45 @@ const dReal * dBodyGetTorque (dBodyID b)
 }
 
 
+void dBodyGetState (dBodyID b, dReal *state)
+{
+  dAASSERT (b && state);
+  memcpy (state, b->posr.pos, 3 * sizeof(dReal));
+  memcpy (state + 3, b->q, 4 * sizeof(dReal));
+  memcpy (state + 7, b->posr.R, 12 * sizeof(dReal));
+  memcpy (state + 19, b->lvel, 3 * sizeof(dReal));
+  memcpy (state + 22, b->avel, 3 * sizeof(dReal));
+  memcpy (state + 25, b->facc, 3 * sizeof(dReal));
+  memcpy (state + 28, b->tacc, 3 * sizeof(dReal));
+  state[31] = b->adis_timeleft;
+  state[32] = (dReal) b->adis_stepsleft;
+  state[33] = (b->flags & dxBodyDisabled) ? 1 : 0;
+}
+
+
+void dBodySetState (dBodyID b, const dReal *state)
+{
+  dAASSERT (b && state);
+  memcpy (b->posr.pos, state, 3 * sizeof(dReal));
+  memcpy (b->q, state + 3, 4 * sizeof(dReal));
+  memcpy (b->posr.R, state + 7, 12 * sizeof(dReal));
+  memcpy (b->lvel, state + 19, 3 * sizeof(dReal));
+  memcpy (b->avel, state + 22, 3 * sizeof(dReal));
+  memcpy (b->facc, state + 25, 3 * sizeof(dReal));
+  memcpy (b->tacc, state + 28, 3 * sizeof(dReal));
+  b->adis_timeleft = state[31];
+  b->adis_stepsleft = (int) state[32];
+  if (state[33] != 0)
+    b->flags |= dxBodyDisabled;
+  else
+    b->flags &= ~dxBodyDisabled;
+
+  // notify all attached geoms that this body has moved
+  for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
+    dGeomMoved (geom);
+}
+
+
 void dBodySetForce (dBodyID b, dReal x, dReal y, dReal z)
 {
   dAASSERT (b);
@@ -1543,6 +1583,22 @@ dJointFeedback *dJointGetFeedback (dxJoint *joint)
 }
 
 
+void dJointGetWarmStart (dxJoint *joint, dReal *lambda)
+{
+  dAASSERT (joint && lambda);
+  memcpy (lambda, joint->lambda, 6 * sizeof(dReal));
+  memcpy (lambda + 6, joint->lambda_erp, 6 * sizeof(dReal));
+}
+
+
+void dJointSetWarmStart (dxJoint *joint, const dReal *lambda)
+{
+  dAASSERT (joint && lambda);
+  memcpy (joint->lambda, lambda, 6 * sizeof(dReal));
+  memcpy (joint->lambda_erp, lambda + 6, 6 * sizeof(dReal));
+}
+
+
 
 dJointID dConnectingJoint (dBodyID in_b1, dBodyID in_b2)
 {
@@ -1666,9 +1722,13 @@ dxWorld * dWorldCreate()
   w->qs.smooth_contacts = 0.01;
   w->qs.contact_sor_scale = 0.25;
   w->qs.thread_position_correction = false;
+  w->qs.colored_rows = false;
+  w->qs.vectorized_rows = false;
+  w->qs.deterministic_rows = true;
   w->qs.row_reorder1 = true;
   w->qs.warm_start = 0.5;
   w->qs.friction_iterations = 10;
+  w->qs.rand_seed = 0;
   w->qs.friction_model = pyramid_friction;
   w->qs.world_solver_type = ODE_DEFAULT;
 
@@ -1806,6 +1866,16 @@ void dWorldSetQuickStepThreads (dWorldID w, int num_quickstep_threads)
   }
 }
 
+int dWorldGetQuickStepThreads (dWorldID w)
+{
+  dAASSERT (w);
+  if (!w->row_threadpool) {
+    return 0;
+  }
+  // else
+  return w->row_threadpool->size();
+}
+
 void dWorldGetGravity (dWorldID w, dVector3 g)
 {
   dAASSERT (w);
@@ -2307,6 +2377,34 @@ bool  dWorldGetQuickStepThreadPositionCorrection (dWorldID w)
   return w->qs.thread_position_correction;
 }
 
+bool  dWorldGetQuickStepColoredRows (dWorldID w)
+{
+  dAASSERT(w);
+  return w->qs.colored_rows;
+}
+
+bool  dWorldGetQuickStepVectorizedRows (dWorldID w)
+{
+  dAASSERT(w);
+  return w->qs.vectorized_rows;
+}
+
+bool  dWorldGetQuickStepDeterministicRows (dWorldID w)
+{
+  dAASSERT(w);
+  return w->qs.deterministic_rows;
+}
+
+const char *dWorldGetQuickStepRowKernels (dWorldID w)
+{
+  dAASSERT(w);
+  if (!w->qs.vectorized_rows)
+    return "none";
+  const ode::quickstep::dxRowKernels *kernels =
+    ode::quickstep::GetRowKernels(w->qs.deterministic_rows);
+  return kernels ? kernels->name : "none";
+}
+
 bool  dWorldGetQuickStepExperimentalRowReordering (dWorldID w)
 {
   dAASSERT(w);
@@ -2319,6 +2417,12 @@ dReal  dWorldGetQuickStepWarmStartFactor (dWorldID w)
   return w->qs.warm_start;
 }
 
+unsigned long dWorldGetQuickStepRandSeed (dWorldID w)
+{
+  dAASSERT(w);
+  return w->qs.rand_seed;
+}
+
 int  dWorldGetQuickStepExtraFrictionIterations (dWorldID w)
 {
   dAASSERT(w);
@@ -2361,6 +2465,24 @@ void dWorldSetQuickStepThreadPositionCorrection (dWorldID w, bool thread)
   w->qs.thread_position_correction = thread;
 }
 
+void dWorldSetQuickStepColoredRows (dWorldID w, bool colored)
+{
+  dAASSERT(w);
+  w->qs.colored_rows = colored;
+}
+
+void dWorldSetQuickStepVectorizedRows (dWorldID w, bool vectorized)
+{
+  dAASSERT(w);
+  w->qs.vectorized_rows = vectorized;
+}
+
+void dWorldSetQuickStepDeterministicRows (dWorldID w, bool deterministic)
+{
+  dAASSERT(w);
+  w->qs.deterministic_rows = deterministic;
+}
+
 void dWorldSetQuickStepExperimentalRowReordering (dWorldID w, bool order)
 {
   dAASSERT(w);
@@ -2373,6 +2495,12 @@ void dWorldSetQuickStepWarmStartFactor (dWorldID w, dReal warm)
   w->qs.warm_start = warm;
 }
 
+void dWorldSetQuickStepRandSeed (dWorldID w, unsigned long seed)
+{
+  dAASSERT(w);
+  w->qs.rand_seed = seed;
+}
+
 void dWorldSetQuickStepExtraFrictionIterations (dWorldID w, int iters)
 {
   dAASSERT(w);
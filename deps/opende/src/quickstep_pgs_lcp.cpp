@@ -40,6 +40,7 @@
 
 #include "quickstep_util.h"
 #include "quickstep_pgs_lcp.h"
+#include "quickstep_row_kernels.h"
 #ifndef TIMING
 #ifdef HDF5_INSTRUMENT
 #define DUMP
@@ -49,35 +50,41 @@ std::vector<dReal> errors;
 
 using namespace ode;
 
-static void* ComputeRows(void *p)
-{
-  dxPGSLCPParameters *params = (dxPGSLCPParameters *)p;
-
-  #ifdef REPORT_THREAD_TIMING
-  int thread_id                 = params->thread_id;
-  struct timeval tv;
-  double cur_time;
-  gettimeofday(&tv,NULL);
-  cur_time = (double)tv.tv_sec + (double)tv.tv_usec / 1.e6;
-  // printf("thread %d started at time %f\n",thread_id,cur_time);
-  #endif
-
-  IndexError* order             = params->order;
-  dxBody* const* body           = params->body;
-#ifdef RANDOMLY_REORDER_CONSTRAINTS
-#ifdef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
-  boost::recursive_mutex* mutex = params->mutex;
+// the colored solver sweeps rows in a fixed order that is computed once
+// per step, so it is not available with the options that reorder rows
+// while iterating or that carry state from one row to the next.
+#if !defined(REORDER_CONSTRAINTS) && \
+    !defined(RANDOMLY_REORDER_CONSTRAINTS) && \
+    !defined(PENETRATION_JVERROR_CORRECTION)
+#define COLORED_ROWS
 #endif
+
+//***************************************************************************
+// One PGS sweep over rows order[rowStart] to order[rowEnd-1], shared by
+// the chunked and the colored solvers. For every row, updates lambda (and
+// lambda_erp) and propagates the change to caccel (or cforce) of the
+// row's bodies, then accumulates the squared update and residual per
+// constraint type.
+// If lanes is given, the rows form a pack of the row kernels: the J*caccel
+// products are read from lanes and the caccel update is left to the
+// kernels, only delta and delta_erp are stored. Not used with precon.
+static void ComputeRowRange(const dxPGSLCPParameters *params,
+  const int iteration, const int rowStart, const int rowEnd,
+  dReal *rms_dlambda, dReal *rms_error, int *m_rms_dlambda,
+  quickstep::dxRowLanes *lanes
+#ifdef PENETRATION_JVERROR_CORRECTION
+  , const dReal Jvnew_final, dReal &Jvnew
 #endif
+  )
+{
+  const IndexError* order       = params->order;
+  dxBody* const* body           = params->body;
   bool inline_position_correction = params->inline_position_correction;
   bool position_correction_thread = params->position_correction_thread;
 
-  dxQuickStepParameters *qs    = params->qs;
-  int startRow                 = params->nStart;   // 0
-  int nRows                    = params->nChunkSize; // m
-#ifdef USE_1NORM
-  int m                        = params->m; // m used for rms error computation
-#endif
+  const dxQuickStepParameters *qs = params->qs;
+  int startRow                 = params->nStart;
+  int nRows                    = params->nChunkSize;
   int nb                       = params->nb;
 #ifdef PENETRATION_JVERROR_CORRECTION
   dReal stepsize               = params->stepsize;
@@ -107,704 +114,826 @@ static void* ComputeRows(void *p)
   dRealMutablePtr caccel_erp   = params->caccel_erp;
   dRealMutablePtr lambda_erp   = params->lambda_erp;
 
-#ifdef REORDER_CONSTRAINTS
-  dRealMutablePtr last_lambda  = params->last_lambda;
-#endif
-
-  //printf("iiiiiiiii %d %d %d\n",thread_id,jb[0],jb[1]);
-  //for (int i=startRow; i<startRow+nRows; i++) // swap within boundary of our own segment
-  //  printf("wwwwwwwwwwwww>id %d start %d n %d  order[%d].index=%d\n",thread_id,startRow,nRows,i,order[i].index);
-
-  /*  DEBUG PRINTOUTS
-  // print J_orig
-  printf("J_orig\n");
-  for (int i=startRow; i<startRow+nRows; i++) {
-    for (int j=0; j < 12 ; j++) {
-      printf("  %12.6f",J_orig[i*12+j]);
-    }
-    printf("\n");
-  }
-  printf("\n");
-
-  // print J, J_precon (already premultiplied by inverse of diagonal of LHS) and rhs_precon and rhs
-  printf("J_precon\n");
-  for (int i=startRow; i<startRow+nRows; i++) {
-    for (int j=0; j < 12 ; j++) {
-      printf("  %12.6f",J_precon[i*12+j]);
-    }
-    printf("\n");
-  }
-  printf("\n");
-
-  printf("J\n");
-  for (int i=startRow; i<startRow+nRows; i++) {
-    for (int j=0; j < 12 ; j++) {
-      printf("  %12.6f",J[i*12+j]);
-    }
-    printf("\n");
-  }
-  printf("\n");
-
-  printf("rhs_precon\n");
-  for (int i=startRow; i<startRow+nRows; i++)
-    printf("  %12.6f",rhs_precon[i]);
-  printf("\n");
-
-  printf("rhs\n");
-  for (int i=startRow; i<startRow+nRows; i++)
-    printf("  %12.6f",rhs[i]);
-  printf("\n");
-  */
-
-  // m_rms_dlambda[3] keeps track of number of constraint
-  // rows per type of constraint.
-  // m_rms_dlambda[0]: bilateral constraints (findex = -1)
-  // m_rms_dlambda[1]: contact normal constraints (findex = -2)
-  // rm_ms_dlambda[2]: friction constraints (findex >= 0)
-  int m_rms_dlambda[3];
-  m_rms_dlambda[0] = 0;
-  m_rms_dlambda[1] = 0;
-  m_rms_dlambda[2] = 0;
-
-  // rms of dlambda
-  dReal rms_dlambda[4];
-  dSetZero(rms_dlambda, 4);
-  // rms of b_i - A_ij \lambda_j as we sweep through rows
-  dReal rms_error[4];
-  dSetZero(rms_error, 4);
-
   int num_iterations = qs->num_iterations;
   int precon_iterations = qs->precon_iterations;
-  dReal pgs_lcp_tolerance = qs->pgs_lcp_tolerance;
-  int friction_iterations = qs->friction_iterations;
   Friction_Model friction_model = qs->friction_model;
   dReal smooth_contacts = qs->smooth_contacts;
 
-#ifdef SHOW_CONVERGENCE
-    // show starting lambda
-    printf("lambda start: [");
-    for (int i=startRow; i<startRow+nRows; i++)
-      printf("%f, ", lambda[i]);
-    printf("]\n");
-#endif
-
-#ifdef PENETRATION_JVERROR_CORRECTION
-  dReal Jvnew_final = 0;
-#endif
-#ifdef HDF5_INSTRUMENT
-  errors.resize(num_iterations + precon_iterations + friction_iterations);
-#endif
   dRealMutablePtr caccel_ptr1;
   dRealMutablePtr caccel_ptr2;
 
   /// THREAD_POSITION_CORRECTION
-  dRealMutablePtr caccel_erp_ptr1;
-  dRealMutablePtr caccel_erp_ptr2;
+  dRealMutablePtr caccel_erp_ptr1 = NULL;
+  dRealMutablePtr caccel_erp_ptr2 = NULL;
 
   dRealMutablePtr cforce_ptr1;
   dRealMutablePtr cforce_ptr2;
-  int total_iterations = precon_iterations + num_iterations +
-    friction_iterations;
-  for (int iteration = 0; iteration < total_iterations; ++iteration)
+
+#ifdef PENETRATION_JVERROR_CORRECTION
+  dRealMutablePtr vnew_ptr1;
+  dRealMutablePtr vnew_ptr2;
+#endif
+
+
+  for (int i = rowStart; i < rowEnd; ++i)
   {
-    // reset rms_dlambda at beginning of iteration
-    rms_dlambda[2] = 0;
-    // reset rms_error at beginning of iteration
-    rms_error[2] = 0;
-    m_rms_dlambda[2] = 0;
-    if (iteration < num_iterations + precon_iterations)
+    int index = order[i].index;
+    int constraint_index = findex[index];  // cache for efficiency
+
+    // check if we are doing extra friction_iterations, if so, only solve
+    // friction force constraints and nothing else.
+    // i.e. skip bilateral and contact normal constraints.
+    if (iteration >= (num_iterations + precon_iterations) &&
+        constraint_index < 0)
+      continue;
+
+
+    dReal delta = 0;
+    dReal delta_precon = 0;
+
+    // THREAD_POSITION_CORRECTION
+    dReal delta_erp = 0;
+    // precon does not support split position correction right now.
+    // dReal delta_precon_erp = 0;
+
+    // setup pointers
+    int b1 = jb[index*2];
+    int b2 = jb[index*2+1];
+
+    // for precon
     {
-      // skip resetting rms_dlambda and rms_error for bilateral constraints
-      // and contact normals during extra friction iterations.
-      rms_dlambda[0] = 0;
-      rms_dlambda[1] = 0;
-      rms_error[0] = 0;
-      rms_error[1] = 0;
-      m_rms_dlambda[0] = 0;
-      m_rms_dlambda[1] = 0;
+      cforce_ptr1 = cforce + 6*b1;
+      if (b2 >= 0)
+      {
+        cforce_ptr2     = cforce + 6*b2;
+      }
+      else
+      {
+        cforce_ptr2     = NULL;
+      }
     }
 
-#ifdef REORDER_CONSTRAINTS //FIXME: do it for lambda_erp and last_lambda_erp
-    // constraints with findex < 0 always come first.
-    if (iteration < 2) {
-      // for the first two iterations, solve the constraints in
-      // the given order
-      IndexError *ordercurr = order+startRow;
-      for (int i = startRow; i != startRow+nRows; ordercurr++, i++) {
-        ordercurr->error = i;
-        ordercurr->findex = findex[i];
-        ordercurr->index = i;
+    // for non-precon
+    {
+      caccel_ptr1 = caccel + 6*b1;
+      if (b2 >= 0)
+      {
+        caccel_ptr2     = caccel + 6*b2;
       }
-    }
-    else {
-      // sort the constraints so that the ones converging slowest
-      // get solved last. use the absolute (not relative) error.
-      for (int i=startRow; i<startRow+nRows; i++) {
-        dReal v1 = dFabs (lambda[i]);
-        dReal v2 = dFabs (last_lambda[i]);
-        dReal max = (v1 > v2) ? v1 : v2;
-        if (max > 0) {
-          //@@@ relative error: order[i].error = dFabs(lambda[i]-last_lambda[i])/max;
-          order[i].error = dFabs(lambda[i]-last_lambda[i]);
+      else
+      {
+        caccel_ptr2     = NULL;
+      }
+
+      if (inline_position_correction)
+      {
+        caccel_erp_ptr1 = caccel_erp + 6*b1;
+        if (b2 >= 0)
+        {
+          caccel_erp_ptr2     = caccel_erp + 6*b2;
         }
-        else {
-          order[i].error = dInfinity;
+        else
+        {
+          caccel_erp_ptr2     = NULL;
         }
-        order[i].findex = findex[i];
-        order[i].index = i;
       }
     }
+    dReal old_lambda        = lambda[index];
 
-    //if (thread_id == 0) for (int i=startRow;i<startRow+nRows;i++) printf("=====> %d %d %d %f %d\n",thread_id,iteration,i,order[i].error,order[i].index);
-
-    qsort (order+startRow,nRows,sizeof(IndexError),&compare_index_error);
+    /// THREAD_POSITION_CORRECTION
+    dReal old_lambda_erp;
+    if (inline_position_correction)
+      old_lambda_erp    = lambda_erp[index];
 
-    //@@@ potential optimization: swap lambda and last_lambda pointers rather
-    //    than copying the data. we must make sure lambda is properly
-    //    returned to the caller
-    memcpy (last_lambda+startRow,lambda+startRow,nRows*sizeof(dReal));
+  #ifdef PENETRATION_JVERROR_CORRECTION
+    // 4/4 optional pointers for jverror correction
+    vnew_ptr1 = vnew + 6*b1;
+    vnew_ptr2 = (b2 >= 0) ? vnew + 6*b2 : NULL;
+  #endif
 
-    //if (thread_id == 0) for (int i=startRow;i<startRow+nRows;i++) printf("-----> %d %d %d %f %d\n",thread_id,iteration,i,order[i].error,order[i].index);
 
-#endif
-#ifdef RANDOMLY_REORDER_CONSTRAINTS
-    if ((iteration & 7) == 0) {
-      #ifdef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
-        boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every swap
-      #endif
-      //  int swapi = dRandInt(i+1); // swap across engire matrix
-      for (int i=startRow+1; i<startRow+nRows; i++) { // swap within boundary of our own segment
-        int swapi = dRandInt(i+1-startRow)+startRow; // swap within boundary of our own segment
-        //printf("xxxxxxxx>id %d swaping order[%d].index=%d order[%d].index=%d\n",thread_id,i,order[i].index,swapi,order[swapi].index);
-        IndexError tmp = order[i];
-        order[i] = order[swapi];
-        order[swapi] = tmp;
+    //
+    // caccel is the constraint accel in the non-precon case
+    // cforce is the constraint force in the     precon case
+    // J_precon and J differs essentially in Ad and Ad_precon,
+    //  Ad is derived from diagonal of J inv(M) J'
+    //  Ad_precon is derived from diagonal of J J'
+    //
+    if (iteration < precon_iterations)
+    {
+      // preconditioning
+
+      // update delta_precon
+      delta_precon = rhs_precon[index] - old_lambda*Adcfm_precon[index];
+
+      dRealPtr J_ptr = J_precon + index*12;
+
+      // for preconditioned case, update delta using cforce, not caccel
+
+      delta_precon -= quickstep::dot6(cforce_ptr1, J_ptr);
+      if (cforce_ptr2)
+        delta_precon -= quickstep::dot6(cforce_ptr2, J_ptr + 6);
+
+      // set the limits for this constraint.
+      // this is the place where the QuickStep method differs from the
+      // direct LCP solving method, since that method only performs this
+      // limit adjustment once per time step, whereas this method performs
+      // once per iteration per constraint row.
+      // the constraints are ordered so that all lambda[] values needed have
+      // already been computed.
+      dReal hi_act, lo_act;
+      if (constraint_index >= 0) {
+        hi_act = dFabs (hi[index] * lambda[constraint_index]);
+        lo_act = -hi_act;
+      } else {
+        hi_act = hi[index];
+        lo_act = lo[index];
       }
 
-      // {
-      //   // verify
-      //   boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every row
-      //   printf("  random id %d iter %d\n",thread_id,iteration);
-      //   for (int i=startRow+1; i<startRow+nRows; i++)
-      //     printf(" %5d,",i);
-      //   printf("\n");
-      //   for (int i=startRow+1; i<startRow+nRows; i++)
-      //     printf(" %5d;",(int)order[i].index);
-      //   printf("\n");
-      // }
-    }
-#endif
-
-#ifdef PENETRATION_JVERROR_CORRECTION
-    dRealMutablePtr vnew_ptr1;
-    dRealMutablePtr vnew_ptr2;
-    const dReal stepsize1 = dRecip(stepsize);
-    dReal Jvnew = 0;
-#endif
-    for (int i=startRow; i<startRow+nRows; i++) {
-      //boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every row
-
-      // @@@ potential optimization: we could pre-sort J and iMJ, thereby
-      //     linearizing access to those arrays. hmmm, this does not seem
-      //     like a win, but we should think carefully about our memory
-      //     access pattern.
-
-      int index = order[i].index;
-      int constraint_index = findex[index];  // cache for efficiency
-
-      // check if we are doing extra friction_iterations, if so, only solve
-      // friction force constraints and nothing else.
-      // i.e. skip bilateral and contact normal constraints.
-      if (iteration >= (num_iterations + precon_iterations) &&
-          constraint_index < 0)
-        continue;
-
+      // compute lambda and clamp it to [lo,hi].
+      // @@@ SSE is used to speed up vector math
+      // operations with gcc compiler when defined
+      // but SSE is not a win here, #undef for now
+  #undef SSE_CLAMP
+  #ifndef SSE_CLAMP
+      lambda[index] = old_lambda+ delta_precon;
+      if (lambda[index] < lo_act) {
+        delta_precon = lo_act-old_lambda;
+        lambda[index] = lo_act;
+      }
+      else if (lambda[index] > hi_act) {
+        delta_precon = hi_act-old_lambda;
+        lambda[index] = hi_act;
+      }
+  #else
+      dReal nl = old_lambda+ delta_precon;
+      _mm_store_sd(&nl, _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
+        _mm_load_sd(&hi_act)), _mm_load_sd(&lo_act)));
+      lambda[index] = nl;
+      delta_precon = nl - old_lambda;
+  #endif
 
-      dReal delta = 0;
-      dReal delta_precon = 0;
+      // update cforce (this is strictly for the precon case)
+      {
+        // for preconditioning case, compute cforce
+        // FIXME: need un-altered unscaled J, not J_precon!!
+        J_ptr = J_orig + index*12;
 
-      // THREAD_POSITION_CORRECTION
-      dReal delta_erp = 0;
-      // precon does not support split position correction right now.
-      // dReal delta_precon_erp = 0;
+        // update cforce.
+        quickstep::sum6(cforce_ptr1, delta_precon, J_ptr);
+        if (cforce_ptr2)
+          quickstep::sum6(cforce_ptr2, delta_precon, J_ptr + 6);
+      }
 
-      // setup pointers
-      int b1 = jb[index*2];
-      int b2 = jb[index*2+1];
+      // record residual (error) (for the non-erp version)
+      // given
+      //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
+      // define scalar Ad:
+      //   Ad = sor / (A_ii + cfm)
+      // then
+      //   dlambda = Ad  * (b_i - A_ij * lambda_j)
+      // thus, to get residual from dlambda,
+      //   residual = dlambda / Ad
+      // or
+      //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
+      //   where Ad2 = 1/(Ad * Ad)
+      dReal Ad2 = 0.0;
+      if (!_dequal(Ad[index], 0.0))
+      {
+        // Ad[i] = sor_w / (sum + cfm[i]);
+        Ad2 = 1.0 / (Ad[index] * Ad[index]);
+      }
+      else
+      {
+        // TODO: Usually, this means qs->w (SOR param) is zero.
+        // Residual calculation is wrong when SOR (w) is zero
+        // Given SOR is rarely 0, we'll set residual as 0 for now.
+        // To do this properly, we should compute dlambda without sor
+        // then use the Ad without SOR to back out residual.
+      }
 
-      // for precon
+      dReal delta_precon2 = delta_precon*delta_precon;
+      if (constraint_index == -1)  // bilateral
       {
-        cforce_ptr1 = cforce + 6*b1;
-        if (b2 >= 0)
-        {
-          cforce_ptr2     = cforce + 6*b2;
-        }
-        else
-        {
-          cforce_ptr2     = NULL;
-        }
+        rms_dlambda[0] += delta_precon2;
+        rms_error[0] += delta_precon2*Ad2;
+        m_rms_dlambda[0]++;
+      }
+      else if (constraint_index == -2)  // contact normal
+      {
+        rms_dlambda[1] += delta_precon2;
+        rms_error[1] += delta_precon2*Ad2;
+        m_rms_dlambda[1]++;
+      }
+      else  // friction forces
+      {
+        rms_dlambda[2] += delta_precon2;
+        rms_error[2] += delta_precon2*Ad2;
+        m_rms_dlambda[2]++;
       }
 
-      // for non-precon
+      // initialize position correction terms (_erp) with precon results
+      if (inline_position_correction)
       {
-        caccel_ptr1 = caccel + 6*b1;
-        if (b2 >= 0)
+        old_lambda_erp = old_lambda;
+        lambda_erp[index] = lambda[index];
+      }
+    }
+    else
+    {
+      if (!skip_friction || constraint_index < 0)
+      {
+        // NOTE:
+        // for this update, we need not throw away J*v(n+1)/h term from rhs
+        //   ...so adding it back, but remember rhs has already been
+        //      scaled by Ad_i, so we need to do the same to J*v(n+1)/h
+        //      but given that J is already scaled by Ad_i, we don't have
+        //      to do it explicitly here
+
+        // delta: erp throttled by info.c_v_max or info.c
+        delta =
+  #ifdef PENETRATION_JVERROR_CORRECTION
+               Jvnew_final +
+  #endif
+              rhs[index] - old_lambda*Adcfm[index];
+        const int lane = i - rowStart;
+        dRealPtr J_ptr = J + index*12;
+        if (lanes)
         {
-          caccel_ptr2     = caccel + 6*b2;
+          delta -= lanes->dot[0][lane];
+          if (caccel_ptr2)
+            delta -= lanes->dot[1][lane];
         }
         else
         {
-          caccel_ptr2     = NULL;
+          delta -= quickstep::dot6(caccel_ptr1, J_ptr);
+          if (caccel_ptr2)
+            delta -= quickstep::dot6(caccel_ptr2, J_ptr + 6);
         }
 
         if (inline_position_correction)
         {
-          caccel_erp_ptr1 = caccel_erp + 6*b1;
-          if (b2 >= 0)
+          delta_erp = rhs_erp[index] - old_lambda_erp*Adcfm[index];
+          if (lanes)
           {
-            caccel_erp_ptr2     = caccel_erp + 6*b2;
+            delta_erp -= lanes->dot[2][lane];
+            if (caccel_ptr2)
+              delta_erp -= lanes->dot[3][lane];
           }
           else
           {
-            caccel_erp_ptr2     = NULL;
+            delta_erp -= quickstep::dot6(caccel_erp_ptr1, J_ptr);
+            if (caccel_ptr2)
+              delta_erp -= quickstep::dot6(caccel_erp_ptr2, J_ptr + 6);
           }
         }
-      }
-      dReal old_lambda        = lambda[index];
 
+      // set the limits for this constraint.
+      // this is the place where the QuickStep method differs from the
+      // direct LCP solving method, since that method only performs this
+      // limit adjustment once per time step, whereas this method performs
+      // once per iteration per constraint row.
+      // the constraints are ordered so that all lambda[] values needed have
+      // already been computed.
+      dReal hi_act, lo_act;
       /// THREAD_POSITION_CORRECTION
-      dReal old_lambda_erp;
-      if (inline_position_correction)
-        old_lambda_erp    = lambda_erp[index];
-
-#ifdef PENETRATION_JVERROR_CORRECTION
-      // 4/4 optional pointers for jverror correction
-      vnew_ptr1 = vnew + 6*b1;
-      vnew_ptr2 = (b2 >= 0) ? vnew + 6*b2 : NULL;
-#endif
-
-
-      //
-      // caccel is the constraint accel in the non-precon case
-      // cforce is the constraint force in the     precon case
-      // J_precon and J differs essentially in Ad and Ad_precon,
-      //  Ad is derived from diagonal of J inv(M) J'
-      //  Ad_precon is derived from diagonal of J J'
-      //
-      if (iteration < precon_iterations)
+      dReal hi_act_erp, lo_act_erp;
+      if (constraint_index >= 0)
       {
-        // preconditioning
-
-        // update delta_precon
-        delta_precon = rhs_precon[index] - old_lambda*Adcfm_precon[index];
-
-        dRealPtr J_ptr = J_precon + index*12;
-
-        // for preconditioned case, update delta using cforce, not caccel
-
-        delta_precon -= quickstep::dot6(cforce_ptr1, J_ptr);
-        if (cforce_ptr2)
-          delta_precon -= quickstep::dot6(cforce_ptr2, J_ptr + 6);
-
-        // set the limits for this constraint.
-        // this is the place where the QuickStep method differs from the
-        // direct LCP solving method, since that method only performs this
-        // limit adjustment once per time step, whereas this method performs
-        // once per iteration per constraint row.
-        // the constraints are ordered so that all lambda[] values needed have
-        // already been computed.
-        dReal hi_act, lo_act;
-        if (constraint_index >= 0) {
+        if (index - constraint_index >= 3)
+        {
+          // torsional friction should have been added as the third row from
+          // contact normal constraint
+          // this_is_torsional_friction
           hi_act = dFabs (hi[index] * lambda[constraint_index]);
           lo_act = -hi_act;
-        } else {
-          hi_act = hi[index];
-          lo_act = lo[index];
+          if (inline_position_correction)
+          {
+            hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
+            lo_act_erp = -hi_act_erp;
+          }
         }
-
-        // compute lambda and clamp it to [lo,hi].
-        // @@@ SSE is used to speed up vector math
-        // operations with gcc compiler when defined
-        // but SSE is not a win here, #undef for now
-#undef SSE_CLAMP
-#ifndef SSE_CLAMP
-        lambda[index] = old_lambda+ delta_precon;
+        else
+        {
+          // deal with non-torsional frictions
+          if (friction_model == pyramid_friction)
+          {
+            // FOR erp throttled by info.c_v_max or info.c
+            hi_act = dFabs (hi[index] * lambda[constraint_index]);
+            lo_act = -hi_act;
+            if (inline_position_correction)
+            {
+              hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
+              lo_act_erp = -hi_act_erp;
+            }
+          }
+          else if (friction_model == cone_friction)
+          {
+            quickstep::dxConeFrictionModel(lo_act, hi_act, lo_act_erp, hi_act_erp, jb, J_orig, index,
+                constraint_index, startRow, nRows, nb, body, i, order, findex, NULL, hi, lambda, lambda_erp);
+          }
+          else if(friction_model == box_friction)
+          {
+            hi_act = hi[index];
+            lo_act = -hi_act;
+            hi_act_erp = hi[index];
+            lo_act_erp = -hi_act_erp;
+          }
+          else
+          {
+              // initialize the hi and lo to get rid of warnings
+              hi_act = dInfinity;
+              lo_act = -dInfinity;
+              hi_act_erp = dInfinity;
+              lo_act_erp = -dInfinity;
+              dMessage (d_ERR_UASSERT, "internal error, undefined friction model");
+          }
+        }
+      }
+      else
+      {
+        // FOR erp throttled by info.c_v_max or info.c
+        hi_act = hi[index];
+        lo_act = lo[index];
+        if (inline_position_correction)
+        {
+          hi_act_erp = hi[index];
+          lo_act_erp = lo[index];
+        }
+      }
+      // compute lambda and clamp it to [lo,hi].
+      // @@@ SSE not a win here
+  #undef SSE_CLAMP
+  #ifndef SSE_CLAMP
+        // FOR erp throttled by info.c_v_max or info.c
+        lambda[index] = old_lambda + delta;
         if (lambda[index] < lo_act) {
-          delta_precon = lo_act-old_lambda;
+          delta = lo_act-old_lambda;
           lambda[index] = lo_act;
         }
         else if (lambda[index] > hi_act) {
-          delta_precon = hi_act-old_lambda;
+          delta = hi_act-old_lambda;
           lambda[index] = hi_act;
         }
-#else
-        dReal nl = old_lambda+ delta_precon;
-        _mm_store_sd(&nl, _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
-          _mm_load_sd(&hi_act)), _mm_load_sd(&lo_act)));
-        lambda[index] = nl;
-        delta_precon = nl - old_lambda;
-#endif
 
-        // update cforce (this is strictly for the precon case)
+        if (inline_position_correction)
         {
-          // for preconditioning case, compute cforce
-          // FIXME: need un-altered unscaled J, not J_precon!!
-          J_ptr = J_orig + index*12;
-
-          // update cforce.
-          quickstep::sum6(cforce_ptr1, delta_precon, J_ptr);
-          if (cforce_ptr2)
-            quickstep::sum6(cforce_ptr2, delta_precon, J_ptr + 6);
+          lambda_erp[index] = old_lambda_erp + delta_erp;
+          if (lambda_erp[index] < lo_act_erp) {
+            delta_erp = lo_act_erp-old_lambda_erp;
+            lambda_erp[index] = lo_act_erp;
+          }
+          else if (lambda_erp[index] > hi_act_erp) {
+            delta_erp = hi_act_erp-old_lambda_erp;
+            lambda_erp[index] = hi_act_erp;
+          }
         }
+  #else
+        // FOR erp throttled by info.c_v_max or info.c
+        dReal nl = old_lambda + delta;
+        _mm_store_sd(&nl,
+                     _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
+                     _mm_load_sd(&hi_act)),
+                     _mm_load_sd(&lo_act)));
+        lambda[index] = nl;
+        delta = nl - old_lambda;
 
-        // record residual (error) (for the non-erp version)
-        // given
-        //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
-        // define scalar Ad:
-        //   Ad = sor / (A_ii + cfm)
-        // then
-        //   dlambda = Ad  * (b_i - A_ij * lambda_j)
-        // thus, to get residual from dlambda,
-        //   residual = dlambda / Ad
-        // or
-        //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
-        //   where Ad2 = 1/(Ad * Ad)
-        dReal Ad2 = 0.0;
-        if (!_dequal(Ad[index], 0.0))
-        {
-          // Ad[i] = sor_w / (sum + cfm[i]);
-          Ad2 = 1.0 / (Ad[index] * Ad[index]);
-        }
-        else
+        if (inline_position_correction)
         {
-          // TODO: Usually, this means qs->w (SOR param) is zero.
-          // Residual calculation is wrong when SOR (w) is zero
-          // Given SOR is rarely 0, we'll set residual as 0 for now.
-          // To do this properly, we should compute dlambda without sor
-          // then use the Ad without SOR to back out residual.
+          dReal nl_erp = old_lambda_erp + delta_erp;
+          _mm_store_sd(&nl_erp,
+                       _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl_erp),
+                       _mm_load_sd(&hi_act_erp)),
+                       _mm_load_sd(&lo_act_erp)));
+          lambda_erp[index] = nl_erp;
+          delta_erp = nl_erp - old_lambda_erp;
         }
+  #endif
 
-        dReal delta_precon2 = delta_precon*delta_precon;
-        if (constraint_index == -1)  // bilateral
+        // option to smooth lambda
+  #ifdef SMOOTH_LAMBDA
+        // skip smoothing for the position correction thread
+        if (!position_correction_thread)
         {
-          rms_dlambda[0] += delta_precon2;
-          rms_error[0] += delta_precon2*Ad2;
-          m_rms_dlambda[0]++;
+          // smooth delta lambda
+          // equivalent to first order artificial dissipation on lambda update.
+
+          // debug smoothing
+          // if (i == 0)
+          //   printf("rhs[%f] adcfm[%f]: ",rhs[index], Adcfm[index]);
+          // if (i == 0)
+          //   printf("dlambda iter[%d]: ",iteration);
+          // printf(" %f ", lambda[index]-old_lambda);
+          // if (i == startRow + nRows - 1)
+          //   printf("\n");
+
+          // extra residual smoothing for contact constraints
+          // was smoothing both contact normal and friction constraints for VRC
+          // if (constraint_index != -1)
+          // smooth only lambda for friction directions fails friction_demo.world
+          if (constraint_index != -1)
+          {
+            lambda[index] = (1.0 - smooth_contacts)*lambda[index]
+              + smooth_contacts*old_lambda;
+          }
+
+          // if (inline_position_correction)
+          // {
+          //   /// not smoothing lambda_erp
+          // }
         }
-        else if (constraint_index == -2)  // contact normal
+  #endif
+
+        // update caccel
+        if (lanes)
         {
-          rms_dlambda[1] += delta_precon2;
-          rms_error[1] += delta_precon2*Ad2;
-          m_rms_dlambda[1]++;
+          // done for the whole pack by the row kernels
+          lanes->delta[lane] = delta;
+          lanes->delta_erp[lane] = delta_erp;
+          lanes->active |= 1 << lane;
         }
-        else  // friction forces
+        else
         {
-          rms_dlambda[2] += delta_precon2;
-          rms_error[2] += delta_precon2*Ad2;
-          m_rms_dlambda[2]++;
+          // FOR erp throttled by info.c_v_max or info.c
+          dRealPtr iMJ_ptr = iMJ + index*12;
+
+          // update caccel.
+          quickstep::sum6(caccel_ptr1, delta, iMJ_ptr);
+          if (caccel_ptr2)
+            quickstep::sum6(caccel_ptr2, delta, iMJ_ptr + 6);
+
+          if (inline_position_correction)
+          {
+            quickstep::sum6(caccel_erp_ptr1, delta_erp, iMJ_ptr);
+            if (caccel_erp_ptr2)
+              quickstep::sum6(caccel_erp_ptr2, delta_erp, iMJ_ptr + 6);
+          }
         }
+      }  // end of skip friction check
 
-        // initialize position correction terms (_erp) with precon results
-        if (inline_position_correction)
-        {
-          old_lambda_erp = old_lambda;
-          lambda_erp[index] = lambda[index];
+  #ifdef PENETRATION_JVERROR_CORRECTION
+      {
+        // FOR erp throttled by info.c_v_max or info.c
+        dRealPtr iMJ_ptr = iMJ + index*12;
+        // update vnew incrementally
+        //   add stepsize * delta_caccel to the body velocity
+        //   vnew = vnew + dt * delta_caccel
+        quickstep::sum6(vnew_ptr1, stepsize*delta, iMJ_ptr);
+        if (caccel_ptr2)
+          quickstep::sum6(vnew_ptr2, stepsize*delta, iMJ_ptr + 6);
+
+        // COMPUTE Jvnew = J*vnew/h*Ad
+        //   but J is already scaled by Ad, and we multiply by h later
+        //   so it's just Jvnew = J*vnew here
+        if (iteration >= num_iterations-7) {
+          // check for non-contact bilateral constraints only
+          // I've set findex to -2 for contact normal constraint
+          if (constraint_index == -1) {
+            dRealPtr J_ptr = J + index*12;
+            Jvnew = quickstep::dot6(vnew_ptr1,J_ptr);
+            if (caccel_ptr2)
+              Jvnew += quickstep::dot6(vnew_ptr2,J_ptr+6);
+            // printf("iter [%d] findex [%d] Jvnew [%f] lo [%f] hi [%f]\n",
+            //   iteration, constraint_index, Jvnew, lo[index], hi[index]);
+          }
         }
+        //printf("iter [%d] vnew [%f,%f,%f,%f,%f,%f] Jvnew [%f]\n",
+        //       iteration,
+        //       vnew_ptr1[0], vnew_ptr1[1], vnew_ptr1[2],
+        //       vnew_ptr1[3], vnew_ptr1[4], vnew_ptr1[5],Jvnew);
+      }
+  #endif
+
+
+      //////////////////////////////////////////////////////
+      // record residual (error) (for the non-erp version)
+      //////////////////////////////////////////////////////
+      // given
+      //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
+      // define scalar Ad:
+      //   Ad = sor / (A_ii + cfm)
+      // then
+      //   dlambda = Ad  * (b_i - A_ij * lambda_j)
+      // thus, to get residual from dlambda,
+      //   residual = dlambda / Ad
+      // or
+      //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
+      //   where Ad2 = 1/(Ad * Ad)
+      dReal Ad2 = 0.0;
+      if (!_dequal(Ad[index], 0.0))
+      {
+        // Ad[i] = sor_w / (sum + cfm[i]);
+        Ad2 = 1.0 / (Ad[index] * Ad[index]);
       }
       else
       {
-        if (!skip_friction || constraint_index < 0)
-        {
-          // NOTE:
-          // for this update, we need not throw away J*v(n+1)/h term from rhs
-          //   ...so adding it back, but remember rhs has already been
-          //      scaled by Ad_i, so we need to do the same to J*v(n+1)/h
-          //      but given that J is already scaled by Ad_i, we don't have
-          //      to do it explicitly here
-
-          // delta: erp throttled by info.c_v_max or info.c
-          delta =
+        // TODO: Usually, this means qs->w (SOR param) is zero.
+        // Residual calculation is wrong when SOR (w) is zero
+        // Given SOR is rarely 0, we'll set residual as 0 for now.
+        // To do this properly, we should compute dlambda without sor
+        // then use the Ad without SOR to back out residual.
+      }
+
+      dReal delta2 = delta*delta;
+      if (constraint_index == -1)  // bilateral
+      {
+        rms_dlambda[0] += delta2;
+        rms_error[0] += delta2*Ad2;
+        m_rms_dlambda[0]++;
+      }
+      else if (constraint_index == -2)  // contact normal
+      {
+        rms_dlambda[1] += delta2;
+        rms_error[1] += delta2*Ad2;
+        m_rms_dlambda[1]++;
+      }
+      else  // friction forces
+      {
+        rms_dlambda[2] += delta2;
+        rms_error[2] += delta2*Ad2;
+        m_rms_dlambda[2]++;
+      }
+    } // end of non-precon
+  } // end of for loop on rows
+}
+
+//***************************************************************************
+// Convert the squared row updates and residuals accumulated over one
+// sweep into the rms values reported in qs.
+static void UpdateRMS(dxQuickStepParameters *qs, const dReal *rms_dlambda,
+  const dReal *rms_error, const int *m_rms_dlambda)
+{
+  // DO WE NEED TO COMPUTE NORM ACROSS ENTIRE SOLUTION SPACE (0,m)?
+  // since local convergence might produce errors in other nodes?
+  dReal dlambda_bilateral_mean = 0.0;
+  dReal dlambda_contact_normal_mean = 0.0;
+  dReal dlambda_contact_friction_mean = 0.0;
+  dReal dlambda_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
+  if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
+    dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
+  qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
+  qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
+  qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
+
+  dReal residual_bilateral_mean = 0.0;
+  dReal residual_contact_normal_mean = 0.0;
+  dReal residual_contact_friction_mean = 0.0;
+  dReal residual_total_mean = 0.0;
+
+  if (m_rms_dlambda[0] > 0)
+    residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
+  if (m_rms_dlambda[1] > 0)
+    residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
+  if (m_rms_dlambda[2] > 0)
+    residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
+  if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
+    residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
+      ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
+
+  qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
+  qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
+  qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
+  qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
+  qs->num_contacts = m_rms_dlambda[1];
+}
+
+static void* ComputeRows(void *p)
+{
+  dxPGSLCPParameters *params = (dxPGSLCPParameters *)p;
+
+  #ifdef REPORT_THREAD_TIMING
+  int thread_id                 = params->thread_id;
+  struct timeval tv;
+  double cur_time;
+  gettimeofday(&tv,NULL);
+  cur_time = (double)tv.tv_sec + (double)tv.tv_usec / 1.e6;
+  // printf("thread %d started at time %f\n",thread_id,cur_time);
+  #endif
+
+#if defined(REORDER_CONSTRAINTS) || defined(RANDOMLY_REORDER_CONSTRAINTS)
+  IndexError* order             = params->order;
+#endif
+#ifdef RANDOMLY_REORDER_CONSTRAINTS
+#ifdef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
+  boost::recursive_mutex* mutex = params->mutex;
+#endif
+#endif
+  bool position_correction_thread = params->position_correction_thread;
+
+  dxQuickStepParameters *qs    = params->qs;
+  int startRow                 = params->nStart;   // 0
+  int nRows                    = params->nChunkSize; // m
+#ifdef USE_1NORM
+  int m                        = params->m; // m used for rms error computation
+#endif
 #ifdef PENETRATION_JVERROR_CORRECTION
-                 Jvnew_final +
+  dReal stepsize               = params->stepsize;
+#endif
+#ifdef REORDER_CONSTRAINTS
+  const int* findex            = params->findex;
+  dRealMutablePtr last_lambda  = params->last_lambda;
+#endif
+#if defined(REORDER_CONSTRAINTS) || defined(SHOW_CONVERGENCE)
+  dRealMutablePtr lambda       = params->lambda;
 #endif
-                rhs[index] - old_lambda*Adcfm[index];
-          dRealPtr J_ptr = J + index*12;
-          delta -= quickstep::dot6(caccel_ptr1, J_ptr);
-          if (caccel_ptr2)
-            delta -= quickstep::dot6(caccel_ptr2, J_ptr + 6);
 
-          if (inline_position_correction)
-          {
-            delta_erp = rhs_erp[index] - old_lambda_erp*Adcfm[index];
-            delta_erp -= quickstep::dot6(caccel_erp_ptr1, J_ptr);
-            if (caccel_ptr2)
-              delta_erp -= quickstep::dot6(caccel_erp_ptr2, J_ptr + 6);
-          }
+  //printf("iiiiiiiii %d %d %d\n",thread_id,jb[0],jb[1]);
+  //for (int i=startRow; i<startRow+nRows; i++) // swap within boundary of our own segment
+  //  printf("wwwwwwwwwwwww>id %d start %d n %d  order[%d].index=%d\n",thread_id,startRow,nRows,i,order[i].index);
 
-        // set the limits for this constraint.
-        // this is the place where the QuickStep method differs from the
-        // direct LCP solving method, since that method only performs this
-        // limit adjustment once per time step, whereas this method performs
-        // once per iteration per constraint row.
-        // the constraints are ordered so that all lambda[] values needed have
-        // already been computed.
-        dReal hi_act, lo_act;
-        /// THREAD_POSITION_CORRECTION
-        dReal hi_act_erp, lo_act_erp;
-        if (constraint_index >= 0)
-        {
-          if (index - constraint_index >= 3)
-          {
-            // torsional friction should have been added as the third row from
-            // contact normal constraint
-            // this_is_torsional_friction
-            hi_act = dFabs (hi[index] * lambda[constraint_index]);
-            lo_act = -hi_act;
-            if (inline_position_correction)
-            {
-              hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
-              lo_act_erp = -hi_act_erp;
-            }
-          }
-          else
-          {
-            // deal with non-torsional frictions
-            if (friction_model == pyramid_friction)
-            {
-              // FOR erp throttled by info.c_v_max or info.c
-              hi_act = dFabs (hi[index] * lambda[constraint_index]);
-              lo_act = -hi_act;
-              if (inline_position_correction)
-              {
-                hi_act_erp = dFabs (hi[index] * lambda_erp[constraint_index]);
-                lo_act_erp = -hi_act_erp;
-              }
-            }
-            else if (friction_model == cone_friction)
-            {
-              quickstep::dxConeFrictionModel(lo_act, hi_act, lo_act_erp, hi_act_erp, jb, J_orig, index,
-                  constraint_index, startRow, nRows, nb, body, i, order, findex, NULL, hi, lambda, lambda_erp);
-            }
-            else if(friction_model == box_friction)
-            {
-              hi_act = hi[index];
-              lo_act = -hi_act;
-              hi_act_erp = hi[index];
-              lo_act_erp = -hi_act_erp;
-            }
-            else
-            {
-                // initialize the hi and lo to get rid of warnings
-                hi_act = dInfinity;
-                lo_act = -dInfinity;
-                hi_act_erp = dInfinity;
-                lo_act_erp = -dInfinity;
-                dMessage (d_ERR_UASSERT, "internal error, undefined friction model");
-            }
-          }
-        }
-        else
-        {
-          // FOR erp throttled by info.c_v_max or info.c
-          hi_act = hi[index];
-          lo_act = lo[index];
-          if (inline_position_correction)
-          {
-            hi_act_erp = hi[index];
-            lo_act_erp = lo[index];
-          }
-        }
-        // compute lambda and clamp it to [lo,hi].
-        // @@@ SSE not a win here
-#undef SSE_CLAMP
-#ifndef SSE_CLAMP
-          // FOR erp throttled by info.c_v_max or info.c
-          lambda[index] = old_lambda + delta;
-          if (lambda[index] < lo_act) {
-            delta = lo_act-old_lambda;
-            lambda[index] = lo_act;
-          }
-          else if (lambda[index] > hi_act) {
-            delta = hi_act-old_lambda;
-            lambda[index] = hi_act;
-          }
+  /*  DEBUG PRINTOUTS
+  // print J_orig
+  printf("J_orig\n");
+  for (int i=startRow; i<startRow+nRows; i++) {
+    for (int j=0; j < 12 ; j++) {
+      printf("  %12.6f",J_orig[i*12+j]);
+    }
+    printf("\n");
+  }
+  printf("\n");
 
-          if (inline_position_correction)
-          {
-            lambda_erp[index] = old_lambda_erp + delta_erp;
-            if (lambda_erp[index] < lo_act_erp) {
-              delta_erp = lo_act_erp-old_lambda_erp;
-              lambda_erp[index] = lo_act_erp;
-            }
-            else if (lambda_erp[index] > hi_act_erp) {
-              delta_erp = hi_act_erp-old_lambda_erp;
-              lambda_erp[index] = hi_act_erp;
-            }
-          }
-#else
-          // FOR erp throttled by info.c_v_max or info.c
-          dReal nl = old_lambda + delta;
-          _mm_store_sd(&nl,
-                       _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl),
-                       _mm_load_sd(&hi_act)),
-                       _mm_load_sd(&lo_act)));
-          lambda[index] = nl;
-          delta = nl - old_lambda;
+  // print J, J_precon (already premultiplied by inverse of diagonal of LHS) and rhs_precon and rhs
+  printf("J_precon\n");
+  for (int i=startRow; i<startRow+nRows; i++) {
+    for (int j=0; j < 12 ; j++) {
+      printf("  %12.6f",J_precon[i*12+j]);
+    }
+    printf("\n");
+  }
+  printf("\n");
+
+  printf("J\n");
+  for (int i=startRow; i<startRow+nRows; i++) {
+    for (int j=0; j < 12 ; j++) {
+      printf("  %12.6f",J[i*12+j]);
+    }
+    printf("\n");
+  }
+  printf("\n");
 
-          if (inline_position_correction)
-          {
-            dReal nl_erp = old_lambda_erp + delta_erp;
-            _mm_store_sd(&nl_erp,
-                         _mm_max_sd(_mm_min_sd(_mm_load_sd(&nl_erp),
-                         _mm_load_sd(&hi_act_erp)),
-                         _mm_load_sd(&lo_act_erp)));
-            lambda_erp[index] = nl_erp;
-            delta_erp = nl_erp - old_lambda_erp;
-          }
-#endif
+  printf("rhs_precon\n");
+  for (int i=startRow; i<startRow+nRows; i++)
+    printf("  %12.6f",rhs_precon[i]);
+  printf("\n");
 
-          // option to smooth lambda
-#ifdef SMOOTH_LAMBDA
-          // skip smoothing for the position correction thread
-          if (!position_correction_thread)
-          {
-            // smooth delta lambda
-            // equivalent to first order artificial dissipation on lambda update.
-
-            // debug smoothing
-            // if (i == 0)
-            //   printf("rhs[%f] adcfm[%f]: ",rhs[index], Adcfm[index]);
-            // if (i == 0)
-            //   printf("dlambda iter[%d]: ",iteration);
-            // printf(" %f ", lambda[index]-old_lambda);
-            // if (i == startRow + nRows - 1)
-            //   printf("\n");
-
-            // extra residual smoothing for contact constraints
-            // was smoothing both contact normal and friction constraints for VRC
-            // if (constraint_index != -1)
-            // smooth only lambda for friction directions fails friction_demo.world
-            if (constraint_index != -1)
-            {
-              lambda[index] = (1.0 - smooth_contacts)*lambda[index]
-                + smooth_contacts*old_lambda;
-            }
+  printf("rhs\n");
+  for (int i=startRow; i<startRow+nRows; i++)
+    printf("  %12.6f",rhs[i]);
+  printf("\n");
+  */
 
-            // if (inline_position_correction)
-            // {
-            //   /// not smoothing lambda_erp
-            // }
-          }
-#endif
+  // m_rms_dlambda[3] keeps track of number of constraint
+  // rows per type of constraint.
+  // m_rms_dlambda[0]: bilateral constraints (findex = -1)
+  // m_rms_dlambda[1]: contact normal constraints (findex = -2)
+  // rm_ms_dlambda[2]: friction constraints (findex >= 0)
+  int m_rms_dlambda[3];
+  m_rms_dlambda[0] = 0;
+  m_rms_dlambda[1] = 0;
+  m_rms_dlambda[2] = 0;
 
-          // update caccel
-          {
-            // FOR erp throttled by info.c_v_max or info.c
-            dRealPtr iMJ_ptr = iMJ + index*12;
+  // rms of dlambda
+  dReal rms_dlambda[4];
+  dSetZero(rms_dlambda, 4);
+  // rms of b_i - A_ij \lambda_j as we sweep through rows
+  dReal rms_error[4];
+  dSetZero(rms_error, 4);
 
-            // update caccel.
-            quickstep::sum6(caccel_ptr1, delta, iMJ_ptr);
-            if (caccel_ptr2)
-              quickstep::sum6(caccel_ptr2, delta, iMJ_ptr + 6);
+  int num_iterations = qs->num_iterations;
+  int precon_iterations = qs->precon_iterations;
+  dReal pgs_lcp_tolerance = qs->pgs_lcp_tolerance;
+  int friction_iterations = qs->friction_iterations;
 
-            if (inline_position_correction)
-            {
-              quickstep::sum6(caccel_erp_ptr1, delta_erp, iMJ_ptr);
-              if (caccel_erp_ptr2)
-                quickstep::sum6(caccel_erp_ptr2, delta_erp, iMJ_ptr + 6);
-            }
-          }
-        }  // end of skip friction check
+#ifdef SHOW_CONVERGENCE
+    // show starting lambda
+    printf("lambda start: [");
+    for (int i=startRow; i<startRow+nRows; i++)
+      printf("%f, ", lambda[i]);
+    printf("]\n");
+#endif
 
 #ifdef PENETRATION_JVERROR_CORRECTION
-        {
-          // FOR erp throttled by info.c_v_max or info.c
-          dRealPtr iMJ_ptr = iMJ + index*12;
-          // update vnew incrementally
-          //   add stepsize * delta_caccel to the body velocity
-          //   vnew = vnew + dt * delta_caccel
-          quickstep::sum6(vnew_ptr1, stepsize*delta, iMJ_ptr);
-          if (caccel_ptr2)
-            quickstep::sum6(vnew_ptr2, stepsize*delta, iMJ_ptr + 6);
-
-          // COMPUTE Jvnew = J*vnew/h*Ad
-          //   but J is already scaled by Ad, and we multiply by h later
-          //   so it's just Jvnew = J*vnew here
-          if (iteration >= num_iterations-7) {
-            // check for non-contact bilateral constraints only
-            // I've set findex to -2 for contact normal constraint
-            if (constraint_index == -1) {
-              dRealPtr J_ptr = J + index*12;
-              Jvnew = quickstep::dot6(vnew_ptr1,J_ptr);
-              if (caccel_ptr2)
-                Jvnew += quickstep::dot6(vnew_ptr2,J_ptr+6);
-              // printf("iter [%d] findex [%d] Jvnew [%f] lo [%f] hi [%f]\n",
-              //   iteration, constraint_index, Jvnew, lo[index], hi[index]);
-            }
-          }
-          //printf("iter [%d] vnew [%f,%f,%f,%f,%f,%f] Jvnew [%f]\n",
-          //       iteration,
-          //       vnew_ptr1[0], vnew_ptr1[1], vnew_ptr1[2],
-          //       vnew_ptr1[3], vnew_ptr1[4], vnew_ptr1[5],Jvnew);
-        }
+  dReal Jvnew_final = 0;
 #endif
+#ifdef HDF5_INSTRUMENT
+  errors.resize(num_iterations + precon_iterations + friction_iterations);
+#endif
+  int total_iterations = precon_iterations + num_iterations +
+    friction_iterations;
+  for (int iteration = 0; iteration < total_iterations; ++iteration)
+  {
+    // reset rms_dlambda at beginning of iteration
+    rms_dlambda[2] = 0;
+    // reset rms_error at beginning of iteration
+    rms_error[2] = 0;
+    m_rms_dlambda[2] = 0;
+    if (iteration < num_iterations + precon_iterations)
+    {
+      // skip resetting rms_dlambda and rms_error for bilateral constraints
+      // and contact normals during extra friction iterations.
+      rms_dlambda[0] = 0;
+      rms_dlambda[1] = 0;
+      rms_error[0] = 0;
+      rms_error[1] = 0;
+      m_rms_dlambda[0] = 0;
+      m_rms_dlambda[1] = 0;
+    }
 
-
-        //////////////////////////////////////////////////////
-        // record residual (error) (for the non-erp version)
-        //////////////////////////////////////////////////////
-        // given
-        //   dlambda = sor * (b_i - A_ij * lambda_j)/(A_ii + cfm)
-        // define scalar Ad:
-        //   Ad = sor / (A_ii + cfm)
-        // then
-        //   dlambda = Ad  * (b_i - A_ij * lambda_j)
-        // thus, to get residual from dlambda,
-        //   residual = dlambda / Ad
-        // or
-        //   residual = sqrt(sum( Ad2 * dlambda_i * dlambda_i))
-        //   where Ad2 = 1/(Ad * Ad)
-        dReal Ad2 = 0.0;
-        if (!_dequal(Ad[index], 0.0))
-        {
-          // Ad[i] = sor_w / (sum + cfm[i]);
-          Ad2 = 1.0 / (Ad[index] * Ad[index]);
+#ifdef REORDER_CONSTRAINTS //FIXME: do it for lambda_erp and last_lambda_erp
+    // constraints with findex < 0 always come first.
+    if (iteration < 2) {
+      // for the first two iterations, solve the constraints in
+      // the given order
+      IndexError *ordercurr = order+startRow;
+      for (int i = startRow; i != startRow+nRows; ordercurr++, i++) {
+        ordercurr->error = i;
+        ordercurr->findex = findex[i];
+        ordercurr->index = i;
+      }
+    }
+    else {
+      // sort the constraints so that the ones converging slowest
+      // get solved last. use the absolute (not relative) error.
+      for (int i=startRow; i<startRow+nRows; i++) {
+        dReal v1 = dFabs (lambda[i]);
+        dReal v2 = dFabs (last_lambda[i]);
+        dReal max = (v1 > v2) ? v1 : v2;
+        if (max > 0) {
+          //@@@ relative error: order[i].error = dFabs(lambda[i]-last_lambda[i])/max;
+          order[i].error = dFabs(lambda[i]-last_lambda[i]);
         }
-        else
-        {
-          // TODO: Usually, this means qs->w (SOR param) is zero.
-          // Residual calculation is wrong when SOR (w) is zero
-          // Given SOR is rarely 0, we'll set residual as 0 for now.
-          // To do this properly, we should compute dlambda without sor
-          // then use the Ad without SOR to back out residual.
+        else {
+          order[i].error = dInfinity;
         }
+        order[i].findex = findex[i];
+        order[i].index = i;
+      }
+    }
 
-        dReal delta2 = delta*delta;
-        if (constraint_index == -1)  // bilateral
-        {
-          rms_dlambda[0] += delta2;
-          rms_error[0] += delta2*Ad2;
-          m_rms_dlambda[0]++;
-        }
-        else if (constraint_index == -2)  // contact normal
-        {
-          rms_dlambda[1] += delta2;
-          rms_error[1] += delta2*Ad2;
-          m_rms_dlambda[1]++;
-        }
-        else  // friction forces
-        {
-          rms_dlambda[2] += delta2;
-          rms_error[2] += delta2*Ad2;
-          m_rms_dlambda[2]++;
-        }
-      } // end of non-precon
+    //if (thread_id == 0) for (int i=startRow;i<startRow+nRows;i++) printf("=====> %d %d %d %f %d\n",thread_id,iteration,i,order[i].error,order[i].index);
+
+    qsort (order+startRow,nRows,sizeof(IndexError),&compare_index_error);
+
+    //@@@ potential optimization: swap lambda and last_lambda pointers rather
+    //    than copying the data. we must make sure lambda is properly
+    //    returned to the caller
+    memcpy (last_lambda+startRow,lambda+startRow,nRows*sizeof(dReal));
+
+    //if (thread_id == 0) for (int i=startRow;i<startRow+nRows;i++) printf("-----> %d %d %d %f %d\n",thread_id,iteration,i,order[i].error,order[i].index);
+
+#endif
+#ifdef RANDOMLY_REORDER_CONSTRAINTS
+    if ((iteration & 7) == 0) {
+      #ifdef LOCK_WHILE_RANDOMLY_REORDER_CONSTRAINTS
+        boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every swap
+      #endif
+      //  int swapi = dRandInt(i+1); // swap across engire matrix
+      for (int i=startRow+1; i<startRow+nRows; i++) { // swap within boundary of our own segment
+        int swapi = dRandIntSeeded(&qs->rand_seed,i+1-startRow)+startRow; // swap within boundary of our own segment
+        //printf("xxxxxxxx>id %d swaping order[%d].index=%d order[%d].index=%d\n",thread_id,i,order[i].index,swapi,order[swapi].index);
+        IndexError tmp = order[i];
+        order[i] = order[swapi];
+        order[swapi] = tmp;
+      }
 
-      //@@@ a trick that may or may not help
-      //dReal ramp = (1-((dReal)(iteration+1)/(dReal)iterations));
-      //delta *= ramp;
+      // {
+      //   // verify
+      //   boost::recursive_mutex::scoped_lock lock(*mutex); // lock for every row
+      //   printf("  random id %d iter %d\n",thread_id,iteration);
+      //   for (int i=startRow+1; i<startRow+nRows; i++)
+      //     printf(" %5d,",i);
+      //   printf("\n");
+      //   for (int i=startRow+1; i<startRow+nRows; i++)
+      //     printf(" %5d;",(int)order[i].index);
+      //   printf("\n");
+      // }
+    }
+#endif
 
-    } // end of for loop on m
+#ifdef PENETRATION_JVERROR_CORRECTION
+    const dReal stepsize1 = dRecip(stepsize);
+    dReal Jvnew = 0;
+#endif
+    // @@@ potential optimization: we could pre-sort J and iMJ, thereby
+    //     linearizing access to those arrays. hmmm, this does not seem
+    //     like a win, but we should think carefully about our memory
+    //     access pattern.
+    ComputeRowRange(params, iteration, startRow, startRow+nRows,
+      rms_dlambda, rms_error, m_rms_dlambda, NULL
+#ifdef PENETRATION_JVERROR_CORRECTION
+      , Jvnew_final, Jvnew
+#endif
+      );
 
 #ifdef PENETRATION_JVERROR_CORRECTION
     Jvnew_final = Jvnew*stepsize1;
@@ -813,49 +942,11 @@ static void* ComputeRows(void *p)
 
     // DO WE NEED TO COMPUTE NORM ACROSS ENTIRE SOLUTION SPACE (0,m)?
     // since local convergence might produce errors in other nodes?
-    dReal dlambda_bilateral_mean = 0.0;
-    dReal dlambda_contact_normal_mean = 0.0;
-    dReal dlambda_contact_friction_mean = 0.0;
-    dReal dlambda_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      dlambda_bilateral_mean        = rms_dlambda[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      dlambda_contact_normal_mean   = rms_dlambda[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      dlambda_contact_friction_mean = rms_dlambda[2]/(dReal)m_rms_dlambda[2];
-    if (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2] > 0)
-      dlambda_total_mean = (rms_dlambda[0] + rms_dlambda[1] + rms_dlambda[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_dlambda[0] = sqrt(dlambda_bilateral_mean);
-    qs->rms_dlambda[1] = sqrt(dlambda_contact_normal_mean);
-    qs->rms_dlambda[2] = sqrt(dlambda_contact_friction_mean);
-    qs->rms_dlambda[3] = sqrt(dlambda_total_mean);
-
-    dReal residual_bilateral_mean = 0.0;
-    dReal residual_contact_normal_mean = 0.0;
-    dReal residual_contact_friction_mean = 0.0;
-    dReal residual_total_mean = 0.0;
-
-    if (m_rms_dlambda[0] > 0)
-      residual_bilateral_mean        = rms_error[0]/(dReal)m_rms_dlambda[0];
-    if (m_rms_dlambda[1] > 0)
-      residual_contact_normal_mean   = rms_error[1]/(dReal)m_rms_dlambda[1];
-    if (m_rms_dlambda[2] > 0)
-      residual_contact_friction_mean = rms_error[2]/(dReal)m_rms_dlambda[2];
-    if (rms_error[0] + rms_error[1] + rms_error[2] > 0)
-      residual_total_mean = (rms_error[0] + rms_error[1] + rms_error[2])/
-        ((dReal)(m_rms_dlambda[0] + m_rms_dlambda[1] + m_rms_dlambda[2]));
-
-    qs->rms_constraint_residual[0] = sqrt(residual_bilateral_mean);
-    qs->rms_constraint_residual[1] = sqrt(residual_contact_normal_mean);
-    qs->rms_constraint_residual[2] = sqrt(residual_contact_friction_mean);
-    qs->rms_constraint_residual[3] = sqrt(residual_total_mean);
-    qs->num_contacts = m_rms_dlambda[1];
+    UpdateRMS(qs, rms_dlambda, rms_error, m_rms_dlambda);
 
 #ifdef HDF5_INSTRUMENT
-    errors[iteration] = residual_total_mean;
+    errors[iteration] = qs->rms_constraint_residual[3] *
+      qs->rms_constraint_residual[3];
 #endif
     // debugging mutex locking
     //{
@@ -953,6 +1044,261 @@ static void* ComputeRows(void *p)
   return NULL;
 }
 
+#ifdef COLORED_ROWS
+//***************************************************************************
+// Number of rows solved by one task of the colored solver. It is fixed so
+// that the way a color is split into tasks, and therefore the order in
+// which the rms sums of the tasks are added up, does not depend on the
+// number of threads.
+static const int kColorBlockRows = 64;
+
+// a range of rows of one color, solved by a single task
+struct dxPGSLCPColorBlock {
+  const dxPGSLCPParameters *params;
+  int iteration;
+  int nStart;
+  int nEnd;
+  // rows packed by groups of kRowLanes, NULL to update rows one at a time
+  const quickstep::dxRowKernels *kernels;
+  const quickstep::dxRowPack *packs;
+  // rms sums of this block for the current iteration
+  dReal rms_dlambda[3];
+  dReal rms_error[3];
+  int m_rms_dlambda[3];
+};
+
+static void ComputeColorBlock(dxPGSLCPColorBlock *block)
+{
+  dSetZero(block->rms_dlambda, 3);
+  dSetZero(block->rms_error, 3);
+  block->m_rms_dlambda[0] = 0;
+  block->m_rms_dlambda[1] = 0;
+  block->m_rms_dlambda[2] = 0;
+
+  const dxPGSLCPParameters *params = block->params;
+  if (!block->packs || block->iteration < params->qs->precon_iterations)
+  {
+    ComputeRowRange(params, block->iteration, block->nStart, block->nEnd,
+      block->rms_dlambda, block->rms_error, block->m_rms_dlambda, NULL);
+    return;
+  }
+
+  // the rows of a pack act on distinct bodies, so J*caccel of all of them
+  // can be computed before any of them is solved, and caccel updated once
+  // they all are.
+  const quickstep::dxRowKernels *kernels = block->kernels;
+  const quickstep::dxRowPack *pack = block->packs;
+  for (int i = block->nStart; i < block->nEnd; i += quickstep::kRowLanes)
+  {
+    const int end = i + quickstep::kRowLanes < block->nEnd ?
+      i + quickstep::kRowLanes : block->nEnd;
+    quickstep::dxRowLanes lanes;
+    for (int l = 0; l < quickstep::kRowLanes; ++l)
+    {
+      lanes.delta[l] = 0;
+      lanes.delta_erp[l] = 0;
+    }
+    lanes.active = 0;
+    kernels->dots(pack, params->caccel, params->caccel_erp, &lanes);
+    ComputeRowRange(params, block->iteration, i, end, block->rms_dlambda,
+      block->rms_error, block->m_rms_dlambda, &lanes);
+    kernels->update(pack, &lanes, params->caccel, params->caccel_erp);
+    ++pack;
+  }
+}
+
+//***************************************************************************
+// Greedily assign the rows to colors so that no two rows of a color act
+// on the same body. Colors are filled one at a time by sweeping the rows
+// that are not colored yet in solver order, so the rows of a color keep
+// their relative order. colorOrder receives the rows sorted by color and
+// colorStart the first row of every color. Returns the number of colors.
+static int ColorRows(const int m, const int nb, const int *jb,
+  const IndexError *order, IndexError *colorOrder, int *colorStart,
+  int *pending, int *bodyColor)
+{
+  for (int b = 0; b < nb; ++b)
+    bodyColor[b] = -1;
+  for (int i = 0; i < m; ++i)
+    pending[i] = order[i].index;
+
+  int numPending = m;
+  int numColors = 0;
+  int filled = 0;
+  while (numPending > 0)
+  {
+    colorStart[numColors] = filled;
+    int kept = 0;
+    for (int i = 0; i < numPending; ++i)
+    {
+      const int index = pending[i];
+      const int b1 = jb[index*2];
+      const int b2 = jb[index*2+1];
+      if (bodyColor[b1] == numColors ||
+          (b2 >= 0 && bodyColor[b2] == numColors))
+      {
+        // a body of this row is already used by the current color
+        pending[kept++] = index;
+        continue;
+      }
+      bodyColor[b1] = numColors;
+      if (b2 >= 0)
+        bodyColor[b2] = numColors;
+      colorOrder[filled++].index = index;
+    }
+    numPending = kept;
+    ++numColors;
+  }
+  colorStart[numColors] = filled;
+  return numColors;
+}
+
+//***************************************************************************
+// PGS iterations with the rows grouped by graph color. The colors are
+// swept in sequence; the rows of a color touch disjoint bodies, so the
+// blocks of a color can be solved concurrently. The rms sums of the
+// blocks are added up in block order once the color is done, hence the
+// result does not depend on the number of threads or on scheduling.
+static void ComputeColoredRows(dxWorldProcessContext *context,
+  dxPGSLCPParameters *params, boost::threadpool::pool *row_threadpool)
+{
+  const int m = params->m;
+  const int nb = params->nb;
+  dxQuickStepParameters *qs = params->qs;
+
+  IndexError *colorOrder = context->AllocateArray<IndexError> (m);
+  int *colorStart = context->AllocateArray<int> (m + 1);
+  int *pending = context->AllocateArray<int> (m);
+  int *bodyColor = context->AllocateArray<int> (nb);
+  const int numColors = ColorRows(m, nb, params->jb, params->order,
+    colorOrder, colorStart, pending, bodyColor);
+  params->order = colorOrder;
+
+  // split every color into blocks, every color has at least one row
+  // so there are at most m blocks
+  int *blockStart = context->AllocateArray<int> (m + 1);
+  dxPGSLCPColorBlock *blocks =
+    context->AllocateArray<dxPGSLCPColorBlock> (m);
+  int numBlocks = 0;
+  for (int c = 0; c < numColors; ++c)
+  {
+    blockStart[c] = numBlocks;
+    for (int i = colorStart[c]; i < colorStart[c+1]; i += kColorBlockRows)
+    {
+      dxPGSLCPColorBlock &block = blocks[numBlocks++];
+      block.params = params;
+      block.nStart = i;
+      block.nEnd = i + kColorBlockRows < colorStart[c+1] ?
+        i + kColorBlockRows : colorStart[c+1];
+    }
+  }
+  blockStart[numColors] = numBlocks;
+
+  // pack the rows of the blocks for the row kernels. J and iMJ do not
+  // change during the iterations, so this is done once per step. Blocks
+  // too small to fill a pack are solved one row at a time.
+  const quickstep::dxRowKernels *kernels = qs->vectorized_rows ?
+    quickstep::GetRowKernels(qs->deterministic_rows) : NULL;
+  quickstep::dxRowPack *packs = NULL;
+  if (kernels)
+    packs = context->AllocateArray<quickstep::dxRowPack> (m);
+  int numPacks = 0;
+  for (int b = 0; b < numBlocks; ++b)
+  {
+    dxPGSLCPColorBlock &block = blocks[b];
+    block.kernels = kernels;
+    block.packs = NULL;
+    if (!kernels || block.nEnd - block.nStart < quickstep::kRowLanes)
+      continue;
+
+    block.packs = packs + numPacks;
+    for (int i = block.nStart; i < block.nEnd; i += quickstep::kRowLanes)
+    {
+      int index[quickstep::kRowLanes];
+      int count = 0;
+      for (; count < quickstep::kRowLanes && i + count < block.nEnd; ++count)
+        index[count] = colorOrder[i + count].index;
+      quickstep::PackRows(packs + numPacks++, index, count, params->jb,
+        params->J, params->iMJ);
+    }
+  }
+
+  // a pool with a single thread would only add scheduling overhead
+  const bool threaded = row_threadpool && row_threadpool->size() > 1;
+
+  int m_rms_dlambda[3];
+  m_rms_dlambda[0] = 0;
+  m_rms_dlambda[1] = 0;
+  m_rms_dlambda[2] = 0;
+  dReal rms_dlambda[4];
+  dSetZero(rms_dlambda, 4);
+  dReal rms_error[4];
+  dSetZero(rms_error, 4);
+
+  const int num_iterations = qs->num_iterations;
+  const int precon_iterations = qs->precon_iterations;
+  const int total_iterations = precon_iterations + num_iterations +
+    qs->friction_iterations;
+  for (int iteration = 0; iteration < total_iterations; ++iteration)
+  {
+    // same bookkeeping as ComputeRows, bilateral and contact normal
+    // sums are kept during the extra friction iterations.
+    rms_dlambda[2] = 0;
+    rms_error[2] = 0;
+    m_rms_dlambda[2] = 0;
+    if (iteration < num_iterations + precon_iterations)
+    {
+      rms_dlambda[0] = 0;
+      rms_dlambda[1] = 0;
+      rms_error[0] = 0;
+      rms_error[1] = 0;
+      m_rms_dlambda[0] = 0;
+      m_rms_dlambda[1] = 0;
+    }
+
+    for (int c = 0; c < numColors; ++c)
+    {
+      const int first = blockStart[c];
+      const int last = blockStart[c+1];
+      for (int b = first; b < last; ++b)
+        blocks[b].iteration = iteration;
+
+      if (threaded && last - first > 1)
+      {
+        for (int b = first; b < last; ++b)
+        {
+          dxPGSLCPColorBlock *block = blocks + b;
+          row_threadpool->schedule([block]() { ComputeColorBlock(block); });
+        }
+        row_threadpool->wait();
+      }
+      else
+      {
+        for (int b = first; b < last; ++b)
+          ComputeColorBlock(blocks + b);
+      }
+
+      for (int b = first; b < last; ++b)
+      {
+        for (int k = 0; k < 3; ++k)
+        {
+          rms_dlambda[k] += blocks[b].rms_dlambda[k];
+          rms_error[k] += blocks[b].rms_error[k];
+          m_rms_dlambda[k] += blocks[b].m_rms_dlambda[k];
+        }
+      }
+    }
+
+    UpdateRMS(qs, rms_dlambda, rms_error, m_rms_dlambda);
+
+    // option to stop when tolerance has been met
+    if (iteration >= precon_iterations &&
+        qs->rms_constraint_residual[3] < qs->pgs_lcp_tolerance)
+      break;
+  }
+}
+#endif
+
 //***************************************************************************
 // PGS_LCP method was previously SOR_LCP
 //
@@ -975,11 +1321,7 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
   dRealMutablePtr caccel, dRealMutablePtr caccel_erp, dRealMutablePtr cforce,
   dRealMutablePtr rhs, dRealMutablePtr rhs_erp, dRealMutablePtr rhs_precon,
   dRealPtr lo, dRealPtr hi, dRealPtr cfm, const int *findex,
-  dxQuickStepParameters *qs
-#ifdef USE_TPROW
-  , boost::threadpool::pool* row_threadpool
-#endif
-  )
+  dxQuickStepParameters *qs, boost::threadpool::pool* row_threadpool)
 {
 
   // precompute iMJ = inv(M)*J'
@@ -1190,6 +1532,55 @@ void quickstep::PGS_LCP (dxWorldProcessContext *context,
     }
 #endif
 
+#ifdef COLORED_ROWS
+  // cone friction looks up the neighboring friction row in the solver
+  // order, which the coloring does not preserve.
+  if (qs->colored_rows && m > 0 && qs->friction_model != cone_friction)
+  {
+    // position correction is always solved inline, the colored solver
+    // is already threaded.
+    dxPGSLCPParameters params;
+    params.thread_id = 0;
+    params.order = order;
+    params.body = body;
+    params.mutex = NULL;
+    params.inline_position_correction = true;
+    params.position_correction_thread = false;
+    params.qs = qs;
+    params.nStart = 0;
+    params.nChunkSize = m;
+    params.m = m;
+    params.nb = nb;
+    params.jb = jb;
+    params.findex = findex;
+    params.skip_friction = false;
+    params.hi = hi;
+    params.lo = lo;
+    params.invMOI = invMOI;
+    params.MOI = MOI;
+    params.Ad = Ad;
+    params.Adcfm = Adcfm;
+    params.Adcfm_precon = Adcfm_precon;
+    params.J = J;
+    params.iMJ = iMJ;
+    params.rhs_precon = rhs_precon;
+    params.J_precon = J_precon;
+    params.J_orig = J_orig;
+    params.cforce = cforce;
+    params.rhs = rhs;
+    params.caccel = caccel;
+    params.lambda = lambda;
+    params.rhs_erp = rhs_erp;
+    params.caccel_erp = caccel_erp;
+    params.lambda_erp = lambda_erp;
+
+    IFTIMING (dTimerNow ("start colored pgs rows"));
+    ComputeColoredRows(context, &params, row_threadpool);
+    IFTIMING (dTimerNow ("colored pgs rows done"));
+    return;
+  }
+#endif
+
 #ifdef REORDER_CONSTRAINTS
   // the lambda computed at the previous iteration.
   // this is used to measure error for when we are reordering the indexes.
@@ -1569,7 +1960,7 @@ void quickstep::dxConeFrictionModel(dReal& lo_act, dReal& hi_act, dReal& lo_act_
   } // if-else (abs(v)< eps)
 }
 
-size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
+size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int nb)
 {
   size_t res = dEFFICIENT_SIZE(sizeof(dReal) * 12 * m); // for iMJ
   res += dEFFICIENT_SIZE(sizeof(dReal) * m); // for Ad
@@ -1585,6 +1976,15 @@ size_t quickstep::EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/)
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params_erp
   res += dEFFICIENT_SIZE(sizeof(dxPGSLCPParameters) * m); // for params
   res += dEFFICIENT_SIZE(sizeof(boost::recursive_mutex)); // for mutex
+#ifdef COLORED_ROWS
+  res += dEFFICIENT_SIZE(sizeof(IndexError) * m); // for colorOrder
+  res += dEFFICIENT_SIZE(sizeof(int) * (m + 1)); // for colorStart
+  res += dEFFICIENT_SIZE(sizeof(int) * m); // for pending
+  res += dEFFICIENT_SIZE(sizeof(int) * nb); // for bodyColor
+  res += dEFFICIENT_SIZE(sizeof(int) * (m + 1)); // for blockStart
+  res += dEFFICIENT_SIZE(sizeof(dxPGSLCPColorBlock) * m); // for blocks
+  res += dEFFICIENT_SIZE(sizeof(quickstep::dxRowPack) * m); // for packs
+#endif
   return res;
 }
 
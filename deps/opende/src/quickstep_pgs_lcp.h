@@ -43,11 +43,7 @@ void PGS_LCP (dxWorldProcessContext *context,
   dRealMutablePtr caccel, dRealMutablePtr caccel_erp, dRealMutablePtr cforce,
   dRealMutablePtr rhs, dRealMutablePtr rhs_erp, dRealMutablePtr rhs_precon,
   dRealPtr lo, dRealPtr hi, dRealPtr cfm, const int *findex,
-  dxQuickStepParameters *qs
-#ifdef USE_TPROW
-  , boost::threadpool::pool* row_threadpool
-#endif
-  );
+  dxQuickStepParameters *qs, boost::threadpool::pool* row_threadpool);
 
 /// \brief Compute the hi and lo bound for cone friction model to project onto
 /// \param[in] lo_act The low bound for cone friction model to project onto
@@ -74,7 +70,7 @@ void dxConeFrictionModel(dReal& lo_act, dReal& hi_act, dReal& lo_act_erp, dReal&
     int nRows, const int nb, dxBody * const *body, int i, const IndexError *order,
     const int *findex, dRealPtr lo, dRealPtr hi, dRealMutablePtr lambda, dRealMutablePtr lambda_erp);
 
-size_t EstimatePGS_LCPMemoryRequirements(int m,int /*nb*/);
+size_t EstimatePGS_LCPMemoryRequirements(int m,int nb);
 
     } // namespace quickstep
 } // namespace ode
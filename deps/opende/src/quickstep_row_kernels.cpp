@@ -0,0 +1,585 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001,2002 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+// Row kernels of the colored PGS solver. A kernel computes the J*caccel
+// products of kRowLanes rows at once, or adds delta*iMJ of kRowLanes rows
+// to caccel. The caccel rows of the bodies are transposed into vectors on
+// load and back on store, J and iMJ are already packed by lane.
+//
+// The deterministic kernels reproduce the scalar code exactly: products
+// are added up in the same order as quickstep::dot6 (which depends on
+// ODE_SSE) and no multiply is fused with an add. This holds as long as
+// the scalar code is not compiled with floating point contraction, which
+// is the case on x86 unless FMA is enabled for the whole build.
+
+#include <gazebo/ode/common.h>
+#include "config.h"
+#include "objects.h"
+#include "joints/joint.h"
+#include "quickstep_row_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ROW_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX kernels are compiled with a function target attribute and selected
+// at run time, so the rest of the library does not require AVX.
+#if defined(ROW_KERNELS_SSE2) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define ROW_KERNELS_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define ROW_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace ode;
+using namespace ode::quickstep;
+
+// sum of the six products p0 to p5, in the order used by dot6. The
+// kernels are written out for the six coefficients instead of looping
+// over arrays of vectors, which compilers tend to keep in memory.
+#ifdef ODE_SSE
+#define ROW_DOT6(add, p0, p1, p2, p3, p4, p5) \
+  add(add(add(p0, p2), p4), add(add(p1, p3), p5))
+#else
+#define ROW_DOT6(add, p0, p1, p2, p3, p4, p5) \
+  add(add(add(add(add(p0, p1), p2), p3), p4), p5)
+#endif
+
+//***************************************************************************
+// packing
+
+void quickstep::PackRows (dxRowPack *pack, const int *index, const int count,
+  const int *jb, dRealPtr J, dRealPtr iMJ)
+{
+  pack->mask[0] = 0;
+  pack->mask[1] = 0;
+  for (int l = 0; l < kRowLanes; ++l)
+  {
+    if (l < count)
+    {
+      const int row = index[l];
+      const int b1 = jb[row*2];
+      const int b2 = jb[row*2+1];
+      dRealPtr J_ptr = J + row*12;
+      dRealPtr iMJ_ptr = iMJ + row*12;
+      // the body 2 half of iMJ is not computed for single body rows,
+      // zeros keep uninitialized values out of the vector lanes.
+      const int n = b2 >= 0 ? 12 : 6;
+      for (int k = 0; k < 12; ++k)
+      {
+        pack->J[k][l] = k < n ? J_ptr[k] : 0;
+        pack->iMJ[k][l] = k < n ? iMJ_ptr[k] : 0;
+      }
+      pack->offset[0][l] = 6*b1;
+      pack->offset[1][l] = 6*(b2 >= 0 ? b2 : b1);
+      pack->mask[0] |= 1 << l;
+      if (b2 >= 0)
+        pack->mask[1] |= 1 << l;
+    }
+    else
+    {
+      for (int k = 0; k < 12; ++k)
+      {
+        pack->J[k][l] = 0;
+        pack->iMJ[k][l] = 0;
+      }
+      pack->offset[0][l] = pack->offset[0][0];
+      pack->offset[1][l] = pack->offset[0][0];
+    }
+  }
+}
+
+#ifdef ROW_KERNELS_SSE2
+//***************************************************************************
+// SSE2 kernels, two lanes per vector
+
+// J*caccel of lanes l and l+1 of one set, the transposed caccel rows are
+// stored in acc
+static inline void DotsSSE2Pair (const dReal (*J)[kRowLanes], dRealPtr a,
+  dRealPtr b, const int l, dReal (*acc)[kRowLanes], dReal *dot)
+{
+  const __m128d a0 = _mm_loadu_pd(a);
+  const __m128d b0 = _mm_loadu_pd(b);
+  const __m128d a2 = _mm_loadu_pd(a + 2);
+  const __m128d b2 = _mm_loadu_pd(b + 2);
+  const __m128d a4 = _mm_loadu_pd(a + 4);
+  const __m128d b4 = _mm_loadu_pd(b + 4);
+  const __m128d c0 = _mm_unpacklo_pd(a0, b0);
+  const __m128d c1 = _mm_unpackhi_pd(a0, b0);
+  const __m128d c2 = _mm_unpacklo_pd(a2, b2);
+  const __m128d c3 = _mm_unpackhi_pd(a2, b2);
+  const __m128d c4 = _mm_unpacklo_pd(a4, b4);
+  const __m128d c5 = _mm_unpackhi_pd(a4, b4);
+  _mm_storeu_pd(acc[0] + l, c0);
+  _mm_storeu_pd(acc[1] + l, c1);
+  _mm_storeu_pd(acc[2] + l, c2);
+  _mm_storeu_pd(acc[3] + l, c3);
+  _mm_storeu_pd(acc[4] + l, c4);
+  _mm_storeu_pd(acc[5] + l, c5);
+
+  const __m128d p0 = _mm_mul_pd(c0, _mm_loadu_pd(J[0] + l));
+  const __m128d p1 = _mm_mul_pd(c1, _mm_loadu_pd(J[1] + l));
+  const __m128d p2 = _mm_mul_pd(c2, _mm_loadu_pd(J[2] + l));
+  const __m128d p3 = _mm_mul_pd(c3, _mm_loadu_pd(J[3] + l));
+  const __m128d p4 = _mm_mul_pd(c4, _mm_loadu_pd(J[4] + l));
+  const __m128d p5 = _mm_mul_pd(c5, _mm_loadu_pd(J[5] + l));
+  _mm_storeu_pd(dot + l, ROW_DOT6(_mm_add_pd, p0, p1, p2, p3, p4, p5));
+}
+
+// caccel += delta * iMJ for lanes l and l+1 of one set
+static inline void UpdateSSE2Pair (const dReal (*iMJ)[kRowLanes],
+  const dReal (*acc)[kRowLanes], const dReal *delta, const int l,
+  const int mask, dRealMutablePtr a, dRealMutablePtr b)
+{
+  const __m128d d = _mm_loadu_pd(delta + l);
+  const __m128d c0 = _mm_add_pd(_mm_loadu_pd(acc[0] + l),
+    _mm_mul_pd(d, _mm_loadu_pd(iMJ[0] + l)));
+  const __m128d c1 = _mm_add_pd(_mm_loadu_pd(acc[1] + l),
+    _mm_mul_pd(d, _mm_loadu_pd(iMJ[1] + l)));
+  const __m128d c2 = _mm_add_pd(_mm_loadu_pd(acc[2] + l),
+    _mm_mul_pd(d, _mm_loadu_pd(iMJ[2] + l)));
+  const __m128d c3 = _mm_add_pd(_mm_loadu_pd(acc[3] + l),
+    _mm_mul_pd(d, _mm_loadu_pd(iMJ[3] + l)));
+  const __m128d c4 = _mm_add_pd(_mm_loadu_pd(acc[4] + l),
+    _mm_mul_pd(d, _mm_loadu_pd(iMJ[4] + l)));
+  const __m128d c5 = _mm_add_pd(_mm_loadu_pd(acc[5] + l),
+    _mm_mul_pd(d, _mm_loadu_pd(iMJ[5] + l)));
+  if (mask & (1 << l))
+  {
+    _mm_storeu_pd(a, _mm_unpacklo_pd(c0, c1));
+    _mm_storeu_pd(a + 2, _mm_unpacklo_pd(c2, c3));
+    _mm_storeu_pd(a + 4, _mm_unpacklo_pd(c4, c5));
+  }
+  if (mask & (2 << l))
+  {
+    _mm_storeu_pd(b, _mm_unpackhi_pd(c0, c1));
+    _mm_storeu_pd(b + 2, _mm_unpackhi_pd(c2, c3));
+    _mm_storeu_pd(b + 4, _mm_unpackhi_pd(c4, c5));
+  }
+}
+
+static void DotsSSE2 (const dxRowPack *pack, dRealPtr caccel,
+  dRealPtr caccel_erp, dxRowLanes *lanes)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+    DotsSSE2Pair(pack->J + 6*side, rows[0], rows[1], 0,
+      lanes->accel[set], lanes->dot[set]);
+    DotsSSE2Pair(pack->J + 6*side, rows[2], rows[3], 2,
+      lanes->accel[set], lanes->dot[set]);
+  }
+}
+
+static void UpdateSSE2 (const dxRowPack *pack, const dxRowLanes *lanes,
+  dRealMutablePtr caccel, dRealMutablePtr caccel_erp)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    const int mask = pack->mask[side] & lanes->active;
+    if (!mask)
+      continue;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+    const dReal *delta = set < 2 ? lanes->delta : lanes->delta_erp;
+    UpdateSSE2Pair(pack->iMJ + 6*side, lanes->accel[set], delta, 0, mask,
+      const_cast<dRealMutablePtr>(rows[0]),
+      const_cast<dRealMutablePtr>(rows[1]));
+    UpdateSSE2Pair(pack->iMJ + 6*side, lanes->accel[set], delta, 2, mask,
+      const_cast<dRealMutablePtr>(rows[2]),
+      const_cast<dRealMutablePtr>(rows[3]));
+  }
+}
+
+static const dxRowKernels sse2_kernels = {
+  "sse2", DotsSSE2, UpdateSSE2
+};
+#endif
+
+#ifdef ROW_KERNELS_AVX
+//***************************************************************************
+// AVX kernels, four lanes per vector
+
+#define ROW_AVX __attribute__((target("avx")))
+#define ROW_AVX_FMA __attribute__((target("avx,fma")))
+#define ROW_AVX_INLINE __attribute__((target("avx"), always_inline)) inline
+
+// coefficients 0 to 5 of rows r[0] to r[3] in c0 to c5, by a 4x4 and a
+// 4x2 transpose. The transposed rows are also stored in acc.
+static ROW_AVX_INLINE void Gather4 (const dRealPtr *r, dReal (*acc)[kRowLanes],
+  __m256d &c0, __m256d &c1, __m256d &c2, __m256d &c3, __m256d &c4,
+  __m256d &c5)
+{
+  const __m256d a0 = _mm256_loadu_pd(r[0]);
+  const __m256d a1 = _mm256_loadu_pd(r[1]);
+  const __m256d a2 = _mm256_loadu_pd(r[2]);
+  const __m256d a3 = _mm256_loadu_pd(r[3]);
+  const __m256d t0 = _mm256_unpacklo_pd(a0, a1);
+  const __m256d t1 = _mm256_unpackhi_pd(a0, a1);
+  const __m256d t2 = _mm256_unpacklo_pd(a2, a3);
+  const __m256d t3 = _mm256_unpackhi_pd(a2, a3);
+  c0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+  c1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+  c2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+  c3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+
+  const __m256d u0 = _mm256_insertf128_pd(
+    _mm256_castpd128_pd256(_mm_loadu_pd(r[0] + 4)), _mm_loadu_pd(r[2] + 4), 1);
+  const __m256d u1 = _mm256_insertf128_pd(
+    _mm256_castpd128_pd256(_mm_loadu_pd(r[1] + 4)), _mm_loadu_pd(r[3] + 4), 1);
+  c4 = _mm256_unpacklo_pd(u0, u1);
+  c5 = _mm256_unpackhi_pd(u0, u1);
+
+  _mm256_storeu_pd(acc[0], c0);
+  _mm256_storeu_pd(acc[1], c1);
+  _mm256_storeu_pd(acc[2], c2);
+  _mm256_storeu_pd(acc[3], c3);
+  _mm256_storeu_pd(acc[4], c4);
+  _mm256_storeu_pd(acc[5], c5);
+}
+
+// inverse of Gather4, only the rows whose bit is set in mask are stored
+static ROW_AVX_INLINE void Scatter4 (const __m256d c0, const __m256d c1,
+  const __m256d c2, const __m256d c3, const __m256d c4, const __m256d c5,
+  const dRealPtr *r, const int mask)
+{
+  const __m256d t0 = _mm256_unpacklo_pd(c0, c1);
+  const __m256d t1 = _mm256_unpackhi_pd(c0, c1);
+  const __m256d t2 = _mm256_unpacklo_pd(c2, c3);
+  const __m256d t3 = _mm256_unpackhi_pd(c2, c3);
+  const __m256d u0 = _mm256_unpacklo_pd(c4, c5);
+  const __m256d u1 = _mm256_unpackhi_pd(c4, c5);
+
+  if (mask & 1)
+  {
+    dRealMutablePtr row = const_cast<dRealMutablePtr>(r[0]);
+    _mm256_storeu_pd(row, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm_storeu_pd(row + 4, _mm256_castpd256_pd128(u0));
+  }
+  if (mask & 2)
+  {
+    dRealMutablePtr row = const_cast<dRealMutablePtr>(r[1]);
+    _mm256_storeu_pd(row, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm_storeu_pd(row + 4, _mm256_castpd256_pd128(u1));
+  }
+  if (mask & 4)
+  {
+    dRealMutablePtr row = const_cast<dRealMutablePtr>(r[2]);
+    _mm256_storeu_pd(row, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm_storeu_pd(row + 4, _mm256_extractf128_pd(u0, 1));
+  }
+  if (mask & 8)
+  {
+    dRealMutablePtr row = const_cast<dRealMutablePtr>(r[3]);
+    _mm256_storeu_pd(row, _mm256_permute2f128_pd(t1, t3, 0x31));
+    _mm_storeu_pd(row + 4, _mm256_extractf128_pd(u1, 1));
+  }
+}
+
+static ROW_AVX void DotsAVX (const dxRowPack *pack, dRealPtr caccel,
+  dRealPtr caccel_erp, dxRowLanes *lanes)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+    __m256d c0, c1, c2, c3, c4, c5;
+    Gather4(rows, lanes->accel[set], c0, c1, c2, c3, c4, c5);
+
+    const dReal (*J)[kRowLanes] = pack->J + 6*side;
+    const __m256d p0 = _mm256_mul_pd(c0, _mm256_loadu_pd(J[0]));
+    const __m256d p1 = _mm256_mul_pd(c1, _mm256_loadu_pd(J[1]));
+    const __m256d p2 = _mm256_mul_pd(c2, _mm256_loadu_pd(J[2]));
+    const __m256d p3 = _mm256_mul_pd(c3, _mm256_loadu_pd(J[3]));
+    const __m256d p4 = _mm256_mul_pd(c4, _mm256_loadu_pd(J[4]));
+    const __m256d p5 = _mm256_mul_pd(c5, _mm256_loadu_pd(J[5]));
+    _mm256_storeu_pd(lanes->dot[set],
+      ROW_DOT6(_mm256_add_pd, p0, p1, p2, p3, p4, p5));
+  }
+}
+
+static ROW_AVX void UpdateAVX (const dxRowPack *pack, const dxRowLanes *lanes,
+  dRealMutablePtr caccel, dRealMutablePtr caccel_erp)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    const int mask = pack->mask[side] & lanes->active;
+    if (!mask)
+      continue;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+
+    const __m256d d = _mm256_loadu_pd(set < 2 ? lanes->delta :
+      lanes->delta_erp);
+    const dReal (*acc)[kRowLanes] = lanes->accel[set];
+    const dReal (*iMJ)[kRowLanes] = pack->iMJ + 6*side;
+    Scatter4(
+      _mm256_add_pd(_mm256_loadu_pd(acc[0]),
+        _mm256_mul_pd(d, _mm256_loadu_pd(iMJ[0]))),
+      _mm256_add_pd(_mm256_loadu_pd(acc[1]),
+        _mm256_mul_pd(d, _mm256_loadu_pd(iMJ[1]))),
+      _mm256_add_pd(_mm256_loadu_pd(acc[2]),
+        _mm256_mul_pd(d, _mm256_loadu_pd(iMJ[2]))),
+      _mm256_add_pd(_mm256_loadu_pd(acc[3]),
+        _mm256_mul_pd(d, _mm256_loadu_pd(iMJ[3]))),
+      _mm256_add_pd(_mm256_loadu_pd(acc[4]),
+        _mm256_mul_pd(d, _mm256_loadu_pd(iMJ[4]))),
+      _mm256_add_pd(_mm256_loadu_pd(acc[5]),
+        _mm256_mul_pd(d, _mm256_loadu_pd(iMJ[5]))),
+      rows, mask);
+  }
+}
+
+static const dxRowKernels avx_kernels = {
+  "avx", DotsAVX, UpdateAVX
+};
+
+static ROW_AVX_FMA void DotsAVXFMA (const dxRowPack *pack, dRealPtr caccel,
+  dRealPtr caccel_erp, dxRowLanes *lanes)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+    __m256d c0, c1, c2, c3, c4, c5;
+    Gather4(rows, lanes->accel[set], c0, c1, c2, c3, c4, c5);
+
+    const dReal (*J)[kRowLanes] = pack->J + 6*side;
+    __m256d sum = _mm256_mul_pd(c0, _mm256_loadu_pd(J[0]));
+    sum = _mm256_fmadd_pd(c1, _mm256_loadu_pd(J[1]), sum);
+    sum = _mm256_fmadd_pd(c2, _mm256_loadu_pd(J[2]), sum);
+    sum = _mm256_fmadd_pd(c3, _mm256_loadu_pd(J[3]), sum);
+    sum = _mm256_fmadd_pd(c4, _mm256_loadu_pd(J[4]), sum);
+    sum = _mm256_fmadd_pd(c5, _mm256_loadu_pd(J[5]), sum);
+    _mm256_storeu_pd(lanes->dot[set], sum);
+  }
+}
+
+static ROW_AVX_FMA void UpdateAVXFMA (const dxRowPack *pack,
+  const dxRowLanes *lanes, dRealMutablePtr caccel, dRealMutablePtr caccel_erp)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    const int mask = pack->mask[side] & lanes->active;
+    if (!mask)
+      continue;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+
+    const __m256d d = _mm256_loadu_pd(set < 2 ? lanes->delta :
+      lanes->delta_erp);
+    const dReal (*acc)[kRowLanes] = lanes->accel[set];
+    const dReal (*iMJ)[kRowLanes] = pack->iMJ + 6*side;
+    Scatter4(
+      _mm256_fmadd_pd(d, _mm256_loadu_pd(iMJ[0]), _mm256_loadu_pd(acc[0])),
+      _mm256_fmadd_pd(d, _mm256_loadu_pd(iMJ[1]), _mm256_loadu_pd(acc[1])),
+      _mm256_fmadd_pd(d, _mm256_loadu_pd(iMJ[2]), _mm256_loadu_pd(acc[2])),
+      _mm256_fmadd_pd(d, _mm256_loadu_pd(iMJ[3]), _mm256_loadu_pd(acc[3])),
+      _mm256_fmadd_pd(d, _mm256_loadu_pd(iMJ[4]), _mm256_loadu_pd(acc[4])),
+      _mm256_fmadd_pd(d, _mm256_loadu_pd(iMJ[5]), _mm256_loadu_pd(acc[5])),
+      rows, mask);
+  }
+}
+
+static const dxRowKernels avx_fma_kernels = {
+  "avx_fma", DotsAVXFMA, UpdateAVXFMA
+};
+
+struct dxRowCPUFeatures {
+  bool avx;
+  bool fma;
+  dxRowCPUFeatures() {
+    __builtin_cpu_init();
+    avx = __builtin_cpu_supports("avx");
+    fma = avx && __builtin_cpu_supports("fma");
+  }
+};
+#endif
+
+#ifdef ROW_KERNELS_NEON
+//***************************************************************************
+// NEON kernels, two lanes per vector. They are only used when results do
+// not have to be deterministic, since the compiler may contract the
+// scalar code into fused multiply-adds on this architecture.
+
+static inline void DotsNEONPair (const dReal (*J)[kRowLanes], dRealPtr a,
+  dRealPtr b, const int l, dReal (*acc)[kRowLanes], dReal *dot)
+{
+  const float64x2_t a0 = vld1q_f64(a);
+  const float64x2_t b0 = vld1q_f64(b);
+  const float64x2_t a2 = vld1q_f64(a + 2);
+  const float64x2_t b2 = vld1q_f64(b + 2);
+  const float64x2_t a4 = vld1q_f64(a + 4);
+  const float64x2_t b4 = vld1q_f64(b + 4);
+  const float64x2_t c0 = vzip1q_f64(a0, b0);
+  const float64x2_t c1 = vzip2q_f64(a0, b0);
+  const float64x2_t c2 = vzip1q_f64(a2, b2);
+  const float64x2_t c3 = vzip2q_f64(a2, b2);
+  const float64x2_t c4 = vzip1q_f64(a4, b4);
+  const float64x2_t c5 = vzip2q_f64(a4, b4);
+  vst1q_f64(acc[0] + l, c0);
+  vst1q_f64(acc[1] + l, c1);
+  vst1q_f64(acc[2] + l, c2);
+  vst1q_f64(acc[3] + l, c3);
+  vst1q_f64(acc[4] + l, c4);
+  vst1q_f64(acc[5] + l, c5);
+
+  float64x2_t sum = vmulq_f64(c0, vld1q_f64(J[0] + l));
+  sum = vfmaq_f64(sum, c1, vld1q_f64(J[1] + l));
+  sum = vfmaq_f64(sum, c2, vld1q_f64(J[2] + l));
+  sum = vfmaq_f64(sum, c3, vld1q_f64(J[3] + l));
+  sum = vfmaq_f64(sum, c4, vld1q_f64(J[4] + l));
+  sum = vfmaq_f64(sum, c5, vld1q_f64(J[5] + l));
+  vst1q_f64(dot + l, sum);
+}
+
+static inline void UpdateNEONPair (const dReal (*iMJ)[kRowLanes],
+  const dReal (*acc)[kRowLanes], const dReal *delta, const int l,
+  const int mask, dRealMutablePtr a, dRealMutablePtr b)
+{
+  const float64x2_t d = vld1q_f64(delta + l);
+  const float64x2_t c0 =
+    vfmaq_f64(vld1q_f64(acc[0] + l), d, vld1q_f64(iMJ[0] + l));
+  const float64x2_t c1 =
+    vfmaq_f64(vld1q_f64(acc[1] + l), d, vld1q_f64(iMJ[1] + l));
+  const float64x2_t c2 =
+    vfmaq_f64(vld1q_f64(acc[2] + l), d, vld1q_f64(iMJ[2] + l));
+  const float64x2_t c3 =
+    vfmaq_f64(vld1q_f64(acc[3] + l), d, vld1q_f64(iMJ[3] + l));
+  const float64x2_t c4 =
+    vfmaq_f64(vld1q_f64(acc[4] + l), d, vld1q_f64(iMJ[4] + l));
+  const float64x2_t c5 =
+    vfmaq_f64(vld1q_f64(acc[5] + l), d, vld1q_f64(iMJ[5] + l));
+  if (mask & (1 << l))
+  {
+    vst1q_f64(a, vzip1q_f64(c0, c1));
+    vst1q_f64(a + 2, vzip1q_f64(c2, c3));
+    vst1q_f64(a + 4, vzip1q_f64(c4, c5));
+  }
+  if (mask & (2 << l))
+  {
+    vst1q_f64(b, vzip2q_f64(c0, c1));
+    vst1q_f64(b + 2, vzip2q_f64(c2, c3));
+    vst1q_f64(b + 4, vzip2q_f64(c4, c5));
+  }
+}
+
+static void DotsNEON (const dxRowPack *pack, dRealPtr caccel,
+  dRealPtr caccel_erp, dxRowLanes *lanes)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+    DotsNEONPair(pack->J + 6*side, rows[0], rows[1], 0,
+      lanes->accel[set], lanes->dot[set]);
+    DotsNEONPair(pack->J + 6*side, rows[2], rows[3], 2,
+      lanes->accel[set], lanes->dot[set]);
+  }
+}
+
+static void UpdateNEON (const dxRowPack *pack, const dxRowLanes *lanes,
+  dRealMutablePtr caccel, dRealMutablePtr caccel_erp)
+{
+  const int sets = caccel_erp ? 4 : 2;
+  for (int set = 0; set < sets; ++set)
+  {
+    const int side = set & 1;
+    const int mask = pack->mask[side] & lanes->active;
+    if (!mask)
+      continue;
+    dRealPtr base = set < 2 ? caccel : caccel_erp;
+    const int *off = pack->offset[side];
+    const dRealPtr rows[kRowLanes] = {
+      base + off[0], base + off[1], base + off[2], base + off[3]};
+    const dReal *delta = set < 2 ? lanes->delta : lanes->delta_erp;
+    UpdateNEONPair(pack->iMJ + 6*side, lanes->accel[set], delta, 0, mask,
+      const_cast<dRealMutablePtr>(rows[0]),
+      const_cast<dRealMutablePtr>(rows[1]));
+    UpdateNEONPair(pack->iMJ + 6*side, lanes->accel[set], delta, 2, mask,
+      const_cast<dRealMutablePtr>(rows[2]),
+      const_cast<dRealMutablePtr>(rows[3]));
+  }
+}
+
+static const dxRowKernels neon_fma_kernels = {
+  "neon_fma", DotsNEON, UpdateNEON
+};
+#endif
+
+//***************************************************************************
+// selection
+
+const dxRowKernels *quickstep::GetRowKernels (const bool deterministic)
+{
+#ifdef ROW_KERNELS_AVX
+  static const dxRowCPUFeatures features;
+  if (!deterministic && features.fma)
+    return &avx_fma_kernels;
+  if (features.avx)
+    return &avx_kernels;
+#endif
+#if defined(ROW_KERNELS_SSE2)
+  (void)deterministic;
+  return &sse2_kernels;
+#elif defined(ROW_KERNELS_NEON)
+  return deterministic ? NULL : &neon_fma_kernels;
+#else
+  (void)deterministic;
+  return NULL;
+#endif
+}
@@ -0,0 +1,94 @@
+/*************************************************************************
+ *                                                                       *
+ * Open Dynamics Engine, Copyright (C) 2001,2002 Russell L. Smith.       *
+ * All rights reserved.  Email: russ@q12.org   Web: www.q12.org          *
+ *                                                                       *
+ * This library is free software; you can redistribute it and/or         *
+ * modify it under the terms of EITHER:                                  *
+ *   (1) The GNU Lesser General Public License as published by the Free  *
+ *       Software Foundation; either version 2.1 of the License, or (at  *
+ *       your option) any later version. The text of the GNU Lesser      *
+ *       General Public License is included with this library in the     *
+ *       file LICENSE.TXT.                                               *
+ *   (2) The BSD-style license that is included with this library in     *
+ *       the file LICENSE-BSD.TXT.                                       *
+ *                                                                       *
+ * This library is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the files    *
+ * LICENSE.TXT and LICENSE-BSD.TXT for more details.                     *
+ *                                                                       *
+ *************************************************************************/
+
+#ifndef _ODE_QUICK_STEP_ROW_KERNELS_H_
+#define _ODE_QUICK_STEP_ROW_KERNELS_H_
+
+#include <gazebo/ode/common.h>
+#include "quickstep_util.h"
+
+namespace ode {
+    namespace quickstep{
+
+// number of constraint rows handled together by the row kernels
+static const int kRowLanes = 4;
+
+// J and iMJ of up to kRowLanes constraint rows in structure of arrays
+// layout: coefficient k of the row in lane l is stored at [k][l], so a
+// coefficient of all the rows is loaded at once. The rows of a pack must
+// not share bodies. Unused lanes have zero coefficients and read the
+// bodies of lane 0, they are never written back.
+struct dxRowPack {
+  dReal J[12][kRowLanes];
+  dReal iMJ[12][kRowLanes];
+  // offset in caccel of body 1 (side 0) and body 2 (side 1) of every
+  // lane; lanes without a second body read the row of their first body
+  int offset[2][kRowLanes];
+  // bit l is set if lane l has a body on that side
+  int mask[2];
+};
+
+// per lane values exchanged between the row kernels and the scalar part
+// of a PGS row update (lambda clamping, friction bounds, rms sums).
+// Sets are caccel of body 1 and body 2, then caccel_erp of body 1 and 2.
+struct dxRowLanes {
+  // caccel rows loaded by the dot kernel, kept for the update kernel
+  dReal accel[4][6][kRowLanes];
+  // J*caccel of every set
+  dReal dot[4][kRowLanes];
+  // lambda and lambda_erp change of the row
+  dReal delta[kRowLanes];
+  dReal delta_erp[kRowLanes];
+  // bit l is set if caccel must be updated with the delta of lane l
+  int active;
+};
+
+// J*caccel products of all the lanes of a pack, caccel_erp may be NULL
+typedef void dxRowDotsFn (const dxRowPack *pack, dRealPtr caccel,
+  dRealPtr caccel_erp, dxRowLanes *lanes);
+
+// caccel += delta * iMJ for the active lanes of a pack, starting from the
+// caccel values loaded by the dot kernel
+typedef void dxRowUpdateFn (const dxRowPack *pack, const dxRowLanes *lanes,
+  dRealMutablePtr caccel, dRealMutablePtr caccel_erp);
+
+struct dxRowKernels {
+  const char *name;
+  dxRowDotsFn *dots;
+  dxRowUpdateFn *update;
+};
+
+// Fill a pack with rows index[0] to index[count-1], count <= kRowLanes.
+void PackRows (dxRowPack *pack, const int *index, const int count,
+  const int *jb, dRealPtr J, dRealPtr iMJ);
+
+// Select the row kernels for the host CPU. Deterministic kernels
+// accumulate the products in the same order as dot6 and sum6 and never
+// fuse a multiply with an add, so their results are bitwise identical to
+// the scalar row update. Otherwise, fused multiply-add is used when the
+// CPU has it. Returns NULL if no kernel is available, in which case the
+// rows are updated one at a time with the scalar code.
+const dxRowKernels *GetRowKernels (const bool deterministic);
+
+    } // namespace quickstep
+} // namespace ode
+#endif
@@ -24,6 +24,7 @@
 
 #include <stdio.h>
 #include <signal.h>
+#include <algorithm>
 #include <mutex>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
@@ -164,6 +165,11 @@ bool Server::ParseArgs(int _argc, char **_argv)
     ("record_resources", "Recording with model meshes and materials.")
     ("seed",  po::value<double>(), "Start with a given random number seed.")
     ("iters",  po::value<unsigned int>(), "Number of iterations to simulate.")
+    ("batch", po::value<unsigned int>()->implicit_value(100),
+     "Step physics as fast as possible, publishing statistics and "
+     "processing messages only every arg iterations (default 100).")
+    ("batch_period", po::value<double>()->default_value(0),
+     "In batch mode, also process messages every arg seconds of sim time.")
     ("minimal_comms", "Reduce the TCP/IP traffic output by gzserver")
     ("server-plugin,s", po::value<std::vector<std::string> >(),
      "Load a plugin.")
@@ -357,6 +363,15 @@ bool Server::ParseArgs(int _argc, char **_argv)
               << std::endl;
       }
     }
+
+    if (this->dataPtr->vm.count("batch"))
+    {
+      unsigned int steps = this->dataPtr->vm["batch"].as<unsigned int>();
+      double period = this->dataPtr->vm["batch_period"].as<double>();
+      physics::get_world()->SetBatchMode(std::max(1u, steps), period);
+      gzmsg << "Running in batch mode, housekeeping every ["
+            << std::max(1u, steps) << "] iterations." << std::endl;
+    }
   }
 
   this->ProcessParams();
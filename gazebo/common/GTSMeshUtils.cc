@@ -14,8 +14,11 @@
  * limitations under the License.
  *
  */
+#include <algorithm>
 #include <vector>
 #include <gts.h>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "gazebo/common/Mesh.hh"
 #include "gazebo/common/Console.hh"
@@ -56,69 +59,148 @@ static void AddConstraint(GtsConstraint *_c, GtsSurface *_s)
 }
 
 //////////////////////////////////////////////////
-static void Intersection(GtsEdge *_c, gpointer *_data)
+/// \brief Constraint edges binned in horizontal slabs, to find the edges
+/// crossed by a ray without testing all of them.
+class EdgeSlabs
 {
-  double x = *reinterpret_cast<double *>(_data[0]);
-  double y = *reinterpret_cast<double *>(_data[1]);
-  int *intersection = reinterpret_cast<int *>(_data[2]);
-
-  GtsVertex *v1, *v2;
-  v1 = _c->segment.v1;
-  v2 = _c->segment.v2;
-
-  double x1 = v1->p.x;
-  double x2 = v2->p.x;
-  double y1 = v1->p.y;
-  double y2 = v2->p.y;
-
-  double xmin = std::min(x1, x2);
-  double xmax = (x1 + x2) - xmin;
-  double ymin = std::min(y1, y2);
-  double ymax = (y1 + y2) - ymin;
-  double xBound = xmax+1;
-
-  if (y < ymax && y >= ymin)
+  /// \brief Constructor.
+  /// \param[in] _edgeList Constraint edges.
+  public: explicit EdgeSlabs(GtsFifo *_edgeList)
   {
-    double xdiff1, ydiff1, xdiff2, ydiff2;
-    xdiff1 = x2 - x1;
-    ydiff1 = y2 - y1;
-    xdiff2 = xBound - x;
-    ydiff2 = 0;
-
-    double s, t;
-    s = (-ydiff1 * (x1 - x) + xdiff1 * (y1 - y)) /
-        (-xdiff2 * ydiff1 + xdiff1 * ydiff2);
-    t = (xdiff2 * (y1 - y) - ydiff2 * (x1 - x)) /
-        (-xdiff2 * ydiff1 + xdiff1 * ydiff2);
-
-    if (s >= 0 && s <= 1 && t >= 0 && t <= 1)
-      (*intersection)++;
+    gts_fifo_foreach(_edgeList, (GtsFunc) AddEdge, this);
+    if (this->edges.empty())
+      return;
+
+    this->yMin = this->edges[0].y1;
+    double yMax = this->yMin;
+    for (const auto &edge : this->edges)
+    {
+      this->yMin = std::min(this->yMin, std::min(edge.y1, edge.y2));
+      yMax = std::max(yMax, std::max(edge.y1, edge.y2));
+    }
+
+    // About one edge per slab
+    const size_t count = std::max<size_t>(1, this->edges.size());
+    this->slabHeight = std::max((yMax - this->yMin) / count, 1e-9);
+    this->slabs.resize(count);
+    for (size_t i = 0; i < this->edges.size(); ++i)
+    {
+      const Edge &edge = this->edges[i];
+      const size_t first = this->Slab(std::min(edge.y1, edge.y2));
+      const size_t last = this->Slab(std::max(edge.y1, edge.y2));
+      for (size_t s = first; s <= last; ++s)
+        this->slabs[s].push_back(i);
+    }
   }
-}
 
-//////////////////////////////////////////////////
-bool TriangleIsHole(GtsTriangle *_t, GtsFifo *_edgeList)
-{
-  GtsEdge *e1, *e2, *e3;
-  GtsVertex *v1, *v2, *v3;
+  /// \brief Count the edges crossed by a ray from a point towards +x.
+  /// \param[in] _x X coordinate of the point.
+  /// \param[in] _y Y coordinate of the point.
+  /// \return Number of crossings.
+  public: int Crossings(const double _x, const double _y) const
+  {
+    if (this->slabs.empty())
+      return 0;
 
-  gts_triangle_vertices_edges(_t, nullptr, &v1, &v2, &v3, &e1, &e2, &e3);
+    const double s = (_y - this->yMin) / this->slabHeight;
+    if (s < 0 || s >= this->slabs.size() + 1)
+      return 0;
 
-  double xCenter = (v1->p.x + v2->p.x + v3->p.x) / 3.0;
-  double yCenter = (v1->p.y + v2->p.y + v3->p.y) / 3.0;
+    int intersections = 0;
+    for (const size_t i : this->slabs[this->Slab(_y)])
+    {
+      if (Crosses(this->edges[i], _x, _y))
+        ++intersections;
+    }
+    return intersections;
+  }
 
-  int intersections = 0;
-  gpointer data[3];
-  data[0] = &xCenter;
-  data[1] = &yCenter;
-  data[2] = &intersections;
+  /// \brief End points of a constraint edge.
+  private: struct Edge
+  {
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+  };
+
+  /// \brief Get the slab of a y coordinate.
+  /// \param[in] _y The coordinate.
+  /// \return Slab index, clamped to the slabs.
+  private: size_t Slab(const double _y) const
+  {
+    const double s = (_y - this->yMin) / this->slabHeight;
+    if (s <= 0)
+      return 0;
+    return std::min(static_cast<size_t>(s), this->slabs.size() - 1);
+  }
 
-  gts_fifo_foreach(_edgeList, (GtsFunc) Intersection, data);
+  /// \brief Add a GTS edge, called for each constraint edge.
+  /// \param[in] _c The edge.
+  /// \param[in] _slabs The slabs.
+  private: static void AddEdge(GtsEdge *_c, EdgeSlabs *_slabs)
+  {
+    const GtsVertex *v1 = _c->segment.v1;
+    const GtsVertex *v2 = _c->segment.v2;
+    _slabs->edges.push_back({v1->p.x, v1->p.y, v2->p.x, v2->p.y});
+  }
 
-  if (intersections % 2)
+  /// \brief Test whether a ray from a point towards +x crosses an edge.
+  /// \param[in] _edge The edge.
+  /// \param[in] _x X coordinate of the point.
+  /// \param[in] _y Y coordinate of the point.
+  /// \return True if the edge is crossed.
+  private: static bool Crosses(const Edge &_edge, const double _x,
+               const double _y)
+  {
+    double x1 = _edge.x1;
+    double x2 = _edge.x2;
+    double y1 = _edge.y1;
+    double y2 = _edge.y2;
+
+    double xmin = std::min(x1, x2);
+    double xmax = (x1 + x2) - xmin;
+    double ymin = std::min(y1, y2);
+    double ymax = (y1 + y2) - ymin;
+    double xBound = xmax+1;
+
+    if (_y < ymax && _y >= ymin)
+    {
+      double xdiff1, ydiff1, xdiff2, ydiff2;
+      xdiff1 = x2 - x1;
+      ydiff1 = y2 - y1;
+      xdiff2 = xBound - _x;
+      ydiff2 = 0;
+
+      double s, t;
+      s = (-ydiff1 * (x1 - _x) + xdiff1 * (y1 - _y)) /
+          (-xdiff2 * ydiff1 + xdiff1 * ydiff2);
+      t = (xdiff2 * (y1 - _y) - ydiff2 * (x1 - _x)) /
+          (-xdiff2 * ydiff1 + xdiff1 * ydiff2);
+
+      if (s >= 0 && s <= 1 && t >= 0 && t <= 1)
+        return true;
+    }
     return false;
-  else
-    return true;
+  }
+
+  /// \brief All the constraint edges.
+  private: std::vector<Edge> edges;
+
+  /// \brief Indices of the edges overlapping each slab.
+  private: std::vector<std::vector<size_t>> slabs;
+
+  /// \brief Bottom of the first slab.
+  private: double yMin = 0;
+
+  /// \brief Height of a slab.
+  private: double slabHeight = 1;
+};
+
+//////////////////////////////////////////////////
+static void CollectFace(GtsFace *_f, std::vector<GtsFace *> *_faces)
+{
+  _faces->push_back(_f);
 }
 
 //////////////////////////////////////////////////
@@ -129,14 +211,18 @@ GtsSurface *GTSMeshUtils::DelaunayTriangulation(
   GSList *l, *verticesList = nullptr;
 
   GtsSurface *surface;
-  verticesList = nullptr;
 
+  // Keep the vertices in an array too, for constant time lookups by index.
+  // The list is built backwards, since appending to a GSList is linear.
+  std::vector<GtsVertex *> vertices;
+  vertices.reserve(_vertices.size());
   for (const auto &vertex : _vertices)
   {
-    verticesList = g_slist_append(verticesList,
-          gts_vertex_new(gts_vertex_class(),
-            vertex.X(), vertex.Y(), 0));
+    vertices.push_back(gts_vertex_new(gts_vertex_class(),
+          vertex.X(), vertex.Y(), 0));
+    verticesList = g_slist_prepend(verticesList, vertices.back());
   }
+  verticesList = g_slist_reverse(verticesList);
 
   GtsFifo *edgeList;
   edgeList = gts_fifo_new();
@@ -144,10 +230,7 @@ GtsSurface *GTSMeshUtils::DelaunayTriangulation(
   {
     gts_fifo_push(edgeList,
             gts_edge_new(GTS_EDGE_CLASS(gts_constraint_class()),
-            reinterpret_cast<GtsVertex *>
-            (g_slist_nth_data(verticesList, edge.X())),
-            reinterpret_cast<GtsVertex *>
-            (g_slist_nth_data(verticesList, edge.Y()))));
+            vertices[edge.X()], vertices[edge.Y()]));
   }
 
 
@@ -190,9 +273,38 @@ GtsSurface *GTSMeshUtils::DelaunayTriangulation(
   // Remove edges on the boundary which are not constraints
   gts_delaunay_remove_hull(surface);
 
-  // remove triangles that are inside holes
-  gts_surface_foreach_face_remove(surface, (GtsFunc) TriangleIsHole,
-        edgeList);
+  // remove triangles that are inside holes, i.e. whose center is outside
+  // of the polygons. The centers are classified in parallel against the
+  // binned constraint edges.
+  std::vector<GtsFace *> faces;
+  gts_surface_foreach_face(surface, (GtsFunc) CollectFace, &faces);
+
+  std::vector<ignition::math::Vector2d> centers(faces.size());
+  for (size_t i = 0; i < faces.size(); ++i)
+  {
+    GtsVertex *v1, *v2, *v3;
+    gts_triangle_vertices(GTS_TRIANGLE(faces[i]), &v1, &v2, &v3);
+    centers[i].Set((v1->p.x + v2->p.x + v3->p.x) / 3.0,
+                   (v1->p.y + v2->p.y + v3->p.y) / 3.0);
+  }
+
+  const EdgeSlabs slabs(edgeList);
+  std::vector<char> isHole(faces.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, faces.size(), 256),
+      [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+        {
+          isHole[i] =
+            slabs.Crossings(centers[i].X(), centers[i].Y()) % 2 == 0;
+        }
+      });
+
+  for (size_t i = 0; i < faces.size(); ++i)
+  {
+    if (isHole[i])
+      gts_surface_remove_face(surface, faces[i]);
+  }
 
   gts_fifo_destroy(edgeList);
   return surface;
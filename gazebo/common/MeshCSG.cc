@@ -23,12 +23,18 @@
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
 #include "gazebo/common/MeshCSG.hh"
 #include "gazebo/common/MeshManager.hh"
 
 using namespace gazebo;
 using namespace common;
 
+/// \brief Version of the boolean operations, part of their mesh cache keys.
+/// Increment it whenever the resulting meshes change, so that meshes cached
+/// by older versions are not reused.
+static const unsigned int kBooleanVersion = 1;
+
 //////////////////////////////////////////////////
 MeshCSG::MeshCSG()
 {
@@ -147,6 +153,21 @@ Mesh *MeshCSG::CreateBoolean(const Mesh *_m1, const Mesh *_m2, int _operation,
   bool isOpen1 = false;
   bool isOpen2 = false;
 
+  // The result only depends on the geometry of the inputs, so a previous
+  // result for the same inputs can be reused.
+  MeshHash hash;
+  hash.Add("boolean");
+  hash.Add(static_cast<double>(kBooleanVersion));
+  hash.Add(_m1);
+  hash.Add(_m2);
+  hash.Add(static_cast<double>(_operation));
+  hash.Add(_offset);
+  const std::string cacheKey = hash.Key();
+
+  Mesh *cached = MeshCache::Instance()->Find(cacheKey);
+  if (cached)
+    return cached;
+
   s1 = gts_surface_new(gts_surface_class(), gts_face_class(), gts_edge_class(),
       gts_vertex_class());
   s2 = gts_surface_new(gts_surface_class(), gts_face_class(), gts_edge_class(),
@@ -263,6 +284,8 @@ Mesh *MeshCSG::CreateBoolean(const Mesh *_m1, const Mesh *_m2, int _operation,
   // destroy bounding box trees (including bounding boxes)
   gts_bb_tree_destroy(tree1, true);
   gts_bb_tree_destroy(tree2, true);
+
+  MeshCache::Instance()->Add(cacheKey, mesh);
   return mesh;
 }
 
@@ -0,0 +1,478 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/SystemPaths.hh"
+#include "gazebo/common/MeshCache.hh"
+
+using namespace gazebo;
+using namespace common;
+
+/// \brief First bytes of a cache file, ending with the format version.
+static const char kMeshCacheMagic[8] = {'G', 'Z', 'M', 'E', 'S', 'H', 'C', '1'};
+
+/// \brief Private data for the MeshCache class
+class gazebo::common::MeshCachePrivate
+{
+  /// \brief Directory of the cache files, empty for none.
+  public: std::string path;
+
+  /// \brief Maximum number of meshes in memory.
+  public: unsigned int maxCount = 256;
+
+  /// \brief Maximum number of cache files.
+  public: unsigned int maxFileCount = 1024;
+
+  /// \brief Meshes in memory, by key.
+  public: std::map<std::string, std::unique_ptr<Mesh>> meshes;
+
+  /// \brief Keys of the meshes in memory, oldest first.
+  public: std::list<std::string> order;
+
+  /// \brief Protects the members above.
+  public: std::mutex mutex;
+
+  /// \brief Keep a copy of a mesh in memory, and remove the oldest meshes
+  /// above the maximum count. The mutex must be locked.
+  /// \param[in] _key Key of the mesh.
+  /// \param[in] _mesh Mesh to copy.
+  public: void Insert(const std::string &_key, const Mesh *_mesh);
+
+  /// \brief Remove the oldest meshes above the maximum count. The mutex
+  /// must be locked.
+  public: void Trim();
+};
+
+/////////////////////////////////////////////////
+/// \brief Copy the geometry of the submeshes of a mesh.
+/// \param[in] _mesh Mesh to copy.
+/// \return New mesh.
+static Mesh *CopyGeometry(const Mesh *_mesh)
+{
+  Mesh *mesh = new Mesh();
+  for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); ++i)
+    mesh->AddSubMesh(new SubMesh(_mesh->GetSubMesh(i)));
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a value to a cache file.
+/// \param[in] _out Output stream.
+/// \param[in] _value Value to write.
+template<typename T>
+static void Write(std::ostream &_out, const T _value)
+{
+  _out.write(reinterpret_cast<const char *>(&_value), sizeof(_value));
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a value from a cache file.
+/// \param[in] _in Input stream.
+/// \return The value, undefined if the stream failed.
+template<typename T>
+static T Read(std::istream &_in)
+{
+  T value = T();
+  _in.read(reinterpret_cast<char *>(&value), sizeof(value));
+  return value;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a mesh to a cache file.
+/// \param[in] _filename File to write.
+/// \param[in] _mesh Mesh to write.
+/// \return True on success.
+static bool WriteMesh(const std::string &_filename, const Mesh *_mesh)
+{
+  std::ofstream out(_filename, std::ios::binary);
+  if (!out)
+    return false;
+
+  out.write(kMeshCacheMagic, sizeof(kMeshCacheMagic));
+  Write<uint32_t>(out, _mesh->GetSubMeshCount());
+  for (unsigned int i = 0; i < _mesh->GetSubMeshCount(); ++i)
+  {
+    const SubMesh *subMesh = _mesh->GetSubMesh(i);
+    Write<uint32_t>(out, subMesh->GetPrimitiveType());
+    Write<uint32_t>(out, subMesh->GetVertexCount());
+    Write<uint32_t>(out, subMesh->GetNormalCount());
+    Write<uint32_t>(out, subMesh->GetTexCoordCount());
+    Write<uint32_t>(out, subMesh->GetIndexCount());
+
+    for (unsigned int j = 0; j < subMesh->GetVertexCount(); ++j)
+    {
+      const ignition::math::Vector3d v = subMesh->Vertex(j);
+      Write(out, v.X());
+      Write(out, v.Y());
+      Write(out, v.Z());
+    }
+    for (unsigned int j = 0; j < subMesh->GetNormalCount(); ++j)
+    {
+      const ignition::math::Vector3d n = subMesh->Normal(j);
+      Write(out, n.X());
+      Write(out, n.Y());
+      Write(out, n.Z());
+    }
+    for (unsigned int j = 0; j < subMesh->GetTexCoordCount(); ++j)
+    {
+      const ignition::math::Vector2d t = subMesh->TexCoord(j);
+      Write(out, t.X());
+      Write(out, t.Y());
+    }
+    for (unsigned int j = 0; j < subMesh->GetIndexCount(); ++j)
+      Write<uint32_t>(out, subMesh->GetIndex(j));
+  }
+  return static_cast<bool>(out);
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a mesh from a cache file.
+/// \param[in] _filename File to read.
+/// \return New mesh, or nullptr if the file is missing or invalid.
+static Mesh *ReadMesh(const std::string &_filename)
+{
+  std::ifstream in(_filename, std::ios::binary);
+  if (!in)
+    return nullptr;
+
+  char magic[sizeof(kMeshCacheMagic)];
+  in.read(magic, sizeof(magic));
+  if (!in || !std::equal(magic, magic + sizeof(magic), kMeshCacheMagic))
+    return nullptr;
+
+  std::unique_ptr<Mesh> mesh(new Mesh());
+  const uint32_t subMeshCount = Read<uint32_t>(in);
+  for (uint32_t i = 0; i < subMeshCount && in; ++i)
+  {
+    SubMesh *subMesh = new SubMesh();
+    mesh->AddSubMesh(subMesh);
+
+    const uint32_t type = Read<uint32_t>(in);
+    const uint32_t vertexCount = Read<uint32_t>(in);
+    const uint32_t normalCount = Read<uint32_t>(in);
+    const uint32_t texCoordCount = Read<uint32_t>(in);
+    const uint32_t indexCount = Read<uint32_t>(in);
+    if (!in || type > SubMesh::TRISTRIPS)
+      return nullptr;
+    subMesh->SetPrimitiveType(static_cast<SubMesh::PrimitiveType>(type));
+
+    for (uint32_t j = 0; j < vertexCount && in; ++j)
+    {
+      const double x = Read<double>(in);
+      const double y = Read<double>(in);
+      const double z = Read<double>(in);
+      subMesh->AddVertex(x, y, z);
+    }
+    for (uint32_t j = 0; j < normalCount && in; ++j)
+    {
+      const double x = Read<double>(in);
+      const double y = Read<double>(in);
+      const double z = Read<double>(in);
+      subMesh->AddNormal(x, y, z);
+    }
+    for (uint32_t j = 0; j < texCoordCount && in; ++j)
+    {
+      const double u = Read<double>(in);
+      const double v = Read<double>(in);
+      subMesh->AddTexCoord(u, v);
+    }
+    for (uint32_t j = 0; j < indexCount && in; ++j)
+    {
+      const uint32_t index = Read<uint32_t>(in);
+      if (index >= vertexCount)
+        return nullptr;
+      subMesh->AddIndex(index);
+    }
+  }
+
+  if (!in)
+    return nullptr;
+  return mesh.release();
+}
+
+/////////////////////////////////////////////////
+/// \brief Remove the least recently used cache files above a count.
+/// \param[in] _path Directory of the cache files.
+/// \param[in] _maxCount Maximum number of files.
+static void TrimFiles(const std::string &_path, const unsigned int _maxCount)
+{
+  boost::system::error_code ec;
+  std::vector<std::pair<std::time_t, boost::filesystem::path>> files;
+  for (boost::filesystem::directory_iterator iter(_path, ec), end;
+       !ec && iter != end; iter.increment(ec))
+  {
+    if (iter->path().extension() != ".mesh")
+      continue;
+    const std::time_t time = boost::filesystem::last_write_time(
+        iter->path(), ec);
+    if (!ec)
+      files.push_back(std::make_pair(time, iter->path()));
+  }
+
+  if (files.size() <= _maxCount)
+    return;
+
+  std::sort(files.begin(), files.end());
+  for (size_t i = 0; i < files.size() - _maxCount; ++i)
+    boost::filesystem::remove(files[i].second, ec);
+}
+
+/////////////////////////////////////////////////
+void MeshCachePrivate::Insert(const std::string &_key, const Mesh *_mesh)
+{
+  if (this->maxCount == 0 || this->meshes.count(_key))
+    return;
+
+  this->meshes[_key].reset(CopyGeometry(_mesh));
+  this->order.push_back(_key);
+  this->Trim();
+}
+
+/////////////////////////////////////////////////
+void MeshCachePrivate::Trim()
+{
+  while (this->order.size() > this->maxCount)
+  {
+    this->meshes.erase(this->order.front());
+    this->order.pop_front();
+  }
+}
+
+/////////////////////////////////////////////////
+void MeshHash::AddBytes(const void *_data, const size_t _size)
+{
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(_data);
+  for (size_t i = 0; i < _size; ++i)
+  {
+    this->value ^= bytes[i];
+    this->value *= 1099511628211ull;
+  }
+}
+
+/////////////////////////////////////////////////
+void MeshHash::Add(const std::string &_value)
+{
+  // Add the size too, so that consecutive strings can't be confused
+  const uint64_t size = _value.size();
+  this->AddBytes(&size, sizeof(size));
+  this->AddBytes(_value.data(), _value.size());
+}
+
+/////////////////////////////////////////////////
+void MeshHash::Add(const double _value)
+{
+  // Make 0 and -0 hash the same
+  const double value = _value + 0.0;
+  this->AddBytes(&value, sizeof(value));
+}
+
+/////////////////////////////////////////////////
+void MeshHash::Add(const ignition::math::Pose3d &_pose)
+{
+  this->Add(_pose.Pos().X());
+  this->Add(_pose.Pos().Y());
+  this->Add(_pose.Pos().Z());
+  this->Add(_pose.Rot().W());
+  this->Add(_pose.Rot().X());
+  this->Add(_pose.Rot().Y());
+  this->Add(_pose.Rot().Z());
+}
+
+/////////////////////////////////////////////////
+void MeshHash::Add(const Mesh *_mesh)
+{
+  const uint32_t subMeshCount = _mesh->GetSubMeshCount();
+  this->AddBytes(&subMeshCount, sizeof(subMeshCount));
+  for (unsigned int i = 0; i < subMeshCount; ++i)
+  {
+    const SubMesh *subMesh = _mesh->GetSubMesh(i);
+    const uint32_t vertexCount = subMesh->GetVertexCount();
+    const uint32_t indexCount = subMesh->GetIndexCount();
+    this->AddBytes(&vertexCount, sizeof(vertexCount));
+    this->AddBytes(&indexCount, sizeof(indexCount));
+    for (unsigned int j = 0; j < vertexCount; ++j)
+    {
+      const ignition::math::Vector3d v = subMesh->Vertex(j);
+      this->Add(v.X());
+      this->Add(v.Y());
+      this->Add(v.Z());
+    }
+    for (unsigned int j = 0; j < indexCount; ++j)
+    {
+      const uint32_t index = subMesh->GetIndex(j);
+      this->AddBytes(&index, sizeof(index));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+std::string MeshHash::Key() const
+{
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx",
+      static_cast<unsigned long long>(this->value));
+  return key;
+}
+
+/////////////////////////////////////////////////
+MeshCache::MeshCache()
+  : dataPtr(new MeshCachePrivate)
+{
+  const char *envPath = getEnv("GAZEBO_MESH_CACHE_PATH");
+  if (envPath)
+  {
+    this->dataPtr->path = envPath;
+  }
+  else
+  {
+    this->dataPtr->path =
+      (boost::filesystem::path(SystemPaths::Instance()->GetLogPath()) /
+       "mesh_cache").string();
+  }
+}
+
+/////////////////////////////////////////////////
+MeshCache::~MeshCache()
+{
+}
+
+/////////////////////////////////////////////////
+void MeshCache::SetPath(const std::string &_path)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->path = _path;
+}
+
+/////////////////////////////////////////////////
+std::string MeshCache::Path() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->path;
+}
+
+/////////////////////////////////////////////////
+void MeshCache::SetMaxCount(const unsigned int _count)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxCount = _count;
+  this->dataPtr->Trim();
+}
+
+/////////////////////////////////////////////////
+void MeshCache::SetMaxFileCount(const unsigned int _count)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->maxFileCount = _count;
+}
+
+/////////////////////////////////////////////////
+Mesh *MeshCache::Find(const std::string &_key)
+{
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto iter = this->dataPtr->meshes.find(_key);
+    if (iter != this->dataPtr->meshes.end())
+      return CopyGeometry(iter->second.get());
+    path = this->dataPtr->path;
+  }
+
+  if (path.empty())
+    return nullptr;
+
+  const boost::filesystem::path filename =
+    boost::filesystem::path(path) / (_key + ".mesh");
+  Mesh *mesh = ReadMesh(filename.string());
+  if (!mesh)
+    return nullptr;
+
+  // Mark it as recently used, see TrimFiles
+  boost::system::error_code ec;
+  boost::filesystem::last_write_time(filename, std::time(nullptr), ec);
+
+  // Keep it in memory for the next time
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Insert(_key, mesh);
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+void MeshCache::Add(const std::string &_key, const Mesh *_mesh)
+{
+  if (!_mesh)
+    return;
+
+  std::string path;
+  unsigned int maxFileCount;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    path = this->dataPtr->path;
+    maxFileCount = this->dataPtr->maxFileCount;
+    this->dataPtr->Insert(_key, _mesh);
+  }
+
+  if (path.empty())
+    return;
+
+  // Write to a temporary file first, so that other processes never read
+  // a partial file.
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(path, ec);
+  const boost::filesystem::path filename =
+    boost::filesystem::path(path) / (_key + ".mesh");
+  const boost::filesystem::path tmpFilename = filename.string() + "." +
+    boost::filesystem::unique_path().string();
+  if (!WriteMesh(tmpFilename.string(), _mesh))
+  {
+    gzwarn << "Unable to write mesh cache file [" << tmpFilename.string()
+           << "]" << std::endl;
+    boost::filesystem::remove(tmpFilename, ec);
+    return;
+  }
+  boost::filesystem::rename(tmpFilename, filename, ec);
+  if (ec)
+  {
+    gzwarn << "Unable to write mesh cache file [" << filename.string()
+           << "]: " << ec.message() << std::endl;
+    boost::filesystem::remove(tmpFilename, ec);
+    return;
+  }
+
+  TrimFiles(path, maxFileCount);
+}
+
+/////////////////////////////////////////////////
+void MeshCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->meshes.clear();
+  this->dataPtr->order.clear();
+}
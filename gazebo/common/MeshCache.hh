@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_COMMON_MESHCACHE_HH_
+#define GAZEBO_COMMON_MESHCACHE_HH_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/SingletonT.hh"
+#include "gazebo/util/system.hh"
+
+/// \brief Explicit instantiation for typed SingletonT.
+GZ_SINGLETON_DECLARE(GZ_COMMON_VISIBLE, gazebo, common, MeshCache)
+
+namespace gazebo
+{
+  namespace common
+  {
+    // Forward declarations.
+    class Mesh;
+    class MeshCachePrivate;
+
+    /// \addtogroup gazebo_common Common
+    /// \{
+
+    /// \class MeshHash MeshCache.hh common/common.hh
+    /// \brief Hash of the inputs of a mesh computation, used as a key of
+    /// the MeshCache. It is a 64 bit FNV-1a hash of the values added.
+    class GZ_COMMON_VISIBLE MeshHash
+    {
+      /// \brief Add a string, e.g. the name of the computation.
+      /// \param[in] _value String to add.
+      public: void Add(const std::string &_value);
+
+      /// \brief Add a number.
+      /// \param[in] _value Number to add.
+      public: void Add(const double _value);
+
+      /// \brief Add a pose.
+      /// \param[in] _pose Pose to add.
+      public: void Add(const ignition::math::Pose3d &_pose);
+
+      /// \brief Add the geometry of a mesh: vertices and indices of every
+      /// submesh.
+      /// \param[in] _mesh Mesh to add.
+      public: void Add(const Mesh *_mesh);
+
+      /// \brief Add raw bytes.
+      /// \param[in] _data Bytes to add.
+      /// \param[in] _size Number of bytes.
+      public: void AddBytes(const void *_data, const size_t _size);
+
+      /// \brief Get the cache key of the values added.
+      /// \return Hash as 16 hexadecimal digits.
+      public: std::string Key() const;
+
+      /// \brief Hash value.
+      private: uint64_t value = 14695981039346656037ull;
+    };
+
+    /// \class MeshCache MeshCache.hh common/common.hh
+    /// \brief Cache of computed meshes, such as extruded polylines and CSG
+    /// results, indexed by a hash of their inputs. Meshes are kept in
+    /// memory, up to a maximum count, and written to a directory so that
+    /// they are reused by the next runs. The oldest files are removed
+    /// above a maximum count.
+    ///
+    /// Algorithms whose meshes are cached must add a version number to
+    /// their keys, and increment it whenever their output changes.
+    class GZ_COMMON_VISIBLE MeshCache : public SingletonT<MeshCache>
+    {
+      /// \brief Constructor. The cache directory is the value of the
+      /// GAZEBO_MESH_CACHE_PATH environment variable if it is set, an empty
+      /// value disables the cache files. Otherwise it is mesh_cache in the
+      /// gazebo log path, usually ~/.gazebo/mesh_cache.
+      private: MeshCache();
+
+      /// \brief Destructor.
+      private: virtual ~MeshCache();
+
+      /// \brief Set the directory of the cache files. It is created when
+      /// the first mesh is added.
+      /// \param[in] _path Directory, empty to only cache in memory.
+      public: void SetPath(const std::string &_path);
+
+      /// \brief Get the directory of the cache files.
+      /// \return The directory, empty if meshes are only cached in memory.
+      public: std::string Path() const;
+
+      /// \brief Set the maximum number of meshes kept in memory. The least
+      /// recently added are removed first.
+      /// \param[in] _count Maximum number of meshes.
+      public: void SetMaxCount(const unsigned int _count);
+
+      /// \brief Set the maximum number of cache files. The least recently
+      /// used are removed first, when a mesh is added.
+      /// \param[in] _count Maximum number of files.
+      public: void SetMaxFileCount(const unsigned int _count);
+
+      /// \brief Get a copy of a cached mesh, looked up in memory then in
+      /// the cache directory.
+      /// \param[in] _key Key of the mesh, see MeshHash.
+      /// \return New mesh owned by the caller, without name or materials,
+      /// or nullptr if the mesh is not cached.
+      public: Mesh *Find(const std::string &_key);
+
+      /// \brief Add a copy of a mesh to the cache.
+      /// \param[in] _key Key of the mesh, see MeshHash.
+      /// \param[in] _mesh Mesh to copy. Only the geometry of the submeshes
+      /// is cached.
+      public: void Add(const std::string &_key, const Mesh *_mesh);
+
+      /// \brief Remove all the meshes kept in memory. The cache files are
+      /// left untouched.
+      public: void Clear();
+
+      /// \brief Singleton implementation
+      private: friend class SingletonT<MeshCache>;
+
+      /// \internal
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<MeshCachePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
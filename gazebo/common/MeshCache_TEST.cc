@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <boost/filesystem.hpp>
+
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MeshCacheTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Create a mesh with a single triangle.
+/// \param[in] _z Height of the triangle.
+/// \return New mesh.
+static common::Mesh *Triangle(const double _z)
+{
+  common::Mesh *mesh = new common::Mesh();
+  common::SubMesh *subMesh = new common::SubMesh();
+  mesh->AddSubMesh(subMesh);
+  subMesh->AddVertex(0, 0, _z);
+  subMesh->AddVertex(1, 0, _z);
+  subMesh->AddVertex(0, 1, _z);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    subMesh->AddNormal(ignition::math::Vector3d::UnitZ);
+    subMesh->AddIndex(i);
+  }
+  return mesh;
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, Hash)
+{
+  std::unique_ptr<common::Mesh> mesh1(Triangle(0));
+  std::unique_ptr<common::Mesh> mesh2(Triangle(0));
+  std::unique_ptr<common::Mesh> mesh3(Triangle(1));
+
+  common::MeshHash hash1;
+  hash1.Add("boolean");
+  hash1.Add(mesh1.get());
+  hash1.Add(ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+
+  common::MeshHash hash2;
+  hash2.Add("boolean");
+  hash2.Add(mesh2.get());
+  hash2.Add(ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+
+  EXPECT_EQ(16u, hash1.Key().size());
+  EXPECT_EQ(hash1.Key(), hash2.Key());
+
+  // Any different input changes the key
+  common::MeshHash hash3;
+  hash3.Add("boolean");
+  hash3.Add(mesh3.get());
+  hash3.Add(ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+  EXPECT_NE(hash1.Key(), hash3.Key());
+
+  common::MeshHash hash4;
+  hash4.Add("boolean");
+  hash4.Add(mesh1.get());
+  hash4.Add(ignition::math::Pose3d(1, 2, 4, 0, 0, 0));
+  EXPECT_NE(hash1.Key(), hash4.Key());
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, Memory)
+{
+  common::MeshCache *cache = common::MeshCache::Instance();
+  cache->SetPath("");
+  cache->Clear();
+
+  EXPECT_EQ(nullptr, cache->Find("0123456789abcdef"));
+
+  std::unique_ptr<common::Mesh> mesh(Triangle(2));
+  cache->Add("0123456789abcdef", mesh.get());
+
+  std::unique_ptr<common::Mesh> cached(cache->Find("0123456789abcdef"));
+  ASSERT_NE(nullptr, cached);
+  EXPECT_NE(mesh.get(), cached.get());
+  ASSERT_EQ(1u, cached->GetSubMeshCount());
+  EXPECT_EQ(3u, cached->GetVertexCount());
+  EXPECT_EQ(3u, cached->GetIndexCount());
+  EXPECT_EQ(ignition::math::Vector3d(1, 0, 2),
+      cached->GetSubMesh(0)->Vertex(1));
+
+  // Only the newest meshes are kept
+  std::unique_ptr<common::Mesh> other(Triangle(3));
+  cache->SetMaxCount(1);
+  cache->Add("fedcba9876543210", other.get());
+  EXPECT_EQ(nullptr, cache->Find("0123456789abcdef"));
+  std::unique_ptr<common::Mesh> newest(cache->Find("fedcba9876543210"));
+  EXPECT_NE(nullptr, newest);
+
+  cache->SetMaxCount(256);
+  cache->Clear();
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshCacheTest, Disk)
+{
+  const boost::filesystem::path path =
+    boost::filesystem::temp_directory_path() /
+    boost::filesystem::unique_path("gz_mesh_cache_%%%%%%%%");
+
+  common::MeshCache *cache = common::MeshCache::Instance();
+  cache->SetPath(path.string());
+  EXPECT_EQ(path.string(), cache->Path());
+  cache->Clear();
+
+  std::unique_ptr<common::Mesh> mesh(Triangle(4));
+  cache->Add("00000000000000aa", mesh.get());
+  EXPECT_TRUE(boost::filesystem::exists(path / "00000000000000aa.mesh"));
+
+  // Read back from the file
+  cache->Clear();
+  std::unique_ptr<common::Mesh> cached(cache->Find("00000000000000aa"));
+  ASSERT_NE(nullptr, cached);
+  ASSERT_EQ(1u, cached->GetSubMeshCount());
+  const common::SubMesh *subMesh = cached->GetSubMesh(0);
+  EXPECT_EQ(3u, subMesh->GetVertexCount());
+  EXPECT_EQ(3u, subMesh->GetNormalCount());
+  EXPECT_EQ(3u, subMesh->GetIndexCount());
+  EXPECT_EQ(ignition::math::Vector3d(0, 1, 4), subMesh->Vertex(2));
+  EXPECT_EQ(ignition::math::Vector3d::UnitZ, subMesh->Normal(0));
+
+  // Corrupt files are ignored
+  {
+    std::ofstream out((path / "00000000000000bb.mesh").string());
+    out << "not a mesh";
+  }
+  EXPECT_EQ(nullptr, cache->Find("00000000000000bb"));
+  boost::filesystem::remove(path / "00000000000000bb.mesh");
+
+  // Only the most recently used files are kept
+  cache->SetMaxFileCount(2);
+  boost::filesystem::last_write_time(path / "00000000000000aa.mesh",
+      std::time(nullptr) - 20);
+  cache->Add("00000000000000cc", mesh.get());
+  boost::filesystem::last_write_time(path / "00000000000000cc.mesh",
+      std::time(nullptr) - 10);
+  cache->Add("00000000000000dd", mesh.get());
+  EXPECT_FALSE(boost::filesystem::exists(path / "00000000000000aa.mesh"));
+  EXPECT_TRUE(boost::filesystem::exists(path / "00000000000000cc.mesh"));
+  EXPECT_TRUE(boost::filesystem::exists(path / "00000000000000dd.mesh"));
+
+  cache->SetMaxFileCount(1024);
+  cache->Clear();
+  cache->SetPath("");
+  boost::filesystem::remove_all(path);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,13 +16,18 @@
  */
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <string>
 #include <map>
+#include <utility>
 
 #include "gazebo/common/CommonIface.hh"
 #include "gazebo/common/Exception.hh"
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshCache.hh"
 #include "gazebo/common/ColladaLoader.hh"
 #include "gazebo/common/ColladaExporter.hh"
 #include "gazebo/common/STLLoader.hh"
@@ -71,6 +76,11 @@ class MeshManagerPrivate
 // TODO move to header / private class when merging forward.
 static OBJLoader objLoader;
 
+/// \brief Version of the polyline extrusion, part of its mesh cache keys.
+/// Increment it whenever the extruded meshes change, so that meshes cached
+/// by older versions are not reused.
+static const unsigned int kExtrudedPolylineVersion = 1;
+
 //////////////////////////////////////////////////
 MeshManager::MeshManager()
   : dataPtr(new MeshManagerPrivate)
@@ -581,7 +591,33 @@ void MeshManager::CreateExtrudedPolyline(const std::string &_name,
     return;
   }
 
-  Mesh *mesh = new Mesh();
+  // Identical polylines extrude to the same mesh, so reuse a previous result
+  // when there is one.
+  MeshHash hash;
+  hash.Add("extruded_polyline");
+  hash.Add(static_cast<double>(kExtrudedPolylineVersion));
+  for (const auto &poly : polys)
+  {
+    hash.Add(static_cast<double>(poly.size()));
+    for (const auto &p : poly)
+    {
+      hash.Add(p.X());
+      hash.Add(p.Y());
+    }
+  }
+  hash.Add(_height);
+  hash.Add(tol);
+  const std::string cacheKey = hash.Key();
+
+  Mesh *mesh = MeshCache::Instance()->Find(cacheKey);
+  if (mesh)
+  {
+    mesh->SetName(_name);
+    this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
+    return;
+  }
+
+  mesh = new Mesh();
   mesh->SetName(_name);
 
   SubMesh *subMesh = new SubMesh();
@@ -602,6 +638,18 @@ void MeshManager::CreateExtrudedPolyline(const std::string &_name,
   }
   #endif
 
+  // Index the triangles by the position of their vertices, so the triangles
+  // sharing the first vertex of an edge are found without scanning them all.
+  std::map<std::pair<double, double>, std::vector<unsigned int>> triangles;
+  for (unsigned int j = 0; j < subMesh->GetIndexCount(); j+=3)
+  {
+    for (unsigned int k = 0; k < 3; ++k)
+    {
+      ignition::math::Vector3d v = subMesh->Vertex(subMesh->GetIndex(j+k));
+      triangles[std::make_pair(v.X(), v.Y())].push_back(j);
+    }
+  }
+
   std::vector<ignition::math::Vector3d> normals;
   for (unsigned int i  = 0; i < edges.size(); ++i)
   {
@@ -611,8 +659,22 @@ void MeshManager::CreateExtrudedPolyline(const std::string &_name,
     ignition::math::Vector2d edgeV0 = vertices[i0];
     ignition::math::Vector2d edgeV1 = vertices[i1];
 
+    // candidate triangles, in index order. Triangulation may have moved the
+    // vertex slightly, in which case all the triangles are checked.
+    std::vector<unsigned int> candidates;
+    auto it = triangles.find(std::make_pair(edgeV0.X(), edgeV0.Y()));
+    if (it != triangles.end())
+    {
+      candidates = it->second;
+    }
+    else
+    {
+      for (unsigned int j = 0; j < subMesh->GetIndexCount(); j+=3)
+        candidates.push_back(j);
+    }
+
     // we look for those points in the subMesh (where indices may have changed)
-    for (unsigned int j = 0; j < subMesh->GetIndexCount(); j+=3)
+    for (const unsigned int j : candidates)
     {
       ignition::math::Vector3d v0 = subMesh->Vertex(subMesh->GetIndex(j));
       ignition::math::Vector3d v1 = subMesh->Vertex(subMesh->GetIndex(j+1));
@@ -759,6 +821,7 @@ void MeshManager::CreateExtrudedPolyline(const std::string &_name,
     }
   }
 
+  MeshCache::Instance()->Add(cacheKey, mesh);
   this->dataPtr->meshes.insert(std::make_pair(_name, mesh));
   return;
 }
@@ -1335,25 +1398,78 @@ void MeshManager::CreateBoolean(const std::string &_name, const Mesh *_m1,
 }
 #endif
 
+namespace
+{
 //////////////////////////////////////////////////
-size_t MeshManager::AddUniquePointToVerticesTable(
-                     std::vector<ignition::math::Vector2d> &_vertices,
-                     const ignition::math::Vector2d &_p,
-                     double _tol)
+/// \brief Table of distinct points, hashed in a grid of cells as large as
+/// the tolerance so only the neighbouring cells are searched for a match.
+class UniquePoints
 {
-  double sqrTol = _tol * _tol;
-  for (auto i = 0u; i != _vertices.size(); ++i)
+  /// \brief Constructor.
+  /// \param[in] _vertices The vertex table where points are stored.
+  /// \param[in] _tol The maximum distance under which 2 points are
+  /// considered to be the same point.
+  public: UniquePoints(std::vector<ignition::math::Vector2d> &_vertices,
+              const double _tol)
+    : vertices(_vertices), tol(std::max(_tol, 1e-12))
+  {
+    for (size_t i = 0; i < this->vertices.size(); ++i)
+      this->cells[this->Cell(this->vertices[i])].push_back(i);
+  }
+
+  /// \brief Add a point to the table if it is not there already.
+  /// \param[in] _p The point coordinates.
+  /// \return The index of the point, the lowest one if several points
+  /// are within tolerance.
+  public: size_t Add(const ignition::math::Vector2d &_p)
   {
-    auto v = _vertices[i] - _p;
-    double d = (v.X() * v.X() + v.Y() * v.Y());
-    if ( d < sqrTol)
+    const double sqrTol = this->tol * this->tol;
+    const auto cell = this->Cell(_p);
+    size_t found = this->vertices.size();
+    for (int64_t x = cell.first - 1; x <= cell.first + 1; ++x)
     {
-      return i;
+      for (int64_t y = cell.second - 1; y <= cell.second + 1; ++y)
+      {
+        auto it = this->cells.find(std::make_pair(x, y));
+        if (it == this->cells.end())
+          continue;
+        for (const size_t i : it->second)
+        {
+          auto v = this->vertices[i] - _p;
+          double d = (v.X() * v.X() + v.Y() * v.Y());
+          if (d < sqrTol && i < found)
+            found = i;
+        }
+      }
     }
+    if (found < this->vertices.size())
+      return found;
+
+    this->vertices.push_back(_p);
+    this->cells[cell].push_back(found);
+    return found;
+  }
+
+  /// \brief Get the grid cell of a point.
+  /// \param[in] _p The point.
+  /// \return Cell coordinates.
+  private: std::pair<int64_t, int64_t> Cell(
+               const ignition::math::Vector2d &_p) const
+  {
+    return std::make_pair(
+        static_cast<int64_t>(std::floor(_p.X() / this->tol)),
+        static_cast<int64_t>(std::floor(_p.Y() / this->tol)));
   }
-  _vertices.push_back(_p);
-  size_t r =  _vertices.size() -1;
-  return r;
+
+  /// \brief The vertex table.
+  private: std::vector<ignition::math::Vector2d> &vertices;
+
+  /// \brief Distance tolerance, which is also the cell size.
+  private: double tol;
+
+  /// \brief Indices of the vertices in each cell.
+  private: std::map<std::pair<int64_t, int64_t>, std::vector<size_t>> cells;
+};
 }
 
 //////////////////////////////////////////////////
@@ -1363,16 +1479,15 @@ void MeshManager::ConvertPolylinesToVerticesAndEdges(
     std::vector<ignition::math::Vector2d> &_vertices,
     std::vector<ignition::math::Vector2i> &edges)
 {
+  UniquePoints unique(_vertices, _tol);
   for (auto poly : _polys)
   {
     ignition::math::Vector2d previous = poly[0];
     for (auto i = 1u; i != poly.size(); ++i)
     {
       auto p = poly[i];
-      auto startPointIndex = AddUniquePointToVerticesTable(_vertices,
-          previous, _tol);
-      auto endPointIndex = AddUniquePointToVerticesTable(_vertices,
-          p, _tol);
+      auto startPointIndex = unique.Add(previous);
+      auto endPointIndex = unique.Add(p);
       // current end point is now the starting point for the next edge
       previous = p;
       if (startPointIndex == endPointIndex)
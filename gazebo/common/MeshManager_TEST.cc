@@ -25,7 +25,11 @@
 
 using namespace gazebo;
 
-class MeshManager : public gazebo::testing::AutoLogFixture { };
+class MeshManager : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Extrude for real, without reusing meshes cached by other runs.
+  protected: gazebo::testing::TemporaryMeshCache meshCache;
+};
 
 #ifdef HAVE_GTS
 /////////////////////////////////////////////////
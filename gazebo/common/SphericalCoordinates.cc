@@ -203,6 +203,64 @@ ignition::math::Vector3d SphericalCoordinates::SphericalFromLocal(
   return result;
 }
 
+//////////////////////////////////////////////////
+void SphericalCoordinates::SphericalFromLocal(
+    const std::vector<ignition::math::Vector3d> &_xyz,
+    std::vector<ignition::math::Vector3d> &_spherical) const
+{
+  _spherical.resize(_xyz.size());
+
+  // Copy the cached values to locals, so they stay in registers
+  const ignition::math::Matrix3d &rot = this->dataPtr->rotLocalToECEF;
+  const double r00 = rot(0, 0), r01 = rot(0, 1), r02 = rot(0, 2);
+  const double r10 = rot(1, 0), r11 = rot(1, 1), r12 = rot(1, 2);
+  const double r20 = rot(2, 0), r21 = rot(2, 1), r22 = rot(2, 2);
+  const double ox = this->dataPtr->origin.X();
+  const double oy = this->dataPtr->origin.Y();
+  const double oz = this->dataPtr->origin.Z();
+  const double a = this->dataPtr->ellA;
+  const double b = this->dataPtr->ellB;
+  const double e2 = this->dataPtr->ellE * this->dataPtr->ellE;
+  const double e2a = e2 * a;
+  const double p2b = this->dataPtr->ellP * this->dataPtr->ellP * b;
+
+  for (size_t i = 0; i < _xyz.size(); ++i)
+  {
+    const ignition::math::Vector3d &pos = _xyz[i];
+
+    // LOCAL to ECEF
+    const double x = ox + r00 * pos.X() + r01 * pos.Y() + r02 * pos.Z();
+    const double y = oy + r10 * pos.X() + r11 * pos.Y() + r12 * pos.Z();
+    const double z = oz + r20 * pos.X() + r21 * pos.Y() + r22 * pos.Z();
+
+    // ECEF to SPHERICAL, with the same formula as PositionTransform. The
+    // sine and cosine of the auxiliary angle theta and of the latitude
+    // are obtained from their tangent instead of evaluating atan, sin and
+    // cos, which also keeps the result finite at the poles.
+    const double p = sqrt(x * x + y * y);
+    const double sinThetaN = z * a;
+    const double cosThetaN = p * b;
+    const double thetaNorm = sqrt(sinThetaN * sinThetaN +
+        cosThetaN * cosThetaN);
+    const double sinTheta = sinThetaN / thetaNorm;
+    const double cosTheta = cosThetaN / thetaNorm;
+
+    const double latN = z + p2b * sinTheta * sinTheta * sinTheta;
+    const double latD = p - e2a * cosTheta * cosTheta * cosTheta;
+    const double latNorm = sqrt(latN * latN + latD * latD);
+    const double sinLat = latN / latNorm;
+    const double cosLat = latD / latNorm;
+
+    // Altitude above the ellipsoid, equal to p/cos(lat) - N but defined
+    // at the poles.
+    const double alt = p * cosLat + z * sinLat -
+      a * sqrt(1.0 - e2 * sinLat * sinLat);
+
+    _spherical[i].Set(IGN_RTOD(atan2(latN, latD)), IGN_RTOD(atan2(y, x)),
+        alt);
+  }
+}
+
 //////////////////////////////////////////////////
 ignition::math::Vector3d SphericalCoordinates::LocalFromSpherical(
     const ignition::math::Vector3d &_xyz) const
@@ -220,6 +278,25 @@ ignition::math::Vector3d SphericalCoordinates::GlobalFromLocal(
   return this->VelocityTransform(_xyz, LOCAL, GLOBAL);
 }
 
+//////////////////////////////////////////////////
+void SphericalCoordinates::GlobalFromLocal(
+    const std::vector<ignition::math::Vector3d> &_xyz,
+    std::vector<ignition::math::Vector3d> &_global) const
+{
+  _global.resize(_xyz.size());
+
+  // LOCAL to ECEF to GLOBAL only leaves the heading rotation, see
+  // VelocityTransform
+  const double cosHea = this->dataPtr->cosHea;
+  const double sinHea = this->dataPtr->sinHea;
+  for (size_t i = 0; i < _xyz.size(); ++i)
+  {
+    const ignition::math::Vector3d &vel = _xyz[i];
+    _global[i].Set(-vel.X() * cosHea + vel.Y() * sinHea,
+        -vel.X() * sinHea - vel.Y() * cosHea, vel.Z());
+  }
+}
+
 //////////////////////////////////////////////////
 ignition::math::Vector3d SphericalCoordinates::LocalFromGlobal(
     const ignition::math::Vector3d &_xyz) const
@@ -279,6 +356,14 @@ void SphericalCoordinates::UpdateTransformationMatrix()
   this->dataPtr->cosHea = cos(-this->dataPtr->headingOffset.Radian());
   this->dataPtr->sinHea = sin(-this->dataPtr->headingOffset.Radian());
 
+  // Cache the rotation that moves LOCAL to ECEF, as done step by step in
+  // PositionTransform
+  this->dataPtr->rotLocalToECEF = this->dataPtr->rotGlobalToECEF *
+    ignition::math::Matrix3d(
+        -this->dataPtr->cosHea, this->dataPtr->sinHea, 0,
+        -this->dataPtr->sinHea, -this->dataPtr->cosHea, 0,
+        0, 0, 1);
+
   // Cache the ECEF coordinate of the origin
   this->dataPtr->origin = ignition::math::Vector3d(
     this->dataPtr->latitudeReference.Radian(),
@@ -18,6 +18,7 @@
 #define _GAZEBO_SPHERICALCOORDINATES_HH_
 
 #include <string>
+#include <vector>
 
 #include <ignition/math/Angle.hh>
 #include <ignition/math/Vector3.hh>
@@ -100,6 +101,28 @@ namespace gazebo
       public: ignition::math::Vector3d GlobalFromLocal(
                   const ignition::math::Vector3d &_xyz) const;
 
+      /// \brief Convert Cartesian position vectors to geodetic coordinates
+      /// in one pass. The result is the same as calling SphericalFromLocal
+      /// on every vector, but the transform from the local frame to ECEF is
+      /// cached and the loop only evaluates two trigonometric functions per
+      /// vector, which makes it suited to converting many sensors at once.
+      /// \param[in] _xyz Cartesian position vectors in gazebo's world frame.
+      /// \param[out] _spherical Geodetic latitude (deg), longitude (deg) and
+      /// altitude above sea level (m) of each vector, resized to the size
+      /// of _xyz.
+      public: void SphericalFromLocal(
+                  const std::vector<ignition::math::Vector3d> &_xyz,
+                  std::vector<ignition::math::Vector3d> &_spherical) const;
+
+      /// \brief Convert Cartesian velocity vectors in the local gazebo frame
+      /// to the global East, North, Up frame in one pass.
+      /// \param[in] _xyz Cartesian vectors in gazebo's world frame.
+      /// \param[out] _global Rotated vectors with components (x,y,z):
+      /// (East, North, Up), resized to the size of _xyz.
+      public: void GlobalFromLocal(
+                  const std::vector<ignition::math::Vector3d> &_xyz,
+                  std::vector<ignition::math::Vector3d> &_global) const;
+
       /// \brief Convert a string to a SurfaceType.
       /// \param[in] _str String to convert.
       /// \return Conversion to SurfaceType.
@@ -84,6 +84,10 @@ namespace gazebo
 
       /// \brief Cache sine head transform
       public: double sinHea;
+
+      /// \brief Cache rotation matrix that moves LOCAL to ECEF, i.e. the
+      /// heading rotation followed by rotGlobalToECEF.
+      public: ignition::math::Matrix3d rotLocalToECEF;
     };
     /// \}
   }
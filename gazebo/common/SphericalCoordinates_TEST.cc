@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <vector>
 
 #include "gazebo/common/Console.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
@@ -252,6 +253,61 @@ TEST_F(SphericalCoordinatesTest, CoordinateTransforms)
   }
 }
 
+//////////////////////////////////////////////////
+// Test that batch conversions match the single vector ones
+TEST_F(SphericalCoordinatesTest, BatchTransforms)
+{
+  common::SphericalCoordinates sc(
+      common::SphericalCoordinates::EARTH_WGS84,
+      ignition::math::Angle(IGN_DTOR(47.3)),
+      ignition::math::Angle(IGN_DTOR(-122.1)),
+      120.0,
+      ignition::math::Angle(IGN_DTOR(40.0)));
+
+  std::vector<ignition::math::Vector3d> local;
+  for (int i = -10; i <= 10; ++i)
+  {
+    local.push_back(ignition::math::Vector3d(i * 1234.5, -i * 321.0,
+          i * 45.6));
+  }
+
+  std::vector<ignition::math::Vector3d> spherical;
+  std::vector<ignition::math::Vector3d> global;
+  sc.SphericalFromLocal(local, spherical);
+  sc.GlobalFromLocal(local, global);
+  ASSERT_EQ(local.size(), spherical.size());
+  ASSERT_EQ(local.size(), global.size());
+
+  for (size_t i = 0; i < local.size(); ++i)
+  {
+    ignition::math::Vector3d expected = sc.SphericalFromLocal(local[i]);
+    EXPECT_NEAR(expected.X(), spherical[i].X(), 1e-10);
+    EXPECT_NEAR(expected.Y(), spherical[i].Y(), 1e-10);
+    EXPECT_NEAR(expected.Z(), spherical[i].Z(), 1e-5);
+
+    expected = sc.GlobalFromLocal(local[i]);
+    EXPECT_NEAR(expected.X(), global[i].X(), 1e-6);
+    EXPECT_NEAR(expected.Y(), global[i].Y(), 1e-6);
+    EXPECT_NEAR(expected.Z(), global[i].Z(), 1e-6);
+  }
+
+  // Outputs are resized to the inputs
+  local.clear();
+  sc.SphericalFromLocal(local, spherical);
+  EXPECT_TRUE(spherical.empty());
+
+  // The north pole is converted without dividing by zero
+  common::SphericalCoordinates pole(
+      common::SphericalCoordinates::EARTH_WGS84,
+      ignition::math::Angle(IGN_DTOR(90.0)),
+      ignition::math::Angle(0.0), 0.0, ignition::math::Angle(0.0));
+  local.push_back(ignition::math::Vector3d(0, 0, 10));
+  pole.SphericalFromLocal(local, spherical);
+  ASSERT_EQ(1u, spherical.size());
+  EXPECT_NEAR(90.0, spherical[0].X(), 1e-6);
+  EXPECT_NEAR(10.0, spherical[0].Z(), 1e-6);
+}
+
 //////////////////////////////////////////////////
 // Test distance
 TEST_F(SphericalCoordinatesTest, Distance)
@@ -17,6 +17,7 @@
 
 #include <google/protobuf/descriptor.h>
 #include <algorithm>
+#include <cmath>
 #include <ignition/math/MassMatrix3.hh>
 #include <ignition/math/Rand.hh>
 
@@ -160,6 +161,90 @@ namespace gazebo
       Set(_p->mutable_orientation(), _v.Rot());
     }
 
+    /////////////////////////////////////////////
+    void AddPose(msgs::PoseStream &_msg, const uint32_t _id,
+                 const ignition::math::Pose3d &_pose)
+    {
+      _msg.add_id(_id);
+
+      const double resolution = _msg.position_resolution();
+      if (resolution > 0)
+      {
+        _msg.add_position_quantized(
+            static_cast<int32_t>(std::round(_pose.Pos().X() / resolution)));
+        _msg.add_position_quantized(
+            static_cast<int32_t>(std::round(_pose.Pos().Y() / resolution)));
+        _msg.add_position_quantized(
+            static_cast<int32_t>(std::round(_pose.Pos().Z() / resolution)));
+
+        _msg.add_orientation_quantized(
+            static_cast<int32_t>(std::round(_pose.Rot().W() * 32767.0)));
+        _msg.add_orientation_quantized(
+            static_cast<int32_t>(std::round(_pose.Rot().X() * 32767.0)));
+        _msg.add_orientation_quantized(
+            static_cast<int32_t>(std::round(_pose.Rot().Y() * 32767.0)));
+        _msg.add_orientation_quantized(
+            static_cast<int32_t>(std::round(_pose.Rot().Z() * 32767.0)));
+      }
+      else
+      {
+        _msg.add_position(_pose.Pos().X());
+        _msg.add_position(_pose.Pos().Y());
+        _msg.add_position(_pose.Pos().Z());
+
+        _msg.add_orientation(_pose.Rot().W());
+        _msg.add_orientation(_pose.Rot().X());
+        _msg.add_orientation(_pose.Rot().Y());
+        _msg.add_orientation(_pose.Rot().Z());
+      }
+    }
+
+    /////////////////////////////////////////////
+    ignition::math::Pose3d PoseStreamPose(const msgs::PoseStream &_msg,
+                                          const int _index)
+    {
+      const double resolution = _msg.position_resolution();
+      if (resolution > 0)
+      {
+        if (_msg.position_quantized_size() < (_index + 1) * 3 ||
+            _msg.orientation_quantized_size() < (_index + 1) * 4)
+        {
+          gzerr << "Invalid pose index [" << _index << "]" << std::endl;
+          return ignition::math::Pose3d::Zero;
+        }
+
+        const double scale = 1.0 / 32767.0;
+        ignition::math::Quaterniond rot(
+            _msg.orientation_quantized(_index * 4) * scale,
+            _msg.orientation_quantized(_index * 4 + 1) * scale,
+            _msg.orientation_quantized(_index * 4 + 2) * scale,
+            _msg.orientation_quantized(_index * 4 + 3) * scale);
+        rot.Normalize();
+
+        return ignition::math::Pose3d(ignition::math::Vector3d(
+              _msg.position_quantized(_index * 3) * resolution,
+              _msg.position_quantized(_index * 3 + 1) * resolution,
+              _msg.position_quantized(_index * 3 + 2) * resolution), rot);
+      }
+
+      if (_msg.position_size() < (_index + 1) * 3 ||
+          _msg.orientation_size() < (_index + 1) * 4)
+      {
+        gzerr << "Invalid pose index [" << _index << "]" << std::endl;
+        return ignition::math::Pose3d::Zero;
+      }
+
+      return ignition::math::Pose3d(ignition::math::Vector3d(
+            _msg.position(_index * 3),
+            _msg.position(_index * 3 + 1),
+            _msg.position(_index * 3 + 2)),
+          ignition::math::Quaterniond(
+            _msg.orientation(_index * 4),
+            _msg.orientation(_index * 4 + 1),
+            _msg.orientation(_index * 4 + 2),
+            _msg.orientation(_index * 4 + 3)));
+    }
+
     /////////////////////////////////////////////
     void Set(msgs::Color *_c, const ignition::math::Color &_v)
     {
@@ -302,6 +302,24 @@ namespace gazebo
     GAZEBO_VISIBLE
     void Set(msgs::Pose *_p, const ignition::math::Pose3d &_v);
 
+    /// \brief Append a pose to a msgs::PoseStream. The pose is quantized
+    /// when the message has a position resolution, so the resolution must
+    /// be set before adding poses.
+    /// \param[out] _msg A msgs::PoseStream reference
+    /// \param[in] _id Id of the entity
+    /// \param[in] _pose Pose of the entity
+    GAZEBO_VISIBLE
+    void AddPose(msgs::PoseStream &_msg, const uint32_t _id,
+                 const ignition::math::Pose3d &_pose);
+
+    /// \brief Get a pose from a msgs::PoseStream
+    /// \param[in] _msg A msgs::PoseStream reference
+    /// \param[in] _index Index of the pose, between 0 and _msg.id_size()
+    /// \return The decoded pose
+    GAZEBO_VISIBLE
+    ignition::math::Pose3d PoseStreamPose(const msgs::PoseStream &_msg,
+                                          const int _index);
+
     /// \brief Set a msgs::Color from an ignition::math::Color
     /// \param[out] _p A msgs::Color pointer
     /// \param[in] _v An ignition::math::Color reference
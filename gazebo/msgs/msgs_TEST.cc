@@ -100,6 +100,43 @@ TEST_F(MsgsTest, Packet)
   EXPECT_STREQ("test_string", msg.data().c_str());
 }
 
+TEST_F(MsgsTest, PoseStream)
+{
+  const ignition::math::Pose3d pose(1.23456789, -2.5, 1000.0001,
+      0.1, -0.2, 0.3);
+
+  // Full precision
+  msgs::PoseStream msg;
+  msgs::AddPose(msg, 3, pose);
+  msgs::AddPose(msg, 7, ignition::math::Pose3d::Zero);
+  ASSERT_EQ(msg.id_size(), 2);
+  EXPECT_EQ(msg.id(0), 3u);
+  EXPECT_EQ(msg.id(1), 7u);
+  EXPECT_EQ(msg.position_quantized_size(), 0);
+  EXPECT_EQ(msgs::PoseStreamPose(msg, 0), pose);
+  EXPECT_EQ(msgs::PoseStreamPose(msg, 1), ignition::math::Pose3d::Zero);
+
+  // Quantized
+  msgs::PoseStream quantized;
+  quantized.set_position_resolution(1e-3);
+  msgs::AddPose(quantized, 3, pose);
+  ASSERT_EQ(quantized.id_size(), 1);
+  EXPECT_EQ(quantized.position_size(), 0);
+  EXPECT_EQ(quantized.position_quantized_size(), 3);
+  EXPECT_EQ(quantized.orientation_quantized_size(), 4);
+
+  auto decoded = msgs::PoseStreamPose(quantized, 0);
+  EXPECT_NEAR(decoded.Pos().X(), pose.Pos().X(), 0.5e-3);
+  EXPECT_NEAR(decoded.Pos().Y(), pose.Pos().Y(), 0.5e-3);
+  EXPECT_NEAR(decoded.Pos().Z(), pose.Pos().Z(), 0.5e-3);
+  EXPECT_NEAR(decoded.Rot().Euler().X(), 0.1, 1e-3);
+  EXPECT_NEAR(decoded.Rot().Euler().Y(), -0.2, 1e-3);
+  EXPECT_NEAR(decoded.Rot().Euler().Z(), 0.3, 1e-3);
+
+  // Out of range index
+  EXPECT_EQ(msgs::PoseStreamPose(quantized, 1), ignition::math::Pose3d::Zero);
+}
+
 TEST_F(MsgsTest, BadPackage)
 {
   msgs::GzString msg;
@@ -15,7 +15,11 @@
  *
 */
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/msgs/MessageTypes.hh"
@@ -54,6 +58,16 @@ class SDFCollisionInitializer
 };
 static SDFCollisionInitializer g_SDFInit;
 
+// TODO declared here for ABI compatibility
+// move to class member variable(s) when merging forward.
+static std::unordered_map<const Collision *,
+    std::shared_ptr<ContactSurfaceFunc>> g_contactSurfaceFuncs;
+static std::mutex g_contactSurfaceFuncsMutex;
+
+/// \brief Number of entries of g_contactSurfaceFuncs, checked without the
+/// lock since the physics engines query every colliding pair.
+static std::atomic<size_t> g_contactSurfaceFuncCount(0);
+
 
 //////////////////////////////////////////////////
 Collision::Collision(LinkPtr _link)
@@ -90,6 +104,7 @@ void Collision::Fini()
   this->link.reset();
   this->shape.reset();
   this->surface.reset();
+  this->SetContactSurfaceFunc(nullptr);
 
   Entity::Fini();
 }
@@ -390,6 +405,45 @@ unsigned int Collision::GetMaxContacts()
   return this->maxContacts;
 }
 
+/////////////////////////////////////////////////
+void Collision::SetContactSurfaceFunc(const ContactSurfaceFunc &_func)
+{
+  std::lock_guard<std::mutex> lock(g_contactSurfaceFuncsMutex);
+  if (_func)
+    g_contactSurfaceFuncs[this] = std::make_shared<ContactSurfaceFunc>(_func);
+  else
+    g_contactSurfaceFuncs.erase(this);
+  g_contactSurfaceFuncCount = g_contactSurfaceFuncs.size();
+}
+
+/////////////////////////////////////////////////
+bool Collision::HasContactSurfaceFunc() const
+{
+  if (g_contactSurfaceFuncCount == 0)
+    return false;
+
+  std::lock_guard<std::mutex> lock(g_contactSurfaceFuncsMutex);
+  return g_contactSurfaceFuncs.count(this) > 0;
+}
+
+/////////////////////////////////////////////////
+void Collision::ProcessContactSurface(ContactSurface &_surface) const
+{
+  if (g_contactSurfaceFuncCount == 0)
+    return;
+
+  // The callback is called without the lock, it may set callbacks
+  std::shared_ptr<ContactSurfaceFunc> func;
+  {
+    std::lock_guard<std::mutex> lock(g_contactSurfaceFuncsMutex);
+    auto iter = g_contactSurfaceFuncs.find(this);
+    if (iter == g_contactSurfaceFuncs.end())
+      return;
+    func = iter->second;
+  }
+  (*func)(_surface);
+}
+
 /////////////////////////////////////////////////
 const ignition::math::Pose3d &Collision::WorldPose() const
 {
@@ -25,6 +25,7 @@
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/CollisionState.hh"
 #include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/SurfaceParams.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -192,6 +193,26 @@ namespace gazebo
       /// \return max num contacts allowed for this collision.
       public: virtual unsigned int GetMaxContacts();
 
+      /// \brief Set a callback that edits the surface of every contact
+      /// point of this collision, right before the physics engine creates
+      /// its contact constraint. The callback is not called for collisions
+      /// that collide without contact. If both collisions of a contact
+      /// have a callback, the one of the first collision runs first.
+      /// Supported by ODE. Bullet calls the callback of the first collision
+      /// of each link when a contact point is added, and only applies the
+      /// primary friction coefficient. Other engines ignore it.
+      /// \param[in] _func The callback, or nullptr to remove it.
+      public: void SetContactSurfaceFunc(const ContactSurfaceFunc &_func);
+
+      /// \brief Whether a contact surface callback is set.
+      /// \return True if a callback is set.
+      public: bool HasContactSurfaceFunc() const;
+
+      /// \brief Call the contact surface callback, if any. Used by the
+      /// physics engines.
+      /// \param[in,out] _surface Surface of the contact point.
+      public: void ProcessContactSurface(ContactSurface &_surface) const;
+
       /// \brief Indicate that the world pose should be recalculated.
       /// The recalculation will be done when Collision::GetWorldPose is
       /// called.
@@ -15,7 +15,13 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
+#include "gazebo/transport/MessagePool.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Publisher.hh"
 #include "gazebo/transport/TransportIface.hh"
@@ -26,10 +32,75 @@
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/Contact.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/SleepManager.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief In-process feed of a contact filter.
+    class ContactFeed
+    {
+      /// \brief Callback that receives the filtered contacts.
+      public: ContactFeedCallback callback;
+
+      /// \brief Indices of the contact buffer records of the current step.
+      public: std::vector<unsigned int> records;
+    };
+
+    /// \internal
+    /// \brief Sleep manager and in-process feeds of a contact manager.
+    class ContactManagerFeeds
+    {
+      /// \brief Constructor.
+      public: ContactManagerFeeds()
+        : buffers(2 * ContactBuffer::MaxRetained + 1),
+          names(new ContactBuffer::NameTable)
+      {
+      }
+
+      /// \brief Sleep manager of the physics engine.
+      public: SleepManager *sleepManager = nullptr;
+
+      /// \brief Feeds by contact filter. Guarded by the custom mutex of
+      /// the contact manager.
+      public: std::unordered_map<const ContactPublisher *, ContactFeed> feeds;
+
+      /// \brief Contact buffers handed to the in-process feeds.
+      public: transport::MessagePool<ContactBuffer> buffers;
+
+      /// \brief Scoped names of the collisions seen by the feeds. Replaced
+      /// by a new table when a collision is added to it.
+      public: boost::shared_ptr<const ContactBuffer::NameTable> names;
+    };
+  }
+}
 
 using namespace gazebo;
 using namespace physics;
 
+// TODO declared here for ABI compatibility
+// move to class member variables when merging forward.
+static std::unordered_map<const ContactManager *,
+    std::unique_ptr<ContactManagerFeeds>> g_contactFeeds;
+
+/// \brief Protects g_contactFeeds.
+static std::mutex g_contactFeedsMutex;
+
+/////////////////////////////////////////////////
+/// \brief Get the feeds of a contact manager.
+/// \param[in] _manager The contact manager.
+/// \return The feeds, which live as long as the manager.
+static ContactManagerFeeds &Feeds(const ContactManager *_manager)
+{
+  std::lock_guard<std::mutex> lock(g_contactFeedsMutex);
+  auto &feeds = g_contactFeeds[_manager];
+  if (!feeds)
+    feeds.reset(new ContactManagerFeeds);
+  return *feeds;
+}
+
 /////////////////////////////////////////////////
 ContactManager::ContactManager()
 {
@@ -66,6 +137,9 @@ ContactManager::~ContactManager()
   this->customMutex = NULL;
 
   this->world.reset();
+
+  std::lock_guard<std::mutex> lock(g_contactFeedsMutex);
+  g_contactFeeds.erase(this);
 }
 
 /////////////////////////////////////////////////
@@ -80,6 +154,12 @@ void ContactManager::Init(WorldPtr _world)
     this->node->Advertise<msgs::Contacts>("~/physics/contacts", 50);
 }
 
+/////////////////////////////////////////////////
+void ContactManager::SetSleepManager(SleepManager *_sleepManager)
+{
+  Feeds(this).sleepManager = _sleepManager;
+}
+
 /////////////////////////////////////////////////
 void ContactManager::SetNeverDropContacts(const bool _neverDrop)
 {
@@ -193,6 +273,12 @@ Contact *ContactManager::NewContact(Collision *_collision1,
   if (!_collision1 || !_collision2)
     return result;
 
+  // Contacts of links at rest are not published on the default topic.
+  // This also wakes up a sleeping link touched by a moving one.
+  SleepManager *sleepManager = Feeds(this).sleepManager;
+  const bool resting = sleepManager &&
+    sleepManager->Resting(_collision1, _collision2);
+
   // If no one is listening to the default topic, or there are no
   // custom contact publishers then don't create any contact information.
   // This is a signal to the Physics engine that it can skip the extra
@@ -207,7 +293,7 @@ Contact *ContactManager::NewContact(Collision *_collision1,
                             getOnlyConnected, publishers);
 
   if (this->NeverDropContacts() ||
-      this->contactPub->HasConnections() ||
+      (!resting && this->contactPub->HasConnections()) ||
       !publishers.empty())
   {
     // Get or create a contact feedback object.
@@ -314,11 +400,73 @@ void ContactManager::PublishContacts()
 
   // publish to other custom topics
   boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+
+  // Copy the contacts of the in-process feeds once into a buffer shared by
+  // all of them. The buffer is complete before any feed receives it.
+  ContactManagerFeeds &data = Feeds(this);
+  boost::shared_ptr<ContactBuffer> buffer;
+  std::unordered_map<const Contact *, unsigned int> bufferIndex;
+  boost::shared_ptr<ContactBuffer::NameTable> newNames;
+  for (auto &feed : data.feeds)
+  {
+    const ContactPublisher *contactPublisher = feed.first;
+
+    if (!buffer)
+    {
+      buffer = data.buffers.Acquire();
+      buffer->Clear();
+      buffer->world = this->world->Name();
+      buffer->time = this->world->SimTime();
+    }
+
+    feed.second.records.clear();
+    for (auto const &contact : contactPublisher->contacts)
+    {
+      if (contact->count == 0)
+        continue;
+
+      auto inserted = bufferIndex.emplace(contact, 0);
+      if (inserted.second)
+      {
+        inserted.first->second = buffer->Add(*contact);
+
+        // Names are only looked up the first time a collision is seen
+        for (Collision *collision : {contact->collision1, contact->collision2})
+        {
+          if (data.names->count(collision->GetId()))
+            continue;
+          if (!newNames)
+            newNames.reset(new ContactBuffer::NameTable(*data.names));
+          newNames->emplace(collision->GetId(), collision->GetScopedName());
+        }
+      }
+      feed.second.records.push_back(inserted.first->second);
+    }
+  }
+
+  if (newNames)
+    data.names = newNames;
+  if (buffer)
+    buffer->names = data.names;
+
   boost::unordered_map<std::string, ContactPublisher *>::iterator iter;
   for (iter = this->customContactPublishers.begin();
       iter != this->customContactPublishers.end(); ++iter)
   {
     ContactPublisher *contactPublisher = iter->second;
+    auto feed = data.feeds.find(contactPublisher);
+    if (feed != data.feeds.end())
+    {
+      feed->second.callback(buffer, feed->second.records);
+
+      // Only build a message if someone listens to the filter topic
+      if (!contactPublisher->publisher->HasConnections())
+      {
+        contactPublisher->contacts.clear();
+        continue;
+      }
+    }
+
     msgs::Contacts msg2;
     for (unsigned int j = 0;
         j < contactPublisher->contacts.size(); ++j)
@@ -437,6 +585,7 @@ void ContactManager::RemoveFilter(const std::string &_name)
   {
     ContactPublisher *contactPublisher = iter->second;
     contactPublisher->contacts.clear();
+    Feeds(this).feeds.erase(contactPublisher);
     contactPublisher->collisionNames.clear();
     contactPublisher->collisions.clear();
     contactPublisher->publisher->Fini();
@@ -445,6 +594,35 @@ void ContactManager::RemoveFilter(const std::string &_name)
   }
 }
 
+/////////////////////////////////////////////////
+bool ContactManager::SetFilterFeed(const std::string &_name,
+    const ContactFeedCallback &_feed)
+{
+  std::string name = _name;
+  boost::replace_all(name, "::", "/");
+
+  boost::recursive_mutex::scoped_lock lock(*this->customMutex);
+  auto iter = this->customContactPublishers.find(name);
+  if (iter == this->customContactPublishers.end())
+  {
+    gzerr << "Contact filter [" << _name << "] does not exist" << std::endl;
+    return false;
+  }
+
+  auto &feeds = Feeds(this).feeds;
+  if (_feed)
+  {
+    ContactFeed &feed = feeds[iter->second];
+    feed.callback = _feed;
+    feed.records.clear();
+  }
+  else
+  {
+    feeds.erase(iter->second);
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////
 unsigned int ContactManager::GetFilterCount()
 {
@@ -462,3 +640,88 @@ bool ContactManager::HasFilter(const std::string &_name)
   return this->customContactPublishers.find(name) !=
       this->customContactPublishers.end();
 }
+
+/////////////////////////////////////////////////
+unsigned int ContactBuffer::Add(const Contact &_contact)
+{
+  Record record;
+  record.collisionId1 = _contact.collision1->GetId();
+  record.collisionId2 = _contact.collision2->GetId();
+  record.first = this->positions.size();
+  record.count = static_cast<unsigned int>(std::max(_contact.count, 0));
+
+  for (unsigned int i = 0; i < record.count; ++i)
+  {
+    this->positions.push_back(_contact.positions[i]);
+    this->normals.push_back(_contact.normals[i]);
+    this->depths.push_back(_contact.depths[i]);
+    this->wrenches.push_back(_contact.wrench[i]);
+  }
+
+  this->records.push_back(record);
+  return this->records.size() - 1;
+}
+
+/////////////////////////////////////////////////
+void ContactBuffer::FillMsg(const unsigned int _record,
+    msgs::Contact &_msg) const
+{
+  if (_record >= this->records.size())
+  {
+    gzerr << "Invalid contact record index[" << _record << "]\n";
+    return;
+  }
+
+  const Record &record = this->records[_record];
+  const std::string &collision1 = this->CollisionName(record.collisionId1);
+  const std::string &collision2 = this->CollisionName(record.collisionId2);
+
+  _msg.set_world(this->world);
+  _msg.set_collision1(collision1);
+  _msg.set_collision2(collision2);
+  msgs::Set(_msg.mutable_time(), this->time);
+
+  for (unsigned int j = record.first; j < record.first + record.count; ++j)
+  {
+    _msg.add_depth(this->depths[j]);
+
+    msgs::Set(_msg.add_position(), this->positions[j]);
+    msgs::Set(_msg.add_normal(), this->normals[j]);
+
+    msgs::JointWrench *jntWrench = _msg.add_wrench();
+    jntWrench->set_body_1_name(collision1);
+    jntWrench->set_body_1_id(record.collisionId1);
+    jntWrench->set_body_2_name(collision2);
+    jntWrench->set_body_2_id(record.collisionId2);
+
+    msgs::Wrench *wrenchMsg =  jntWrench->mutable_body_1_wrench();
+    msgs::Set(wrenchMsg->mutable_force(), this->wrenches[j].body1Force);
+    msgs::Set(wrenchMsg->mutable_torque(), this->wrenches[j].body1Torque);
+
+    wrenchMsg =  jntWrench->mutable_body_2_wrench();
+    msgs::Set(wrenchMsg->mutable_force(), this->wrenches[j].body2Force);
+    msgs::Set(wrenchMsg->mutable_torque(), this->wrenches[j].body2Torque);
+  }
+}
+
+/////////////////////////////////////////////////
+const std::string &ContactBuffer::CollisionName(const uint32_t _id) const
+{
+  static const std::string empty;
+  if (!this->names)
+    return empty;
+
+  auto iter = this->names->find(_id);
+  return iter != this->names->end() ? iter->second : empty;
+}
+
+/////////////////////////////////////////////////
+void ContactBuffer::Clear()
+{
+  this->records.clear();
+  this->positions.clear();
+  this->normals.clear();
+  this->depths.clear();
+  this->wrenches.clear();
+  this->names.reset();
+}
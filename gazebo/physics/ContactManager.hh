@@ -18,9 +18,11 @@
 #ifndef GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 #define GAZEBO_PHYSICS_CONTACTMANAGER_HH_
 
+#include <functional>
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <ignition/transport/Node.hh>
 
 #include <boost/unordered/unordered_set.hpp>
@@ -37,6 +39,95 @@ namespace gazebo
 {
   namespace physics
   {
+    class SleepManager;
+
+    /// \brief Compact copy of the contacts of one simulation step, handed
+    /// to in-process contact feeds. A single buffer is shared by all the
+    /// feeds of a step and is not modified once it has been delivered.
+    class GZ_PHYSICS_VISIBLE ContactBuffer
+    {
+      /// \brief A contact between two collisions. Its contact points are
+      /// stored in the point arrays of the buffer.
+      public: class Record
+      {
+        /// \brief Id of the first collision.
+        public: uint32_t collisionId1 = 0;
+
+        /// \brief Id of the second collision.
+        public: uint32_t collisionId2 = 0;
+
+        /// \brief Index of the first contact point in the point arrays.
+        public: unsigned int first = 0;
+
+        /// \brief Number of contact points.
+        public: unsigned int count = 0;
+      };
+
+      /// \brief Scoped names of collisions, by collision id.
+      public: typedef std::unordered_map<uint32_t, std::string> NameTable;
+
+      /// \brief Maximum number of buffers a feed should keep. The contact
+      /// manager pools enough buffers for a feed that keeps this many
+      /// steps pending, and as many being processed.
+      public: static const unsigned int MaxRetained = 100;
+
+      /// \brief Append a contact to the buffer.
+      /// \param[in] _contact Contact to copy.
+      /// \return Index of the new record.
+      public: unsigned int Add(const Contact &_contact);
+
+      /// \brief Get the scoped name of a collision of the buffer.
+      /// \param[in] _id Id of the collision.
+      /// \return Scoped name of the collision, empty if unknown.
+      public: const std::string &CollisionName(const uint32_t _id) const;
+
+      /// \brief Populate a contact message from a record.
+      /// \param[in] _record Index of the record.
+      /// \param[out] _msg Contact message that will hold the data.
+      public: void FillMsg(const unsigned int _record,
+                           msgs::Contact &_msg) const;
+
+      /// \brief Remove all the contacts.
+      public: void Clear();
+
+      /// \brief Name of the world in which the contacts occurred.
+      public: std::string world;
+
+      /// \brief Time at which the contacts occurred.
+      public: common::Time time;
+
+      /// \brief Contacts of the step.
+      public: std::vector<Record> records;
+
+      /// \brief Positions of the contact points.
+      public: std::vector<ignition::math::Vector3d> positions;
+
+      /// \brief Normals of the contact points.
+      public: std::vector<ignition::math::Vector3d> normals;
+
+      /// \brief Depths of the contact points.
+      public: std::vector<double> depths;
+
+      /// \brief Wrenches of the contact points.
+      public: std::vector<JointWrench> wrenches;
+
+      /// \brief Scoped names of the collisions of the records. The table
+      /// is shared by the buffers and never modified once it is set.
+      public: boost::shared_ptr<const NameTable> names;
+    };
+
+    /// \def ConstContactBufferPtr
+    /// \brief Shared pointer to a delivered contact buffer.
+    typedef boost::shared_ptr<const ContactBuffer> ConstContactBufferPtr;
+
+    /// \def ContactFeedCallback
+    /// \brief Callback of an in-process contact feed. It receives the
+    /// contact buffer of a step and the indices of the records that
+    /// involve the collisions of the filter. It is called from the physics
+    /// thread and must return quickly.
+    typedef std::function<void(const ConstContactBufferPtr &,
+        const std::vector<unsigned int> &)> ContactFeedCallback;
+
     /// \brief A custom contact publisher created for each contact filter
     /// in the Contact Manager.
     class GZ_PHYSICS_VISIBLE ContactPublisher
@@ -84,6 +175,12 @@ namespace gazebo
       /// contact manager.
       public: void Init(WorldPtr _world);
 
+      /// \brief Set the sleep manager of the physics engine. A sleeping
+      /// link touched by a moving link is woken up, and the contacts of
+      /// links at rest are only added for the filters of their collisions.
+      /// \param[in] _sleepManager The sleep manager.
+      public: void SetSleepManager(SleepManager *_sleepManager);
+
       /// \brief Add a new contact.
       ///
       /// Normally this is only used by a Physics/Collision engine when
@@ -191,6 +288,16 @@ namespace gazebo
                   const std::map<std::string, physics::CollisionPtr>
                   &_collisions);
 
+      /// \brief Deliver the contacts of a filter to a callback after each
+      /// step, without serializing them into messages. The filter topic is
+      /// still published whenever it has subscribers.
+      /// \param[in] _name Filter name.
+      /// \param[in] _feed Callback that receives the filtered contacts. An
+      /// empty function disables the feed.
+      /// \return False if the filter does not exist.
+      public: bool SetFilterFeed(const std::string &_name,
+                                 const ContactFeedCallback &_feed);
+
       /// \brief Remove a contacts filter and the associated custom publisher
       /// param[in] _name Filter name.
       public: void RemoveFilter(const std::string &_name);
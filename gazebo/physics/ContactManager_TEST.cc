@@ -15,6 +15,9 @@
  *
 */
 
+#include <string>
+#include <vector>
+
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/test/ServerFixture.hh"
 
@@ -194,6 +197,86 @@ TEST_F(ContactManagerTest, NeverDropContacts)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(ContactManagerTest, FilterFeed)
+{
+  // world needs to be paused in order to use World::Step()
+  // function correctly (second parameter true)
+  Load("test/worlds/box.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::ContactManager *manager = physics->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // Feeds can only be attached to existing filters
+  EXPECT_FALSE(manager->SetFilterFeed("no_filter", nullptr));
+
+  std::string collisionName = "box::link::collision";
+  std::string filterName = "box_feed";
+  std::vector<std::string> collisions;
+  collisions.push_back(collisionName);
+  EXPECT_FALSE(manager->CreateFilter(filterName, collisions).empty());
+
+  unsigned int feedCount = 0;
+  physics::ConstContactBufferPtr lastBuffer;
+  std::vector<unsigned int> lastRecords;
+  EXPECT_TRUE(manager->SetFilterFeed(filterName,
+      [&](const physics::ConstContactBufferPtr &_buffer,
+          const std::vector<unsigned int> &_records)
+      {
+        ++feedCount;
+        lastBuffer = _buffer;
+        lastRecords = _records;
+      }));
+
+  // The box rests on the ground, so every step has contacts
+  world->Step(1);
+  EXPECT_EQ(feedCount, 1u);
+  ASSERT_TRUE(lastBuffer != nullptr);
+  ASSERT_FALSE(lastRecords.empty());
+  EXPECT_EQ(lastBuffer->time, world->SimTime());
+  EXPECT_EQ(lastBuffer->world, world->Name());
+
+  for (auto const &index : lastRecords)
+  {
+    ASSERT_LT(index, lastBuffer->records.size());
+    const physics::ContactBuffer::Record &record =
+      lastBuffer->records[index];
+    EXPECT_TRUE(
+        lastBuffer->CollisionName(record.collisionId1) == collisionName ||
+        lastBuffer->CollisionName(record.collisionId2) == collisionName);
+    EXPECT_GT(record.count, 0u);
+    EXPECT_LE(record.first + record.count, lastBuffer->positions.size());
+
+    // The message matches the record
+    msgs::Contact msg;
+    lastBuffer->FillMsg(index, msg);
+    EXPECT_EQ(msg.collision1(),
+        lastBuffer->CollisionName(record.collisionId1));
+    EXPECT_EQ(msg.collision2(),
+        lastBuffer->CollisionName(record.collisionId2));
+    EXPECT_EQ(msg.position_size(), static_cast<int>(record.count));
+    EXPECT_EQ(msg.wrench_size(), static_cast<int>(record.count));
+    EXPECT_EQ(msgs::ConvertIgn(msg.position(0)),
+              lastBuffer->positions[record.first]);
+  }
+
+  // The feed is called once per step
+  world->Step(3);
+  EXPECT_EQ(feedCount, 4u);
+
+  // Removing the filter stops the feed
+  manager->RemoveFilter(filterName);
+  world->Step(1);
+  EXPECT_EQ(feedCount, 4u);
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
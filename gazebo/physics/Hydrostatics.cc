@@ -0,0 +1,690 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "gazebo/common/CommonIface.hh"
+#include "gazebo/common/Console.hh"
+#include "gazebo/common/Events.hh"
+#include "gazebo/common/Mesh.hh"
+#include "gazebo/common/MeshManager.hh"
+#include "gazebo/physics/BoxShape.hh"
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/CylinderShape.hh"
+#include "gazebo/physics/Hydrostatics.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/MeshShape.hh"
+#include "gazebo/physics/SphereShape.hh"
+#include "gazebo/physics/World.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief A link with buoyancy.
+    class HydrostaticsBody
+    {
+      /// \brief The link.
+      public: LinkPtr link;
+
+      /// \brief Density of the water.
+      public: double fluidDensity = 0;
+
+      /// \brief Mesh vertices in the link frame.
+      public: std::vector<ignition::math::Vector3d> localVertices;
+
+      /// \brief Three vertex indices per triangle, oriented outwards.
+      public: std::vector<unsigned int> indices;
+
+      /// \brief Volume of the whole mesh.
+      public: double volume = 0;
+
+      /// \brief Centroid of the whole mesh in the link frame.
+      public: ignition::math::Vector3d centroid;
+
+      /// \brief Distance from the link origin to the farthest vertex.
+      public: double radius = 0;
+
+      /// \brief Link pose, refreshed at every update.
+      public: ignition::math::Pose3d pose;
+
+      /// \brief Mesh vertices in the world frame, scratch space.
+      public: std::vector<ignition::math::Vector3d> worldVertices;
+
+      /// \brief Submerged volume at the last update.
+      public: double submergedVolume = 0;
+
+      /// \brief World centroid of the submerged volume at the last update.
+      public: ignition::math::Vector3d submergedCentroid;
+    };
+
+    /// \internal
+    /// \brief Private data for the Hydrostatics class
+    class HydrostaticsPrivate
+    {
+      /// \brief Compute the submerged volume of a body.
+      /// \param[in] _body The body.
+      /// \param[in] _time Simulation time.
+      public: void Compute(HydrostaticsBody &_body, const double _time) const;
+
+      /// \brief Height of the water surface and its slope.
+      /// \param[in] _x World x coordinate.
+      /// \param[in] _y World y coordinate.
+      /// \param[in] _time Simulation time.
+      /// \param[out] _dx Slope of the surface along x.
+      /// \param[out] _dy Slope of the surface along y.
+      /// \return Height of the surface.
+      public: double Surface(const double _x, const double _y,
+                  const double _time, double &_dx, double &_dy) const;
+
+      /// \brief Remove a link, the mutex must be locked.
+      /// \param[in] _link The link.
+      public: void Remove(const LinkPtr &_link);
+
+      /// \brief World of the links.
+      public: WorldPtr world;
+
+      /// \brief Protects the bodies.
+      public: mutable std::mutex mutex;
+
+      /// \brief All the links with buoyancy.
+      public: std::vector<HydrostaticsBody> bodies;
+
+      /// \brief Calm water level.
+      public: double level = 0;
+
+      /// \brief Wave amplitude.
+      public: double amplitude = 0;
+
+      /// \brief Wave number, 2 pi over the wave length.
+      public: double waveNumber = 0;
+
+      /// \brief Angular frequency, 2 pi over the wave period.
+      public: double frequency = 0;
+
+      /// \brief Unit direction of propagation of the wave.
+      public: ignition::math::Vector2d direction =
+                  ignition::math::Vector2d(1, 0);
+
+      /// \brief Connection to the world update event.
+      public: event::ConnectionPtr updateConnection;
+    };
+
+    /// \internal
+    /// \brief Instances by world name.
+    static std::map<std::string, std::weak_ptr<Hydrostatics>> gInstances;
+
+    /// \internal
+    /// \brief Protects gInstances.
+    static std::mutex gInstancesMutex;
+
+    /// \internal
+    /// \brief Add a triangle of a convex shape, oriented away from its
+    /// center.
+    /// \param[in] _center Center of the shape.
+    /// \param[in] _a First vertex index.
+    /// \param[in] _b Second vertex index.
+    /// \param[in] _c Third vertex index.
+    /// \param[in,out] _body Body holding the vertices.
+    static void AddConvexTriangle(const ignition::math::Vector3d &_center,
+        const unsigned int _a, const unsigned int _b, const unsigned int _c,
+        HydrostaticsBody &_body)
+    {
+      const auto &v = _body.localVertices;
+      const ignition::math::Vector3d normal =
+          (v[_b] - v[_a]).Cross(v[_c] - v[_a]);
+      const ignition::math::Vector3d out = (v[_a] + v[_b] + v[_c]) / 3.0 -
+          _center;
+      _body.indices.push_back(_a);
+      if (normal.Dot(out) >= 0)
+      {
+        _body.indices.push_back(_b);
+        _body.indices.push_back(_c);
+      }
+      else
+      {
+        _body.indices.push_back(_c);
+        _body.indices.push_back(_b);
+      }
+    }
+
+    /// \internal
+    /// \brief Append the closed mesh of a collision to a body, in the link
+    /// frame.
+    /// \param[in] _collision The collision.
+    /// \param[in,out] _body The body.
+    /// \return True if the shape could be meshed.
+    static bool AppendCollision(const CollisionPtr &_collision,
+        HydrostaticsBody &_body)
+    {
+      const ShapePtr shape = _collision->GetShape();
+      const ignition::math::Pose3d pose = _collision->RelativePose();
+      auto &vertices = _body.localVertices;
+      const unsigned int first = vertices.size();
+      const unsigned int firstIndex = _body.indices.size();
+      const ignition::math::Vector3d center = pose.Pos();
+
+      if (shape->HasType(Base::BOX_SHAPE))
+      {
+        const ignition::math::Vector3d half =
+            boost::static_pointer_cast<BoxShape>(shape)->Size() * 0.5;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+          vertices.push_back(pose.CoordPositionAdd(ignition::math::Vector3d(
+              (i & 1) ? half.X() : -half.X(),
+              (i & 2) ? half.Y() : -half.Y(),
+              (i & 4) ? half.Z() : -half.Z())));
+        }
+        // Two triangles per face, indices of the corners by axis bits
+        static const unsigned int faces[6][4] = {
+          {0, 2, 6, 4}, {1, 3, 7, 5}, {0, 1, 5, 4},
+          {2, 3, 7, 6}, {0, 1, 3, 2}, {4, 5, 7, 6}};
+        for (auto const &f : faces)
+        {
+          AddConvexTriangle(center, first + f[0], first + f[1], first + f[2],
+              _body);
+          AddConvexTriangle(center, first + f[0], first + f[2], first + f[3],
+              _body);
+        }
+        return true;
+      }
+
+      if (shape->HasType(Base::SPHERE_SHAPE) ||
+          shape->HasType(Base::CYLINDER_SHAPE))
+      {
+        const bool sphere = shape->HasType(Base::SPHERE_SHAPE);
+        double radius = 0;
+        double length = 0;
+        if (sphere)
+        {
+          radius = boost::static_pointer_cast<SphereShape>(shape)->GetRadius();
+        }
+        else
+        {
+          auto cylinder = boost::static_pointer_cast<CylinderShape>(shape);
+          radius = cylinder->GetRadius();
+          length = cylinder->GetLength();
+        }
+
+        // Rings of vertices from the bottom to the top, plus both poles
+        const int segments = 16;
+        const int rings = sphere ? 7 : 2;
+        vertices.push_back(pose.CoordPositionAdd(ignition::math::Vector3d(
+            0, 0, sphere ? -radius : -length * 0.5)));
+        for (int r = 0; r < rings; ++r)
+        {
+          double z = length * (r - 0.5);
+          double ringRadius = radius;
+          if (sphere)
+          {
+            const double lat = IGN_PI * ((r + 1.0) / (rings + 1.0) - 0.5);
+            z = radius * std::sin(lat);
+            ringRadius = radius * std::cos(lat);
+          }
+          for (int s = 0; s < segments; ++s)
+          {
+            const double lon = 2 * IGN_PI * s / segments;
+            vertices.push_back(pose.CoordPositionAdd(ignition::math::Vector3d(
+                ringRadius * std::cos(lon), ringRadius * std::sin(lon), z)));
+          }
+        }
+        vertices.push_back(pose.CoordPositionAdd(ignition::math::Vector3d(
+            0, 0, sphere ? radius : length * 0.5)));
+
+        const unsigned int bottom = first;
+        const unsigned int top = first + 1 + rings * segments;
+        for (int s = 0; s < segments; ++s)
+        {
+          const unsigned int s1 = (s + 1) % segments;
+          AddConvexTriangle(center, bottom, first + 1 + s, first + 1 + s1,
+              _body);
+          for (int r = 0; r + 1 < rings; ++r)
+          {
+            const unsigned int lo = first + 1 + r * segments;
+            const unsigned int hi = lo + segments;
+            AddConvexTriangle(center, lo + s, lo + s1, hi + s1, _body);
+            AddConvexTriangle(center, lo + s, hi + s1, hi + s, _body);
+          }
+          const unsigned int last = first + 1 + (rings - 1) * segments;
+          AddConvexTriangle(center, top, last + s, last + s1, _body);
+        }
+
+        // The faceted mesh is inside the shape, scale it to the exact
+        // volume: uniformly for a sphere, radially for a cylinder.
+        double meshVolume = 0;
+        for (unsigned int j = firstIndex; j < _body.indices.size(); j += 3)
+        {
+          meshVolume += (vertices[_body.indices[j]] - center).Dot(
+              (vertices[_body.indices[j + 1]] - center).Cross(
+              vertices[_body.indices[j + 2]] - center)) / 6.0;
+        }
+        const double volume = sphere ?
+            4.0 / 3.0 * IGN_PI * radius * radius * radius :
+            IGN_PI * radius * radius * length;
+        if (meshVolume > 0)
+        {
+          const double ratio = volume / meshVolume;
+          const ignition::math::Vector3d axis =
+              pose.Rot().RotateVector(ignition::math::Vector3d::UnitZ);
+          for (unsigned int j = first; j < vertices.size(); ++j)
+          {
+            const ignition::math::Vector3d d = vertices[j] - center;
+            if (sphere)
+            {
+              vertices[j] = center + d * std::cbrt(ratio);
+            }
+            else
+            {
+              const ignition::math::Vector3d along = axis * d.Dot(axis);
+              vertices[j] = center + along + (d - along) * std::sqrt(ratio);
+            }
+          }
+        }
+        return true;
+      }
+
+      if (shape->HasType(Base::MESH_SHAPE))
+      {
+        auto meshShape = boost::static_pointer_cast<MeshShape>(shape);
+        const std::string uri = meshShape->GetMeshURI();
+        common::MeshManager *meshManager = common::MeshManager::Instance();
+        const common::Mesh *mesh = meshManager->GetMesh(uri);
+        if (!mesh)
+          mesh = meshManager->Load(common::find_file(uri));
+        if (!mesh)
+          return false;
+
+        const ignition::math::Vector3d scale = meshShape->Size();
+        for (unsigned int i = 0; i < mesh->GetSubMeshCount(); ++i)
+        {
+          const common::SubMesh *subMesh = mesh->GetSubMesh(i);
+          if (subMesh->GetPrimitiveType() != common::SubMesh::TRIANGLES)
+            continue;
+
+          const unsigned int offset = vertices.size();
+          for (unsigned int v = 0; v < subMesh->GetVertexCount(); ++v)
+          {
+            vertices.push_back(
+                pose.CoordPositionAdd(subMesh->Vertex(v) * scale));
+          }
+          const unsigned int count = subMesh->GetIndexCount() / 3 * 3;
+          for (unsigned int j = 0; j < count; ++j)
+            _body.indices.push_back(offset + subMesh->GetIndex(j));
+        }
+        if (_body.indices.size() == firstIndex)
+          return false;
+
+        // Meshes may be wound either way, orient them outwards
+        double volume = 0;
+        for (unsigned int j = firstIndex; j < _body.indices.size(); j += 3)
+        {
+          volume += vertices[_body.indices[j]].Dot(
+              vertices[_body.indices[j + 1]].Cross(
+              vertices[_body.indices[j + 2]]));
+        }
+        if (volume < 0)
+        {
+          for (unsigned int j = firstIndex; j < _body.indices.size(); j += 3)
+            std::swap(_body.indices[j + 1], _body.indices[j + 2]);
+        }
+        return true;
+      }
+
+      return false;
+    }
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+Hydrostatics::Hydrostatics(WorldPtr _world)
+  : dataPtr(new HydrostaticsPrivate)
+{
+  this->dataPtr->world = _world;
+
+  // Only this world's updates, worlds may be stepped in parallel
+  this->dataPtr->updateConnection = _world->ConnectWorldUpdateBegin(
+      std::bind(&Hydrostatics::Update, this, std::placeholders::_1));
+}
+
+//////////////////////////////////////////////////
+Hydrostatics::~Hydrostatics()
+{
+  this->dataPtr->updateConnection.reset();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<Hydrostatics> Hydrostatics::ForWorld(WorldPtr _world)
+{
+  std::lock_guard<std::mutex> lock(gInstancesMutex);
+  auto &weak = gInstances[_world->Name()];
+  std::shared_ptr<Hydrostatics> instance = weak.lock();
+  if (!instance)
+  {
+    instance.reset(new Hydrostatics(_world));
+    weak = instance;
+  }
+  return instance;
+}
+
+//////////////////////////////////////////////////
+bool Hydrostatics::AddLink(LinkPtr _link, const double _fluidDensity)
+{
+  HydrostaticsBody body;
+  body.link = _link;
+  body.fluidDensity = _fluidDensity;
+  for (auto const &collision : _link->GetCollisions())
+  {
+    if (!AppendCollision(collision, body))
+    {
+      gzwarn << "Collision [" << collision->GetScopedName()
+             << "] is not a closed shape, it is ignored by hydrostatics"
+             << std::endl;
+    }
+  }
+
+  if (body.indices.empty())
+    return false;
+
+  // Volume and centroid of the whole mesh, used when fully submerged
+  body.volume = ClipVolume(body.localVertices, body.indices,
+      ignition::math::Vector3d(0, 0, 1e9), ignition::math::Vector3d::UnitZ,
+      body.centroid);
+  for (auto const &v : body.localVertices)
+    body.radius = std::max(body.radius, v.Length());
+  body.worldVertices.resize(body.localVertices.size());
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Remove(_link);
+  this->dataPtr->bodies.push_back(std::move(body));
+  return true;
+}
+
+//////////////////////////////////////////////////
+void Hydrostatics::RemoveLink(LinkPtr _link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->Remove(_link);
+}
+
+//////////////////////////////////////////////////
+void HydrostaticsPrivate::Remove(const LinkPtr &_link)
+{
+  auto iter = std::find_if(this->bodies.begin(), this->bodies.end(),
+      [&_link](const HydrostaticsBody &_body)
+      {
+        return _body.link == _link;
+      });
+  if (iter == this->bodies.end())
+    return;
+
+  // Order does not matter, swap with the last body
+  if (iter != this->bodies.end() - 1)
+    *iter = std::move(this->bodies.back());
+  this->bodies.pop_back();
+}
+
+//////////////////////////////////////////////////
+size_t Hydrostatics::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->bodies.size();
+}
+
+//////////////////////////////////////////////////
+void Hydrostatics::SetWaterLevel(const double _level)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->level = _level;
+}
+
+//////////////////////////////////////////////////
+double Hydrostatics::WaterLevel() const
+{
+  return this->dataPtr->level;
+}
+
+//////////////////////////////////////////////////
+void Hydrostatics::SetWave(const double _amplitude, const double _wavelength,
+    const double _period, const ignition::math::Vector2d &_direction)
+{
+  if (_amplitude > 0 && (!(_wavelength > 0) || !(_period > 0) ||
+      _direction.Length() <= 0))
+  {
+    gzerr << "Invalid wave, the wave length, period and direction must "
+          << "not be zero" << std::endl;
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->amplitude = std::max(0.0, _amplitude);
+  if (this->dataPtr->amplitude > 0)
+  {
+    this->dataPtr->waveNumber = 2 * IGN_PI / _wavelength;
+    this->dataPtr->frequency = 2 * IGN_PI / _period;
+    this->dataPtr->direction = _direction / _direction.Length();
+  }
+}
+
+//////////////////////////////////////////////////
+double HydrostaticsPrivate::Surface(const double _x, const double _y,
+    const double _time, double &_dx, double &_dy) const
+{
+  _dx = 0;
+  _dy = 0;
+  if (this->amplitude <= 0)
+    return this->level;
+
+  const double phase = this->waveNumber *
+      (this->direction.X() * _x + this->direction.Y() * _y) -
+      this->frequency * _time;
+  const double slope = -this->amplitude * this->waveNumber * std::sin(phase);
+  _dx = slope * this->direction.X();
+  _dy = slope * this->direction.Y();
+  return this->level + this->amplitude * std::cos(phase);
+}
+
+//////////////////////////////////////////////////
+double Hydrostatics::WaterHeight(const double _x, const double _y,
+    const double _time) const
+{
+  double dx, dy;
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->Surface(_x, _y, _time, dx, dy);
+}
+
+//////////////////////////////////////////////////
+double Hydrostatics::SubmergedVolume(const LinkPtr &_link,
+    ignition::math::Vector3d &_centroid) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (auto const &body : this->dataPtr->bodies)
+  {
+    if (body.link == _link)
+    {
+      _centroid = body.submergedCentroid;
+      return body.submergedVolume;
+    }
+  }
+  _centroid = ignition::math::Vector3d::Zero;
+  return 0;
+}
+
+//////////////////////////////////////////////////
+void HydrostaticsPrivate::Compute(HydrostaticsBody &_body,
+    const double _time) const
+{
+  // Tangent plane of the water surface below the link origin
+  const ignition::math::Vector3d &origin = _body.pose.Pos();
+  double dx, dy;
+  const ignition::math::Vector3d point(origin.X(), origin.Y(),
+      this->Surface(origin.X(), origin.Y(), _time, dx, dy));
+  const ignition::math::Vector3d normal =
+      ignition::math::Vector3d(-dx, -dy, 1).Normalize();
+
+  // Skip the clipping when the mesh is entirely on one side
+  const double height = normal.Dot(origin - point);
+  if (height >= _body.radius)
+  {
+    _body.submergedVolume = 0;
+    _body.submergedCentroid = point;
+    return;
+  }
+  if (height <= -_body.radius)
+  {
+    _body.submergedVolume = _body.volume;
+    _body.submergedCentroid = _body.pose.CoordPositionAdd(_body.centroid);
+    return;
+  }
+
+  for (size_t i = 0; i < _body.localVertices.size(); ++i)
+  {
+    _body.worldVertices[i] =
+        _body.pose.CoordPositionAdd(_body.localVertices[i]);
+  }
+
+  _body.submergedVolume = Hydrostatics::ClipVolume(_body.worldVertices,
+      _body.indices, point, normal, _body.submergedCentroid);
+}
+
+//////////////////////////////////////////////////
+void Hydrostatics::Update(const common::UpdateInfo &_info)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &bodies = this->dataPtr->bodies;
+  if (bodies.empty())
+    return;
+
+  for (auto &body : bodies)
+    body.pose = body.link->WorldPose();
+
+  const double time = _info.simTime.Double();
+  const HydrostaticsPrivate &data = *this->dataPtr;
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, bodies.size(), 4),
+      [&data, &bodies, time](const tbb::blocked_range<size_t> &_r)
+  {
+    for (size_t i = _r.begin(); i != _r.end(); ++i)
+      data.Compute(bodies[i], time);
+  });
+
+  // By Archimedes' principle, the buoyancy is the weight of the displaced
+  // water, applied at the centroid of the submerged volume.
+  const ignition::math::Vector3d gravity = this->dataPtr->world->Gravity();
+  for (auto &body : bodies)
+  {
+    if (body.submergedVolume <= 0)
+      continue;
+    body.link->AddForceAtWorldPosition(
+        -body.fluidDensity * body.submergedVolume * gravity,
+        body.submergedCentroid);
+  }
+}
+
+//////////////////////////////////////////////////
+double Hydrostatics::ClipVolume(
+    const std::vector<ignition::math::Vector3d> &_vertices,
+    const std::vector<unsigned int> &_indices,
+    const ignition::math::Vector3d &_point,
+    const ignition::math::Vector3d &_normal,
+    ignition::math::Vector3d &_centroid)
+{
+  // Signed height of every vertex above the water plane
+  std::vector<double> heights(_vertices.size());
+  for (size_t i = 0; i < _vertices.size(); ++i)
+    heights[i] = _normal.Dot(_vertices[i] - _point);
+
+  // The submerged volume is the sum of the tetrahedra joining the plane
+  // point to the submerged part of every triangle. The waterline cap lies
+  // in the plane, so its tetrahedra are flat and can be left out.
+  double volume6 = 0;
+  ignition::math::Vector3d moment;
+  auto addTriangle = [&](const ignition::math::Vector3d &_a,
+      const ignition::math::Vector3d &_b, const ignition::math::Vector3d &_c)
+  {
+    const ignition::math::Vector3d a = _a - _point;
+    const ignition::math::Vector3d b = _b - _point;
+    const ignition::math::Vector3d c = _c - _point;
+    const double v = a.Dot(b.Cross(c));
+    volume6 += v;
+    moment += v * (a + b + c);
+  };
+
+  for (size_t t = 0; t + 2 < _indices.size(); t += 3)
+  {
+    unsigned int idx[3] = {_indices[t], _indices[t + 1], _indices[t + 2]};
+    int below = 0;
+    for (int k = 0; k < 3; ++k)
+      below += heights[idx[k]] < 0;
+
+    if (below == 0)
+      continue;
+    if (below == 3)
+    {
+      addTriangle(_vertices[idx[0]], _vertices[idx[1]], _vertices[idx[2]]);
+      continue;
+    }
+
+    // Rotate the triangle, keeping its winding, so that the first vertex
+    // is the only one on its side of the plane
+    const bool firstBelow = below == 1;
+    while ((heights[idx[0]] < 0) != firstBelow ||
+           (heights[idx[1]] < 0) == firstBelow)
+    {
+      std::rotate(idx, idx + 1, idx + 3);
+    }
+    const ignition::math::Vector3d &a = _vertices[idx[0]];
+    const ignition::math::Vector3d &b = _vertices[idx[1]];
+    const ignition::math::Vector3d &c = _vertices[idx[2]];
+    const double ha = heights[idx[0]];
+    const ignition::math::Vector3d ab =
+        a + (b - a) * (ha / (ha - heights[idx[1]]));
+    const ignition::math::Vector3d ac =
+        a + (c - a) * (ha / (ha - heights[idx[2]]));
+
+    if (firstBelow)
+    {
+      addTriangle(a, ab, ac);
+    }
+    else
+    {
+      addTriangle(ab, b, c);
+      addTriangle(ab, c, ac);
+    }
+  }
+
+  if (volume6 <= 0)
+  {
+    _centroid = _point;
+    return 0;
+  }
+
+  _centroid = _point + moment / (4 * volume6);
+  return volume6 / 6;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_HYDROSTATICS_HH_
+#define GAZEBO_PHYSICS_HYDROSTATICS_HH_
+
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/common/UpdateInfo.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class HydrostaticsPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class Hydrostatics Hydrostatics.hh physics/physics.hh
+    /// \brief Buoyancy of partially submerged links.
+    ///
+    /// The collision shapes of every added link are turned into a closed
+    /// triangle mesh once, in the link frame. At every world update, the
+    /// meshes of all the links are clipped against the water surface in
+    /// parallel, which gives the submerged volume and its centroid, and
+    /// the buoyancy force is applied at the centroid.
+    ///
+    /// The water surface is a plane at the water level plus an optional
+    /// sinusoidal wave. Around each link, the surface is approximated by
+    /// its tangent plane below the link origin, which is accurate when
+    /// the wave length is large compared to the link.
+    ///
+    /// There is one instance per world, shared by all its users, see
+    /// ForWorld.
+    class GZ_PHYSICS_VISIBLE Hydrostatics
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World of the links.
+      public: explicit Hydrostatics(WorldPtr _world);
+
+      /// \brief Destructor.
+      public: virtual ~Hydrostatics();
+
+      /// \brief Get the instance of a world, created if needed. It is
+      /// deleted when the last user releases it.
+      /// \param[in] _world The world.
+      /// \return The instance of the world.
+      public: static std::shared_ptr<Hydrostatics> ForWorld(WorldPtr _world);
+
+      /// \brief Apply buoyancy to a link.
+      /// \param[in] _link The link.
+      /// \param[in] _fluidDensity Density of the water in kg/m^3.
+      /// \return False if the link has no closed collision shape, i.e. no
+      /// box, sphere, cylinder or mesh.
+      public: bool AddLink(LinkPtr _link, const double _fluidDensity);
+
+      /// \brief Stop applying buoyancy to a link.
+      /// \param[in] _link The link.
+      public: void RemoveLink(LinkPtr _link);
+
+      /// \brief Number of links with buoyancy.
+      /// \return Number of links.
+      public: size_t LinkCount() const;
+
+      /// \brief Set the height of the calm water surface.
+      /// \param[in] _level Water level along z, in meters.
+      public: void SetWaterLevel(const double _level);
+
+      /// \brief Get the height of the calm water surface.
+      /// \return Water level along z, in meters.
+      public: double WaterLevel() const;
+
+      /// \brief Set a sinusoidal wave on the water surface.
+      /// \param[in] _amplitude Wave amplitude in meters, 0 for calm water.
+      /// \param[in] _wavelength Wave length in meters.
+      /// \param[in] _period Wave period in seconds.
+      /// \param[in] _direction Direction of propagation in the xy plane.
+      public: void SetWave(const double _amplitude, const double _wavelength,
+                  const double _period,
+                  const ignition::math::Vector2d &_direction);
+
+      /// \brief Height of the water surface.
+      /// \param[in] _x World x coordinate.
+      /// \param[in] _y World y coordinate.
+      /// \param[in] _time Simulation time in seconds.
+      /// \return Height of the water along z.
+      public: double WaterHeight(const double _x, const double _y,
+                  const double _time) const;
+
+      /// \brief Submerged volume of a link at the last update.
+      /// \param[in] _link The link.
+      /// \param[out] _centroid World position of the submerged centroid.
+      /// \return Submerged volume in m^3, 0 if the link is not added or
+      /// out of the water.
+      public: double SubmergedVolume(const LinkPtr &_link,
+                  ignition::math::Vector3d &_centroid) const;
+
+      /// \brief Compute the submerged buoyancy of all the links and apply
+      /// it. Called at the beginning of every world update.
+      /// \param[in] _info World update information.
+      public: void Update(const common::UpdateInfo &_info);
+
+      /// \brief Volume of a closed triangle mesh below a plane.
+      /// \param[in] _vertices Vertices of the mesh.
+      /// \param[in] _indices Three vertex indices per triangle, counter
+      /// clockwise seen from outside of the mesh.
+      /// \param[in] _point A point of the plane.
+      /// \param[in] _normal Normal of the plane, pointing out of the water.
+      /// \param[out] _centroid Centroid of the submerged volume, set to
+      /// _point if nothing is submerged.
+      /// \return Submerged volume.
+      public: static double ClipVolume(
+                  const std::vector<ignition::math::Vector3d> &_vertices,
+                  const std::vector<unsigned int> &_indices,
+                  const ignition::math::Vector3d &_point,
+                  const ignition::math::Vector3d &_normal,
+                  ignition::math::Vector3d &_centroid);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<HydrostaticsPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "gazebo/physics/Hydrostatics.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+class HydrostaticsTest : public gazebo::testing::AutoLogFixture
+{
+  /// \brief Build a box mesh centered on the origin.
+  /// \param[in] _size Size of the box.
+  protected: void Box(const ignition::math::Vector3d &_size)
+  {
+    this->vertices.clear();
+    this->indices.clear();
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+      this->vertices.push_back(ignition::math::Vector3d(
+          (i & 1) ? _size.X() * 0.5 : -_size.X() * 0.5,
+          (i & 2) ? _size.Y() * 0.5 : -_size.Y() * 0.5,
+          (i & 4) ? _size.Z() * 0.5 : -_size.Z() * 0.5));
+    }
+    // Counter clockwise seen from outside
+    this->indices = {
+      0, 2, 3,  0, 3, 1,  4, 5, 7,  4, 7, 6,
+      0, 1, 5,  0, 5, 4,  2, 6, 7,  2, 7, 3,
+      0, 4, 6,  0, 6, 2,  1, 3, 7,  1, 7, 5};
+  }
+
+  /// \brief Mesh vertices.
+  protected: std::vector<ignition::math::Vector3d> vertices;
+
+  /// \brief Mesh triangles.
+  protected: std::vector<unsigned int> indices;
+};
+
+/////////////////////////////////////////////////
+TEST_F(HydrostaticsTest, ClipVolume)
+{
+  this->Box(ignition::math::Vector3d(1, 2, 1));
+  const ignition::math::Vector3d up = ignition::math::Vector3d::UnitZ;
+  ignition::math::Vector3d centroid;
+
+  // Out of the water
+  EXPECT_DOUBLE_EQ(Hydrostatics::ClipVolume(this->vertices, this->indices,
+      ignition::math::Vector3d(0, 0, -1), up, centroid), 0.0);
+
+  // Partially submerged, the centroid is halfway down the submerged part
+  EXPECT_NEAR(Hydrostatics::ClipVolume(this->vertices, this->indices,
+      ignition::math::Vector3d(0, 0, -0.25), up, centroid), 0.5, 1e-9);
+  EXPECT_NEAR(centroid.Z(), -0.375, 1e-9);
+
+  EXPECT_NEAR(Hydrostatics::ClipVolume(this->vertices, this->indices,
+      ignition::math::Vector3d(0, 0, 0.3), up, centroid), 1.6, 1e-9);
+  EXPECT_NEAR(centroid.Z(), -0.1, 1e-9);
+
+  // Fully submerged
+  EXPECT_NEAR(Hydrostatics::ClipVolume(this->vertices, this->indices,
+      ignition::math::Vector3d(0, 0, 1), up, centroid), 2.0, 1e-9);
+  EXPECT_NEAR(centroid.Length(), 0.0, 1e-9);
+
+  // Tilted water plane through the center cuts the box in half, the
+  // submerged part is a prism with a triangular section
+  const ignition::math::Vector3d tilted =
+      ignition::math::Vector3d(1, 0, 1).Normalize();
+  EXPECT_NEAR(Hydrostatics::ClipVolume(this->vertices, this->indices,
+      ignition::math::Vector3d::Zero, tilted, centroid), 1.0, 1e-9);
+  EXPECT_NEAR(centroid.X(), -1.0 / 6.0, 1e-9);
+  EXPECT_NEAR(centroid.Y(), 0.0, 1e-9);
+  EXPECT_NEAR(centroid.Z(), -1.0 / 6.0, 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST_F(HydrostaticsTest, WaterHeight)
+{
+  Hydrostatics hydrostatics((WorldPtr()));
+  EXPECT_EQ(hydrostatics.LinkCount(), 0u);
+  EXPECT_DOUBLE_EQ(hydrostatics.WaterHeight(3, 4, 5), 0.0);
+
+  hydrostatics.SetWaterLevel(1.5);
+  EXPECT_DOUBLE_EQ(hydrostatics.WaterLevel(), 1.5);
+  EXPECT_DOUBLE_EQ(hydrostatics.WaterHeight(3, 4, 5), 1.5);
+
+  // Crest at the origin at time 0, trough half a wave length further
+  hydrostatics.SetWave(0.5, 10, 4, ignition::math::Vector2d(0, 2));
+  EXPECT_NEAR(hydrostatics.WaterHeight(0, 0, 0), 2.0, 1e-9);
+  EXPECT_NEAR(hydrostatics.WaterHeight(7, 5, 0), 1.0, 1e-9);
+
+  // The wave travels along the direction, a period later it is back
+  EXPECT_NEAR(hydrostatics.WaterHeight(0, 2.5, 1), 2.0, 1e-9);
+  EXPECT_NEAR(hydrostatics.WaterHeight(0, 0, 4), 2.0, 1e-9);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -16,6 +16,7 @@
 */
 
 #include <boost/algorithm/string.hpp>
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <sstream>
@@ -38,9 +39,11 @@
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/ContactManager.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/SleepManager.hh"
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/WrenchQueue.hh"
 
 #include "gazebo/util/IntrospectionManager.hh"
 #include "gazebo/util/OpenAL.hh"
@@ -55,6 +58,10 @@ class gazebo::physics::LinkPrivate
   /// \brief This flag is used to trigger the enabled
   public: bool enabled = false;
 
+  /// \brief True if the link sleeps. It can be set from the threads of
+  /// the physics engine.
+  public: std::atomic<bool> sleeping{false};
+
   /// \brief Names of all the sensors attached to the link.
   public: std::vector<std::string> sensors;
 
@@ -88,17 +95,15 @@ class gazebo::physics::LinkPrivate
   /// \brief Wrench subscriber.
   public: transport::SubscriberPtr wrenchSub;
 
-  /// \brief Vector of wrench messages to be processed.
-  public: std::vector<msgs::Wrench> wrenchMsgs;
-
-  /// \brief Mutex to protect the wrenchMsgs variable.
-  public: std::mutex wrenchMsgMutex;
+  /// \brief Wrenches to apply at the next update, created with the wrench
+  /// subscriber when the link becomes non static.
+  public: std::unique_ptr<WrenchQueue> wrenchQueue;
 
   /// \brief Wind velocity.
   public: ignition::math::Vector3d windLinearVel;
 
-  /// \brief Update connection to calculate wind velocity.
-  public: event::ConnectionPtr updateConnection;
+  /// \brief True if the link is added to the world wind.
+  public: bool windSubscribed = false;
 
   /// \brief All the attached batteries.
   public: std::vector<common::BatteryPtr> batteries;
@@ -295,7 +300,7 @@ void Link::Load(sdf::ElementPtr _sdf)
   this->sdf->GetElement("enable_wind")->GetValue()->SetUpdateFunc(
       std::bind(&Link::WindMode, this));
 
-  this->connections.push_back(event::Events::ConnectWorldUpdateBegin(
+  this->connections.push_back(this->world->ConnectWorldUpdateBegin(
       std::bind(
       static_cast<void(Link::*)(const common::UpdateInfo &)>(&Link::Update),
       this, std::placeholders::_1)));
@@ -344,7 +349,14 @@ void Link::Init()
 //////////////////////////////////////////////////
 void Link::Fini()
 {
-  this->dataPtr->updateConnection.reset();
+  if (this->dataPtr->windSubscribed)
+    this->SetWindEnabled(false);
+
+  if (this->world && this->world->Physics() &&
+      this->world->Physics()->GetSleepManager())
+  {
+    this->world->Physics()->GetSleepManager()->RemoveLink(this);
+  }
 
   this->dataPtr->attachedModels.clear();
   this->dataPtr->parentJoints.clear();
@@ -610,18 +622,16 @@ void Link::Update(const common::UpdateInfo & /*_info*/)
      this->dataPtr->enabledSignal(this->dataPtr->enabled);
    }*/
 
-  if (!this->IsStatic() && !this->dataPtr->wrenchMsgs.empty())
+  if (!this->IsStatic() && this->dataPtr->wrenchQueue)
   {
-    std::vector<msgs::Wrench> messages;
-    {
-      std::lock_guard<std::mutex> lock(this->dataPtr->wrenchMsgMutex);
-      messages = this->dataPtr->wrenchMsgs;
-      this->dataPtr->wrenchMsgs.clear();
-    }
-
-    for (auto it : messages)
+    // All the wrenches queued since the last update, summed
+    ignition::math::Vector3d force;
+    ignition::math::Vector3d torque;
+    if (this->dataPtr->wrenchQueue->Drain(force, torque) > 0)
     {
-      this->ProcessWrenchMsg(it);
+      this->WakeUp();
+      this->AddLinkForce(force);
+      this->AddRelativeTorque(torque);
     }
   }
 
@@ -635,7 +645,7 @@ void Link::Update(const common::UpdateInfo & /*_info*/)
 //////////////////////////////////////////////////
 void Link::UpdateWind(const common::UpdateInfo & /*_info*/)
 {
-  this->dataPtr->windLinearVel = this->world->Wind().WorldLinearVel(this);
+  this->SetWorldWindLinearVel(this->world->Wind().WorldLinearVel(this));
 }
 
 /////////////////////////////////////////////////
@@ -842,26 +852,36 @@ void Link::SetWindMode(const bool _mode)
 {
   this->sdf->GetElement("enable_wind")->Set(_mode);
 
-  if (!this->WindMode() && this->dataPtr->updateConnection)
+  if (!this->WindMode() && this->dataPtr->windSubscribed)
     this->SetWindEnabled(false);
-  else if (this->WindMode() && !this->dataPtr->updateConnection)
+  else if (this->WindMode() && !this->dataPtr->windSubscribed)
     this->SetWindEnabled(true);
 }
 
 /////////////////////////////////////////////////
 void Link::SetWindEnabled(const bool _enable)
 {
+  if (_enable == this->dataPtr->windSubscribed || !this->world)
+    return;
+
+  // The world wind computes the velocity of all its links in one batch
   if (_enable)
   {
-    this->dataPtr->updateConnection = event::Events::ConnectWorldUpdateBegin(
-        std::bind(&Link::UpdateWind, this, std::placeholders::_1));
+    this->world->Wind().AddLink(this);
   }
   else
   {
-    this->dataPtr->updateConnection.reset();
+    this->world->Wind().RemoveLink(this);
     // Make sure wind velocity is null
     this->dataPtr->windLinearVel.Set(0, 0, 0);
   }
+  this->dataPtr->windSubscribed = _enable;
+}
+
+//////////////////////////////////////////////////
+void Link::SetWorldWindLinearVel(const ignition::math::Vector3d &_vel)
+{
+  this->dataPtr->windLinearVel = _vel;
 }
 
 //////////////////////////////////////////////////
@@ -1237,7 +1257,7 @@ void Link::SetPublishData(bool _enable)
     std::string topic = "~/" + this->GetScopedName();
     this->dataPtr->dataPub = this->node->Advertise<msgs::LinkData>(topic);
     this->connections.push_back(
-      event::Events::ConnectWorldUpdateEnd(
+      this->world->ConnectWorldUpdateEnd(
         std::bind(&Link::PublishData, this)));
   }
   else
@@ -1775,6 +1795,9 @@ void Link::SetStatic(const bool &_static)
 {
   if (!_static && !this->dataPtr->wrenchSub)
   {
+    if (!this->dataPtr->wrenchQueue)
+      this->dataPtr->wrenchQueue.reset(new WrenchQueue());
+
     std::string topicName = "~/" + this->GetScopedName() + "/wrench";
     boost::replace_all(topicName, "::", "/");
     this->dataPtr->wrenchSub =
@@ -1791,40 +1814,27 @@ void Link::SetStatic(const bool &_static)
 //////////////////////////////////////////////////
 void Link::OnWrenchMsg(ConstWrenchPtr &_msg)
 {
-  // Sanity check
-  if (this->IsStatic())
-  {
-    gzerr << "Link [" << this->GetName() <<
-        "] received a wrench message, but it is static." << std::endl;
-    return;
-  }
+  LinkWrench wrench;
+  wrench.force = msgs::ConvertIgn(_msg->force());
+  wrench.torque = msgs::ConvertIgn(_msg->torque());
+  if (_msg->has_force_offset())
+    wrench.forceOffset = msgs::ConvertIgn(_msg->force_offset());
 
-  std::lock_guard<std::mutex> lock(this->dataPtr->wrenchMsgMutex);
-  this->dataPtr->wrenchMsgs.push_back(*_msg);
+  this->QueueWrench(wrench);
 }
 
 //////////////////////////////////////////////////
-void Link::ProcessWrenchMsg(const msgs::Wrench &_msg)
+void Link::QueueWrench(const LinkWrench &_wrench)
 {
   // Sanity check
-  if (this->IsStatic())
+  if (this->IsStatic() || !this->dataPtr->wrenchQueue)
   {
     gzerr << "Link [" << this->GetName() <<
-        "] received a wrench message, but it is static." << std::endl;
+        "] received a wrench, but it is static." << std::endl;
     return;
   }
 
-  ignition::math::Vector3d pos;
-  if (_msg.has_force_offset())
-  {
-    pos = msgs::ConvertIgn(_msg.force_offset());
-  }
-
-  const ignition::math::Vector3d force = msgs::ConvertIgn(_msg.force());
-  this->AddLinkForce(force, pos);
-
-  const ignition::math::Vector3d torque = msgs::ConvertIgn(_msg.torque());
-  this->AddRelativeTorque(torque);
+  this->dataPtr->wrenchQueue->Push(_wrench);
 }
 
 //////////////////////////////////////////////////
@@ -1911,6 +1921,29 @@ ignition::math::Vector3d Link::WorldLinearVel() const
   return this->WorldLinearVel(ignition::math::Vector3d::Zero);
 }
 
+/////////////////////////////////////////////////
+bool Link::Sleeping() const
+{
+  return this->dataPtr->sleeping;
+}
+
+/////////////////////////////////////////////////
+bool Link::SetSleeping(const bool _sleeping) const
+{
+  return this->dataPtr->sleeping.exchange(_sleeping) != _sleeping;
+}
+
+/////////////////////////////////////////////////
+void Link::WakeUp()
+{
+  if (!this->Sleeping() || !this->world || !this->world->Physics())
+    return;
+
+  SleepManager *sleepManager = this->world->Physics()->GetSleepManager();
+  if (sleepManager)
+    sleepManager->Wake(this);
+}
+
 /////////////////////////////////////////////////
 event::ConnectionPtr Link::ConnectEnabled(
     std::function<void (bool)> _subscriber)
@@ -41,6 +41,7 @@ namespace gazebo
     class Collision;
     class Battery;
     class LinkPrivate;
+    class LinkWrench;
 
     /// \addtogroup gazebo_physics
     /// \{
@@ -217,6 +218,14 @@ namespace gazebo
       public: virtual void AddRelativeTorque(
                   const ignition::math::Vector3d &_torque) = 0;
 
+      /// \brief Queue a wrench to apply at the next update. All the wrenches
+      /// queued during a step are summed and applied once. Unlike the Add
+      /// functions, it can be called from any thread without locking, which
+      /// makes it suited to controllers sending commands at high rates.
+      /// \param[in] _wrench Force, torque and force offset in the link
+      /// frame.
+      public: void QueueWrench(const LinkWrench &_wrench);
+
       /// \brief Get the pose of the body's center of gravity in the world
       ///        coordinate frame.
       /// \return Pose of the body's center of gravity in the world coordinate
@@ -407,6 +416,12 @@ namespace gazebo
       /// bounds.
       public: std::string GetSensorName(unsigned int _index) const;
 
+      /// \brief Get whether the link sleeps. Sleeping links are at rest,
+      /// and are skipped by the world until they are touched or pushed.
+      /// \return True if the link sleeps.
+      /// \sa SleepManager
+      public: bool Sleeping() const;
+
       /// \brief Connect to the add entity signal
       /// \param[in] _subscriber Subsciber callback function.
       /// \return Pointer to the connection, which must be kept in scope.
@@ -566,13 +581,21 @@ namespace gazebo
       /// \return this link's wind velocity.
       public: const ignition::math::Vector3d WorldWindLinearVel() const;
 
+      /// \brief Set this link's wind velocity in the world coordinate
+      /// frame. Called by the world wind at every update.
+      /// \param[in] _vel Wind velocity.
+      public: void SetWorldWindLinearVel(const ignition::math::Vector3d &_vel);
+
       /// \brief Returns this link's wind velocity.
       /// \return this link's wind velocity.
       public: const ignition::math::Vector3d RelativeWindLinearVel() const;
 
       /// \brief Update the wind.
       /// \param[in] _info Update information.
-      public: void UpdateWind(const common::UpdateInfo &_info);
+      /// \deprecated The world wind sets the velocity of every link at each
+      /// update, see SetWorldWindLinearVel.
+      public: void UpdateWind(const common::UpdateInfo &_info)
+          GAZEBO_DEPRECATED(11.0);
 
       /// \brief Get a battery by name.
       /// \param[in] _name Name of the battery to get.
@@ -664,10 +687,6 @@ namespace gazebo
       /// \param[in] _msg The wrench message.
       private: void OnWrenchMsg(ConstWrenchPtr &_msg);
 
-      /// \brief Process the message and add force and torque.
-      /// \param[in] _msg The message to set the wrench from.
-      private: void ProcessWrenchMsg(const msgs::Wrench &_msg);
-
       /// \brief Load a battery.
       /// \param[in] _sdf SDF parameter.
       private: void LoadBattery(const sdf::ElementPtr _sdf);
@@ -675,6 +694,19 @@ namespace gazebo
       /// \brief Register items in the introspection service.
       protected: virtual void RegisterIntrospectionItems() override;
 
+      /// \brief Wake up the link and its island if it sleeps. Called when
+      /// a force or a torque is applied to the link.
+      /// \sa SleepManager::Wake
+      protected: void WakeUp();
+
+      /// \brief Set whether the link sleeps. Called by the sleep manager.
+      /// \param[in] _sleeping True if the link sleeps.
+      /// \return True if the state changed.
+      private: bool SetSleeping(const bool _sleeping) const;
+
+      /// \brief The sleep manager sets the sleeping state.
+      private: friend class SleepManager;
+
       /// \brief Inertial properties.
       protected: InertialPtr inertial;
 
@@ -329,9 +329,14 @@ void Model::Update()
 
   boost::recursive_mutex::scoped_lock lock(this->updateMutex);
 
-  for (Joint_V::iterator jiter = this->joints.begin();
-       jiter != this->joints.end(); ++jiter)
-    (*jiter)->Update();
+  // The joints of a sleeping model do not move, so their update signals
+  // are skipped until the model wakes up.
+  if (!this->Sleeping())
+  {
+    for (Joint_V::iterator jiter = this->joints.begin();
+         jiter != this->joints.end(); ++jiter)
+      (*jiter)->Update();
+  }
 
   if (this->jointController)
     this->jointController->Update();
@@ -1454,6 +1459,26 @@ bool Model::GetAutoDisable() const
   return this->sdf->Get<bool>("allow_auto_disable");
 }
 
+/////////////////////////////////////////////////
+bool Model::Sleeping() const
+{
+  if (this->links.empty() && this->models.empty())
+    return false;
+
+  for (const auto &link : this->links)
+  {
+    if (!link->Sleeping())
+      return false;
+  }
+
+  for (const auto &model : this->models)
+  {
+    if (!model->Sleeping())
+      return false;
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////
 void Model::SetSelfCollide(bool _self_collide)
 {
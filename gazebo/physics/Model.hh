@@ -344,6 +344,12 @@ namespace gazebo
       /// \return True if auto disable is allowed for this model.
       public: bool GetAutoDisable() const;
 
+      /// \brief Get whether all the links of the model, and of its nested
+      /// models, sleep.
+      /// \return True if the model sleeps.
+      /// \sa SleepManager
+      public: bool Sleeping() const;
+
       /// \brief Load all plugins
       ///
       /// Load all plugins specified in the SDF for the model.
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/ModelIndex.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/////////////////////////////////////////////////
+/// \brief Check that a box is not empty and has a finite size.
+static bool Bounded(const ignition::math::AxisAlignedBox &_box)
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (!std::isfinite(_box.Min()[i]) || !std::isfinite(_box.Max()[i]) ||
+        _box.Min()[i] > _box.Max()[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+ModelIndex::ModelIndex(const double _cellSize)
+  : cellSize(_cellSize > 0 ? _cellSize : 4.0)
+{
+}
+
+//////////////////////////////////////////////////
+void ModelIndex::SetStale()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stale = true;
+  this->dirtyModels.clear();
+}
+
+//////////////////////////////////////////////////
+void ModelIndex::MarkDirty(const std::set<ModelPtr> &_models)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->stale)
+    return;
+
+  this->dirtyModels.insert(this->dirtyModels.end(), _models.begin(),
+      _models.end());
+}
+
+//////////////////////////////////////////////////
+size_t ModelIndex::ModelCount() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->entries.size();
+}
+
+//////////////////////////////////////////////////
+void ModelIndex::Rebuild(const Model_V &_models)
+{
+  this->entries.clear();
+  this->lookup.clear();
+  this->cells.clear();
+  this->large.clear();
+  this->dirtyModels.clear();
+
+  for (auto const &model : _models)
+    this->Add(model);
+
+  for (size_t i = 0; i < this->entries.size(); ++i)
+    this->Update(i);
+
+  this->stale = false;
+}
+
+//////////////////////////////////////////////////
+void ModelIndex::Add(const ModelPtr &_model)
+{
+  if (!_model)
+    return;
+
+  Entry entry;
+  entry.model = _model;
+  entry.binned = false;
+  entry.indexed = false;
+  this->lookup[_model.get()] = this->entries.size();
+  this->entries.push_back(entry);
+
+  // Pre-order, so that the entries follow the order of a recursive
+  // traversal of the model tree.
+  for (auto const &nested : _model->NestedModels())
+    this->Add(nested);
+}
+
+//////////////////////////////////////////////////
+void ModelIndex::Unbin(const size_t _index)
+{
+  Entry &entry = this->entries[_index];
+  std::vector<size_t> &list = entry.binned ?
+      this->cells[entry.cell] : this->large;
+
+  auto iter = std::find(list.begin(), list.end(), _index);
+  if (iter != list.end())
+  {
+    *iter = list.back();
+    list.pop_back();
+  }
+
+  if (entry.binned && list.empty())
+    this->cells.erase(entry.cell);
+}
+
+//////////////////////////////////////////////////
+void ModelIndex::Update(const size_t _index)
+{
+  Entry &entry = this->entries[_index];
+  entry.box = entry.model->BoundingBox();
+
+  bool binned = Bounded(entry.box);
+  for (unsigned int i = 0; binned && i < 3; ++i)
+    binned = entry.box.Max()[i] - entry.box.Min()[i] <= this->cellSize;
+
+  Cell cell = {{0, 0, 0}};
+  if (binned)
+  {
+    const ignition::math::Vector3d center = entry.box.Center();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      cell[i] = static_cast<int64_t>(
+          std::floor(center[i] / this->cellSize));
+    }
+  }
+
+  if (entry.indexed)
+  {
+    if (binned && entry.binned && cell == entry.cell)
+      return;
+    this->Unbin(_index);
+  }
+
+  entry.binned = binned;
+  entry.indexed = true;
+  entry.cell = cell;
+  if (binned)
+    this->cells[cell].push_back(_index);
+  else
+    this->large.push_back(_index);
+}
+
+//////////////////////////////////////////////////
+void ModelIndex::Query(const Model_V &_models,
+    const ignition::math::AxisAlignedBox &_box,
+    const Filter &_filter, Model_V &_result)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  if (!this->stale)
+  {
+    // Refresh the boxes of the models that moved, and of their nested
+    // models. A nested model missing from the index was added at run time,
+    // in which case the index is rebuilt.
+    std::vector<ModelPtr> pending;
+    pending.swap(this->dirtyModels);
+    while (!pending.empty() && !this->stale)
+    {
+      ModelPtr model = pending.back();
+      pending.pop_back();
+
+      auto iter = this->lookup.find(model.get());
+      if (iter == this->lookup.end())
+      {
+        this->stale = true;
+        break;
+      }
+
+      if (this->entries[iter->second].model != model)
+      {
+        this->stale = true;
+        break;
+      }
+
+      this->Update(iter->second);
+      pending.insert(pending.end(), model->NestedModels().begin(),
+          model->NestedModels().end());
+    }
+  }
+
+  if (this->stale)
+    this->Rebuild(_models);
+
+  this->candidates.clear();
+  this->candidates.insert(this->candidates.end(), this->large.begin(),
+      this->large.end());
+
+  if (!Bounded(_box))
+  {
+    for (auto const &cell : this->cells)
+    {
+      this->candidates.insert(this->candidates.end(), cell.second.begin(),
+          cell.second.end());
+    }
+  }
+  else
+  {
+    // A binned box is at most one cell wide, so its center is at most half
+    // a cell away from the query box.
+    Cell minCell;
+    Cell maxCell;
+    double range = 1;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const double half = 0.5 * this->cellSize;
+      minCell[i] = static_cast<int64_t>(
+          std::floor((_box.Min()[i] - half) / this->cellSize));
+      maxCell[i] = static_cast<int64_t>(
+          std::floor((_box.Max()[i] + half) / this->cellSize));
+      range *= static_cast<double>(maxCell[i] - minCell[i] + 1);
+    }
+
+    if (range > static_cast<double>(this->cells.size()))
+    {
+      // Large query, cheaper to visit the occupied cells.
+      for (auto const &cell : this->cells)
+      {
+        bool inside = true;
+        for (unsigned int i = 0; inside && i < 3; ++i)
+        {
+          inside = cell.first[i] >= minCell[i] &&
+                   cell.first[i] <= maxCell[i];
+        }
+        if (inside)
+        {
+          this->candidates.insert(this->candidates.end(),
+              cell.second.begin(), cell.second.end());
+        }
+      }
+    }
+    else
+    {
+      Cell cell;
+      for (cell[0] = minCell[0]; cell[0] <= maxCell[0]; ++cell[0])
+      {
+        for (cell[1] = minCell[1]; cell[1] <= maxCell[1]; ++cell[1])
+        {
+          for (cell[2] = minCell[2]; cell[2] <= maxCell[2]; ++cell[2])
+          {
+            auto iter = this->cells.find(cell);
+            if (iter != this->cells.end())
+            {
+              this->candidates.insert(this->candidates.end(),
+                  iter->second.begin(), iter->second.end());
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Report the models in the order of a traversal of the model tree, so
+  // that the result does not depend on the layout of the grid.
+  std::sort(this->candidates.begin(), this->candidates.end());
+
+  const bool boundedQuery = Bounded(_box);
+  for (auto const index : this->candidates)
+  {
+    const Entry &entry = this->entries[index];
+
+    // Empty or infinite boxes are left to the filter.
+    if (Bounded(entry.box))
+    {
+      if (boundedQuery && !_box.Intersects(entry.box))
+        continue;
+    }
+    else if (!_filter)
+    {
+      continue;
+    }
+
+    if (_filter && !_filter(entry.box))
+      continue;
+
+    _result.push_back(entry.model);
+  }
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_MODELINDEX_HH_
+#define GAZEBO_PHYSICS_MODELINDEX_HH_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \brief Spatial index of the bounding boxes of all the models of a
+    /// world, including nested models. Models are binned by the center of
+    /// their box in a loose hash grid, so that a query only visits the
+    /// cells around the query box instead of every model. Models larger
+    /// than a cell, or with an empty box, are kept in a separate list that
+    /// is tested by every query.
+    ///
+    /// The index is refreshed lazily by the queries: only the models
+    /// marked dirty since the last query have their box recomputed, and
+    /// the whole index is rebuilt after models are added or removed.
+    class GZ_PHYSICS_VISIBLE ModelIndex
+    {
+      /// \brief Function that tests the bounding box of a model.
+      public: using Filter =
+          std::function<bool(const ignition::math::AxisAlignedBox &)>;
+
+      /// \brief Constructor.
+      /// \param[in] _cellSize Size of the grid cells in meters.
+      public: explicit ModelIndex(const double _cellSize = 4.0);
+
+      /// \brief Rebuild the whole index on the next query.
+      public: void SetStale();
+
+      /// \brief Recompute the box of some models, and of their nested
+      /// models, on the next query.
+      /// \param[in] _models Models that moved.
+      public: void MarkDirty(const std::set<ModelPtr> &_models);
+
+      /// \brief Find the models whose bounding box intersects a box and
+      /// passes a filter.
+      /// \param[in] _models Top level models of the world, used when the
+      /// index has to be rebuilt.
+      /// \param[in] _box Query box.
+      /// \param[in] _filter Exact test applied to the candidate boxes,
+      /// nullptr to only test for intersection with _box.
+      /// \param[out] _result Models found, in depth first order.
+      public: void Query(const Model_V &_models,
+                  const ignition::math::AxisAlignedBox &_box,
+                  const Filter &_filter, Model_V &_result);
+
+      /// \brief Get the number of indexed models.
+      /// \return Number of models, including nested models.
+      public: size_t ModelCount() const;
+
+      /// \brief Rebuild the index from the world models.
+      /// \param[in] _models Top level models.
+      private: void Rebuild(const Model_V &_models);
+
+      /// \brief Add a model and its nested models to the index.
+      /// \param[in] _model Model to add.
+      private: void Add(const ModelPtr &_model);
+
+      /// \brief Recompute the box of an entry and move it to its new cell.
+      /// \param[in] _index Index of the entry.
+      private: void Update(const size_t _index);
+
+      /// \brief Remove an entry from its cell.
+      /// \param[in] _index Index of the entry.
+      private: void Unbin(const size_t _index);
+
+      /// \brief Grid cell coordinates.
+      private: using Cell = std::array<int64_t, 3>;
+
+      /// \brief Hash of grid cell coordinates.
+      private: struct CellHash
+      {
+        /// \brief Hash a cell.
+        /// \param[in] _cell Cell to hash.
+        /// \return Hash value.
+        size_t operator()(const Cell &_cell) const
+        {
+          return static_cast<size_t>(_cell[0] * 73856093 ^
+              _cell[1] * 19349663 ^ _cell[2] * 83492791);
+        }
+      };
+
+      /// \brief An indexed model.
+      private: struct Entry
+      {
+        /// \brief The model.
+        ModelPtr model;
+
+        /// \brief Cached bounding box of the model.
+        ignition::math::AxisAlignedBox box;
+
+        /// \brief Cell of the model, if binned.
+        Cell cell;
+
+        /// \brief False if the model is in the list of large models.
+        bool binned;
+
+        /// \brief True once the entry is in a cell or in the list of
+        /// large models.
+        bool indexed;
+      };
+
+      /// \brief Size of the grid cells.
+      private: double cellSize;
+
+      /// \brief Indexed models, in depth first order.
+      private: std::vector<Entry> entries;
+
+      /// \brief Entry index of each model.
+      private: std::unordered_map<const Model *, size_t> lookup;
+
+      /// \brief Entries of each non-empty cell.
+      private: std::unordered_map<Cell, std::vector<size_t>, CellHash> cells;
+
+      /// \brief Entries too large to be binned.
+      private: std::vector<size_t> large;
+
+      /// \brief Models marked dirty since the last query.
+      private: std::vector<ModelPtr> dirtyModels;
+
+      /// \brief True if the index has to be rebuilt.
+      private: bool stale = true;
+
+      /// \brief Candidate entries of the current query.
+      private: std::vector<size_t> candidates;
+
+      /// \brief Protects the index.
+      private: mutable std::mutex mutex;
+    };
+    /// \}
+  }
+}
+#endif
@@ -17,6 +17,12 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -28,15 +34,60 @@
 #include "gazebo/transport/Node.hh"
 
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/Joint.hh"
 #include "gazebo/physics/Link.hh"
 #include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/PhysicsEngine.hh"
 #include "gazebo/physics/PresetManager.hh"
+#include "gazebo/physics/SleepManager.hh"
 
 using namespace gazebo;
 using namespace physics;
 
+namespace
+{
+  /// \brief Engine specific snapshot functions.
+  struct SnapshotFuncs
+  {
+    /// \brief Saves the state.
+    PhysicsEngine::SaveSnapshotFunc save;
+
+    /// \brief Restores the state.
+    PhysicsEngine::RestoreSnapshotFunc restore;
+  };
+}
+
+// TODO declared here for ABI compatibility
+// make SaveSnapshot and RestoreSnapshot virtual when merging forward.
+static std::map<std::string, SnapshotFuncs> g_snapshotFuncs;
+
+/// \brief Protects g_snapshotFuncs.
+static std::mutex g_snapshotFuncsMutex;
+
+/////////////////////////////////////////////////
+/// \brief Get the snapshot functions of an engine type.
+/// \param[in] _type Engine type.
+/// \param[out] _funcs The functions, if registered.
+/// \return False if the engine type uses the default implementation.
+static bool FindSnapshotFuncs(const std::string &_type, SnapshotFuncs &_funcs)
+{
+  std::lock_guard<std::mutex> lock(g_snapshotFuncsMutex);
+  auto iter = g_snapshotFuncs.find(_type);
+  if (iter == g_snapshotFuncs.end())
+    return false;
+  _funcs = iter->second;
+  return true;
+}
+
+// TODO declared here for ABI compatibility
+// move to class member variable(s) when merging forward.
+static std::unordered_map<const PhysicsEngine *,
+    std::unique_ptr<SleepManager>> g_sleepManagers;
+
+/// \brief Protects g_sleepManagers.
+static std::mutex g_sleepManagersMutex;
+
 //////////////////////////////////////////////////
 PhysicsEngine::PhysicsEngine(WorldPtr _world)
   : world(_world)
@@ -61,9 +112,18 @@ PhysicsEngine::PhysicsEngine(WorldPtr _world)
 
   this->physicsUpdateMutex = new boost::recursive_mutex();
 
+  // Create and initialize the sleep manager.
+  SleepManager *sleepManager = new SleepManager();
+  sleepManager->Init(this->world);
+  {
+    std::lock_guard<std::mutex> lock(g_sleepManagersMutex);
+    g_sleepManagers[this].reset(sleepManager);
+  }
+
   // Create and initialized the contact manager.
   this->contactManager = new ContactManager();
   this->contactManager->Init(this->world);
+  this->contactManager->SetSleepManager(sleepManager);
 }
 
 //////////////////////////////////////////////////
@@ -77,6 +137,8 @@ void PhysicsEngine::Load(sdf::ElementPtr _sdf)
       this->sdf->GetElement("real_time_factor")->Get<double>();
   this->maxStepSize =
       this->sdf->GetElement("max_step_size")->Get<double>();
+
+  this->GetSleepManager()->Load(_sdf);
 }
 
 //////////////////////////////////////////////////
@@ -105,6 +167,11 @@ void PhysicsEngine::Fini()
     this->contactManager = NULL;
   }
 
+  {
+    std::lock_guard<std::mutex> lock(g_sleepManagersMutex);
+    g_sleepManagers.erase(this);
+  }
+
   if (this->physicsUpdateMutex)
   {
     delete this->physicsUpdateMutex;
@@ -243,6 +310,14 @@ bool PhysicsEngine::SetParam(const std::string &_key,
       this->world->SetMagneticField(
           any_cast<ignition::math::Vector3d>(copy));
     }
+    else if (_key == "sleep")
+      this->GetSleepManager()->SetEnabled(any_cast<bool>(_value));
+    else if (_key == "sleep_linear_threshold")
+      this->GetSleepManager()->SetLinearThreshold(any_cast<double>(_value));
+    else if (_key == "sleep_angular_threshold")
+      this->GetSleepManager()->SetAngularThreshold(any_cast<double>(_value));
+    else if (_key == "sleep_time")
+      this->GetSleepManager()->SetIdleTime(any_cast<double>(_value));
     else
     {
       gzwarn << "SetParam failed for [" << _key << "] in physics engine "
@@ -295,6 +370,14 @@ bool PhysicsEngine::GetParam(const std::string &_key,
     _value = this->world->Gravity();
   else if (_key == "magnetic_field")
     _value = this->world->MagneticField();
+  else if (_key == "sleep")
+    _value = this->GetSleepManager()->Enabled();
+  else if (_key == "sleep_linear_threshold")
+    _value = this->GetSleepManager()->LinearThreshold();
+  else if (_key == "sleep_angular_threshold")
+    _value = this->GetSleepManager()->AngularThreshold();
+  else if (_key == "sleep_time")
+    _value = this->GetSleepManager()->IdleTime();
   else
   {
     gzwarn << "GetParam failed for [" << _key << "] in physics engine "
@@ -311,6 +394,14 @@ ContactManager *PhysicsEngine::GetContactManager() const
   return this->contactManager;
 }
 
+//////////////////////////////////////////////////
+SleepManager *PhysicsEngine::GetSleepManager() const
+{
+  std::lock_guard<std::mutex> lock(g_sleepManagersMutex);
+  auto iter = g_sleepManagers.find(this);
+  return iter != g_sleepManagers.end() ? iter->second.get() : nullptr;
+}
+
 //////////////////////////////////////////////////
 sdf::ElementPtr PhysicsEngine::GetSDF() const
 {
@@ -322,3 +413,89 @@ WorldPtr PhysicsEngine::World() const
 {
   return this->world;
 }
+
+//////////////////////////////////////////////////
+void PhysicsEngine::RegisterSnapshotFuncs(const std::string &_type,
+    SaveSnapshotFunc _save, RestoreSnapshotFunc _restore)
+{
+  std::lock_guard<std::mutex> lock(g_snapshotFuncsMutex);
+  g_snapshotFuncs[_type] = {_save, _restore};
+}
+
+//////////////////////////////////////////////////
+void PhysicsEngine::SaveSnapshot(const Link_V &_links,
+    const Joint_V &_joints, std::string &_data) const
+{
+  SnapshotFuncs funcs;
+  if (FindSnapshotFuncs(this->GetType(), funcs) && funcs.save)
+  {
+    funcs.save(*this, _links, _joints, _data);
+    return;
+  }
+
+  for (auto const &joint : _joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+    {
+      const double state[2] = {joint->Position(i), joint->GetVelocity(i)};
+      WriteSnapshot(_data, state, 2);
+    }
+  }
+
+  for (auto const &link : _links)
+  {
+    const ignition::math::Pose3d &pose = link->WorldPose();
+    const ignition::math::Vector3d linVel = link->WorldCoGLinearVel();
+    const ignition::math::Vector3d angVel = link->WorldAngularVel();
+    const ignition::math::Vector3d force = link->WorldForce();
+    const ignition::math::Vector3d torque = link->WorldTorque();
+
+    const double state[19] = {
+        pose.Pos().X(), pose.Pos().Y(), pose.Pos().Z(),
+        pose.Rot().W(), pose.Rot().X(), pose.Rot().Y(), pose.Rot().Z(),
+        linVel.X(), linVel.Y(), linVel.Z(),
+        angVel.X(), angVel.Y(), angVel.Z(),
+        force.X(), force.Y(), force.Z(),
+        torque.X(), torque.Y(), torque.Z()};
+    WriteSnapshot(_data, state, 19);
+  }
+}
+
+//////////////////////////////////////////////////
+bool PhysicsEngine::RestoreSnapshot(const Link_V &_links,
+    const Joint_V &_joints, const char *&_data, const char *_end)
+{
+  SnapshotFuncs funcs;
+  if (FindSnapshotFuncs(this->GetType(), funcs) && funcs.restore)
+    return funcs.restore(*this, _links, _joints, _data, _end);
+
+  // Joints first, so that engines with maximal coordinates end up with
+  // the saved link poses.
+  for (auto const &joint : _joints)
+  {
+    for (unsigned int i = 0; i < joint->DOF(); ++i)
+    {
+      double state[2];
+      if (!ReadSnapshot(_data, _end, state, 2))
+        return false;
+      joint->SetPosition(i, state[0]);
+      joint->SetVelocity(i, state[1]);
+    }
+  }
+
+  for (auto const &link : _links)
+  {
+    double s[19];
+    if (!ReadSnapshot(_data, _end, s, 19))
+      return false;
+
+    link->SetWorldPose(ignition::math::Pose3d(
+        s[0], s[1], s[2], s[3], s[4], s[5], s[6]));
+    link->SetLinearVel(ignition::math::Vector3d(s[7], s[8], s[9]));
+    link->SetAngularVel(ignition::math::Vector3d(s[10], s[11], s[12]));
+    link->SetForce(ignition::math::Vector3d(s[13], s[14], s[15]));
+    link->SetTorque(ignition::math::Vector3d(s[16], s[17], s[18]));
+  }
+
+  return true;
+}
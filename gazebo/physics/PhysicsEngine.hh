@@ -19,6 +19,8 @@
 
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/any.hpp>
+#include <cstring>
+#include <functional>
 #include <string>
 #include <ignition/transport/Node.hh>
 
@@ -33,6 +35,7 @@ namespace gazebo
   namespace physics
   {
     class ContactManager;
+    class SleepManager;
 
     /// \addtogroup gazebo_physics
     /// \{
@@ -215,6 +218,13 @@ namespace gazebo
       ///          (defined but not used in ode).
       ///       -# "max_step_size" (double) - maximum physics step size when
       ///          physics update step must return.
+      ///       -# "sleep" (bool) - put the links at rest to sleep.
+      ///       -# "sleep_linear_threshold" (double) - linear velocity under
+      ///          which a link is at rest.
+      ///       -# "sleep_angular_threshold" (double) - angular velocity
+      ///          under which a link is at rest.
+      ///       -# "sleep_time" (double) - time a link must be at rest
+      ///          before it sleeps.
       ///
       /// \param[in] _value The value to set to
       /// \return true if SetParam is successful, false if operation fails.
@@ -246,6 +256,10 @@ namespace gazebo
       /// \return Pointer to the contact manager.
       public: ContactManager *GetContactManager() const;
 
+      /// \brief Get a pointer to the sleep manager.
+      /// \return Pointer to the sleep manager.
+      public: SleepManager *GetSleepManager() const;
+
       /// \brief returns a pointer to the PhysicsEngine#physicsUpdateMutex.
       /// \return Pointer to the physics mutex.
       public: boost::recursive_mutex *GetPhysicsUpdateMutex() const
@@ -255,6 +269,83 @@ namespace gazebo
       /// \return Pointer to the physics SDF element.
       public: sdf::ElementPtr GetSDF() const;
 
+      /// \brief Append the dynamic state of links and joints to a binary
+      /// snapshot, see World::SaveSnapshot. The default implementation
+      /// stores joint positions and velocities, and link poses, center of
+      /// mass velocities, forces and torques, using the generic Link and
+      /// Joint interface. Engines register their own functions with
+      /// RegisterSnapshotFuncs to store their internal state directly,
+      /// including solver warm start data, so that a restored simulation
+      /// is bit-identical to the original run.
+      /// \param[in] _links Links, in a stable order.
+      /// \param[in] _joints Joints, in a stable order.
+      /// \param[out] _data Buffer the state is appended to.
+      public: void SaveSnapshot(const Link_V &_links,
+                  const Joint_V &_joints, std::string &_data) const;
+
+      /// \brief Restore the state written by SaveSnapshot.
+      /// \param[in] _links Links, in the order used to save the state.
+      /// \param[in] _joints Joints, in the order used to save the state.
+      /// \param[in,out] _data Start of the state; advanced past it.
+      /// \param[in] _end End of the snapshot buffer.
+      /// \return False if the buffer is too short.
+      public: bool RestoreSnapshot(const Link_V &_links,
+                  const Joint_V &_joints, const char *&_data,
+                  const char *_end);
+
+      /// \def SaveSnapshotFunc
+      /// \brief Engine specific implementation of SaveSnapshot.
+      public: typedef std::function<void (const PhysicsEngine &,
+                  const Link_V &, const Joint_V &, std::string &)>
+                  SaveSnapshotFunc;
+
+      /// \def RestoreSnapshotFunc
+      /// \brief Engine specific implementation of RestoreSnapshot.
+      public: typedef std::function<bool (PhysicsEngine &,
+                  const Link_V &, const Joint_V &, const char *&,
+                  const char *)> RestoreSnapshotFunc;
+
+      /// \brief Register the snapshot functions of an engine type. They
+      /// replace the default implementation of SaveSnapshot and
+      /// RestoreSnapshot for every engine whose GetType() matches.
+      /// \param[in] _type Engine type, such as "ode".
+      /// \param[in] _save Function that saves the state.
+      /// \param[in] _restore Function that restores the state.
+      public: static void RegisterSnapshotFuncs(const std::string &_type,
+                  SaveSnapshotFunc _save, RestoreSnapshotFunc _restore);
+
+      /// \brief Append raw values to a snapshot buffer.
+      /// \param[out] _data Snapshot buffer.
+      /// \param[in] _values Values to append.
+      /// \param[in] _count Number of values.
+      public:
+      template <typename T>
+      static void WriteSnapshot(std::string &_data, const T *_values,
+          const size_t _count)
+      {
+        _data.append(reinterpret_cast<const char *>(_values),
+            _count * sizeof(T));
+      }
+
+      /// \brief Read raw values from a snapshot buffer.
+      /// \param[in,out] _data Read position; advanced past the values.
+      /// \param[in] _end End of the snapshot buffer.
+      /// \param[out] _values Values read.
+      /// \param[in] _count Number of values.
+      /// \return False if the buffer is too short.
+      public:
+      template <typename T>
+      static bool ReadSnapshot(const char *&_data, const char *_end,
+          T *_values, const size_t _count)
+      {
+        const size_t size = _count * sizeof(T);
+        if (static_cast<size_t>(_end - _data) < size)
+          return false;
+        std::memcpy(_values, _data, size);
+        _data += size;
+        return true;
+      }
+
       /// \brief Helper function for performing any_cast operations in
       /// SetParam. This is useful because the PresetManager stores the
       /// output of sdf::Element::GetAny as boost::any values in its
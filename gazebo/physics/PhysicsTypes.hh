@@ -52,6 +52,7 @@ namespace gazebo
     class UserCmdManager;
     class PhysicsEngine;
     class Wind;
+    class WindField;
     class Atmosphere;
     class Mass;
     class Road;
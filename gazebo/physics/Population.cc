@@ -15,11 +15,18 @@
  *
 */
 
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <string>
 #include <vector>
 #include <boost/lexical_cast.hpp>
 #include <boost/shared_ptr.hpp>
-#include <ignition/math/Kmeans.hh>
+#include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 #include <sdf/sdf.hh>
 #include "gazebo/common/Assert.hh"
@@ -33,6 +40,206 @@ using namespace gazebo;
 using namespace common;
 using namespace physics;
 
+namespace
+{
+  /// \brief SplitMix64 hash, used to derive an independent random stream
+  /// for every tile of the Poisson disk sampler.
+  /// \param[in] _x Value to hash.
+  /// \return Hashed value.
+  uint64_t MixSeed(uint64_t _x)
+  {
+    _x += 0x9E3779B97F4A7C15ULL;
+    _x = (_x ^ (_x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    _x = (_x ^ (_x >> 27)) * 0x94D049BB133111EBULL;
+    return _x ^ (_x >> 31);
+  }
+
+  /// \brief A cell of the Poisson disk sampling grid.
+  struct SampleCell
+  {
+    /// \brief Position of the sample in the cell.
+    double x = 0;
+
+    /// \brief Position of the sample in the cell.
+    double y = 0;
+
+    /// \brief True if the cell holds a sample.
+    bool used = false;
+  };
+
+  /// \brief Get a seed for the pose samplers from the global generator, so
+  /// that populations stay reproducible with a fixed random seed.
+  /// \return Seed.
+  uint64_t PopulationSeed()
+  {
+    return static_cast<uint64_t>(ignition::math::Rand::IntUniform(0,
+        std::numeric_limits<int>::max()));
+  }
+}
+
+//////////////////////////////////////////////////
+double PoissonDiskSampler::Sample(const ignition::math::Vector2d &_size,
+    const bool _disk, const unsigned int _count, const uint64_t _seed,
+    std::vector<ignition::math::Vector2d> &_samples)
+{
+  _samples.clear();
+  if (_count == 0 || _size.X() <= 0 || _size.Y() <= 0)
+    return 0;
+
+  // Number of grid cells along each side of a tile. Candidates are
+  // checked against the cells up to two cells away, so tiles processed in
+  // the same phase, which are a whole tile apart, never read each other.
+  const int kTileCells = 4;
+
+  // Candidates drawn per grid cell in a pass.
+  const int kAttempts = 30;
+
+  // Maximum number of passes, each with a smaller spacing.
+  const int kMaxPasses = 8;
+
+  const ignition::math::Vector2d center = _size / 2.0;
+  const double radius = std::min(_size.X(), _size.Y()) / 2.0;
+  const double area = _disk ? IGN_PI * radius * radius :
+    _size.X() * _size.Y();
+
+  // Dart throwing until saturation places about 30% more samples than
+  // needed with this spacing; the surplus is dropped at random below.
+  double spacing = 0.7 * std::sqrt(area / _count);
+
+  std::vector<SampleCell> grid;
+  std::vector<ignition::math::Vector2d> accepted;
+  for (int pass = 0; pass < kMaxPasses; ++pass)
+  {
+    // With this cell size a cell holds at most one sample.
+    const double cellSize = spacing / std::sqrt(2.0);
+    const int nx = std::max(1, static_cast<int>(
+          std::ceil(_size.X() / cellSize)));
+    const int ny = std::max(1, static_cast<int>(
+          std::ceil(_size.Y() / cellSize)));
+
+    // Samples of the previous passes are kept.
+    grid.assign(nx * ny, SampleCell());
+    for (auto const &sample : accepted)
+    {
+      const int ci = std::min(static_cast<int>(sample.X() / cellSize), nx-1);
+      const int cj = std::min(static_cast<int>(sample.Y() / cellSize), ny-1);
+      SampleCell &cell = grid[cj * nx + ci];
+      cell.x = sample.X();
+      cell.y = sample.Y();
+      cell.used = true;
+    }
+
+    const int tx = (nx + kTileCells - 1) / kTileCells;
+    const int ty = (ny + kTileCells - 1) / kTileCells;
+    std::vector<int> tiles;
+    for (int phase = 0; phase < 4; ++phase)
+    {
+      tiles.clear();
+      for (int j = phase / 2; j < ty; j += 2)
+      {
+        for (int i = phase % 2; i < tx; i += 2)
+          tiles.push_back(j * tx + i);
+      }
+
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, tiles.size()),
+          [&](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t t = _r.begin(); t != _r.end(); ++t)
+        {
+          const int ci0 = (tiles[t] % tx) * kTileCells;
+          const int cj0 = (tiles[t] / tx) * kTileCells;
+          const int ci1 = std::min(ci0 + kTileCells, nx);
+          const int cj1 = std::min(cj0 + kTileCells, ny);
+
+          std::mt19937_64 rng(MixSeed(_seed ^ MixSeed(
+                (static_cast<uint64_t>(pass) << 32) + tiles[t])));
+          std::uniform_real_distribution<double> ux(ci0 * cellSize,
+              std::min(ci1 * cellSize, _size.X()));
+          std::uniform_real_distribution<double> uy(cj0 * cellSize,
+              std::min(cj1 * cellSize, _size.Y()));
+
+          const int attempts = kAttempts * (ci1 - ci0) * (cj1 - cj0);
+          for (int a = 0; a < attempts; ++a)
+          {
+            const double x = ux(rng);
+            const double y = uy(rng);
+            if (_disk && (x - center.X()) * (x - center.X()) +
+                (y - center.Y()) * (y - center.Y()) > radius * radius)
+            {
+              continue;
+            }
+
+            const int ci = ignition::math::clamp(
+                static_cast<int>(x / cellSize), ci0, ci1 - 1);
+            const int cj = ignition::math::clamp(
+                static_cast<int>(y / cellSize), cj0, cj1 - 1);
+            if (grid[cj * nx + ci].used)
+              continue;
+
+            bool free = true;
+            for (int j = std::max(cj - 2, 0);
+                 free && j <= std::min(cj + 2, ny - 1); ++j)
+            {
+              for (int i = std::max(ci - 2, 0);
+                   i <= std::min(ci + 2, nx - 1); ++i)
+              {
+                const SampleCell &cell = grid[j * nx + i];
+                if (cell.used && (cell.x - x) * (cell.x - x) +
+                    (cell.y - y) * (cell.y - y) < spacing * spacing)
+                {
+                  free = false;
+                  break;
+                }
+              }
+            }
+
+            if (free)
+            {
+              SampleCell &cell = grid[cj * nx + ci];
+              cell.x = x;
+              cell.y = y;
+              cell.used = true;
+            }
+          }
+        }
+      });
+    }
+
+    accepted.clear();
+    for (auto const &cell : grid)
+    {
+      if (cell.used)
+        accepted.push_back(ignition::math::Vector2d(cell.x, cell.y));
+    }
+
+    if (accepted.size() >= _count)
+      break;
+
+    // The region is saturated before reaching the requested count.
+    spacing *= 0.8;
+  }
+
+  std::mt19937_64 rng(MixSeed(_seed));
+  std::shuffle(accepted.begin(), accepted.end(), rng);
+
+  // Only reachable for degenerate regions, fill up with random samples.
+  std::uniform_real_distribution<double> unit(0, 1);
+  while (accepted.size() < _count)
+  {
+    ignition::math::Vector2d sample(unit(rng) * _size.X(),
+        unit(rng) * _size.Y());
+    if (!_disk || sample.Distance(center) <= radius)
+    {
+      accepted.push_back(sample);
+      spacing = 0;
+    }
+  }
+
+  accepted.resize(_count);
+  _samples.swap(accepted);
+  return spacing;
+}
+
 //////////////////////////////////////////////////
 Population::Population(sdf::ElementPtr _sdf, boost::shared_ptr<World> _world)
   : dataPtr(new PopulationPrivate)
@@ -101,35 +308,20 @@ bool Population::PopulateOne(const sdf::ElementPtr _population)
     return false;
   }
 
-  // Create an sdf containing the model description.
-  sdf::SDF sdf;
-  sdf.SetFromString("<sdf version ='" + std::string(SDF_PROTOCOL_VERSION) +
-    "'>" + params.modelSdf + "</sdf>");
+  // Every clone is copied from the parsed <model> element, so the model
+  // description is not serialized and parsed again for each instance.
+  sdf::ElementPtr modelElem = _population->GetElement("model");
 
   for (size_t i = 0; i < objects.size(); ++i)
   {
-    ignition::math::Vector3d p(objects[i].X(), objects[i].Y(), objects[i].Z());
-
     // Create a unique model for each clone.
-    std::string cloneSdf = sdf.ToString();
-    std::string delim = "model name='";
-    size_t first = cloneSdf.find(delim) + delim.size();
-    size_t last = cloneSdf.find("'", first);
-    std::string newName = params.modelName + std::string("_clone_") +
-      boost::lexical_cast<std::string>(i);
-    cloneSdf.replace(first, last - first, newName);
-
-    // Insert the <pose> element.
-    std::string endDelim = "'>";
-    first = cloneSdf.find(delim) + delim.size();
-    last = cloneSdf.find(endDelim, first);
-    std::string pose = "\n    <pose>" +
-      boost::lexical_cast<std::string>(p.X()) + " " +
-      boost::lexical_cast<std::string>(p.Y()) + " " +
-      boost::lexical_cast<std::string>(p.Z()) + " 0 0 0</pose>";
-    cloneSdf.insert(last + endDelim.size(), pose);
-
-    this->dataPtr->world->InsertModelString(cloneSdf);
+    sdf::ElementPtr clone = modelElem->Clone();
+    clone->GetAttribute("name")->Set(params.modelName +
+        std::string("_clone_") + boost::lexical_cast<std::string>(i));
+    clone->GetElement("pose")->Set(ignition::math::Pose3d(objects[i],
+          ignition::math::Quaterniond::Identity));
+
+    this->dataPtr->world->InsertModelElement(clone);
   }
 
   return true;
@@ -356,39 +548,19 @@ void Population::CreatePosesBoxUniform(const PopulationParams &_populParams,
   // _poses should be empty.
   GZ_ASSERT(_poses.empty(), "Output parameter '_poses' is not empty");
 
-  std::vector<ignition::math::Vector3d> obs;
+  // Spread the objects over the base of the box.
+  std::vector<ignition::math::Vector2d> samples;
+  PoissonDiskSampler::Sample(ignition::math::Vector2d(
+        _populParams.size.X(), _populParams.size.Y()), false,
+      _populParams.modelCount, PopulationSeed(), samples);
 
-  // Step1: Sample points in a box.
-  double x = 0.0;
-  double y = 0.0;
-  while (y < _populParams.size.Y())
-  {
-    while (x < _populParams.size.X())
-    {
-      ignition::math::Vector3d p;
-      p.X(x);
-      p.Y(y);
-      p.Z(ignition::math::Rand::DblUniform(0, _populParams.size.Z()));
-      obs.push_back(p);
-      x += .1;
-    }
-    x = 0.0;
-    y += .1;
-  }
-
-  // Step2: Cluster the sampled points in 'modelCount' clusters.
-  std::vector<ignition::math::Vector3d> centroids;
-  std::vector<unsigned int> labels;
-  ignition::math::Kmeans kmeans(obs);
-  kmeans.Cluster(_populParams.modelCount, centroids, labels);
-
-  // Step3: Create the list of object positions.
   _poses.clear();
-  for (int i = 0; i < _populParams.modelCount; ++i)
+  for (auto const &sample : samples)
   {
-    ignition::math::Pose3d p(centroids[i],
-                             ignition::math::Quaterniond::Identity);
-    _poses.push_back((p + _populParams.pose).Pos());
+    ignition::math::Pose3d offset(sample.X(), sample.Y(),
+        ignition::math::Rand::DblUniform(0, _populParams.size.Z()),
+        0, 0, 0);
+    _poses.push_back((offset + _populParams.pose).Pos());
   }
 
   // Check that we have generated the appropriate number of poses.
@@ -526,33 +698,20 @@ void Population::CreatePosesCylinderUniform(
   // _poses should be empty.
   GZ_ASSERT(_poses.empty(), "Output parameter '_poses' is not empty");
 
-  std::vector<ignition::math::Vector3d> obs;
+  // Spread the objects over the base of the cylinder.
+  const double diameter = 2 * _populParams.radius;
+  std::vector<ignition::math::Vector2d> samples;
+  PoissonDiskSampler::Sample(ignition::math::Vector2d(diameter, diameter),
+      true, _populParams.modelCount, PopulationSeed(), samples);
 
-  // Step1: Sample points in the cylinder.
-  unsigned int points = 10000;
-  for (size_t i = 0; i < points; ++i)
-  {
-    double ang = ignition::math::Rand::DblUniform(0, 2 * M_PI);
-    double r = ignition::math::Rand::DblUniform(0, _populParams.radius);
-    ignition::math::Vector3d p;
-    p.X(r * cos(ang));
-    p.Y(r * sin(ang));
-    p.Z(ignition::math::Rand::DblUniform(0, _populParams.length));
-    obs.push_back(p);
-  }
-
-  // Step2: Cluster the sampled points in 'modelCount' clusters.
-  std::vector<ignition::math::Vector3d> centroids;
-  std::vector<unsigned int> labels;
-  ignition::math::Kmeans kmeans(obs);
-  kmeans.Cluster(_populParams.modelCount, centroids, labels);
-
-  // Step3: Create the list of object positions.
   _poses.clear();
   ignition::math::Pose3d offset = ignition::math::Pose3d::Zero;
-  for (int i = 0; i < _populParams.modelCount; ++i)
+  for (auto const &sample : samples)
   {
-    offset.Pos() = centroids[i];
+    offset.Pos().X() = sample.X() - _populParams.radius;
+    offset.Pos().Y() = sample.Y() - _populParams.radius;
+    offset.Pos().Z() =
+      ignition::math::Rand::DblUniform(0, _populParams.length);
     _poses.push_back((offset + _populParams.pose).Pos());
   }
 
@@ -154,8 +154,8 @@ namespace gazebo
         std::vector<ignition::math::Vector3d> &_poses);
 
       /// \brief Populate a vector of poses with '_modelCount' elements,
-      /// uniformly distributed within a box. We use k-means to split the
-      /// box in similar subregions.
+      /// uniformly distributed within a box. The objects are spread over
+      /// the base of the box with Poisson disk sampling.
       /// \param[in] _modelCount Number of poses.
       /// \param[in] _min Minimum corner of the box containing the models.
       /// \param[in] _max Maximum corner of the box containing the models.
@@ -222,8 +222,8 @@ namespace gazebo
         std::vector<ignition::math::Vector3d> &_poses);
 
       /// \brief Populate a vector of poses with '_modelCount' elements,
-      /// uniformly distributed within a cylinder. We use k-means to split the
-      /// cylinder in similar subregions.
+      /// uniformly distributed within a cylinder. The objects are spread
+      /// over the base of the cylinder with Poisson disk sampling.
       /// \param[in] _modelCount Number of poses.
       /// \param[in] _center Center of the cylinder's base containing
       /// the models.
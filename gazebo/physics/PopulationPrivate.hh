@@ -18,9 +18,13 @@
 #ifndef _GAZEBO_POPULATION_PRIVATE_HH_
 #define _GAZEBO_POPULATION_PRIVATE_HH_
 
+#include <cstdint>
+#include <vector>
 #include <boost/shared_ptr.hpp>
+#include <ignition/math/Vector2.hh>
 #include <sdf/sdf.hh>
 #include "gazebo/physics/World.hh"
+#include "gazebo/util/system.hh"
 
 namespace gazebo
 {
@@ -35,6 +39,29 @@ namespace gazebo
       /// \brief Pointer to the world.
       public: boost::shared_ptr<World> world;
     };
+
+    /// \brief Spreads samples evenly over a 2D region by Poisson disk
+    /// sampling: every sample keeps a minimum distance to the others.
+    /// Candidate samples are checked against a grid that holds at most one
+    /// sample per cell. The grid is split in tiles that are filled in
+    /// parallel, in four phases so that tiles processed at the same time
+    /// never share a neighborhood. Each tile draws from its own random
+    /// stream, so the result only depends on the seed.
+    class GZ_PHYSICS_VISIBLE PoissonDiskSampler
+    {
+      /// \brief Generate samples.
+      /// \param[in] _size Size of the rectangle containing the region.
+      /// \param[in] _disk True to restrict the samples to the disk
+      /// inscribed in the rectangle.
+      /// \param[in] _count Number of samples.
+      /// \param[in] _seed Seed of the random streams.
+      /// \param[out] _samples Samples, between 0 and _size.
+      /// \return Minimum distance kept between the samples.
+      public: static double Sample(const ignition::math::Vector2d &_size,
+                  const bool _disk, const unsigned int _count,
+                  const uint64_t _seed,
+                  std::vector<ignition::math::Vector2d> &_samples);
+    };
   }
 }
 #endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "gazebo/physics/PopulationPrivate.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class Population_TEST : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+/// \brief Check the samples of a region.
+/// \param[in] _size Size of the region.
+/// \param[in] _disk True if the region is a disk.
+/// \param[in] _count Number of samples.
+void CheckSamples(const ignition::math::Vector2d &_size, const bool _disk,
+    const unsigned int _count)
+{
+  std::vector<ignition::math::Vector2d> samples;
+  double spacing = physics::PoissonDiskSampler::Sample(_size, _disk, _count,
+      1234, samples);
+  ASSERT_EQ(samples.size(), _count);
+  EXPECT_GT(spacing, 0.0);
+
+  const ignition::math::Vector2d center = _size / 2.0;
+  for (size_t i = 0; i < samples.size(); ++i)
+  {
+    if (_disk)
+    {
+      EXPECT_LE(samples[i].Distance(center), _size.X() / 2.0);
+    }
+    else
+    {
+      EXPECT_GE(samples[i].X(), 0.0);
+      EXPECT_GE(samples[i].Y(), 0.0);
+      EXPECT_LE(samples[i].X(), _size.X());
+      EXPECT_LE(samples[i].Y(), _size.Y());
+    }
+
+    for (size_t j = i + 1; j < samples.size(); ++j)
+      EXPECT_GE(samples[i].Distance(samples[j]), spacing);
+  }
+
+  // The same seed gives the same samples.
+  std::vector<ignition::math::Vector2d> samples2;
+  physics::PoissonDiskSampler::Sample(_size, _disk, _count, 1234, samples2);
+  EXPECT_EQ(samples, samples2);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Population_TEST, PoissonDiskBox)
+{
+  CheckSamples(ignition::math::Vector2d(4, 2), false, 1);
+  CheckSamples(ignition::math::Vector2d(4, 2), false, 10);
+  CheckSamples(ignition::math::Vector2d(100, 50), false, 2000);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Population_TEST, PoissonDiskCylinder)
+{
+  CheckSamples(ignition::math::Vector2d(2, 2), true, 1);
+  CheckSamples(ignition::math::Vector2d(2, 2), true, 10);
+  CheckSamples(ignition::math::Vector2d(100, 100), true, 2000);
+}
+
+/////////////////////////////////////////////////
+TEST_F(Population_TEST, PoissonDiskEmpty)
+{
+  std::vector<ignition::math::Vector2d> samples;
+  physics::PoissonDiskSampler::Sample(ignition::math::Vector2d(1, 1), false,
+      0, 1234, samples);
+  EXPECT_TRUE(samples.empty());
+
+  physics::PoissonDiskSampler::Sample(ignition::math::Vector2d(0, 1), false,
+      10, 1234, samples);
+  EXPECT_TRUE(samples.empty());
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,431 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "gazebo/physics/Collision.hh"
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/SleepManager.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Private data for the SleepManager class
+class gazebo::physics::SleepManagerPrivate
+{
+  /// \brief Pointer to the world.
+  public: WorldPtr world;
+
+  /// \brief True if the physics engine sleeps the bodies itself.
+  public: bool native = false;
+
+  /// \brief True if sleeping is enabled.
+  public: bool enabled = false;
+
+  /// \brief Linear velocity under which a link is at rest, in m/s.
+  public: double linearThreshold = 0.1;
+
+  /// \brief Angular velocity under which a link is at rest, in rad/s.
+  public: double angularThreshold = 0.1;
+
+  /// \brief Time a link must be at rest before it sleeps, in seconds.
+  public: double idleTime = 1.0;
+
+  /// \brief Emitted when a parameter changes.
+  public: event::EventT<void ()> paramsChanged;
+
+  /// \brief Time each awake link has been at rest. Only used when the
+  /// engine is not native, from the world thread.
+  public: std::unordered_map<const Link *, double> restTimes;
+
+  /// \brief Links touched by each sleeping link, recorded from the
+  /// contacts. Only used when the engine is not native.
+  public: std::unordered_map<const Link *,
+          std::unordered_set<const Link *>> supports;
+
+  /// \brief Sleeping links that had a resting contact during the current
+  /// step. Only used when the engine is not native.
+  public: std::unordered_set<const Link *> touched;
+
+  /// \brief Number of sleeping links.
+  public: std::atomic<unsigned int> sleepingCount{0};
+
+  /// \brief Number of sleep transitions.
+  public: std::atomic<uint64_t> sleepCount{0};
+
+  /// \brief Number of wake transitions.
+  public: std::atomic<uint64_t> wakeCount{0};
+};
+
+/////////////////////////////////////////////////
+/// \brief Call a function on the links of models, and of their nested
+/// models.
+/// \param[in] _models The models.
+/// \param[in] _func Function called with each model and link.
+static void ForEachLink(const Model_V &_models,
+    const std::function<void (const ModelPtr &, const LinkPtr &)> &_func)
+{
+  for (const auto &model : _models)
+  {
+    if (model->IsStatic())
+      continue;
+
+    ForEachLink(model->NestedModels(), _func);
+    for (const auto &link : model->GetLinks())
+      _func(model, link);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Stop a link of an engine without native sleeping when it falls
+/// asleep. The engine keeps simulating it, so the velocity is only cleared
+/// once: a force that keeps acting on the link speeds it up again past the
+/// thresholds, which wakes it up.
+/// \param[in] _link The link.
+static void HoldStill(const LinkPtr &_link)
+{
+  _link->SetLinearVel(ignition::math::Vector3d::Zero);
+  _link->SetAngularVel(ignition::math::Vector3d::Zero);
+}
+
+/////////////////////////////////////////////////
+SleepManager::SleepManager()
+  : dataPtr(new SleepManagerPrivate)
+{
+}
+
+/////////////////////////////////////////////////
+SleepManager::~SleepManager()
+{
+  this->dataPtr->world.reset();
+}
+
+/////////////////////////////////////////////////
+void SleepManager::Init(WorldPtr _world)
+{
+  this->dataPtr->world = _world;
+}
+
+/////////////////////////////////////////////////
+void SleepManager::Load(sdf::ElementPtr _sdf)
+{
+  if (!_sdf || !_sdf->HasElement("gz:sleep"))
+    return;
+
+  sdf::ElementPtr elem = _sdf->GetElement("gz:sleep");
+  this->dataPtr->enabled =
+    elem->Get<bool>("enabled", this->dataPtr->enabled).first;
+  this->dataPtr->linearThreshold = elem->Get<double>("linear_threshold",
+      this->dataPtr->linearThreshold).first;
+  this->dataPtr->angularThreshold = elem->Get<double>("angular_threshold",
+      this->dataPtr->angularThreshold).first;
+  this->dataPtr->idleTime =
+    elem->Get<double>("time", this->dataPtr->idleTime).first;
+
+  this->dataPtr->paramsChanged();
+}
+
+/////////////////////////////////////////////////
+void SleepManager::SetNative(const bool _native)
+{
+  this->dataPtr->native = _native;
+}
+
+/////////////////////////////////////////////////
+bool SleepManager::Native() const
+{
+  return this->dataPtr->native;
+}
+
+/////////////////////////////////////////////////
+void SleepManager::SetEnabled(const bool _enabled)
+{
+  this->dataPtr->enabled = _enabled;
+
+  // Native engines wake their bodies up when they receive the parameters
+  if (!_enabled && !this->dataPtr->native && this->dataPtr->world)
+  {
+    ForEachLink(this->dataPtr->world->Models(),
+        [this](const ModelPtr &, const LinkPtr &_link)
+        {
+          this->SetSleeping(_link.get(), false);
+        });
+    this->dataPtr->restTimes.clear();
+  }
+
+  this->dataPtr->paramsChanged();
+}
+
+/////////////////////////////////////////////////
+bool SleepManager::Enabled() const
+{
+  return this->dataPtr->enabled;
+}
+
+/////////////////////////////////////////////////
+void SleepManager::SetLinearThreshold(const double _threshold)
+{
+  this->dataPtr->linearThreshold = _threshold;
+  this->dataPtr->paramsChanged();
+}
+
+/////////////////////////////////////////////////
+double SleepManager::LinearThreshold() const
+{
+  return this->dataPtr->linearThreshold;
+}
+
+/////////////////////////////////////////////////
+void SleepManager::SetAngularThreshold(const double _threshold)
+{
+  this->dataPtr->angularThreshold = _threshold;
+  this->dataPtr->paramsChanged();
+}
+
+/////////////////////////////////////////////////
+double SleepManager::AngularThreshold() const
+{
+  return this->dataPtr->angularThreshold;
+}
+
+/////////////////////////////////////////////////
+void SleepManager::SetIdleTime(const double _time)
+{
+  this->dataPtr->idleTime = _time;
+  this->dataPtr->paramsChanged();
+}
+
+/////////////////////////////////////////////////
+double SleepManager::IdleTime() const
+{
+  return this->dataPtr->idleTime;
+}
+
+/////////////////////////////////////////////////
+event::ConnectionPtr SleepManager::ConnectParamsChanged(
+    std::function<void ()> _subscriber)
+{
+  return this->dataPtr->paramsChanged.Connect(_subscriber);
+}
+
+/////////////////////////////////////////////////
+void SleepManager::Update(const double _dt)
+{
+  if (this->dataPtr->native || !this->dataPtr->enabled ||
+      !this->dataPtr->world)
+  {
+    return;
+  }
+
+  const double linear = this->dataPtr->linearThreshold;
+  const double angular = this->dataPtr->angularThreshold;
+
+  ForEachLink(this->dataPtr->world->Models(),
+      [&](const ModelPtr &_model, const LinkPtr &_link)
+      {
+        // Same rule as ODE auto-disable
+        if (!_model->GetAutoDisable() || _model->GetJointCount() > 0 ||
+            _link->IsStatic() || _link->GetKinematic())
+        {
+          return;
+        }
+
+        const bool resting =
+          _link->WorldLinearVel().Length() < linear &&
+          _link->WorldAngularVel().Length() < angular;
+
+        if (_link->Sleeping())
+        {
+          // Also wake it up when it lost all the contacts it rested on
+          auto supportsIter = this->dataPtr->supports.find(_link.get());
+          const bool unsupported =
+            supportsIter != this->dataPtr->supports.end() &&
+            !supportsIter->second.empty() &&
+            this->dataPtr->touched.count(_link.get()) == 0;
+
+          if (!resting || unsupported)
+            this->Wake(_link.get());
+          return;
+        }
+
+        double &restTime = this->dataPtr->restTimes[_link.get()];
+        if (!resting)
+        {
+          restTime = 0;
+          return;
+        }
+
+        restTime += _dt;
+        if (restTime >= this->dataPtr->idleTime)
+        {
+          this->SetSleeping(_link.get(), true);
+          HoldStill(_link);
+        }
+      });
+
+  this->dataPtr->touched.clear();
+}
+
+/////////////////////////////////////////////////
+void SleepManager::Wake(Link *_link)
+{
+  if (!_link)
+    return;
+
+  ModelPtr model = _link->GetModel();
+  if (!model)
+  {
+    this->SetSleeping(_link, false);
+    return;
+  }
+
+  // The links of a model are woken up together, as an island
+  for (const auto &link : model->GetLinks())
+  {
+    if (this->dataPtr->native)
+    {
+      // The engine reports the transition through SetSleeping
+      link->SetEnabled(true);
+    }
+    else
+    {
+      this->dataPtr->restTimes[link.get()] = 0;
+      this->SetSleeping(link.get(), false);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void SleepManager::SetSleeping(const Link *_link, const bool _sleeping)
+{
+  if (!_link || !_link->SetSleeping(_sleeping))
+    return;
+
+  if (_sleeping)
+  {
+    ++this->dataPtr->sleepingCount;
+    ++this->dataPtr->sleepCount;
+  }
+  else
+  {
+    if (!this->dataPtr->native)
+      this->dataPtr->supports.erase(_link);
+    --this->dataPtr->sleepingCount;
+    ++this->dataPtr->wakeCount;
+  }
+}
+
+/////////////////////////////////////////////////
+void SleepManager::RemoveLink(const Link *_link)
+{
+  if (!_link)
+    return;
+
+  this->dataPtr->restTimes.erase(_link);
+  this->dataPtr->touched.erase(_link);
+
+  // The links resting on the removed link lost their support
+  std::vector<const Link *> supported;
+  for (auto &support : this->dataPtr->supports)
+  {
+    if (support.second.erase(_link) > 0)
+      supported.push_back(support.first);
+  }
+  for (const auto &link : supported)
+    this->Wake(const_cast<Link *>(link));
+
+  this->dataPtr->supports.erase(_link);
+  if (_link->SetSleeping(false))
+    --this->dataPtr->sleepingCount;
+}
+
+/////////////////////////////////////////////////
+bool SleepManager::Resting(Collision *_collision1, Collision *_collision2)
+{
+  if (!_collision1 || !_collision2)
+    return false;
+
+  LinkPtr link1 = _collision1->GetLink();
+  LinkPtr link2 = _collision2->GetLink();
+  const bool sleeping1 = link1 && link1->Sleeping();
+  const bool sleeping2 = link2 && link2->Sleeping();
+  if (!sleeping1 && !sleeping2)
+    return false;
+
+  const bool static1 = !link1 || link1->IsStatic();
+  const bool static2 = !link2 || link2->IsStatic();
+  if ((sleeping1 || static1) && (sleeping2 || static2))
+  {
+    // Remember what the sleeping links rest on, to wake them up when the
+    // contact disappears.
+    if (!this->dataPtr->native)
+    {
+      if (sleeping1)
+      {
+        this->dataPtr->touched.insert(link1.get());
+        if (link2)
+          this->dataPtr->supports[link1.get()].insert(link2.get());
+      }
+      if (sleeping2)
+      {
+        this->dataPtr->touched.insert(link2.get());
+        if (link1)
+          this->dataPtr->supports[link2.get()].insert(link1.get());
+      }
+    }
+    return true;
+  }
+
+  // A sleeping link touches an awake dynamic link. Native engines wake
+  // their islands up themselves.
+  if (!this->dataPtr->native)
+  {
+    const LinkPtr &other = sleeping1 ? link2 : link1;
+
+    // Only wake it up if the other link moves, otherwise two touching
+    // links at rest would keep each other awake.
+    if (other->WorldLinearVel().Length() >= this->dataPtr->linearThreshold ||
+        other->WorldAngularVel().Length() >= this->dataPtr->angularThreshold)
+    {
+      this->Wake(sleeping1 ? link1.get() : link2.get());
+    }
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+unsigned int SleepManager::SleepingCount() const
+{
+  return this->dataPtr->sleepingCount;
+}
+
+/////////////////////////////////////////////////
+uint64_t SleepManager::SleepCount() const
+{
+  return this->dataPtr->sleepCount;
+}
+
+/////////////////////////////////////////////////
+uint64_t SleepManager::WakeCount() const
+{
+  return this->dataPtr->wakeCount;
+}
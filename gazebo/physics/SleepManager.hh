@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_SLEEPMANAGER_HH_
+#define GAZEBO_PHYSICS_SLEEPMANAGER_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <sdf/sdf.hh>
+
+#include "gazebo/common/Event.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class
+    class SleepManagerPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class SleepManager SleepManager.hh physics/physics.hh
+    /// \brief Puts the links that are at rest to sleep, and wakes them up
+    /// when they are touched or pushed. Sleeping links are skipped by the
+    /// joint updates of their model, by the pose propagation, by the world
+    /// state capture and by the contact manager.
+    ///
+    /// A link is at rest when its linear and angular velocities stay below
+    /// thresholds for some time. Like ODE auto-disable, only the links of
+    /// models that allow auto-disable and have no joints are put to sleep,
+    /// and the links of a model are woken up together.
+    ///
+    /// Physics engines that sleep bodies themselves (ODE) are native: they
+    /// apply the thresholds, which they receive through
+    /// ConnectParamsChanged, and report the transitions of their bodies
+    /// with SetSleeping. For the other engines Update compares the link
+    /// velocities against the thresholds after each step; their sleeping
+    /// links are still simulated by the engine, so a force that keeps
+    /// pushing them wakes them up once they move. They are also woken up
+    /// when the contacts they rest on disappear.
+    ///
+    /// The thresholds are read from the optional gz:sleep element of the
+    /// physics element:
+    /// \code
+    /// <physics type="ode">
+    ///   <gz:sleep>
+    ///     <enabled>true</enabled>
+    ///     <linear_threshold>0.1</linear_threshold>
+    ///     <angular_threshold>0.1</angular_threshold>
+    ///     <time>1</time>
+    ///   </gz:sleep>
+    /// </physics>
+    /// \endcode
+    class GZ_PHYSICS_VISIBLE SleepManager
+    {
+      /// \brief Constructor.
+      public: SleepManager();
+
+      /// \brief Destructor.
+      public: virtual ~SleepManager();
+
+      /// \brief Initialize the sleep manager.
+      /// \param[in] _world Pointer to the world.
+      public: void Init(WorldPtr _world);
+
+      /// \brief Load the parameters from the physics element.
+      /// \param[in] _sdf The physics element.
+      public: void Load(sdf::ElementPtr _sdf);
+
+      /// \brief Set whether the physics engine sleeps the bodies itself.
+      /// Set by the physics engine before the world is loaded.
+      /// \param[in] _native True if the engine sleeps the bodies.
+      public: void SetNative(const bool _native);
+
+      /// \brief Get whether the physics engine sleeps the bodies itself.
+      /// \return True if the engine sleeps the bodies.
+      public: bool Native() const;
+
+      /// \brief Enable or disable sleeping. Disabling it wakes up all the
+      /// links. Enabled by default for native engines only.
+      /// \param[in] _enabled True to enable sleeping.
+      public: void SetEnabled(const bool _enabled);
+
+      /// \brief Get whether sleeping is enabled.
+      /// \return True if sleeping is enabled.
+      public: bool Enabled() const;
+
+      /// \brief Set the linear velocity under which a link is at rest.
+      /// \param[in] _threshold Linear velocity in m/s.
+      public: void SetLinearThreshold(const double _threshold);
+
+      /// \brief Get the linear velocity under which a link is at rest.
+      /// \return Linear velocity in m/s.
+      public: double LinearThreshold() const;
+
+      /// \brief Set the angular velocity under which a link is at rest.
+      /// \param[in] _threshold Angular velocity in rad/s.
+      public: void SetAngularThreshold(const double _threshold);
+
+      /// \brief Get the angular velocity under which a link is at rest.
+      /// \return Angular velocity in rad/s.
+      public: double AngularThreshold() const;
+
+      /// \brief Set how long a link must be at rest before it sleeps.
+      /// \param[in] _time Time in seconds.
+      public: void SetIdleTime(const double _time);
+
+      /// \brief Get how long a link must be at rest before it sleeps.
+      /// \return Time in seconds.
+      public: double IdleTime() const;
+
+      /// \brief Connect to the signal emitted when a parameter changes.
+      /// \param[in] _subscriber Callback function.
+      /// \return Pointer to the connection, which must be kept in scope.
+      public: event::ConnectionPtr ConnectParamsChanged(
+                  std::function<void ()> _subscriber);
+
+      /// \brief Put the links at rest to sleep and wake up the links that
+      /// moved. Called by the world after each physics step; does nothing
+      /// for native engines.
+      /// \param[in] _dt Duration of the step in seconds.
+      public: void Update(const double _dt);
+
+      /// \brief Wake up a link and the other links of its model.
+      /// \param[in] _link The link.
+      public: void Wake(Link *_link);
+
+      /// \brief Set whether a link sleeps, and count the transition. Native
+      /// engines call it when their bodies are disabled or enabled. It can
+      /// be called from the threads of the physics engine.
+      /// \param[in] _link The link.
+      /// \param[in] _sleeping True if the link sleeps.
+      public: void SetSleeping(const Link *_link, const bool _sleeping);
+
+      /// \brief Forget a link that is being removed, without counting it as
+      /// woken up. The links that rest on it are woken up.
+      /// \param[in] _link The link.
+      public: void RemoveLink(const Link *_link);
+
+      /// \brief Called by the contact manager for each new contact. Wakes
+      /// up a sleeping link touched by a moving link, and records the
+      /// links a sleeping link rests on.
+      /// \param[in] _collision1 First collision of the contact.
+      /// \param[in] _collision2 Second collision of the contact.
+      /// \return True if the contact is between links that sleep, or
+      /// between a sleeping link and a static one.
+      public: bool Resting(Collision *_collision1, Collision *_collision2);
+
+      /// \brief Get the number of links that sleep.
+      /// \return Number of sleeping links.
+      public: unsigned int SleepingCount() const;
+
+      /// \brief Get the number of times links were put to sleep.
+      /// \return Number of sleep transitions.
+      public: uint64_t SleepCount() const;
+
+      /// \brief Get the number of times links were woken up.
+      /// \return Number of wake transitions.
+      public: uint64_t WakeCount() const;
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SleepManagerPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
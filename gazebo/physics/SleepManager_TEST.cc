@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+
+#include "gazebo/gazebo_config.h"
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/SleepManager.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+class SleepManagerTest : public ServerFixture
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, Params)
+{
+  Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::PhysicsEnginePtr physics = world->Physics();
+  ASSERT_TRUE(physics != nullptr);
+
+  physics::SleepManager *manager = physics->GetSleepManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // ODE puts the bodies to sleep itself, and does it by default
+  EXPECT_TRUE(manager->Native());
+  EXPECT_TRUE(manager->Enabled());
+  EXPECT_DOUBLE_EQ(manager->LinearThreshold(), 0.1);
+  EXPECT_DOUBLE_EQ(manager->AngularThreshold(), 0.1);
+  EXPECT_DOUBLE_EQ(manager->IdleTime(), 1.0);
+
+  int changes = 0;
+  event::ConnectionPtr connection = manager->ConnectParamsChanged(
+      [&changes]() { ++changes; });
+
+  EXPECT_TRUE(physics->SetParam("sleep_linear_threshold", 0.2));
+  EXPECT_TRUE(physics->SetParam("sleep_angular_threshold", 0.3));
+  EXPECT_TRUE(physics->SetParam("sleep_time", 0.5));
+  EXPECT_TRUE(physics->SetParam("sleep", false));
+  EXPECT_EQ(changes, 4);
+
+  EXPECT_DOUBLE_EQ(boost::any_cast<double>(
+        physics->GetParam("sleep_linear_threshold")), 0.2);
+  EXPECT_DOUBLE_EQ(boost::any_cast<double>(
+        physics->GetParam("sleep_angular_threshold")), 0.3);
+  EXPECT_DOUBLE_EQ(boost::any_cast<double>(
+        physics->GetParam("sleep_time")), 0.5);
+  EXPECT_FALSE(boost::any_cast<bool>(physics->GetParam("sleep")));
+}
+
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, SleepAndWake)
+{
+  Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::SleepManager *manager = world->Physics()->GetSleepManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  // Drop a box on the ground
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.6), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  EXPECT_FALSE(link->Sleeping());
+  EXPECT_FALSE(model->Sleeping());
+  EXPECT_EQ(manager->SleepingCount(), 0u);
+
+  // It sleeps after a second at rest
+  world->Step(2500);
+  EXPECT_TRUE(link->Sleeping());
+  EXPECT_TRUE(model->Sleeping());
+  EXPECT_EQ(manager->SleepingCount(), 1u);
+  EXPECT_EQ(manager->SleepCount(), 1u);
+  EXPECT_EQ(manager->WakeCount(), 0u);
+
+  // Pushing it wakes it up
+  link->SetForce(ignition::math::Vector3d(100, 0, 0));
+  EXPECT_FALSE(link->Sleeping());
+  EXPECT_FALSE(model->Sleeping());
+  EXPECT_EQ(manager->SleepingCount(), 0u);
+  EXPECT_EQ(manager->WakeCount(), 1u);
+
+  // Disabling sleeping keeps it awake
+  world->Physics()->SetParam("sleep", false);
+  world->Step(2500);
+  EXPECT_FALSE(link->Sleeping());
+  EXPECT_EQ(manager->SleepCount(), 1u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, RestoreSnapshot)
+{
+  Load("worlds/empty.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::SleepManager *manager = world->Physics()->GetSleepManager();
+  ASSERT_TRUE(manager != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.6), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  // Save while asleep
+  world->Step(2500);
+  ASSERT_TRUE(link->Sleeping());
+  std::string asleep;
+  world->SaveSnapshot(asleep);
+
+  // Wake it up and save while awake
+  link->SetForce(ignition::math::Vector3d(100, 0, 0));
+  world->Step(1);
+  EXPECT_FALSE(link->Sleeping());
+  std::string awake;
+  world->SaveSnapshot(awake);
+
+  // Restoring applies the saved state, not the one of the last move
+  EXPECT_TRUE(world->RestoreSnapshot(asleep));
+  EXPECT_TRUE(link->Sleeping());
+  EXPECT_TRUE(model->Sleeping());
+  EXPECT_EQ(manager->SleepingCount(), 1u);
+
+  EXPECT_TRUE(world->RestoreSnapshot(awake));
+  EXPECT_FALSE(link->Sleeping());
+  EXPECT_EQ(manager->SleepingCount(), 0u);
+}
+
+#ifdef HAVE_DART
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, DARTSlowDrift)
+{
+  Load("worlds/empty.world", true, "dart");
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::SleepManager *manager = world->Physics()->GetSleepManager();
+  ASSERT_TRUE(manager != nullptr);
+  EXPECT_FALSE(manager->Native());
+  manager->SetEnabled(true);
+
+  // Without gravity, a box sliding slower than the linear threshold never
+  // stops on its own
+  world->SetGravity(ignition::math::Vector3d::Zero);
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+  model->SetLinearVel(ignition::math::Vector3d(0.05, 0, 0));
+
+  world->Step(1500);
+  ASSERT_TRUE(link->Sleeping());
+  EXPECT_EQ(link->WorldLinearVel(), ignition::math::Vector3d::Zero);
+  const ignition::math::Pose3d pose = link->WorldPose();
+  EXPECT_GT(pose.Pos().X(), 0.0);
+
+  // The box stays where it fell asleep, in DART too since its pose keeps
+  // being read back
+  world->Step(1000);
+  EXPECT_TRUE(link->Sleeping());
+  EXPECT_NEAR(link->WorldPose().Pos().X(), pose.Pos().X(), 1e-6);
+  EXPECT_EQ(link->WorldLinearVel(), ignition::math::Vector3d::Zero);
+
+  // It still wakes up when pushed
+  link->SetLinearVel(ignition::math::Vector3d(1, 0, 0));
+  world->Step(1);
+  EXPECT_FALSE(link->Sleeping());
+  world->Step(100);
+  EXPECT_GT(link->WorldPose().Pos().X(), pose.Pos().X() + 0.05);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, DARTSmallConstantForce)
+{
+  Load("worlds/empty.world", true, "dart");
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::SleepManager *manager = world->Physics()->GetSleepManager();
+  ASSERT_TRUE(manager != nullptr);
+  manager->SetEnabled(true);
+
+  world->SetGravity(ignition::math::Vector3d::Zero);
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 5), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  world->Step(1500);
+  ASSERT_TRUE(link->Sleeping());
+  const ignition::math::Pose3d pose = link->WorldPose();
+
+  // A force too small to exceed the thresholds in a step still wakes the
+  // box up, and keeps pushing it
+  event::ConnectionPtr connection = world->ConnectWorldUpdateBegin(
+      [&link](const common::UpdateInfo &)
+      {
+        link->AddForce(ignition::math::Vector3d(0.05, 0, 0));
+      });
+  world->Step(1);
+  EXPECT_FALSE(link->Sleeping());
+
+  world->Step(2000);
+  EXPECT_GT(link->WorldPose().Pos().X(), pose.Pos().X() + 0.05);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SleepManagerTest, DARTRemovedSupport)
+{
+  Load("worlds/empty.world", true, "dart");
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::SleepManager *manager = world->Physics()->GetSleepManager();
+  ASSERT_TRUE(manager != nullptr);
+  manager->SetEnabled(true);
+
+  // A box resting on a static box
+  SpawnBox("support", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 1.6), ignition::math::Vector3d::Zero);
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::LinkPtr link = model->GetLink();
+  ASSERT_TRUE(link != nullptr);
+
+  world->Step(2500);
+  ASSERT_TRUE(link->Sleeping());
+  const double z = link->WorldPose().Pos().Z();
+  EXPECT_NEAR(z, 1.5, 0.05);
+
+  // Removing the support wakes the box up, and it falls to the ground
+  world->RemoveModel("support");
+  EXPECT_FALSE(link->Sleeping());
+
+  world->Step(1000);
+  EXPECT_NEAR(link->WorldPose().Pos().Z(), 0.5, 0.05);
+}
+#endif
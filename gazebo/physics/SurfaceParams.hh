@@ -17,6 +17,8 @@
 #ifndef GAZEBO_PHYSICS_SURFACEPARAMS_HH_
 #define GAZEBO_PHYSICS_SURFACEPARAMS_HH_
 
+#include <functional>
+
 #include <sdf/sdf.hh>
 #include <ignition/math/Vector3.hh>
 
@@ -200,6 +202,59 @@ namespace gazebo
       /// collideWithoutContact.
       public: unsigned int collideBitmask;
     };
+
+    /// \class ContactSurface SurfaceParams.hh physics/physics.hh
+    /// \brief Surface of a single contact point, given to the contact
+    /// surface callbacks of the colliding collisions right before the
+    /// physics engine creates the contact constraint. The callbacks may
+    /// change the friction and motion values, which are then used by the
+    /// constraint. All vectors are in the world frame.
+    /// \sa Collision::SetContactSurfaceFunc
+    class GZ_PHYSICS_VISIBLE ContactSurface
+    {
+      /// \brief First collision of the contact.
+      public: Collision *collision1 = nullptr;
+
+      /// \brief Second collision of the contact.
+      public: Collision *collision2 = nullptr;
+
+      /// \brief Position of the contact point.
+      public: ignition::math::Vector3d position;
+
+      /// \brief Contact normal, as reported by the physics engine. Its
+      /// orientation depends on the engine and on the collision shapes.
+      public: ignition::math::Vector3d normal;
+
+      /// \brief Penetration depth.
+      public: double depth = 0;
+
+      /// \brief Primary friction direction, zero to let the physics engine
+      /// choose it.
+      public: ignition::math::Vector3d frictionDirection1;
+
+      /// \brief Friction coefficient along the primary direction.
+      public: double mu1 = 0;
+
+      /// \brief Friction coefficient along the secondary direction.
+      public: double mu2 = 0;
+
+      /// \brief Slip along the primary direction, combined for the two
+      /// surfaces.
+      public: double slip1 = 0;
+
+      /// \brief Slip along the secondary direction, combined for the two
+      /// surfaces.
+      public: double slip2 = 0;
+
+      /// \brief Surface velocity along the primary friction direction.
+      public: double motion1 = 0;
+
+      /// \brief Surface velocity along the secondary friction direction.
+      public: double motion2 = 0;
+    };
+
+    /// \brief Callback editing the surface of a contact point.
+    using ContactSurfaceFunc = std::function<void(ContactSurface &)>;
     /// \}
   }
 }
@@ -19,6 +19,8 @@
 
 #include "gazebo/transport/transport.hh"
 
+#include "gazebo/physics/Light.hh"
+#include "gazebo/physics/Model.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/WorldState.hh"
 
@@ -28,6 +30,120 @@
 using namespace gazebo;
 using namespace physics;
 
+/////////////////////////////////////////////////
+/// \brief Estimate the memory used by a map node, besides its value.
+/// \param[in] _key Key of the node.
+/// \return Size in bytes.
+static size_t NodeSize(const std::string &_key)
+{
+  // Red-black tree node header: color, parent, left and right.
+  return 4 * sizeof(void *) + sizeof(std::string) + _key.capacity();
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the memory used by a link state.
+/// \param[in] _state Link state.
+/// \return Size in bytes.
+static size_t StateSize(const LinkState &_state)
+{
+  size_t size = sizeof(LinkState) + _state.GetName().size();
+
+  const std::vector<CollisionState> &collisions = _state.GetCollisionStates();
+  size += collisions.capacity() * sizeof(CollisionState);
+  for (auto const &collision : collisions)
+    size += collision.GetName().size();
+
+  return size;
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the memory used by a joint state.
+/// \param[in] _state Joint state.
+/// \return Size in bytes.
+static size_t StateSize(const JointState &_state)
+{
+  return sizeof(JointState) + _state.GetName().size() +
+    _state.Positions().capacity() * sizeof(double);
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the memory used by a model state, including the
+/// names and the nested states it holds.
+/// \param[in] _state Model state.
+/// \return Size in bytes.
+static size_t StateSize(const ModelState &_state)
+{
+  size_t size = sizeof(ModelState) + _state.GetName().size();
+
+  for (auto const &link : _state.GetLinkStates())
+    size += NodeSize(link.first) + StateSize(link.second);
+
+  for (auto const &joint : _state.GetJointStates())
+    size += NodeSize(joint.first) + StateSize(joint.second);
+
+  for (auto const &nested : _state.NestedModelStates())
+    size += NodeSize(nested.first) + StateSize(nested.second);
+
+  return size;
+}
+
+/////////////////////////////////////////////////
+/// \brief Estimate the heap memory used by a world state, that is
+/// everything but sizeof(WorldState).
+/// \param[in] _state World state.
+/// \return Size in bytes.
+static size_t HeapSize(const WorldState &_state)
+{
+  size_t size = _state.GetName().size();
+
+  for (auto const &model : _state.GetModelStates())
+    size += NodeSize(model.first) + StateSize(model.second);
+
+  for (auto const &light : _state.LightStates())
+  {
+    size += NodeSize(light.first) + sizeof(LightState) +
+      light.second.GetName().size();
+  }
+
+  for (auto const &insertion : _state.Insertions())
+    size += sizeof(std::string) + insertion.capacity();
+
+  for (auto const &deletion : _state.Deletions())
+    size += sizeof(std::string) + deletion.capacity();
+
+  return size;
+}
+
+/////////////////////////////////////////////////
+/// \brief Set the states of the models and lights in a sparse world state,
+/// leaving the world clock and every other entity untouched.
+/// \param[in] _world World to update.
+/// \param[in] _state Sparse world state.
+static void SetEntityStates(const WorldPtr &_world, const WorldState &_state)
+{
+  for (auto const &modelState : _state.GetModelStates())
+  {
+    ModelPtr model = _world->ModelByName(modelState.first);
+    if (model)
+      model->SetState(modelState.second);
+  }
+
+  for (auto const &lightState : _state.LightStates())
+  {
+    LightPtr light = _world->LightByName(lightState.first);
+    if (light)
+      light->SetState(lightState.second);
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the name of the top level model of an entity.
+/// \param[in] _name Scoped name of the entity.
+/// \return Name of the top level model.
+static std::string TopLevelName(const std::string &_name)
+{
+  return _name.substr(0, _name.find("::"));
+}
 
 /////////////////////////////////////////////////
 UserCmd::UserCmd(const unsigned int _id,
@@ -45,6 +161,26 @@ UserCmd::UserCmd(const unsigned int _id,
   this->dataPtr->startState = WorldState(this->dataPtr->world);
 }
 
+/////////////////////////////////////////////////
+UserCmd::UserCmd(const unsigned int _id,
+                 physics::WorldPtr _world,
+                 const std::string &_description,
+                 const msgs::UserCmd::Type &_type,
+                 const std::set<std::string> &_entities)
+  : dataPtr(new UserCmdPrivate())
+{
+  this->dataPtr->id = _id;
+  this->dataPtr->world = _world;
+  this->dataPtr->description = _description;
+  this->dataPtr->type = _type;
+  this->dataPtr->wholeWorld = false;
+  this->dataPtr->entities = _entities;
+
+  // Record the current state of the affected entities
+  this->dataPtr->startState.LoadEntities(this->dataPtr->world,
+      this->dataPtr->entities);
+}
+
 /////////////////////////////////////////////////
 UserCmd::~UserCmd()
 {
@@ -60,23 +196,42 @@ UserCmd::~UserCmd()
 void UserCmd::Undo()
 {
   // Record / override the state for redo
-  this->dataPtr->endState = WorldState(this->dataPtr->world);
+  if (this->dataPtr->wholeWorld)
+  {
+    this->dataPtr->endState = WorldState(this->dataPtr->world);
 
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
+    // Reset physics states for the whole world
+    this->dataPtr->world->ResetPhysicsStates();
+  }
+  else
+  {
+    this->dataPtr->endState.LoadEntities(this->dataPtr->world,
+        this->dataPtr->entities);
+    this->ResetPhysicsStates();
+  }
 
-  // Set state to the moment the command was executed
-  this->dataPtr->world->SetState(this->dataPtr->startState);
+  // Set state to the moment the command was executed. A sparse command
+  // doesn't rewind the world clock.
+  if (this->dataPtr->wholeWorld)
+    this->dataPtr->world->SetState(this->dataPtr->startState);
+  else
+    SetEntityStates(this->dataPtr->world, this->dataPtr->startState);
 }
 
 /////////////////////////////////////////////////
 void UserCmd::Redo()
 {
-  // Reset physics states for the whole world
-  this->dataPtr->world->ResetPhysicsStates();
+  // Reset physics states of the affected entities
+  if (this->dataPtr->wholeWorld)
+    this->dataPtr->world->ResetPhysicsStates();
+  else
+    this->ResetPhysicsStates();
 
   // Set state to the moment undo was triggered
-  this->dataPtr->world->SetState(this->dataPtr->endState);
+  if (this->dataPtr->wholeWorld)
+    this->dataPtr->world->SetState(this->dataPtr->endState);
+  else
+    SetEntityStates(this->dataPtr->world, this->dataPtr->endState);
 }
 
 /////////////////////////////////////////////////
@@ -97,6 +252,29 @@ msgs::UserCmd::Type UserCmd::Type() const
   return this->dataPtr->type;
 }
 
+/////////////////////////////////////////////////
+size_t UserCmd::MemorySize() const
+{
+  size_t size = sizeof(UserCmdPrivate) + this->dataPtr->description.size() +
+    HeapSize(this->dataPtr->startState) + HeapSize(this->dataPtr->endState);
+
+  for (auto const &entity : this->dataPtr->entities)
+    size += NodeSize(entity);
+
+  return size;
+}
+
+/////////////////////////////////////////////////
+void UserCmd::ResetPhysicsStates()
+{
+  for (auto const &entityName : this->dataPtr->entities)
+  {
+    ModelPtr model = this->dataPtr->world->ModelByName(entityName);
+    if (model)
+      model->ResetPhysicsStates();
+  }
+}
+
 /////////////////////////////////////////////////
 UserCmdManager::UserCmdManager(const WorldPtr _world)
   : dataPtr(new UserCmdManagerPrivate())
@@ -160,9 +338,50 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
   // Generate unique id
   unsigned int id = this->dataPtr->idCounter++;
 
+  // Commands which only touch a few entities record just their state.
+  std::set<std::string> entities;
+  bool wholeWorld = false;
+  switch (_msg->type())
+  {
+    case msgs::UserCmd::MOVING:
+    case msgs::UserCmd::SCALING:
+    {
+      for (int i = 0; i < _msg->model_size(); ++i)
+        entities.insert(TopLevelName(_msg->model(i).name()));
+
+      for (int i = 0; i < _msg->light_size(); ++i)
+        entities.insert(_msg->light(i).name());
+
+      break;
+    }
+    case msgs::UserCmd::WRENCH:
+    {
+      entities.insert(TopLevelName(_msg->entity_name()));
+      break;
+    }
+    default:
+    {
+      wholeWorld = true;
+      break;
+    }
+  }
+
+  // Without named entities there is no telling what the command touches
+  if (entities.empty())
+    wholeWorld = true;
+
   // Create command
-  UserCmdPtr cmd(new UserCmd(id, this->dataPtr->world, _msg->description(),
-      _msg->type()));
+  UserCmdPtr cmd;
+  if (wholeWorld)
+  {
+    cmd.reset(new UserCmd(id, this->dataPtr->world, _msg->description(),
+        _msg->type()));
+  }
+  else
+  {
+    cmd.reset(new UserCmd(id, this->dataPtr->world, _msg->description(),
+        _msg->type(), entities));
+  }
 
   // Forward message after we've saved the current state
   switch (_msg->type())
@@ -220,11 +439,17 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
     }
   }
 
-  // Add it to undo list
-  this->dataPtr->undoCmds.push_back(cmd);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->cmdMutex);
 
-  // Clear redo list
-  this->dataPtr->redoCmds.clear();
+    // Add it to undo list
+    this->dataPtr->undoCmds.push_back(cmd);
+
+    // Clear redo list
+    this->dataPtr->redoCmds.clear();
+
+    this->EvictCommands();
+  }
 
   // Publish stats
   this->PublishCurrentStats();
@@ -233,6 +458,8 @@ void UserCmdManager::OnUserCmdMsg(ConstUserCmdPtr &_msg)
 /////////////////////////////////////////////////
 void UserCmdManager::OnUndoRedoMsg(ConstUndoRedoPtr &_msg)
 {
+  std::unique_lock<std::mutex> lock(this->dataPtr->cmdMutex);
+
   // Undo
   if (_msg->undo())
   {
@@ -328,14 +555,77 @@ void UserCmdManager::OnUndoRedoMsg(ConstUndoRedoPtr &_msg)
     }
   }
 
+  // Undo records the state for redo, which may grow the history
+  this->EvictCommands();
+  lock.unlock();
+
   this->PublishCurrentStats();
 }
 
+/////////////////////////////////////////////////
+void UserCmdManager::SetMemoryBudget(const size_t _bytes)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cmdMutex);
+  this->dataPtr->memoryBudget = _bytes;
+  this->EvictCommands();
+}
+
+/////////////////////////////////////////////////
+size_t UserCmdManager::MemoryBudget() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cmdMutex);
+  return this->dataPtr->memoryBudget;
+}
+
+/////////////////////////////////////////////////
+size_t UserCmdManager::MemoryUsage() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->cmdMutex);
+
+  size_t usage = 0;
+  for (auto const &cmd : this->dataPtr->undoCmds)
+    usage += cmd->MemorySize();
+  for (auto const &cmd : this->dataPtr->redoCmds)
+    usage += cmd->MemorySize();
+
+  return usage;
+}
+
+/////////////////////////////////////////////////
+void UserCmdManager::EvictCommands()
+{
+  size_t usage = 0;
+  for (auto const &cmd : this->dataPtr->undoCmds)
+    usage += cmd->MemorySize();
+  for (auto const &cmd : this->dataPtr->redoCmds)
+    usage += cmd->MemorySize();
+
+  // Drop the oldest commands first: the front of the undo list, then the
+  // far end of the redo list. The most recent command is always kept.
+  auto evict = [&](std::vector<UserCmdPtr> &_cmds)
+  {
+    size_t count = 0;
+    while (usage > this->dataPtr->memoryBudget && count < _cmds.size() &&
+        this->dataPtr->undoCmds.size() + this->dataPtr->redoCmds.size() >
+        count + 1)
+    {
+      usage -= _cmds[count]->MemorySize();
+      ++count;
+    }
+    _cmds.erase(_cmds.begin(), _cmds.begin() + count);
+  };
+
+  evict(this->dataPtr->undoCmds);
+  evict(this->dataPtr->redoCmds);
+}
+
 /////////////////////////////////////////////////
 void UserCmdManager::PublishCurrentStats()
 {
   msgs::UserCmdStats statsMsg;
 
+  std::lock_guard<std::mutex> lock(this->dataPtr->cmdMutex);
+
   statsMsg.set_undo_cmd_count(this->dataPtr->undoCmds.size());
   statsMsg.set_redo_cmd_count(this->dataPtr->redoCmds.size());
 
@@ -17,6 +17,7 @@
 #ifndef GAZEBO_PHYSICS_USERCMDMANAGER_HH_
 #define GAZEBO_PHYSICS_USERCMDMANAGER_HH_
 
+#include <set>
 #include <string>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -45,6 +46,22 @@ namespace gazebo
                       const std::string &_description,
                       const msgs::UserCmd::Type &_type);
 
+      /// \brief Constructor for a command which only affects some entities.
+      /// Only the state of those entities is recorded for undo and redo.
+      /// Undo and redo don't change the world clock.
+      /// \param[in] _id Unique ID for this command
+      /// \param[in] _world Pointer to the world
+      /// \param[in] _description Description for the command, such as
+      /// "Rotate box", "Delete sphere", etc.
+      /// \param[in] _type Type of command, such as MOVING, DELETING, etc.
+      /// \param[in] _entities Names of the top level models and lights
+      /// affected by the command.
+      public: UserCmd(const unsigned int _id,
+                      physics::WorldPtr _world,
+                      const std::string &_description,
+                      const msgs::UserCmd::Type &_type,
+                      const std::set<std::string> &_entities);
+
       /// \brief Destructor
       public: virtual ~UserCmd();
 
@@ -66,6 +83,15 @@ namespace gazebo
       /// \return Command type
       public: msgs::UserCmd::Type Type() const;
 
+      /// \brief Return an estimate of the memory used by the states
+      /// recorded for this command.
+      /// \return Size in bytes.
+      public: size_t MemorySize() const;
+
+      /// \brief Reset the physics states of the entities affected by
+      /// this command.
+      private: void ResetPhysicsStates();
+
       /// \internal
       /// \brief Pointer to private data.
       protected: UserCmdPrivate *dataPtr;
@@ -83,6 +109,22 @@ namespace gazebo
       /// \brief Destructor.
       public: virtual ~UserCmdManager();
 
+      /// \brief Set the maximum memory used by the undo and redo history.
+      /// When a new command makes the history exceed this budget, the
+      /// oldest commands are dropped. The most recent command is always
+      /// kept.
+      /// \param[in] _bytes Budget in bytes.
+      public: void SetMemoryBudget(const size_t _bytes);
+
+      /// \brief Get the maximum memory used by the undo and redo history.
+      /// \return Budget in bytes.
+      public: size_t MemoryBudget() const;
+
+      /// \brief Get an estimate of the memory used by the undo and redo
+      /// history.
+      /// \return Size in bytes.
+      public: size_t MemoryUsage() const;
+
       /// \brief Callback when a UserCmd message is received, notifying that
       /// a new command has been executed by a user.
       /// \param[in] _msg Incoming message
@@ -96,6 +138,10 @@ namespace gazebo
       /// \brief Publish a message about current user command statistics.
       private: void PublishCurrentStats();
 
+      /// \brief Drop the oldest commands until the history fits in the
+      /// memory budget.
+      private: void EvictCommands();
+
       /// \internal
       /// \brief Pointer to private data.
       private: UserCmdManagerPrivate *dataPtr;
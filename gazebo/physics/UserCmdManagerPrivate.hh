@@ -17,6 +17,8 @@
 #ifndef _GAZEBO_USER_CMD_MANAGER_PRIVATE_HH_
 #define _GAZEBO_USER_CMD_MANAGER_PRIVATE_HH_
 
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 #include <sdf/sdf.hh>
@@ -24,13 +26,12 @@
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/Subscriber.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/physics/WorldState.hh"
 
 namespace gazebo
 {
   namespace physics
   {
-    class WorldState;
-
     /// \internal
     /// \brief Private data for the UserCmdManager class
     class UserCmdPrivate
@@ -38,13 +39,21 @@ namespace gazebo
       /// \brief Pointer to the world.
       public: WorldPtr world;
 
-      /// \brief Whole world state the moment the user command was executed.
+      /// \brief World state the moment the user command was executed.
+      /// Holds the whole world, or only the entities in \e entities.
       public: WorldState startState;
 
-      /// \brief Whole world state for the most recent time the user has
+      /// \brief World state for the most recent time the user has
       /// triggered undo for this command.
       public: WorldState endState;
 
+      /// \brief True if the command may affect the whole world, false if
+      /// it only affects the entities in \e entities.
+      public: bool wholeWorld = true;
+
+      /// \brief Names of the models and lights affected by the command.
+      public: std::set<std::string> entities;
+
       /// \brief Unique ID identifying this command in the server.
       public: unsigned int id;
 
@@ -93,6 +102,12 @@ namespace gazebo
 
       /// \brief List of commands which can be redone.
       public: std::vector<UserCmdPtr> redoCmds;
+
+      /// \brief Maximum memory used by the undo and redo history.
+      public: size_t memoryBudget = 64 * 1024 * 1024;
+
+      /// \brief Protects the command lists and the memory budget.
+      public: mutable std::mutex cmdMutex;
     };
   }
 }
@@ -15,6 +15,10 @@
  *
 */
 
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/test/ServerFixture.hh"
@@ -61,6 +65,159 @@ TEST_F(UserCmdManagerTest, CreateCmd)
   manager = NULL;
 }
 
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, SparseCmd)
+{
+  Load("test/worlds/empty_test.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  SpawnBox("box1", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero);
+  SpawnBox("box2", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(2, 0, 0.5), ignition::math::Vector3d::Zero);
+
+  physics::ModelPtr box1 = world->ModelByName("box1");
+  physics::ModelPtr box2 = world->ModelByName("box2");
+  ASSERT_TRUE(box1 != NULL);
+  ASSERT_TRUE(box2 != NULL);
+
+  // A command which only moves box1 records less than a whole world one
+  physics::UserCmd wholeCmd(0, world, "whole", msgs::UserCmd::WORLD_CONTROL);
+  physics::UserCmd sparseCmd(1, world, "sparse", msgs::UserCmd::MOVING,
+      {"box1"});
+  EXPECT_LT(sparseCmd.MemorySize(), wholeCmd.MemorySize());
+
+  // Move both boxes, undo only restores box1
+  auto pose1 = box1->WorldPose();
+  auto pose2 = box2->WorldPose();
+  box1->SetWorldPose(ignition::math::Pose3d(5, 5, 0.5, 0, 0, 0));
+  box2->SetWorldPose(ignition::math::Pose3d(-5, 5, 0.5, 0, 0, 0));
+
+  // Undo doesn't rewind the world clock either
+  world->Step(10);
+  const common::Time simTime = world->SimTime();
+  const uint64_t iterations = world->Iterations();
+
+  sparseCmd.Undo();
+  EXPECT_EQ(box1->WorldPose(), pose1);
+  EXPECT_NE(box2->WorldPose(), pose2);
+  EXPECT_EQ(world->SimTime(), simTime);
+  EXPECT_EQ(world->Iterations(), iterations);
+
+  // Redo moves box1 back
+  sparseCmd.Redo();
+  EXPECT_EQ(box1->WorldPose(), ignition::math::Pose3d(5, 5, 0.5, 0, 0, 0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, MemoryBudget)
+{
+  Load("test/worlds/empty_test.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::UserCmdManager manager(world);
+  EXPECT_GT(manager.MemoryBudget(), 0u);
+  EXPECT_EQ(manager.MemoryUsage(), 0u);
+
+  manager.SetMemoryBudget(1024);
+  EXPECT_EQ(manager.MemoryBudget(), 1024u);
+}
+
+/////////////////////////////////////////////////
+/// \brief Undo ids in the latest stats which don't start with the first
+/// command. The world's own manager publishes on the same topic, but it
+/// never evicts anything.
+static std::vector<unsigned int> g_undoIds;
+static std::mutex g_undoIdsMutex;
+
+/////////////////////////////////////////////////
+void OnUserCmdStats(ConstUserCmdStatsPtr &_msg)
+{
+  if (_msg->undo_cmd_size() == 0 || _msg->undo_cmd(0).id() == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(g_undoIdsMutex);
+  g_undoIds.clear();
+  for (int i = 0; i < _msg->undo_cmd_size(); ++i)
+    g_undoIds.push_back(_msg->undo_cmd(i).id());
+}
+
+/////////////////////////////////////////////////
+TEST_F(UserCmdManagerTest, EvictOldest)
+{
+  Load("test/worlds/empty_test.world", true);
+
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  const unsigned int cmdCount = 5;
+  for (unsigned int i = 0; i < cmdCount; ++i)
+  {
+    SpawnBox("box" + std::to_string(i), ignition::math::Vector3d::One,
+        ignition::math::Vector3d(2 * i, 0, 0.5),
+        ignition::math::Vector3d::Zero);
+  }
+
+  physics::UserCmdManager manager(world);
+
+  transport::NodePtr node(new transport::Node());
+  node->Init();
+  transport::PublisherPtr userCmdPub =
+    node->Advertise<msgs::UserCmd>("~/user_cmd");
+  transport::SubscriberPtr statsSub =
+    node->Subscribe("~/user_cmd_stats", &OnUserCmdStats);
+
+  // Move one box per command
+  auto moveBox = [&](const unsigned int _index)
+  {
+    msgs::UserCmd msg;
+    msg.set_description("move box" + std::to_string(_index));
+    msg.set_type(msgs::UserCmd::MOVING);
+    msgs::Model *modelMsg = msg.add_model();
+    modelMsg->set_name("box" + std::to_string(_index));
+    msgs::Set(modelMsg->mutable_pose(),
+        ignition::math::Pose3d(2 * _index, 3, 0.5, 0, 0, 0));
+    userCmdPub->Publish(msg);
+  };
+
+  // The first command sets the size of one record
+  moveBox(0);
+  for (int i = 0; i < 100 && manager.MemoryUsage() == 0u; ++i)
+    common::Time::MSleep(10);
+  const size_t cmdSize = manager.MemoryUsage();
+  ASSERT_GT(cmdSize, 0u);
+
+  // Room for two commands and a half
+  const size_t budget = cmdSize * 5 / 2;
+  manager.SetMemoryBudget(budget);
+
+  for (unsigned int i = 1; i < cmdCount; ++i)
+    moveBox(i);
+
+  // Wait for the manager to report the last command
+  std::vector<unsigned int> ids;
+  for (int i = 0; i < 100; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_undoIdsMutex);
+      ids = g_undoIds;
+    }
+    if (!ids.empty() && ids.back() == cmdCount - 1)
+      break;
+    common::Time::MSleep(10);
+  }
+
+  // Only the two most recent commands are kept
+  EXPECT_LE(manager.MemoryUsage(), budget);
+  ASSERT_EQ(ids.size(), 2u);
+  EXPECT_EQ(ids[0], cmdCount - 2);
+  EXPECT_EQ(ids[1], cmdCount - 1);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -15,18 +15,25 @@
  *
 */
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
+#include <mutex>
 #include <boost/lexical_cast.hpp>
 #include <sdf/sdf.hh>
 
+#include <ignition/math/Rand.hh>
 #include <ignition/math/Vector3.hh>
 
+#include "gazebo/common/Events.hh"
 #include "gazebo/transport/Node.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 #include "gazebo/physics/Entity.hh"
+#include "gazebo/physics/Link.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/WindField.hh"
 #include "gazebo/physics/World.hh"
 
 namespace gazebo
@@ -57,6 +64,52 @@ namespace gazebo
       public: std::function< ignition::math::Vector3d (
                   const Wind *, const Entity *)> linearVelFunc;
 
+      /// \brief True if linearVelFunc was set by the user, in which case
+      /// it is called for every link.
+      public: bool customLinearVelFunc = false;
+
+      /// \brief Function computing the wind velocity of all the links.
+      public: std::function<void (const Wind *,
+                  const std::vector<ignition::math::Vector3d> &,
+                  std::vector<ignition::math::Vector3d> &)> linearVelBatchFunc;
+
+      /// \brief Gridded wind field added to the global velocity.
+      public: WindField field;
+
+      /// \brief Standard deviation of the turbulence along each axis.
+      public: ignition::math::Vector3d turbulenceIntensity;
+
+      /// \brief Turbulence length scales along each axis.
+      public: ignition::math::Vector3d turbulenceLength =
+                  ignition::math::Vector3d(200, 200, 50);
+
+      /// \brief Protects the link arrays.
+      public: std::mutex linksMutex;
+
+      /// \brief Links whose wind velocity is updated.
+      public: std::vector<Link *> links;
+
+      /// \brief Incremented whenever a link is added or removed.
+      public: uint64_t linksVersion = 0;
+
+      /// \brief Copy of links used by Update while the lock is released.
+      public: std::vector<Link *> updateLinks;
+
+      /// \brief Turbulence velocity of every link.
+      public: std::vector<ignition::math::Vector3d> gusts;
+
+      /// \brief World position of every link, refreshed at every update.
+      public: std::vector<ignition::math::Vector3d> positions;
+
+      /// \brief Wind velocity of every link, refreshed at every update.
+      public: std::vector<ignition::math::Vector3d> vels;
+
+      /// \brief Simulation time of the last update.
+      public: common::Time lastUpdate;
+
+      /// \brief Connection to the world update event.
+      public: event::ConnectionPtr updateConnection;
+
       // Transport is declared last.
       /// \brief Node for communication.
       public: transport::NodePtr node;
@@ -93,13 +146,19 @@ Wind::Wind(World &_world, sdf::ElementPtr _sdf)
   this->dataPtr->requestSub = this->dataPtr->node->Subscribe("~/request",
                                            &Wind::OnRequest, this);
 
-  this->SetLinearVelFunc(std::bind(&Wind::LinearVelDefault, this,
-        std::placeholders::_1, std::placeholders::_2));
+  this->dataPtr->linearVelFunc = std::bind(&Wind::LinearVelDefault, this,
+        std::placeholders::_1, std::placeholders::_2);
+
+  // Only this world's updates, worlds may be stepped in parallel
+  this->dataPtr->updateConnection =
+      this->dataPtr->world.ConnectWorldUpdateBegin(
+      std::bind(&Wind::Update, this, std::placeholders::_1));
 }
 
 //////////////////////////////////////////////////
 Wind::~Wind()
 {
+  this->dataPtr->updateConnection.reset();
   this->dataPtr->windSub.reset();
   this->dataPtr->requestSub.reset();
   this->dataPtr->responsePub.reset();
@@ -109,9 +168,15 @@ Wind::~Wind()
 
 //////////////////////////////////////////////////
 ignition::math::Vector3d Wind::LinearVelDefault(
-    const Wind *_wind, const Entity */*_entity*/)
+    const Wind *_wind, const Entity *_entity)
 {
-  return _wind->LinearVel();
+  // The field may be reloaded at any time
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+  if (!_entity || !this->dataPtr->field.Valid())
+    return _wind->LinearVel();
+
+  return _wind->LinearVel() + this->dataPtr->field.Sample(
+      this->dataPtr->world.SimTime().Double(), _entity->WorldPose().Pos());
 }
 
 //////////////////////////////////////////////////
@@ -151,6 +216,29 @@ bool Wind::SetParam(const std::string &_key,
           boost::any_cast<ignition::math::Vector3d>(_value);
       this->SetLinearVel(vel);
     }
+    else if (_key == "field_file")
+    {
+      return this->LoadField(boost::any_cast<std::string>(_value));
+    }
+    else if (_key == "turbulence_intensity")
+    {
+      ignition::math::Vector3d intensity =
+          boost::any_cast<ignition::math::Vector3d>(_value);
+      std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+      this->dataPtr->turbulenceIntensity = intensity;
+    }
+    else if (_key == "turbulence_length")
+    {
+      ignition::math::Vector3d length =
+          boost::any_cast<ignition::math::Vector3d>(_value);
+      if (length.Min() <= 0)
+      {
+        gzerr << "Turbulence length scales must be positive" << std::endl;
+        return false;
+      }
+      std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+      this->dataPtr->turbulenceLength = length;
+    }
     else
     {
       gzwarn << "SetParam failed for [" << _key << "] in wind " << std::endl;
@@ -186,6 +274,12 @@ bool Wind::Param(const std::string &_key,
 {
   if (_key == "linear_velocity")
     _value = this->LinearVel();
+  else if (_key == "field_file")
+    _value = this->dataPtr->field.Filename();
+  else if (_key == "turbulence_intensity")
+    _value = this->dataPtr->turbulenceIntensity;
+  else if (_key == "turbulence_length")
+    _value = this->dataPtr->turbulenceLength;
   else
   {
     gzwarn << "Param failed for [" << _key << "] in wind " << std::endl;
@@ -238,5 +332,167 @@ void Wind::OnWindMsg(ConstWindPtr &_msg)
 void Wind::SetLinearVelFunc(std::function< ignition::math::Vector3d (
     const Wind *, const Entity *_entity) > _linearVelFunc)
 {
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
   this->dataPtr->linearVelFunc = _linearVelFunc;
+  this->dataPtr->customLinearVelFunc = true;
+}
+
+/////////////////////////////////////////////////
+void Wind::SetLinearVelBatchFunc(std::function<void (const Wind *,
+    const std::vector<ignition::math::Vector3d> &,
+    std::vector<ignition::math::Vector3d> &)> _linearVelBatchFunc)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+  this->dataPtr->linearVelBatchFunc = _linearVelBatchFunc;
+}
+
+/////////////////////////////////////////////////
+bool Wind::LoadField(const std::string &_filename)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+  if (_filename.empty())
+  {
+    this->dataPtr->field.Unload();
+    return true;
+  }
+  return this->dataPtr->field.Load(_filename);
+}
+
+/////////////////////////////////////////////////
+const WindField &Wind::Field() const
+{
+  return this->dataPtr->field;
+}
+
+/////////////////////////////////////////////////
+void Wind::AddLink(Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+  auto &links = this->dataPtr->links;
+  if (std::find(links.begin(), links.end(), _link) != links.end())
+    return;
+  links.push_back(_link);
+  this->dataPtr->gusts.push_back(ignition::math::Vector3d::Zero);
+  ++this->dataPtr->linksVersion;
+}
+
+/////////////////////////////////////////////////
+void Wind::RemoveLink(Link *_link)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+  auto &links = this->dataPtr->links;
+  auto iter = std::find(links.begin(), links.end(), _link);
+  if (iter == links.end())
+    return;
+
+  // Swap with the last link, order does not matter
+  const size_t index = iter - links.begin();
+  links[index] = links.back();
+  links.pop_back();
+  this->dataPtr->gusts[index] = this->dataPtr->gusts.back();
+  this->dataPtr->gusts.pop_back();
+  ++this->dataPtr->linksVersion;
+}
+
+/////////////////////////////////////////////////
+size_t Wind::LinkCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+  return this->dataPtr->links.size();
+}
+
+/////////////////////////////////////////////////
+void Wind::Update(const common::UpdateInfo &_info)
+{
+  // User functions may call back into Wind, so they are called without
+  // holding the lock, on a copy of the link list.
+  auto &links = this->dataPtr->updateLinks;
+  uint64_t version;
+  bool custom;
+  std::function<ignition::math::Vector3d (const Wind *, const Entity *)>
+      linearVelFunc;
+  std::function<void (const Wind *,
+      const std::vector<ignition::math::Vector3d> &,
+      std::vector<ignition::math::Vector3d> &)> linearVelBatchFunc;
+  double dt;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+    dt = (_info.simTime - this->dataPtr->lastUpdate).Double();
+    this->dataPtr->lastUpdate = _info.simTime;
+
+    links = this->dataPtr->links;
+    version = this->dataPtr->linksVersion;
+    custom = this->dataPtr->customLinearVelFunc;
+    if (custom)
+      linearVelFunc = this->dataPtr->linearVelFunc;
+    else
+      linearVelBatchFunc = this->dataPtr->linearVelBatchFunc;
+  }
+
+  const size_t count = links.size();
+  if (count == 0)
+    return;
+
+  auto &positions = this->dataPtr->positions;
+  auto &vels = this->dataPtr->vels;
+  positions.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    positions[i] = links[i]->WorldPose().Pos();
+
+  if (custom)
+  {
+    vels.resize(count);
+    for (size_t i = 0; i < count; ++i)
+      vels[i] = linearVelFunc(this, links[i]);
+  }
+  else if (linearVelBatchFunc)
+  {
+    vels.resize(count);
+    linearVelBatchFunc(this, positions, vels);
+    if (vels.size() != count)
+    {
+      gzerr << "Wind batch function returned " << vels.size()
+            << " velocities for " << count << " links" << std::endl;
+      return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->linksMutex);
+
+  // A callback added or removed links, the gusts no longer match. The
+  // links get their wind at the next update.
+  if (version != this->dataPtr->linksVersion)
+    return;
+
+  if (!custom && !linearVelBatchFunc)
+  {
+    this->dataPtr->field.Sample(_info.simTime.Double(), positions, vels);
+    for (auto &vel : vels)
+      vel += this->dataPtr->linearVel;
+  }
+
+  // First order Dryden turbulence: every axis is a Gauss-Markov process
+  // with correlation time L / V, where V is the link airspeed.
+  const ignition::math::Vector3d &sigma = this->dataPtr->turbulenceIntensity;
+  if (sigma != ignition::math::Vector3d::Zero && dt > 0)
+  {
+    const ignition::math::Vector3d &length = this->dataPtr->turbulenceLength;
+    auto &gusts = this->dataPtr->gusts;
+    for (size_t i = 0; i < count; ++i)
+    {
+      // Avoid frozen turbulence when the link drifts with the wind
+      const double airspeed = std::max(1.0,
+          (vels[i] - links[i]->WorldLinearVel()).Length());
+      for (int k = 0; k < 3; ++k)
+      {
+        const double a = std::exp(-airspeed * dt / length[k]);
+        gusts[i][k] = a * gusts[i][k] + sigma[k] * std::sqrt(1.0 - a * a) *
+            ignition::math::Rand::DblNormal(0, 1);
+      }
+      vels[i] += gusts[i];
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i)
+    links[i]->SetWorldWindLinearVel(vels[i]);
 }
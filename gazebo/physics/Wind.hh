@@ -20,8 +20,10 @@
 #include <string>
 #include <functional>
 #include <memory>
+#include <vector>
 #include <boost/any.hpp>
 
+#include "gazebo/common/UpdateInfo.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/util/system.hh"
@@ -38,6 +40,13 @@ namespace gazebo
 
     /// \class Wind Wind.hh physics/physics.hh
     /// \brief Base class for wind.
+    ///
+    /// The wind velocity of every link that has wind enabled is computed
+    /// once per world update, for all the links at once. By default it is
+    /// the global linear velocity, plus the wind field loaded with
+    /// LoadField, plus turbulence. A batch function set with
+    /// SetLinearVelBatchFunc replaces the global velocity and the field,
+    /// a function set with SetLinearVelFunc is called for every link.
     class GZ_PHYSICS_VISIBLE Wind
     {
       /// \brief Default constructor.
@@ -56,7 +65,13 @@ namespace gazebo
       /// See SetParam documentation for descriptions of duplicate parameters.
       /// \param[in] _key String key
       /// Below is a list of _key parameter definitions:
-      ///       -# "linear_vel" (Vector3d) - wind linear velocity
+      ///       -# "linear_velocity" (Vector3d) - wind linear velocity
+      ///       -# "field_file" (std::string) - wind field file to map,
+      ///          empty to unload the field, see WindField
+      ///       -# "turbulence_intensity" (Vector3d) - standard deviation of
+      ///          the turbulence along x, y and z in m/s, zero to disable
+      ///       -# "turbulence_length" (Vector3d) - turbulence length scales
+      ///          along x, y and z in meters
       ///
       /// \param[in] _value The value to set to
       /// \return true if SetParam is successful, false if operation fails.
@@ -114,7 +129,47 @@ namespace gazebo
       public: void SetLinearVelFunc(std::function< ignition::math::Vector3d (
           const Wind *_wind, const Entity *_entity) > _linearVelFunc);
 
-      /// \brief Get the global wind velocity, ignoring the entity.
+      /// \brief Setup function to compute the wind velocity of all the
+      /// links with wind enabled in one call.
+      /// \param[in] _linearVelBatchFunc The function callback that is used
+      /// to calculate the wind's velocity. Its parameters are a pointer to
+      /// this wind, the world positions of the links and the vector to fill
+      /// with the velocity of each link. Pass an empty function to go back
+      /// to the global velocity and wind field.
+      public: void SetLinearVelBatchFunc(std::function<void (
+          const Wind *_wind,
+          const std::vector<ignition::math::Vector3d> &_positions,
+          std::vector<ignition::math::Vector3d> &_vels)> _linearVelBatchFunc);
+
+      /// \brief Map a wind field file, see WindField. The field is added to
+      /// the global wind velocity.
+      /// \param[in] _filename Path to the file, empty to unload the field.
+      /// \return True if the field was loaded or unloaded.
+      public: bool LoadField(const std::string &_filename);
+
+      /// \brief Get the wind field.
+      /// \return The wind field, not valid if no file is loaded.
+      public: const WindField &Field() const;
+
+      /// \brief Update the wind velocity of a link at every world update.
+      /// \param[in] _link The link, must be removed before it is deleted.
+      public: void AddLink(Link *_link);
+
+      /// \brief Stop updating the wind velocity of a link.
+      /// \param[in] _link The link.
+      public: void RemoveLink(Link *_link);
+
+      /// \brief Number of links whose wind velocity is updated.
+      /// \return Number of links.
+      public: size_t LinkCount() const;
+
+      /// \brief Compute the wind velocity of all the added links and set
+      /// it on the links. Called at the beginning of every world update.
+      /// \param[in] _info World update information.
+      public: void Update(const common::UpdateInfo &_info);
+
+      /// \brief Get the global wind velocity plus the wind field at the
+      /// entity location.
       /// \param[in] _wind Reference to the wind.
       /// \param[in] _entity Pointer to an entity at which location the wind
       /// velocity is to be calculated.
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/WindField.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Header of a wind field file, see WindField.
+    struct WindFieldHeader
+    {
+      /// \brief Magic string, "GZWIND1".
+      char magic[8];
+
+      /// \brief Number of grid points along x, y and z.
+      uint32_t size[3];
+
+      /// \brief Number of frames.
+      uint32_t frames;
+
+      /// \brief World position of the first grid point.
+      double origin[3];
+
+      /// \brief Distance between grid points.
+      double spacing[3];
+
+      /// \brief Time between frames.
+      double period;
+    };
+
+    static_assert(sizeof(WindFieldHeader) == 80,
+        "wind field header must match the file layout");
+
+    /// \internal
+    /// \brief Expected magic string of a wind field file.
+    static const char kWindFieldMagic[8] = "GZWIND1";
+
+    /// \internal
+    /// \brief Private data for the WindField class
+    class WindFieldPrivate
+    {
+      /// \brief Interpolation weights of a position along one axis.
+      /// \param[in] _axis Axis index.
+      /// \param[in] _pos Coordinate of the position along the axis.
+      /// \param[out] _i0 Index of the lower grid point.
+      /// \param[out] _i1 Index of the upper grid point.
+      /// \param[out] _t Weight of the upper grid point.
+      public: void Locate(const int _axis, const double _pos,
+                  size_t &_i0, size_t &_i1, double &_t) const
+      {
+        const size_t n = this->header.size[_axis];
+        double g = 0;
+        if (n > 1)
+        {
+          g = (_pos - this->header.origin[_axis]) /
+              this->header.spacing[_axis];
+          g = std::max(0.0, std::min(g, static_cast<double>(n - 1)));
+        }
+        _i0 = std::min(static_cast<size_t>(g), n > 1 ? n - 2 : 0);
+        _i1 = std::min(_i0 + 1, n - 1);
+        _t = g - _i0;
+      }
+
+      /// \brief Mapped file.
+      public: boost::iostreams::mapped_file_source file;
+
+      /// \brief Path of the mapped file.
+      public: std::string filename;
+
+      /// \brief Copy of the file header.
+      public: WindFieldHeader header;
+
+      /// \brief Wind velocities, inside the mapped file. Null if no field
+      /// is loaded.
+      public: const float *data = nullptr;
+
+      /// \brief Number of floats in one frame.
+      public: size_t frameSize = 0;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+//////////////////////////////////////////////////
+WindField::WindField()
+  : dataPtr(new WindFieldPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+WindField::~WindField()
+{
+  this->Unload();
+}
+
+//////////////////////////////////////////////////
+bool WindField::Load(const std::string &_filename)
+{
+  this->Unload();
+
+  try
+  {
+    this->dataPtr->file.open(_filename);
+  }
+  catch(const std::exception &_e)
+  {
+    gzerr << "Unable to map wind field [" << _filename << "]: "
+          << _e.what() << std::endl;
+    return false;
+  }
+
+  WindFieldHeader &header = this->dataPtr->header;
+  const size_t fileSize = this->dataPtr->file.size();
+  if (fileSize < sizeof(header))
+  {
+    gzerr << "Wind field [" << _filename << "] is too small" << std::endl;
+    this->Unload();
+    return false;
+  }
+  std::memcpy(&header, this->dataPtr->file.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, kWindFieldMagic, sizeof(header.magic)) != 0)
+  {
+    gzerr << "[" << _filename << "] is not a wind field" << std::endl;
+    this->Unload();
+    return false;
+  }
+
+  // Check every factor against the floats in the file before multiplying,
+  // so that a corrupt header can't overflow the expected size.
+  const size_t available = (fileSize - sizeof(header)) / sizeof(float);
+  size_t floats = 3;
+  for (int i = 0; i < 3; ++i)
+  {
+    if (header.size[i] == 0 ||
+        (header.size[i] > 1 && !(header.spacing[i] > 0)))
+    {
+      gzerr << "Wind field [" << _filename << "] has an invalid grid"
+            << std::endl;
+      this->Unload();
+      return false;
+    }
+    if (header.size[i] > available / floats)
+    {
+      gzerr << "Wind field [" << _filename << "] is truncated, its grid "
+            << "needs more than the " << fileSize << " bytes of the file"
+            << std::endl;
+      this->Unload();
+      return false;
+    }
+    floats *= header.size[i];
+  }
+
+  if (header.frames == 0 || (header.frames > 1 && !(header.period > 0)))
+  {
+    gzerr << "Wind field [" << _filename << "] has invalid frames"
+          << std::endl;
+    this->Unload();
+    return false;
+  }
+
+  if (header.frames > available / floats)
+  {
+    gzerr << "Wind field [" << _filename << "] is truncated, expected "
+          << sizeof(header) + floats * header.frames * sizeof(float)
+          << " bytes, got " << fileSize << std::endl;
+    this->Unload();
+    return false;
+  }
+  this->dataPtr->frameSize = floats;
+
+  this->dataPtr->data = reinterpret_cast<const float *>(
+      this->dataPtr->file.data() + sizeof(header));
+  this->dataPtr->filename = _filename;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void WindField::Unload()
+{
+  if (this->dataPtr->file.is_open())
+    this->dataPtr->file.close();
+  this->dataPtr->data = nullptr;
+  this->dataPtr->frameSize = 0;
+  this->dataPtr->filename.clear();
+}
+
+//////////////////////////////////////////////////
+bool WindField::Valid() const
+{
+  return this->dataPtr->data != nullptr;
+}
+
+//////////////////////////////////////////////////
+std::string WindField::Filename() const
+{
+  return this->dataPtr->filename;
+}
+
+//////////////////////////////////////////////////
+unsigned int WindField::FrameCount() const
+{
+  return this->dataPtr->data ? this->dataPtr->header.frames : 0u;
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d WindField::Sample(const double _time,
+    const ignition::math::Vector3d &_pos) const
+{
+  std::vector<ignition::math::Vector3d> vels;
+  this->Sample(_time, {_pos}, vels);
+  return vels[0];
+}
+
+//////////////////////////////////////////////////
+void WindField::Sample(const double _time,
+    const std::vector<ignition::math::Vector3d> &_positions,
+    std::vector<ignition::math::Vector3d> &_vels) const
+{
+  _vels.assign(_positions.size(), ignition::math::Vector3d::Zero);
+  if (!this->dataPtr->data)
+    return;
+
+  const WindFieldHeader &header = this->dataPtr->header;
+
+  // Frames to blend, shared by the whole batch
+  size_t f0 = 0;
+  size_t f1 = 0;
+  double ft = 0;
+  if (header.frames > 1)
+  {
+    double t = std::fmod(_time / header.period,
+        static_cast<double>(header.frames));
+    if (t < 0)
+      t += header.frames;
+    f0 = std::min(static_cast<size_t>(t),
+        static_cast<size_t>(header.frames - 1));
+    f1 = (f0 + 1) % header.frames;
+    ft = t - f0;
+  }
+  const float *frame0 = this->dataPtr->data + f0 * this->dataPtr->frameSize;
+  const float *frame1 = this->dataPtr->data + f1 * this->dataPtr->frameSize;
+  const size_t nx = header.size[0];
+  const size_t nxy = nx * header.size[1];
+
+  for (size_t i = 0; i < _positions.size(); ++i)
+  {
+    size_t x[2], y[2], z[2];
+    double tx, ty, tz;
+    this->dataPtr->Locate(0, _positions[i].X(), x[0], x[1], tx);
+    this->dataPtr->Locate(1, _positions[i].Y(), y[0], y[1], ty);
+    this->dataPtr->Locate(2, _positions[i].Z(), z[0], z[1], tz);
+
+    const double wx[2] = {1.0 - tx, tx};
+    const double wy[2] = {1.0 - ty, ty};
+    const double wz[2] = {1.0 - tz, tz};
+
+    // Trilinear interpolation in both frames
+    double v[3] = {0, 0, 0};
+    for (int c = 0; c < 8; ++c)
+    {
+      const int ix = c & 1;
+      const int iy = (c >> 1) & 1;
+      const int iz = c >> 2;
+      const double w = wx[ix] * wy[iy] * wz[iz];
+      const size_t offset = 3 * (x[ix] + y[iy] * nx + z[iz] * nxy);
+      for (int k = 0; k < 3; ++k)
+      {
+        v[k] += w * ((1.0 - ft) * frame0[offset + k] +
+                     ft * frame1[offset + k]);
+      }
+    }
+    _vels[i].Set(v[0], v[1], v[2]);
+  }
+}
+
+//////////////////////////////////////////////////
+bool WindField::Save(const std::string &_filename,
+    const ignition::math::Vector3<unsigned int> &_size,
+    const unsigned int _frames,
+    const ignition::math::Vector3d &_origin,
+    const ignition::math::Vector3d &_spacing,
+    const double _period,
+    const std::vector<ignition::math::Vector3d> &_vels)
+{
+  const size_t count =
+      static_cast<size_t>(_size.X()) * _size.Y() * _size.Z() * _frames;
+  if (count == 0 || _vels.size() != count)
+  {
+    gzerr << "Wind field [" << _filename << "] expects " << count
+          << " velocities, got " << _vels.size() << std::endl;
+    return false;
+  }
+
+  WindFieldHeader header;
+  std::memcpy(header.magic, kWindFieldMagic, sizeof(header.magic));
+  for (int i = 0; i < 3; ++i)
+  {
+    header.size[i] = _size[i];
+    header.origin[i] = _origin[i];
+    header.spacing[i] = _spacing[i];
+  }
+  header.frames = _frames;
+  header.period = _period;
+
+  std::vector<float> data;
+  data.reserve(count * 3);
+  for (auto const &vel : _vels)
+  {
+    data.push_back(static_cast<float>(vel.X()));
+    data.push_back(static_cast<float>(vel.Y()));
+    data.push_back(static_cast<float>(vel.Z()));
+  }
+
+  std::ofstream out(_filename, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(data.data()),
+      data.size() * sizeof(float));
+  if (!out)
+  {
+    gzerr << "Unable to write wind field [" << _filename << "]"
+          << std::endl;
+    return false;
+  }
+  return true;
+}
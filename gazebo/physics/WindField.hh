@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WINDFIELD_HH_
+#define GAZEBO_PHYSICS_WINDFIELD_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class WindFieldPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WindField WindField.hh physics/physics.hh
+    /// \brief Time varying wind velocity sampled on a regular grid, read
+    /// from a memory mapped file.
+    ///
+    /// The file starts with an 80 byte little endian header:
+    ///   - 8 bytes: magic string "GZWIND1" followed by a null character.
+    ///   - 4 x uint32: number of points along x, y, z and number of frames.
+    ///   - 3 x double: world position of the first grid point.
+    ///   - 3 x double: distance between grid points along x, y and z.
+    ///   - 1 x double: time between frames, in seconds.
+    ///
+    /// It is followed by the wind velocities, 3 floats per grid point, with
+    /// x varying fastest, then y, z and the frame. Positions outside of the
+    /// grid use the closest grid point. Frames are linearly interpolated
+    /// and repeat once the last frame is reached.
+    class GZ_PHYSICS_VISIBLE WindField
+    {
+      /// \brief Constructor.
+      public: WindField();
+
+      /// \brief Destructor.
+      public: virtual ~WindField();
+
+      /// \brief Map a wind field file, replacing the current field.
+      /// \param[in] _filename Path to the file.
+      /// \return True if the file was mapped and its header is valid.
+      public: bool Load(const std::string &_filename);
+
+      /// \brief Unmap the current field.
+      public: void Unload();
+
+      /// \brief Whether a field is loaded.
+      /// \return True if a field is loaded.
+      public: bool Valid() const;
+
+      /// \brief Path of the mapped file.
+      /// \return Path of the file, empty if no field is loaded.
+      public: std::string Filename() const;
+
+      /// \brief Number of frames of the field.
+      /// \return Number of frames, 0 if no field is loaded.
+      public: unsigned int FrameCount() const;
+
+      /// \brief Wind velocity at a position.
+      /// \param[in] _time Simulation time in seconds.
+      /// \param[in] _pos World position.
+      /// \return Wind velocity, zero if no field is loaded.
+      public: ignition::math::Vector3d Sample(const double _time,
+                  const ignition::math::Vector3d &_pos) const;
+
+      /// \brief Wind velocity at many positions. The frames to interpolate
+      /// are looked up once for the whole batch.
+      /// \param[in] _time Simulation time in seconds.
+      /// \param[in] _positions World positions.
+      /// \param[out] _vels Wind velocity at every position, zero if no
+      /// field is loaded.
+      public: void Sample(const double _time,
+                  const std::vector<ignition::math::Vector3d> &_positions,
+                  std::vector<ignition::math::Vector3d> &_vels) const;
+
+      /// \brief Write a wind field file.
+      /// \param[in] _filename Path to the file.
+      /// \param[in] _size Number of points along x, y and z.
+      /// \param[in] _frames Number of frames.
+      /// \param[in] _origin World position of the first grid point.
+      /// \param[in] _spacing Distance between grid points.
+      /// \param[in] _period Time between frames, in seconds.
+      /// \param[in] _vels Wind velocities, in file order.
+      /// \return True if the file was written.
+      public: static bool Save(const std::string &_filename,
+                  const ignition::math::Vector3<unsigned int> &_size,
+                  const unsigned int _frames,
+                  const ignition::math::Vector3d &_origin,
+                  const ignition::math::Vector3d &_spacing,
+                  const double _period,
+                  const std::vector<ignition::math::Vector3d> &_vels);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WindFieldPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
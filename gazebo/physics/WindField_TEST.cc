@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gazebo/physics/WindField.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+class WindFieldTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(WindFieldTest, Sample)
+{
+  const std::string filename = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("wind_%%%%.bin")).string();
+
+  // 4x3x2 grid with two frames, the velocity is (x index + 10 * frame,
+  // y index, z index)
+  std::vector<ignition::math::Vector3d> vels;
+  for (unsigned int f = 0; f < 2; ++f)
+    for (unsigned int z = 0; z < 2; ++z)
+      for (unsigned int y = 0; y < 3; ++y)
+        for (unsigned int x = 0; x < 4; ++x)
+          vels.push_back(ignition::math::Vector3d(x + 10.0 * f, y, z));
+
+  const ignition::math::Vector3d origin(-1, 0, 0);
+  const ignition::math::Vector3d spacing(2, 1, 10);
+  EXPECT_FALSE(WindField::Save(filename,
+      ignition::math::Vector3<unsigned int>(4, 3, 2), 3, origin, spacing,
+      0.5, vels));
+  EXPECT_TRUE(WindField::Save(filename,
+      ignition::math::Vector3<unsigned int>(4, 3, 2), 2, origin, spacing,
+      0.5, vels));
+
+  WindField field;
+  EXPECT_FALSE(field.Valid());
+  EXPECT_EQ(field.Sample(0, ignition::math::Vector3d::Zero),
+      ignition::math::Vector3d::Zero);
+
+  ASSERT_TRUE(field.Load(filename));
+  EXPECT_TRUE(field.Valid());
+  EXPECT_EQ(field.Filename(), filename);
+  EXPECT_EQ(field.FrameCount(), 2u);
+
+  // Trilinear interpolation in the first frame
+  const ignition::math::Vector3d pos(2, 1.5, 5);
+  EXPECT_EQ(field.Sample(0, pos), ignition::math::Vector3d(1.5, 1.5, 0.5));
+
+  // Halfway between the two frames, then back to the first frame
+  EXPECT_EQ(field.Sample(0.25, pos), ignition::math::Vector3d(6.5, 1.5, 0.5));
+  EXPECT_EQ(field.Sample(1.0, pos), ignition::math::Vector3d(1.5, 1.5, 0.5));
+
+  // Positions outside of the grid are clamped
+  std::vector<ignition::math::Vector3d> positions = {
+      pos, ignition::math::Vector3d(100, -5, 5)};
+  std::vector<ignition::math::Vector3d> result;
+  field.Sample(0.75, positions, result);
+  ASSERT_EQ(result.size(), 2u);
+  EXPECT_EQ(result[0], ignition::math::Vector3d(6.5, 1.5, 0.5));
+  EXPECT_EQ(result[1], ignition::math::Vector3d(8, 0, 0.5));
+
+  field.Unload();
+  EXPECT_FALSE(field.Valid());
+  EXPECT_EQ(field.FrameCount(), 0u);
+
+  // Corrupt sizes whose product overflows, 2^30 grid points along every
+  // axis and 2^30 frames
+  {
+    std::fstream out(filename,
+        std::ios::binary | std::ios::in | std::ios::out);
+    const uint32_t huge[4] = {1u << 30, 1u << 30, 1u << 30, 1u << 30};
+    out.seekp(8);
+    out.write(reinterpret_cast<const char *>(huge), sizeof(huge));
+  }
+  EXPECT_FALSE(field.Load(filename));
+  EXPECT_FALSE(field.Valid());
+
+  // Not a wind field
+  {
+    std::ofstream out(filename, std::ios::binary);
+    out << "not a wind field, but long enough to hold a header. "
+        << "not a wind field, but long enough to hold a header.";
+  }
+  EXPECT_FALSE(field.Load(filename));
+  EXPECT_FALSE(field.Load(filename + "_missing"));
+  EXPECT_FALSE(field.Valid());
+
+  boost::filesystem::remove(filename);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
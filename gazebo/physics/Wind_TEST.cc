@@ -15,6 +15,9 @@
  *
 */
 #include <memory>
+#include <vector>
+
+#include <boost/filesystem.hpp>
 
 #include "gazebo/test/ServerFixture.hh"
 #include "gazebo/msgs/msgs.hh"
@@ -221,6 +224,115 @@ TEST_F(WindTest, WindSetLinearVelFunc)
   WindSetLinearVelFunc();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WindTest, WindBatch)
+{
+  Load("worlds/wind_demo.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  physics::ModelPtr model = world->ModelByName("wind_demo_model");
+  ASSERT_TRUE(model != NULL);
+  physics::Link_V links = model->GetLinks();
+  ASSERT_FALSE(links.empty());
+
+  // Every link of the model is updated by the world wind
+  physics::Wind &wind = world->Wind();
+  EXPECT_EQ(wind.LinkCount(), links.size());
+
+  world->Step(1);
+  for (auto const &link : links)
+    EXPECT_EQ(link->WorldWindLinearVel(), ignition::math::Vector3d(0, 1, 0));
+
+  // Uniform field added to the global velocity
+  const std::string filename = (boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("wind_%%%%.bin")).string();
+  ASSERT_TRUE(physics::WindField::Save(filename,
+      ignition::math::Vector3<unsigned int>(1, 1, 1), 1,
+      ignition::math::Vector3d::Zero, ignition::math::Vector3d::One, 0,
+      {ignition::math::Vector3d(2, 0, 0)}));
+  EXPECT_TRUE(wind.SetParam("field_file", filename));
+  EXPECT_EQ(boost::any_cast<std::string>(wind.Param("field_file")), filename);
+  EXPECT_FALSE(wind.SetParam("field_file", filename + "_missing"));
+
+  EXPECT_TRUE(wind.SetParam("field_file", filename));
+  world->Step(1);
+  for (auto const &link : links)
+    EXPECT_EQ(link->WorldWindLinearVel(), ignition::math::Vector3d(2, 1, 0));
+  EXPECT_EQ(wind.WorldLinearVel(links[0].get()),
+      ignition::math::Vector3d(2, 1, 0));
+  EXPECT_TRUE(wind.SetParam("field_file", std::string()));
+  boost::filesystem::remove(filename);
+
+  // Turbulence perturbs the wind of every link
+  EXPECT_FALSE(wind.SetParam("turbulence_length",
+      ignition::math::Vector3d(0, 1, 1)));
+  EXPECT_TRUE(wind.SetParam("turbulence_length",
+      ignition::math::Vector3d(10, 10, 10)));
+  EXPECT_TRUE(wind.SetParam("turbulence_intensity",
+      ignition::math::Vector3d(1, 1, 1)));
+  world->Step(1);
+  for (auto const &link : links)
+    EXPECT_NE(link->WorldWindLinearVel(), ignition::math::Vector3d(0, 1, 0));
+  EXPECT_TRUE(wind.SetParam("turbulence_intensity",
+      ignition::math::Vector3d::Zero));
+
+  // Batch function called once for all the links
+  int calls = 0;
+  size_t count = 0;
+  wind.SetLinearVelBatchFunc([&calls, &count](const physics::Wind *,
+      const std::vector<ignition::math::Vector3d> &_positions,
+      std::vector<ignition::math::Vector3d> &_vels)
+  {
+    ++calls;
+    count = _positions.size();
+    for (auto &vel : _vels)
+      vel.Set(3, 0, 0);
+  });
+  world->Step(1);
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(count, links.size());
+  for (auto const &link : links)
+    EXPECT_EQ(link->WorldWindLinearVel(), ignition::math::Vector3d(3, 0, 0));
+
+  // Callbacks may call back into the wind without deadlocking
+  size_t reentrantCount = 0;
+  wind.SetLinearVelBatchFunc([&reentrantCount](const physics::Wind *_wind,
+      const std::vector<ignition::math::Vector3d> &,
+      std::vector<ignition::math::Vector3d> &_vels)
+  {
+    reentrantCount = _wind->LinkCount();
+    for (auto &vel : _vels)
+      vel = _wind->LinearVel();
+  });
+  world->Step(1);
+  EXPECT_EQ(reentrantCount, links.size());
+  wind.SetLinearVelBatchFunc(nullptr);
+
+  wind.SetLinearVelFunc([&wind](const physics::Wind *_wind,
+      const physics::Entity *)
+  {
+    wind.SetParam("linear_velocity", ignition::math::Vector3d(0, 0, 4));
+    return _wind->LinearVel() +
+        ignition::math::Vector3d(_wind->LinkCount(), 0, 0);
+  });
+  world->Step(1);
+  for (auto const &link : links)
+  {
+    EXPECT_EQ(link->WorldWindLinearVel(),
+        ignition::math::Vector3d(links.size(), 0, 4));
+  }
+
+  // Disabling wind on a link removes it from the batch
+  links[0]->SetWindMode(false);
+  EXPECT_EQ(wind.LinkCount(), links.size() - 1);
+  EXPECT_EQ(links[0]->WorldWindLinearVel(), ignition::math::Vector3d::Zero);
+
+  world->SetWindEnabled(false);
+  EXPECT_EQ(wind.LinkCount(), 0u);
+}
+
+/////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
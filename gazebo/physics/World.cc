@@ -22,8 +22,13 @@
 
 #include <sdf/sdf.hh>
 
+#include <algorithm>
+#include <cmath>
 #include <deque>
+#include <functional>
+#include <limits>
 #include <list>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -76,20 +81,35 @@
 #include "gazebo/physics/Light.hh"
 #include "gazebo/physics/Actor.hh"
 #include "gazebo/physics/Wind.hh"
+#include "gazebo/physics/WrenchQueue.hh"
 #include "gazebo/physics/WorldPrivate.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/common/SphericalCoordinates.hh"
 
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/SleepManager.hh"
 #include "gazebo/physics/Population.hh"
 
 using namespace gazebo;
 using namespace physics;
 
-/// \brief Flag used to say if/when to clear all models.
-/// This will be replaced with a class member variable in Gazebo 3.0
-bool g_clearModels;
+/// \brief Serializes the global events and the process wide singletons
+/// (introspection, log recording) between worlds stepped in parallel by a
+/// WorldBatch.
+static std::recursive_mutex g_batchSharedMutex;
+
+/////////////////////////////////////////////////
+/// \brief Lock g_batchSharedMutex if a world is in batch mode.
+/// \param[in] _batch True if the world is in batch mode.
+/// \return The lock, which owns nothing outside of batch mode.
+static std::unique_lock<std::recursive_mutex> BatchSharedLock(
+    const bool _batch)
+{
+  if (_batch)
+    return std::unique_lock<std::recursive_mutex>(g_batchSharedMutex);
+  return std::unique_lock<std::recursive_mutex>();
+}
 
 class ModelUpdate_TBB
 {
@@ -109,7 +129,6 @@ class ModelUpdate_TBB
 World::World(const std::string &_name)
   : dataPtr(new WorldPrivate)
 {
-  g_clearModels = false;
   this->dataPtr->sdf.reset(new sdf::Element);
   sdf::initFile("world.sdf", this->dataPtr->sdf);
 
@@ -222,6 +241,13 @@ void World::Load(sdf::ElementPtr _sdf)
   this->dataPtr->posePub = this->dataPtr->node->Advertise<msgs::PosesStamped>(
     "~/pose/info", 10, 60);
 
+  // compact pose stream, which only sends the poses that changed. Each
+  // delta depends on the previous ones, so messages are never throttled
+  // nor dropped from the queue.
+  this->dataPtr->poseStreamPub =
+    this->dataPtr->node->Advertise<msgs::PoseStream>("~/pose/stream",
+        std::numeric_limits<unsigned int>::max());
+
   this->dataPtr->guiPub = this->dataPtr->node->Advertise<msgs::GUI>("~/gui", 5);
   if (this->dataPtr->sdf->HasElement("gui"))
   {
@@ -251,6 +277,9 @@ void World::Load(sdf::ElementPtr _sdf)
   this->dataPtr->modelSub = this->dataPtr->node->Subscribe<msgs::Model>(
       "~/model/modify", &World::OnModelMsg, this);
 
+  this->dataPtr->linkWrenchesSub = this->dataPtr->node->Subscribe(
+      "~/link_wrenches", &World::OnLinkWrenchesMsg, this);
+
   this->dataPtr->responsePub = this->dataPtr->node->Advertise<msgs::Response>(
       "~/response");
   this->dataPtr->statPub =
@@ -524,31 +553,31 @@ void World::Stop()
 //////////////////////////////////////////////////
 void World::RunLoop()
 {
-  this->dataPtr->physicsEngine->InitForThread();
-
-  this->dataPtr->startTime = common::Time::GetWallTime();
-
-  // This fixes a minor issue when the world is paused before it's started
-  if (this->IsPaused())
-    this->dataPtr->pauseStartTime = this->dataPtr->startTime;
-
-  this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
-
-  // Get the first state
-  this->dataPtr->prevStates[0] = WorldState(shared_from_this());
-  this->dataPtr->prevStates[1] = WorldState(shared_from_this());
-  this->dataPtr->stateToggle = 0;
-
-  this->dataPtr->logThread =
-    new std::thread(std::bind(&World::LogWorker, this));
+  this->StartLoop();
 
   if (!util::LogPlay::Instance()->IsOpen())
   {
+    this->dataPtr->rateIterations = 0;
     for (this->dataPtr->iterations = 0; !this->dataPtr->stop &&
         (!this->dataPtr->stopIterations ||
          (this->dataPtr->iterations < this->dataPtr->stopIterations));)
     {
-      this->Step();
+      if (this->dataPtr->batchSteps > 0 && !this->IsPaused())
+        this->BatchStep();
+      else
+        this->Step();
+    }
+
+    if (this->dataPtr->batchSteps > 0)
+    {
+      common::Time elapsed =
+          common::Time::GetWallTime() - this->dataPtr->startTime;
+      gzmsg << "World [" << this->Name() << "] ran "
+            << this->dataPtr->iterations << " iterations in "
+            << elapsed.Double() << " s ("
+            << (elapsed.Double() > 0 ?
+                this->dataPtr->iterations / elapsed.Double() : 0.0)
+            << " iterations/s)\n";
     }
   }
   else
@@ -562,6 +591,36 @@ void World::RunLoop()
     }
   }
 
+  this->StopLoop();
+}
+
+//////////////////////////////////////////////////
+void World::StartLoop()
+{
+  this->dataPtr->physicsEngine->InitForThread();
+
+  this->dataPtr->startTime = common::Time::GetWallTime();
+
+  // This fixes a minor issue when the world is paused before it's started
+  if (this->IsPaused())
+    this->dataPtr->pauseStartTime = this->dataPtr->startTime;
+
+  this->dataPtr->prevStepWallTime = common::Time::GetWallTime();
+  this->dataPtr->rateWallTime = this->dataPtr->startTime;
+  this->dataPtr->rateIterations = this->dataPtr->iterations;
+
+  // Get the first state
+  this->dataPtr->prevStates[0] = WorldState(shared_from_this());
+  this->dataPtr->prevStates[1] = WorldState(shared_from_this());
+  this->dataPtr->stateToggle = 0;
+
+  this->dataPtr->logThread =
+    new std::thread(std::bind(&World::LogWorker, this));
+}
+
+//////////////////////////////////////////////////
+void World::StopLoop()
+{
   this->dataPtr->stop = true;
 
   if (this->dataPtr->logThread)
@@ -735,22 +794,159 @@ void World::Step()
     else
     {
       // Flush the log record buffer, if there is data in it.
+      auto lock = BatchSharedLock(true);
       if (util::LogRecord::Instance()->BufferSize() > 0)
         util::LogRecord::Instance()->Notify();
       this->dataPtr->pauseTime += stepTime;
     }
   }
 
-  gazebo::util::IntrospectionManager::Instance()->NotifyUpdates();
+  {
+    auto lock = BatchSharedLock(true);
+    gazebo::util::IntrospectionManager::Instance()->NotifyUpdates();
+  }
 
   this->ProcessMessages();
 
   DIAG_TIMER_STOP("World::Step");
 
-  if (g_clearModels)
+  if (this->dataPtr->clearModels)
+    this->ClearModels();
+}
+
+//////////////////////////////////////////////////
+void World::BatchStep()
+{
+  DIAG_TIMER_START("World::BatchStep");
+
+  if (!this->dataPtr->pluginsLoaded && this->SensorsInitialized())
+  {
+    this->LoadPlugins();
+    this->dataPtr->pluginsLoaded = true;
+  }
+
+  // Step back to back: no wall clock reads and no sleeping. Everything
+  // else is deferred to the housekeeping pass below. A paused world only
+  // takes the steps requested with stepInc.
+  bool stepped = false;
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+    const double stepTime = this->dataPtr->physicsEngine->GetMaxStepSize();
+    if (!this->IsPaused() || this->dataPtr->stepInc > 0
+        || this->dataPtr->needsReset)
+    {
+      this->dataPtr->simTime += stepTime;
+      this->dataPtr->iterations++;
+      this->Update();
+      stepped = true;
+
+      if (this->IsPaused() && this->dataPtr->stepInc > 0)
+        this->dataPtr->stepInc--;
+    }
+    else
+    {
+      this->dataPtr->pauseTime += stepTime;
+    }
+  }
+
+  DIAG_TIMER_LAP("World::BatchStep", "update");
+
+  // While paused, run housekeeping every call so that the messages which
+  // resume the world are processed.
+  if (stepped)
+    ++this->dataPtr->batchStepCount;
+  bool housekeeping = !stepped ||
+      this->dataPtr->batchStepCount >= this->dataPtr->batchSteps ||
+      this->dataPtr->needsReset || this->dataPtr->clearModels;
+
+  if (this->dataPtr->batchSimPeriod > 0 &&
+      this->dataPtr->simTime >= this->dataPtr->batchNextSimTime)
+  {
+    housekeeping = true;
+    this->dataPtr->batchNextSimTime =
+        this->dataPtr->simTime + this->dataPtr->batchSimPeriod;
+  }
+
+  if (!housekeeping)
+  {
+    DIAG_TIMER_STOP("World::BatchStep");
+    return;
+  }
+
+  this->dataPtr->batchStepCount = 0;
+
+  // Keep the real time throttling in Step from trying to catch up if
+  // batch mode is disabled or the world is paused.
+  common::Time wallTime = common::Time::GetWallTime();
+  this->dataPtr->prevStepWallTime = wallTime;
+
+  double elapsed = (wallTime - this->dataPtr->rateWallTime).Double();
+  if (elapsed >= 1.0)
+  {
+    this->dataPtr->stepsPerSecond = (this->dataPtr->iterations -
+        this->dataPtr->rateIterations) / elapsed;
+    this->dataPtr->rateWallTime = wallTime;
+    this->dataPtr->rateIterations = this->dataPtr->iterations;
+  }
+
+  this->PublishWorldStats();
+
+  {
+    auto lock = BatchSharedLock(true);
+
+    // Flush the log record buffer, if there is data in it.
+    if (!stepped && util::LogRecord::Instance()->BufferSize() > 0)
+      util::LogRecord::Instance()->Notify();
+
+    gazebo::util::IntrospectionManager::Instance()->NotifyUpdates();
+  }
+
+  this->ProcessMessages();
+
+  DIAG_TIMER_STOP("World::BatchStep");
+
+  if (this->dataPtr->clearModels)
     this->ClearModels();
 }
 
+//////////////////////////////////////////////////
+event::ConnectionPtr World::ConnectWorldUpdateBegin(
+    std::function<void (const common::UpdateInfo &)> _subscriber)
+{
+  return this->dataPtr->updateBegin.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+event::ConnectionPtr World::ConnectWorldUpdateEnd(
+    std::function<void ()> _subscriber)
+{
+  return this->dataPtr->updateEnd.Connect(_subscriber);
+}
+
+//////////////////////////////////////////////////
+void World::SetBatchMode(const unsigned int _steps, const double _simPeriod)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+  this->dataPtr->batchSteps = _steps;
+  this->dataPtr->batchSimPeriod = std::max(0.0, _simPeriod);
+  this->dataPtr->batchNextSimTime =
+      this->dataPtr->simTime + this->dataPtr->batchSimPeriod;
+  this->dataPtr->batchStepCount = 0;
+}
+
+//////////////////////////////////////////////////
+unsigned int World::BatchSteps() const
+{
+  return this->dataPtr->batchSteps;
+}
+
+//////////////////////////////////////////////////
+double World::StepsPerSecond() const
+{
+  return this->dataPtr->stepsPerSecond;
+}
+
 //////////////////////////////////////////////////
 void World::Step(const unsigned int _steps)
 {
@@ -794,9 +990,15 @@ void World::Update()
   }
   DIAG_TIMER_LAP("World::Update", "needsReset");
 
+  const bool batch = this->dataPtr->batchSteps > 0;
+
   this->dataPtr->updateInfo.simTime = this->SimTime();
   this->dataPtr->updateInfo.realTime = this->RealTime();
-  event::Events::worldUpdateBegin(this->dataPtr->updateInfo);
+  this->dataPtr->updateBegin(this->dataPtr->updateInfo);
+  {
+    auto lock = BatchSharedLock(batch);
+    event::Events::worldUpdateBegin(this->dataPtr->updateInfo);
+  }
 
   DIAG_TIMER_LAP("World::Update", "Events::worldUpdateBegin");
 
@@ -810,8 +1012,14 @@ void World::Update()
 
   DIAG_TIMER_LAP("World::Update", "PhysicsEngine::UpdateCollision");
 
+  bool logging;
+  {
+    auto lock = BatchSharedLock(batch);
+    logging = util::LogRecord::Instance()->Running();
+  }
+
   // Wait for logging to finish, if it's running.
-  if (util::LogRecord::Instance()->Running())
+  if (logging)
   {
     std::unique_lock<std::mutex> lock(this->dataPtr->logMutex);
 
@@ -828,7 +1036,10 @@ void World::Update()
   // Give clients a possibility to react to collisions before the physics
   // gets updated.
   this->dataPtr->updateInfo.realTime = this->RealTime();
-  event::Events::beforePhysicsUpdate(this->dataPtr->updateInfo);
+  {
+    auto lock = BatchSharedLock(batch);
+    event::Events::beforePhysicsUpdate(this->dataPtr->updateInfo);
+  }
 
   DIAG_TIMER_LAP("World::Update", "Events::beforePhysicsUpdate");
 
@@ -857,10 +1068,16 @@ void World::Update()
     }
 
     DIAG_TIMER_LAP("World::Update", "SetWorldPose(dirtyPoses)");
+
+    // Put the links at rest to sleep, for engines that don't do it
+    this->dataPtr->physicsEngine->GetSleepManager()->Update(
+        this->dataPtr->physicsEngine->GetMaxStepSize());
+
+    DIAG_TIMER_LAP("World::Update", "SleepManager::Update");
   }
 
   // Only update state information if logging data.
-  if (util::LogRecord::Instance()->Running())
+  if (logging)
     this->dataPtr->logCondition.notify_one();
   DIAG_TIMER_LAP("World::Update", "LogRecordNotify");
 
@@ -869,9 +1086,12 @@ void World::Update()
 
   DIAG_TIMER_LAP("World::Update", "ContactManager::PublishContacts");
 
-  event::Events::worldUpdateEnd();
-
-  gazebo::util::IntrospectionManager::Instance()->Update();
+  this->dataPtr->updateEnd();
+  {
+    auto lock = BatchSharedLock(batch);
+    event::Events::worldUpdateEnd();
+    gazebo::util::IntrospectionManager::Instance()->Update();
+  }
 
   DIAG_TIMER_STOP("World::Update");
 }
@@ -895,9 +1115,12 @@ void World::Fini()
     this->dataPtr->lightFactoryMsgs.clear();
     this->dataPtr->lightModifyMsgs.clear();
     this->dataPtr->playbackControlMsgs.clear();
+    this->dataPtr->pendingMsgCount = 0;
+    this->dataPtr->msgsPending = false;
 
     this->dataPtr->poseLocalPub.reset();
     this->dataPtr->posePub.reset();
+    this->dataPtr->poseStreamPub.reset();
     this->dataPtr->guiPub.reset();
     this->dataPtr->responsePub.reset();
     this->dataPtr->statPub.reset();
@@ -914,6 +1137,7 @@ void World::Fini()
     this->dataPtr->lightFactorySub.reset();
     this->dataPtr->lightModifySub.reset();
     this->dataPtr->modelSub.reset();
+    this->dataPtr->linkWrenchesSub.reset();
 
     if (this->dataPtr->node)
       this->dataPtr->node->Fini();
@@ -938,6 +1162,7 @@ void World::Fini()
       model->Fini();
   }
   this->dataPtr->models.clear();
+  this->dataPtr->modelIndex.SetStale();
 
   for (auto &road : this->dataPtr->roads)
   {
@@ -994,14 +1219,14 @@ void World::Fini()
 //////////////////////////////////////////////////
 void World::Clear()
 {
-  g_clearModels = true;
+  this->dataPtr->clearModels = true;
   /// \todo Clear lights too?
 }
 
 //////////////////////////////////////////////////
 void World::ClearModels()
 {
-  g_clearModels = false;
+  this->dataPtr->clearModels = false;
   bool pauseState = this->IsPaused();
   this->SetPaused(true);
 
@@ -1010,6 +1235,7 @@ void World::ClearModels()
     this->RemoveModel(this->dataPtr->models[0]);
   }
   this->dataPtr->models.clear();
+  this->dataPtr->modelIndex.SetStale();
 
   for (auto &road : this->dataPtr->roads)
   {
@@ -1164,6 +1390,7 @@ ModelPtr World::LoadModel(sdf::ElementPtr _sdf , BasePtr _parent)
 
   this->PublishModelPose(model);
   this->dataPtr->models.push_back(model);
+  this->dataPtr->modelIndex.SetStale();
   return model;
 }
 
@@ -1219,6 +1446,7 @@ ActorPtr World::LoadActor(sdf::ElementPtr _sdf , BasePtr _parent)
   this->EnableAllModels();
   this->PublishModelPose(actor);
   this->dataPtr->models.push_back(actor);
+  this->dataPtr->modelIndex.SetStale();
 
   return actor;
 }
@@ -1467,6 +1695,7 @@ void World::OnFactoryMsg(ConstFactoryPtr &_msg)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   this->dataPtr->factoryMsgs.push_back(*_msg);
+  this->MessageReceived();
 }
 
 //////////////////////////////////////////////////
@@ -1519,6 +1748,7 @@ void World::OnPlaybackControl(ConstLogPlaybackControlPtr &_data)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   this->dataPtr->playbackControlMsgs.push_back(*_data);
+  this->MessageReceived();
 }
 
 //////////////////////////////////////////////////
@@ -1576,6 +1806,7 @@ void World::OnRequest(ConstRequestPtr &_msg)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   this->dataPtr->requestMsgs.push_back(*_msg);
+  this->MessageReceived();
 }
 
 //////////////////////////////////////////////////
@@ -1604,6 +1835,7 @@ void World::OnModelMsg(ConstModelPtr &_msg)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   this->dataPtr->modelMsgs.push_back(*_msg);
+  this->MessageReceived();
 }
 
 //////////////////////////////////////////////////
@@ -1775,6 +2007,9 @@ void World::ProcessRequestMsgs()
     {
       std::lock_guard<std::mutex> lock2(this->dataPtr->entityDeleteMutex);
       this->dataPtr->deleteEntity.push_back(requestMsg.data());
+
+      // Deleted on the next pass
+      this->dataPtr->msgsPending = true;
     }
     else if (requestMsg.request() == "entity_info")
     {
@@ -1898,6 +2133,15 @@ void World::ProcessRequestMsgs()
       sphereCoordMsg.SerializeToString(serializedData);
       response.set_type(sphereCoordMsg.GetTypeName());
     }
+    else if (requestMsg.request() == "topic_stats")
+    {
+      msgs::TopicStatistics statsMsg;
+      transport::getStatistics(statsMsg);
+
+      std::string *serializedData = response.mutable_serialized_data();
+      statsMsg.SerializeToString(serializedData);
+      response.set_type(statsMsg.GetTypeName());
+    }
     else
       send = false;
 
@@ -2007,10 +2251,7 @@ void World::ProcessLightFactoryMsgs()
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
 
-    std::copy(this->dataPtr->lightFactoryMsgs.begin(),
-        this->dataPtr->lightFactoryMsgs.end(),
-        std::back_inserter(lightFactoryMsgsCopy));
-    this->dataPtr->lightFactoryMsgs.clear();
+    lightFactoryMsgsCopy.swap(this->dataPtr->lightFactoryMsgs);
   }
 
   for (auto const &lightFactoryMsg : lightFactoryMsgsCopy)
@@ -2039,13 +2280,34 @@ void World::ProcessFactoryMsgs()
   std::list<sdf::ElementPtr> modelsToLoad, lightsToLoad;
 
   std::list<msgs::Factory> factoryMsgsCopy;
+  std::list<sdf::ElementPtr> modelElems;
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
 
-    std::copy(this->dataPtr->factoryMsgs.begin(),
-      this->dataPtr->factoryMsgs.end(),
-      std::back_inserter(factoryMsgsCopy));
-    this->dataPtr->factoryMsgs.clear();
+    factoryMsgsCopy.swap(this->dataPtr->factoryMsgs);
+
+    modelElems.swap(this->dataPtr->factoryModelElems);
+  }
+
+  // Models that are already parsed only need a unique name.
+  for (auto const &elem : modelElems)
+  {
+    auto entityName = elem->Get<std::string>("name");
+    if (entityName.empty())
+    {
+      gzerr << "Can't load model with empty name" << std::endl;
+      continue;
+    }
+
+    if (this->ModelByName(entityName))
+    {
+      entityName = this->UniqueModelName(entityName);
+      elem->GetAttribute("name")->Set(entityName);
+    }
+
+    elem->SetParent(this->dataPtr->sdf);
+    elem->GetParent()->InsertElement(elem);
+    modelsToLoad.push_back(elem);
   }
 
   for (auto const &factoryMsg : factoryMsgsCopy)
@@ -2279,6 +2541,229 @@ EntityPtr World::EntityBelowPoint(const ignition::math::Vector3d &_pt) const
   return this->EntityByName(entityName);
 }
 
+//////////////////////////////////////////////////
+void World::ModelsInBox(const ignition::math::AxisAlignedBox &_box,
+    Model_V &_models) const
+{
+  this->dataPtr->modelIndex.Query(this->dataPtr->models, _box, nullptr,
+      _models);
+}
+
+//////////////////////////////////////////////////
+void World::ModelsInSphere(const ignition::math::Vector3d &_center,
+    const double _radius, Model_V &_models) const
+{
+  const ignition::math::Vector3d extent(_radius, _radius, _radius);
+  const ignition::math::AxisAlignedBox box(_center - extent,
+      _center + extent);
+
+  this->dataPtr->modelIndex.Query(this->dataPtr->models, box,
+      [&](const ignition::math::AxisAlignedBox &_modelBox)
+      {
+        // Distance from the center to the closest point of the box.
+        ignition::math::Vector3d closest;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          closest[i] = ignition::math::clamp(_center[i],
+              _modelBox.Min()[i], _modelBox.Max()[i]);
+        }
+        return closest.SquaredDistance(_center) <= _radius * _radius;
+      }, _models);
+}
+
+//////////////////////////////////////////////////
+void World::ModelsInFrustum(const ignition::math::Frustum &_frustum,
+    Model_V &_models) const
+{
+  // Bounding box of the corners of the near and far planes. The frustum
+  // looks along its +X axis.
+  const ignition::math::Pose3d &pose = _frustum.Pose();
+  const double tanFov = std::tan(_frustum.FOV().Radian() * 0.5);
+  const double aspect = _frustum.AspectRatio() > 0 ?
+      _frustum.AspectRatio() : 1.0;
+
+  ignition::math::AxisAlignedBox box;
+  for (const double dist : {_frustum.Near(), _frustum.Far()})
+  {
+    const double halfWidth = dist * tanFov;
+    const double halfHeight = halfWidth / aspect;
+    for (const double y : {-halfWidth, halfWidth})
+    {
+      for (const double z : {-halfHeight, halfHeight})
+      {
+        const ignition::math::Vector3d corner =
+            pose.Pos() + pose.Rot().RotateVector(
+            ignition::math::Vector3d(dist, y, z));
+        box.Merge(ignition::math::AxisAlignedBox(corner, corner));
+      }
+    }
+  }
+
+  this->dataPtr->modelIndex.Query(this->dataPtr->models, box,
+      [&](const ignition::math::AxisAlignedBox &_modelBox)
+      {
+        return _frustum.Contains(_modelBox);
+      }, _models);
+}
+
+//////////////////////////////////////////////////
+/// \brief Magic number at the start of a world snapshot.
+static const uint32_t kSnapshotMagic = 0x4e535a47;
+
+/// \brief Version of the world snapshot layout.
+static const uint32_t kSnapshotVersion = 1;
+
+/// \brief Header of a world snapshot.
+struct SnapshotHeader
+{
+  /// \brief Always kSnapshotMagic.
+  uint32_t magic;
+
+  /// \brief Always kSnapshotVersion.
+  uint32_t version;
+
+  /// \brief Seconds of sim time.
+  int32_t simSec;
+
+  /// \brief Nanoseconds of sim time.
+  int32_t simNsec;
+
+  /// \brief Iteration count.
+  uint64_t iterations;
+
+  /// \brief Number of links.
+  uint64_t linkCount;
+
+  /// \brief Number of joints.
+  uint64_t jointCount;
+
+  /// \brief Hash of the physics engine type and the entity ids.
+  uint64_t hash;
+};
+
+//////////////////////////////////////////////////
+/// \brief Collect the links and joints of models and their nested models.
+/// \param[in] _models Models to traverse.
+/// \param[in,out] _links Links are appended here.
+/// \param[in,out] _joints Joints are appended here.
+static void CollectSnapshotEntities(const Model_V &_models, Link_V &_links,
+    Joint_V &_joints)
+{
+  for (auto const &model : _models)
+  {
+    const Link_V &links = model->GetLinks();
+    _links.insert(_links.end(), links.begin(), links.end());
+    const Joint_V &joints = model->GetJoints();
+    _joints.insert(_joints.end(), joints.begin(), joints.end());
+    CollectSnapshotEntities(model->NestedModels(), _links, _joints);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief FNV-1a hash of the physics engine type and entity ids, used to
+/// reject snapshots of a different world.
+static uint64_t SnapshotHash(const std::string &_engine, const Link_V &_links,
+    const Joint_V &_joints)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](const uint32_t _value)
+  {
+    hash = (hash ^ _value) * 1099511628211ULL;
+  };
+
+  for (auto const c : _engine)
+    mix(static_cast<unsigned char>(c));
+  for (auto const &link : _links)
+    mix(link->GetId());
+  for (auto const &joint : _joints)
+    mix(joint->GetId());
+  return hash;
+}
+
+//////////////////////////////////////////////////
+void World::SaveSnapshot(std::string &_data)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  this->dataPtr->snapshotLinks.clear();
+  this->dataPtr->snapshotJoints.clear();
+  CollectSnapshotEntities(this->dataPtr->models,
+      this->dataPtr->snapshotLinks, this->dataPtr->snapshotJoints);
+
+  SnapshotHeader header;
+  header.magic = kSnapshotMagic;
+  header.version = kSnapshotVersion;
+  header.simSec = this->dataPtr->simTime.sec;
+  header.simNsec = this->dataPtr->simTime.nsec;
+  header.iterations = this->dataPtr->iterations;
+  header.linkCount = this->dataPtr->snapshotLinks.size();
+  header.jointCount = this->dataPtr->snapshotJoints.size();
+  header.hash = SnapshotHash(this->dataPtr->physicsEngine->GetType(),
+      this->dataPtr->snapshotLinks, this->dataPtr->snapshotJoints);
+
+  _data.clear();
+  PhysicsEngine::WriteSnapshot(_data, &header, 1);
+  this->dataPtr->physicsEngine->SaveSnapshot(this->dataPtr->snapshotLinks,
+      this->dataPtr->snapshotJoints, _data);
+}
+
+//////////////////////////////////////////////////
+bool World::RestoreSnapshot(const std::string &_data)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->worldUpdateMutex);
+
+  const char *data = _data.data();
+  const char *end = data + _data.size();
+
+  SnapshotHeader header;
+  if (!PhysicsEngine::ReadSnapshot(data, end, &header, 1) ||
+      header.magic != kSnapshotMagic || header.version != kSnapshotVersion)
+  {
+    gzerr << "Invalid world snapshot\n";
+    return false;
+  }
+
+  this->dataPtr->snapshotLinks.clear();
+  this->dataPtr->snapshotJoints.clear();
+  CollectSnapshotEntities(this->dataPtr->models,
+      this->dataPtr->snapshotLinks, this->dataPtr->snapshotJoints);
+
+  if (header.linkCount != this->dataPtr->snapshotLinks.size() ||
+      header.jointCount != this->dataPtr->snapshotJoints.size() ||
+      header.hash != SnapshotHash(this->dataPtr->physicsEngine->GetType(),
+        this->dataPtr->snapshotLinks, this->dataPtr->snapshotJoints))
+  {
+    gzerr << "World snapshot does not match the entities of world ["
+          << this->Name() << "]\n";
+    return false;
+  }
+
+  if (!this->dataPtr->physicsEngine->RestoreSnapshot(
+        this->dataPtr->snapshotLinks, this->dataPtr->snapshotJoints,
+        data, end))
+  {
+    gzerr << "Truncated world snapshot\n";
+    return false;
+  }
+
+  this->dataPtr->simTime = common::Time(header.simSec, header.simNsec);
+  this->dataPtr->iterations = header.iterations;
+
+  // Engines that restore their bodies directly report the new poses
+  // through the dirty list, as in Update.
+  {
+    boost::recursive_mutex::scoped_lock plock(
+        *this->Physics()->GetPhysicsUpdateMutex());
+
+    for (auto &dirtyEntity : this->dataPtr->dirtyPoses)
+      dirtyEntity->SetWorldPose(dirtyEntity->DirtyPose(), false);
+
+    this->dataPtr->dirtyPoses.clear();
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 void World::SetState(const WorldState &_state)
 {
@@ -2418,6 +2903,7 @@ void World::InsertModelFile(const std::string &_sdfFilename)
   msgs::Factory msg;
   msg.set_sdf_filename(_sdfFilename);
   this->dataPtr->factoryMsgs.push_back(msg);
+  this->MessageReceived();
 }
 
 //////////////////////////////////////////////////
@@ -2427,6 +2913,21 @@ void World::InsertModelSDF(const sdf::SDF &_sdf)
   msgs::Factory msg;
   msg.set_sdf(_sdf.ToString());
   this->dataPtr->factoryMsgs.push_back(msg);
+  this->MessageReceived();
+}
+
+//////////////////////////////////////////////////
+void World::InsertModelElement(sdf::ElementPtr _modelElem)
+{
+  if (!_modelElem || _modelElem->GetName() != "model")
+  {
+    gzerr << "Unable to insert model, the SDF element is not a <model>\n";
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  this->dataPtr->factoryModelElems.push_back(_modelElem);
+  this->MessageReceived();
 }
 
 //////////////////////////////////////////////////
@@ -2436,6 +2937,7 @@ void World::InsertModelString(const std::string &_sdfString)
   msgs::Factory msg;
   msg.set_sdf(_sdfString);
   this->dataPtr->factoryMsgs.push_back(msg);
+  this->MessageReceived();
 }
 
 //////////////////////////////////////////////////
@@ -2680,7 +3182,7 @@ void World::ProcessMessages()
             msgs::Set(poseMsg, m->RelativePose());
 
             // Publish each of the model's child links relative poses
-            Link_V links = m->GetLinks();
+            const Link_V &links = m->GetLinks();
             for (auto const &link : links)
             {
               poseMsg = msg.add_pose();
@@ -2690,7 +3192,7 @@ void World::ProcessMessages()
             }
 
             // add all nested models to the queue
-            Model_V models = m->NestedModels();
+            const Model_V &models = m->NestedModels();
             for (auto const &n : models)
               modelList.push_back(n);
           }
@@ -2727,6 +3229,9 @@ void World::ProcessMessages()
       // }
     }
 
+    this->PublishPoseStream();
+
+    this->dataPtr->modelIndex.MarkDirty(this->dataPtr->publishModelPoses);
     this->dataPtr->publishModelPoses.clear();
     this->dataPtr->publishLightPoses.clear();
   }
@@ -2796,12 +3301,30 @@ void World::ProcessMessages()
         }
       }
     }
+    this->dataPtr->modelIndex.MarkDirty(this->dataPtr->publishModelScales);
     this->dataPtr->publishModelScales.clear();
   }
 
-  if (common::Time::GetWallTime() - this->dataPtr->prevProcessMsgsTime >
+  // The flag is set by the subscriber callbacks, so that steps without
+  // incoming messages neither lock nor visit the message buffers.
+  if (this->dataPtr->msgsPending &&
+      common::Time::GetWallTime() - this->dataPtr->prevProcessMsgsTime >
       this->dataPtr->processMsgsPeriod)
   {
+    // Clear the flag first, messages received while processing set it
+    // again and are handled by the next pass.
+    this->dataPtr->msgsPending = false;
+
+    unsigned int count;
+    common::Time received;
+    {
+      std::lock_guard<std::recursive_mutex> lock(
+          this->dataPtr->receiveMutex);
+      count = this->dataPtr->pendingMsgCount;
+      received = this->dataPtr->firstPendingMsgTime;
+      this->dataPtr->pendingMsgCount = 0;
+    }
+
     this->ProcessPlaybackControlMsgs();
     this->ProcessEntityMsgs();
     this->ProcessRequestMsgs();
@@ -2810,9 +3333,36 @@ void World::ProcessMessages()
     this->ProcessLightFactoryMsgs();
     this->ProcessLightModifyMsgs();
     this->dataPtr->prevProcessMsgsTime = common::Time::GetWallTime();
+
+    if (count > 0)
+    {
+      this->dataPtr->processedMsgCount += count;
+      this->dataPtr->msgLatency =
+          (this->dataPtr->prevProcessMsgsTime - received).Double();
+    }
   }
 }
 
+//////////////////////////////////////////////////
+void World::MessageReceived()
+{
+  if (this->dataPtr->pendingMsgCount++ == 0)
+    this->dataPtr->firstPendingMsgTime = common::Time::GetWallTime();
+  this->dataPtr->msgsPending = true;
+}
+
+//////////////////////////////////////////////////
+uint64_t World::ProcessedMessageCount() const
+{
+  return this->dataPtr->processedMsgCount;
+}
+
+//////////////////////////////////////////////////
+double World::MessageLatency() const
+{
+  return this->dataPtr->msgLatency;
+}
+
 //////////////////////////////////////////////////
 void World::PublishWorldStats()
 {
@@ -2828,6 +3378,16 @@ void World::PublishWorldStats()
   this->dataPtr->worldStatsMsg.set_iterations(this->dataPtr->iterations);
   this->dataPtr->worldStatsMsg.set_paused(this->IsPaused());
 
+  if (this->dataPtr->physicsEngine)
+  {
+    const SleepManager *sleepManager =
+      this->dataPtr->physicsEngine->GetSleepManager();
+    this->dataPtr->worldStatsMsg.set_sleeping_link_count(
+        sleepManager->SleepingCount());
+    this->dataPtr->worldStatsMsg.set_sleep_count(sleepManager->SleepCount());
+    this->dataPtr->worldStatsMsg.set_wake_count(sleepManager->WakeCount());
+  }
+
   if (util::LogPlay::Instance()->IsOpen())
   {
     msgs::LogPlaybackStatistics logStats;
@@ -2851,6 +3411,141 @@ bool World::IsLoaded() const
   return this->dataPtr->loaded;
 }
 
+//////////////////////////////////////////////////
+void World::PublishPoseStream()
+{
+  if (!this->dataPtr->poseStreamPub ||
+      !this->dataPtr->poseStreamPub->HasConnections())
+  {
+    // Start with a key frame once a subscriber connects
+    this->dataPtr->poseStreamPoses.clear();
+    return;
+  }
+
+  // Key frames let late subscribers learn the dictionary, and drop the
+  // entities that were removed.
+  const common::Time keyFramePeriod(2, 0);
+
+  auto &cache = this->dataPtr->poseStreamPoses;
+  const double resolution = this->dataPtr->poseStreamResolution;
+  const common::Time wallTime = common::Time::GetWallTime();
+  bool keyFrame = cache.empty() ||
+    wallTime - this->dataPtr->poseStreamKeyFrameTime > keyFramePeriod;
+
+  msgs::PoseStream &msg = this->dataPtr->poseStreamMsg;
+
+  // Add the pose of an entity to the message. Returns false if the
+  // entity is not in the dictionary yet.
+  auto addPose = [&](Entity *_entity) -> bool
+  {
+    const uint32_t id = _entity->GetId();
+    const ignition::math::Pose3d pose = _entity->RelativePose();
+
+    if (keyFrame)
+    {
+      msg.add_dict_id(id);
+      msg.add_dict_name(_entity->GetScopedName());
+      cache[id] = pose;
+      msgs::AddPose(msg, id, pose);
+      return true;
+    }
+
+    auto iter = cache.find(id);
+    if (iter == cache.end())
+      return false;
+
+    // Skip poses that didn't change by at least one quantization step
+    const ignition::math::Pose3d &last = iter->second;
+    bool changed;
+    if (resolution > 0)
+    {
+      const double rotStep = 1.0 / 32767.0;
+      changed =
+        std::abs(pose.Pos().X() - last.Pos().X()) >= resolution ||
+        std::abs(pose.Pos().Y() - last.Pos().Y()) >= resolution ||
+        std::abs(pose.Pos().Z() - last.Pos().Z()) >= resolution ||
+        std::abs(pose.Rot().W() - last.Rot().W()) >= rotStep ||
+        std::abs(pose.Rot().X() - last.Rot().X()) >= rotStep ||
+        std::abs(pose.Rot().Y() - last.Rot().Y()) >= rotStep ||
+        std::abs(pose.Rot().Z() - last.Rot().Z()) >= rotStep;
+    }
+    else
+    {
+      changed = pose != last;
+    }
+
+    if (changed)
+    {
+      iter->second = pose;
+      msgs::AddPose(msg, id, pose);
+    }
+    return true;
+  };
+
+  // Add a model, its links and its nested models.
+  std::function<bool(Model *)> addModel = [&](Model *_model) -> bool
+  {
+    bool known = addPose(_model);
+    for (auto const &link : _model->GetLinks())
+      known = addPose(link.get()) && known;
+    for (auto const &nested : _model->NestedModels())
+      known = addModel(nested.get()) && known;
+    return known;
+  };
+
+  for (int attempt = 0; attempt < 2; ++attempt)
+  {
+    msg.Clear();
+    msgs::Set(msg.mutable_time(), this->SimTime());
+    msg.set_key_frame(keyFrame);
+    msg.set_position_resolution(resolution);
+
+    bool known = true;
+    if (keyFrame)
+    {
+      cache.clear();
+      for (auto const &model : this->dataPtr->models)
+        addModel(model.get());
+      for (auto const &light : this->dataPtr->lights)
+        addPose(light.get());
+      this->dataPtr->poseStreamKeyFrameTime = wallTime;
+    }
+    else
+    {
+      // Only the entities which moved since the last message
+      for (auto const &model : this->dataPtr->publishModelPoses)
+        known = addModel(model.get()) && known;
+      for (auto const &light : this->dataPtr->publishLightPoses)
+        known = addPose(light.get()) && known;
+    }
+
+    // New entities are announced with a key frame
+    if (known)
+      break;
+    keyFrame = true;
+  }
+
+  if (msg.key_frame() || msg.id_size() > 0)
+    this->dataPtr->poseStreamPub->Publish(msg);
+}
+
+//////////////////////////////////////////////////
+void World::SetPoseStreamResolution(const double _resolution)
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  this->dataPtr->poseStreamResolution = std::max(0.0, _resolution);
+
+  // Send every pose again with the new resolution
+  this->dataPtr->poseStreamPoses.clear();
+}
+
+//////////////////////////////////////////////////
+double World::PoseStreamResolution() const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
+  return this->dataPtr->poseStreamResolution;
+}
+
 //////////////////////////////////////////////////
 void World::PublishModelPose(physics::ModelPtr _model)
 {
@@ -3033,6 +3728,7 @@ void World::RemoveModel(const std::string &_name)
       if ((*model)->GetName() == _name || (*model)->GetScopedName() == _name)
       {
         this->dataPtr->models.erase(model);
+        this->dataPtr->modelIndex.SetStale();
         this->dataPtr->rootElement->RemoveChild(_name);
         break;
       }
@@ -3100,11 +3796,48 @@ void World::RemoveModel(const std::string &_name)
   }
 }
 
+/////////////////////////////////////////////////
+void World::OnLinkWrenchesMsg(ConstLinkWrenchesPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->wrenchLinksMutex);
+
+  for (auto const &linkWrench : _msg->link_wrench())
+  {
+    auto &weakLink = this->dataPtr->wrenchLinks[linkWrench.link_name()];
+    LinkPtr link = weakLink.lock();
+    if (!link)
+    {
+      {
+        std::lock_guard<std::mutex> loadLock(this->dataPtr->loadModelMutex);
+        link = boost::dynamic_pointer_cast<Link>(
+            this->BaseByName(linkWrench.link_name()));
+      }
+      if (!link)
+      {
+        gzerr << "Unable to find link [" << linkWrench.link_name()
+              << "] to apply a wrench" << std::endl;
+        this->dataPtr->wrenchLinks.erase(linkWrench.link_name());
+        continue;
+      }
+      weakLink = link;
+    }
+
+    const msgs::Wrench &msg = linkWrench.wrench();
+    LinkWrench wrench;
+    wrench.force = msgs::ConvertIgn(msg.force());
+    wrench.torque = msgs::ConvertIgn(msg.torque());
+    if (msg.has_force_offset())
+      wrench.forceOffset = msgs::ConvertIgn(msg.force_offset());
+    link->QueueWrench(wrench);
+  }
+}
+
 /////////////////////////////////////////////////
 void World::OnLightModifyMsg(ConstLightPtr &_msg)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   this->dataPtr->lightModifyMsgs.push_back(*_msg);
+  this->MessageReceived();
 }
 
 /////////////////////////////////////////////////
@@ -3112,6 +3845,7 @@ void World::OnLightFactoryMsg(ConstLightPtr &_msg)
 {
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->receiveMutex);
   this->dataPtr->lightFactoryMsgs.push_back(*_msg);
+  this->MessageReceived();
 }
 
 /////////////////////////////////////////////////
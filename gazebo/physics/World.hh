@@ -26,6 +26,8 @@
 
 #include <boost/enable_shared_from_this.hpp>
 
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Frustum.hh>
 #include <sdf/sdf.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
@@ -293,10 +295,55 @@ namespace gazebo
       public: EntityPtr EntityBelowPoint(
                   const ignition::math::Vector3d &_pt) const;
 
+      /// \brief Get the models whose bounding box intersects a box.
+      /// Nested models are tested independently of their parent, since the
+      /// bounding box of a model does not include its nested models.
+      /// The query uses a spatial index of the models, so its cost depends
+      /// on the number of models near the box rather than on the number of
+      /// models in the world.
+      /// \param[in] _box Box in world coordinates.
+      /// \param[out] _models The models found are appended to this list.
+      public: void ModelsInBox(const ignition::math::AxisAlignedBox &_box,
+                  Model_V &_models) const;
+
+      /// \brief Get the models whose bounding box intersects a sphere.
+      /// \param[in] _center Center of the sphere in world coordinates.
+      /// \param[in] _radius Radius of the sphere.
+      /// \param[out] _models The models found are appended to this list.
+      /// \sa ModelsInBox
+      public: void ModelsInSphere(const ignition::math::Vector3d &_center,
+                  const double _radius, Model_V &_models) const;
+
+      /// \brief Get the models whose bounding box is inside a frustum,
+      /// using the same test as ignition::math::Frustum::Contains.
+      /// \param[in] _frustum Frustum in world coordinates.
+      /// \param[out] _models The models found are appended to this list.
+      /// \sa ModelsInBox
+      public: void ModelsInFrustum(const ignition::math::Frustum &_frustum,
+                  Model_V &_models) const;
+
       /// \brief Set the current world state.
       /// \param _state The state to set the World to.
       public: void SetState(const WorldState &_state);
 
+      /// \brief Save the dynamic state of the world into a compact binary
+      /// snapshot: sim time, iterations, and the state of every link and
+      /// joint as stored by PhysicsEngine::SaveSnapshot. Unlike a
+      /// WorldState, a snapshot is positional instead of keyed by name,
+      /// and includes the internal state of the physics engine, so it is
+      /// only valid for this world instance and as long as no entity is
+      /// added or removed.
+      /// \param[out] _data Snapshot buffer. Its capacity is reused.
+      public: void SaveSnapshot(std::string &_data);
+
+      /// \brief Restore a snapshot written by SaveSnapshot in a single
+      /// pass.
+      /// \param[in] _data Snapshot buffer.
+      /// \return False if the snapshot does not match the entities of the
+      /// world or the physics engine, in which case the world may be
+      /// partially restored.
+      public: bool RestoreSnapshot(const std::string &_data);
+
       /// \brief Insert a model from an SDF file.
       /// Spawns a model into the world base on and SDF file.
       /// \param[in] _sdfFilename The name of the SDF file (including path).
@@ -312,6 +359,14 @@ namespace gazebo
       /// \param[in] _sdf A reference to an SDF object.
       public: void InsertModelSDF(const sdf::SDF &_sdf);
 
+      /// \brief Insert a model from a parsed <model> element.
+      /// The element is loaded as is, without being serialized and parsed
+      /// again, which makes it the cheapest way to spawn many copies of a
+      /// model. The world takes ownership of the element, so callers
+      /// should pass a clone when they reuse a template.
+      /// \param[in] _modelElem A <model> SDF element.
+      public: void InsertModelElement(sdf::ElementPtr _modelElem);
+
       /// \brief Return a version of the name with "<world_name>::" removed
       /// \param[in] _name Usually the name of an entity.
       /// \return The stripped world name.
@@ -400,6 +455,77 @@ namespace gazebo
       /// \param[in] _light Pointer to the light to publish.
       public: void PublishLightPose(const physics::LightPtr _light);
 
+      /// \brief Set the position resolution of the compact pose stream
+      /// published on ~/pose/stream. Positions are rounded to multiples of
+      /// the resolution and orientations to 16 bit components, and only
+      /// poses that change by at least one step are sent.
+      /// \param[in] _resolution Resolution in meters. Zero sends full
+      /// precision poses.
+      public: void SetPoseStreamResolution(const double _resolution);
+
+      /// \brief Get the position resolution of the compact pose stream.
+      /// \return Resolution in meters, zero for full precision.
+      public: double PoseStreamResolution() const;
+
+      /// \brief Enable or disable batch mode. In batch mode the world
+      /// steps physics back to back, without reading the wall clock or
+      /// sleeping to match the real time update rate, and only publishes
+      /// statistics, notifies introspection and processes incoming
+      /// messages every few iterations. This is meant for headless runs
+      /// that should finish as fast as possible.
+      /// \param[in] _steps Number of iterations between housekeeping
+      /// passes. Zero disables batch mode.
+      /// \param[in] _simPeriod Optional sim time period in seconds that
+      /// also triggers a housekeeping pass when it elapses, so that
+      /// clients keep seeing regular updates with small step sizes.
+      /// Zero only uses the iteration count.
+      public: void SetBatchMode(const unsigned int _steps,
+                                const double _simPeriod = 0);
+
+      /// \brief Get the number of iterations between housekeeping passes
+      /// in batch mode.
+      /// \return Number of iterations, zero if batch mode is disabled.
+      public: unsigned int BatchSteps() const;
+
+      /// \brief Get the number of physics iterations per wall clock
+      /// second, measured about once per second by the housekeeping
+      /// passes of batch mode.
+      /// \return Iterations per second, zero before the first
+      /// measurement or if batch mode was never enabled.
+      public: double StepsPerSecond() const;
+
+      /// \brief Connect to the update begin event of this world. Unlike
+      /// event::Events::ConnectWorldUpdateBegin, the subscriber is only
+      /// called for the updates of this world, from the thread that steps
+      /// it, which matters when several worlds are stepped in parallel by
+      /// a WorldBatch. It is called before the global event.
+      /// \param[in] _subscriber Callback.
+      /// \return Connection, the subscriber is disconnected when it is
+      /// released.
+      public: event::ConnectionPtr ConnectWorldUpdateBegin(
+                  std::function<void (const common::UpdateInfo &)>
+                  _subscriber);
+
+      /// \brief Connect to the update end event of this world, see
+      /// ConnectWorldUpdateBegin.
+      /// \param[in] _subscriber Callback.
+      /// \return Connection, the subscriber is disconnected when it is
+      /// released.
+      public: event::ConnectionPtr ConnectWorldUpdateEnd(
+                  std::function<void ()> _subscriber);
+
+      /// \brief Get the number of incoming messages (factory, request,
+      /// model, light and playback control messages, and model insertions)
+      /// that have been applied to the world.
+      /// \return Number of messages applied since the world was created.
+      public: uint64_t ProcessedMessageCount() const;
+
+      /// \brief Get the time the oldest message applied by the last
+      /// message processing pass waited before being applied.
+      /// \return Latency in wall clock seconds, zero if no message has
+      /// been applied yet.
+      public: double MessageLatency() const;
+
       /// \brief Get the total number of iterations.
       /// \return Number of iterations that simulation has taken.
       public: uint32_t Iterations() const;
@@ -507,9 +633,20 @@ namespace gazebo
       /// \brief Function to run physics. Used by physicsThread.
       private: void RunLoop();
 
+      /// \brief Prepare the world to be stepped from the calling thread:
+      /// initialize the physics engine for the thread, reset the wall
+      /// clock references and start the log worker.
+      private: void StartLoop();
+
+      /// \brief Stop stepping the world and join the log worker.
+      private: void StopLoop();
+
       /// \brief Step the world once.
       private: void Step();
 
+      /// \brief Step the world in batch mode, see SetBatchMode.
+      private: void BatchStep();
+
       /// \brief Step the world once by reading from a log file.
       private: void LogStep();
 
@@ -553,6 +690,11 @@ namespace gazebo
       /// \param[in] _msg The model message.
       private: void OnModelMsg(ConstModelPtr &_msg);
 
+      /// \brief Called when wrenches for many links are received. Each
+      /// wrench is queued to its link, see Link::QueueWrench.
+      /// \param[in] _msg The wrenches.
+      private: void OnLinkWrenchesMsg(ConstLinkWrenchesPtr &_msg);
+
       /// \brief TBB version of model updating.
       private: void ModelUpdateTBB();
 
@@ -606,6 +748,17 @@ namespace gazebo
       /// \brief Process all incoming messages.
       private: void ProcessMessages();
 
+      /// \brief Record that a message was added to one of the message
+      /// buffers, so that the next call to ProcessMessages handles it.
+      /// Must be called with the receive mutex locked.
+      private: void MessageReceived();
+
+      /// \brief Publish the compact pose stream. Sends a key frame with
+      /// every entity when needed, otherwise the poses that changed among
+      /// the entities waiting to publish their pose.
+      /// Must only be called from the World::ProcessMessages function.
+      private: void PublishPoseStream();
+
       /// \brief Publish the world stats message.
       private: void PublishWorldStats();
 
@@ -656,6 +809,9 @@ namespace gazebo
 
       /// Friend SimbodyPhysics so that it has access to dataPtr->dirtyPoses
       private: friend class SimbodyPhysics;
+
+      /// Friend WorldBatch so that it can step the world from a thread pool
+      private: friend class WorldBatch;
     };
     /// \}
   }
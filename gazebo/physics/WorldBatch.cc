@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "gazebo/common/Console.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsEngine.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldPrivate.hh"
+#include "gazebo/physics/WorldState.hh"
+#include "gazebo/physics/WorldBatch.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \internal
+    /// \brief Private data for the WorldBatch class
+    class WorldBatchPrivate
+    {
+      /// \brief A world of the batch.
+      public: struct Entry
+      {
+        /// \brief The world.
+        WorldPtr world;
+
+        /// \brief Snapshot restored by a reset.
+        std::string resetSnapshot;
+
+        /// \brief State restored by a reset if the snapshot no longer
+        /// matches the world.
+        WorldState resetState;
+
+        /// \brief Observed models, in the order of modelNames. Missing
+        /// models are null.
+        std::vector<ModelPtr> models;
+      };
+
+      /// \brief Worlds of the batch.
+      public: std::vector<Entry> entries;
+
+      /// \brief Iterations between housekeeping passes of each world.
+      public: unsigned int housekeepingSteps;
+
+      /// \brief Names of the observed models.
+      public: std::vector<std::string> modelNames;
+
+      /// \brief Custom observation function.
+      public: WorldBatch::ObservationFunc observationFunc;
+
+      /// \brief Number of values written by observationFunc.
+      public: size_t observationFuncSize = 0;
+
+      /// \brief Observations of all the worlds, one row per world.
+      public: std::vector<double> observations;
+    };
+  }
+}
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Number of observed values per model.
+static const size_t kModelObservationSize = 13;
+
+/////////////////////////////////////////////////
+/// \brief Look up the observed models of a world.
+/// \param[in] _names Model names.
+/// \param[in,out] _entry World entry to update.
+static void ResolveModels(const std::vector<std::string> &_names,
+    WorldBatchPrivate::Entry &_entry)
+{
+  _entry.models.clear();
+  for (auto const &name : _names)
+    _entry.models.push_back(_entry.world->ModelByName(name));
+}
+
+/////////////////////////////////////////////////
+/// \brief Write the observation of a world.
+/// \param[in] _data Batch data.
+/// \param[in] _index Index of the world.
+static void Observe(WorldBatchPrivate &_data, const size_t _index)
+{
+  const size_t size = _data.modelNames.size() * kModelObservationSize +
+      _data.observationFuncSize;
+  if (size == 0)
+    return;
+
+  auto &entry = _data.entries[_index];
+  double *obs = _data.observations.data() + _index * size;
+
+  for (auto const &model : entry.models)
+  {
+    if (!model)
+    {
+      std::fill(obs, obs + kModelObservationSize, 0.0);
+      obs += kModelObservationSize;
+      continue;
+    }
+
+    const ignition::math::Pose3d &pose = model->WorldPose();
+    const ignition::math::Vector3d linVel = model->WorldLinearVel();
+    const ignition::math::Vector3d angVel = model->WorldAngularVel();
+
+    *obs++ = pose.Pos().X();
+    *obs++ = pose.Pos().Y();
+    *obs++ = pose.Pos().Z();
+    *obs++ = pose.Rot().W();
+    *obs++ = pose.Rot().X();
+    *obs++ = pose.Rot().Y();
+    *obs++ = pose.Rot().Z();
+    *obs++ = linVel.X();
+    *obs++ = linVel.Y();
+    *obs++ = linVel.Z();
+    *obs++ = angVel.X();
+    *obs++ = angVel.Y();
+    *obs++ = angVel.Z();
+  }
+
+  if (_data.observationFunc)
+    _data.observationFunc(entry.world, obs);
+}
+
+/////////////////////////////////////////////////
+WorldBatch::WorldBatch(const unsigned int _housekeepingSteps)
+  : dataPtr(new WorldBatchPrivate)
+{
+  this->dataPtr->housekeepingSteps = std::max(1u, _housekeepingSteps);
+}
+
+/////////////////////////////////////////////////
+WorldBatch::~WorldBatch()
+{
+  this->Clear();
+}
+
+/////////////////////////////////////////////////
+bool WorldBatch::AddWorld(const WorldPtr &_world)
+{
+  if (!_world || !_world->IsLoaded())
+  {
+    gzerr << "Unable to add a world that is not loaded to the batch\n";
+    return false;
+  }
+
+  if (_world->dataPtr->thread)
+  {
+    gzerr << "World [" << _world->Name() << "] is already running its own "
+          << "update thread and can't be added to the batch\n";
+    return false;
+  }
+
+  for (auto const &entry : this->dataPtr->entries)
+  {
+    if (entry.world == _world)
+    {
+      gzerr << "World [" << _world->Name() << "] is already in the batch\n";
+      return false;
+    }
+  }
+
+  _world->dataPtr->stop = false;
+  _world->dataPtr->stopIterations = 0;
+  _world->SetBatchMode(this->dataPtr->housekeepingSteps);
+  _world->StartLoop();
+
+  WorldBatchPrivate::Entry entry;
+  entry.world = _world;
+  entry.resetState = WorldState(_world);
+  _world->SaveSnapshot(entry.resetSnapshot);
+  ResolveModels(this->dataPtr->modelNames, entry);
+  this->dataPtr->entries.push_back(entry);
+
+  this->dataPtr->observations.resize(
+      this->dataPtr->entries.size() * this->ObservationSize(), 0.0);
+  Observe(*this->dataPtr, this->dataPtr->entries.size() - 1);
+
+  return true;
+}
+
+/////////////////////////////////////////////////
+void WorldBatch::Clear()
+{
+  for (auto &entry : this->dataPtr->entries)
+  {
+    entry.world->StopLoop();
+    entry.world->SetBatchMode(0);
+  }
+
+  this->dataPtr->entries.clear();
+  this->dataPtr->observations.clear();
+}
+
+/////////////////////////////////////////////////
+size_t WorldBatch::WorldCount() const
+{
+  return this->dataPtr->entries.size();
+}
+
+/////////////////////////////////////////////////
+WorldPtr WorldBatch::WorldByIndex(const size_t _index) const
+{
+  if (_index >= this->dataPtr->entries.size())
+    return WorldPtr();
+  return this->dataPtr->entries[_index].world;
+}
+
+/////////////////////////////////////////////////
+void WorldBatch::Step(const unsigned int _steps)
+{
+  WorldBatchPrivate &data = *this->dataPtr;
+
+  // One task per world: a world is always stepped by a single thread at a
+  // time, and small worlds are too cheap to split further.
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, data.entries.size(), 1),
+      [&data, _steps](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+        {
+          const WorldPtr &world = data.entries[i].world;
+
+          // Pool threads are not tied to a world, so the physics engine
+          // per thread data has to be set up for each task.
+          world->dataPtr->physicsEngine->InitForThread();
+
+          for (unsigned int s = 0; s < _steps && !world->dataPtr->stop; ++s)
+            world->BatchStep();
+
+          Observe(data, i);
+        }
+      });
+}
+
+/////////////////////////////////////////////////
+void WorldBatch::SetObservation(const size_t _size, ObservationFunc _func)
+{
+  this->dataPtr->observationFunc = _func;
+  this->dataPtr->observationFuncSize = _func ? _size : 0;
+  this->dataPtr->observations.assign(
+      this->dataPtr->entries.size() * this->ObservationSize(), 0.0);
+
+  for (size_t i = 0; i < this->dataPtr->entries.size(); ++i)
+    Observe(*this->dataPtr, i);
+}
+
+/////////////////////////////////////////////////
+void WorldBatch::SetModelObservation(const std::vector<std::string> &_models)
+{
+  this->dataPtr->modelNames = _models;
+  this->dataPtr->observations.assign(
+      this->dataPtr->entries.size() * this->ObservationSize(), 0.0);
+
+  for (size_t i = 0; i < this->dataPtr->entries.size(); ++i)
+  {
+    ResolveModels(this->dataPtr->modelNames, this->dataPtr->entries[i]);
+    Observe(*this->dataPtr, i);
+  }
+}
+
+/////////////////////////////////////////////////
+size_t WorldBatch::ObservationSize() const
+{
+  return this->dataPtr->modelNames.size() * kModelObservationSize +
+      this->dataPtr->observationFuncSize;
+}
+
+/////////////////////////////////////////////////
+const double *WorldBatch::Observations() const
+{
+  return this->dataPtr->observations.data();
+}
+
+/////////////////////////////////////////////////
+void WorldBatch::CacheState(const size_t _index)
+{
+  if (_index >= this->dataPtr->entries.size())
+  {
+    gzerr << "Invalid world index [" << _index << "]\n";
+    return;
+  }
+
+  auto &entry = this->dataPtr->entries[_index];
+  std::lock_guard<std::recursive_mutex> lock(
+      entry.world->dataPtr->worldUpdateMutex);
+  entry.resetState = WorldState(entry.world);
+  entry.world->SaveSnapshot(entry.resetSnapshot);
+}
+
+/////////////////////////////////////////////////
+void WorldBatch::Reset(const std::vector<size_t> &_indices)
+{
+  WorldBatchPrivate &data = *this->dataPtr;
+
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, _indices.size(), 1),
+      [&data, &_indices](const tbb::blocked_range<size_t> &_r)
+      {
+        for (size_t i = _r.begin(); i != _r.end(); ++i)
+        {
+          const size_t index = _indices[i];
+          if (index >= data.entries.size())
+            continue;
+
+          auto &entry = data.entries[index];
+          {
+            std::lock_guard<std::recursive_mutex> lock(
+                entry.world->dataPtr->worldUpdateMutex);
+            entry.world->dataPtr->physicsEngine->InitForThread();
+            if (!entry.world->RestoreSnapshot(entry.resetSnapshot))
+            {
+              entry.world->SetState(entry.resetState);
+              entry.world->dataPtr->physicsEngine->Reset();
+            }
+          }
+
+          ResolveModels(data.modelNames, entry);
+          Observe(data, index);
+        }
+      });
+}
+
+/////////////////////////////////////////////////
+void WorldBatch::ResetAll()
+{
+  std::vector<size_t> indices(this->dataPtr->entries.size());
+  for (size_t i = 0; i < indices.size(); ++i)
+    indices[i] = i;
+  this->Reset(indices);
+}
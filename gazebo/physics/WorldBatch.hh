@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WORLDBATCH_HH_
+#define GAZEBO_PHYSICS_WORLDBATCH_HH_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class WorldBatchPrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class WorldBatch WorldBatch.hh physics/physics.hh
+    /// \brief Steps many independent worlds in lockstep on a shared thread
+    /// pool, instead of giving every world its own update thread. This is
+    /// meant for running many small copies of an environment in a single
+    /// process, e.g. for reinforcement learning. After every call to Step
+    /// an observation vector is gathered from each world into a single
+    /// contiguous buffer, and each world can be reset to a cached state
+    /// without reloading it.
+    ///
+    /// Worlds must be loaded and initialized, but not running, when they
+    /// are added. They run in batch mode (see World::SetBatchMode) while
+    /// they belong to the batch.
+    class GZ_PHYSICS_VISIBLE WorldBatch
+    {
+      /// \brief Function that writes the observation of a world.
+      /// \param[in] _world The world to observe.
+      /// \param[out] _obs Observation buffer of the world, its size is
+      /// given to SetObservation.
+      public: using ObservationFunc =
+          std::function<void(const WorldPtr &_world, double *_obs)>;
+
+      /// \brief Constructor.
+      /// \param[in] _housekeepingSteps Number of iterations between the
+      /// housekeeping passes (statistics, message processing) of every
+      /// world.
+      public: explicit WorldBatch(const unsigned int _housekeepingSteps = 100);
+
+      /// \brief Destructor. Releases all the worlds.
+      public: ~WorldBatch();
+
+      /// \brief Add a world to the batch. The current state of the world
+      /// is cached as its reset state.
+      /// \param[in] _world Loaded and initialized world, which must not be
+      /// running its own update thread.
+      /// \return True if the world was added.
+      public: bool AddWorld(const WorldPtr &_world);
+
+      /// \brief Remove all the worlds from the batch. The worlds are left
+      /// stopped and can be run again with World::Run.
+      public: void Clear();
+
+      /// \brief Get the number of worlds.
+      /// \return Number of worlds in the batch.
+      public: size_t WorldCount() const;
+
+      /// \brief Get a world by index.
+      /// \param[in] _index Index of the world, in insertion order.
+      /// \return The world, or nullptr if the index is out of range.
+      public: WorldPtr WorldByIndex(const size_t _index) const;
+
+      /// \brief Step every world, in parallel, and gather the observations.
+      /// Returns once all the worlds have taken all the steps.
+      /// \param[in] _steps Number of iterations to step each world.
+      public: void Step(const unsigned int _steps = 1);
+
+      /// \brief Set a function used to observe the worlds. It is called
+      /// in parallel, once per world, at the end of every Step and after a
+      /// reset. Its values follow the model observations in each row.
+      /// \param[in] _size Number of values written by the function.
+      /// \param[in] _func Function that writes the observation, nullptr to
+      /// only observe models.
+      public: void SetObservation(const size_t _size, ObservationFunc _func);
+
+      /// \brief Observe the pose and velocity of a few models in every
+      /// world. Each model contributes 13 values: world position (x, y, z),
+      /// orientation (w, x, y, z), linear velocity and angular velocity.
+      /// Missing models are reported as zeros.
+      /// \param[in] _models Names of the models to observe.
+      public: void SetModelObservation(const std::vector<std::string> &_models);
+
+      /// \brief Get the number of values in the observation of one world.
+      /// \return Observation size.
+      public: size_t ObservationSize() const;
+
+      /// \brief Get the observations gathered by the last Step, one row
+      /// of ObservationSize() values per world.
+      /// \return Pointer to WorldCount() * ObservationSize() values.
+      public: const double *Observations() const;
+
+      /// \brief Cache the current state of a world as its reset state.
+      /// \param[in] _index Index of the world.
+      public: void CacheState(const size_t _index);
+
+      /// \brief Restore the cached state of some worlds, in parallel,
+      /// from a binary snapshot (see World::SaveSnapshot). If entities
+      /// were added or removed since the state was cached, the world
+      /// falls back to World::SetState, which resets time, link poses and
+      /// link velocities but does not remove inserted models.
+      /// \param[in] _indices Distinct indices of the worlds to reset.
+      public: void Reset(const std::vector<size_t> &_indices);
+
+      /// \brief Restore the cached state of every world.
+      public: void ResetAll();
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WorldBatchPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
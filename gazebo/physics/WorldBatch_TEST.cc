@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/Link.hh"
+#include "gazebo/physics/Model.hh"
+#include "gazebo/physics/PhysicsIface.hh"
+#include "gazebo/physics/World.hh"
+#include "gazebo/physics/WorldBatch.hh"
+#include "gazebo/physics/WrenchQueue.hh"
+#include "gazebo/test/ServerFixture.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class WorldBatchTest : public ServerFixture
+{
+  /// \brief Create a world with a sphere falling from 2 meters.
+  /// \param[in] _name Name of the world.
+  /// \return The new world, loaded and initialized.
+  protected: physics::WorldPtr CreateWorld(const std::string &_name)
+  {
+    std::string worldStr =
+      "<sdf version='" + std::string(SDF_VERSION) + "'>"
+      "<world name='" + _name + "'>"
+      "  <model name='sphere'>"
+      "    <pose>0 0 2 0 0 0</pose>"
+      "    <link name='link'>"
+      "      <collision name='collision'>"
+      "        <geometry><sphere><radius>0.5</radius></sphere></geometry>"
+      "      </collision>"
+      "    </link>"
+      "  </model>"
+      "</world>"
+      "</sdf>";
+
+    sdf::SDFPtr worldSDF(new sdf::SDF);
+    worldSDF->SetFromString(worldStr);
+
+    physics::WorldPtr world = physics::create_world(_name);
+    physics::load_world(world, worldSDF->Root()->GetElement("world"));
+    physics::init_world(world, nullptr);
+    return world;
+  }
+
+  /// \brief Create a world without gravity, with wind, and a sphere
+  /// pushed by a constant force and dragged by the wind at every update.
+  /// \param[in] _name Name of the world.
+  /// \param[in] _wind Wind velocity.
+  /// \param[in] _force Constant force on the sphere.
+  /// \return The new world, loaded and initialized.
+  protected: physics::WorldPtr CreateWindWorld(const std::string &_name,
+      const ignition::math::Vector3d &_wind,
+      const ignition::math::Vector3d &_force)
+  {
+    std::ostringstream worldStr;
+    worldStr
+      << "<sdf version='" << SDF_VERSION << "'>"
+      << "<world name='" << _name << "'>"
+      << "  <gravity>0 0 0</gravity>"
+      << "  <wind><linear_velocity>" << _wind << "</linear_velocity></wind>"
+      << "  <model name='sphere'>"
+      << "    <pose>0 0 2 0 0 0</pose>"
+      << "    <link name='link'>"
+      << "      <enable_wind>true</enable_wind>"
+      << "      <collision name='collision'>"
+      << "        <geometry><sphere><radius>0.5</radius></sphere></geometry>"
+      << "      </collision>"
+      << "    </link>"
+      << "  </model>"
+      << "</world>"
+      << "</sdf>";
+
+    sdf::SDFPtr worldSDF(new sdf::SDF);
+    worldSDF->SetFromString(worldStr.str());
+
+    physics::WorldPtr world = physics::create_world(_name);
+    physics::load_world(world, worldSDF->Root()->GetElement("world"));
+    physics::init_world(world, nullptr);
+
+    physics::LinkPtr link = world->ModelByName("sphere")->GetLink("link");
+    physics::Link *linkPtr = link.get();
+    this->connections.push_back(world->ConnectWorldUpdateBegin(
+        [linkPtr, _force](const common::UpdateInfo &)
+        {
+          // Linear drag towards the wind velocity
+          physics::LinkWrench wrench;
+          wrench.force = _force + 0.5 *
+              (linkPtr->WorldWindLinearVel() - linkPtr->WorldLinearVel());
+          linkPtr->QueueWrench(wrench);
+        }));
+    return world;
+  }
+
+  /// \brief Create a world with a stack of boxes tumbling onto the
+  /// ground, which keeps the constraint solver busy.
+  /// \param[in] _name Name of the world.
+  /// \return The new world, loaded and initialized.
+  protected: physics::WorldPtr CreateStackWorld(const std::string &_name)
+  {
+    std::ostringstream worldStr;
+    worldStr
+      << "<sdf version='" << SDF_VERSION << "'>"
+      << "<world name='" << _name << "'>"
+      << "  <model name='ground'>"
+      << "    <static>true</static>"
+      << "    <link name='link'>"
+      << "      <collision name='collision'>"
+      << "        <geometry><box><size>10 10 1</size></box></geometry>"
+      << "      </collision>"
+      << "    </link>"
+      << "  </model>";
+    for (int i = 0; i < 4; ++i)
+    {
+      worldStr
+        << "  <model name='box_" << i << "'>"
+        << "    <pose>" << 0.1 * i << " 0 " << 1 + 0.6 * i << " 0 0.3 0</pose>"
+        << "    <link name='link'>"
+        << "      <collision name='collision'>"
+        << "        <geometry><box><size>0.5 0.5 0.5</size></box></geometry>"
+        << "      </collision>"
+        << "    </link>"
+        << "  </model>";
+    }
+    worldStr << "</world></sdf>";
+
+    sdf::SDFPtr worldSDF(new sdf::SDF);
+    worldSDF->SetFromString(worldStr.str());
+
+    physics::WorldPtr world = physics::create_world(_name);
+    physics::load_world(world, worldSDF->Root()->GetElement("world"));
+    physics::init_world(world, nullptr);
+    return world;
+  }
+
+  // Documentation inherited
+  protected: void TearDown() override
+  {
+    // Disconnect before the worlds go away
+    this->connections.clear();
+    ServerFixture::TearDown();
+  }
+
+  /// \brief Update connections of the wind worlds.
+  protected: std::vector<event::ConnectionPtr> connections;
+};
+
+//////////////////////////////////////////////////
+TEST_F(WorldBatchTest, StepAndReset)
+{
+  this->Load("worlds/blank.world", true);
+
+  physics::WorldBatch batch(10);
+
+  // A world running its own thread can't be added
+  EXPECT_FALSE(batch.AddWorld(physics::get_world("default")));
+  EXPECT_EQ(batch.WorldCount(), 0u);
+
+  const size_t worldCount = 4;
+  for (size_t i = 0; i < worldCount; ++i)
+  {
+    auto world = this->CreateWorld("batch_" + std::to_string(i));
+    ASSERT_NE(nullptr, world);
+    EXPECT_TRUE(batch.AddWorld(world));
+    EXPECT_FALSE(batch.AddWorld(world));
+  }
+  EXPECT_EQ(batch.WorldCount(), worldCount);
+  EXPECT_EQ(nullptr, batch.WorldByIndex(worldCount));
+
+  batch.SetModelObservation({"sphere", "missing"});
+  batch.SetObservation(1,
+      [](const physics::WorldPtr &_world, double *_obs)
+      {
+        *_obs = _world->SimTime().Double();
+      });
+  const size_t size = 2 * 13 + 1;
+  ASSERT_EQ(batch.ObservationSize(), size);
+
+  const double *obs = batch.Observations();
+  for (size_t i = 0; i < worldCount; ++i)
+  {
+    EXPECT_DOUBLE_EQ(obs[i * size + 2], 2.0);
+    EXPECT_DOUBLE_EQ(obs[i * size + 3], 1.0);
+    EXPECT_DOUBLE_EQ(obs[i * size + 26], 0.0);
+  }
+
+  // Let the spheres fall
+  batch.Step(200);
+  obs = batch.Observations();
+  for (size_t i = 0; i < worldCount; ++i)
+  {
+    auto world = batch.WorldByIndex(i);
+    ASSERT_NE(nullptr, world);
+    EXPECT_EQ(world->Iterations(), 200u);
+    EXPECT_NEAR(obs[i * size + 26], world->SimTime().Double(), 1e-9);
+
+    // Falling, and identical in every world
+    EXPECT_LT(obs[i * size + 2], 2.0);
+    EXPECT_LT(obs[i * size + 9], 0.0);
+    EXPECT_DOUBLE_EQ(obs[i * size + 2], obs[2]);
+
+    // The missing model reads as zeros
+    for (size_t j = 13; j < 26; ++j)
+      EXPECT_DOUBLE_EQ(obs[i * size + j], 0.0);
+  }
+
+  // Reset a single world
+  batch.Reset({1});
+  obs = batch.Observations();
+  EXPECT_DOUBLE_EQ(obs[size + 2], 2.0);
+  EXPECT_DOUBLE_EQ(obs[size + 9], 0.0);
+  EXPECT_DOUBLE_EQ(obs[size + 26], 0.0);
+  EXPECT_LT(obs[2], 2.0);
+
+  // Reset the rest
+  batch.ResetAll();
+  obs = batch.Observations();
+  for (size_t i = 0; i < worldCount; ++i)
+    EXPECT_DOUBLE_EQ(obs[i * size + 2], 2.0);
+
+  batch.Clear();
+  EXPECT_EQ(batch.WorldCount(), 0u);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldBatchTest, PauseStepIncAndClear)
+{
+  this->Load("worlds/blank.world", true);
+
+  physics::WorldBatch batch(10);
+  auto paused = this->CreateWorld("batch_paused");
+  auto running = this->CreateWorld("batch_running");
+  ASSERT_NE(nullptr, paused);
+  ASSERT_NE(nullptr, running);
+  EXPECT_TRUE(batch.AddWorld(paused));
+  EXPECT_TRUE(batch.AddWorld(running));
+
+  // A paused world doesn't move, the others do
+  paused->SetPaused(true);
+  batch.Step(50);
+  EXPECT_EQ(paused->Iterations(), 0u);
+  EXPECT_EQ(running->Iterations(), 50u);
+
+  // Multi step requests are honored while paused
+  transport::NodePtr node(new transport::Node());
+  node->Init("batch_paused");
+  transport::PublisherPtr controlPub =
+    node->Advertise<msgs::WorldControl>("~/world_control");
+  msgs::WorldControl msg;
+  msg.set_multi_step(5);
+  controlPub->Publish(msg);
+
+  for (int i = 0; i < 100 && paused->Iterations() == 0u; ++i)
+  {
+    batch.Step(1);
+    common::Time::MSleep(10);
+  }
+  batch.Step(50);
+  EXPECT_EQ(paused->Iterations(), 5u);
+  EXPECT_TRUE(paused->IsPaused());
+
+  // Clearing one world leaves the other untouched
+  EXPECT_NE(nullptr, running->ModelByName("sphere"));
+  paused->Clear();
+  batch.Step(1);
+  EXPECT_EQ(nullptr, paused->ModelByName("sphere"));
+  EXPECT_NE(nullptr, running->ModelByName("sphere"));
+
+  batch.Clear();
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldBatchTest, WindAndWrenchMatchSingleWorld)
+{
+  this->Load("worlds/blank.world", true);
+
+  const size_t worldCount = 4;
+  const unsigned int steps = 500;
+  auto wind = [](const size_t _i)
+  {
+    return ignition::math::Vector3d(0, 1.0 + _i, 0);
+  };
+  auto force = [](const size_t _i)
+  {
+    return ignition::math::Vector3d(0.5 * _i, 0, 1.0 - _i);
+  };
+
+  // Step every world on its own
+  std::vector<ignition::math::Vector3d> expected;
+  for (size_t i = 0; i < worldCount; ++i)
+  {
+    physics::WorldBatch single;
+    EXPECT_TRUE(single.AddWorld(this->CreateWindWorld(
+        "single_" + std::to_string(i), wind(i), force(i))));
+    single.Step(steps);
+    expected.push_back(single.WorldByIndex(0)->ModelByName("sphere")->
+        GetLink("link")->WorldPose().Pos());
+    single.Clear();
+  }
+
+  // Then all of them in parallel
+  physics::WorldBatch batch;
+  for (size_t i = 0; i < worldCount; ++i)
+  {
+    EXPECT_TRUE(batch.AddWorld(this->CreateWindWorld(
+        "parallel_" + std::to_string(i), wind(i), force(i))));
+  }
+  batch.Step(steps);
+
+  for (size_t i = 0; i < worldCount; ++i)
+  {
+    auto world = batch.WorldByIndex(i);
+    ASSERT_NE(nullptr, world);
+    EXPECT_EQ(world->Iterations(), steps);
+
+    physics::LinkPtr link = world->ModelByName("sphere")->GetLink("link");
+    EXPECT_EQ(link->WorldWindLinearVel(), wind(i));
+
+    // Blown by the wind of its own world only
+    const ignition::math::Vector3d pos = link->WorldPose().Pos();
+    EXPECT_GT(pos.Y(), 0.0);
+    EXPECT_NEAR(pos.X(), expected[i].X(), 1e-9);
+    EXPECT_NEAR(pos.Y(), expected[i].Y(), 1e-9);
+    EXPECT_NEAR(pos.Z(), expected[i].Z(), 1e-9);
+  }
+
+  batch.Clear();
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldBatchTest, SnapshotReplayInParallel)
+{
+  this->Load("worlds/blank.world", true);
+
+  auto poses = [](const physics::WorldPtr &_world)
+  {
+    std::vector<ignition::math::Pose3d> result;
+    for (auto const &model : _world->Models())
+      result.push_back(model->WorldPose());
+    return result;
+  };
+
+  physics::WorldBatch batch;
+  std::vector<physics::WorldPtr> worlds;
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    worlds.push_back(this->CreateStackWorld("stack_" + std::to_string(i)));
+    worlds.back()->Physics()->SetSeed(1234 + i);
+    EXPECT_TRUE(batch.AddWorld(worlds.back()));
+  }
+
+  batch.Step(50);
+  std::vector<std::string> snapshots(worlds.size());
+  for (size_t i = 0; i < worlds.size(); ++i)
+    worlds[i]->SaveSnapshot(snapshots[i]);
+
+  batch.Step(300);
+  std::vector<std::vector<ignition::math::Pose3d>> expected;
+  for (auto const &world : worlds)
+    expected.push_back(poses(world));
+
+  // Both worlds replay in parallel. The random row reordering seed lives
+  // in each world, so neither world disturbs the other's sequence.
+  for (size_t i = 0; i < worlds.size(); ++i)
+    EXPECT_TRUE(worlds[i]->RestoreSnapshot(snapshots[i]));
+  batch.Step(300);
+  for (size_t i = 0; i < worlds.size(); ++i)
+    EXPECT_EQ(poses(worlds[i]), expected[i]);
+
+  // The first world replays the same on its own
+  EXPECT_TRUE(worlds[0]->RestoreSnapshot(snapshots[0]));
+  batch.Clear();
+  EXPECT_TRUE(batch.AddWorld(worlds[0]));
+  batch.Step(300);
+  EXPECT_EQ(poses(worlds[0]), expected[0]);
+
+  batch.Clear();
+}
+
+//////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -26,9 +26,12 @@
 #include <sdf/sdf.hh>
 #include <string>
 #include <mutex>
+#include <unordered_map>
 #include <thread>
 #include <condition_variable>
 
+#include <boost/weak_ptr.hpp>
+
 #include <ignition/transport.hh>
 
 #include "gazebo/common/Event.hh"
@@ -39,6 +42,7 @@
 
 #include "gazebo/transport/TransportTypes.hh"
 
+#include "gazebo/physics/ModelIndex.hh"
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/WorldState.hh"
 
@@ -122,6 +126,57 @@ namespace gazebo
       /// \brief Publisher for local pose messages.
       public: transport::PublisherPtr poseLocalPub;
 
+      /// \brief Publisher for the compact pose stream.
+      public: transport::PublisherPtr poseStreamPub;
+
+      /// \brief Reused compact pose stream message.
+      public: msgs::PoseStream poseStreamMsg;
+
+      /// \brief Last pose sent on the pose stream for each entity id.
+      /// Empty until the next key frame.
+      public: std::unordered_map<uint32_t, ignition::math::Pose3d>
+              poseStreamPoses;
+
+      /// \brief Wall time of the last pose stream key frame.
+      public: common::Time poseStreamKeyFrameTime;
+
+      /// \brief Position resolution of the pose stream in meters, zero for
+      /// full precision.
+      public: double poseStreamResolution = 0;
+
+      /// \brief Iterations between housekeeping passes in batch mode, zero
+      /// when batch mode is disabled.
+      public: std::atomic<unsigned int> batchSteps{0};
+
+      /// \brief Sim time period between housekeeping passes in batch
+      /// mode, zero to only use batchSteps.
+      public: double batchSimPeriod = 0;
+
+      /// \brief Sim time of the next housekeeping pass in batch mode.
+      public: common::Time batchNextSimTime;
+
+      /// \brief Iterations since the last housekeeping pass.
+      public: unsigned int batchStepCount = 0;
+
+      /// \brief True when all the models must be removed at the end of the
+      /// current step. Set by World::Clear from any thread.
+      public: std::atomic<bool> clearModels{false};
+
+      /// \brief Wall time of the last steps per second measurement.
+      public: common::Time rateWallTime;
+
+      /// \brief Iteration count at the last steps per second measurement.
+      public: uint64_t rateIterations = 0;
+
+      /// \brief Iterations per wall clock second.
+      public: std::atomic<double> stepsPerSecond{0};
+
+      /// \brief Update begin event of this world only.
+      public: event::EventT<void (const common::UpdateInfo &)> updateBegin;
+
+      /// \brief Update end event of this world only.
+      public: event::EventT<void ()> updateEnd;
+
       /// \brief Subscriber to world control messages.
       public: transport::SubscriberPtr controlSub;
 
@@ -146,6 +201,17 @@ namespace gazebo
       /// \brief Subscriber to model messages.
       public: transport::SubscriberPtr modelSub;
 
+      /// \brief Subscriber to wrenches for many links.
+      public: transport::SubscriberPtr linkWrenchesSub;
+
+      /// \brief Links of the bulk wrench messages, by scoped name, so that
+      /// they are only looked up once.
+      public: std::unordered_map<std::string, boost::weak_ptr<Link>>
+              wrenchLinks;
+
+      /// \brief Protects wrenchLinks.
+      public: std::mutex wrenchLinksMutex;
+
       /// \brief Subscriber to request messages.
       public: transport::SubscriberPtr requestSub;
 
@@ -205,6 +271,9 @@ namespace gazebo
       /// \brief Factory message buffer.
       public: std::list<msgs::Factory> factoryMsgs;
 
+      /// \brief Parsed model elements waiting to be inserted.
+      public: std::list<sdf::ElementPtr> factoryModelElems;
+
       /// \brief Model message buffer.
       public: std::list<msgs::Model> modelMsgs;
 
@@ -217,6 +286,25 @@ namespace gazebo
       /// \brief Playback control message buffer.
       public: std::list<msgs::LogPlaybackControl> playbackControlMsgs;
 
+      /// \brief True when one of the message buffers may hold messages.
+      /// Read without locking at every step.
+      public: std::atomic<bool> msgsPending{false};
+
+      /// \brief Number of messages received since the last processing
+      /// pass. Protected by receiveMutex.
+      public: unsigned int pendingMsgCount = 0;
+
+      /// \brief Wall time of the first message received since the last
+      /// processing pass. Protected by receiveMutex.
+      public: common::Time firstPendingMsgTime;
+
+      /// \brief Number of messages applied to the world.
+      public: std::atomic<uint64_t> processedMsgCount{0};
+
+      /// \brief Wait time of the oldest message of the last processing
+      /// pass, in seconds.
+      public: std::atomic<double> msgLatency{0};
+
       /// \brief True to reset the world on next update.
       public: bool needsReset;
 
@@ -331,6 +419,9 @@ namespace gazebo
       /// \brief A cached list of models. This is here for performance.
       public: Model_V models;
 
+      /// \brief Spatial index of the models, used by the region queries.
+      public: ModelIndex modelIndex;
+
       /// \brief A cached list of lights.
       public: Light_V lights;
 
@@ -343,6 +434,12 @@ namespace gazebo
       /// physics::Link in World::Update.
       public: std::list<Entity*> dirtyPoses;
 
+      /// \brief Links of all the models, in snapshot order.
+      public: Link_V snapshotLinks;
+
+      /// \brief Joints of all the models, in snapshot order.
+      public: Joint_V snapshotJoints;
+
       /// \brief Class to manage preset simulation parameter profiles.
       public: PresetManagerPtr presetManager;
 
@@ -87,6 +87,40 @@ void WorldState::LoadWithFilter(const WorldPtr _world,
   this->Load(_world);
 }
 
+/////////////////////////////////////////////////
+void WorldState::LoadEntities(const WorldPtr _world,
+    const std::set<std::string> &_names)
+{
+  this->world = _world;
+  this->name = _world->Name();
+  this->wallTime = common::Time::GetWallTime();
+  this->simTime = _world->SimTime();
+  this->realTime = _world->RealTime();
+  this->iterations = _world->Iterations();
+  this->insertions.clear();
+  this->deletions.clear();
+  this->modelStates.clear();
+  this->lightStates.clear();
+
+  for (auto const &entityName : _names)
+  {
+    ModelPtr model = _world->ModelByName(entityName);
+    if (model)
+    {
+      this->modelStates[entityName].Load(model, this->realTime,
+          this->simTime, this->iterations);
+      continue;
+    }
+
+    LightPtr light = _world->LightByName(entityName);
+    if (light)
+    {
+      this->lightStates[entityName].Load(light, this->realTime,
+          this->simTime, this->iterations);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 void WorldState::Load(const WorldPtr _world)
 {
@@ -129,11 +163,22 @@ void WorldState::Load(const WorldPtr _world)
       add = boost::regex_match((*iter)->GetName(), regex);
     }
 
-    if (add)
+    if (!add)
+      continue;
+
+    // The state of a sleeping model doesn't change, only its time stamps
+    auto stateIter = this->modelStates.find((*iter)->GetName());
+    if (stateIter != this->modelStates.end() && (*iter)->Sleeping())
     {
-      this->modelStates[(*iter)->GetName()].Load(*iter, this->realTime,
-          this->simTime, this->iterations);
+      stateIter->second.SetWallTime(this->wallTime);
+      stateIter->second.SetRealTime(this->realTime);
+      stateIter->second.SetSimTime(this->simTime);
+      stateIter->second.SetIterations(this->iterations);
+      continue;
     }
+
+    this->modelStates[(*iter)->GetName()].Load(*iter, this->realTime,
+        this->simTime, this->iterations);
   }
 
   // Remove models that no longer exist. We determine this by check the time
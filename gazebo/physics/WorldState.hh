@@ -21,6 +21,7 @@
 #ifndef GAZEBO_PHYSICS_WORLDSTATE_HH_
 #define GAZEBO_PHYSICS_WORLDSTATE_HH_
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -78,6 +79,16 @@ namespace gazebo
       public: void LoadWithFilter(const WorldPtr _world,
           const std::string &_filter);
 
+      /// \brief Load the state of some entities of a world.
+      ///
+      /// Generate a WorldState holding the world times and the states of
+      /// the given models and lights only. Names that don't match a model
+      /// or a light of the world are skipped.
+      /// \param[in] _world Pointer to a world
+      /// \param[in] _names Names of top level models and lights.
+      public: void LoadEntities(const WorldPtr _world,
+          const std::set<std::string> &_names);
+
       /// \brief Load state from SDF element.
       ///
       /// Set a WorldState from an SDF element containing WorldState info.
@@ -15,6 +15,12 @@
  *
 */
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "gazebo/physics/PhysicsTypes.hh"
 #include "gazebo/physics/World.hh"
 #include "gazebo/test/ServerFixture.hh"
@@ -216,6 +222,377 @@ TEST_F(WorldTest, Stop)
   EXPECT_TRUE(world->Running());
 }
 
+//////////////////////////////////////////////////
+TEST_F(WorldTest, BatchMode)
+{
+  // Load an empty world
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_EQ(world->BatchSteps(), 0u);
+  EXPECT_DOUBLE_EQ(world->StepsPerSecond(), 0.0);
+
+  world->SetBatchMode(100);
+  EXPECT_EQ(world->BatchSteps(), 100u);
+
+  // The blank world runs at 1000 Hz in real time mode, batch mode is not
+  // throttled and should go well beyond that.
+  uint64_t startIterations = world->Iterations();
+  common::Time startTime = common::Time::GetWallTime();
+  world->SetPaused(false);
+
+  int sleep = 0;
+  int maxSleep = 50;
+  while (sleep < maxSleep && world->StepsPerSecond() <= 0)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  world->SetPaused(true);
+
+  double elapsed = (common::Time::GetWallTime() - startTime).Double();
+  EXPECT_GT(world->StepsPerSecond(), 0.0);
+  EXPECT_GT(world->Iterations() - startIterations, elapsed * 1000);
+
+  world->SetBatchMode(0);
+  EXPECT_EQ(world->BatchSteps(), 0u);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, Snapshot)
+{
+  // Load a world with simple shapes resting on the ground
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+
+  // Throw the box so that it tumbles and collides
+  box->SetLinearVel(ignition::math::Vector3d(2, 0, 3));
+  box->SetAngularVel(ignition::math::Vector3d(1, 2, 0));
+  world->Step(50);
+
+  std::string snapshot;
+  world->SaveSnapshot(snapshot);
+  EXPECT_FALSE(snapshot.empty());
+  common::Time simTime = world->SimTime();
+
+  world->Step(500);
+  std::vector<ignition::math::Pose3d> poses;
+  for (auto const &model : world->Models())
+    poses.push_back(model->WorldPose());
+  ignition::math::Pose3d boxPose = box->WorldPose();
+  ignition::math::Vector3d vel = box->WorldLinearVel();
+
+  // Restore and replay, the result must be identical
+  EXPECT_TRUE(world->RestoreSnapshot(snapshot));
+  EXPECT_EQ(world->SimTime(), simTime);
+  EXPECT_NE(box->WorldPose(), boxPose);
+
+  world->Step(500);
+  size_t i = 0;
+  for (auto const &model : world->Models())
+    EXPECT_EQ(model->WorldPose(), poses[i++]);
+  EXPECT_EQ(box->WorldLinearVel(), vel);
+
+  // Corrupted snapshots are rejected
+  EXPECT_FALSE(world->RestoreSnapshot(""));
+  EXPECT_FALSE(world->RestoreSnapshot(snapshot.substr(0, 60)));
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a model is in a list.
+/// \param[in] _models List of models.
+/// \param[in] _name Name of the model.
+/// \return True if the list contains the model.
+bool HasModel(const physics::Model_V &_models, const std::string &_name)
+{
+  return std::find_if(_models.begin(), _models.end(),
+      [&](const physics::ModelPtr &_model)
+      {
+        return _model->GetName() == _name;
+      }) != _models.end();
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, RegionQueries)
+{
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // A row of static unit boxes along the x axis, one every 3 meters.
+  for (int i = 0; i < 20; ++i)
+  {
+    this->SpawnBox("box_" + std::to_string(i), ignition::math::Vector3d::One,
+        ignition::math::Vector3d(i * 3.0, 0, 0.5),
+        ignition::math::Vector3d::Zero, true);
+  }
+
+  physics::Model_V models;
+  world->ModelsInBox(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(8.8, -1, 0),
+      ignition::math::Vector3d(9.2, 1, 1)), models);
+  EXPECT_TRUE(HasModel(models, "box_3"));
+  EXPECT_FALSE(HasModel(models, "box_2"));
+  EXPECT_FALSE(HasModel(models, "box_4"));
+
+  models.clear();
+  world->ModelsInSphere(ignition::math::Vector3d(0, 0, 0.5), 3.2, models);
+  EXPECT_TRUE(HasModel(models, "box_0"));
+  EXPECT_TRUE(HasModel(models, "box_1"));
+  EXPECT_FALSE(HasModel(models, "box_2"));
+
+  // Frustum looking along the row, up to x = 9.
+  ignition::math::Frustum frustum(0.1, 10, IGN_DTOR(30), 1.0,
+      ignition::math::Pose3d(-1, 0, 0.5, 0, 0, 0));
+  models.clear();
+  world->ModelsInFrustum(frustum, models);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(HasModel(models, "box_" + std::to_string(i)));
+  EXPECT_FALSE(HasModel(models, "box_4"));
+
+  // Results follow the order of the world models.
+  physics::Model_V boxes;
+  for (auto const &model : models)
+  {
+    if (model->GetName().find("box_") == 0)
+      boxes.push_back(model);
+  }
+  ASSERT_EQ(boxes.size(), 4u);
+  for (size_t i = 0; i < boxes.size(); ++i)
+    EXPECT_EQ(boxes[i]->GetName(), "box_" + std::to_string(i));
+
+  // Moved models are found at their new position after a step.
+  auto box = world->ModelByName("box_10");
+  ASSERT_NE(nullptr, box);
+  box->SetWorldPose(ignition::math::Pose3d(0, 5, 0.5, 0, 0, 0));
+  world->Step(1);
+
+  models.clear();
+  world->ModelsInSphere(ignition::math::Vector3d(0, 5, 0.5), 1, models);
+  EXPECT_TRUE(HasModel(models, "box_10"));
+  models.clear();
+  world->ModelsInSphere(ignition::math::Vector3d(30, 0, 0.5), 1, models);
+  EXPECT_FALSE(HasModel(models, "box_10"));
+
+  // Removed models are not returned.
+  world->RemoveModel("box_3");
+  models.clear();
+  world->ModelsInBox(ignition::math::AxisAlignedBox(
+      ignition::math::Vector3d(8.8, -1, 0),
+      ignition::math::Vector3d(9.2, 1, 1)), models);
+  EXPECT_FALSE(HasModel(models, "box_3"));
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, MessageStats)
+{
+  this->Load("worlds/blank.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // Steps without incoming messages do not change the statistics.
+  world->Step(10);
+  uint64_t count = world->ProcessedMessageCount();
+
+  std::string sdf =
+    "<sdf version='1.6'>"
+    "  <model name='queued_box'>"
+    "    <static>true</static>"
+    "    <link name='link'/>"
+    "  </model>"
+    "</sdf>";
+  world->InsertModelString(sdf);
+
+  // Messages are processed at most every 200 ms of wall time.
+  int sleep = 0;
+  int maxSleep = 50;
+  while (sleep < maxSleep && !world->ModelByName("queued_box"))
+  {
+    world->Step(1);
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  ASSERT_NE(nullptr, world->ModelByName("queued_box"));
+  EXPECT_EQ(world->ProcessedMessageCount(), count + 1);
+  EXPECT_GE(world->MessageLatency(), 0.0);
+
+  world->Step(10);
+  EXPECT_EQ(world->ProcessedMessageCount(), count + 1);
+}
+
+//////////////////////////////////////////////////
+std::mutex g_poseStreamMutex;
+std::vector<msgs::PoseStream> g_poseStreams;
+
+//////////////////////////////////////////////////
+void OnPoseStream(ConstPoseStreamPtr &_msg)
+{
+  std::lock_guard<std::mutex> lock(g_poseStreamMutex);
+  g_poseStreams.push_back(*_msg);
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, PoseStream)
+{
+  // Load a world with simple shapes
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  EXPECT_DOUBLE_EQ(world->PoseStreamResolution(), 0.0);
+  world->SetPoseStreamResolution(0.001);
+  EXPECT_DOUBLE_EQ(world->PoseStreamResolution(), 0.001);
+  world->SetPoseStreamResolution(-1);
+  EXPECT_DOUBLE_EQ(world->PoseStreamResolution(), 0.0);
+  world->SetPoseStreamResolution(0.001);
+
+  transport::SubscriberPtr sub =
+    this->node->Subscribe("~/pose/stream", &OnPoseStream);
+
+  // Move a model so that its pose is published
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+
+  int sleep = 0;
+  int maxSleep = 50;
+  while (sleep < maxSleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_poseStreamMutex);
+      if (g_poseStreams.size() > 1u)
+        break;
+    }
+    box->SetWorldPose(ignition::math::Pose3d(sleep * 0.1, 0, 0.5, 0, 0, 0));
+    world->Step(1);
+    common::Time::MSleep(100);
+    sleep++;
+  }
+
+  std::lock_guard<std::mutex> lock(g_poseStreamMutex);
+  ASSERT_GT(g_poseStreams.size(), 1u);
+
+  // The first message is a key frame with the full dictionary
+  const msgs::PoseStream &keyFrame = g_poseStreams.front();
+  EXPECT_TRUE(keyFrame.key_frame());
+  EXPECT_DOUBLE_EQ(keyFrame.position_resolution(), 0.001);
+  EXPECT_EQ(keyFrame.dict_id_size(), keyFrame.dict_name_size());
+  EXPECT_EQ(keyFrame.id_size(), keyFrame.dict_id_size());
+  bool found = false;
+  for (int i = 0; i < keyFrame.dict_id_size(); ++i)
+  {
+    if (keyFrame.dict_name(i) == "box")
+    {
+      EXPECT_EQ(keyFrame.dict_id(i), box->GetId());
+      found = true;
+    }
+  }
+  EXPECT_TRUE(found);
+
+  // Deltas only carry the poses that changed, which never includes the
+  // static ground plane
+  for (auto const &msg : g_poseStreams)
+  {
+    if (msg.key_frame())
+      continue;
+    EXPECT_LT(msg.id_size(), keyFrame.id_size());
+    for (int i = 0; i < msg.id_size(); ++i)
+    {
+      EXPECT_NE(msg.id(i), world->ModelByName("ground_plane")->GetId());
+      auto pose = msgs::PoseStreamPose(msg, i);
+      EXPECT_NEAR(pose.Rot().W(), 1.0, 1e-3);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+TEST_F(WorldTest, PoseStreamFastSteps)
+{
+  this->Load("worlds/shapes.world", true);
+  auto world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  // Exact poses, without quantization
+  world->SetPoseStreamResolution(0.0);
+
+  {
+    std::lock_guard<std::mutex> lock(g_poseStreamMutex);
+    g_poseStreams.clear();
+  }
+  transport::SubscriberPtr sub =
+    this->node->Subscribe("~/pose/stream", &OnPoseStream);
+
+  auto box = world->ModelByName("box");
+  ASSERT_NE(nullptr, box);
+
+  // Wait for the subscriber to connect
+  for (int i = 0; i < 50; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_poseStreamMutex);
+      if (!g_poseStreams.empty())
+        break;
+    }
+    world->Step(1);
+    common::Time::MSleep(100);
+  }
+
+  // Step much faster than 60 Hz, moving the box every step
+  for (int i = 0; i < 200; ++i)
+  {
+    box->SetWorldPose(ignition::math::Pose3d(i * 0.01, 1, 0.5, 0, 0, 0));
+    world->Step(1);
+  }
+
+  // Wait for the message of the last step
+  const common::Time lastTime = world->SimTime();
+  std::vector<msgs::PoseStream> stream;
+  for (int i = 0; i < 50; ++i)
+  {
+    {
+      std::lock_guard<std::mutex> lock(g_poseStreamMutex);
+      stream = g_poseStreams;
+    }
+    if (!stream.empty() && msgs::Convert(stream.back().time()) == lastTime)
+      break;
+    common::Time::MSleep(100);
+  }
+  ASSERT_FALSE(stream.empty());
+  EXPECT_EQ(msgs::Convert(stream.back().time()), lastTime);
+  ASSERT_TRUE(stream.front().key_frame());
+
+  // Rebuild the poses from the key frames and the deltas
+  std::map<uint32_t, std::string> names;
+  std::map<uint32_t, ignition::math::Pose3d> poses;
+  for (auto const &msg : stream)
+  {
+    if (msg.key_frame())
+    {
+      names.clear();
+      poses.clear();
+      for (int i = 0; i < msg.dict_id_size(); ++i)
+        names[msg.dict_id(i)] = msg.dict_name(i);
+    }
+
+    for (int i = 0; i < msg.id_size(); ++i)
+      poses[msg.id(i)] = msgs::PoseStreamPose(msg, i);
+  }
+
+  ASSERT_FALSE(poses.empty());
+  EXPECT_EQ(poses[box->GetId()], box->RelativePose());
+  for (auto const &pose : poses)
+  {
+    ASSERT_TRUE(names.find(pose.first) != names.end());
+    auto entity = world->EntityByName(names[pose.first]);
+    ASSERT_NE(nullptr, entity);
+    EXPECT_EQ(pose.second, entity->RelativePose()) << names[pose.first];
+  }
+}
+
 //////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
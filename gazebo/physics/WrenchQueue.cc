@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "gazebo/physics/WrenchQueue.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief A slot of the ring.
+struct WrenchSlot
+{
+  /// \brief Sequence number of the slot, which tells whether it can be
+  /// written or read at a given queue position.
+  std::atomic<size_t> sequence;
+
+  /// \brief The queued wrench.
+  LinkWrench wrench;
+};
+
+/// \brief Private data for the WrenchQueue class
+class gazebo::physics::WrenchQueuePrivate
+{
+  /// \brief Ring of slots, its size is a power of two.
+  public: std::vector<WrenchSlot> slots;
+
+  /// \brief Size of the ring minus one.
+  public: size_t mask = 0;
+
+  /// \brief Next position to write, shared by the producers.
+  public: alignas(64) std::atomic<size_t> enqueuePos{0};
+
+  /// \brief Next position to read, only used by the consumer.
+  public: alignas(64) size_t dequeuePos = 0;
+
+  /// \brief True if wrenches were accumulated in the overflow sums.
+  public: std::atomic<bool> overflowed{false};
+
+  /// \brief Protects the overflow sums.
+  public: std::mutex overflowMutex;
+
+  /// \brief Sum of the forces that did not fit in the ring.
+  public: ignition::math::Vector3d overflowForce;
+
+  /// \brief Sum of the torques that did not fit in the ring.
+  public: ignition::math::Vector3d overflowTorque;
+
+  /// \brief Number of wrenches that did not fit in the ring.
+  public: unsigned int overflowCount = 0;
+};
+
+//////////////////////////////////////////////////
+WrenchQueue::WrenchQueue(const unsigned int _capacity)
+  : dataPtr(new WrenchQueuePrivate)
+{
+  size_t size = 2;
+  while (size < _capacity)
+    size *= 2;
+
+  this->dataPtr->slots = std::vector<WrenchSlot>(size);
+  for (size_t i = 0; i < size; ++i)
+    this->dataPtr->slots[i].sequence.store(i, std::memory_order_relaxed);
+  this->dataPtr->mask = size - 1;
+}
+
+//////////////////////////////////////////////////
+WrenchQueue::~WrenchQueue()
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int WrenchQueue::Capacity() const
+{
+  return static_cast<unsigned int>(this->dataPtr->slots.size());
+}
+
+//////////////////////////////////////////////////
+void WrenchQueue::Push(const LinkWrench &_wrench)
+{
+  // Bounded multi producer queue: a producer claims a position by
+  // incrementing enqueuePos, and publishes the slot through its sequence.
+  size_t pos = this->dataPtr->enqueuePos.load(std::memory_order_relaxed);
+  WrenchSlot *slot;
+  while (true)
+  {
+    slot = &this->dataPtr->slots[pos & this->dataPtr->mask];
+    size_t seq = slot->sequence.load(std::memory_order_acquire);
+    if (seq == pos)
+    {
+      if (this->dataPtr->enqueuePos.compare_exchange_weak(pos, pos + 1,
+            std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (seq < pos)
+    {
+      // The ring is full
+      std::lock_guard<std::mutex> lock(this->dataPtr->overflowMutex);
+      this->dataPtr->overflowForce += _wrench.force;
+      this->dataPtr->overflowTorque += _wrench.torque +
+        _wrench.forceOffset.Cross(_wrench.force);
+      ++this->dataPtr->overflowCount;
+      this->dataPtr->overflowed = true;
+      return;
+    }
+    else
+    {
+      pos = this->dataPtr->enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->wrench = _wrench;
+  slot->sequence.store(pos + 1, std::memory_order_release);
+}
+
+//////////////////////////////////////////////////
+unsigned int WrenchQueue::Drain(ignition::math::Vector3d &_force,
+    ignition::math::Vector3d &_torque)
+{
+  _force.Set(0, 0, 0);
+  _torque.Set(0, 0, 0);
+  unsigned int count = 0;
+
+  size_t &pos = this->dataPtr->dequeuePos;
+  while (true)
+  {
+    WrenchSlot &slot = this->dataPtr->slots[pos & this->dataPtr->mask];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+      break;
+
+    // A force applied at an offset is the same force at the origin plus
+    // the torque of the offset.
+    const LinkWrench &wrench = slot.wrench;
+    _force += wrench.force;
+    _torque += wrench.torque + wrench.forceOffset.Cross(wrench.force);
+    ++count;
+
+    // Give the slot back to the producers, one lap later
+    slot.sequence.store(pos + this->dataPtr->mask + 1,
+        std::memory_order_release);
+    ++pos;
+  }
+
+  if (this->dataPtr->overflowed)
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->overflowMutex);
+    _force += this->dataPtr->overflowForce;
+    _torque += this->dataPtr->overflowTorque;
+    count += this->dataPtr->overflowCount;
+    this->dataPtr->overflowForce.Set(0, 0, 0);
+    this->dataPtr->overflowTorque.Set(0, 0, 0);
+    this->dataPtr->overflowCount = 0;
+    this->dataPtr->overflowed = false;
+  }
+
+  return count;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_WRENCHQUEUE_HH_
+#define GAZEBO_PHYSICS_WRENCHQUEUE_HH_
+
+#include <memory>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    // Forward declare private data class.
+    class WrenchQueuePrivate;
+
+    /// \addtogroup gazebo_physics
+    /// \{
+
+    /// \class LinkWrench WrenchQueue.hh physics/physics.hh
+    /// \brief Force and torque to apply to a link, in the link frame.
+    class GZ_PHYSICS_VISIBLE LinkWrench
+    {
+      /// \brief Force.
+      public: ignition::math::Vector3d force;
+
+      /// \brief Torque.
+      public: ignition::math::Vector3d torque;
+
+      /// \brief Point where the force is applied, relative to the link
+      /// origin.
+      public: ignition::math::Vector3d forceOffset;
+    };
+
+    /// \class WrenchQueue WrenchQueue.hh physics/physics.hh
+    /// \brief Bounded queue of link wrenches, preallocated and lock free.
+    /// Any number of threads may push wrenches, while a single thread
+    /// drains them. Draining sums the queued wrenches into a single force
+    /// at the link origin and a torque.
+    ///
+    /// If the queue is full, Push falls back to accumulating the wrench
+    /// under a mutex, so that no wrench is ever lost.
+    class GZ_PHYSICS_VISIBLE WrenchQueue
+    {
+      /// \brief Constructor.
+      /// \param[in] _capacity Number of wrenches that can be queued without
+      /// locking, rounded up to a power of two.
+      public: explicit WrenchQueue(const unsigned int _capacity = 64);
+
+      /// \brief Destructor.
+      public: ~WrenchQueue();
+
+      /// \brief Get the number of wrenches that can be queued without
+      /// locking.
+      /// \return The capacity.
+      public: unsigned int Capacity() const;
+
+      /// \brief Queue a wrench. Thread safe.
+      /// \param[in] _wrench The wrench.
+      public: void Push(const LinkWrench &_wrench);
+
+      /// \brief Remove all the queued wrenches and sum them. Must only be
+      /// called by one thread at a time.
+      /// \param[out] _force Sum of the forces, applied at the link origin.
+      /// \param[out] _torque Sum of the torques, including those of the
+      /// force offsets about the link origin.
+      /// \return Number of wrenches removed.
+      public: unsigned int Drain(ignition::math::Vector3d &_force,
+                  ignition::math::Vector3d &_torque);
+
+      /// \internal
+      /// \brief Private data pointer.
+      private: std::unique_ptr<WrenchQueuePrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "gazebo/physics/WrenchQueue.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+class WrenchQueueTest : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(WrenchQueueTest, Drain)
+{
+  WrenchQueue queue(5);
+  EXPECT_EQ(8u, queue.Capacity());
+
+  ignition::math::Vector3d force;
+  ignition::math::Vector3d torque;
+  EXPECT_EQ(0u, queue.Drain(force, torque));
+  EXPECT_EQ(ignition::math::Vector3d::Zero, force);
+  EXPECT_EQ(ignition::math::Vector3d::Zero, torque);
+
+  // A force with an offset becomes a torque about the origin
+  LinkWrench wrench;
+  wrench.force.Set(1, 0, 0);
+  wrench.forceOffset.Set(0, 2, 0);
+  queue.Push(wrench);
+
+  wrench.force.Set(0, 0, 3);
+  wrench.torque.Set(0, 4, 0);
+  wrench.forceOffset.Set(0, 0, 0);
+  queue.Push(wrench);
+
+  EXPECT_EQ(2u, queue.Drain(force, torque));
+  EXPECT_EQ(ignition::math::Vector3d(1, 0, 3), force);
+  EXPECT_EQ(ignition::math::Vector3d(0, 4, -2), torque);
+
+  EXPECT_EQ(0u, queue.Drain(force, torque));
+  EXPECT_EQ(ignition::math::Vector3d::Zero, force);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WrenchQueueTest, Overflow)
+{
+  WrenchQueue queue(4);
+
+  // Wrenches that do not fit in the ring are still applied
+  LinkWrench wrench;
+  wrench.force.Set(1, 0, 0);
+  for (unsigned int i = 0; i < 10; ++i)
+    queue.Push(wrench);
+
+  ignition::math::Vector3d force;
+  ignition::math::Vector3d torque;
+  EXPECT_EQ(10u, queue.Drain(force, torque));
+  EXPECT_EQ(ignition::math::Vector3d(10, 0, 0), force);
+
+  // The ring is usable again
+  queue.Push(wrench);
+  EXPECT_EQ(1u, queue.Drain(force, torque));
+  EXPECT_EQ(ignition::math::Vector3d(1, 0, 0), force);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WrenchQueueTest, Threads)
+{
+  WrenchQueue queue(16);
+  const unsigned int producerCount = 4;
+  const unsigned int pushCount = 10000;
+
+  std::vector<std::thread> producers;
+  for (unsigned int p = 0; p < producerCount; ++p)
+  {
+    producers.push_back(std::thread([&queue]()
+    {
+      LinkWrench wrench;
+      wrench.force.Set(1, 0, 0);
+      for (unsigned int i = 0; i < pushCount; ++i)
+        queue.Push(wrench);
+    }));
+  }
+
+  // Drain while the producers push
+  unsigned int count = 0;
+  double forceX = 0;
+  ignition::math::Vector3d force;
+  ignition::math::Vector3d torque;
+  while (count < producerCount * pushCount)
+  {
+    count += queue.Drain(force, torque);
+    forceX += force.X();
+  }
+
+  for (auto &producer : producers)
+    producer.join();
+
+  EXPECT_EQ(producerCount * pushCount, count);
+  EXPECT_DOUBLE_EQ(producerCount * pushCount, forceX);
+  EXPECT_EQ(0u, queue.Drain(force, torque));
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
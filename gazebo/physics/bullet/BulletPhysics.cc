@@ -245,6 +245,45 @@ bool ContactCallback(btManifoldPoint &_cp,
   _cp.m_combinedFriction = std::min(_obj1->m_collisionObject->getFriction(),
     _obj0->m_collisionObject->getFriction());
 
+  // Let the first collision of each link edit the contact surface, the
+  // other surface parameters of this engine are also per link.
+  const btRigidBody *rb0 = btRigidBody::upcast(_obj0->m_collisionObject);
+  const btRigidBody *rb1 = btRigidBody::upcast(_obj1->m_collisionObject);
+  if (rb0 && rb1)
+  {
+    BulletLink *link0 = static_cast<BulletLink *>(rb0->getUserPointer());
+    BulletLink *link1 = static_cast<BulletLink *>(rb1->getUserPointer());
+    CollisionPtr collision0;
+    CollisionPtr collision1;
+    if (link0 && !link0->GetCollisions().empty())
+      collision0 = link0->GetCollision(0u);
+    if (link1 && !link1->GetCollisions().empty())
+      collision1 = link1->GetCollision(0u);
+
+    if (collision0 && collision1 &&
+        (collision0->HasContactSurfaceFunc() ||
+         collision1->HasContactSurfaceFunc()))
+    {
+      ContactSurface surface;
+      surface.collision1 = collision0.get();
+      surface.collision2 = collision1.get();
+      const btVector3 &pos = _cp.getPositionWorldOnB();
+      surface.position.Set(pos.getX(), pos.getY(), pos.getZ());
+      surface.normal.Set(_cp.m_normalWorldOnB.getX(),
+          _cp.m_normalWorldOnB.getY(), _cp.m_normalWorldOnB.getZ());
+      surface.depth = -_cp.getDistance();
+      surface.mu1 = _cp.m_combinedFriction;
+      surface.mu2 = _cp.m_combinedFriction;
+
+      collision0->ProcessContactSurface(surface);
+      collision1->ProcessContactSurface(surface);
+
+      // Bullet computes its own friction directions, only the friction
+      // coefficient can be changed.
+      _cp.m_combinedFriction = surface.mu1;
+    }
+  }
+
   // this return value is currently ignored, but to be on the safe side:
   //  return false if you don't calculate friction
   return true;
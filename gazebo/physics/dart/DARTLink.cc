@@ -523,6 +523,7 @@ void DARTLink::AddForce(const ignition::math::Vector3d &_force)
     return;
   }
 
+  this->WakeUp();
   this->dataPtr->dtBodyNode->addExtForce(DARTTypes::ConvVec3(_force));
 }
 
@@ -537,6 +538,7 @@ void DARTLink::AddRelativeForce(const ignition::math::Vector3d &_force)
     return;
   }
 
+  this->WakeUp();
   this->dataPtr->dtBodyNode->addExtForce(DARTTypes::ConvVec3(_force),
                                 Eigen::Vector3d::Zero(),
                                 true, true);
@@ -554,6 +556,7 @@ void DARTLink::AddForceAtWorldPosition(const ignition::math::Vector3d &_force,
     return;
   }
 
+  this->WakeUp();
   this->dataPtr->dtBodyNode->addExtForce(DARTTypes::ConvVec3(_pos),
                                 DARTTypes::ConvVec3(_force),
                                 false, false);
@@ -573,6 +576,7 @@ void DARTLink::AddForceAtRelativePosition(
     return;
   }
 
+  this->WakeUp();
   this->dataPtr->dtBodyNode->addExtForce(
         DARTTypes::ConvVec3(_force),
         DARTTypes::ConvVec3(_relpos) + this->dataPtr->dtBodyNode->getLocalCOM(),
@@ -593,6 +597,7 @@ void DARTLink::AddLinkForce(
     return;
   }
 
+  this->WakeUp();
   this->dataPtr->dtBodyNode->addExtForce(
         DARTTypes::ConvVec3(_force),
         DARTTypes::ConvVec3(_offset),
@@ -609,6 +614,7 @@ void DARTLink::AddTorque(const ignition::math::Vector3d &_torque)
     return;
   }
 
+  this->WakeUp();
   this->dataPtr->dtBodyNode->addExtTorque(DARTTypes::ConvVec3(_torque));
 }
 
@@ -623,6 +629,7 @@ void DARTLink::AddRelativeTorque(const ignition::math::Vector3d &_torque)
     return;
   }
 
+  this->WakeUp();
   this->dataPtr->dtBodyNode->addExtTorque(DARTTypes::ConvVec3(_torque), true);
 }
 
@@ -24,6 +24,7 @@
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Console.hh"
 
+#include "gazebo/physics/World.hh"
 #include "gazebo/physics/ode/ODESurfaceParams.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
 #include "gazebo/physics/ode/ODELink.hh"
@@ -50,7 +51,11 @@ ODECollision::ODECollision(LinkPtr _link)
 ODECollision::~ODECollision()
 {
   if (this->collisionId)
+  {
+    if (this->IsStatic())
+      this->NotifyStaticChange();
     dGeomDestroy(this->collisionId);
+  }
   this->collisionId = nullptr;
 
   this->Fini();
@@ -98,7 +103,10 @@ void ODECollision::OnPoseChange()
   // (*this.*onPoseChangeFunc)();
 
   if (this->IsStatic() && this->collisionId && this->placeable)
+  {
     this->OnPoseChangeGlobal();
+    this->NotifyStaticChange();
+  }
   else if (this->collisionId && this->placeable)
     this->OnPoseChangeRelative();
 }
@@ -117,6 +125,9 @@ void ODECollision::SetCollision(dGeomID _collisionId, bool _placeable)
     GZ_ASSERT(dGeomGetSpace(this->collisionId) != 0, "Collision ID is null");
   }
 
+  if (this->IsStatic())
+    this->NotifyStaticChange();
+
   if (this->collisionId && this->placeable)
   {
     if (this->IsStatic())
@@ -185,6 +196,19 @@ ignition::math::AxisAlignedBox ODECollision::BoundingBox() const
   return box;
 }
 
+//////////////////////////////////////////////////
+void ODECollision::NotifyStaticChange()
+{
+  WorldPtr world = this->GetWorld();
+  if (!world)
+    return;
+
+  ODEPhysicsPtr physics =
+    boost::dynamic_pointer_cast<ODEPhysics>(world->Physics());
+  if (physics)
+    physics->SetStaticCollisionsDirty();
+}
+
 //////////////////////////////////////////////////
 dSpaceID ODECollision::GetSpaceId() const
 {
@@ -99,6 +99,10 @@ namespace gazebo
       /// \brief Empty pose change callback.
       private: void OnPoseChangeNull();
 
+      /// \brief Tell the physics engine that a static collision was
+      /// added, moved or removed.
+      private: void NotifyStaticChange();
+
       /// \brief Collision space for this.
       protected: dSpaceID spaceId;
 
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "gazebo/physics/ode/ODEGeomIndex.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+/// \brief Maximum number of geoms stored in a leaf node.
+static const size_t kLeafSize = 4;
+
+/////////////////////////////////////////////////
+/// \brief Test two ODE bounding boxes for overlap, using the same
+/// convention as the ODE spaces.
+static bool Overlap(const dReal *_a, const dReal *_b)
+{
+  return !(_a[0] > _b[1] || _b[0] > _a[1] ||
+           _a[2] > _b[3] || _b[2] > _a[3] ||
+           _a[4] > _b[5] || _b[4] > _a[5]);
+}
+
+//////////////////////////////////////////////////
+void ODEGeomIndex::Build(const std::vector<dGeomID> &_geoms)
+{
+  this->Clear();
+
+  this->entries.reserve(_geoms.size());
+  for (auto const &geom : _geoms)
+  {
+    Entry entry;
+    entry.geom = geom;
+    dGeomGetAABB(geom, entry.aabb);
+
+    bool bounded = true;
+    for (unsigned int i = 0; i < 6; ++i)
+      bounded = bounded && std::isfinite(entry.aabb[i]);
+
+    if (bounded)
+      this->entries.push_back(entry);
+    else
+      this->unbounded.push_back(geom);
+  }
+
+  if (!this->entries.empty())
+  {
+    this->nodes.reserve(2 * this->entries.size() / kLeafSize + 1);
+    this->BuildNode(0, this->entries.size());
+  }
+}
+
+//////////////////////////////////////////////////
+int ODEGeomIndex::BuildNode(const size_t _first, const size_t _count)
+{
+  const int index = static_cast<int>(this->nodes.size());
+  this->nodes.push_back(Node());
+
+  Node node;
+  node.first = _first;
+  node.count = _count;
+  node.left = -1;
+  node.right = -1;
+
+  // Bounding box of the entries and of their centers.
+  dReal center[6];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    node.aabb[i*2] = dInfinity;
+    node.aabb[i*2+1] = -dInfinity;
+    center[i*2] = dInfinity;
+    center[i*2+1] = -dInfinity;
+  }
+
+  for (size_t e = _first; e < _first + _count; ++e)
+  {
+    const dReal *box = this->entries[e].aabb;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      node.aabb[i*2] = std::min(node.aabb[i*2], box[i*2]);
+      node.aabb[i*2+1] = std::max(node.aabb[i*2+1], box[i*2+1]);
+
+      const dReal c = 0.5 * (box[i*2] + box[i*2+1]);
+      center[i*2] = std::min(center[i*2], c);
+      center[i*2+1] = std::max(center[i*2+1], c);
+    }
+  }
+
+  if (_count > kLeafSize)
+  {
+    // Split at the median along the axis with the largest center spread.
+    unsigned int axis = 0;
+    for (unsigned int i = 1; i < 3; ++i)
+    {
+      if (center[i*2+1] - center[i*2] > center[axis*2+1] - center[axis*2])
+        axis = i;
+    }
+
+    const size_t half = _count / 2;
+    auto begin = this->entries.begin() + _first;
+    std::nth_element(begin, begin + half, begin + _count,
+        [axis](const Entry &_a, const Entry &_b)
+        {
+          return _a.aabb[axis*2] + _a.aabb[axis*2+1] <
+                 _b.aabb[axis*2] + _b.aabb[axis*2+1];
+        });
+
+    node.left = this->BuildNode(_first, half);
+    node.right = this->BuildNode(_first + half, _count - half);
+  }
+
+  this->nodes[index] = node;
+  return index;
+}
+
+//////////////////////////////////////////////////
+void ODEGeomIndex::Clear()
+{
+  this->entries.clear();
+  this->nodes.clear();
+  this->unbounded.clear();
+}
+
+//////////////////////////////////////////////////
+size_t ODEGeomIndex::GeomCount() const
+{
+  return this->entries.size() + this->unbounded.size();
+}
+
+//////////////////////////////////////////////////
+void ODEGeomIndex::Query(const dReal _aabb[6],
+    std::vector<dGeomID> &_result) const
+{
+  _result.insert(_result.end(), this->unbounded.begin(),
+      this->unbounded.end());
+
+  if (this->nodes.empty())
+    return;
+
+  // Iterative traversal; the depth of a median split tree is logarithmic
+  // so a small fixed stack is enough.
+  int stack[64];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+  {
+    const Node &node = this->nodes[stack[--top]];
+    if (!Overlap(node.aabb, _aabb))
+      continue;
+
+    if (node.left < 0)
+    {
+      for (size_t e = node.first; e < node.first + node.count; ++e)
+      {
+        if (Overlap(this->entries[e].aabb, _aabb))
+          _result.push_back(this->entries[e].geom);
+      }
+    }
+    else
+    {
+      stack[top++] = node.left;
+      stack[top++] = node.right;
+    }
+  }
+}
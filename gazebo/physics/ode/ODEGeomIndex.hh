@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_PHYSICS_ODE_ODEGEOMINDEX_HH_
+#define GAZEBO_PHYSICS_ODE_ODEGEOMINDEX_HH_
+
+#include <vector>
+
+#include "gazebo/physics/ode/ode_inc.h"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace physics
+  {
+    /// \addtogroup gazebo_physics_ode
+    /// \{
+
+    /// \brief Bounding volume hierarchy over a set of ODE geoms whose
+    /// axis aligned bounding boxes rarely change, such as the collisions
+    /// of static models. The hierarchy is built once from a snapshot of
+    /// the geom bounding boxes and then queried with the bounding box of
+    /// each moving geom, so that the cost of a query grows with the
+    /// logarithm of the number of indexed geoms instead of linearly.
+    /// Geoms with an unbounded box (e.g. planes) are kept in a separate
+    /// list that is returned by every query.
+    class GZ_PHYSICS_VISIBLE ODEGeomIndex
+    {
+      /// \brief Constructor.
+      public: ODEGeomIndex() = default;
+
+      /// \brief Rebuild the hierarchy from a list of geoms. The bounding
+      /// box of every geom is sampled once, during this call.
+      /// \param[in] _geoms Geoms to index. Spaces are indexed as a whole.
+      public: void Build(const std::vector<dGeomID> &_geoms);
+
+      /// \brief Remove all the geoms from the index.
+      public: void Clear();
+
+      /// \brief Get the number of indexed geoms.
+      /// \return Number of geoms, including unbounded geoms.
+      public: size_t GeomCount() const;
+
+      /// \brief Find all the indexed geoms whose bounding box overlaps
+      /// a given box.
+      /// \param[in] _aabb Query box in ODE layout
+      /// (minx, maxx, miny, maxy, minz, maxz).
+      /// \param[out] _result Overlapping geoms are appended to this list.
+      public: void Query(const dReal _aabb[6],
+                         std::vector<dGeomID> &_result) const;
+
+      /// \brief Recursively build a node of the hierarchy.
+      /// \param[in] _first Index of the first entry covered by the node.
+      /// \param[in] _count Number of entries covered by the node.
+      /// \return Index of the new node.
+      private: int BuildNode(const size_t _first, const size_t _count);
+
+      /// \brief A single indexed geom.
+      private: struct Entry
+      {
+        /// \brief Cached bounding box of the geom.
+        dReal aabb[6];
+
+        /// \brief The geom.
+        dGeomID geom;
+      };
+
+      /// \brief A node of the hierarchy. Leaves have no children.
+      private: struct Node
+      {
+        /// \brief Bounding box enclosing all the entries of the node.
+        dReal aabb[6];
+
+        /// \brief Index of the first entry of the node.
+        size_t first;
+
+        /// \brief Number of entries covered by the node.
+        size_t count;
+
+        /// \brief Index of the left child, -1 for leaves.
+        int left;
+
+        /// \brief Index of the right child, -1 for leaves.
+        int right;
+      };
+
+      /// \brief Bounded entries, ordered so that every node covers a
+      /// contiguous range.
+      private: std::vector<Entry> entries;
+
+      /// \brief Nodes of the hierarchy; the root is the first node.
+      private: std::vector<Node> nodes;
+
+      /// \brief Geoms with an infinite bounding box.
+      private: std::vector<dGeomID> unbounded;
+    };
+    /// \}
+  }
+}
+#endif
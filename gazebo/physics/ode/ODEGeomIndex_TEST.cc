@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "gazebo/physics/ode/ODEGeomIndex.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+using namespace physics;
+
+class ODEGeomIndex_TEST : public gazebo::testing::AutoLogFixture
+{
+  protected: void SetUp() override
+  {
+    gazebo::testing::AutoLogFixture::SetUp();
+    dInitODE2(0);
+  }
+
+  protected: void TearDown() override
+  {
+    dCloseODE();
+    gazebo::testing::AutoLogFixture::TearDown();
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(ODEGeomIndex_TEST, Query)
+{
+  // A row of unit boxes along the x axis, one every 2 meters.
+  std::vector<dGeomID> geoms;
+  for (int i = 0; i < 100; ++i)
+  {
+    dGeomID box = dCreateBox(nullptr, 1, 1, 1);
+    dGeomSetPosition(box, i * 2.0, 0, 0);
+    geoms.push_back(box);
+  }
+
+  dGeomID plane = dCreatePlane(nullptr, 0, 0, 1, 0);
+  geoms.push_back(plane);
+
+  ODEGeomIndex index;
+  EXPECT_EQ(index.GeomCount(), 0u);
+
+  index.Build(geoms);
+  EXPECT_EQ(index.GeomCount(), geoms.size());
+
+  // Box overlapping the boxes at x = 10 and x = 12.
+  dReal aabb[6] = {10.2, 11.8, -0.1, 0.1, -0.1, 0.1};
+  std::vector<dGeomID> result;
+  index.Query(aabb, result);
+  ASSERT_EQ(result.size(), 3u);
+  EXPECT_NE(std::find(result.begin(), result.end(), plane), result.end());
+  EXPECT_NE(std::find(result.begin(), result.end(), geoms[5]), result.end());
+  EXPECT_NE(std::find(result.begin(), result.end(), geoms[6]), result.end());
+
+  // Far away from every box, only the plane is returned.
+  dReal far[6] = {-10, -9, 5, 6, 5, 6};
+  result.clear();
+  index.Query(far, result);
+  ASSERT_EQ(result.size(), 1u);
+  EXPECT_EQ(result[0], plane);
+
+  index.Clear();
+  EXPECT_EQ(index.GeomCount(), 0u);
+  result.clear();
+  index.Query(aabb, result);
+  EXPECT_TRUE(result.empty());
+
+  for (auto &geom : geoms)
+    dGeomDestroy(geom);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
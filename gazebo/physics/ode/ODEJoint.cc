@@ -138,6 +138,12 @@ void ODEJoint::Load(sdf::ElementPtr _sdf)
   }
 }
 
+//////////////////////////////////////////////////
+dJointID ODEJoint::GetODEId() const
+{
+  return this->jointId;
+}
+
 //////////////////////////////////////////////////
 LinkPtr ODEJoint::GetJointLink(unsigned int _index) const
 {
@@ -64,6 +64,10 @@ namespace gazebo
       // Documentation inherited.
       public: virtual LinkPtr GetJointLink(unsigned int _index) const override;
 
+      /// \brief Return the ID of this joint
+      /// \return ODE joint id
+      public: dJointID GetODEId() const;
+
       // Documentation inherited.
       public: virtual bool AreConnected(LinkPtr _one, LinkPtr _two) const
             override;
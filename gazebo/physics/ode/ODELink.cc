@@ -25,6 +25,7 @@
 #include "gazebo/physics/World.hh"
 #include "gazebo/physics/WorldPrivate.hh"
 #include "gazebo/physics/Model.hh"
+#include "gazebo/physics/SleepManager.hh"
 #include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODESurfaceParams.hh"
 #include "gazebo/physics/ode/ODEPhysics.hh"
@@ -65,19 +66,7 @@ void ODELink::Init()
   {
     this->linkId = dBodyCreate(this->odePhysics->GetWorldId());
     dBodySetData(this->linkId, this);
-
-    // Only use auto disable if no joints and no sensors are present
-    if (this->GetModel()->GetAutoDisable() &&
-        this->GetModel()->GetJointCount() == 0 &&
-        this->GetSensorCount() == 0)
-    {
-      dBodySetAutoDisableDefaults(this->linkId);
-      dBodySetAutoDisableFlag(this->linkId, 1);
-    }
-    else
-    {
-      dBodySetAutoDisableFlag(this->linkId, 0);
-    }
+    this->UpdateAutoDisable();
   }
 
   GZ_ASSERT(this->sdf != nullptr, "Unable to initialize link, SDF is null");
@@ -133,8 +122,15 @@ void ODELink::Init()
 }
 
 //////////////////////////////////////////////////
-void ODELink::DisabledCallback(dBodyID /*_id*/)
+void ODELink::DisabledCallback(dBodyID _id)
 {
+  ODELink *self = static_cast<ODELink*>(dBodyGetData(_id));
+
+  // Once every body of the link space is disabled the space is only
+  // collided against moving bodies.
+  self->odePhysics->RequestSpaceResting(self->spaceId, true);
+
+  self->odePhysics->GetSleepManager()->SetSleeping(self, true);
 }
 
 //////////////////////////////////////////////////
@@ -145,6 +141,11 @@ void ODELink::MoveCallback(dBodyID _id)
   ODELink *self = static_cast<ODELink*>(dBodyGetData(_id));
   // self->poseMutex->lock();
 
+  // The body may have been woken up by a contact with a moving body.
+  self->odePhysics->RequestSpaceResting(self->spaceId, false);
+  if (self->Sleeping())
+    self->odePhysics->GetSleepManager()->SetSleeping(self, false);
+
   p = dBodyGetPosition(_id);
   r = dBodyGetQuaternion(_id);
 
@@ -288,6 +289,36 @@ void ODELink::SetEnabled(bool _enable) const
     dBodyEnable(this->linkId);
   else
     dBodyDisable(this->linkId);
+
+  this->odePhysics->RequestSpaceResting(this->spaceId, !_enable);
+  this->odePhysics->GetSleepManager()->SetSleeping(this, !_enable);
+}
+
+/////////////////////////////////////////////////////////////////////
+void ODELink::SetStatic(const bool &_static)
+{
+  Link::SetStatic(_static);
+
+  // A model made static at run time keeps its bodies. Hold them in place,
+  // the static collision index assumes static geoms don't move.
+  if (this->linkId && this->initialized)
+  {
+    if (_static)
+    {
+      dBodySetLinearVel(this->linkId, 0, 0, 0);
+      dBodySetAngularVel(this->linkId, 0, 0, 0);
+      dBodySetKinematic(this->linkId);
+    }
+    else if (!this->sdf->Get<bool>("kinematic"))
+    {
+      dBodySetDynamic(this->linkId);
+    }
+  }
+
+  // The space is shared by all links of the model, duplicate requests are
+  // ignored by the physics engine.
+  if (this->odePhysics)
+    this->odePhysics->RequestSpaceStatic(this->spaceId, _static);
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -777,6 +808,31 @@ void ODELink::SetAutoDisable(bool _disable)
     gzlog << "ODE model has joints, unable to SetAutoDisable" << std::endl;
 }
 
+//////////////////////////////////////////////////
+void ODELink::UpdateAutoDisable()
+{
+  if (!this->linkId)
+    return;
+
+  // Only use auto disable if no joints and no sensors are present
+  if (this->odePhysics->GetSleepManager()->Enabled() &&
+      this->GetModel()->GetAutoDisable() &&
+      this->GetModel()->GetJointCount() == 0 &&
+      this->GetSensorCount() == 0)
+  {
+    dBodySetAutoDisableDefaults(this->linkId);
+    dBodySetAutoDisableFlag(this->linkId, 1);
+  }
+  else
+  {
+    dBodySetAutoDisableFlag(this->linkId, 0);
+
+    // Wake up the links put to sleep before sleeping was disabled
+    if (this->Sleeping())
+      this->SetEnabled(true);
+  }
+}
+
 //////////////////////////////////////////////////
 void ODELink::SetLinkStatic(bool /*_static*/)
 {
@@ -158,6 +158,11 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetAutoDisable(bool _disable);
 
+      /// \brief Apply the sleep parameters of the physics engine to the
+      /// auto-disable settings of the body. Links of models with joints,
+      /// and links with sensors, never sleep.
+      public: void UpdateAutoDisable();
+
       /// \brief Return the ID of this link
       /// \return ODE link id
       public: dBodyID GetODEId() const;
@@ -182,6 +187,10 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetLinkStatic(bool _static);
 
+      // Documentation inherited
+      public: virtual void SetStatic(const bool &_static);
+      using Link::SetStatic;
+
       /// \brief ODE link handle
       private: dBodyID linkId;
 
@@ -97,6 +97,9 @@ void ODEMultiRayShape::UpdateRays()
     dSpaceCollide2((dGeomID) (this->superSpaceId),
         (dGeomID) (ode->GetSpaceId()),
         this, &UpdateCallback);
+
+    // Static collisions are kept out of the world space.
+    ode->CollideStatic((dGeomID) (this->raySpaceId), this, &UpdateCallback);
   }
 }
 
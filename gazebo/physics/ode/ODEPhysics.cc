@@ -21,6 +21,7 @@
 #include <sdf/sdf.hh>
 
 #include <algorithm>
+#include <list>
 #include <map>
 #include <string>
 #include <utility>
@@ -47,6 +48,7 @@
 #include "gazebo/physics/Collision.hh"
 #include "gazebo/physics/MapShape.hh"
 #include "gazebo/physics/ContactManager.hh"
+#include "gazebo/physics/SleepManager.hh"
 
 #include "gazebo/physics/ode/ODECollision.hh"
 #include "gazebo/physics/ode/ODELink.hh"
@@ -58,6 +60,7 @@
 #include "gazebo/physics/ode/ODEBallJoint.hh"
 #include "gazebo/physics/ode/ODEUniversalJoint.hh"
 #include "gazebo/physics/ode/ODEFixedJoint.hh"
+#include "gazebo/physics/ode/ODEJoint.hh"
 
 #include "gazebo/physics/ode/ODERayShape.hh"
 #include "gazebo/physics/ode/ODEBoxShape.hh"
@@ -146,10 +149,37 @@ ODEPhysics::ODEPhysics(WorldPtr _world)
   this->dataPtr->spaceId = dHashSpaceCreate(0);
   dHashSpaceSetLevels(this->dataPtr->spaceId, -2, 8);
 
+  // Static and resting collisions live outside of the world space, so that
+  // they are never paired with each other by dSpaceCollide.
+  this->dataPtr->staticSpaceId = dSimpleSpaceCreate(0);
+  this->dataPtr->restingSpaceId = dSimpleSpaceCreate(0);
+  this->dataPtr->staticIndexDirty = true;
+  this->dataPtr->restingIndexDirty = false;
+  this->dataPtr->restingAllowed = false;
+
   this->dataPtr->contactGroup = dJointGroupCreate(0);
 
   this->dataPtr->colliders.resize(100);
 
+  PhysicsEngine::RegisterSnapshotFuncs("ode",
+      [](const PhysicsEngine &_engine, const Link_V &_links,
+         const Joint_V &_joints, std::string &_data)
+      {
+        static_cast<const ODEPhysics &>(_engine).SaveSnapshot(
+            _links, _joints, _data);
+      },
+      [](PhysicsEngine &_engine, const Link_V &_links,
+         const Joint_V &_joints, const char *&_data, const char *_end)
+      {
+        return static_cast<ODEPhysics &>(_engine).RestoreSnapshot(
+            _links, _joints, _data, _end);
+      });
+
+  // ODE disables resting bodies itself. Models with joints are excluded
+  // from auto-disable, see ODELink::UpdateAutoDisable.
+  this->GetSleepManager()->SetNative(true);
+  this->GetSleepManager()->SetEnabled(true);
+
   // Set random seed for physics engine based on gazebo's random seed.
   // Note: this was moved from physics::PhysicsEngine constructor.
   this->SetSeed(ignition::math::Rand::Seed());
@@ -199,14 +229,11 @@ void ODEPhysics::Load(sdf::ElementPtr _sdf)
        odeElem->GetElement("constraints")->Get<double>(
         "contact_surface_layer"));
 
-  // Enable auto-disable by default. Models with joints are excluded from
-  // auto-disable
-  dWorldSetAutoDisableFlag(this->dataPtr->worldId, 1);
-
-  dWorldSetAutoDisableTime(this->dataPtr->worldId, 1);
-  dWorldSetAutoDisableLinearThreshold(this->dataPtr->worldId, 0.1);
-  dWorldSetAutoDisableAngularThreshold(this->dataPtr->worldId, 0.1);
-  dWorldSetAutoDisableSteps(this->dataPtr->worldId, 5);
+  // Auto-disable follows the sleep parameters, which can change at run time
+  this->OnSleepParamsChanged();
+  this->dataPtr->sleepParamsConnection =
+    this->GetSleepManager()->ConnectParamsChanged(
+        std::bind(&ODEPhysics::OnSleepParamsChanged, this));
 
   auto g = this->world->Gravity();
 
@@ -371,10 +398,26 @@ void ODEPhysics::UpdateCollision()
   // Reset the contact count
   this->contactManager->ResetCount();
 
+  // Contacts between resting bodies are only generated when someone
+  // listens to them, so the resting set is not used in that case.
+  this->dataPtr->restingAllowed = !this->contactManager->NeverDropContacts() &&
+    !this->contactManager->SubscribersConnected(nullptr, nullptr);
+  this->UpdateCollisionSets();
+
   // Do collision detection; this will add contacts to the contact group
   dSpaceCollide(this->dataPtr->spaceId, this, CollisionCallback);
   DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "dSpaceCollide");
 
+  // Collide the moving spaces against the static and resting collisions.
+  // Static-static and resting-resting pairs are never generated.
+  int numGeoms = dSpaceGetNumGeoms(this->dataPtr->spaceId);
+  for (int g = 0; g < numGeoms; ++g)
+  {
+    this->CollideIndexed(dSpaceGetGeom(this->dataPtr->spaceId, g), this,
+        CollisionCallback);
+  }
+  DIAG_TIMER_LAP("ODEPhysics::UpdateCollision", "collideStatic");
+
   // Generate non-trimesh collisions.
   for (i = 0; i < this->dataPtr->collidersCount; ++i)
   {
@@ -448,6 +491,8 @@ void ODEPhysics::UpdatePhysics()
 //////////////////////////////////////////////////
 void ODEPhysics::Fini()
 {
+  this->dataPtr->sleepParamsConnection.reset();
+
   dCloseODE();
 
   if (this->dataPtr->contactGroup)
@@ -468,6 +513,23 @@ void ODEPhysics::Fini()
     dSpaceDestroy(this->dataPtr->spaceId);
   }
 
+  this->dataPtr->staticIndex.Clear();
+  this->dataPtr->restingIndex.Clear();
+
+  if (this->dataPtr->staticSpaceId)
+  {
+    dSpaceSetCleanup(this->dataPtr->staticSpaceId, 0);
+    dSpaceDestroy(this->dataPtr->staticSpaceId);
+  }
+  this->dataPtr->staticSpaceId = nullptr;
+
+  if (this->dataPtr->restingSpaceId)
+  {
+    dSpaceSetCleanup(this->dataPtr->restingSpaceId, 0);
+    dSpaceDestroy(this->dataPtr->restingSpaceId);
+  }
+  this->dataPtr->restingSpaceId = nullptr;
+
   if (this->dataPtr->worldId)
     dWorldDestroy(this->dataPtr->worldId);
   this->dataPtr->worldId = nullptr;
@@ -495,8 +557,20 @@ LinkPtr ODEPhysics::CreateLink(ModelPtr _parent)
   iter = this->dataPtr->spaces.find(_parent->GetName());
 
   if (iter == this->dataPtr->spaces.end())
-    this->dataPtr->spaces[_parent->GetName()] =
-      dSimpleSpaceCreate(this->dataPtr->spaceId);
+  {
+    // Collisions of static models are kept out of the world space.
+    if (_parent->IsStatic())
+    {
+      this->dataPtr->spaces[_parent->GetName()] =
+        dSimpleSpaceCreate(this->dataPtr->staticSpaceId);
+      this->dataPtr->staticIndexDirty = true;
+    }
+    else
+    {
+      this->dataPtr->spaces[_parent->GetName()] =
+        dSimpleSpaceCreate(this->dataPtr->spaceId);
+    }
+  }
 
   ODELinkPtr link(new ODELink(_parent));
 
@@ -901,6 +975,234 @@ dSpaceID ODEPhysics::GetSpaceId() const
   return this->dataPtr->spaceId;
 }
 
+//////////////////////////////////////////////////
+dSpaceID ODEPhysics::GetStaticSpaceId() const
+{
+  return this->dataPtr->staticSpaceId;
+}
+
+//////////////////////////////////////////////////
+/// \brief Recursively collect the non-space geoms of a space.
+/// \param[in] _spaceId Space to traverse.
+/// \param[out] _geoms Leaf geoms are appended to this list.
+static void CollectGeoms(dSpaceID _spaceId, std::vector<dGeomID> &_geoms)
+{
+  int numGeoms = dSpaceGetNumGeoms(_spaceId);
+  for (int i = 0; i < numGeoms; ++i)
+  {
+    dGeomID geom = dSpaceGetGeom(_spaceId, i);
+    if (dGeomIsSpace(geom))
+      CollectGeoms(reinterpret_cast<dSpaceID>(geom), _geoms);
+    else
+      _geoms.push_back(geom);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Check whether a space contains at least one body and whether
+/// all of its bodies are disabled.
+/// \param[in] _spaceId Space to check.
+/// \param[out] _hasBody Set to true if a geom is attached to a body.
+/// \return False if any geom is attached to an enabled body.
+static bool SpaceAtRest(dSpaceID _spaceId, bool &_hasBody)
+{
+  int numGeoms = dSpaceGetNumGeoms(_spaceId);
+  for (int i = 0; i < numGeoms; ++i)
+  {
+    dGeomID geom = dSpaceGetGeom(_spaceId, i);
+    if (dGeomIsSpace(geom))
+    {
+      if (!SpaceAtRest(reinterpret_cast<dSpaceID>(geom), _hasBody))
+        return false;
+    }
+    else if (dGeomGetBody(geom))
+    {
+      _hasBody = true;
+      if (dBodyIsEnabled(dGeomGetBody(geom)))
+        return false;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::SetStaticCollisionsDirty()
+{
+  this->dataPtr->staticIndexDirty = true;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::RequestSpaceResting(dSpaceID _spaceId, const bool _resting)
+{
+  if (!_spaceId || !this->dataPtr->restingSpaceId)
+    return;
+
+  // Most calls come from moving bodies, which are already awake.
+  if (!_resting && dGeomGetSpace(reinterpret_cast<dGeomID>(_spaceId)) !=
+      this->dataPtr->restingSpaceId)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->restingMutex);
+  this->dataPtr->restingRequests.push_back(
+      std::make_pair(_spaceId, _resting));
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::RequestSpaceStatic(dSpaceID _spaceId, const bool _static)
+{
+  if (!_spaceId || !this->dataPtr->staticSpaceId)
+    return;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->restingMutex);
+  this->dataPtr->staticRequests.push_back(std::make_pair(_spaceId, _static));
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::MoveSpace(dSpaceID _spaceId, const bool _resting)
+{
+  dGeomID geom = reinterpret_cast<dGeomID>(_spaceId);
+  if (_resting)
+  {
+    dSpaceRemove(this->dataPtr->spaceId, geom);
+    dSpaceAdd(this->dataPtr->restingSpaceId, geom);
+  }
+  else
+  {
+    dSpaceRemove(this->dataPtr->restingSpaceId, geom);
+    dSpaceAdd(this->dataPtr->spaceId, geom);
+  }
+  this->dataPtr->restingIndexDirty = true;
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::UpdateCollisionSets()
+{
+  std::vector<std::pair<dSpaceID, bool> > requests;
+  std::vector<std::pair<dSpaceID, bool> > staticRequests;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->restingMutex);
+    requests.swap(this->dataPtr->restingRequests);
+    staticRequests.swap(this->dataPtr->staticRequests);
+  }
+
+  // Models whose static flag changed after they were loaded.
+  for (auto const &request : staticRequests)
+  {
+    dGeomID geom = reinterpret_cast<dGeomID>(request.first);
+    dSpaceID parent = dGeomGetSpace(geom);
+    if (!parent || request.second == (parent == this->dataPtr->staticSpaceId))
+      continue;
+
+    if (parent == this->dataPtr->restingSpaceId)
+      this->dataPtr->restingIndexDirty = true;
+
+    dSpaceRemove(parent, geom);
+    dSpaceAdd(request.second ? this->dataPtr->staticSpaceId :
+        this->dataPtr->spaceId, geom);
+    this->dataPtr->staticIndexDirty = true;
+  }
+
+  if (!this->dataPtr->restingAllowed)
+  {
+    while (dSpaceGetNumGeoms(this->dataPtr->restingSpaceId) > 0)
+    {
+      this->MoveSpace(reinterpret_cast<dSpaceID>(
+            dSpaceGetGeom(this->dataPtr->restingSpaceId, 0)), false);
+    }
+  }
+  else
+  {
+    for (auto const &request : requests)
+    {
+      dSpaceID parent =
+        dGeomGetSpace(reinterpret_cast<dGeomID>(request.first));
+
+      if (request.second && parent == this->dataPtr->spaceId)
+      {
+        bool hasBody = false;
+        if (SpaceAtRest(request.first, hasBody) && hasBody)
+          this->MoveSpace(request.first, true);
+      }
+      else if (!request.second && parent == this->dataPtr->restingSpaceId)
+      {
+        this->MoveSpace(request.first, false);
+      }
+    }
+  }
+
+  if (this->dataPtr->staticIndexDirty)
+  {
+    std::vector<dGeomID> geoms;
+    CollectGeoms(this->dataPtr->staticSpaceId, geoms);
+    this->dataPtr->staticIndex.Build(geoms);
+    this->dataPtr->staticIndexDirty = false;
+  }
+
+  if (this->dataPtr->restingIndexDirty)
+  {
+    std::vector<dGeomID> spaces;
+    int numGeoms = dSpaceGetNumGeoms(this->dataPtr->restingSpaceId);
+    for (int i = 0; i < numGeoms; ++i)
+      spaces.push_back(dSpaceGetGeom(this->dataPtr->restingSpaceId, i));
+    this->dataPtr->restingIndex.Build(spaces);
+    this->dataPtr->restingIndexDirty = false;
+  }
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::CollideStatic(dGeomID _geom, void *_data,
+    dNearCallback *_callback)
+{
+  this->UpdateCollisionSets();
+  this->CollideIndexed(_geom, _data, _callback);
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::CollideIndexed(dGeomID _geom, void *_data,
+    dNearCallback *_callback)
+{
+  if (!dGeomIsEnabled(_geom))
+    return;
+
+  if (this->dataPtr->staticIndex.GeomCount() == 0 &&
+      this->dataPtr->restingIndex.GeomCount() == 0)
+  {
+    return;
+  }
+
+  dReal aabb[6];
+  dGeomGetAABB(_geom, aabb);
+
+  std::vector<dGeomID> &candidates = this->dataPtr->indexCandidates;
+  candidates.clear();
+  this->dataPtr->staticIndex.Query(aabb, candidates);
+  this->dataPtr->restingIndex.Query(aabb, candidates);
+
+  // Same filtering as the ODE spaces apply before calling the callback.
+  unsigned long categoryBits = dGeomGetCategoryBits(_geom);
+  unsigned long collideBits = dGeomGetCollideBits(_geom);
+  dBodyID body = dGeomGetBody(_geom);
+
+  for (auto const &other : candidates)
+  {
+    if (!dGeomIsEnabled(other))
+      continue;
+
+    if ((categoryBits & dGeomGetCollideBits(other)) == 0 &&
+        (dGeomGetCategoryBits(other) & collideBits) == 0)
+    {
+      continue;
+    }
+
+    if (body && body == dGeomGetBody(other))
+      continue;
+
+    _callback(_data, _geom, other);
+  }
+}
+
 //////////////////////////////////////////////////
 std::string ODEPhysics::GetStepType() const
 {
@@ -1275,15 +1577,31 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
     jointFeedback->contact = contactFeedback;
   }
 
+  // Let the collisions edit the surface of their contacts
+  const bool editSurface =
+      (_collision1->HasContactSurfaceFunc() ||
+       _collision2->HasContactSurfaceFunc()) &&
+      !_collision1->GetSurface()->collideWithoutContact &&
+      !_collision2->GetSurface()->collideWithoutContact;
+  dContact editedContact;
+
   // Create a joint for each contact
   for (unsigned int j = 0; j < numc; ++j)
   {
     contact.geom = _contactCollisions[this->dataPtr->indices[j]];
 
+    const dContact *jointContact = &contact;
+    if (editSurface)
+    {
+      editedContact = contact;
+      this->EditContactSurface(_collision1, _collision2, editedContact);
+      jointContact = &editedContact;
+    }
+
     // Create the contact joint. This introduces the contact constraint to
     // ODE
     dJointID contactJoint = dJointCreateContact(this->dataPtr->worldId,
-      this->dataPtr->contactGroup, &contact);
+      this->dataPtr->contactGroup, jointContact);
 
     // Store contact information.
     if (contactFeedback && jointFeedback)
@@ -1319,6 +1637,61 @@ void ODEPhysics::Collide(ODECollision *_collision1, ODECollision *_collision2,
   }
 }
 
+/////////////////////////////////////////////////
+void ODEPhysics::EditContactSurface(ODECollision *_collision1,
+    ODECollision *_collision2, dContact &_contact) const
+{
+  ContactSurface surface;
+  surface.collision1 = _collision1;
+  surface.collision2 = _collision2;
+  surface.position.Set(_contact.geom.pos[0], _contact.geom.pos[1],
+      _contact.geom.pos[2]);
+  surface.normal.Set(_contact.geom.normal[0], _contact.geom.normal[1],
+      _contact.geom.normal[2]);
+  surface.depth = _contact.geom.depth;
+  if (_contact.surface.mode & dContactFDir1)
+  {
+    surface.frictionDirection1.Set(_contact.fdir1[0], _contact.fdir1[1],
+        _contact.fdir1[2]);
+  }
+  surface.mu1 = _contact.surface.mu;
+  surface.mu2 = _contact.surface.mu2;
+  surface.slip1 = _contact.surface.slip1;
+  surface.slip2 = _contact.surface.slip2;
+
+  _collision1->ProcessContactSurface(surface);
+  _collision2->ProcessContactSurface(surface);
+
+  if (surface.frictionDirection1 != ignition::math::Vector3d::Zero)
+  {
+    _contact.surface.mode |= dContactFDir1;
+    _contact.fdir1[0] = surface.frictionDirection1.X();
+    _contact.fdir1[1] = surface.frictionDirection1.Y();
+    _contact.fdir1[2] = surface.frictionDirection1.Z();
+  }
+  else
+  {
+    _contact.surface.mode &= ~dContactFDir1;
+  }
+
+  _contact.surface.mu = surface.mu1;
+  _contact.surface.mu2 = surface.mu2;
+  _contact.surface.slip1 = surface.slip1;
+  _contact.surface.slip2 = surface.slip2;
+
+  if (!ignition::math::equal(surface.motion1, 0.0))
+  {
+    _contact.surface.mode |= dContactMotion1;
+    _contact.surface.motion1 = surface.motion1;
+  }
+
+  if (!ignition::math::equal(surface.motion2, 0.0))
+  {
+    _contact.surface.mode |= dContactMotion2;
+    _contact.surface.motion2 = surface.motion2;
+  }
+}
+
 /////////////////////////////////////////////////
 void ODEPhysics::AddTrimeshCollider(ODECollision *_collision1,
                                     ODECollision *_collision2)
@@ -1402,7 +1775,105 @@ void ODEPhysics::DebugPrint() const
 /////////////////////////////////////////////////
 void ODEPhysics::SetSeed(uint32_t _seed)
 {
-  dRandSetSeed(_seed);
+  // Per world seed, the global dRand seed would be shared by every world
+  dWorldSetQuickStepRandSeed(this->dataPtr->worldId, _seed);
+}
+
+//////////////////////////////////////////////////
+void ODEPhysics::SaveSnapshot(const Link_V &_links, const Joint_V &_joints,
+    std::string &_data) const
+{
+  // quickstep reorders constraint rows randomly
+  const uint64_t seed = dWorldGetQuickStepRandSeed(this->dataPtr->worldId);
+  WriteSnapshot(_data, &seed, 1);
+
+  dReal state[dBODY_STATE_SIZE];
+  for (auto const &link : _links)
+  {
+    dBodyID body = static_cast<ODELink *>(link.get())->GetODEId();
+    const uint8_t hasBody = body ? 1 : 0;
+    WriteSnapshot(_data, &hasBody, 1);
+    if (body)
+    {
+      dBodyGetState(body, state);
+      WriteSnapshot(_data, state, dBODY_STATE_SIZE);
+    }
+  }
+
+  dReal lambda[dJOINT_WARM_START_SIZE];
+  for (auto const &joint : _joints)
+  {
+    dJointID jointId = static_cast<ODEJoint *>(joint.get())->GetODEId();
+    const uint8_t hasJoint = jointId ? 1 : 0;
+    WriteSnapshot(_data, &hasJoint, 1);
+    if (jointId)
+    {
+      dJointGetWarmStart(jointId, lambda);
+      WriteSnapshot(_data, lambda, dJOINT_WARM_START_SIZE);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool ODEPhysics::RestoreSnapshot(const Link_V &_links, const Joint_V &_joints,
+    const char *&_data, const char *_end)
+{
+  boost::recursive_mutex::scoped_lock lock(*this->physicsUpdateMutex);
+
+  uint64_t seed;
+  if (!ReadSnapshot(_data, _end, &seed, 1))
+    return false;
+  dWorldSetQuickStepRandSeed(this->dataPtr->worldId,
+      static_cast<unsigned long>(seed));
+
+  dReal state[dBODY_STATE_SIZE];
+  for (auto const &link : _links)
+  {
+    dBodyID body = static_cast<ODELink *>(link.get())->GetODEId();
+    uint8_t hasBody;
+    if (!ReadSnapshot(_data, _end, &hasBody, 1) ||
+        hasBody != (body ? 1 : 0))
+    {
+      return false;
+    }
+
+    if (body)
+    {
+      if (!ReadSnapshot(_data, _end, state, dBODY_STATE_SIZE))
+        return false;
+      dBodySetState(body, state);
+
+      // Propagate the pose to the link, as after a physics update
+      ODELink::MoveCallback(body);
+
+      // MoveCallback wakes the link up, apply the restored disabled flag
+      const bool sleeping = !dBodyIsEnabled(body);
+      this->RequestSpaceResting(
+          static_cast<ODELink *>(link.get())->GetSpaceId(), sleeping);
+      this->GetSleepManager()->SetSleeping(link.get(), sleeping);
+    }
+  }
+
+  dReal lambda[dJOINT_WARM_START_SIZE];
+  for (auto const &joint : _joints)
+  {
+    dJointID jointId = static_cast<ODEJoint *>(joint.get())->GetODEId();
+    uint8_t hasJoint;
+    if (!ReadSnapshot(_data, _end, &hasJoint, 1) ||
+        hasJoint != (jointId ? 1 : 0))
+    {
+      return false;
+    }
+
+    if (jointId)
+    {
+      if (!ReadSnapshot(_data, _end, lambda, dJOINT_WARM_START_SIZE))
+        return false;
+      dJointSetWarmStart(jointId, lambda);
+    }
+  }
+
+  return true;
 }
 
 //////////////////////////////////////////////////
@@ -1543,6 +2014,26 @@ bool ODEPhysics::SetParam(const std::string &_key, const boost::any &_value)
       }
       dWorldSetIslandThreads(this->dataPtr->worldId, value);
     }
+    else if (_key == "quickstep_threads")
+    {
+      dWorldSetQuickStepThreads(this->dataPtr->worldId,
+        any_cast<int>(_value));
+    }
+    else if (_key == "colored_rows")
+    {
+      dWorldSetQuickStepColoredRows(this->dataPtr->worldId,
+        any_cast<bool>(_value));
+    }
+    else if (_key == "vectorized_rows")
+    {
+      dWorldSetQuickStepVectorizedRows(this->dataPtr->worldId,
+        any_cast<bool>(_value));
+    }
+    else if (_key == "deterministic_rows")
+    {
+      dWorldSetQuickStepDeterministicRows(this->dataPtr->worldId,
+        any_cast<bool>(_value));
+    }
     else if (_key == "ode_quiet")
     {
       bool odeQuiet = any_cast<bool>(_value);
@@ -1650,6 +2141,19 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
     _value = this->GetFrictionModel();
   else if (_key == "island_threads")
     _value = dWorldGetIslandThreads(this->dataPtr->worldId);
+  else if (_key == "quickstep_threads")
+    _value = dWorldGetQuickStepThreads(this->dataPtr->worldId);
+  else if (_key == "colored_rows")
+    _value = dWorldGetQuickStepColoredRows(this->dataPtr->worldId);
+  else if (_key == "vectorized_rows")
+    _value = dWorldGetQuickStepVectorizedRows(this->dataPtr->worldId);
+  else if (_key == "deterministic_rows")
+    _value = dWorldGetQuickStepDeterministicRows(this->dataPtr->worldId);
+  else if (_key == "row_kernels")
+  {
+    _value = std::string(
+        dWorldGetQuickStepRowKernels(this->dataPtr->worldId));
+  }
   else if (_key == "ode_quiet")
     _value = dGetMessageHandler() != 0;
   else if (_key == "world_step_solver")
@@ -1660,3 +2164,34 @@ bool ODEPhysics::GetParam(const std::string &_key, boost::any &_value) const
   }
   return true;
 }
+
+/////////////////////////////////////////////////
+void ODEPhysics::OnSleepParamsChanged()
+{
+  if (!this->dataPtr->worldId)
+    return;
+
+  dWorldSetAutoDisableFlag(this->dataPtr->worldId,
+      this->GetSleepManager()->Enabled());
+  dWorldSetAutoDisableTime(this->dataPtr->worldId,
+      this->GetSleepManager()->IdleTime());
+  dWorldSetAutoDisableLinearThreshold(this->dataPtr->worldId,
+      this->GetSleepManager()->LinearThreshold());
+  dWorldSetAutoDisableAngularThreshold(this->dataPtr->worldId,
+      this->GetSleepManager()->AngularThreshold());
+  dWorldSetAutoDisableSteps(this->dataPtr->worldId, 5);
+
+  // Bodies copy the world parameters when they are created
+  std::list<ModelPtr> models;
+  for (const auto &model : this->world->Models())
+    models.push_back(model);
+  while (!models.empty())
+  {
+    ModelPtr model = models.front();
+    models.pop_front();
+    for (const auto &nested : model->NestedModels())
+      models.push_back(nested);
+    for (const auto &link : model->GetLinks())
+      boost::static_pointer_cast<ODELink>(link)->UpdateAutoDisable();
+  }
+}
@@ -213,6 +213,26 @@ namespace gazebo
       // Documentation inherited
       public: virtual void SetSeed(uint32_t _seed);
 
+      /// \brief Save the ODE body states, the quickstep seed and the joint
+      /// warm start data. Registered as the snapshot function of "ode",
+      /// see PhysicsEngine::SaveSnapshot.
+      /// \param[in] _links Links, in a stable order.
+      /// \param[in] _joints Joints, in a stable order.
+      /// \param[out] _data Buffer the state is appended to.
+      public: void SaveSnapshot(const Link_V &_links,
+                  const Joint_V &_joints, std::string &_data) const;
+
+      /// \brief Restore the state written by SaveSnapshot, see
+      /// PhysicsEngine::RestoreSnapshot.
+      /// \param[in] _links Links, in the order used to save the state.
+      /// \param[in] _joints Joints, in the order used to save the state.
+      /// \param[in,out] _data Start of the state; advanced past it.
+      /// \param[in] _end End of the snapshot buffer.
+      /// \return False if the buffer is too short.
+      public: bool RestoreSnapshot(const Link_V &_links,
+                  const Joint_V &_joints, const char *&_data,
+                  const char *_end);
+
       /// Documentation inherited
       public: virtual bool SetParam(const std::string &_key,
                   const boost::any &_value);
@@ -224,10 +244,47 @@ namespace gazebo
       public: virtual bool GetParam(const std::string &_key,
                   boost::any &_value) const;
 
-      /// \brief Return the world space id.
+      /// \brief Return the world space id. The world space only holds
+      /// the moving collisions; use CollideStatic to also test a geom
+      /// against the static and resting collisions.
       /// \return The space id for the world.
       public: dSpaceID GetSpaceId() const;
 
+      /// \brief Return the id of the space that holds the collisions of
+      /// static models.
+      /// \return The static space id.
+      public: dSpaceID GetStaticSpaceId() const;
+
+      /// \brief Collide a geom against the collisions of static models and
+      /// against the collisions of links at rest, in the same way as
+      /// dSpaceCollide2 would if they were in the world space. The callback
+      /// receives _geom as its first geom argument.
+      /// The physics update mutex must be held by the caller.
+      /// \param[in] _geom Geom or space to collide.
+      /// \param[in] _data User data passed to the callback.
+      /// \param[in] _callback Near callback.
+      public: void CollideStatic(dGeomID _geom, void *_data,
+                                 dNearCallback *_callback);
+
+      /// \brief Mark the collisions of static models as changed, so that
+      /// the static collision index is rebuilt before the next query.
+      public: void SetStaticCollisionsDirty();
+
+      /// \brief Request that a link space is moved in or out of the resting
+      /// set. A space is moved to the resting set only if all of its bodies
+      /// are disabled. Resting spaces are only collided against moving
+      /// spaces. The request is applied before the next collision query.
+      /// \param[in] _spaceId Top-level space of a link.
+      /// \param[in] _resting True to put the space to rest, false to wake it.
+      public: void RequestSpaceResting(dSpaceID _spaceId, const bool _resting);
+
+      /// \brief Request that a model space is moved in or out of the set of
+      /// static collisions, after the model static flag changed at run time.
+      /// The request is applied before the next collision query.
+      /// \param[in] _spaceId Top-level space of a model.
+      /// \param[in] _static True if the model became static.
+      public: void RequestSpaceStatic(dSpaceID _spaceId, const bool _static);
+
       /// \brief Get the world id.
       /// \return The world id.
       public: dWorldID GetWorldId();
@@ -315,6 +372,35 @@ namespace gazebo
       private: void AddCollider(ODECollision *_collision1,
                                 ODECollision *_collision2);
 
+      /// \brief Apply the pending resting requests and rebuild the static
+      /// and resting indices if needed.
+      private: void UpdateCollisionSets();
+
+      /// \brief Collide a geom against the static and resting indices
+      /// without updating them first.
+      /// \param[in] _geom Geom or space to collide.
+      /// \param[in] _data User data passed to the callback.
+      /// \param[in] _callback Near callback.
+      private: void CollideIndexed(dGeomID _geom, void *_data,
+                                   dNearCallback *_callback);
+
+      /// \brief Move a space in or out of the resting set.
+      /// \param[in] _spaceId Space to move.
+      /// \param[in] _resting True to move it to the resting set.
+      private: void MoveSpace(dSpaceID _spaceId, const bool _resting);
+
+      /// \brief Let the contact surface callbacks of two collisions edit
+      /// the surface of a contact.
+      /// \param[in] _collision1 First collision of the contact.
+      /// \param[in] _collision2 Second collision of the contact.
+      /// \param[in,out] _contact Contact to edit.
+      private: void EditContactSurface(ODECollision *_collision1,
+                   ODECollision *_collision2, dContact &_contact) const;
+
+      /// \brief Apply the parameters of the sleep manager to the ODE world
+      /// and to the existing bodies.
+      private: void OnSleepParamsChanged();
+
       /// \internal
       /// \brief Private data pointer.
       private: ODEPhysicsPrivate *dataPtr;
@@ -19,11 +19,14 @@
 #define _ODEPHYSICS_PRIVATE_HH_
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <utility>
 
+#include "gazebo/common/Event.hh"
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ode/ODEGeomIndex.hh"
 #include "gazebo/physics/ode/ODETypes.hh"
 
 namespace gazebo
@@ -50,9 +53,49 @@ namespace gazebo
       /// \brief Top-level world for all bodies
       public: dWorldID worldId;
 
-      /// \brief Top-level space for all sub-spaces/collisions
+      /// \brief Top-level space for all the moving sub-spaces/collisions.
       public: dSpaceID spaceId;
 
+      /// \brief Container space for the collisions of static models. It is
+      /// never collided against itself, only queried through staticIndex.
+      public: dSpaceID staticSpaceId;
+
+      /// \brief Container space for the sub-spaces whose bodies are all
+      /// disabled. It is only queried through restingIndex.
+      public: dSpaceID restingSpaceId;
+
+      /// \brief Spatial index over the geoms in staticSpaceId.
+      public: ODEGeomIndex staticIndex;
+
+      /// \brief Spatial index over the sub-spaces in restingSpaceId.
+      public: ODEGeomIndex restingIndex;
+
+      /// \brief True when staticIndex must be rebuilt.
+      public: bool staticIndexDirty;
+
+      /// \brief True when restingIndex must be rebuilt.
+      public: bool restingIndexDirty;
+
+      /// \brief False when contacts between resting bodies are requested,
+      /// in which case no space is put to rest.
+      public: bool restingAllowed;
+
+      /// \brief Pending requests to move a sub-space in (true) or out
+      /// (false) of the resting set.
+      public: std::vector<std::pair<dSpaceID, bool> > restingRequests;
+
+      /// \brief Pending requests to move a model space in (true) or out
+      /// (false) of staticSpaceId. Guarded by restingMutex.
+      public: std::vector<std::pair<dSpaceID, bool> > staticRequests;
+
+      /// \brief Protects restingRequests and staticRequests, which can be
+      /// filled from the ODE island threads.
+      public: std::mutex restingMutex;
+
+      /// \brief Scratch buffer for index queries. Guarded by the physics
+      /// update mutex.
+      public: std::vector<dGeomID> indexCandidates;
+
       /// \brief Collision attributes
       public: dJointGroupID contactGroup;
 
@@ -92,6 +135,9 @@ namespace gazebo
 
       /// \brief Maximum number of contact points per collision pair.
       public: unsigned int maxContacts;
+
+      /// \brief Connection to the parameter changes of the sleep manager.
+      public: event::ConnectionPtr sleepParamsConnection;
     };
   }
 }
@@ -320,6 +320,72 @@ TEST_F(ODEPhysics_TEST, PhysicsParam)
     }
   }
 
+  // Test colored_rows and quickstep_threads
+  {
+    // colored rows are off and there is no quickstep pool by default
+    bool coloredRows = true;
+    EXPECT_NO_THROW(coloredRows =
+      boost::any_cast<bool>(odePhysics->GetParam("colored_rows")));
+    EXPECT_FALSE(coloredRows);
+    int quickStepThreads = 1;
+    EXPECT_NO_THROW(quickStepThreads =
+      boost::any_cast<int>(odePhysics->GetParam("quickstep_threads")));
+    EXPECT_EQ(quickStepThreads, 0);
+
+    EXPECT_TRUE(odePhysics->SetParam("colored_rows", true));
+    EXPECT_NO_THROW(coloredRows =
+      boost::any_cast<bool>(odePhysics->GetParam("colored_rows")));
+    EXPECT_TRUE(coloredRows);
+
+    std::vector<int> threads = {2, 4, 0};
+    for (auto const quickStepThreadsSet : threads)
+    {
+      EXPECT_TRUE(
+          odePhysics->SetParam("quickstep_threads", quickStepThreadsSet));
+      EXPECT_NO_THROW(quickStepThreads =
+        boost::any_cast<int>(odePhysics->GetParam("quickstep_threads")));
+      EXPECT_EQ(quickStepThreads, quickStepThreadsSet);
+    }
+
+    EXPECT_TRUE(odePhysics->SetParam("colored_rows", false));
+  }
+
+  // Test vectorized_rows, deterministic_rows and row_kernels
+  {
+    // SIMD row kernels are off by default, and deterministic when enabled
+    bool vectorizedRows = true;
+    EXPECT_NO_THROW(vectorizedRows =
+      boost::any_cast<bool>(odePhysics->GetParam("vectorized_rows")));
+    EXPECT_FALSE(vectorizedRows);
+    bool deterministicRows = false;
+    EXPECT_NO_THROW(deterministicRows =
+      boost::any_cast<bool>(odePhysics->GetParam("deterministic_rows")));
+    EXPECT_TRUE(deterministicRows);
+    std::string rowKernels;
+    EXPECT_NO_THROW(rowKernels =
+      boost::any_cast<std::string>(odePhysics->GetParam("row_kernels")));
+    EXPECT_EQ(rowKernels, "none");
+
+    EXPECT_TRUE(odePhysics->SetParam("vectorized_rows", true));
+    EXPECT_NO_THROW(vectorizedRows =
+      boost::any_cast<bool>(odePhysics->GetParam("vectorized_rows")));
+    EXPECT_TRUE(vectorizedRows);
+    EXPECT_NO_THROW(rowKernels =
+      boost::any_cast<std::string>(odePhysics->GetParam("row_kernels")));
+    EXPECT_FALSE(rowKernels.empty());
+
+    // fused multiply-add kernels are only selected in non deterministic mode
+    EXPECT_EQ(rowKernels.find("fma"), std::string::npos);
+
+    EXPECT_TRUE(odePhysics->SetParam("deterministic_rows", false));
+    EXPECT_NO_THROW(deterministicRows =
+      boost::any_cast<bool>(odePhysics->GetParam("deterministic_rows")));
+    EXPECT_FALSE(deterministicRows);
+
+    EXPECT_TRUE(odePhysics->SetParam("deterministic_rows", true));
+    EXPECT_TRUE(odePhysics->SetParam("vectorized_rows", false));
+  }
+
   // Test ode_quiet
   // convenient for disabling LCP internal error messages from world solver
   {
@@ -490,6 +556,59 @@ TEST_F(ODEPhysics_TEST, PhysicsMsgParam)
   PhysicsMsgParam();
 }
 
+/////////////////////////////////////////////////
+/// Test that a contact surface callback drives a box resting on the ground
+TEST_F(ODEPhysics_TEST, ContactSurfaceFunc)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 0.5));
+  physics::ModelPtr model = world->ModelByName("box");
+  ASSERT_TRUE(model != nullptr);
+  physics::CollisionPtr collision = model->GetLink()->GetCollisions()[0];
+  ASSERT_TRUE(collision != nullptr);
+  EXPECT_FALSE(collision->HasContactSurfaceFunc());
+
+  // Settle on the ground
+  world->Step(100);
+
+  unsigned int calls = 0;
+  collision->SetContactSurfaceFunc(
+      [&](physics::ContactSurface &_surface)
+      {
+        ++calls;
+        EXPECT_TRUE(_surface.collision1 == collision.get() ||
+                    _surface.collision2 == collision.get());
+        EXPECT_NEAR(_surface.position.Z(), 0.0, 0.01);
+        EXPECT_GT(_surface.mu1, 0.0);
+        _surface.frictionDirection1.Set(1, 0, 0);
+        _surface.motion1 = 0.5;
+      });
+  EXPECT_TRUE(collision->HasContactSurfaceFunc());
+
+  const auto start = model->WorldPose().Pos();
+  world->Step(1000);
+  EXPECT_GT(calls, 0u);
+
+  // The moving surface drags the box along x only
+  const auto moved = model->WorldPose().Pos() - start;
+  EXPECT_GT(std::abs(moved.X()), 0.2);
+  EXPECT_NEAR(moved.Y(), 0.0, 0.01);
+
+  // Without the callback, the box stops
+  collision->SetContactSurfaceFunc(nullptr);
+  EXPECT_FALSE(collision->HasContactSurfaceFunc());
+  const unsigned int lastCalls = calls;
+  world->Step(100);
+  const auto stopped = model->WorldPose().Pos();
+  world->Step(100);
+  EXPECT_EQ(calls, lastCalls);
+  EXPECT_NEAR(model->WorldPose().Pos().X(), stopped.X(), 1e-3);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int argc, char **argv)
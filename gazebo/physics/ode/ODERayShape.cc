@@ -138,6 +138,10 @@ void ODERayShape::GetIntersection(double &_dist, std::string &_entity)
       dSpaceCollide2(this->geomId,
           (dGeomID)(this->physicsEngine->GetSpaceId()),
           &intersection, &UpdateCallback);
+
+      // Static collisions are kept out of the world space.
+      this->physicsEngine->CollideStatic(this->geomId, &intersection,
+          &UpdateCallback);
     }
 
     _dist = intersection.depth;
@@ -96,11 +96,11 @@ void SimbodyLink::Init()
   // Create the new rigid body
 
   // change link's gravity mode if requested by user
-  this->gravityModeConnection = event::Events::ConnectWorldUpdateBegin(
+  this->gravityModeConnection = this->world->ConnectWorldUpdateBegin(
     boost::bind(&SimbodyLink::ProcessSetGravityMode, this));
 
   // lock or unlock the link if requested by user
-  this->staticLinkConnection = event::Events::ConnectWorldUpdateEnd(
+  this->staticLinkConnection = this->world->ConnectWorldUpdateEnd(
     boost::bind(&SimbodyLink::ProcessSetLinkStatic, this));
 }
 
@@ -496,6 +496,8 @@ void SimbodyLink::SetAngularDamping(double /*_damping*/)
 /////////////////////////////////////////////////
 void SimbodyLink::AddForce(const ignition::math::Vector3d &_force)
 {
+  this->WakeUp();
+
   SimTK::Vec3 f(SimbodyPhysics::Vector3ToVec3(_force));
 
   this->simbodyPhysics->discreteForces.addForceToBodyPoint(
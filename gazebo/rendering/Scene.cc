@@ -15,10 +15,13 @@
  *
 */
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
+#include <google/protobuf/message.h>
 #include <ignition/math/Color.hh>
 #include <ignition/math/Helpers.hh>
 
@@ -95,6 +98,72 @@ struct VisualMessageLess {
     }
 } VisualMessageLessOp;
 
+/////////////////////////////////////////////////
+/// \brief Clear the repeated fields of a message that are set in a newer
+/// message, recursively, so that merging the newer message replaces them
+/// instead of appending to them.
+/// \param[in,out] _msg Message to clear.
+/// \param[in] _newer Newer message.
+static void ClearReplacedFields(google::protobuf::Message &_msg,
+    const google::protobuf::Message &_newer)
+{
+  const google::protobuf::Reflection *reflection = _msg.GetReflection();
+  std::vector<const google::protobuf::FieldDescriptor *> fields;
+  _newer.GetReflection()->ListFields(_newer, &fields);
+  for (auto const *field : fields)
+  {
+    if (field->is_repeated())
+    {
+      reflection->ClearField(&_msg, field);
+    }
+    else if (field->cpp_type() ==
+        google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+        reflection->HasField(_msg, field))
+    {
+      ClearReplacedFields(*reflection->MutableMessage(&_msg, field),
+          _newer.GetReflection()->GetMessage(_newer, field));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Queue a visual message. If the queue already holds a pending
+/// message of the same visual, the new message is merged into it, so that
+/// a burst of updates of a visual is processed once.
+/// Deletions and messages without id are never merged.
+/// \param[in,out] _queue Message queue.
+/// \param[in,out] _index Pending message of each visual in the queue.
+/// \param[in] _msg Message to queue.
+static void QueueVisualMsg(VisualMsgs_L &_queue, VisualMsgIndex_M &_index,
+    const boost::shared_ptr<msgs::Visual const> &_msg)
+{
+  if (!_msg->has_id())
+  {
+    _queue.push_back(_msg);
+    return;
+  }
+
+  if (_msg->has_delete_me() && _msg->delete_me())
+  {
+    _index.erase(_msg->id());
+    _queue.push_back(_msg);
+    return;
+  }
+
+  auto pending = _index.find(_msg->id());
+  if (pending == _index.end())
+  {
+    _index[_msg->id()] = _queue.insert(_queue.end(), _msg);
+    return;
+  }
+
+  boost::shared_ptr<msgs::Visual> merged(
+      new msgs::Visual(**pending->second));
+  ClearReplacedFields(*merged, *_msg);
+  merged->MergeFrom(*_msg);
+  *pending->second = merged;
+}
+
 //////////////////////////////////////////////////
 Scene::Scene()
   : dataPtr(new ScenePrivate)
@@ -235,7 +304,14 @@ void Scene::Clear()
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
     this->dataPtr->modelMsgs.clear();
+    this->dataPtr->modelVisualMsgs.clear();
+    this->dataPtr->modelVisualMsgIndex.clear();
+    this->dataPtr->linkVisualMsgs.clear();
+    this->dataPtr->linkVisualMsgIndex.clear();
     this->dataPtr->visualMsgs.clear();
+    this->dataPtr->visualMsgIndex.clear();
+    this->dataPtr->collisionVisualMsgs.clear();
+    this->dataPtr->collisionVisualMsgIndex.clear();
     this->dataPtr->lightFactoryMsgs.clear();
     this->dataPtr->lightModifyMsgs.clear();
     this->dataPtr->sceneMsgs.clear();
@@ -1544,21 +1620,25 @@ bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
       this->dataPtr->poseMsgs[_msg->model(i).id()].set_name(
           _msg->model(i).name());
       this->dataPtr->poseMsgs[_msg->model(i).id()].set_id(_msg->model(i).id());
-
-      this->ProcessModelMsg(_msg->model(i));
     }
   }
 
-  for (int i = 0; i < _msg->light_size(); ++i)
-  {
-    boost::shared_ptr<msgs::Light> lm(new msgs::Light(_msg->light(i)));
-    this->dataPtr->lightFactoryMsgs.push_back(lm);
-  }
+  for (int i = 0; i < _msg->model_size(); ++i)
+    this->ProcessModelMsg(_msg->model(i));
 
-  for (int i = 0; i < _msg->joint_size(); ++i)
   {
-    boost::shared_ptr<msgs::Joint> jm(new msgs::Joint(_msg->joint(i)));
-    this->dataPtr->jointMsgs.push_back(jm);
+    std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+    for (int i = 0; i < _msg->light_size(); ++i)
+    {
+      boost::shared_ptr<msgs::Light> lm(new msgs::Light(_msg->light(i)));
+      this->dataPtr->lightFactoryMsgs.push_back(lm);
+    }
+
+    for (int i = 0; i < _msg->joint_size(); ++i)
+    {
+      boost::shared_ptr<msgs::Joint> jm(new msgs::Joint(_msg->joint(i)));
+      this->dataPtr->jointMsgs.push_back(jm);
+    }
   }
 
   if (_msg->has_ambient())
@@ -1627,6 +1707,9 @@ bool Scene::ProcessSceneMsg(ConstScenePtr &_msg)
 //////////////////////////////////////////////////
 bool Scene::ProcessModelMsg(const msgs::Model &_msg)
 {
+  // The messages of the parts of the model are queued for the next frame
+  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+
   std::string modelName, linkName;
 
   modelName = _msg.name() + "::";
@@ -1634,7 +1717,8 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
   {
     boost::shared_ptr<msgs::Visual> vm(new msgs::Visual(
           _msg.visual(j)));
-    this->dataPtr->modelVisualMsgs.push_back(vm);
+    QueueVisualMsg(this->dataPtr->modelVisualMsgs,
+        this->dataPtr->modelVisualMsgIndex, vm);
   }
 
   // Set the scale of the model visual
@@ -1649,7 +1733,8 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
     vm->mutable_scale()->set_x(_msg.scale().x());
     vm->mutable_scale()->set_y(_msg.scale().y());
     vm->mutable_scale()->set_z(_msg.scale().z());
-    this->dataPtr->modelVisualMsgs.push_back(vm);
+    QueueVisualMsg(this->dataPtr->modelVisualMsgs,
+        this->dataPtr->modelVisualMsgIndex, vm);
   }
 
   for (int j = 0; j < _msg.joint_size(); ++j)
@@ -1698,14 +1783,16 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
       // note: the first visual in the link is the link visual
       msgs::VisualPtr vm(new msgs::Visual(
             _msg.link(j).visual(0)));
-      this->dataPtr->linkVisualMsgs.push_back(vm);
+      QueueVisualMsg(this->dataPtr->linkVisualMsgs,
+          this->dataPtr->linkVisualMsgIndex, vm);
     }
 
     for (int k = 1; k < _msg.link(j).visual_size(); ++k)
     {
       boost::shared_ptr<msgs::Visual> vm(new msgs::Visual(
             _msg.link(j).visual(k)));
-      this->dataPtr->visualMsgs.push_back(vm);
+      QueueVisualMsg(this->dataPtr->visualMsgs,
+          this->dataPtr->visualMsgIndex, vm);
     }
 
     for (int k = 0; k < _msg.link(j).collision_size(); ++k)
@@ -1715,7 +1802,8 @@ bool Scene::ProcessModelMsg(const msgs::Model &_msg)
       {
         boost::shared_ptr<msgs::Visual> vm(new msgs::Visual(
               _msg.link(j).collision(k).visual(l)));
-        this->dataPtr->collisionVisualMsgs.push_back(vm);
+        QueueVisualMsg(this->dataPtr->collisionVisualMsgs,
+            this->dataPtr->collisionVisualMsgIndex, vm);
       }
     }
 
@@ -1753,7 +1841,8 @@ void Scene::OnSensorMsg(ConstSensorPtr &_msg)
 void Scene::OnVisualMsg(ConstVisualPtr &_msg)
 {
   std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
-  this->dataPtr->visualMsgs.push_back(_msg);
+  QueueVisualMsg(this->dataPtr->visualMsgs, this->dataPtr->visualMsgIndex,
+      _msg);
 }
 
 //////////////////////////////////////////////////
@@ -1804,17 +1893,9 @@ void Scene::PreRender()
     first = false;
   */
 
-  static RequestMsgs_L::iterator rIter;
-  static SceneMsgs_L::iterator sIter;
-  static ModelMsgs_L::iterator modelIter;
-  static VisualMsgs_L::iterator visualIter;
-  static LightMsgs_L::iterator lightIter;
-  static PoseMsgs_M::iterator pIter;
-  static SkeletonPoseMsgs_L::iterator spIter;
-  static JointMsgs_L::iterator jointIter;
-  static SensorMsgs_L::iterator sensorIter;
-  static LinkMsgs_L::iterator linkIter;
-
+  // Swap the queues with empty ones, so the producers only wait for a few
+  // pointer swaps. Messages that cannot be processed yet are put back in
+  // front of the queues at the end.
   SceneMsgs_L sceneMsgsCopy;
   ModelMsgs_L modelMsgsCopy;
   SensorMsgs_L sensorMsgsCopy;
@@ -1827,69 +1908,50 @@ void Scene::PreRender()
   JointMsgs_L jointMsgsCopy;
   LinkMsgs_L linkMsgsCopy;
   RoadMsgs_L roadMsgsCopy;
+  RequestMsgs_L requestMsgsCopy;
+  common::Time budget;
 
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
 
-    std::copy(this->dataPtr->sceneMsgs.begin(), this->dataPtr->sceneMsgs.end(),
-              std::back_inserter(sceneMsgsCopy));
-    this->dataPtr->sceneMsgs.clear();
-
-    std::copy(this->dataPtr->modelMsgs.begin(), this->dataPtr->modelMsgs.end(),
-              std::back_inserter(modelMsgsCopy));
-    this->dataPtr->modelMsgs.clear();
-
-    std::copy(this->dataPtr->sensorMsgs.begin(),
-              this->dataPtr->sensorMsgs.end(),
-              std::back_inserter(sensorMsgsCopy));
-    this->dataPtr->sensorMsgs.clear();
-
-    std::copy(this->dataPtr->lightFactoryMsgs.begin(),
-              this->dataPtr->lightFactoryMsgs.end(),
-              std::back_inserter(lightFactoryMsgsCopy));
-    this->dataPtr->lightFactoryMsgs.clear();
-
-    std::copy(this->dataPtr->lightModifyMsgs.begin(),
-              this->dataPtr->lightModifyMsgs.end(),
-              std::back_inserter(lightModifyMsgsCopy));
-    this->dataPtr->lightModifyMsgs.clear();
-
-    std::copy(this->dataPtr->modelVisualMsgs.begin(),
-              this->dataPtr->modelVisualMsgs.end(),
-              std::back_inserter(modelVisualMsgsCopy));
-    this->dataPtr->modelVisualMsgs.clear();
-
-    std::copy(this->dataPtr->linkVisualMsgs.begin(),
-              this->dataPtr->linkVisualMsgs.end(),
-              std::back_inserter(linkVisualMsgsCopy));
-    this->dataPtr->linkVisualMsgs.clear();
-
-    this->dataPtr->visualMsgs.sort(VisualMessageLessOp);
-    std::copy(this->dataPtr->visualMsgs.begin(),
-              this->dataPtr->visualMsgs.end(),
-              std::back_inserter(visualMsgsCopy));
-    this->dataPtr->visualMsgs.clear();
-
-    std::copy(this->dataPtr->collisionVisualMsgs.begin(),
-              this->dataPtr->collisionVisualMsgs.end(),
-              std::back_inserter(collisionVisualMsgsCopy));
-    this->dataPtr->collisionVisualMsgs.clear();
-
-    std::copy(this->dataPtr->jointMsgs.begin(), this->dataPtr->jointMsgs.end(),
-              std::back_inserter(jointMsgsCopy));
-    this->dataPtr->jointMsgs.clear();
-
-    std::copy(this->dataPtr->linkMsgs.begin(), this->dataPtr->linkMsgs.end(),
-              std::back_inserter(linkMsgsCopy));
-    this->dataPtr->linkMsgs.clear();
-
-    std::copy(this->dataPtr->roadMsgs.begin(), this->dataPtr->roadMsgs.end(),
-              std::back_inserter(roadMsgsCopy));
-    this->dataPtr->roadMsgs.clear();
-  }
+    sceneMsgsCopy.swap(this->dataPtr->sceneMsgs);
+    modelMsgsCopy.swap(this->dataPtr->modelMsgs);
+    sensorMsgsCopy.swap(this->dataPtr->sensorMsgs);
+    lightFactoryMsgsCopy.swap(this->dataPtr->lightFactoryMsgs);
+    lightModifyMsgsCopy.swap(this->dataPtr->lightModifyMsgs);
+    modelVisualMsgsCopy.swap(this->dataPtr->modelVisualMsgs);
+    linkVisualMsgsCopy.swap(this->dataPtr->linkVisualMsgs);
+    visualMsgsCopy.swap(this->dataPtr->visualMsgs);
+    collisionVisualMsgsCopy.swap(this->dataPtr->collisionVisualMsgs);
+    jointMsgsCopy.swap(this->dataPtr->jointMsgs);
+    linkMsgsCopy.swap(this->dataPtr->linkMsgs);
+    roadMsgsCopy.swap(this->dataPtr->roadMsgs);
+    requestMsgsCopy.swap(this->dataPtr->requestMsgs);
+
+    // The swapped messages can't be merged with new ones anymore
+    this->dataPtr->modelVisualMsgIndex.clear();
+    this->dataPtr->linkVisualMsgIndex.clear();
+    this->dataPtr->visualMsgIndex.clear();
+    this->dataPtr->collisionVisualMsgIndex.clear();
+
+    budget = this->dataPtr->preRenderBudget;
+  }
+
+  visualMsgsCopy.sort(VisualMessageLessOp);
+
+  // Once the budget is spent, the remaining entity messages wait for the
+  // next frames.
+  const auto start = std::chrono::steady_clock::now();
+  const double budgetSec = budget.Double();
+  auto withinBudget = [&]()
+  {
+    return budgetSec <= 0 ||
+        std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count() < budgetSec;
+  };
 
   // Process the scene messages. DO THIS FIRST
-  for (sIter = sceneMsgsCopy.begin(); sIter != sceneMsgsCopy.end();)
+  for (auto sIter = sceneMsgsCopy.begin(); sIter != sceneMsgsCopy.end();)
   {
     if (this->ProcessSceneMsg(*sIter))
     {
@@ -1903,7 +1965,8 @@ void Scene::PreRender()
   }
 
   // Process the model messages.
-  for (modelIter = modelMsgsCopy.begin(); modelIter != modelMsgsCopy.end();)
+  for (auto modelIter = modelMsgsCopy.begin();
+      modelIter != modelMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessModelMsg(**modelIter))
       modelMsgsCopy.erase(modelIter++);
@@ -1912,7 +1975,8 @@ void Scene::PreRender()
   }
 
   // Process the sensor messages.
-  for (sensorIter = sensorMsgsCopy.begin(); sensorIter != sensorMsgsCopy.end();)
+  for (auto sensorIter = sensorMsgsCopy.begin();
+      sensorIter != sensorMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessSensorMsg(*sensorIter))
       sensorMsgsCopy.erase(sensorIter++);
@@ -1921,8 +1985,8 @@ void Scene::PreRender()
   }
 
   // Process the model visual messages.
-  for (visualIter = modelVisualMsgsCopy.begin();
-      visualIter != modelVisualMsgsCopy.end();)
+  for (auto visualIter = modelVisualMsgsCopy.begin();
+      visualIter != modelVisualMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_MODEL))
       modelVisualMsgsCopy.erase(visualIter++);
@@ -1931,8 +1995,8 @@ void Scene::PreRender()
   }
 
   // Process the link visual messages.
-  for (visualIter = linkVisualMsgsCopy.begin();
-      visualIter != linkVisualMsgsCopy.end();)
+  for (auto visualIter = linkVisualMsgsCopy.begin();
+      visualIter != linkVisualMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_LINK))
       linkVisualMsgsCopy.erase(visualIter++);
@@ -1941,7 +2005,8 @@ void Scene::PreRender()
   }
 
   // Process the visual messages.
-  for (visualIter = visualMsgsCopy.begin(); visualIter != visualMsgsCopy.end();)
+  for (auto visualIter = visualMsgsCopy.begin();
+      visualIter != visualMsgsCopy.end() && withinBudget();)
   {
     Visual::VisualType visualType = Visual::VT_VISUAL;
     if ((*visualIter)->has_type())
@@ -1954,8 +2019,8 @@ void Scene::PreRender()
   }
 
   // Process the collision visual messages.
-  for (visualIter = collisionVisualMsgsCopy.begin();
-      visualIter != collisionVisualMsgsCopy.end();)
+  for (auto visualIter = collisionVisualMsgsCopy.begin();
+      visualIter != collisionVisualMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessVisualMsg(*visualIter, Visual::VT_COLLISION))
       collisionVisualMsgsCopy.erase(visualIter++);
@@ -1964,7 +2029,8 @@ void Scene::PreRender()
   }
 
   // Process the joint messages.
-  for (jointIter = jointMsgsCopy.begin(); jointIter != jointMsgsCopy.end();)
+  for (auto jointIter = jointMsgsCopy.begin();
+      jointIter != jointMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessJointMsg(*jointIter))
       jointMsgsCopy.erase(jointIter++);
@@ -1973,7 +2039,8 @@ void Scene::PreRender()
   }
 
   // Process the link messages.
-  for (linkIter = linkMsgsCopy.begin(); linkIter != linkMsgsCopy.end();)
+  for (auto linkIter = linkMsgsCopy.begin();
+      linkIter != linkMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessLinkMsg(*linkIter))
       linkMsgsCopy.erase(linkIter++);
@@ -1983,8 +2050,8 @@ void Scene::PreRender()
 
   // Process the light factory messages.
   // do this after the link and visual msgs have been processed
-  for (lightIter = lightFactoryMsgsCopy.begin();
-      lightIter != lightFactoryMsgsCopy.end();)
+  for (auto lightIter = lightFactoryMsgsCopy.begin();
+      lightIter != lightFactoryMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessLightFactoryMsg(*lightIter))
       lightFactoryMsgsCopy.erase(lightIter++);
@@ -1993,8 +2060,8 @@ void Scene::PreRender()
   }
 
   // Process the light modify messages.
-  for (lightIter = lightModifyMsgsCopy.begin();
-      lightIter != lightModifyMsgsCopy.end();)
+  for (auto lightIter = lightModifyMsgsCopy.begin();
+      lightIter != lightModifyMsgsCopy.end() && withinBudget();)
   {
     if (this->ProcessLightModifyMsg(*lightIter))
       lightModifyMsgsCopy.erase(lightIter++);
@@ -2003,159 +2070,169 @@ void Scene::PreRender()
   }
 
   // Process the request messages
-  for (rIter =  this->dataPtr->requestMsgs.begin();
-      rIter != this->dataPtr->requestMsgs.end(); ++rIter)
-  {
-    this->ProcessRequestMsg(*rIter);
-  }
-  this->dataPtr->requestMsgs.clear();
+  for (auto const &request : requestMsgsCopy)
+    this->ProcessRequestMsg(request);
 
   {
     std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
 
-    std::copy(sceneMsgsCopy.begin(), sceneMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sceneMsgs));
-
-    std::copy(modelMsgsCopy.begin(), modelMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelMsgs));
-
-    std::copy(sensorMsgsCopy.begin(), sensorMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->sensorMsgs));
-
-    std::copy(lightFactoryMsgsCopy.begin(), lightFactoryMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightFactoryMsgs));
-
-    std::copy(lightModifyMsgsCopy.begin(), lightModifyMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->lightModifyMsgs));
-
-    std::copy(modelVisualMsgsCopy.begin(), modelVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->modelVisualMsgs));
-
-    std::copy(linkVisualMsgsCopy.begin(), linkVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkVisualMsgs));
-
-    std::copy(visualMsgsCopy.begin(), visualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->visualMsgs));
-
-    std::copy(collisionVisualMsgsCopy.begin(), collisionVisualMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->collisionVisualMsgs));
-
-    std::copy(jointMsgsCopy.begin(), jointMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->jointMsgs));
-
-    std::copy(linkMsgsCopy.begin(), linkMsgsCopy.end(),
-        std::front_inserter(this->dataPtr->linkMsgs));
+    // Put the leftovers back in front of the messages received meanwhile
+    this->dataPtr->sceneMsgs.splice(this->dataPtr->sceneMsgs.begin(),
+        sceneMsgsCopy);
+    this->dataPtr->modelMsgs.splice(this->dataPtr->modelMsgs.begin(),
+        modelMsgsCopy);
+    this->dataPtr->sensorMsgs.splice(this->dataPtr->sensorMsgs.begin(),
+        sensorMsgsCopy);
+    this->dataPtr->lightFactoryMsgs.splice(
+        this->dataPtr->lightFactoryMsgs.begin(), lightFactoryMsgsCopy);
+    this->dataPtr->lightModifyMsgs.splice(
+        this->dataPtr->lightModifyMsgs.begin(), lightModifyMsgsCopy);
+    this->dataPtr->modelVisualMsgs.splice(
+        this->dataPtr->modelVisualMsgs.begin(), modelVisualMsgsCopy);
+    this->dataPtr->linkVisualMsgs.splice(
+        this->dataPtr->linkVisualMsgs.begin(), linkVisualMsgsCopy);
+    this->dataPtr->visualMsgs.splice(this->dataPtr->visualMsgs.begin(),
+        visualMsgsCopy);
+    this->dataPtr->collisionVisualMsgs.splice(
+        this->dataPtr->collisionVisualMsgs.begin(), collisionVisualMsgsCopy);
+    this->dataPtr->jointMsgs.splice(this->dataPtr->jointMsgs.begin(),
+        jointMsgsCopy);
+    this->dataPtr->linkMsgs.splice(this->dataPtr->linkMsgs.begin(),
+        linkMsgsCopy);
   }
 
   // update the rt shader
   RTShaderSystem::Instance()->Update();
 
+  // Take the latest poses. Only the latest pose of each visual is kept in
+  // the map, so a burst of pose messages is applied once.
+  PoseMsgs_M poseMsgsCopy;
+  SkeletonPoseMsgs_L skeletonPoseMsgsCopy;
+  common::Time posesReceived;
   {
     std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
+    poseMsgsCopy.swap(this->dataPtr->poseMsgs);
+    skeletonPoseMsgsCopy.swap(this->dataPtr->skeletonPoseMsgs);
+    posesReceived = this->dataPtr->sceneSimTimePosesReceived;
+  }
 
-    // Process all the model messages last. Remove pose message from the list
-    // only when a corresponding visual exits. We may receive pose updates
-    // over the wire before  we recieve the visual
-    pIter = this->dataPtr->poseMsgs.begin();
-    while (pIter != this->dataPtr->poseMsgs.end())
+  // Process all the model messages last. Remove pose message from the list
+  // only when a corresponding visual exits. We may receive pose updates
+  // over the wire before  we recieve the visual
+  for (auto pIter = poseMsgsCopy.begin(); pIter != poseMsgsCopy.end();)
+  {
+    Visual_M::iterator iter = this->dataPtr->visuals.find(pIter->first);
+    if (iter != this->dataPtr->visuals.end() && iter->second)
     {
-      Visual_M::iterator iter = this->dataPtr->visuals.find(pIter->first);
-      if (iter != this->dataPtr->visuals.end() && iter->second)
+      // If an object is selected, don't let the physics engine move it.
+      if (!this->dataPtr->selectedVis
+          || this->dataPtr->selectionMode != "move" ||
+          (iter->first != this->dataPtr->selectedVis->GetId() &&
+          !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
       {
-        // If an object is selected, don't let the physics engine move it.
-        if (!this->dataPtr->selectedVis
-            || this->dataPtr->selectionMode != "move" ||
-            (iter->first != this->dataPtr->selectedVis->GetId() &&
-            !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
-        {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          GZ_ASSERT(iter->second, "Visual pointer is NULL");
-          iter->second->SetPose(pose);
-          PoseMsgs_M::iterator prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
-        }
-        else
-          ++pIter;
+        ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
+        GZ_ASSERT(iter->second, "Visual pointer is NULL");
+        iter->second->SetPose(pose);
+        pIter = poseMsgsCopy.erase(pIter);
       }
       else
+        ++pIter;
+    }
+    else
+    {
+      // process light pose messages
+      auto lIter = this->dataPtr->lights.find(pIter->first);
+      if (lIter != this->dataPtr->lights.end())
       {
-        // process light pose messages
-        auto lIter = this->dataPtr->lights.find(pIter->first);
-        if (lIter != this->dataPtr->lights.end())
-        {
-          ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
-          lIter->second->SetPosition(pose.Pos());
-          lIter->second->SetRotation(pose.Rot());
-          auto prev = pIter++;
-          this->dataPtr->poseMsgs.erase(prev);
-        }
-        else
-          ++pIter;
+        ignition::math::Pose3d pose = msgs::ConvertIgn(pIter->second);
+        lIter->second->SetPosition(pose.Pos());
+        lIter->second->SetRotation(pose.Rot());
+        pIter = poseMsgsCopy.erase(pIter);
       }
+      else
+        ++pIter;
     }
+  }
 
-    // process skeleton pose msgs
-    spIter = this->dataPtr->skeletonPoseMsgs.begin();
-    while (spIter != this->dataPtr->skeletonPoseMsgs.end())
+  // process skeleton pose msgs
+  for (auto spIter = skeletonPoseMsgsCopy.begin();
+      spIter != skeletonPoseMsgsCopy.end();)
+  {
+    Visual_M::iterator iter =
+        this->dataPtr->visuals.find((*spIter)->model_id());
+    for (int i = 0; i < (*spIter)->pose_size(); ++i)
     {
-      Visual_M::iterator iter =
-          this->dataPtr->visuals.find((*spIter)->model_id());
-      for (int i = 0; i < (*spIter)->pose_size(); ++i)
+      const msgs::Pose& pose_msg = (*spIter)->pose(i);
+      if (pose_msg.has_id())
       {
-        const msgs::Pose& pose_msg = (*spIter)->pose(i);
-        if (pose_msg.has_id())
+        Visual_M::iterator iter2 = this->dataPtr->visuals.find(pose_msg.id());
+        if (iter2 != this->dataPtr->visuals.end())
         {
-          Visual_M::iterator iter2 = this->dataPtr->visuals.find(pose_msg.id());
-          if (iter2 != this->dataPtr->visuals.end())
+          // If an object is selected, don't let the physics engine move it.
+          if (!this->dataPtr->selectedVis ||
+              this->dataPtr->selectionMode != "move" ||
+              (iter->first != this->dataPtr->selectedVis->GetId()&&
+              !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
           {
-            // If an object is selected, don't let the physics engine move it.
-            if (!this->dataPtr->selectedVis ||
-                this->dataPtr->selectionMode != "move" ||
-                (iter->first != this->dataPtr->selectedVis->GetId()&&
-                !this->dataPtr->selectedVis->IsAncestorOf(iter->second)))
-            {
-              ignition::math::Pose3d pose = msgs::ConvertIgn(pose_msg);
-              iter2->second->SetPose(pose);
-            }
+            ignition::math::Pose3d pose = msgs::ConvertIgn(pose_msg);
+            iter2->second->SetPose(pose);
           }
         }
       }
+    }
 
-      if (iter != this->dataPtr->visuals.end())
-      {
-        iter->second->SetSkeletonPose(*(*spIter).get());
-        SkeletonPoseMsgs_L::iterator prev = spIter++;
-        this->dataPtr->skeletonPoseMsgs.erase(prev);
-      }
-      else
-        ++spIter;
+    if (iter != this->dataPtr->visuals.end())
+    {
+      iter->second->SetSkeletonPose(*(*spIter).get());
+      skeletonPoseMsgsCopy.erase(spIter++);
     }
+    else
+      ++spIter;
+  }
 
-    // Process the road messages.
-    for (const auto &msg : roadMsgsCopy)
+  // Process the road messages.
+  for (const auto &msg : roadMsgsCopy)
+  {
+    // do not add road if it already exists
+    bool addRoad = true;
+    for (const auto &it : this->dataPtr->visuals)
     {
-      // do not add road if it already exists
-      bool addRoad = true;
-      for (const auto &it : this->dataPtr->visuals)
+      Road2dPtr road = std::dynamic_pointer_cast<Road2d>(it.second);
+      if (road && road->Name() == msg->name())
       {
-        Road2dPtr road = std::dynamic_pointer_cast<Road2d>(it.second);
-        if (road && road->Name() == msg->name())
-        {
-          addRoad = false;
-          break;
-        }
-      }
-      if (addRoad)
-      {
-        Road2dPtr road(new Road2d(msg->name(), this->dataPtr->worldVisual));
-        road->Load(*msg);
-        this->dataPtr->visuals[road->GetId()] = road;
+        addRoad = false;
+        break;
       }
     }
+    if (addRoad)
+    {
+      Road2dPtr road(new Road2d(msg->name(), this->dataPtr->worldVisual));
+      road->Load(*msg);
+      this->dataPtr->visuals[road->GetId()] = road;
+    }
+  }
+
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->dataPtr->poseMsgMutex);
+
+    // Keep the poses that were not applied, unless a newer one arrived
+    for (auto &pose : poseMsgsCopy)
+      this->dataPtr->poseMsgs.insert(std::move(pose));
+
+    for (auto const &skeletonMsg : skeletonPoseMsgsCopy)
+    {
+      const bool newer = std::any_of(this->dataPtr->skeletonPoseMsgs.begin(),
+          this->dataPtr->skeletonPoseMsgs.end(),
+          [&](const boost::shared_ptr<msgs::PoseAnimation const> &_msg)
+          {
+            return _msg->model_name() == skeletonMsg->model_name();
+          });
+      if (!newer)
+        this->dataPtr->skeletonPoseMsgs.push_front(skeletonMsg);
+    }
 
     // official time stamp of approval
-    this->dataPtr->sceneSimTimePosesApplied =
-        this->dataPtr->sceneSimTimePosesReceived;
+    this->dataPtr->sceneSimTimePosesApplied = posesReceived;
   }
 }
 
@@ -2853,6 +2930,30 @@ bool Scene::ProcessVisualMsg(ConstVisualPtr &_msg, Visual::VisualType _type)
   return true;
 }
 
+/////////////////////////////////////////////////
+void Scene::SetPreRenderBudget(const common::Time &_budget)
+{
+  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+  this->dataPtr->preRenderBudget = _budget;
+}
+
+/////////////////////////////////////////////////
+common::Time Scene::PreRenderBudget() const
+{
+  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+  return this->dataPtr->preRenderBudget;
+}
+
+/////////////////////////////////////////////////
+size_t Scene::PendingVisualMsgCount() const
+{
+  std::lock_guard<std::mutex> lock(*this->dataPtr->receiveMutex);
+  return this->dataPtr->modelVisualMsgs.size() +
+      this->dataPtr->linkVisualMsgs.size() +
+      this->dataPtr->visualMsgs.size() +
+      this->dataPtr->collisionVisualMsgs.size();
+}
+
 /////////////////////////////////////////////////
 common::Time Scene::SimTime() const
 {
@@ -558,6 +558,26 @@ namespace gazebo
       /// \return The current simulation time in Scene
       public: common::Time SimTime() const;
 
+      /// \brief Set the time each PreRender call may spend creating and
+      /// updating entities from the queued model, link, joint, sensor,
+      /// visual and light messages. The messages left over are processed
+      /// in the following frames. Scene messages, requests and poses are
+      /// always processed.
+      /// \param[in] _budget Time budget, zero for no limit.
+      public: void SetPreRenderBudget(const common::Time &_budget);
+
+      /// \brief Get the time each PreRender call may spend processing
+      /// queued entity messages.
+      /// \return Time budget, zero for no limit.
+      /// \sa SetPreRenderBudget
+      public: common::Time PreRenderBudget() const;
+
+      /// \brief Get the number of queued visual messages waiting to be
+      /// processed by PreRender. Messages of the same visual are merged
+      /// while they wait, and count as one.
+      /// \return Number of queued visual messages.
+      public: size_t PendingVisualMsgCount() const;
+
       /// \brief Update Poses of objects in the scene via direct API call
       /// instead of transport.
       /// \param[in] _msg The message data.
@@ -20,6 +20,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
@@ -68,9 +69,14 @@ namespace gazebo
     /// \brief List of light messages.
     typedef std::list<boost::shared_ptr<msgs::Light const> > LightMsgs_L;
 
+    /// \def VisualMsgIndex_M
+    /// \brief Pending visual message of each visual id in a queue.
+    typedef std::unordered_map<uint32_t, VisualMsgs_L::iterator>
+        VisualMsgIndex_M;
+
     /// \typedef PoseMsgs_M.
-    /// \brief List of messages.
-    typedef std::map<uint32_t, msgs::Pose> PoseMsgs_M;
+    /// \brief Latest pose message of each visual id.
+    typedef std::unordered_map<uint32_t, msgs::Pose> PoseMsgs_M;
 
     /// \typedef LightPoseMsgs_M.
     /// \brief List of messages.
@@ -175,6 +181,19 @@ namespace gazebo
       /// \brief List of collision visual messages to process.
       public: VisualMsgs_L collisionVisualMsgs;
 
+      /// \brief Pending messages in modelVisualMsgs, used to coalesce the
+      /// messages of the same visual.
+      public: VisualMsgIndex_M modelVisualMsgIndex;
+
+      /// \brief Pending messages in linkVisualMsgs.
+      public: VisualMsgIndex_M linkVisualMsgIndex;
+
+      /// \brief Pending messages in visualMsgs.
+      public: VisualMsgIndex_M visualMsgIndex;
+
+      /// \brief Pending messages in collisionVisualMsgs.
+      public: VisualMsgIndex_M collisionVisualMsgIndex;
+
       /// \brief List of light factory message to process.
       public: LightMsgs_L lightFactoryMsgs;
 
@@ -232,6 +251,10 @@ namespace gazebo
       /// \brief Mutex to lock the pose message buffers.
       public: std::recursive_mutex poseMsgMutex;
 
+      /// \brief Time PreRender may spend processing queued entity
+      /// messages, zero for no limit.
+      public: common::Time preRenderBudget;
+
       /// \brief Communication Node
       public: transport::NodePtr node;
 
@@ -402,6 +402,99 @@ TEST_F(Scene_TEST, AddRemoveLights)
   EXPECT_FALSE(scene->LightByName("light1"));
 }
 
+/////////////////////////////////////////////////
+TEST_F(Scene_TEST, QueuedVisualMsgs)
+{
+  Load("worlds/empty.world");
+
+  // Get the scene
+  gazebo::rendering::ScenePtr scene = gazebo::rendering::get_scene();
+  ASSERT_TRUE(scene != nullptr);
+
+  // No budget by default
+  EXPECT_EQ(scene->PreRenderBudget(), common::Time::Zero);
+  scene->SetPreRenderBudget(common::Time(0, 5000000));
+  EXPECT_EQ(scene->PreRenderBudget(), common::Time(0, 5000000));
+  scene->SetPreRenderBudget(common::Time::Zero);
+
+  transport::NodePtr node = transport::NodePtr(new transport::Node());
+  node->Init();
+  transport::PublisherPtr visPub = node->Advertise<msgs::Visual>("~/visual");
+  visPub->WaitForConnection();
+
+  // Process the visuals of the world first
+  int sleep = 0;
+  int maxSleep = 50;
+  while (scene->PendingVisualMsgCount() > 0 && sleep < maxSleep)
+  {
+    common::Time::MSleep(100);
+    event::Events::preRender();
+    sleep++;
+  }
+  ASSERT_EQ(scene->PendingVisualMsgCount(), 0u);
+
+  // A new visual followed by a burst of updates
+  msgs::Visual msg;
+  msg.set_name("queued_visual");
+  msg.set_id(123456u);
+  msg.set_parent_name(scene->Name());
+  msg.set_transparency(0.1);
+  msgs::Set(msg.mutable_pose(), ignition::math::Pose3d(1, 2, 3, 0, 0, 0));
+  visPub->Publish(msg);
+
+  for (int i = 1; i <= 10; ++i)
+  {
+    msgs::Visual update;
+    update.set_name("queued_visual");
+    update.set_id(123456u);
+    update.set_transparency(0.05 * i);
+    visPub->Publish(update);
+  }
+
+  // A second visual, received after all the updates of the first one
+  msgs::Visual other;
+  other.set_name("other_visual");
+  other.set_id(123457u);
+  other.set_parent_name(scene->Name());
+  visPub->Publish(other);
+
+  // The updates wait merged into the message that creates the visual
+  sleep = 0;
+  while (scene->PendingVisualMsgCount() < 2u && sleep < maxSleep)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_EQ(scene->PendingVisualMsgCount(), 2u);
+
+  // The merged message keeps the fields set only by the first message,
+  // and the latest update wins
+  event::Events::preRender();
+  EXPECT_EQ(scene->PendingVisualMsgCount(), 0u);
+  rendering::VisualPtr vis = scene->GetVisual("queued_visual");
+  ASSERT_TRUE(vis != nullptr);
+  EXPECT_FLOAT_EQ(vis->GetTransparency(), 0.5f);
+  EXPECT_EQ(vis->GetId(), 123456u);
+  EXPECT_EQ(vis->WorldPose().Pos(), ignition::math::Vector3d(1, 2, 3));
+  EXPECT_TRUE(scene->GetVisual("other_visual") != nullptr);
+
+  // Deleting it
+  msgs::Visual deleteMsg;
+  deleteMsg.set_name("queued_visual");
+  deleteMsg.set_id(123456u);
+  deleteMsg.set_delete_me(true);
+  visPub->Publish(deleteMsg);
+
+  sleep = 0;
+  while (vis && sleep < maxSleep)
+  {
+    common::Time::MSleep(100);
+    event::Events::preRender();
+    vis = scene->GetVisual("queued_visual");
+    sleep++;
+  }
+  EXPECT_TRUE(vis == nullptr);
+}
 
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
@@ -231,47 +231,50 @@ bool CameraSensor::UpdateImpl(const bool /*_force*/)
   this->camera->PostRender();
 
 
-  if ((this->imagePub && this->imagePub->HasConnections()) ||
-      this->imagePubIgn.HasConnections())
+  const bool publish = this->imagePub && this->imagePub->HasConnections();
+  const bool publishIgn = this->imagePubIgn.HasConnections();
+  if (publish || publishIgn)
   {
     auto simTime = this->scene->SimTime();
-    if (this->imagePub && this->imagePub->HasConnections())
+    const unsigned int width = this->camera->ImageWidth();
+    const unsigned int height = this->camera->ImageHeight();
+    const unsigned int step = width * this->camera->ImageDepth();
+
+    // Copy the frame out of the render target once. Both transports
+    // publish from this buffer.
+    boost::shared_ptr<msgs::ImageStamped> msg =
+      this->dataPtr->imagePool.Acquire();
+    msgs::Set(msg->mutable_time(), simTime);
+    msg->mutable_image()->set_width(width);
+    msg->mutable_image()->set_height(height);
+    msg->mutable_image()->set_pixel_format(common::Image::ConvertPixelFormat(
+          this->camera->ImageFormat()));
+    msg->mutable_image()->set_step(step);
+    msg->mutable_image()->mutable_data()->assign(
+        reinterpret_cast<const char *>(this->camera->ImageData()),
+        step * height);
+
+    if (publishIgn)
     {
-      msgs::ImageStamped msg;
-      msgs::Set(msg.mutable_time(), simTime);
-      msg.mutable_image()->set_width(this->camera->ImageWidth());
-      msg.mutable_image()->set_height(this->camera->ImageHeight());
-      msg.mutable_image()->set_pixel_format(common::Image::ConvertPixelFormat(
-            this->camera->ImageFormat()));
-
-      msg.mutable_image()->set_step(this->camera->ImageWidth() *
-          this->camera->ImageDepth());
-      msg.mutable_image()->set_data(this->camera->ImageData(),
-          msg.image().width() * this->camera->ImageDepth() *
-          msg.image().height());
-
-      this->imagePub->Publish(msg);
-    }
+      ignition::msgs::Image &msgIgn = this->dataPtr->imageMsgIgn;
+      msgIgn.mutable_header()->mutable_stamp()->set_sec(simTime.sec);
+      msgIgn.mutable_header()->mutable_stamp()->set_nsec(simTime.nsec);
 
-    if (this->imagePubIgn.HasConnections())
-    {
-      ignition::msgs::Image msg;
-      msg.mutable_header()->mutable_stamp()->set_sec(simTime.sec);
-      msg.mutable_header()->mutable_stamp()->set_nsec(simTime.nsec);
-
-      msg.set_width(this->camera->ImageWidth());
-      msg.set_height(this->camera->ImageHeight());
-      msg.set_pixel_format_type(ignition::msgs::ConvertPixelFormatType(
+      msgIgn.set_width(width);
+      msgIgn.set_height(height);
+      msgIgn.set_pixel_format_type(ignition::msgs::ConvertPixelFormatType(
             this->camera->ImageFormat()));
+      msgIgn.set_step(step);
 
-      msg.set_step(this->camera->ImageWidth() *
-          this->camera->ImageDepth());
-      msg.set_data(this->camera->ImageData(),
-          msg.width() * this->camera->ImageDepth() *
-          msg.height());
-
-      this->imagePubIgn.Publish(msg);
+      // Lend the frame to the ignition message for the duration of the
+      // publication, which serializes or delivers it before returning.
+      msgIgn.mutable_data()->swap(*msg->mutable_image()->mutable_data());
+      this->imagePubIgn.Publish(msgIgn);
+      msgIgn.mutable_data()->swap(*msg->mutable_image()->mutable_data());
     }
+
+    if (publish)
+      this->imagePub->PublishShared(msg);
   }
 
   this->dataPtr->rendered = false;
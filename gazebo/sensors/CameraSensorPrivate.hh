@@ -17,6 +17,11 @@
 #ifndef GAZEBO_SENSORS_CAMERASENSOR_PRIVATE_HH_
 #define GAZEBO_SENSORS_CAMERASENSOR_PRIVATE_HH_
 
+#include <ignition/msgs/image.pb.h>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/MessagePool.hh"
+
 namespace gazebo
 {
   namespace sensors
@@ -27,6 +32,15 @@ namespace gazebo
     {
       /// \brief True if the sensor was rendered.
       public: bool rendered = false;
+
+      /// \brief Pool of image messages. Each frame is copied once from
+      /// the render target into a pooled message, which is then shared
+      /// with the transport and local subscribers.
+      public: transport::MessagePool<msgs::ImageStamped> imagePool;
+
+      /// \brief Image message published on the ignition topic. Its data
+      /// is swapped in from the pooled message while it is published.
+      public: ignition::msgs::Image imageMsgIgn;
     };
   }
 }
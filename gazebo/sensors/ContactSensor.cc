@@ -15,6 +15,7 @@
  *
 */
 #include <boost/algorithm/string.hpp>
+#include <functional>
 #include <sstream>
 
 #include "gazebo/common/Exception.hh"
@@ -112,13 +113,13 @@ void ContactSensor::Load(const std::string &_worldName)
     // request the contact manager to publish messages to a custom topic for
     // this sensor
     physics::ContactManager *mgr = this->world->Physics()->GetContactManager();
-    std::string topic = mgr->CreateFilter(this->dataPtr->filterName,
-        this->dataPtr->collisions);
-    if (!this->dataPtr->contactSub)
-    {
-      this->dataPtr->contactSub = this->node->Subscribe(topic,
-          &ContactSensor::OnContacts, this);
-    }
+    mgr->CreateFilter(this->dataPtr->filterName, this->dataPtr->collisions);
+
+    // Receive the filtered contacts in-process instead of through the
+    // filter topic
+    mgr->SetFilterFeed(this->dataPtr->filterName,
+        std::bind(&ContactSensor::OnContacts, this,
+                  std::placeholders::_1, std::placeholders::_2));
   }
 }
 
@@ -137,66 +138,21 @@ bool ContactSensor::UpdateImpl(const bool /*_force*/)
   if (this->dataPtr->incomingContacts.empty())
     return false;
 
-  std::vector<std::string>::iterator collIter;
-  std::string collision1;
-
-  // Clear the outgoing contact message.
-  this->dataPtr->contactsMsg.clear_contact();
-
-  // Iterate over all the contact messages
-  for (auto iter = this->dataPtr->incomingContacts.begin();
-       iter != this->dataPtr->incomingContacts.end(); ++iter)
-  {
-    // Iterate over all the contacts in the message
-    for (int i = 0; i < (*iter)->contact_size(); ++i)
-    {
-      collision1 = (*iter)->contact(i).collision1();
-
-      // Try to find the first collision's name
-      collIter = std::find(this->dataPtr->collisions.begin(),
-          this->dataPtr->collisions.end(), collision1);
-
-      // If unable to find the first collision's name, try the second
-      if (collIter == this->dataPtr->collisions.end())
-      {
-        collision1 = (*iter)->contact(i).collision2();
-        collIter = std::find(this->dataPtr->collisions.begin(),
-            this->dataPtr->collisions.end(), collision1);
-      }
-
-      // If this sensor is monitoring one of the collision's in the
-      // contact, then add the contact to our outgoing message.
-      if (collIter != this->dataPtr->collisions.end())
-      {
-        int count = (*iter)->contact(i).position_size();
-
-        // Check to see if the contact arrays all have the same size.
-        if (count != (*iter)->contact(i).normal_size() ||
-            count != (*iter)->contact(i).wrench_size() ||
-            count != (*iter)->contact(i).depth_size())
-        {
-          gzerr << "Contact message has invalid array sizes\n";
-          continue;
-        }
-
-        // Copy the contact message.
-        msgs::Contact *contactMsg = this->dataPtr->contactsMsg.add_contact();
-        contactMsg->CopyFrom((*iter)->contact(i));
-      }
-    }
-  }
+  // The contact manager already filtered the contacts of this sensor.
+  this->dataPtr->contacts.assign(this->dataPtr->incomingContacts.begin(),
+      this->dataPtr->incomingContacts.end());
+  this->dataPtr->contactsMsgDirty = true;
 
   // Clear the incoming contact list.
   this->dataPtr->incomingContacts.clear();
 
   this->lastMeasurementTime = this->world->SimTime();
-  msgs::Set(this->dataPtr->contactsMsg.mutable_time(),
-            this->lastMeasurementTime);
 
   // Generate a outgoing message only if someone is listening.
   if (this->dataPtr->contactsPub &&
       this->dataPtr->contactsPub->HasConnections())
   {
+    this->UpdateContactsMsg();
     this->dataPtr->contactsPub->Publish(this->dataPtr->contactsMsg);
   }
 
@@ -212,8 +168,18 @@ void ContactSensor::Fini()
         this->world->Physics()->GetContactManager();
     mgr->RemoveFilter(this->dataPtr->filterName);
   }
+  else if (this->world && this->world->Physics())
+  {
+    // Make sure the contact manager doesn't call back into this sensor
+    this->world->Physics()->GetContactManager()->SetFilterFeed(
+        this->dataPtr->filterName, nullptr);
+  }
 
-  this->dataPtr->contactSub.reset();
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->incomingContacts.clear();
+    this->dataPtr->contacts.clear();
+  }
   this->dataPtr->contactsPub.reset();
   Sensor::Fini();
 }
@@ -242,12 +208,17 @@ unsigned int ContactSensor::GetCollisionContactCount(
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   unsigned int result = 0;
 
-  for (int i = 0; i < this->dataPtr->contactsMsg.contact_size(); ++i)
+  for (auto const &frame : this->dataPtr->contacts)
   {
-    if (this->dataPtr->contactsMsg.contact(i).collision1() == _collisionName ||
-        this->dataPtr->contactsMsg.contact(i).collision2() == _collisionName)
+    for (auto const &index : frame.second)
     {
-      result += this->dataPtr->contactsMsg.contact(i).position_size();
+      const physics::ContactBuffer::Record &record =
+        frame.first->records[index];
+      if (frame.first->CollisionName(record.collisionId1) == _collisionName ||
+          frame.first->CollisionName(record.collisionId2) == _collisionName)
+      {
+        result += record.count;
+      }
     }
   }
 
@@ -258,6 +229,7 @@ unsigned int ContactSensor::GetCollisionContactCount(
 msgs::Contacts ContactSensor::Contacts() const
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->UpdateContactsMsg();
   return this->dataPtr->contactsMsg;
 }
 
@@ -269,6 +241,8 @@ std::map<std::string, gazebo::physics::Contact> ContactSensor::Contacts(
 
   std::map<std::string, gazebo::physics::Contact> result;
 
+  this->UpdateContactsMsg();
+
   std::string collision2;
 
   for (int i = 0; i < this->dataPtr->contactsMsg.contact_size(); ++i)
@@ -295,22 +269,42 @@ std::map<std::string, gazebo::physics::Contact> ContactSensor::Contacts(
 }
 
 //////////////////////////////////////////////////
-void ContactSensor::OnContacts(ConstContactsPtr &_msg)
+void ContactSensor::OnContacts(const physics::ConstContactBufferPtr &_buffer,
+    const std::vector<unsigned int> &_records)
 {
   std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
 
   // Only store information if the sensor is active
   if (this->IsActive())
   {
-    // Store the contacts message for processing in UpdateImpl
-    this->dataPtr->incomingContacts.push_back(_msg);
+    // Store the contacts for processing in UpdateImpl
+    this->dataPtr->incomingContacts.emplace_back(_buffer, _records);
 
     // Prevent the incomingContacts list to grow indefinitely.
-    if (this->dataPtr->incomingContacts.size() > 100)
+    if (this->dataPtr->incomingContacts.size() >
+        physics::ContactBuffer::MaxRetained)
       this->dataPtr->incomingContacts.pop_front();
   }
 }
 
+//////////////////////////////////////////////////
+void ContactSensor::UpdateContactsMsg() const
+{
+  if (!this->dataPtr->contactsMsgDirty)
+    return;
+
+  this->dataPtr->contactsMsg.clear_contact();
+  for (auto const &frame : this->dataPtr->contacts)
+  {
+    for (auto const &index : frame.second)
+      frame.first->FillMsg(index, *this->dataPtr->contactsMsg.add_contact());
+  }
+
+  msgs::Set(this->dataPtr->contactsMsg.mutable_time(),
+            this->lastMeasurementTime);
+  this->dataPtr->contactsMsgDirty = false;
+}
+
 //////////////////////////////////////////////////
 bool ContactSensor::IsActive() const
 {
@@ -20,11 +20,13 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "gazebo/msgs/msgs.hh"
 
 #include "gazebo/sensors/Sensor.hh"
 #include "gazebo/physics/Contact.hh"
+#include "gazebo/physics/ContactManager.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -94,10 +96,11 @@ namespace gazebo
       /// to publish all contacts generated within a timestep onto
       /// Gazebo topic ~/physics/contacts.
       ///
-      /// Each ContactSensor subscribes to the Gazebo ~/physics/contacts topic,
-      /// retrieves all contact pairs in a time step and filters them wthin
-      /// ContactSensor::OnContacts against <collision> body name
-      /// specified by the ContactSensor SDF.
+      /// Each ContactSensor registers a contact filter with the
+      /// ContactManager for the <collision> bodies specified by the
+      /// ContactSensor SDF. After each time step the ContactManager hands
+      /// the filtered contacts directly to the sensor, and the message
+      /// below is only built when it is requested or published.
       /// All collision pairs between ContactSensor <collision> body and
       /// other bodies in the world are stored in an array inside
       /// contacts.proto.
@@ -133,8 +136,16 @@ namespace gazebo
       // Documentation inherited.
       public: virtual bool IsActive() const;
 
-      /// \brief Callback for contact messages from the physics engine.
-      private: void OnContacts(ConstContactsPtr &_msg);
+      /// \brief Callback for the contacts of a step, called by the
+      /// contact manager from the physics thread.
+      /// \param[in] _buffer Contacts of the step.
+      /// \param[in] _records Indices of the contacts of this sensor.
+      private: void OnContacts(const physics::ConstContactBufferPtr &_buffer,
+                               const std::vector<unsigned int> &_records);
+
+      /// \brief Rebuild the contacts message from the contacts of the
+      /// last update, if they changed. The mutex must be locked.
+      private: void UpdateContactsMsg() const;
 
       /// \internal
       /// \brief Private data pointer
@@ -21,9 +21,11 @@
 #include <list>
 #include <string>
 #include <mutex>
+#include <utility>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/ContactManager.hh"
 
 namespace gazebo
 {
@@ -39,21 +41,27 @@ namespace gazebo
       /// \brief Output contact information.
       public: transport::PublisherPtr contactsPub;
 
-      /// \brief Subscription to contact messages from the physics engine
-      public: transport::SubscriberPtr contactSub;
-
       /// \brief Mutex to protect reads and writes.
       public: mutable std::mutex mutex;
 
-      /// \brief Contacts message used to output sensor data.
-      public: msgs::Contacts contactsMsg;
+      /// \brief Contacts message used to output sensor data. Built from
+      /// the contacts of the last update when needed.
+      public: mutable msgs::Contacts contactsMsg;
+
+      /// \brief True if contactsMsg doesn't match the last update.
+      public: mutable bool contactsMsgDirty = false;
+
+      /// \type ContactFrame
+      /// \brief Contacts of one step: the buffer shared by all the contact
+      /// filters and the indices of the records of this sensor.
+      typedef std::pair<physics::ConstContactBufferPtr,
+              std::vector<unsigned int> > ContactFrame;
 
-      /// \type ContactMsgs_L
-      /// List of contact messages
-      typedef std::list<boost::shared_ptr<msgs::Contacts const> > ContactMsgs_L;
+      /// \brief Contacts received since the last update.
+      public: std::list<ContactFrame> incomingContacts;
 
-      /// \brief List of incoming messages.
-      public: ContactMsgs_L incomingContacts;
+      /// \brief Contacts of the last update.
+      public: std::vector<ContactFrame> contacts;
 
       /// \brief Name of filter used to filter contact messages.
       public: std::string filterName;
@@ -142,17 +142,18 @@ bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
       // generating point clouds instead
       this->dataPtr->depthCamera->DepthData())
   {
-    msgs::ImageStamped msg;
-    msgs::Set(msg.mutable_time(), this->scene->SimTime());
-    msg.mutable_image()->set_width(this->camera->ImageWidth());
-    msg.mutable_image()->set_height(this->camera->ImageHeight());
-    msg.mutable_image()->set_pixel_format(common::Image::R_FLOAT32);
+    boost::shared_ptr<msgs::ImageStamped> msg =
+      this->dataPtr->imagePool.Acquire();
+    msgs::Set(msg->mutable_time(), this->scene->SimTime());
+    msg->mutable_image()->set_width(this->camera->ImageWidth());
+    msg->mutable_image()->set_height(this->camera->ImageHeight());
+    msg->mutable_image()->set_pixel_format(common::Image::R_FLOAT32);
 
 
-    msg.mutable_image()->set_step(this->camera->ImageWidth() *
+    msg->mutable_image()->set_step(this->camera->ImageWidth() *
         this->camera->ImageDepth());
 
-    unsigned int depthSamples = msg.image().width() * msg.image().height();
+    unsigned int depthSamples = msg->image().width() * msg->image().height();
     float f;
     // cppchecker recommends using sizeof(varname)
     unsigned int depthBufferSize = depthSamples * sizeof(f);
@@ -175,8 +176,10 @@ bool DepthCameraSensor::UpdateImpl(const bool /*_force*/)
         this->dataPtr->depthBuffer[i] = -ignition::math::INF_D;
       }
     }
-    msg.mutable_image()->set_data(this->dataPtr->depthBuffer, depthBufferSize);
-    this->imagePub->Publish(msg);
+    msg->mutable_image()->mutable_data()->assign(
+        reinterpret_cast<const char *>(this->dataPtr->depthBuffer),
+        depthBufferSize);
+    this->imagePub->PublishShared(msg);
   }
 
   this->SetRendered(false);
@@ -17,7 +17,9 @@
 #ifndef _GAZEBO_SENSORS_DEPTHCAMERASENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_DEPTHCAMERASENSOR_PRIVATE_HH_
 
+#include "gazebo/msgs/msgs.hh"
 #include "gazebo/rendering/RenderTypes.hh"
+#include "gazebo/transport/MessagePool.hh"
 
 namespace gazebo
 {
@@ -32,6 +34,10 @@ namespace gazebo
 
       /// \brief Local pointer to the depthCamera.
       public: rendering::DepthCameraPtr depthCamera;
+
+      /// \brief Pool of depth image messages, shared with the transport
+      /// instead of being copied on publication.
+      public: transport::MessagePool<msgs::ImageStamped> imagePool;
     };
   }
 }
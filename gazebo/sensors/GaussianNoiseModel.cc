@@ -14,6 +14,12 @@
  * limitations under the License.
  *
 */
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <mutex>
+
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Rand.hh>
 
@@ -74,6 +80,147 @@ namespace gazebo
     /// shader.
     private: const double &stddev;
   };
+
+  /// \brief Ziggurat tables for sampling a standard normal distribution,
+  /// from G. Marsaglia and W. W. Tsang, "The Ziggurat Method for Generating
+  /// Random Variables", Journal of Statistical Software, 2000.
+  class ZigguratTables
+  {
+    /// \brief Constructor, fills the 128 layer tables.
+    public: ZigguratTables()
+    {
+      const double m1 = 2147483648.0;
+      const double vn = 9.91256303526217e-3;
+      double dn = kR;
+      double tn = dn;
+      const double q = vn / exp(-0.5 * dn * dn);
+
+      this->kn[0] = static_cast<uint32_t>((dn / q) * m1);
+      this->kn[1] = 0;
+      this->wn[0] = q / m1;
+      this->wn[127] = dn / m1;
+      this->fn[0] = 1.0;
+      this->fn[127] = exp(-0.5 * dn * dn);
+
+      for (int i = 126; i >= 1; --i)
+      {
+        dn = sqrt(-2.0 * log(vn / dn + exp(-0.5 * dn * dn)));
+        this->kn[i+1] = static_cast<uint32_t>((dn / tn) * m1);
+        tn = dn;
+        this->fn[i] = exp(-0.5 * dn * dn);
+        this->wn[i] = dn / m1;
+      }
+    }
+
+    /// \brief Start of the tail of the distribution.
+    public: static constexpr double kR = 3.442619855899;
+
+    /// \brief Acceptance thresholds of the layers.
+    public: uint32_t kn[128];
+
+    /// \brief Widths of the layers.
+    public: double wn[128];
+
+    /// \brief Density at the layer boundaries.
+    public: double fn[128];
+  };
+
+  /// \brief Shared Ziggurat tables.
+  static const ZigguratTables g_zigguratTables;
+
+  /// \brief Counter based random generator: returns the SplitMix64 hash of
+  /// the seed and the counter, and increments the counter. The output only
+  /// depends on the seed and the position in the stream.
+  /// \param[in] _seed Seed of the stream.
+  /// \param[in,out] _counter Position in the stream.
+  /// \return 64 random bits.
+  inline uint64_t CounterRandom(const uint64_t _seed, uint64_t &_counter)
+  {
+    uint64_t z = _seed + (++_counter) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  /// \brief Uniform sample in (0, 1).
+  /// \param[in] _seed Seed of the stream.
+  /// \param[in,out] _counter Position in the stream.
+  /// \return Uniform sample.
+  inline double CounterUniform(const uint64_t _seed, uint64_t &_counter)
+  {
+    return ((CounterRandom(_seed, _counter) >> 11) + 0.5) *
+      (1.0 / 9007199254740992.0);
+  }
+
+  /// \brief Standard normal sample using the Ziggurat method.
+  /// \param[in] _seed Seed of the stream.
+  /// \param[in,out] _counter Position in the stream.
+  /// \return Standard normal sample.
+  inline double ZigguratNormal(const uint64_t _seed, uint64_t &_counter)
+  {
+    const ZigguratTables &t = g_zigguratTables;
+    for (;;)
+    {
+      const int32_t hz =
+        static_cast<int32_t>(CounterRandom(_seed, _counter) >> 32);
+      const uint32_t iz = static_cast<uint32_t>(hz) & 127u;
+      const double x = hz * t.wn[iz];
+
+      // Fast path, taken about 99% of the time.
+      if (static_cast<uint32_t>(std::abs(static_cast<int64_t>(hz))) <
+          t.kn[iz])
+      {
+        return x;
+      }
+
+      if (iz == 0)
+      {
+        // Sample from the tail.
+        double xt, yt;
+        do
+        {
+          xt = -log(CounterUniform(_seed, _counter)) / ZigguratTables::kR;
+          yt = -log(CounterUniform(_seed, _counter));
+        } while (yt + yt < xt * xt);
+        return hz > 0 ? ZigguratTables::kR + xt : -ZigguratTables::kR - xt;
+      }
+
+      if (t.fn[iz] + CounterUniform(_seed, _counter) *
+          (t.fn[iz-1] - t.fn[iz]) < exp(-0.5 * x * x))
+      {
+        return x;
+      }
+    }
+  }
+
+  /// \brief Counter based random stream of a Gaussian noise model, used
+  /// when noise is applied to a buffer.
+  class GaussianNoiseStream
+  {
+    /// \brief Seed of the stream.
+    public: uint64_t seed = 0;
+
+    /// \brief Position in the stream.
+    public: uint64_t counter = 0;
+  };
+
+  // Declared here for ABI compatibility
+  // TODO move to a private class member when merging forward.
+  static std::map<const sensors::GaussianNoiseModel *, GaussianNoiseStream>
+      g_noiseStreams;
+
+  /// \brief Protects g_noiseStreams.
+  static std::mutex g_noiseStreamsMutex;
+
+  /// \brief Get the random stream of a noise model.
+  /// \param[in] _model The noise model.
+  /// \return The stream, which lives as long as the model.
+  static GaussianNoiseStream &NoiseStream(
+      const sensors::GaussianNoiseModel *_model)
+  {
+    std::lock_guard<std::mutex> lock(g_noiseStreamsMutex);
+    return g_noiseStreams[_model];
+  }
 }  // namespace gazebo
 
 using namespace gazebo;
@@ -97,6 +244,8 @@ GaussianNoiseModel::GaussianNoiseModel()
 //////////////////////////////////////////////////
 GaussianNoiseModel::~GaussianNoiseModel()
 {
+  std::lock_guard<std::mutex> lock(g_noiseStreamsMutex);
+  g_noiseStreams.erase(this);
 }
 
 //////////////////////////////////////////////////
@@ -119,6 +268,11 @@ void GaussianNoiseModel::Load(sdf::ElementPtr _sdf)
   }
   this->SampleBias();
 
+  // Seed the buffer noise stream from the global random generator, so that
+  // it is reproducible when the global seed is set.
+  this->SetSeed(static_cast<uint64_t>(
+      ignition::math::Rand::IntUniform(0, std::numeric_limits<int>::max())));
+
   /// \todo Remove this, and use Noise::Print. See ImuSensor for an example
   gzlog << "applying Gaussian noise model with mean " << this->mean
     << ", stddev " << this->stdDev
@@ -158,19 +312,8 @@ double GaussianNoiseModel::ApplyImpl(double _in, double _dt)
   //
   //  https://github.com/ethz-asl/kalibr/wiki/IMU-Noise-Model
   //
-  if (this->dynamicBiasStdDev > 0 &&
-      this->dynamicBiasCorrTime > 0)
-  {
-    const double sigmaB = this->dynamicBiasStdDev;
-    const double tau = this->dynamicBiasCorrTime;
-
-    const double sigmaBD = sqrt(-sigmaB * sigmaB *
-        tau / 2 * expm1(-2 * _dt / tau));
-
-    const double phiD = exp(-_dt / tau);
-    this->bias = phiD * this->bias +
-      ignition::math::Rand::DblNormal(0, sigmaBD);
-  }
+  if (this->dynamicBiasStdDev > 0 && this->dynamicBiasCorrTime > 0)
+    this->UpdateDynamicBias(_dt, ignition::math::Rand::DblNormal(0, 1));
 
   double output = _in + this->bias + whiteNoise;
   if (this->quantized)
@@ -184,6 +327,60 @@ double GaussianNoiseModel::ApplyImpl(double _in, double _dt)
   return output;
 }
 
+//////////////////////////////////////////////////
+void GaussianNoiseModel::ApplyImpl(double *_data, const size_t _count,
+    const double _dt)
+{
+  GaussianNoiseStream &stream = NoiseStream(this);
+
+  if (this->dynamicBiasStdDev > 0 && this->dynamicBiasCorrTime > 0)
+    this->UpdateDynamicBias(_dt, ZigguratNormal(stream.seed, stream.counter));
+
+  const double offset = this->mean + this->bias;
+  for (size_t i = 0; i < _count; ++i)
+  {
+    _data[i] += offset +
+      this->stdDev * ZigguratNormal(stream.seed, stream.counter);
+  }
+
+  if (this->quantized &&
+      !ignition::math::equal(this->precision, 0.0, 1e-6))
+  {
+    for (size_t i = 0; i < _count; ++i)
+      _data[i] = std::round(_data[i] / this->precision) * this->precision;
+  }
+}
+
+//////////////////////////////////////////////////
+void GaussianNoiseModel::UpdateDynamicBias(const double _dt,
+    const double _sample)
+{
+  // Generate varying (correlated) bias for each input value.
+  // This implementation is based on the one available in Rotors:
+  // https://github.com/ethz-asl/rotors_simulator/blob/master/rotors_gazebo_plugins/src/gazebo_imu_plugin.cpp
+  //
+  // More information about the parameters and their derivation:
+  //
+  //  https://github.com/ethz-asl/kalibr/wiki/IMU-Noise-Model
+  //
+  const double sigmaB = this->dynamicBiasStdDev;
+  const double tau = this->dynamicBiasCorrTime;
+
+  const double sigmaBD = sqrt(-sigmaB * sigmaB *
+      tau / 2 * expm1(-2 * _dt / tau));
+
+  const double phiD = exp(-_dt / tau);
+  this->bias = phiD * this->bias + sigmaBD * _sample;
+}
+
+//////////////////////////////////////////////////
+void GaussianNoiseModel::SetSeed(const uint64_t _seed)
+{
+  GaussianNoiseStream &stream = NoiseStream(this);
+  stream.seed = _seed;
+  stream.counter = 0;
+}
+
 //////////////////////////////////////////////////
 double GaussianNoiseModel::GetMean() const
 {
@@ -18,6 +18,7 @@
 #ifndef _GAZEBO_GAUSSIAN_NOISE_MODEL_HH_
 #define _GAZEBO_GAUSSIAN_NOISE_MODEL_HH_
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -57,6 +58,24 @@ namespace gazebo
         // Documentation inherited.
         public: double ApplyImpl(double _in, double _dt);
 
+        /// \brief Apply Gaussian noise to a buffer of values in place.
+        /// Samples are drawn from the random stream of this noise model
+        /// (see SetSeed) with a Ziggurat generator, which is much cheaper
+        /// than drawing each value through ignition::math::Rand. The dynamic
+        /// bias is advanced once per call. Called by Noise::Apply.
+        /// \param[in,out] _data Pointer to the first data value.
+        /// \param[in] _count Number of data values.
+        /// \param[in] _dt Time elapsed since the previous call.
+        public: void ApplyImpl(double *_data, const size_t _count,
+            const double _dt);
+
+        /// \brief Seed the random stream used when noise is applied to a
+        /// buffer. Two noise models with the same parameters and seed
+        /// produce the same sequence of buffers. By default the stream is
+        /// seeded from ignition::math::Rand when the model is loaded.
+        /// \param[in] _seed Seed of the random stream.
+        public: void SetSeed(const uint64_t _seed);
+
         /// \brief Accessor for mean.
         /// \return Mean of Gaussian noise.
         public: double GetMean() const;
@@ -99,6 +118,12 @@ namespace gazebo
         /// \brief Sample the bias.
         private: void SampleBias();
 
+        /// \brief Advance the dynamic bias random walk. Only call when
+        /// dynamic bias is enabled.
+        /// \param[in] _dt Time elapsed since the previous update.
+        /// \param[in] _sample Standard normal sample driving the walk.
+        private: void UpdateDynamicBias(const double _dt, const double _sample);
+
         /// \brief If type starts with GAUSSIAN, the mean of the distribution
         /// from which we sample when adding noise.
         protected: double mean;
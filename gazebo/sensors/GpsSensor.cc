@@ -14,6 +14,11 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+
 #include <boost/algorithm/string.hpp>
 
 #include "gazebo/sensors/SensorFactory.hh"
@@ -31,6 +36,138 @@ using namespace sensors;
 
 GZ_REGISTER_STATIC_SENSOR("gps", GpsSensor)
 
+/// \brief Group of each world, by world name.
+static std::map<std::string, std::weak_ptr<GpsSensorGroup>> gGroups;
+
+/// \brief Protects gGroups.
+static std::mutex gGroupsMutex;
+
+/////////////////////////////////////////////////
+GpsSensorGroup::GpsSensorGroup(physics::WorldPtr _world)
+: world(_world)
+{
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<GpsSensorGroup> GpsSensorGroup::ForWorld(
+    physics::WorldPtr _world)
+{
+  std::lock_guard<std::mutex> lock(gGroupsMutex);
+  auto &weak = gGroups[_world->Name()];
+  std::shared_ptr<GpsSensorGroup> group = weak.lock();
+  if (!group)
+  {
+    group.reset(new GpsSensorGroup(_world));
+    weak = group;
+  }
+  return group;
+}
+
+/////////////////////////////////////////////////
+void GpsSensorGroup::Add(const GpsSensor *_sensor, MeasureFunc _measure)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->sensors.push_back(_sensor);
+  this->measureFuncs.push_back(_measure);
+  this->pending.push_back(false);
+  this->epochs.push_back(common::Time::Zero);
+  this->batchIndices.push_back(-1);
+  this->sphericals.push_back(ignition::math::Vector3d::Zero);
+  this->globals.push_back(ignition::math::Vector3d::Zero);
+  this->times.push_back(common::Time::Zero);
+}
+
+/////////////////////////////////////////////////
+void GpsSensorGroup::Remove(const GpsSensor *_sensor)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (size_t i = 0; i < this->sensors.size(); ++i)
+  {
+    if (this->sensors[i] == _sensor)
+    {
+      this->sensors.erase(this->sensors.begin() + i);
+      this->measureFuncs.erase(this->measureFuncs.begin() + i);
+      this->pending.erase(this->pending.begin() + i);
+      this->epochs.erase(this->epochs.begin() + i);
+      this->batchIndices.erase(this->batchIndices.begin() + i);
+      this->sphericals.erase(this->sphericals.begin() + i);
+      this->globals.erase(this->globals.begin() + i);
+      this->times.erase(this->times.begin() + i);
+      return;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+bool GpsSensorGroup::Measurement(const GpsSensor *_sensor,
+    const common::Time &_lastMeasurementTime,
+    ignition::math::Vector3d &_spherical, ignition::math::Vector3d &_velocity,
+    common::Time &_time)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  auto iter = std::find(this->sensors.begin(), this->sensors.end(), _sensor);
+  if (iter == this->sensors.end())
+    return false;
+  const size_t index = iter - this->sensors.begin();
+
+  // A measurement taken before the last update of the sensor is stale,
+  // start a new batch with the sensors due now
+  if (!this->pending[index] || this->epochs[index] != _lastMeasurementTime)
+  {
+    this->pending[index] = false;
+    this->MeasureBatch();
+    if (!this->pending[index] || this->epochs[index] != _lastMeasurementTime)
+      return false;
+  }
+
+  _spherical = this->sphericals[index];
+  _velocity = this->globals[index];
+  _time = this->times[index];
+  this->pending[index] = false;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void GpsSensorGroup::MeasureBatch()
+{
+  const common::Time time = this->world->SimTime();
+  this->positions.clear();
+  this->velocities.clear();
+  for (size_t i = 0; i < this->sensors.size(); ++i)
+  {
+    ignition::math::Vector3d position;
+    ignition::math::Vector3d velocity;
+    common::Time epoch;
+    if (this->measureFuncs[i](position, velocity, epoch))
+    {
+      this->batchIndices[i] = static_cast<int>(this->positions.size());
+      this->epochs[i] = epoch;
+      this->positions.push_back(position);
+      this->velocities.push_back(velocity);
+    }
+    else
+      this->batchIndices[i] = -1;
+  }
+
+  common::SphericalCoordinatesPtr sphericalCoordinates =
+    this->world->SphericalCoords();
+  sphericalCoordinates->SphericalFromLocal(this->positions,
+      this->batchSphericals);
+  sphericalCoordinates->GlobalFromLocal(this->velocities, this->batchGlobals);
+
+  for (size_t i = 0; i < this->sensors.size(); ++i)
+  {
+    const int batchIndex = this->batchIndices[i];
+    if (batchIndex < 0)
+      continue;
+    this->sphericals[i] = this->batchSphericals[batchIndex];
+    this->globals[i] = this->batchGlobals[batchIndex];
+    this->times[i] = time;
+    this->pending[i] = true;
+  }
+}
+
 /////////////////////////////////////////////////
 GpsSensor::GpsSensor()
 : Sensor(sensors::OTHER),
@@ -41,6 +178,8 @@ GpsSensor::GpsSensor()
 /////////////////////////////////////////////////
 GpsSensor::~GpsSensor()
 {
+  if (this->dataPtr->group)
+    this->dataPtr->group->Remove(this);
 }
 
 /////////////////////////////////////////////////
@@ -107,6 +246,12 @@ void GpsSensor::Load(const std::string &_worldName)
 /////////////////////////////////////////////////
 void GpsSensor::Fini()
 {
+  if (this->dataPtr->group)
+  {
+    this->dataPtr->group->Remove(this);
+    this->dataPtr->group.reset();
+  }
+
   Sensor::Fini();
   this->dataPtr->parentLink.reset();
   this->dataPtr->sphericalCoordinates.reset();
@@ -118,67 +263,98 @@ void GpsSensor::Init()
   Sensor::Init();
 
   this->dataPtr->sphericalCoordinates = this->world->SphericalCoords();
+
+  // Let the first GPS sensor to update convert all those due at the same
+  // time in one batch.
+  this->dataPtr->group = GpsSensorGroup::ForWorld(this->world);
+  this->dataPtr->group->Add(this,
+      [this](ignition::math::Vector3d &_position,
+             ignition::math::Vector3d &_velocity,
+             common::Time &_lastMeasurementTime)
+      {
+        // Same condition as Sensor::Update, without the delay compensation
+        // which can only make the sensor update earlier. A sensor missed
+        // here converts its measurement on its own.
+        if (!this->IsActive() || !this->dataPtr->parentLink ||
+            this->world->SimTime() - this->lastMeasurementTime <
+            this->updatePeriod)
+        {
+          return false;
+        }
+        this->MeasureLocal(_position, _velocity);
+        _lastMeasurementTime = this->lastMeasurementTime;
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+void GpsSensor::MeasureLocal(ignition::math::Vector3d &_position,
+    ignition::math::Vector3d &_velocity)
+{
+  // Get postion in Cartesian gazebo frame
+  ignition::math::Pose3d gpsPose = this->pose +
+    this->dataPtr->parentLink->WorldPose();
+
+  // Apply position noise before converting to global frame
+  _position.X(this->noises[GPS_POSITION_LATITUDE_NOISE_METERS]->Apply(
+        gpsPose.Pos().X()));
+  _position.Y(this->noises[GPS_POSITION_LONGITUDE_NOISE_METERS]->Apply(
+        gpsPose.Pos().Y()));
+  _position.Z(this->noises[GPS_POSITION_ALTITUDE_NOISE_METERS]->Apply(
+        gpsPose.Pos().Z()));
+
+  _velocity = this->dataPtr->parentLink->WorldLinearVel(this->pose.Pos());
 }
 
 //////////////////////////////////////////////////
 bool GpsSensor::UpdateImpl(const bool /*_force*/)
 {
+  // The message is stamped with the time of the pose it was computed from
+  common::Time measurementTime = this->world->SimTime();
+
   // Get latest pose information
   if (this->dataPtr->parentLink)
   {
-    // Measure position and apply noise
+    ignition::math::Vector3d spherical;
+    ignition::math::Vector3d gpsVelocity;
+
+    // Use the batch conversion if this sensor was part of it, otherwise,
+    // e.g. when forced, convert on our own.
+    if (!this->dataPtr->group ||
+        !this->dataPtr->group->Measurement(this, this->lastMeasurementTime,
+            spherical, gpsVelocity, measurementTime))
     {
-      // Get postion in Cartesian gazebo frame
-      ignition::math::Pose3d gpsPose = this->pose +
-        this->dataPtr->parentLink->WorldPose();
-
-      // Apply position noise before converting to global frame
-      gpsPose.Pos().X(
-        this->noises[GPS_POSITION_LATITUDE_NOISE_METERS]->Apply(
-          gpsPose.Pos().X()));
-      gpsPose.Pos().Y(
-        this->noises[GPS_POSITION_LONGITUDE_NOISE_METERS]->Apply(
-          gpsPose.Pos().Y()));
-      gpsPose.Pos().Z(
-        this->noises[GPS_POSITION_ALTITUDE_NOISE_METERS]->Apply(
-          gpsPose.Pos().Z()));
+      ignition::math::Vector3d position;
+      this->MeasureLocal(position, gpsVelocity);
 
       // Convert to global frames
-      ignition::math::Vector3d spherical = this->dataPtr->sphericalCoordinates->
-        SphericalFromLocal(gpsPose.Pos());
-      this->dataPtr->lastGpsMsg.set_latitude_deg(spherical.X());
-      this->dataPtr->lastGpsMsg.set_longitude_deg(spherical.Y());
-      this->dataPtr->lastGpsMsg.set_altitude(spherical.Z());
-    }
-
-    // Measure velocity and apply noise
-    {
-      ignition::math::Vector3d gpsVelocity =
-        this->dataPtr->parentLink->WorldLinearVel(this->pose.Pos());
-
-      // Convert to global frame
+      spherical =
+        this->dataPtr->sphericalCoordinates->SphericalFromLocal(position);
       gpsVelocity =
         this->dataPtr->sphericalCoordinates->GlobalFromLocal(gpsVelocity);
-
-      // Apply noise after converting to global frame
-      gpsVelocity.X(
-        this->noises[GPS_VELOCITY_LATITUDE_NOISE_METERS]->Apply(
-          gpsVelocity.X()));
-      gpsVelocity.Y(
-        this->noises[GPS_VELOCITY_LONGITUDE_NOISE_METERS]->Apply(
-          gpsVelocity.Y()));
-      gpsVelocity.Z(
-        this->noises[GPS_VELOCITY_ALTITUDE_NOISE_METERS]->Apply(
-          gpsVelocity.Z()));
-
-      this->dataPtr->lastGpsMsg.set_velocity_east(gpsVelocity.X());
-      this->dataPtr->lastGpsMsg.set_velocity_north(gpsVelocity.Y());
-      this->dataPtr->lastGpsMsg.set_velocity_up(gpsVelocity.Z());
     }
+
+    this->dataPtr->lastGpsMsg.set_latitude_deg(spherical.X());
+    this->dataPtr->lastGpsMsg.set_longitude_deg(spherical.Y());
+    this->dataPtr->lastGpsMsg.set_altitude(spherical.Z());
+
+    // Apply velocity noise after converting to global frame
+    gpsVelocity.X(
+      this->noises[GPS_VELOCITY_LATITUDE_NOISE_METERS]->Apply(
+        gpsVelocity.X()));
+    gpsVelocity.Y(
+      this->noises[GPS_VELOCITY_LONGITUDE_NOISE_METERS]->Apply(
+        gpsVelocity.Y()));
+    gpsVelocity.Z(
+      this->noises[GPS_VELOCITY_ALTITUDE_NOISE_METERS]->Apply(
+        gpsVelocity.Z()));
+
+    this->dataPtr->lastGpsMsg.set_velocity_east(gpsVelocity.X());
+    this->dataPtr->lastGpsMsg.set_velocity_north(gpsVelocity.Y());
+    this->dataPtr->lastGpsMsg.set_velocity_up(gpsVelocity.Z());
   }
   this->lastMeasurementTime = this->world->SimTime();
-  msgs::Set(this->dataPtr->lastGpsMsg.mutable_time(),
-      this->lastMeasurementTime);
+  msgs::Set(this->dataPtr->lastGpsMsg.mutable_time(), measurementTime);
 
   if (this->dataPtr->gpsPub)
     this->dataPtr->gpsPub->Publish(this->dataPtr->lastGpsMsg);
@@ -39,6 +39,10 @@ namespace gazebo
 
     /// \class GpsSensor GpsSensor.hh sensors/sensors.hh
     /// \brief GpsSensor to provide position measurement.
+    /// The GPS sensors of a world due in the same sensor update pass are
+    /// measured together by the first of them to update. The messages are
+    /// stamped with the simulation time of the measurement, which may be
+    /// earlier than the time the sensor published them.
     class GZ_SENSORS_VISIBLE GpsSensor: public Sensor
     {
       /// \brief Constructor.
@@ -91,6 +95,13 @@ namespace gazebo
       /// \return Current velocity towards Up
       public: double VelocityUp() const;
 
+      /// \brief Measure the position of the sensor, with noise, and its
+      /// velocity, both in the world frame.
+      /// \param[out] _position Position with noise.
+      /// \param[out] _velocity Velocity.
+      private: void MeasureLocal(ignition::math::Vector3d &_position,
+                   ignition::math::Vector3d &_velocity);
+
       /// \internal
       /// \brief Private data pointer
       private: std::unique_ptr<GpsSensorPrivate> dataPtr;
@@ -17,16 +17,129 @@
 #ifndef _GAZEBO_SENSORS_GPSSENSOR_PRIVATE_HH_
 #define _GAZEBO_SENSORS_GPSSENSOR_PRIVATE_HH_
 
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
 
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/common/CommonTypes.hh"
+#include "gazebo/common/Time.hh"
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/physics/PhysicsTypes.hh"
 
 namespace gazebo
 {
   namespace sensors
   {
+    class GpsSensor;
+
+    /// \internal
+    /// \brief GPS sensors of a world. The positions and velocities of all
+    /// the sensors due in a sensor update pass are converted to geodetic
+    /// coordinates in one batch, by the first of them to update.
+    class GpsSensorGroup
+    {
+      /// \brief Function measuring the position, with noise, and the
+      /// velocity of a sensor in the world frame. Returns false if the
+      /// sensor is not due for an update. The last argument is set to the
+      /// last measurement time of the sensor, which identifies its update.
+      public: using MeasureFunc = std::function<bool(
+                  ignition::math::Vector3d &, ignition::math::Vector3d &,
+                  common::Time &)>;
+
+      /// \brief Constructor.
+      /// \param[in] _world World of the sensors.
+      public: explicit GpsSensorGroup(physics::WorldPtr _world);
+
+      /// \brief Get the group of a world, created if needed. It is deleted
+      /// when the last sensor releases it.
+      /// \param[in] _world The world.
+      /// \return The group of the world.
+      public: static std::shared_ptr<GpsSensorGroup> ForWorld(
+                  physics::WorldPtr _world);
+
+      /// \brief Add a sensor to the group.
+      /// \param[in] _sensor The sensor.
+      /// \param[in] _measure Function measuring the sensor.
+      public: void Add(const GpsSensor *_sensor, MeasureFunc _measure);
+
+      /// \brief Remove a sensor from the group.
+      /// \param[in] _sensor The sensor.
+      public: void Remove(const GpsSensor *_sensor);
+
+      /// \brief Get the converted measurement of a sensor for its current
+      /// update. If the sensor has no pending measurement taken since its
+      /// last update, all the sensors due are measured and converted in a
+      /// new batch. The simulation time may advance while the sensors of a
+      /// pass update, so a batch is not tied to the time of the update. The
+      /// time at which the batch was measured is returned with it. A
+      /// measurement is only returned once.
+      /// \param[in] _sensor The sensor.
+      /// \param[in] _lastMeasurementTime Last measurement time of the
+      /// sensor.
+      /// \param[out] _spherical Latitude (deg), longitude (deg), altitude.
+      /// \param[out] _velocity Velocity in the East, North, Up frame.
+      /// \param[out] _time Simulation time of the batch.
+      /// \return False if the sensor was not measured in the batch, in which
+      /// case it must be converted on its own.
+      public: bool Measurement(const GpsSensor *_sensor,
+                  const common::Time &_lastMeasurementTime,
+                  ignition::math::Vector3d &_spherical,
+                  ignition::math::Vector3d &_velocity,
+                  common::Time &_time);
+
+      /// \brief Measure and convert all the sensors due.
+      private: void MeasureBatch();
+
+      /// \brief World of the sensors.
+      private: physics::WorldPtr world;
+
+      /// \brief Protects the members below.
+      private: std::mutex mutex;
+
+      /// \brief Sensors of the group.
+      private: std::vector<const GpsSensor *> sensors;
+
+      /// \brief Measure function of each sensor.
+      private: std::vector<MeasureFunc> measureFuncs;
+
+      /// \brief True for each sensor with a measurement not returned yet.
+      private: std::vector<bool> pending;
+
+      /// \brief Last measurement time of each sensor when its pending
+      /// measurement was taken.
+      private: std::vector<common::Time> epochs;
+
+      /// \brief Index in the batch of each sensor measured by the last
+      /// batch, -1 for the others.
+      private: std::vector<int> batchIndices;
+
+      /// \brief Positions in the world frame of the batch.
+      private: std::vector<ignition::math::Vector3d> positions;
+
+      /// \brief Velocities in the world frame of the batch.
+      private: std::vector<ignition::math::Vector3d> velocities;
+
+      /// \brief Geodetic positions of the batch.
+      private: std::vector<ignition::math::Vector3d> batchSphericals;
+
+      /// \brief East, North, Up velocities of the batch.
+      private: std::vector<ignition::math::Vector3d> batchGlobals;
+
+      /// \brief Pending geodetic position of each sensor.
+      private: std::vector<ignition::math::Vector3d> sphericals;
+
+      /// \brief Pending East, North, Up velocity of each sensor.
+      private: std::vector<ignition::math::Vector3d> globals;
+
+      /// \brief Simulation time of the pending measurement of each sensor.
+      private: std::vector<common::Time> times;
+    };
+
     /// \internal
     /// \brief GPS sensor private data.
     class GpsSensorPrivate
@@ -45,6 +158,9 @@ namespace gazebo
 
       /// \brief Stores most recent GPS sensor data.
       public: msgs::GPS lastGpsMsg;
+
+      /// \brief Group converting the GPS sensors of the world together.
+      public: std::shared_ptr<GpsSensorGroup> group;
     };
   }
 }
@@ -15,12 +15,31 @@
  *
 */
 
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
 class GpsSensor_TEST : public ServerFixture
 {
+  /// \brief Store a GPS message by link name.
+  /// \param[in] _msg The message.
+  public: void OnGps(ConstGPSPtr &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->receivedMutex);
+    this->received[_msg->link_name()].push_back(*_msg);
+  }
+
+  /// \brief Protects received.
+  public: std::mutex receivedMutex;
+
+  /// \brief Messages received, by link name.
+  public: std::map<std::string, std::vector<msgs::GPS>> received;
 };
 
 static std::string gpsSensorString =
@@ -117,6 +136,106 @@ TEST_F(GpsSensor_TEST, CreateGps)
   world->Step(100);
 }
 
+/////////////////////////////////////////////////
+/// \brief Several GPS sensors converted in batches: every update publishes
+/// exactly one message, computed from its own link pose at the time of the
+/// batch it is stamped with.
+TEST_F(GpsSensor_TEST, BatchMeasurements)
+{
+  Load("worlds/empty.world", true);
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  const unsigned int sensorCount = 3;
+  std::vector<transport::SubscriberPtr> subs;
+  std::vector<physics::ModelPtr> models;
+
+  for (unsigned int i = 0; i < sensorCount; ++i)
+  {
+    const std::string index = std::to_string(i);
+    std::ostringstream modelStr;
+    modelStr << "<sdf version='" << SDF_VERSION << "'>"
+      << "<model name='gps_model_" << index << "'>"
+      << "  <static>true</static>"
+      << "  <pose>" << 10 * i << " 0 0 0 0 0</pose>"
+      << "  <link name='link'>"
+      << "    <sensor name='gps_" << index << "' type='gps'>"
+      << "      <always_on>1</always_on>"
+      << "      <update_rate>10</update_rate>"
+      << "      <pose>0 1 0 0 0 0</pose>"
+      << "    </sensor>"
+      << "  </link>"
+      << "</model>"
+      << "</sdf>";
+    SpawnSDF(modelStr.str());
+    WaitUntilSensorSpawn("gps_" + index, 100, 100);
+
+    models.push_back(world->ModelByName("gps_model_" + index));
+    ASSERT_TRUE(models.back() != nullptr);
+
+    subs.push_back(this->node->Subscribe(
+        "~/gps_model_" + index + "/link/gps_" + index,
+        &GpsSensor_TEST::OnGps, this));
+  }
+
+  common::SphericalCoordinatesPtr sphericalCoordinates =
+    world->SphericalCoords();
+  const int stepsPerUpdate = static_cast<int>(
+      0.1 / world->Physics()->GetMaxStepSize());
+
+  // Let the sensors publish once, then move the models before each update
+  world->Step(stepsPerUpdate);
+  common::Time::MSleep(500);
+
+  for (int round = 1; round <= 3; ++round)
+  {
+    for (unsigned int i = 0; i < sensorCount; ++i)
+    {
+      models[i]->SetWorldPose(
+          ignition::math::Pose3d(10 * i + round, 2 * round, round, 0, 0, 0));
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->receivedMutex);
+      this->received.clear();
+    }
+    world->Step(stepsPerUpdate);
+
+    int sleep = 0;
+    while (sleep++ < 50)
+    {
+      common::Time::MSleep(100);
+      std::lock_guard<std::mutex> lock(this->receivedMutex);
+      if (this->received.size() == sensorCount)
+        break;
+    }
+
+    std::lock_guard<std::mutex> lock(this->receivedMutex);
+    ASSERT_EQ(this->received.size(), sensorCount);
+    const common::Time batchTime =
+      msgs::Convert(this->received.begin()->second.front().time());
+    EXPECT_LE(batchTime, world->SimTime());
+    for (unsigned int i = 0; i < sensorCount; ++i)
+    {
+      auto const &msgsOfLink =
+        this->received["gps_model_" + std::to_string(i) + "::link"];
+      ASSERT_EQ(msgsOfLink.size(), 1u);
+      const msgs::GPS &msg = msgsOfLink.front();
+
+      // Measured in the same batch as the other sensors
+      EXPECT_EQ(msgs::Convert(msg.time()), batchTime);
+
+      // Fresh position of this sensor, not of another one
+      ignition::math::Vector3d expected =
+        sphericalCoordinates->SphericalFromLocal(
+            ignition::math::Vector3d(10 * i + round, 2 * round + 1, round));
+      EXPECT_NEAR(msg.latitude_deg(), expected.X(), 1e-9);
+      EXPECT_NEAR(msg.longitude_deg(), expected.Y(), 1e-9);
+      EXPECT_NEAR(msg.altitude(), expected.Z(), 1e-6);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
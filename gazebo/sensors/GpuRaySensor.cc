@@ -656,18 +656,42 @@ bool GpuRaySensor::UpdateImpl(const bool /*_force*/)
     {
       range = -ignition::math::INF_D;
     }
-    else if (this->noises.find(GPU_RAY_NOISE) != this->noises.end())
+    else
     {
-      range = this->noises[GPU_RAY_NOISE]->Apply(range);
-      range = ignition::math::clamp(range,
-          this->dataPtr->rangeMin, this->dataPtr->rangeMax);
+      this->dataPtr->noiseIndices.push_back(i);
     }
 
-    range = ignition::math::isnan(range) ? this->dataPtr->rangeMax : range;
     scan->set_ranges(i, range);
     scan->set_intensities(i, intensity);
   }
 
+  // Apply noise to all the in-range values at once.
+  double *ranges = scan->mutable_ranges()->mutable_data();
+  auto noiseIter = this->noises.find(GPU_RAY_NOISE);
+  if (noiseIter != this->noises.end() &&
+      !this->dataPtr->noiseIndices.empty())
+  {
+    std::vector<double> &buffer = this->dataPtr->noiseBuffer;
+    buffer.resize(this->dataPtr->noiseIndices.size());
+    for (size_t i = 0; i < buffer.size(); ++i)
+      buffer[i] = ranges[this->dataPtr->noiseIndices[i]];
+
+    noiseIter->second->Apply(buffer.data(), buffer.size());
+
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+      ranges[this->dataPtr->noiseIndices[i]] = ignition::math::clamp(
+          buffer[i], this->dataPtr->rangeMin, this->dataPtr->rangeMax);
+    }
+  }
+
+  for (auto const &index : this->dataPtr->noiseIndices)
+  {
+    if (ignition::math::isnan(ranges[index]))
+      ranges[index] = this->dataPtr->rangeMax;
+  }
+  this->dataPtr->noiseIndices.clear();
+
   if (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections())
     this->dataPtr->scanPub->Publish(this->dataPtr->laserMsg);
 
@@ -18,6 +18,8 @@
 #define _GAZEBO_SENSORS_GPURAYENSOR_PRIVATE_HH_
 
 #include <mutex>
+#include <vector>
+
 #include <sdf/sdf.hh>
 
 #include "gazebo/rendering/RenderTypes.hh"
@@ -86,6 +88,13 @@ namespace gazebo
 
       /// \brief True if the sensor was rendered.
       public: bool rendered;
+
+      /// \brief Indices of the in-range values of the last scan, which
+      /// receive noise.
+      public: std::vector<int> noiseIndices;
+
+      /// \brief Buffer of in-range values that noise is applied to.
+      public: std::vector<double> noiseBuffer;
     };
   }
 }
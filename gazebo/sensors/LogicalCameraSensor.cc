@@ -116,23 +116,16 @@ void LogicalCameraSensorPrivate::AddVisibleModels(
   for (auto const &model : _models)
   {
     auto const &scopedName = model->GetScopedName();
-    auto const aabb = model->BoundingBox();
-
-    if (this->modelName != scopedName && this->frustum.Contains(aabb))
-    {
-      // Add new model msg
-      msgs::LogicalCameraImage::Model *modelMsg = this->msg.add_model();
-
-      // Set the name and pose reported by the sensor.
-      modelMsg->set_name(scopedName);
-      msgs::Set(modelMsg->mutable_pose(),
-          model->WorldPose() - _myPose);
-    }
-    // Check nested models
-    // Note, the model AABB does not necessarily contain the nested model
-    // so nested models must be searched even if the frustum does not contain
-    // the parent model.
-    AddVisibleModels(_myPose, model->NestedModels());
+    if (this->modelName == scopedName)
+      continue;
+
+    // Add new model msg
+    msgs::LogicalCameraImage::Model *modelMsg = this->msg.add_model();
+
+    // Set the name and pose reported by the sensor.
+    modelMsg->set_name(scopedName);
+    msgs::Set(modelMsg->mutable_pose(),
+        model->WorldPose() - _myPose);
   }
 }
 
@@ -155,8 +148,13 @@ bool LogicalCameraSensor::UpdateImpl(const bool _force)
     // Set the camera's pose in the message.
     msgs::Set(this->dataPtr->msg.mutable_pose(), myPose);
 
-    // Recursively check if models and nested models are in the frustum.
-    this->dataPtr->AddVisibleModels(myPose, this->world->Models());
+    // Find the models and nested models in the frustum. The world keeps a
+    // spatial index of the models, so only the models near the frustum are
+    // tested.
+    this->dataPtr->visibleModels.clear();
+    this->world->ModelsInFrustum(this->dataPtr->frustum,
+        this->dataPtr->visibleModels);
+    this->dataPtr->AddVisibleModels(myPose, this->dataPtr->visibleModels);
 
     // Send the message.
     this->dataPtr->pub->Publish(this->dataPtr->msg);
@@ -258,8 +258,14 @@ bool MultiCameraSensor::UpdateImpl(const bool /*_force*/)
 
   bool publish = this->dataPtr->imagePub->HasConnections();
 
-  msgs::Set(this->dataPtr->msg.mutable_time(),
-            this->lastMeasurementTime);
+  boost::shared_ptr<msgs::ImagesStamped> msg;
+  if (publish)
+  {
+    msg = this->dataPtr->imagePool.Acquire();
+    if (msg->image_size() != this->dataPtr->msg.image_size())
+      msg->CopyFrom(this->dataPtr->msg);
+    msgs::Set(msg->mutable_time(), this->lastMeasurementTime);
+  }
 
   int index = 0;
   for (auto iter = this->dataPtr->cameras.begin();
@@ -269,14 +275,15 @@ bool MultiCameraSensor::UpdateImpl(const bool /*_force*/)
 
     if (publish)
     {
-      msgs::Image *image = this->dataPtr->msg.mutable_image(index);
-      image->set_data((*iter)->ImageData(0),
+      msgs::Image *image = msg->mutable_image(index);
+      image->mutable_data()->assign(
+          reinterpret_cast<const char *>((*iter)->ImageData(0)),
           image->width() * (*iter)->ImageDepth() * image->height());
     }
   }
 
   if (publish)
-    this->dataPtr->imagePub->Publish(this->dataPtr->msg);
+    this->dataPtr->imagePub->PublishShared(msg);
 
   this->dataPtr->rendered = false;
   return true;
@@ -21,6 +21,7 @@
 #include <mutex>
 
 #include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/MessagePool.hh"
 #include "gazebo/transport/TransportTypes.hh"
 
 namespace gazebo
@@ -40,9 +41,14 @@ namespace gazebo
       /// \brief Publishes messages of type msgs::ImagesStamped.
       public: transport::PublisherPtr imagePub;
 
-      /// \brief The images msg.
+      /// \brief The images msg. Holds the image properties of every
+      /// camera, but no image data.
       public: msgs::ImagesStamped msg;
 
+      /// \brief Pool of images messages, shared with the transport
+      /// instead of being copied on publication.
+      public: transport::MessagePool<msgs::ImagesStamped> imagePool;
+
       /// \brief True if the sensor was rendered.
       public: bool rendered;
     };
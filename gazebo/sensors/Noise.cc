@@ -124,6 +124,33 @@ double Noise::ApplyImpl(double _in, double /*_dt*/)
   return _in;
 }
 
+//////////////////////////////////////////////////
+void Noise::Apply(double *_data, const size_t _count, const double _dt)
+{
+  if (this->type == NONE)
+    return;
+  else if (this->type == CUSTOM)
+  {
+    for (size_t i = 0; i < _count; ++i)
+      _data[i] = this->Apply(_data[i], _dt);
+  }
+  else if (GaussianNoiseModel *gaussian =
+      dynamic_cast<GaussianNoiseModel *>(this))
+  {
+    // Not virtual, for ABI compatibility
+    gaussian->ApplyImpl(_data, _count, _dt);
+  }
+  else
+    this->ApplyImpl(_data, _count, _dt);
+}
+
+//////////////////////////////////////////////////
+void Noise::ApplyImpl(double *_data, const size_t _count, const double _dt)
+{
+  for (size_t i = 0; i < _count; ++i)
+    _data[i] = this->ApplyImpl(_data[i], _dt);
+}
+
 //////////////////////////////////////////////////
 Noise::NoiseType Noise::GetNoiseType() const
 {
@@ -88,6 +88,24 @@ namespace gazebo
       /// \return Data with noise applied.
       public: virtual double ApplyImpl(double _in, double _dt = 0.0);
 
+      /// \brief Apply noise to a buffer of input data values in place.
+      /// All the values are treated as samples taken at the same time, so
+      /// time dependent parts of a noise model are advanced once per call.
+      /// \param[in,out] _data Pointer to the first data value.
+      /// \param[in] _count Number of data values.
+      /// \param[in] _dt Time elapsed since the previous call.
+      public: void Apply(double *_data, const size_t _count,
+          const double _dt = 0.0);
+
+      /// \brief Apply noise to a buffer of input data values in place.
+      /// Called by the buffer version of Apply for the noise models that
+      /// have no buffer implementation, it calls ApplyImpl for each value.
+      /// \param[in,out] _data Pointer to the first data value.
+      /// \param[in] _count Number of data values.
+      /// \param[in] _dt Time elapsed since the previous call.
+      public: void ApplyImpl(double *_data, const size_t _count,
+          const double _dt);
+
       /// \brief Finalize the noise model
       public: virtual void Fini();
 
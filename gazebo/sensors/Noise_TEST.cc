@@ -348,6 +348,62 @@ TEST_F(NoiseTest, ApplyGaussianQuantized)
   }
 }
 
+//////////////////////////////////////////////////
+// Test applying noise to a buffer of values
+TEST_F(NoiseTest, ApplyBuffer)
+{
+  const double mean = 10.0;
+  const double stddev = 5.0;
+  const size_t count = 100000;
+
+  // No noise leaves the buffer untouched
+  {
+    sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+        NoiseSdf("none", 0, 0, 0, 0, 0));
+    std::vector<double> data(count, 42.0);
+    noise->Apply(data.data(), data.size());
+    for (auto const &value : data)
+      EXPECT_DOUBLE_EQ(value, 42.0);
+  }
+
+  sensors::NoisePtr noise = sensors::NoiseFactory::NewNoiseModel(
+      NoiseSdf("gaussian", mean, stddev, 0, 0, 0));
+  sensors::GaussianNoiseModelPtr gaussianNoise =
+    std::dynamic_pointer_cast<sensors::GaussianNoiseModel>(noise);
+  ASSERT_TRUE(gaussianNoise != nullptr);
+
+  gaussianNoise->SetSeed(1234);
+  std::vector<double> data(count, 42.0);
+  noise->Apply(data.data(), data.size());
+
+  boost::accumulators::accumulator_set<double,
+    boost::accumulators::stats<boost::accumulators::tag::mean,
+                               boost::accumulators::tag::variance > > acc;
+  for (auto const &value : data)
+    acc(value);
+
+  // See comments in GaussianNoise function to explain these calculations.
+  double sampleStdDev = g_sigma*stddev / sqrt(count);
+  EXPECT_NEAR(boost::accumulators::mean(acc), 42.0 + mean, sampleStdDev);
+
+  double variance = stddev*stddev;
+  double sampleVariance2 = 2 * variance*variance / (count - 1);
+  EXPECT_NEAR(boost::accumulators::variance(acc),
+              variance, g_sigma*sqrt(sampleVariance2));
+
+  // The same seed produces the same buffer
+  gaussianNoise->SetSeed(1234);
+  std::vector<double> data2(count, 42.0);
+  noise->Apply(data2.data(), data2.size());
+  EXPECT_EQ(data, data2);
+
+  // A different seed produces a different buffer
+  gaussianNoise->SetSeed(4321);
+  std::vector<double> data3(count, 42.0);
+  noise->Apply(data3.data(), data3.size());
+  EXPECT_NE(data, data3);
+}
+
 //////////////////////////////////////////////////
 // Callback function for applying custom noise
 double OnApplyCustomNoise(double _in)
@@ -483,13 +483,9 @@ bool RaySensor::UpdateImpl(const bool /*_force*/)
       {
         range = -ignition::math::INF_D;
       }
-      else if (this->noises.find(RAY_NOISE) !=
-               this->noises.end())
+      else
       {
-        // currently supports only one noise model per laser sensor
-        range = this->noises[RAY_NOISE]->Apply(range);
-        range = ignition::math::clamp(range,
-            this->RangeMin(), this->RangeMax());
+        this->dataPtr->noiseIndices.push_back(scan->ranges_size());
       }
 
       scan->add_ranges(range);
@@ -497,6 +493,28 @@ bool RaySensor::UpdateImpl(const bool /*_force*/)
     }
   }
 
+  // Apply noise to all the in-range values at once.
+  // Currently supports only one noise model per laser sensor.
+  auto noiseIter = this->noises.find(RAY_NOISE);
+  if (noiseIter != this->noises.end() &&
+      !this->dataPtr->noiseIndices.empty())
+  {
+    double *ranges = scan->mutable_ranges()->mutable_data();
+    std::vector<double> &buffer = this->dataPtr->noiseBuffer;
+    buffer.resize(this->dataPtr->noiseIndices.size());
+    for (size_t i = 0; i < buffer.size(); ++i)
+      buffer[i] = ranges[this->dataPtr->noiseIndices[i]];
+
+    noiseIter->second->Apply(buffer.data(), buffer.size());
+
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+      ranges[this->dataPtr->noiseIndices[i]] = ignition::math::clamp(
+          buffer[i], this->RangeMin(), this->RangeMax());
+    }
+  }
+  this->dataPtr->noiseIndices.clear();
+
   if (this->dataPtr->scanPub && this->dataPtr->scanPub->HasConnections())
     this->dataPtr->scanPub->Publish(this->dataPtr->laserMsg);
 
@@ -782,6 +782,15 @@ void SimTimeEventHandler::OnUpdate(const common::UpdateInfo &_info)
   boost::mutex::scoped_lock timingLock(g_sensorTimingMutex);
   boost::mutex::scoped_lock lock(this->mutex);
 
+  // Event times are relative to the first world, see AddRelativeEvent.
+  // Ignore the updates of other worlds, which may run concurrently in
+  // batch mode.
+  if (this->events.empty() ||
+      _info.worldName != physics::get_world()->Name())
+  {
+    return;
+  }
+
   // Iterate over all the events.
   for (std::list<SimTimeEvent*>::iterator iter = this->events.begin();
       iter != this->events.end();)
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "gazebo/common/Assert.hh"
+#include "gazebo/physics/physics.hh"
+
+#include "gazebo/sensors/WirelessPropagationPrivate.hh"
+#include "gazebo/sensors/WirelessPropagation.hh"
+
+using namespace gazebo;
+using namespace sensors;
+
+/// \brief Maximum number of cached segments, to bound memory when the
+/// end points keep moving.
+static const size_t kMaxCacheSize = 1 << 18;
+
+/////////////////////////////////////////////////
+/// \brief Quantize a segment to millimeters.
+/// \param[in] _start Start point.
+/// \param[in] _end End point.
+/// \return Cache key.
+static WirelessPropagationPrivate::Key MakeKey(
+    const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end)
+{
+  return {{std::llround(_start.X() * 1000), std::llround(_start.Y() * 1000),
+           std::llround(_start.Z() * 1000), std::llround(_end.X() * 1000),
+           std::llround(_end.Y() * 1000), std::llround(_end.Z() * 1000)}};
+}
+
+/////////////////////////////////////////////////
+/// \brief Slab test between a segment and an axis aligned box.
+/// \param[in] _start Start point.
+/// \param[in] _end End point.
+/// \param[in] _box Box to test.
+/// \return True if the segment touches the box.
+static bool SegmentHitsBox(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end, const ignition::math::Box &_box)
+{
+  double tMin = 0.0;
+  double tMax = 1.0;
+  const ignition::math::Vector3d dir = _end - _start;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (std::abs(dir[i]) < 1e-12)
+    {
+      if (_start[i] < _box.Min()[i] || _start[i] > _box.Max()[i])
+        return false;
+      continue;
+    }
+
+    double t1 = (_box.Min()[i] - _start[i]) / dir[i];
+    double t2 = (_box.Max()[i] - _start[i]) / dir[i];
+    if (t1 > t2)
+      std::swap(t1, t2);
+    tMin = std::max(tMin, t1);
+    tMax = std::min(tMax, t2);
+    if (tMin > tMax)
+      return false;
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+WirelessPropagation::WirelessPropagation(physics::WorldPtr _world)
+  : dataPtr(new WirelessPropagationPrivate)
+{
+  GZ_ASSERT(_world, "World pointer is null");
+  this->dataPtr->world = _world;
+  this->dataPtr->ray = boost::dynamic_pointer_cast<physics::RayShape>(
+      _world->Physics()->CreateShape("ray", physics::CollisionPtr()));
+}
+
+/////////////////////////////////////////////////
+WirelessPropagation::~WirelessPropagation()
+{
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::Obstructed(const ignition::math::Vector3d &_start,
+    const std::vector<ignition::math::Vector3d> &_ends,
+    std::vector<uint8_t> &_obstructed)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  _obstructed.assign(_ends.size(), 0);
+
+  physics::Model_V models = this->dataPtr->world->Models();
+  if (models.size() != this->dataPtr->modelCount ||
+      this->dataPtr->cache.size() > kMaxCacheSize)
+  {
+    this->dataPtr->cache.clear();
+    this->dataPtr->modelCount = models.size();
+  }
+
+  this->dataPtr->dynamicBoxes.clear();
+  for (auto const &model : models)
+  {
+    if (!model->IsStatic())
+      this->dataPtr->dynamicBoxes.push_back(model->BoundingBox());
+  }
+
+  // Resolve what we can from the cache first, and keep the rest for a
+  // single locked pass over the physics engine.
+  std::vector<size_t> pending;
+  for (size_t i = 0; i < _ends.size(); ++i)
+  {
+    auto iter = this->dataPtr->cache.find(MakeKey(_start, _ends[i]));
+    if (iter == this->dataPtr->cache.end())
+    {
+      pending.push_back(i);
+    }
+    else if (iter->second)
+    {
+      _obstructed[i] = 1;
+    }
+    else
+    {
+      for (auto const &box : this->dataPtr->dynamicBoxes)
+      {
+        if (SegmentHitsBox(_start, _ends[i], box))
+        {
+          pending.push_back(i);
+          break;
+        }
+      }
+    }
+  }
+
+  if (pending.empty())
+    return;
+
+  boost::recursive_mutex::scoped_lock physicsLock(
+      *this->dataPtr->world->Physics()->GetPhysicsUpdateMutex());
+
+  std::string entityName;
+  double dist;
+  for (auto const i : pending)
+  {
+    ignition::math::Vector3d end = _ends[i];
+
+    // Avoid computing the intersection of coincident points
+    // This prevents an assertion in bullet (issue #849)
+    if (_start == end)
+      end.Z() += 0.00001;
+
+    entityName.clear();
+    this->dataPtr->ray->SetPoints(_start, end);
+    this->dataPtr->ray->GetIntersection(dist, entityName);
+    ++this->dataPtr->rayCount;
+
+    const auto key = MakeKey(_start, _ends[i]);
+    if (entityName.empty())
+    {
+      this->dataPtr->cache[key] = false;
+      continue;
+    }
+
+    _obstructed[i] = 1;
+
+    physics::EntityPtr entity =
+        this->dataPtr->world->EntityByName(entityName);
+    if (entity && entity->IsStatic())
+      this->dataPtr->cache[key] = true;
+    else
+      this->dataPtr->cache.erase(key);
+  }
+}
+
+/////////////////////////////////////////////////
+bool WirelessPropagation::Obstructed(const ignition::math::Vector3d &_start,
+    const ignition::math::Vector3d &_end)
+{
+  std::vector<uint8_t> obstructed;
+  this->Obstructed(_start, {_end}, obstructed);
+  return obstructed[0] != 0;
+}
+
+/////////////////////////////////////////////////
+size_t WirelessPropagation::CacheSize() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->cache.size();
+}
+
+/////////////////////////////////////////////////
+uint64_t WirelessPropagation::RayCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->rayCount;
+}
+
+/////////////////////////////////////////////////
+void WirelessPropagation::ClearCache()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->cache.clear();
+}
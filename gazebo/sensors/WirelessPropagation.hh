@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_WIRELESSPROPAGATION_HH_
+#define GAZEBO_SENSORS_WIRELESSPROPAGATION_HH_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    // Forward declare private data class.
+    class WirelessPropagationPrivate;
+
+    /// \addtogroup gazebo_sensors
+    /// \{
+
+    /// \class WirelessPropagation WirelessPropagation.hh sensors/sensors.hh
+    /// \brief Line of sight queries for the wireless propagation model.
+    /// A batch of segments is tested with a single lock of the physics
+    /// engine and a single ray shape. The result of each segment is cached
+    /// when it only depends on static geometry: a segment blocked by a
+    /// static model, or not blocked at all, is only cast again if a
+    /// non-static model moves across it. The cache is cleared whenever
+    /// models are added or removed.
+    class GZ_SENSORS_VISIBLE WirelessPropagation
+    {
+      /// \brief Constructor.
+      /// \param[in] _world World to cast rays in.
+      public: explicit WirelessPropagation(physics::WorldPtr _world);
+
+      /// \brief Destructor.
+      public: ~WirelessPropagation();
+
+      /// \brief Check which segments from a common start point are
+      /// obstructed.
+      /// \param[in] _start Start point of all the segments, usually the
+      /// transmitter antenna.
+      /// \param[in] _ends End point of each segment.
+      /// \param[out] _obstructed One entry per segment, non zero if the
+      /// segment intersects a collision.
+      public: void Obstructed(const ignition::math::Vector3d &_start,
+                  const std::vector<ignition::math::Vector3d> &_ends,
+                  std::vector<uint8_t> &_obstructed);
+
+      /// \brief Check if a single segment is obstructed.
+      /// \param[in] _start Start point of the segment.
+      /// \param[in] _end End point of the segment.
+      /// \return True if the segment intersects a collision.
+      public: bool Obstructed(const ignition::math::Vector3d &_start,
+                  const ignition::math::Vector3d &_end);
+
+      /// \brief Get the number of cached segments.
+      /// \return Number of segments whose result is cached.
+      public: size_t CacheSize() const;
+
+      /// \brief Get the number of rays cast since construction.
+      /// \return Number of ray casts.
+      public: uint64_t RayCount() const;
+
+      /// \brief Clear the cache.
+      public: void ClearCache();
+
+      /// \internal
+      /// \brief Private data pointer
+      private: std::unique_ptr<WirelessPropagationPrivate> dataPtr;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_SENSORS_WIRELESSPROPAGATION_PRIVATE_HH_
+#define GAZEBO_SENSORS_WIRELESSPROPAGATION_PRIVATE_HH_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/math/Box.hh>
+
+#include "gazebo/physics/PhysicsTypes.hh"
+
+namespace gazebo
+{
+  namespace sensors
+  {
+    /// \internal
+    /// \brief Wireless propagation private data
+    class WirelessPropagationPrivate
+    {
+      /// \brief Segment end points quantized to millimeters.
+      public: using Key = std::array<int64_t, 6>;
+
+      /// \brief Hash of a quantized segment.
+      public: struct KeyHash
+      {
+        /// \brief Hash a key.
+        /// \param[in] _key Key to hash.
+        /// \return Hash value.
+        size_t operator()(const Key &_key) const
+        {
+          uint64_t hash = 14695981039346656037ULL;
+          for (auto const v : _key)
+            hash = (hash ^ static_cast<uint64_t>(v)) * 1099511628211ULL;
+          return static_cast<size_t>(hash);
+        }
+      };
+
+      /// \brief World to cast rays in.
+      public: physics::WorldPtr world;
+
+      /// \brief Ray used to test for obstacles.
+      public: physics::RayShapePtr ray;
+
+      /// \brief Cached results: true if blocked by a static model, false if
+      /// not blocked at all. Segments first blocked by a non-static model
+      /// are not cached.
+      public: std::unordered_map<Key, bool, KeyHash> cache;
+
+      /// \brief Model count when the cache was filled.
+      public: unsigned int modelCount = 0;
+
+      /// \brief Bounding boxes of the non-static models, updated for every
+      /// query.
+      public: std::vector<ignition::math::Box> dynamicBoxes;
+
+      /// \brief Number of rays cast.
+      public: uint64_t rayCount = 0;
+
+      /// \brief Protects the cache and the ray.
+      public: mutable std::mutex mutex;
+    };
+  }
+}
+#endif
@@ -118,18 +118,20 @@ bool WirelessReceiver::UpdateImpl(const bool /*_force*/)
       std::shared_ptr<gazebo::sensors::WirelessTransmitter> transmitter =
           std::static_pointer_cast<WirelessTransmitter>(*it);
 
+      // Discard if the frequency received is out of our frequency range
+      // before paying for the line of sight test
       txFreq = transmitter->Freq();
-      rxPower = transmitter->SignalStrength(myPos, this->Gain());
-
-      // Discard if the frequency received is out of our frequency range,
-      // or if the received signal strengh is lower than the sensivity
       if ((txFreq < this->MinFreqFiltered()) ||
-          (txFreq > this->MaxFreqFiltered()) ||
-          (rxPower < this->Sensitivity()))
+          (txFreq > this->MaxFreqFiltered()))
       {
         continue;
       }
 
+      // Discard if the received signal strengh is lower than the sensivity
+      rxPower = transmitter->SignalStrength(myPos, this->Gain());
+      if (rxPower < this->Sensitivity())
+        continue;
+
       txEssid = transmitter->ESSID();
 
       msgs::WirelessNode *wirelessNode = msg.add_node();
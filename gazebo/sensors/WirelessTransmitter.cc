@@ -14,6 +14,8 @@
  * limitations under the License.
  *
 */
+#include <cmath>
+
 #include <ignition/math/Rand.hh>
 
 #include "gazebo/msgs/msgs.hh"
@@ -79,10 +81,23 @@ void WirelessTransmitter::Init()
 {
   WirelessTransceiver::Init();
 
-  // This ray will be used in SignalStrength() for checking obstacles
+  // Used in SignalStrength() and UpdateImpl() for checking obstacles
   // between the transmitter and a given point.
-  this->dataPtr->testRay = boost::dynamic_pointer_cast<RayShape>(
-      this->world->Physics()->CreateShape("ray", CollisionPtr()));
+  this->dataPtr->propagation.reset(new WirelessPropagation(this->world));
+
+  // Iterate using a rectangular grid, but only choose the points within
+  // a circunference of radius MaxRadius
+  this->dataPtr->gridCells.clear();
+  for (double x = -this->dataPtr->MaxRadius;
+       x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
+  {
+    for (double y = -this->dataPtr->MaxRadius;
+         y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
+    {
+      if (std::hypot(x, y) <= this->dataPtr->MaxRadius)
+        this->dataPtr->gridCells.push_back(ignition::math::Vector3d(x, y, 0));
+    }
+  }
 }
 
 //////////////////////////////////////////////////
@@ -92,38 +107,31 @@ bool WirelessTransmitter::UpdateImpl(const bool /*_force*/)
 
   if (this->dataPtr->visualize)
   {
+    // Test the line of sight to every cell in a single query
+    this->dataPtr->gridEnds.resize(this->dataPtr->gridCells.size());
+    for (size_t i = 0; i < this->dataPtr->gridCells.size(); ++i)
+    {
+      this->dataPtr->gridEnds[i] = this->referencePose.CoordPositionAdd(
+          this->dataPtr->gridCells[i]);
+    }
+
+    this->dataPtr->propagation->Obstructed(this->referencePose.Pos(),
+        this->dataPtr->gridEnds, this->dataPtr->gridObstructed);
+
     msgs::PropagationGrid msg;
-    ignition::math::Pose3d pos;
-    ignition::math::Pose3d worldPose;
-    double strength;
-    msgs::PropagationParticle *p;
-
-    // Iterate using a rectangular grid, but only choose the points within
-    // a circunference of radius MaxRadius
-    for (double x = -this->dataPtr->MaxRadius;
-         x <= this->dataPtr->MaxRadius; x += this->dataPtr->Step)
+    for (size_t i = 0; i < this->dataPtr->gridCells.size(); ++i)
     {
-      for (double y = -this->dataPtr->MaxRadius;
-           y <= this->dataPtr->MaxRadius; y += this->dataPtr->Step)
-      {
-        pos.Set(x, y, 0.0, 0, 0, 0);
-
-        worldPose = pos + this->referencePose;
-
-        if (this->referencePose.Pos().Distance(worldPose.Pos()) <=
-            this->dataPtr->MaxRadius)
-        {
-          // For the propagation model assume the receiver antenna has the same
-          // gain as the transmitter
-          strength = this->SignalStrength(worldPose, this->Gain());
-
-          // Add a new particle to the grid
-          p = msg.add_particle();
-          p->set_x(x);
-          p->set_y(y);
-          p->set_signal_level(strength);
-        }
-      }
+      // For the propagation model assume the receiver antenna has the same
+      // gain as the transmitter
+      double strength = this->SignalStrength(
+          this->referencePose.Pos().Distance(this->dataPtr->gridEnds[i]),
+          this->dataPtr->gridObstructed[i] != 0, this->Gain());
+
+      // Add a new particle to the grid
+      msgs::PropagationParticle *p = msg.add_particle();
+      p->set_x(this->dataPtr->gridCells[i].X());
+      p->set_y(this->dataPtr->gridCells[i].Y());
+      p->set_signal_level(strength);
     }
     this->pub->Publish(msg);
   }
@@ -148,37 +156,24 @@ double WirelessTransmitter::SignalStrength(
     const ignition::math::Pose3d &_receiver,
     const double _rxGain)
 {
-  std::string entityName;
-  double dist;
-  ignition::math::Vector3d end = _receiver.Pos();
-  ignition::math::Vector3d start = this->referencePose.Pos();
-
-  // Avoid computing the intersection of coincident points
-  // This prevents an assertion in bullet (issue #849)
-  if (start == end)
-  {
-    end.Z() += 0.00001;
-  }
+  bool obstructed = this->dataPtr->propagation->Obstructed(
+      this->referencePose.Pos(), _receiver.Pos());
 
-  // Acquire the mutex for avoiding race condition with the physics engine
-  boost::recursive_mutex::scoped_lock lock(*(
-        this->world->Physics()->GetPhysicsUpdateMutex()));
+  return this->SignalStrength(
+      this->referencePose.Pos().Distance(_receiver.Pos()), obstructed,
+      _rxGain);
+}
 
+/////////////////////////////////////////////////
+double WirelessTransmitter::SignalStrength(const double _distance,
+    const bool _obstructed, const double _rxGain) const
+{
   // Compute the value of n depending on the obstacles between Tx and Rx
-  double n = WirelessTransmitterPrivate::NEmpty;
-
-  // Looking for obstacles between start and end points
-  this->dataPtr->testRay->SetPoints(start, end);
-  this->dataPtr->testRay->GetIntersection(dist, entityName);
-
   // ToDo: The ray intersects with my own collision model. Fix it.
-  if (entityName != "")
-  {
-    n = WirelessTransmitterPrivate::NObstacle;
-  }
+  double n = _obstructed ? WirelessTransmitterPrivate::NObstacle :
+      WirelessTransmitterPrivate::NEmpty;
 
-  double distance = std::max(1.0,
-      this->referencePose.Pos().Distance(_receiver.Pos()));
+  double distance = std::max(1.0, _distance);
   double x = std::abs(ignition::math::Rand::DblNormal(0.0,
         WirelessTransmitterPrivate::ModelStdDev));
   double wavelength = common::SpeedOfLight / (this->Freq() * 1000000);
@@ -68,6 +68,14 @@ namespace gazebo
       public: double SignalStrength(const ignition::math::Pose3d &_receiver,
           const double _rxGain);
 
+      /// \brief Returns the signal strength for a known line of sight.
+      /// \param[in] _distance Distance between transmitter and receiver.
+      /// \param[in] _obstructed True if there are obstacles between them.
+      /// \param[in] _rxGain Receiver gain value
+      /// \return Signal strength (dBm).
+      private: double SignalStrength(const double _distance,
+          const bool _obstructed, const double _rxGain) const;
+
       /// \brief Get the std dev of the Gaussian random variable used in the
       /// propagation model.
       /// \return The standard deviation of the propagation model.
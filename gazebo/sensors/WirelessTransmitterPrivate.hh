@@ -17,8 +17,15 @@
 #ifndef _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 #define _GAZEBO_SENSORS_WIRELESSTRANSMITTER_PRIVATE_HH_
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+
 #include "gazebo/physics/PhysicsTypes.hh"
+#include "gazebo/sensors/WirelessPropagation.hh"
 
 namespace gazebo
 {
@@ -57,8 +64,18 @@ namespace gazebo
       /// \brief Reception frequency (MHz).
       public: double freq = 2442.0;
 
-      // \brief Ray used to test for collisions when placing entities
-      public: physics::RayShapePtr testRay;
+      /// \brief Line of sight queries, shared by the visualization grid
+      /// and the receivers.
+      public: std::unique_ptr<WirelessPropagation> propagation;
+
+      /// \brief Grid cells within MaxRadius, relative to the transmitter.
+      public: std::vector<ignition::math::Vector3d> gridCells;
+
+      /// \brief World position of each grid cell for the current update.
+      public: std::vector<ignition::math::Vector3d> gridEnds;
+
+      /// \brief Obstruction of each grid cell for the current update.
+      public: std::vector<uint8_t> gridObstructed;
     };
   }
 }
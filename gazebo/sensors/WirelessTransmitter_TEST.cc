@@ -16,6 +16,7 @@
 */
 
 #include <gtest/gtest.h>
+#include "gazebo/sensors/WirelessPropagation.hh"
 #include "gazebo/test/ServerFixture.hh"
 
 using namespace gazebo;
@@ -27,6 +28,7 @@ class WirelessTransmitter_TEST : public ServerFixture
     public: void TestUpdateImpl();
     public: void TestUpdateImplNoVisual();
     public: void TestInvalidFreq();
+    public: void TestPropagationCache();
     private: void TxMsg(const ConstPropagationGridPtr &_msg);
 
     private: std::mutex mutex;
@@ -159,6 +161,57 @@ void WirelessTransmitter_TEST::TestSignalStrength()
   EXPECT_NEAR(signStrengthAvg, -62.0, this->tx->ModelStdDev());
 }
 
+/////////////////////////////////////////////////
+/// \brief Test that line of sight results are cached for static geometry
+void WirelessTransmitter_TEST::TestPropagationCache()
+{
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_NE(nullptr, world);
+
+  sensors::WirelessPropagation propagation(world);
+
+  ignition::math::Vector3d start(0, 0, 0.5);
+  std::vector<ignition::math::Vector3d> ends;
+  for (int i = 0; i < 20; ++i)
+    ends.push_back(ignition::math::Vector3d(i - 10.0, 5, 0.5));
+
+  // Everything in the world is static, rays only need to be cast once
+  std::vector<uint8_t> obstructed;
+  propagation.Obstructed(start, ends, obstructed);
+  ASSERT_EQ(obstructed.size(), ends.size());
+  EXPECT_EQ(propagation.RayCount(), ends.size());
+  EXPECT_EQ(propagation.CacheSize(), ends.size());
+
+  std::vector<uint8_t> cached;
+  propagation.Obstructed(start, ends, cached);
+  EXPECT_EQ(propagation.RayCount(), ends.size());
+  EXPECT_EQ(cached, obstructed);
+
+  // A segment below the ground plane is blocked by static geometry
+  EXPECT_TRUE(propagation.Obstructed(start,
+      ignition::math::Vector3d(0, 5, -1)));
+  EXPECT_TRUE(propagation.Obstructed(start,
+      ignition::math::Vector3d(0, 5, -1)));
+  EXPECT_EQ(propagation.RayCount(), ends.size() + 1);
+
+  // Adding a dynamic box across some segments forces them to be cast again
+  SpawnBox("box", ignition::math::Vector3d(1, 1, 1),
+      ignition::math::Vector3d(0, 5, 0.5), ignition::math::Vector3d::Zero);
+
+  propagation.Obstructed(start, ends, obstructed);
+  EXPECT_TRUE(obstructed[10]);
+  EXPECT_FALSE(obstructed[0]);
+
+  uint64_t rays = propagation.RayCount();
+  propagation.Obstructed(start, ends, cached);
+  EXPECT_EQ(cached, obstructed);
+  EXPECT_GT(propagation.RayCount(), rays);
+  EXPECT_LT(propagation.RayCount(), rays + ends.size());
+
+  propagation.ClearCache();
+  EXPECT_EQ(propagation.CacheSize(), 0u);
+}
+
 /////////////////////////////////////////////////
 /// \brief Callback executed for every propagation grid message received
 void WirelessTransmitter_TEST::TxMsg(const ConstPropagationGridPtr &_msg)
@@ -254,6 +307,12 @@ TEST_F(WirelessTransmitter_TEST, TestSignalStrength)
   TestSignalStrength();
 }
 
+/////////////////////////////////////////////////
+TEST_F(WirelessTransmitter_TEST, TestPropagationCache)
+{
+  TestPropagationCache();
+}
+
 /////////////////////////////////////////////////
 TEST_F(WirelessTransmitter_TEST, TestUpdateImpl)
 {
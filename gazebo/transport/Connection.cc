@@ -49,6 +49,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
@@ -68,6 +73,50 @@ extern void dummy_callback_fn(uint32_t);
 unsigned int Connection::idCounter = 0;
 IOManager *Connection::iomanager = NULL;
 
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \internal
+    /// \brief Traffic counters of a connection.
+    class ConnectionCounters
+    {
+      /// \brief Number of messages written.
+      public: std::atomic<uint64_t> sentCount{0};
+
+      /// \brief Number of bytes written.
+      public: std::atomic<uint64_t> sentBytes{0};
+
+      /// \brief Number of messages read.
+      public: std::atomic<uint64_t> receivedCount{0};
+
+      /// \brief Number of bytes read.
+      public: std::atomic<uint64_t> receivedBytes{0};
+    };
+  }
+}
+
+// TODO declared here for ABI compatibility
+// move to class member variables when merging forward.
+static std::unordered_map<const Connection *,
+    std::unique_ptr<ConnectionCounters>> g_connectionCounters;
+
+/// \brief Protects g_connectionCounters.
+static std::mutex g_connectionCountersMutex;
+
+/////////////////////////////////////////////////
+/// \brief Get the traffic counters of a connection.
+/// \param[in] _connection The connection.
+/// \return The counters, which live as long as the connection.
+static ConnectionCounters &Counters(const Connection *_connection)
+{
+  std::lock_guard<std::mutex> lock(g_connectionCountersMutex);
+  auto &counters = g_connectionCounters[_connection];
+  if (!counters)
+    counters.reset(new ConnectionCounters);
+  return *counters;
+}
+
 // Version 1.52 of boost has an address::is_unspecfied function, but
 // Version 1.46.1 (installed on ubuntu) does not. So this helper function
 // is stolen from adress::is_unspecified function in boost v1.52.
@@ -126,6 +175,11 @@ Connection::~Connection()
 {
   this->Shutdown();
 
+  {
+    std::lock_guard<std::mutex> lock(g_connectionCountersMutex);
+    g_connectionCounters.erase(this);
+  }
+
   if (iomanager)
   {
     iomanager->DecCount();
@@ -306,6 +360,13 @@ void Connection::EnqueueMsg(const std::string &_buffer,
   snprintf(headerBuffer, HEADER_LENGTH + 1, "%08x",
       static_cast<unsigned int>(_buffer.size()));
 
+  {
+    ConnectionCounters &counters = Counters(this);
+    counters.sentCount.fetch_add(1, std::memory_order_relaxed);
+    counters.sentBytes.fetch_add(HEADER_LENGTH + _buffer.size(),
+        std::memory_order_relaxed);
+  }
+
   {
     boost::recursive_mutex::scoped_lock lock(this->writeMutex);
 
@@ -572,6 +633,8 @@ bool Connection::Read(std::string &data)
 
     data = std::string(&incoming[0], incoming.size());
     result = true;
+
+    this->RecordReceived(HEADER_LENGTH + data.size());
   }
 
   return result;
@@ -992,3 +1055,42 @@ std::string Connection::GetIPWhiteList() const
 {
   return this->ipWhiteList;
 }
+
+//////////////////////////////////////////////////
+uint64_t Connection::SentCount() const
+{
+  return Counters(this).sentCount.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::SentBytes() const
+{
+  return Counters(this).sentBytes.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::ReceivedCount() const
+{
+  return Counters(this).receivedCount.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+uint64_t Connection::ReceivedBytes() const
+{
+  return Counters(this).receivedBytes.load(std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void Connection::RecordReceived(const size_t _bytes)
+{
+  ConnectionCounters &counters = Counters(this);
+  counters.receivedCount.fetch_add(1, std::memory_order_relaxed);
+  counters.receivedBytes.fetch_add(_bytes, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+unsigned int Connection::WriteQueueSize()
+{
+  boost::recursive_mutex::scoped_lock lock(this->writeMutex);
+  return this->writeQueue.size();
+}
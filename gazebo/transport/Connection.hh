@@ -305,6 +305,8 @@ namespace gazebo
                                   this->inboundData.size());
                 this->inboundData.clear();
 
+                this->RecordReceived(HEADER_LENGTH + data.size());
+
                 if (data.empty())
                   gzerr << "OnReadData got empty data!!!\n";
 
@@ -343,6 +345,32 @@ namespace gazebo
       /// \return GAZEBO_IP_WHITE_LIST
       public: std::string GetIPWhiteList() const;
 
+      /// \brief Get the number of messages written to the connection.
+      /// \return Number of messages.
+      public: uint64_t SentCount() const;
+
+      /// \brief Get the number of bytes written to the connection,
+      /// headers included.
+      /// \return Number of bytes.
+      public: uint64_t SentBytes() const;
+
+      /// \brief Get the number of messages read from the connection.
+      /// \return Number of messages.
+      public: uint64_t ReceivedCount() const;
+
+      /// \brief Get the number of bytes read from the connection,
+      /// headers included.
+      /// \return Number of bytes.
+      public: uint64_t ReceivedBytes() const;
+
+      /// \brief Get the number of buffers waiting to be written.
+      /// \return Depth of the write queue.
+      public: unsigned int WriteQueueSize();
+
+      /// \brief Count a message read from the connection.
+      /// \param[in] _bytes Size of the message, header included.
+      private: void RecordReceived(const size_t _bytes);
+
       /// \brief Post write.
       /// Called afer a write is finished.
       private: void PostWrite();
@@ -672,6 +672,26 @@ void ConnectionManager::RemoveConnection(ConnectionPtr &_conn)
   }
 }
 
+//////////////////////////////////////////////////
+void ConnectionManager::FillStatistics(msgs::TopicStatistics &_msg)
+{
+  boost::recursive_mutex::scoped_lock lock(this->connectionMutex);
+  for (auto const &conn : this->connections)
+  {
+    if (!conn->IsOpen())
+      continue;
+
+    msgs::TopicStatistics::Connection *connMsg = _msg.add_connection();
+    connMsg->set_local_uri(conn->GetLocalURI());
+    connMsg->set_remote_uri(conn->GetRemoteURI());
+    connMsg->set_sent(conn->SentCount());
+    connMsg->set_sent_bytes(conn->SentBytes());
+    connMsg->set_received(conn->ReceivedCount());
+    connMsg->set_received_bytes(conn->ReceivedBytes());
+    connMsg->set_write_queue_depth(conn->WriteQueueSize());
+  }
+}
+
 //////////////////////////////////////////////////
 ConnectionPtr ConnectionManager::FindConnection(const std::string &_host,
                                                  unsigned int _port)
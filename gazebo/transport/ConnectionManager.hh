@@ -117,6 +117,10 @@ namespace gazebo
       /// \param[in] _conn The connection to be removed
       public: void RemoveConnection(ConnectionPtr &_conn);
 
+      /// \brief Add the statistics of every open connection to a message.
+      /// \param[out] _msg Message to which the connections are added.
+      public: void FillStatistics(msgs::TopicStatistics &_msg);
+
       /// \brief Register a new topic namespace
       /// \param[in] _name The name of the topic namespace to be registered
       public: void RegisterTopicNamespace(const std::string &_name);
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_MESSAGEPOOL_HH_
+#define GAZEBO_TRANSPORT_MESSAGEPOOL_HH_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class MessagePool MessagePool.hh transport/transport.hh
+    /// \brief A small pool of reference counted messages, meant to be used
+    /// with Publisher::PublishShared. A message is handed out again once
+    /// the transport and every local subscriber have released it, so large
+    /// fields such as image data keep their allocation from one
+    /// publication to the next.
+    ///
+    /// A pool must only be used from a single thread.
+    template<typename M>
+    class MessagePool
+    {
+      /// \brief Constructor.
+      /// \param[in] _capacity Maximum number of messages kept in the pool.
+      public: explicit MessagePool(const size_t _capacity = 4)
+              : capacity(_capacity)
+              {
+              }
+
+      /// \brief Get a message that nobody else references. The message
+      /// holds the content of its previous use, so the caller must set
+      /// every field it publishes. When all the pooled messages are in
+      /// use and the pool is full, a new unpooled message is returned.
+      /// \return A message ready to be filled.
+      public: boost::shared_ptr<M> Acquire()
+              {
+                for (auto const &msg : this->messages)
+                {
+                  if (msg.use_count() == 1)
+                    return msg;
+                }
+
+                boost::shared_ptr<M> msg(new M());
+                if (this->messages.size() < this->capacity)
+                  this->messages.push_back(msg);
+                return msg;
+              }
+
+      /// \brief Get the number of messages owned by the pool.
+      /// \return Number of pooled messages.
+      public: size_t Size() const
+              {
+                return this->messages.size();
+              }
+
+      /// \brief Pooled messages.
+      private: std::vector<boost::shared_ptr<M>> messages;
+
+      /// \brief Maximum number of pooled messages.
+      private: size_t capacity;
+    };
+    /// \}
+  }
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/MessagePool.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class MessagePool_TEST : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(MessagePool_TEST, Acquire)
+{
+  transport::MessagePool<msgs::ImageStamped> pool(2);
+  EXPECT_EQ(pool.Size(), 0u);
+
+  // A released message is handed out again, with its data allocation.
+  const msgs::ImageStamped *first;
+  {
+    auto msg = pool.Acquire();
+    msg->mutable_image()->mutable_data()->assign(1024, 'a');
+    first = msg.get();
+  }
+  EXPECT_EQ(pool.Size(), 1u);
+
+  auto msg1 = pool.Acquire();
+  EXPECT_EQ(msg1.get(), first);
+  EXPECT_EQ(msg1->image().data().size(), 1024u);
+
+  // Messages still referenced are not reused.
+  auto msg2 = pool.Acquire();
+  EXPECT_NE(msg2.get(), msg1.get());
+  EXPECT_EQ(pool.Size(), 2u);
+
+  // A full pool returns unpooled messages.
+  auto msg3 = pool.Acquire();
+  EXPECT_NE(msg3.get(), msg1.get());
+  EXPECT_NE(msg3.get(), msg2.get());
+  EXPECT_EQ(pool.Size(), 2u);
+
+  msg2.reset();
+  auto msg4 = pool.Acquire();
+  EXPECT_NE(msg4.get(), msg1.get());
+  EXPECT_NE(msg4.get(), msg3.get());
+  EXPECT_EQ(pool.Size(), 2u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,12 @@
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "gazebo/common/Time.hh"
 #include "gazebo/common/WeakBind.hh"
 #include "SubscriptionTransport.hh"
 #include "Publication.hh"
@@ -28,6 +34,14 @@ using namespace transport;
 extern void dummy_callback_fn(uint32_t);
 unsigned int Publication::idCounter = 0;
 
+// TODO declared here for ABI compatibility
+// move to a class member variable when merging forward.
+static std::unordered_map<const Publication *,
+    std::unique_ptr<TopicStatistics>> g_publicationStatistics;
+
+/// \brief Protects g_publicationStatistics.
+static std::mutex g_publicationStatisticsMutex;
+
 //////////////////////////////////////////////////
 Publication::Publication(const std::string &_topic, const std::string &_msgType)
   : topic(_topic), msgType(_msgType), locallyAdvertised(false)
@@ -38,6 +52,11 @@ Publication::Publication(const std::string &_topic, const std::string &_msgType)
 //////////////////////////////////////////////////
 Publication::~Publication()
 {
+  {
+    std::lock_guard<std::mutex> lock(g_publicationStatisticsMutex);
+    g_publicationStatistics.erase(this);
+  }
+
   boost::mutex::scoped_lock lock(this->callbackMutex);
   this->publishers.clear();
 }
@@ -247,6 +266,8 @@ void Publication::RemoveSubscription(const std::string &_host,
 //////////////////////////////////////////////////
 void Publication::LocalPublish(const std::string &_data)
 {
+  this->statistics.RecordReceive(_data.size());
+
   std::list<NodePtr>::iterator iter, endIter;
 
   {
@@ -320,7 +341,10 @@ int Publication::Publish(MessagePtr _msg, boost::function<void(uint32_t)> _cb,
     if (!this->callbacks.empty())
     {
       std::string data;
+      common::Time start = common::Time::GetWallTime();
       _msg->SerializeToString(&data);
+      this->statistics.RecordSerialize(data.size(),
+          (common::Time::GetWallTime() - start).Double());
       std::list<CallbackHelperPtr>::iterator cbIter;
       cbIter = this->callbacks.begin();
 
@@ -524,3 +548,12 @@ MessagePtr Publication::GetPrevMsg(uint32_t _pubId)
     return MessagePtr();
 }
 
+//////////////////////////////////////////////////
+TopicStatistics &Publication::Statistics()
+{
+  std::lock_guard<std::mutex> lock(g_publicationStatisticsMutex);
+  auto &statistics = g_publicationStatistics[this];
+  if (!statistics)
+    statistics.reset(new TopicStatistics);
+  return *statistics;
+}
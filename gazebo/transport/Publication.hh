@@ -30,6 +30,7 @@
 #include "gazebo/transport/CallbackHelper.hh"
 #include "gazebo/transport/TransportTypes.hh"
 #include "gazebo/transport/PublicationTransport.hh"
+#include "gazebo/transport/TopicStatistics.hh"
 #include "gazebo/util/system.hh"
 
 namespace gazebo
@@ -164,6 +165,11 @@ namespace gazebo
       /// \param[in,out] _pub Pointer to publisher object to be added
       public: void AddPublisher(PublisherPtr _pub);
 
+      /// \brief Get the traffic statistics of the topic.
+      /// \return Statistics shared by all the publishers and subscribers
+      /// of the topic in this process.
+      public: TopicStatistics &Statistics();
+
       /// \brief Remove nodes that have been marked for removal
       private: void RemoveNodes();
 
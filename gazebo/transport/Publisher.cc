@@ -19,6 +19,10 @@
  */
 #include <boost/bind.hpp>
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 #include <ignition/math/Helpers.hh>
 
 #include "gazebo/common/Exception.hh"
@@ -32,6 +36,26 @@ using namespace transport;
 
 uint32_t Publisher::idCounter = 0;
 
+// TODO declared here for ABI compatibility
+// move to a class member variable when merging forward.
+/// \brief Time at which each queued message of a publisher was published.
+/// The lists are guarded by the mutex of their publisher.
+static std::unordered_map<const Publisher *, std::list<common::Time>>
+    g_publishTimes;
+
+/// \brief Protects the g_publishTimes map, not the lists.
+static std::mutex g_publishTimesMutex;
+
+/////////////////////////////////////////////////
+/// \brief Get the publish times of the queued messages of a publisher.
+/// \param[in] _publisher The publisher.
+/// \return The publish times, which live as long as the publisher.
+static std::list<common::Time> &PublishTimes(const Publisher *_publisher)
+{
+  std::lock_guard<std::mutex> lock(g_publishTimesMutex);
+  return g_publishTimes[_publisher];
+}
+
 //////////////////////////////////////////////////
 Publisher::Publisher(const std::string &_topic, const std::string &_msgType,
                      unsigned int _limit, double _hzRate)
@@ -50,6 +74,9 @@ Publisher::Publisher(const std::string &_topic, const std::string &_msgType,
 Publisher::~Publisher()
 {
   this->Fini();
+
+  std::lock_guard<std::mutex> lock(g_publishTimesMutex);
+  g_publishTimes.erase(this);
 }
 
 //////////////////////////////////////////////////
@@ -86,6 +113,28 @@ bool Publisher::WaitForConnection(const common::Time &_timeout) const
 //////////////////////////////////////////////////
 void Publisher::PublishImpl(const google::protobuf::Message &_message,
                             bool _block)
+{
+  if (!this->AcceptMessage(_message))
+    return;
+
+  // Save the latest message
+  MessagePtr msgPtr(_message.New());
+  msgPtr->CopyFrom(_message);
+
+  this->EnqueueMessage(msgPtr, _block);
+}
+
+//////////////////////////////////////////////////
+void Publisher::PublishShared(MessagePtr _message, bool _block)
+{
+  if (!_message || !this->AcceptMessage(*_message))
+    return;
+
+  this->EnqueueMessage(_message, _block);
+}
+
+//////////////////////////////////////////////////
+bool Publisher::AcceptMessage(const google::protobuf::Message &_message)
 {
   if (_message.GetTypeName() != this->msgType)
     gzthrow("Invalid message type\n");
@@ -95,7 +144,7 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
     gzerr << "Publishing an uninitialized message on topic[" <<
       this->topic << "]. Required field [" <<
       _message.InitializationErrorString() << "] missing.\n";
-    return;
+    return false;
   }
 
   // Check if a throttling rate has been set
@@ -109,27 +158,33 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
         (this->currentTime - this->prevPublishTime).Double() <
         this->updatePeriod)
     {
-      return;
+      return false;
     }
 
     // Set the previous time a message was published
     this->prevPublishTime = this->currentTime;
   }
 
-  // Save the latest message
-  MessagePtr msgPtr(_message.New());
-  msgPtr->CopyFrom(_message);
+  return true;
+}
 
-  this->publication->SetPrevMsg(this->id, msgPtr);
+//////////////////////////////////////////////////
+void Publisher::EnqueueMessage(MessagePtr _message, bool _block)
+{
+  this->publication->SetPrevMsg(this->id, _message);
 
   {
     boost::mutex::scoped_lock lock(this->mutex);
 
-    this->messages.push_back(msgPtr);
+    std::list<common::Time> &publishTimes = PublishTimes(this);
+    this->messages.push_back(_message);
+    publishTimes.push_back(common::Time::GetWallTime());
 
     if (this->messages.size() > this->queueLimit)
     {
       this->messages.pop_front();
+      publishTimes.pop_front();
+      this->publication->Statistics().RecordDrop();
 
       if (!queueLimitWarned)
       {
@@ -140,6 +195,8 @@ void Publisher::PublishImpl(const google::protobuf::Message &_message,
         queueLimitWarned = true;
       }
     }
+
+    this->publication->Statistics().RecordPublish(this->messages.size());
   }
 
   TopicManager::Instance()->AddNodeToProcess(this->node);
@@ -160,6 +217,7 @@ void Publisher::SendMessage()
 {
   std::list<MessagePtr> localBuffer;
   std::list<uint32_t> localIds;
+  std::list<common::Time> localTimes;
 
   {
     boost::mutex::scoped_lock lock(this->mutex);
@@ -175,19 +233,19 @@ void Publisher::SendMessage()
       localIds.push_back(this->pubId);
     }
 
-    std::copy(this->messages.begin(), this->messages.end(),
-        std::back_inserter(localBuffer));
-    this->messages.clear();
+    localBuffer.swap(this->messages);
+    localTimes.swap(PublishTimes(this));
   }
 
   // Only send messages if there is something to send
   if (!localBuffer.empty())
   {
     std::list<uint32_t>::iterator pubIter = localIds.begin();
+    std::list<common::Time>::iterator timeIter = localTimes.begin();
 
     // Send all the current messages
     for (std::list<MessagePtr>::iterator iter = localBuffer.begin();
-        iter != localBuffer.end(); ++iter, ++pubIter)
+        iter != localBuffer.end(); ++iter, ++pubIter, ++timeIter)
     {
       // Expected number of calls to the callback function
       // Publisher::OnPublishComplete() triggered by subscriber callbacks.
@@ -216,6 +274,9 @@ void Publisher::SendMessage()
           common::weakBind(&Publisher::OnPublishComplete,
               this->shared_from_this(), _1), *pubIter);
 
+      this->publication->Statistics().RecordLatency(
+          (common::Time::GetWallTime() - *timeIter).Double());
+
       // It is possible that OnPublishComplete() was called less times than
       // initially expected, which happens when a callback of the
       // transport::Publication was found invalid and deleted. In this case
@@ -319,6 +380,10 @@ void Publisher::Fini()
   if (!this->messages.empty())
     this->SendMessage();
   this->messages.clear();
+  {
+    boost::mutex::scoped_lock lock(this->mutex);
+    PublishTimes(this).clear();
+  }
 
   if (!this->topic.empty())
     TopicManager::Instance()->Unadvertise(this->topic, this->id);
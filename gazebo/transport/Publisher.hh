@@ -101,6 +101,16 @@ namespace gazebo
               void Publish(M _message, bool _block = false)
               { this->PublishImpl(_message, _block); }
 
+      /// \brief Publish a message without copying it. The publisher keeps
+      /// a reference to the message until it has been delivered, and local
+      /// subscribers receive the same message. The caller must not modify
+      /// the message after this call; see MessagePool for a way to reuse
+      /// messages once the transport has released them.
+      /// \param[in] _message Message to be published
+      /// \param[in] _block Whether to block until the message is actually
+      /// written into the local message buffer, and SendMessage() is called.
+      public: void PublishShared(MessagePtr _message, bool _block = false);
+
       /// \brief Get the number of outgoing messages
       /// \return The number of outgoing messages
       public: unsigned int GetOutgoingCount() const;
@@ -147,6 +157,19 @@ namespace gazebo
       private: void PublishImpl(const google::protobuf::Message &_message,
                                 bool _block);
 
+      /// \brief Check whether a message can be published now. Rejects
+      /// messages of the wrong type, uninitialized messages and messages
+      /// that arrive faster than the update rate.
+      /// \param[in] _message Message to be published.
+      /// \return True if the message should be published.
+      private: bool AcceptMessage(const google::protobuf::Message &_message);
+
+      /// \brief Queue a message for publication.
+      /// \param[in] _message Message to be published.
+      /// \param[in] _block Whether to block until the message is actually
+      /// written out.
+      private: void EnqueueMessage(MessagePtr _message, bool _block);
+
       /// \brief Callback when a publish is completed
       /// \param[in] _id ID associated with the publication.
       private: void OnPublishComplete(uint32_t _id);
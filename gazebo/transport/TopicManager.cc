@@ -453,3 +453,15 @@ void TopicManager::PauseIncoming(bool _pause)
 {
   this->pauseIncoming = _pause;
 }
+
+//////////////////////////////////////////////////
+void TopicManager::FillStatistics(msgs::TopicStatistics &_msg)
+{
+  for (auto const &publication : this->advertisedTopics)
+  {
+    msgs::TopicStatistics::Topic *topicMsg = _msg.add_topic();
+    topicMsg->set_topic(publication.first);
+    topicMsg->set_msg_type(publication.second->GetMsgType());
+    publication.second->Statistics().Fill(*topicMsg);
+  }
+}
@@ -240,6 +240,11 @@ namespace gazebo
       /// \param[in] _ptr Node to process.
       public: void AddNodeToProcess(NodePtr _ptr);
 
+      /// \brief Add the statistics of every topic of this process to a
+      /// message.
+      /// \param[out] _msg Message to which the topics are added.
+      public: void FillStatistics(msgs::TopicStatistics &_msg);
+
       /// \brief A map of string->list of Node pointers
       typedef std::map<std::string, std::list<NodePtr> > SubNodeMap;
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "gazebo/transport/TopicStatistics.hh"
+
+using namespace gazebo;
+using namespace transport;
+
+const unsigned int TopicStatistics::kLatencyBuckets;
+
+//////////////////////////////////////////////////
+TopicStatistics::TopicStatistics()
+  : published(0), sentBytes(0), received(0), receivedBytes(0), dropped(0),
+    queueDepth(0), maxQueueDepth(0), serializeNsec(0)
+{
+  for (auto &bucket : this->latency)
+    bucket = 0;
+}
+
+//////////////////////////////////////////////////
+void TopicStatistics::RecordPublish(const size_t _queueDepth)
+{
+  this->published.fetch_add(1, std::memory_order_relaxed);
+
+  const uint32_t depth = static_cast<uint32_t>(_queueDepth);
+  this->queueDepth.store(depth, std::memory_order_relaxed);
+
+  uint32_t max = this->maxQueueDepth.load(std::memory_order_relaxed);
+  while (depth > max &&
+      !this->maxQueueDepth.compare_exchange_weak(max, depth,
+        std::memory_order_relaxed))
+  {
+  }
+}
+
+//////////////////////////////////////////////////
+void TopicStatistics::RecordDrop()
+{
+  this->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void TopicStatistics::RecordSerialize(const size_t _bytes,
+    const double _seconds)
+{
+  this->sentBytes.fetch_add(_bytes, std::memory_order_relaxed);
+  this->serializeNsec.fetch_add(static_cast<uint64_t>(_seconds * 1e9),
+      std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void TopicStatistics::RecordReceive(const size_t _bytes)
+{
+  this->received.fetch_add(1, std::memory_order_relaxed);
+  this->receivedBytes.fetch_add(_bytes, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+void TopicStatistics::RecordLatency(const double _seconds)
+{
+  this->latency[LatencyBucket(_seconds)].fetch_add(1,
+      std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////
+unsigned int TopicStatistics::LatencyBucket(const double _seconds)
+{
+  // Bucket i holds [2^(i-1), 2^i) microseconds.
+  double usec = _seconds * 1e6;
+  unsigned int bucket = 0;
+  while (usec >= 1.0 && bucket < kLatencyBuckets - 1)
+  {
+    usec *= 0.5;
+    ++bucket;
+  }
+  return bucket;
+}
+
+//////////////////////////////////////////////////
+void TopicStatistics::Fill(msgs::TopicStatistics::Topic &_msg) const
+{
+  _msg.set_published(this->published.load(std::memory_order_relaxed));
+  _msg.set_sent_bytes(this->sentBytes.load(std::memory_order_relaxed));
+  _msg.set_received(this->received.load(std::memory_order_relaxed));
+  _msg.set_received_bytes(
+      this->receivedBytes.load(std::memory_order_relaxed));
+  _msg.set_dropped(this->dropped.load(std::memory_order_relaxed));
+  _msg.set_queue_depth(this->queueDepth.load(std::memory_order_relaxed));
+  _msg.set_max_queue_depth(
+      this->maxQueueDepth.load(std::memory_order_relaxed));
+  _msg.set_serialize_time(
+      this->serializeNsec.load(std::memory_order_relaxed) * 1e-9);
+
+  _msg.clear_latency();
+  for (auto const &bucket : this->latency)
+    _msg.add_latency(bucket.load(std::memory_order_relaxed));
+}
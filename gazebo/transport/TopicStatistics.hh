@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef GAZEBO_TRANSPORT_TOPICSTATISTICS_HH_
+#define GAZEBO_TRANSPORT_TOPICSTATISTICS_HH_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/util/system.hh"
+
+namespace gazebo
+{
+  namespace transport
+  {
+    /// \addtogroup gazebo_transport
+    /// \{
+
+    /// \class TopicStatistics TopicStatistics.hh transport/transport.hh
+    /// \brief Counters of the traffic on a topic. Every counter is an
+    /// atomic that is only ever incremented or overwritten, so that the
+    /// publishers, the subscribers and the readers of the statistics never
+    /// wait on each other.
+    class GZ_TRANSPORT_VISIBLE TopicStatistics
+    {
+      /// \brief Number of buckets of the latency histogram.
+      public: static const unsigned int kLatencyBuckets = 16;
+
+      /// \brief Constructor.
+      public: TopicStatistics();
+
+      /// \brief Record a message accepted by a publisher.
+      /// \param[in] _queueDepth Depth of the publisher queue after the
+      /// message was added.
+      public: void RecordPublish(const size_t _queueDepth);
+
+      /// \brief Record a message dropped because a publisher queue was full.
+      public: void RecordDrop();
+
+      /// \brief Record the serialization of a message for remote
+      /// subscribers.
+      /// \param[in] _bytes Size of the serialized message.
+      /// \param[in] _seconds Time spent serializing.
+      public: void RecordSerialize(const size_t _bytes, const double _seconds);
+
+      /// \brief Record a message received from a remote publisher.
+      /// \param[in] _bytes Size of the serialized message.
+      public: void RecordReceive(const size_t _bytes);
+
+      /// \brief Record the time between a call to Publish and the dispatch
+      /// of the message to the subscribers.
+      /// \param[in] _seconds Latency in seconds.
+      public: void RecordLatency(const double _seconds);
+
+      /// \brief Get the bucket of the latency histogram for a latency.
+      /// \param[in] _seconds Latency in seconds.
+      /// \return Index of the bucket.
+      public: static unsigned int LatencyBucket(const double _seconds);
+
+      /// \brief Copy the counters to a message.
+      /// \param[out] _msg Message to fill. The topic name and message type
+      /// are left untouched.
+      public: void Fill(msgs::TopicStatistics::Topic &_msg) const;
+
+      /// \brief Number of published messages.
+      private: std::atomic<uint64_t> published;
+
+      /// \brief Number of bytes serialized for remote subscribers.
+      private: std::atomic<uint64_t> sentBytes;
+
+      /// \brief Number of messages received from remote publishers.
+      private: std::atomic<uint64_t> received;
+
+      /// \brief Number of bytes received from remote publishers.
+      private: std::atomic<uint64_t> receivedBytes;
+
+      /// \brief Number of dropped messages.
+      private: std::atomic<uint64_t> dropped;
+
+      /// \brief Last publisher queue depth.
+      private: std::atomic<uint32_t> queueDepth;
+
+      /// \brief Largest publisher queue depth.
+      private: std::atomic<uint32_t> maxQueueDepth;
+
+      /// \brief Time spent serializing, in nanoseconds.
+      private: std::atomic<uint64_t> serializeNsec;
+
+      /// \brief Latency histogram.
+      private: std::array<std::atomic<uint64_t>, kLatencyBuckets> latency;
+    };
+    /// \}
+  }
+}
+#endif
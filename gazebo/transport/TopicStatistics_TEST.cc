@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "gazebo/msgs/msgs.hh"
+#include "gazebo/transport/TopicStatistics.hh"
+#include "test/util.hh"
+
+using namespace gazebo;
+
+class TopicStatistics_TEST : public gazebo::testing::AutoLogFixture { };
+
+/////////////////////////////////////////////////
+TEST_F(TopicStatistics_TEST, Counters)
+{
+  transport::TopicStatistics stats;
+
+  msgs::TopicStatistics::Topic msg;
+  stats.Fill(msg);
+  EXPECT_EQ(msg.published(), 0u);
+  EXPECT_EQ(msg.dropped(), 0u);
+  EXPECT_EQ(msg.latency_size(),
+      static_cast<int>(transport::TopicStatistics::kLatencyBuckets));
+
+  stats.RecordPublish(1);
+  stats.RecordPublish(3);
+  stats.RecordPublish(2);
+  stats.RecordDrop();
+  stats.RecordSerialize(100, 0.5);
+  stats.RecordSerialize(50, 0.25);
+  stats.RecordReceive(10);
+
+  stats.Fill(msg);
+  EXPECT_EQ(msg.published(), 3u);
+  EXPECT_EQ(msg.dropped(), 1u);
+  EXPECT_EQ(msg.queue_depth(), 2u);
+  EXPECT_EQ(msg.max_queue_depth(), 3u);
+  EXPECT_EQ(msg.sent_bytes(), 150u);
+  EXPECT_NEAR(msg.serialize_time(), 0.75, 1e-9);
+  EXPECT_EQ(msg.received(), 1u);
+  EXPECT_EQ(msg.received_bytes(), 10u);
+}
+
+/////////////////////////////////////////////////
+TEST_F(TopicStatistics_TEST, Latency)
+{
+  EXPECT_EQ(transport::TopicStatistics::LatencyBucket(0), 0u);
+  EXPECT_EQ(transport::TopicStatistics::LatencyBucket(0.5e-6), 0u);
+  EXPECT_EQ(transport::TopicStatistics::LatencyBucket(1e-6), 1u);
+  EXPECT_EQ(transport::TopicStatistics::LatencyBucket(3e-6), 2u);
+  EXPECT_EQ(transport::TopicStatistics::LatencyBucket(1000),
+      transport::TopicStatistics::kLatencyBuckets - 1);
+
+  transport::TopicStatistics stats;
+  stats.RecordLatency(3e-6);
+  stats.RecordLatency(3.5e-6);
+  stats.RecordLatency(1000);
+
+  msgs::TopicStatistics::Topic msg;
+  stats.Fill(msg);
+  EXPECT_EQ(msg.latency(2), 2u);
+  EXPECT_EQ(msg.latency(transport::TopicStatistics::kLatencyBuckets - 1), 1u);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
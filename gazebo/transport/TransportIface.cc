@@ -346,6 +346,15 @@ std::string transport::getTopicMsgType(const std::string &_topicName)
   return result;
 }
 
+/////////////////////////////////////////////////
+void transport::getStatistics(msgs::TopicStatistics &_msg)
+{
+  _msg.Clear();
+  msgs::Set(_msg.mutable_stamp(), common::Time::GetWallTime());
+  TopicManager::Instance()->FillStatistics(_msg);
+  ConnectionManager::Instance()->FillStatistics(_msg);
+}
+
 /////////////////////////////////////////////////
 void transport::setMinimalComms(bool _enabled)
 {
@@ -162,6 +162,13 @@ namespace gazebo
     GZ_TRANSPORT_VISIBLE
     std::string getTopicMsgType(const std::string &_topicName);
 
+    /// \brief Get the transport statistics of this process: the counters
+    /// of every topic advertised or subscribed in the process, and of
+    /// every connection to another process.
+    /// \param[out] _msg Message filled with the statistics.
+    GZ_TRANSPORT_VISIBLE
+    void getStatistics(msgs::TopicStatistics &_msg);
+
     /// \brief Set whether minimal comms should be used. This will be used
     /// to reduce network traffic.
     GZ_TRANSPORT_VISIBLE
@@ -15,14 +15,53 @@
  *
 */
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include "gazebo/common/Assert.hh"
 #include "gazebo/common/Events.hh"
+#include "gazebo/physics/Hydrostatics.hh"
 #include "plugins/BuoyancyPlugin.hh"
 
 using namespace gazebo;
 
 GZ_REGISTER_MODEL_PLUGIN(BuoyancyPlugin)
 
+namespace gazebo
+{
+  /// \internal
+  /// \brief Waterline state of a BuoyancyPlugin.
+  class BuoyancyPluginHydrostatics
+  {
+    /// \brief Hydrostatics of the world, null without <waterline>.
+    public: std::shared_ptr<physics::Hydrostatics> hydrostatics;
+
+    /// \brief Links whose buoyancy is computed by hydrostatics, by ID.
+    public: std::map<int, physics::LinkPtr> links;
+  };
+}
+
+// TODO declared here for ABI compatibility
+// move to class member variable(s) when merging forward.
+static std::unordered_map<const BuoyancyPlugin *,
+    std::unique_ptr<BuoyancyPluginHydrostatics>> g_buoyancyHydrostatics;
+static std::mutex g_buoyancyHydrostaticsMutex;
+
+/////////////////////////////////////////////////
+/// \brief Get the waterline state of a plugin, created on first use.
+/// \param[in] _plugin The plugin.
+/// \return The waterline state.
+static BuoyancyPluginHydrostatics &Waterline(const BuoyancyPlugin *_plugin)
+{
+  std::lock_guard<std::mutex> lock(g_buoyancyHydrostaticsMutex);
+  auto &data = g_buoyancyHydrostatics[_plugin];
+  if (!data)
+    data.reset(new BuoyancyPluginHydrostatics);
+  return *data;
+}
+
 /////////////////////////////////////////////////
 BuoyancyPlugin::BuoyancyPlugin()
   // Density of liquid water at 1 atm pressure and 15 degrees Celsius.
@@ -30,6 +69,24 @@ BuoyancyPlugin::BuoyancyPlugin()
 {
 }
 
+/////////////////////////////////////////////////
+BuoyancyPlugin::~BuoyancyPlugin()
+{
+  this->updateConnection.reset();
+
+  // The model clears its links before its plugins, so use the links kept
+  // at registration.
+  auto &water = Waterline(this);
+  if (water.hydrostatics)
+  {
+    for (auto const &link : water.links)
+      water.hydrostatics->RemoveLink(link.second);
+  }
+
+  std::lock_guard<std::mutex> lock(g_buoyancyHydrostaticsMutex);
+  g_buoyancyHydrostatics.erase(this);
+}
+
 /////////////////////////////////////////////////
 void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
 {
@@ -117,6 +174,26 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
     }
   }
 
+  auto &water = Waterline(this);
+  if (this->sdf->HasElement("waterline"))
+  {
+    sdf::ElementPtr waterElem = this->sdf->GetElement("waterline");
+    water.hydrostatics = physics::Hydrostatics::ForWorld(world);
+    if (waterElem->HasElement("level"))
+      water.hydrostatics->SetWaterLevel(waterElem->Get<double>("level"));
+    if (waterElem->HasElement("wave"))
+    {
+      sdf::ElementPtr waveElem = waterElem->GetElement("wave");
+      water.hydrostatics->SetWave(
+          waveElem->Get<double>("amplitude"),
+          waveElem->Get<double>("wavelength"),
+          waveElem->Get<double>("period"),
+          waveElem->HasElement("direction") ?
+          waveElem->Get<ignition::math::Vector2d>("direction") :
+          ignition::math::Vector2d(1, 0));
+    }
+  }
+
   // For links the user didn't input, precompute the center of volume and
   // density. This will be accurate for simple shapes.
   for (auto link : this->model->GetLinks())
@@ -124,6 +201,14 @@ void BuoyancyPlugin::Load(physics::ModelPtr _model, sdf::ElementPtr _sdf)
     int id = link->GetId();
     if (this->volPropsMap.find(id) == this->volPropsMap.end())
     {
+      // Waterline accurate buoyancy, applied by the world hydrostatics
+      if (water.hydrostatics &&
+          water.hydrostatics->AddLink(link, this->fluidDensity))
+      {
+        water.links[id] = link;
+        continue;
+      }
+
       double volumeSum = 0;
       ignition::math::Vector3d weightedPosSum = ignition::math::Vector3d::Zero;
 
@@ -153,8 +238,12 @@ void BuoyancyPlugin::Init()
 /////////////////////////////////////////////////
 void BuoyancyPlugin::OnUpdate()
 {
+  auto const &hydrostaticLinks = Waterline(this).links;
   for (auto link : this->model->GetLinks())
   {
+    if (hydrostaticLinks.count(link->GetId()))
+      continue;
+
     VolumeProperties volumeProperties = this->volPropsMap[link->GetId()];
     double volume = volumeProperties.volume;
     GZ_ASSERT(volume > 0, "Nonpositive volume found in volume properties!");
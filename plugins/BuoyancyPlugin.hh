@@ -57,11 +57,31 @@ namespace gazebo
   /// to compute these properties from the link collision shapes. This
   /// computation will not be accurate if the object is not composed of simple
   /// collision shapes.
+  /// <waterline> makes the buoyancy depend on how deep the links are in
+  /// the water. Links without <center_of_volume> and <volume> are clipped
+  /// against the water surface at every step, using a triangle mesh of
+  /// their box, sphere, cylinder and mesh collisions, see
+  /// physics::Hydrostatics. Without it, links are always fully submerged.
+  /// The water surface is shared by all the models of the world.
+  /// <waterline>
+  ///   <level>0</level>
+  ///   <wave>
+  ///     <amplitude>0.2</amplitude>
+  ///     <wavelength>20</wavelength>
+  ///     <period>5</period>
+  ///     <direction>1 0</direction>
+  ///   </wave>
+  /// </waterline>
+  /// <level> Height of the calm water surface, defaults to 0.
+  /// <wave> Optional sinusoidal wave on the water surface.
   class GZ_PLUGIN_VISIBLE BuoyancyPlugin : public ModelPlugin
   {
     /// \brief Constructor.
     public: BuoyancyPlugin();
 
+    /// \brief Destructor.
+    public: virtual ~BuoyancyPlugin();
+
     /// \brief Read the model SDF to compute volume and center of volume for
     /// each link, and store those properties in volPropsMap.
     public: virtual void Load(physics::ModelPtr _model, sdf::ElementPtr _sdf);
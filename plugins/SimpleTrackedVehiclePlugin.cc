@@ -16,12 +16,15 @@
 */
 
 #include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include <ignition/math/Vector3.hh>
 #include <ignition/math/Pose3.hh>
 
-// OpenDE private definitions; unfortunately, we need them
+// OpenDE private definitions, used by the deprecated ContactIterator
 #include "joints/contact.h"
 
 #include "gazebo/common/Assert.hh"
@@ -45,6 +48,58 @@ using namespace physics;
 /// \brief This is a temporary workaround to keep ABI compatibility in
 /// Gazebo 9. It should be deleted starting with Gazebo 10.
 unordered_map<LinkPtr, unordered_map<Tracks, Link_V> > globalTracks;
+
+/// \internal
+/// \brief Desired motion of the vehicle during the current update, read
+/// by the contact surface callbacks of the tracks.
+class SimpleTrackedVehicleDrive
+{
+  /// \brief Collisions of the tracks with a contact surface callback.
+  public: Collision_V trackCollisions;
+
+  /// \brief Speed of the left belt.
+  public: double leftBeltSpeed = 0;
+
+  /// \brief Speed of the right belt.
+  public: double rightBeltSpeed = 0;
+
+  /// \brief Linear speed of the vehicle.
+  public: double linearSpeed = 0;
+
+  /// \brief Angular speed of the vehicle.
+  public: double angularSpeed = 0;
+
+  /// \brief Whether the vehicle drives straight.
+  public: bool drivingStraight = true;
+
+  /// \brief Pose of the vehicle body.
+  public: ignition::math::Pose3d bodyPose;
+
+  /// \brief Direction of the y-axis of the body in world frame.
+  public: ignition::math::Vector3d bodyYAxisGlobal;
+
+  /// \brief Center of the circle the vehicle follows.
+  public: ignition::math::Vector3d centerOfRotation;
+};
+
+// TODO declared here for ABI compatibility
+// move to class member variable(s) when merging forward.
+static unordered_map<const SimpleTrackedVehiclePlugin *,
+    unique_ptr<SimpleTrackedVehicleDrive>> g_simpleTrackedVehicleDrives;
+static mutex g_simpleTrackedVehicleDrivesMutex;
+
+/// \brief Get the drive state of a plugin, created on first use.
+/// \param[in] _plugin The plugin.
+/// \return The drive state.
+static SimpleTrackedVehicleDrive &Drive(
+    const SimpleTrackedVehiclePlugin *_plugin)
+{
+  lock_guard<mutex> lock(g_simpleTrackedVehicleDrivesMutex);
+  auto &drive = g_simpleTrackedVehicleDrives[_plugin];
+  if (!drive)
+    drive.reset(new SimpleTrackedVehicleDrive);
+  return *drive;
+}
 }
 
 using namespace gazebo;
@@ -53,6 +108,16 @@ GZ_REGISTER_MODEL_PLUGIN(SimpleTrackedVehiclePlugin)
 
 SimpleTrackedVehiclePlugin::~SimpleTrackedVehiclePlugin()
 {
+  this->beforePhysicsUpdateConnection.reset();
+
+  for (auto const &collision : Drive(this).trackCollisions)
+    collision->SetContactSurfaceFunc(nullptr);
+
+  {
+    std::lock_guard<std::mutex> lock(g_simpleTrackedVehicleDrivesMutex);
+    g_simpleTrackedVehicleDrives.erase(this);
+  }
+
   if (this->body != nullptr)
   {
     if (globalTracks.find(this->body) != globalTracks.end())
@@ -198,14 +263,27 @@ void SimpleTrackedVehiclePlugin::Init()
 
   physics::ModelPtr model = this->body->GetModel();
 
-  this->contactManager = model->GetWorld()->Physics()->GetContactManager();
-  // otherwise contact manager would not publish any contacts (since we are not
-  // a real contact subscriber)
-  this->contactManager->SetNeverDropContacts(true);
-
   // set correct categories and collide bitmasks
   this->SetGeomCategories();
 
+  // edit the contacts of the tracks when their contact joints are created
+  auto &trackCollisions = Drive(this).trackCollisions;
+  auto& gtracks = globalTracks.at(this->body);
+  for (auto trackSide : gtracks)
+  {
+    for (auto trackLink : trackSide.second)
+    {
+      for (auto const &collision : trackLink->GetCollisions())
+      {
+        collision->SetContactSurfaceFunc(
+            std::bind(&SimpleTrackedVehiclePlugin::OnTrackContact, this,
+                      trackSide.first, collision.get(),
+                      std::placeholders::_1));
+        trackCollisions.push_back(collision);
+      }
+    }
+  }
+
   // set the desired friction to tracks (override the values set in the
   // SDF model)
   this->UpdateTrackSurface();
@@ -214,8 +292,9 @@ void SimpleTrackedVehiclePlugin::Init()
   this->node = transport::NodePtr(new transport::Node());
   this->node->Init(model->GetWorld()->Name());
 
+  // only this world's updates, worlds may be stepped in parallel
   this->beforePhysicsUpdateConnection =
-      event::Events::ConnectBeforePhysicsUpdate(
+      model->GetWorld()->ConnectWorldUpdateBegin(
           std::bind(&SimpleTrackedVehiclePlugin::DriveTracks, this,
                     std::placeholders::_1));
 }
@@ -297,26 +376,28 @@ size_t SimpleTrackedVehiclePlugin::GetNumTracks(const Tracks side) const
 void SimpleTrackedVehiclePlugin::DriveTracks(
     const common::UpdateInfo &/*_unused*/)
 {
-  if (this->contactManager->GetContactCount() == 0)
-    return;
+  auto &drive = Drive(this);
 
   /////////////////////////////////////////////
   // Calculate the desired center of rotation
   /////////////////////////////////////////////
 
-  const auto leftBeltSpeed = -this->trackVelocity[Tracks::LEFT];
-  const auto rightBeltSpeed = -this->trackVelocity[Tracks::RIGHT];
+  drive.leftBeltSpeed = -this->trackVelocity[Tracks::LEFT];
+  drive.rightBeltSpeed = -this->trackVelocity[Tracks::RIGHT];
 
   // the desired linear and angular speeds (set by desired track velocities)
-  const auto linearSpeed = (leftBeltSpeed + rightBeltSpeed) / 2;
-  const auto angularSpeed = -(leftBeltSpeed - rightBeltSpeed) *
+  const auto linearSpeed =
+    (drive.leftBeltSpeed + drive.rightBeltSpeed) / 2;
+  const auto angularSpeed =
+    -(drive.leftBeltSpeed - drive.rightBeltSpeed) *
     this->GetSteeringEfficiency() / this->GetTracksSeparation();
 
+  const bool drivingStraight = fabs(angularSpeed) < 0.1;
+
   // radius of the turn the robot is doing
   const auto desiredRotationRadiusSigned =
-                               (fabs(angularSpeed) < 0.1) ?
-                               // is driving straight
-                               dInfinity :
+                               drivingStraight ?
+                               std::numeric_limits<double>::infinity() :
                                (
                                  (fabs(linearSpeed) < 0.1) ?
                                  // is rotating about a single point
@@ -327,155 +408,64 @@ void SimpleTrackedVehiclePlugin::DriveTracks(
   const auto bodyPose = this->body->WorldPose();
   const auto bodyYAxisGlobal =
     bodyPose.Rot().RotateVector(ignition::math::Vector3d(0, 1, 0));
-  const auto centerOfRotation =
+
+  drive.linearSpeed = linearSpeed;
+  drive.angularSpeed = angularSpeed;
+  drive.drivingStraight = drivingStraight;
+  drive.bodyPose = bodyPose;
+  drive.bodyYAxisGlobal = bodyYAxisGlobal;
+  drive.centerOfRotation =
     (bodyYAxisGlobal * desiredRotationRadiusSigned) + bodyPose.Pos();
+}
 
-  ////////////////////////////////////////////////////////////////////////
-  // For each contact, compute the friction force direction and speed of
-  // surface movement.
-  ////////////////////////////////////////////////////////////////////////
-  size_t i = 0;
-  const auto contacts = this->contactManager->GetContacts();
-  const auto model = this->body->GetModel();
+void SimpleTrackedVehiclePlugin::OnTrackContact(const Tracks _side,
+    const physics::Collision *_trackCollision,
+    physics::ContactSurface &_surface) const
+{
+  if (!_surface.collision1->GetLink()->GetEnabled() ||
+    !_surface.collision2->GetLink()->GetEnabled())
+    return;
 
-  for (auto contact : contacts)
+  const auto &drive = Drive(this);
+
+  // speed of the track in collision
+  const double beltSpeed = (_side == Tracks::LEFT) ?
+    drive.leftBeltSpeed : drive.rightBeltSpeed;
+
+  // We always want contactNormal to point "inside" the track.
+  // The dot product is 1 for co-directional vectors and -1 for
+  // opposite-pointing vectors.
+  // The contact can be flipped either by the order of the collisions,
+  // or by having some flipped faces on collision meshes.
+  auto contactNormal = _surface.normal;
+  const double normalToTrackCenterDot =
+    contactNormal.Dot(_trackCollision->WorldPose().Pos() - _surface.position);
+  if (normalToTrackCenterDot < 0)
   {
-    // Beware! There may be invalid contacts beyond GetContactCount()...
-    if (i == this->contactManager->GetContactCount())
-      break;
-
-    ++i;
-
-    if (contact->collision1->GetSurface()->collideWithoutContact ||
-      contact->collision2->GetSurface()->collideWithoutContact)
-      continue;
-
-    if (!contact->collision1->GetLink()->GetEnabled() ||
-      !contact->collision2->GetLink()->GetEnabled())
-      continue;
-
-    if (contact->collision1->IsStatic() && contact->collision2->IsStatic())
-    {
-      // we're not interested in static model collisions
-      // (they do not have any ODE bodies).
-      continue;
-    }
-
-    if (model != contact->collision1->GetLink()->GetModel() &&
-        model != contact->collision2->GetLink()->GetModel())
-    {
-      // Verify one of the collisions' bodies is a track of this vehicle
-      continue;
-    }
-
-    dBodyID body1 = dynamic_cast<physics::ODELink&>(
-      *contact->collision1->GetLink()).GetODEId();
-    dBodyID body2 = dynamic_cast<physics::ODELink& >(
-      *contact->collision2->GetLink()).GetODEId();
-
-    dGeomID geom1 = dynamic_cast<physics::ODECollision& >(
-      *contact->collision1).GetCollisionId();
-    dGeomID geom2 = dynamic_cast<physics::ODECollision& >(
-      *contact->collision2).GetCollisionId();
-
-    bool bodiesSwapped = false;
-    if (body1 == 0)
-    {
-      std::swap(body1, body2);
-      std::swap(geom1, geom2);
-
-      // we'll take care of the normal flipping later
-      bodiesSwapped = true;
-    }
-
-    // determine if track is the first or second collision element
-    const bool isGeom1Track = (dGeomGetCategoryBits(geom1) & BELT_CATEGORY) > 0;
-    const bool isGeom2Track = (dGeomGetCategoryBits(geom2) & BELT_CATEGORY) > 0;
-
-    if (!isGeom1Track && !isGeom2Track)
-      continue;
-
-    // speed and geometry of the track in collision
-    const auto trackGeom = (isGeom1Track ? geom1 : geom2);
-    // the != means XOR here; we basically want to get the collision belonging
-    // to the track, but we might have swapped the ODE bodies in between,
-    // so we have to account for it
-    const physics::Collision* trackCollision =
-      ((isGeom1Track != bodiesSwapped) ? contact->collision1
-                                       : contact->collision2);
-    const dReal beltSpeed =
-      (dGeomGetCategoryBits(trackGeom) & LEFT_CATEGORY) != 0 ?
-      leftBeltSpeed : rightBeltSpeed;
-
-    // remember if we've found at least one contact joint (we should!)
-    bool foundContact = false;
-    for (auto contactIterator = ContactIterator::begin(body1, geom1, geom2);
-         contactIterator != ContactIterator::end();
-         ++contactIterator)
-    {
-      dContact* odeContact = contactIterator.getPointer();
-
-      // now we're sure it is a contact between our two geometries
-      foundContact = true;
-
-      const ignition::math::Vector3d contactWorldPosition(
-        odeContact->geom.pos[0],
-        odeContact->geom.pos[1],
-        odeContact->geom.pos[2]);
-
-      ignition::math::Vector3d contactNormal(
-        odeContact->geom.normal[0],
-        odeContact->geom.normal[1],
-        odeContact->geom.normal[2]);
-
-      // We always want contactNormal to point "inside" the track.
-      // The dot product is 1 for co-directional vectors and -1 for
-      // opposite-pointing vectors.
-      // The contact can be flipped either by swapping body1 and body2 above,
-      // or by having some flipped faces on collision meshes.
-      const double normalToTrackCenterDot =
-        contactNormal.Dot(
-          trackCollision->WorldPose().Pos() - contactWorldPosition);
-      if (normalToTrackCenterDot < 0)
-      {
-        contactNormal = -contactNormal;
-      }
-
-      // vector tangent to the belt pointing in the belt's movement direction
-      auto beltDirection(contactNormal.Cross(bodyYAxisGlobal));
-
-      if (beltSpeed > 0)
-        beltDirection = -beltDirection;
-
-      const auto frictionDirection =
-        this->ComputeFrictionDirection(linearSpeed,
-                                       angularSpeed,
-                                       desiredRotationRadiusSigned == dInfinity,
-                                       bodyPose,
-                                       bodyYAxisGlobal,
-                                       centerOfRotation,
-                                       contactWorldPosition,
-                                       contactNormal,
-                                       beltDirection);
-
-      odeContact->fdir1[0] = frictionDirection.X();
-      odeContact->fdir1[1] = frictionDirection.Y();
-      odeContact->fdir1[2] = frictionDirection.Z();
-
-      // use friction direction and motion1 to simulate the track movement
-      odeContact->surface.mode |= dContactFDir1 | dContactMotion1;
-
-      odeContact->surface.motion1 = this->ComputeSurfaceMotion(
-        beltSpeed, beltDirection, frictionDirection);
-    }
-
-    if (!foundContact)
-    {
-      gzwarn << "No ODE contact joint found for contact " <<
-             contact->DebugString() << std::endl;
-      continue;
-    }
+    contactNormal = -contactNormal;
   }
+
+  // vector tangent to the belt pointing in the belt's movement direction
+  auto beltDirection(contactNormal.Cross(drive.bodyYAxisGlobal));
+
+  if (beltSpeed > 0)
+    beltDirection = -beltDirection;
+
+  const auto frictionDirection =
+    this->ComputeFrictionDirection(drive.linearSpeed,
+                                   drive.angularSpeed,
+                                   drive.drivingStraight,
+                                   drive.bodyPose,
+                                   drive.bodyYAxisGlobal,
+                                   drive.centerOfRotation,
+                                   _surface.position,
+                                   contactNormal,
+                                   beltDirection);
+
+  // use friction direction and motion1 to simulate the track movement
+  _surface.frictionDirection1 = frictionDirection;
+  _surface.motion1 = this->ComputeSurfaceMotion(
+    beltSpeed, beltDirection, frictionDirection);
 }
 
 ignition::math::Vector3d SimpleTrackedVehiclePlugin::ComputeFrictionDirection(
@@ -544,6 +534,10 @@ double SimpleTrackedVehiclePlugin::ComputeSurfaceMotion(const double _beltSpeed,
   return -_beltDirection.Dot(_frictionDirection) * fabs(_beltSpeed);
 }
 
+#ifndef _WIN32
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
 SimpleTrackedVehiclePlugin::ContactIterator
 SimpleTrackedVehiclePlugin::ContactIterator::operator++()
 {
@@ -722,3 +716,6 @@ bool SimpleTrackedVehiclePlugin::ContactIterator::operator!=(
 {
   return !SimpleTrackedVehiclePlugin::ContactIterator::operator==(_rhs);
 }
+#ifndef _WIN32
+# pragma GCC diagnostic pop
+#endif
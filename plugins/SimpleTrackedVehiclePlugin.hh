@@ -97,9 +97,19 @@ namespace gazebo {
     /// \brief Desired velocities of the tracks.
     protected: std::unordered_map<Tracks, double> trackVelocity;
 
-    /// \brief Compute and apply the forces that make the tracks move.
+    /// \brief Compute the desired motion of the vehicle, used by the
+    ///        contacts of the tracks created during this world update.
     protected: void DriveTracks(const common::UpdateInfo &/*_unused*/);
 
+    /// \brief Set the friction direction and surface motion of a contact
+    ///        of a track, right before its contact joint is created.
+    /// \param[in] _side Side of the track.
+    /// \param[in] _trackCollision Collision of the track.
+    /// \param[in,out] _surface Surface of the contact.
+    protected: void OnTrackContact(Tracks _side,
+      const physics::Collision *_trackCollision,
+      physics::ContactSurface &_surface) const;
+
     /// \brief Return the number of tracks on the given side. Should always be
     /// at least 1 for the main track. If flippers are present, the number is
     /// higher.
@@ -159,7 +169,10 @@ namespace gazebo {
 
     /// \class ContactIterator
     /// \brief An iterator over all contacts between two geometries.
-    class ContactIterator : std::iterator<std::input_iterator_tag, dContact>
+    /// \deprecated The contacts of the tracks are edited by their contact
+    /// surface callbacks, see physics::Collision::SetContactSurfaceFunc.
+    public: class GAZEBO_DEPRECATED(11.0) ContactIterator
+      : std::iterator<std::input_iterator_tag, dContact>
     {
       /// \brief The contact to return as the next element.
       private: pointer currentContact;
@@ -91,6 +91,45 @@ TEST_F(LinkTest, StaticWrench)
   EXPECT_EQ(model0->WorldPose(), model0Initial);
 }
 
+/////////////////////////////////////////////////
+// This tests the bulk wrench subscriber of the world
+TEST_F(LinkTest, LinkWrenches)
+{
+  this->Load("test/worlds/static.world");
+
+  auto model0 = this->GetModel("model_0");
+  auto model1 = this->GetModel("model_1");
+  ignition::math::Pose3d model0Initial = model0->WorldPose();
+  ignition::math::Pose3d model1Initial = model1->WorldPose();
+
+  auto wrenchesPub =
+    this->node->Advertise<msgs::LinkWrenches>("~/link_wrenches");
+
+  // One message for both links, the static one is ignored
+  msgs::LinkWrenches msg;
+  for (auto const &model : {model0, model1})
+  {
+    auto linkWrench = msg.add_link_wrench();
+    linkWrench->set_link_name(model->GetLink("link")->GetScopedName());
+    msgs::Set(linkWrench->mutable_wrench()->mutable_force(),
+        ignition::math::Vector3d(0, 10000, 0));
+    msgs::Set(linkWrench->mutable_wrench()->mutable_torque(),
+        ignition::math::Vector3d::Zero);
+  }
+  wrenchesPub->Publish(msg);
+
+  int sleep = 0;
+  int maxSleep = 30;
+  while (model1->WorldPose() == model1Initial && sleep < maxSleep)
+  {
+    common::Time::MSleep(100);
+    sleep++;
+  }
+  EXPECT_NE(model1->WorldPose(), model1Initial);
+  EXPECT_GT(model1->WorldPose().Pos().Y(), model1Initial.Pos().Y());
+  EXPECT_EQ(model0->WorldPose(), model0Initial);
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/physics/ode/ODELink.hh"
+#include "gazebo/physics/ode/ODEPhysics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief The ODE collisions of static models are kept in a separate
+/// index, and so are the spaces whose bodies are all disabled. These tests
+/// check that the contacts found through the indices match the contacts
+/// found by the regular broadphase for the same shapes.
+class PhysicsCollisionSetsTest : public ServerFixture
+{
+  /// \brief Count the contact points between two models, found during the
+  /// last step.
+  /// \param[in] _manager Contact manager.
+  /// \param[in] _model1 Name of the first model.
+  /// \param[in] _model2 Name of the second model.
+  /// \return Number of contact points.
+  public: int ContactCount(physics::ContactManager *_manager,
+              const std::string &_model1, const std::string &_model2);
+
+  /// \brief Step once while recording every contact, and compare the
+  /// contacts of a box lying on a static platform with the contacts of
+  /// the same box lying on a dynamic platform.
+  /// \param[in] _world The world.
+  public: void ExpectSameContacts(physics::WorldPtr _world);
+};
+
+/////////////////////////////////////////////////
+int PhysicsCollisionSetsTest::ContactCount(physics::ContactManager *_manager,
+    const std::string &_model1, const std::string &_model2)
+{
+  int count = 0;
+  const std::vector<physics::Contact *> &contacts = _manager->GetContacts();
+  for (unsigned int i = 0; i < _manager->GetContactCount(); ++i)
+  {
+    const std::string name1 =
+      contacts[i]->collision1->GetLink()->GetModel()->GetName();
+    const std::string name2 =
+      contacts[i]->collision2->GetLink()->GetModel()->GetName();
+    if ((name1 == _model1 && name2 == _model2) ||
+        (name1 == _model2 && name2 == _model1))
+    {
+      count += contacts[i]->count;
+    }
+  }
+  return count;
+}
+
+/////////////////////////////////////////////////
+void PhysicsCollisionSetsTest::ExpectSameContacts(physics::WorldPtr _world)
+{
+  physics::ContactManager *manager =
+    _world->Physics()->GetContactManager();
+
+  const bool neverDrop = manager->NeverDropContacts();
+  manager->SetNeverDropContacts(true);
+  _world->Step(1);
+
+  const int staticCount =
+    this->ContactCount(manager, "static_platform", "static_top");
+  const int dynamicCount =
+    this->ContactCount(manager, "dynamic_platform", "dynamic_top");
+  EXPECT_GT(staticCount, 0);
+  EXPECT_EQ(staticCount, dynamicCount);
+
+  // Static models never collide with each other
+  EXPECT_EQ(this->ContactCount(manager, "static_platform", "static_wall"),
+      0);
+
+  manager->SetNeverDropContacts(neverDrop);
+}
+
+/////////////////////////////////////////////////
+// Drop boxes on a static platform and on a dynamic one, and check that they
+// behave the same, with and without bodies at rest.
+TEST_F(PhysicsCollisionSetsTest, StaticAndResting)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  physics::ContactManager *manager = world->Physics()->GetContactManager();
+  ASSERT_TRUE(manager != nullptr);
+  manager->SetNeverDropContacts(false);
+
+  const ignition::math::Vector3d platformSize(2, 2, 1);
+  SpawnBox("static_platform", platformSize,
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("static_wall", ignition::math::Vector3d(0.2, 2, 2),
+      ignition::math::Vector3d(1, 0, 1), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("static_top", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 1.6));
+  SpawnBox("dynamic_platform", platformSize,
+      ignition::math::Vector3d(5, 0, 0.5));
+  SpawnBox("dynamic_top", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(5, 0, 1.6));
+
+  physics::ModelPtr staticTop = world->ModelByName("static_top");
+  physics::ModelPtr dynamicTop = world->ModelByName("dynamic_top");
+  physics::ModelPtr dynamicPlatform = world->ModelByName("dynamic_platform");
+  ASSERT_TRUE(staticTop != nullptr);
+  ASSERT_TRUE(dynamicTop != nullptr);
+  ASSERT_TRUE(dynamicPlatform != nullptr);
+
+  // Both boxes land on their platform and come to rest
+  world->Step(3000);
+  EXPECT_NEAR(staticTop->WorldPose().Pos().Z(), 1.5, 0.01);
+  EXPECT_NEAR(dynamicTop->WorldPose().Pos().Z(), 1.5, 0.01);
+  EXPECT_FALSE(staticTop->GetLink()->GetEnabled());
+  EXPECT_FALSE(dynamicTop->GetLink()->GetEnabled());
+  this->ExpectSameContacts(world);
+
+  // Moving boxes collide with the resting ones
+  SpawnBox("static_drop", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(0, 0, 3));
+  SpawnBox("dynamic_drop", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(5, 0, 3));
+  world->Step(3000);
+  EXPECT_NEAR(world->ModelByName("static_drop")->WorldPose().Pos().Z(),
+      2.5, 0.02);
+  EXPECT_NEAR(world->ModelByName("dynamic_drop")->WorldPose().Pos().Z(),
+      2.5, 0.02);
+  this->ExpectSameContacts(world);
+
+  // Disable and enable the bodies at run time
+  staticTop->GetLink()->SetEnabled(false);
+  dynamicTop->GetLink()->SetEnabled(false);
+  world->Step(10);
+  this->ExpectSameContacts(world);
+
+  staticTop->GetLink()->SetEnabled(true);
+  dynamicTop->GetLink()->SetEnabled(true);
+  world->Step(10);
+  this->ExpectSameContacts(world);
+
+  // Toggle the dynamic platform static at run time, its space must move
+  // in and out of the static set.
+  physics::ODEPhysicsPtr odePhysics =
+    boost::dynamic_pointer_cast<physics::ODEPhysics>(world->Physics());
+  physics::ODELinkPtr platformLink =
+    boost::dynamic_pointer_cast<physics::ODELink>(dynamicPlatform->GetLink());
+  ASSERT_TRUE(odePhysics != nullptr);
+  ASSERT_TRUE(platformLink != nullptr);
+  dGeomID platformSpace =
+    reinterpret_cast<dGeomID>(platformLink->GetSpaceId());
+
+  EXPECT_NE(dGeomGetSpace(platformSpace), odePhysics->GetStaticSpaceId());
+  dynamicPlatform->SetStatic(true);
+  world->Step(10);
+  EXPECT_EQ(dGeomGetSpace(platformSpace), odePhysics->GetStaticSpaceId());
+  this->ExpectSameContacts(world);
+
+  dynamicPlatform->SetStatic(false);
+  world->Step(1);
+  EXPECT_NE(dGeomGetSpace(platformSpace), odePhysics->GetStaticSpaceId());
+  world->Step(500);
+  this->ExpectSameContacts(world);
+  EXPECT_NEAR(dynamicTop->WorldPose().Pos().Z(), 1.5, 0.01);
+  EXPECT_NEAR(staticTop->WorldPose().Pos().Z(), 1.5, 0.01);
+}
+
+/////////////////////////////////////////////////
+// Move a static model at run time, the static index must follow it.
+TEST_F(PhysicsCollisionSetsTest, MoveStatic)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != nullptr);
+
+  SpawnBox("platform", ignition::math::Vector3d(2, 2, 1),
+      ignition::math::Vector3d(0, 0, 0.5), ignition::math::Vector3d::Zero,
+      true);
+  SpawnBox("box", ignition::math::Vector3d::One,
+      ignition::math::Vector3d(5, 0, 3));
+
+  physics::ModelPtr platform = world->ModelByName("platform");
+  physics::ModelPtr box = world->ModelByName("box");
+  ASSERT_TRUE(platform != nullptr);
+  ASSERT_TRUE(box != nullptr);
+
+  // Move the platform under the falling box
+  platform->SetWorldPose(ignition::math::Pose3d(5, 0, 0.5, 0, 0, 0));
+  world->Step(3000);
+  EXPECT_NEAR(box->WorldPose().Pos().Z(), 1.5, 0.01);
+}
+
+/////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
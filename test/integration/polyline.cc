@@ -18,13 +18,17 @@
 #include "gazebo/physics/physics.hh"
 #include "gazebo/msgs/msgs.hh"
 #include "gazebo/test/helper_physics_generator.hh"
+#include "test/util.hh"
 
 using namespace gazebo;
 class PolylineTest : public ServerFixture,
-                     public testing::WithParamInterface<const char*>
+                     public ::testing::WithParamInterface<const char*>
 {
   public: void ComputeVolume(const std::string &_physicsEngine);
   public: void PolylineWorld(const std::string &_physicsEngine);
+
+  /// \brief Extrude for real, without reusing meshes cached by other runs.
+  private: gazebo::testing::TemporaryMeshCache meshCache;
 };
 
 /////////////////////////////////////////////////
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gazebo/physics/physics.hh"
+#include "gazebo/test/ServerFixture.hh"
+
+using namespace gazebo;
+
+/// \brief Compare the serial PGS solver against the graph colored one.
+class QuickStepColoredRowsTest : public ServerFixture
+{
+  /// \brief Spawn a grid of box stacks, one model per stack.
+  /// \param[in] _columns Number of stacks along x and y.
+  /// \param[in] _height Number of boxes per stack.
+  protected: void SpawnStacks(const unsigned int _columns,
+                              const unsigned int _height);
+
+  /// \brief Spawn robots made of a chain of links connected by revolute
+  /// joints, resting on the ground.
+  /// \param[in] _count Number of robots.
+  /// \param[in] _links Number of links per robot.
+  protected: void SpawnRobots(const unsigned int _count,
+                              const unsigned int _links);
+
+  /// \brief Wait until the world holds a number of models.
+  /// \param[in] _world The world.
+  /// \param[in] _count Expected number of models.
+  protected: void WaitForModels(physics::WorldPtr _world,
+                                const unsigned int _count);
+
+  /// \brief Reset the world and step it with a solver configuration.
+  /// \param[in] _world The world.
+  /// \param[in] _colored True to solve the rows by graph color.
+  /// \param[in] _threads Number of quickstep threads.
+  /// \param[in] _steps Number of steps.
+  /// \param[out] _poses World pose of every link after the last step.
+  /// \return Wall time spent stepping.
+  protected: common::Time Run(physics::WorldPtr _world, const bool _colored,
+                              const int _threads, const unsigned int _steps,
+                              std::vector<ignition::math::Pose3d> &_poses);
+
+  /// \brief Benchmark the solvers and check that the colored solver gives
+  /// the same result for any number of threads and with the deterministic
+  /// SIMD row kernels.
+  /// \param[in] _world The world.
+  /// \param[in] _name Name of the scenario, used in the output.
+  protected: void Compare(physics::WorldPtr _world, const std::string &_name);
+};
+
+/////////////////////////////////////////////////
+void QuickStepColoredRowsTest::SpawnStacks(const unsigned int _columns,
+    const unsigned int _height)
+{
+  const double size = 0.5;
+  for (unsigned int x = 0; x < _columns; ++x)
+  {
+    for (unsigned int y = 0; y < _columns; ++y)
+    {
+      std::ostringstream sdf;
+      sdf << "<sdf version='" << SDF_VERSION << "'>"
+          << "<model name='stack_" << x << "_" << y << "'>"
+          << "<pose>" << x * 2 * size << " " << y * 2 * size
+          << " 0 0 0 0</pose>";
+      for (unsigned int z = 0; z < _height; ++z)
+      {
+        sdf << "<link name='box_" << z << "'>"
+            << "<self_collide>true</self_collide>"
+            << "<pose>0 0 " << size * (z + 0.5) << " 0 0 0</pose>"
+            << "<collision name='collision'><geometry><box>"
+            << "<size>" << size << " " << size << " " << size << "</size>"
+            << "</box></geometry></collision>"
+            << "</link>";
+      }
+      sdf << "</model></sdf>";
+      this->SpawnSDF(sdf.str());
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+void QuickStepColoredRowsTest::SpawnRobots(const unsigned int _count,
+    const unsigned int _links)
+{
+  const double length = 0.4;
+  for (unsigned int r = 0; r < _count; ++r)
+  {
+    std::ostringstream sdf;
+    sdf << "<sdf version='" << SDF_VERSION << "'>"
+        << "<model name='robot_" << r << "'>"
+        << "<pose>" << (r % 4) * 3.0 << " " << (r / 4) * 3.0
+        << " 0 0 0 0</pose>";
+    for (unsigned int l = 0; l < _links; ++l)
+    {
+      sdf << "<link name='link_" << l << "'>"
+          << "<pose>0 0 " << length * (l + 0.5) << " 0 0 0</pose>"
+          << "<collision name='collision'><geometry><box>"
+          << "<size>0.2 0.2 " << length << "</size>"
+          << "</box></geometry></collision>"
+          << "</link>";
+      if (l > 0)
+      {
+        sdf << "<joint name='joint_" << l << "' type='revolute'>"
+            << "<parent>link_" << l - 1 << "</parent>"
+            << "<child>link_" << l << "</child>"
+            << "<pose>0 0 " << -length * 0.5 << " 0 0 0</pose>"
+            << "<axis><xyz>" << l % 2 << " " << (l + 1) % 2 << " 0</xyz>"
+            << "</axis></joint>";
+      }
+    }
+    sdf << "</model></sdf>";
+    this->SpawnSDF(sdf.str());
+  }
+}
+
+/////////////////////////////////////////////////
+void QuickStepColoredRowsTest::WaitForModels(physics::WorldPtr _world,
+    const unsigned int _count)
+{
+  for (int i = 0; i < 100 && _world->ModelCount() < _count; ++i)
+    common::Time::MSleep(100);
+  ASSERT_EQ(_world->ModelCount(), _count);
+}
+
+/////////////////////////////////////////////////
+common::Time QuickStepColoredRowsTest::Run(physics::WorldPtr _world,
+    const bool _colored, const int _threads, const unsigned int _steps,
+    std::vector<ignition::math::Pose3d> &_poses)
+{
+  physics::PhysicsEnginePtr physics = _world->Physics();
+  EXPECT_TRUE(physics->SetParam("colored_rows", _colored));
+  EXPECT_TRUE(physics->SetParam("quickstep_threads", _threads));
+
+  _world->Reset();
+
+  common::Time start = common::Time::GetWallTime();
+  _world->Step(_steps);
+  common::Time elapsed = common::Time::GetWallTime() - start;
+
+  _poses.clear();
+  for (auto const &model : _world->Models())
+  {
+    for (auto const &link : model->GetLinks())
+      _poses.push_back(link->WorldPose());
+  }
+
+  return elapsed;
+}
+
+/////////////////////////////////////////////////
+void QuickStepColoredRowsTest::Compare(physics::WorldPtr _world,
+    const std::string &_name)
+{
+  physics::PhysicsEnginePtr physics = _world->Physics();
+  physics->SetRealTimeUpdateRate(0.0);
+
+  // Joint lambdas are warm started from the previous step and are not
+  // cleared by a world reset, so runs would not start from the same state.
+  EXPECT_TRUE(physics->SetParam("warm_start_factor", 0.0));
+
+  const unsigned int steps = 1000;
+  std::vector<ignition::math::Pose3d> poses;
+  std::vector<ignition::math::Pose3d> reference;
+
+  common::Time serial = this->Run(_world, false, 0, steps, poses);
+  gzdbg << _name << " serial PGS: " << serial.Double() << " s\n";
+
+  common::Time colored = this->Run(_world, true, 0, steps, reference);
+  gzdbg << _name << " colored PGS, no threads: "
+        << colored.Double() << " s\n";
+  EXPECT_EQ(poses.size(), reference.size());
+
+  for (const int threads : {2, 4, 8})
+  {
+    colored = this->Run(_world, true, threads, steps, poses);
+    gzdbg << _name << " colored PGS, " << threads << " threads: "
+          << colored.Double() << " s (" << serial.Double() / colored.Double()
+          << "x)\n";
+
+    // The colored solution must not depend on the number of threads.
+    ASSERT_EQ(poses.size(), reference.size());
+    for (size_t i = 0; i < poses.size(); ++i)
+    {
+      EXPECT_EQ(poses[i].Pos().X(), reference[i].Pos().X());
+      EXPECT_EQ(poses[i].Pos().Y(), reference[i].Pos().Y());
+      EXPECT_EQ(poses[i].Pos().Z(), reference[i].Pos().Z());
+      EXPECT_EQ(poses[i].Rot().W(), reference[i].Rot().W());
+      EXPECT_EQ(poses[i].Rot().X(), reference[i].Rot().X());
+      EXPECT_EQ(poses[i].Rot().Y(), reference[i].Rot().Y());
+      EXPECT_EQ(poses[i].Rot().Z(), reference[i].Rot().Z());
+    }
+  }
+
+  // Deterministic SIMD row kernels must not change the colored solution.
+  EXPECT_TRUE(physics->SetParam("vectorized_rows", true));
+  const std::string kernels =
+      boost::any_cast<std::string>(physics->GetParam("row_kernels"));
+  colored = this->Run(_world, true, 0, steps, poses);
+  gzdbg << _name << " colored PGS, " << kernels << " row kernels: "
+        << colored.Double() << " s (" << serial.Double() / colored.Double()
+        << "x)\n";
+  ASSERT_EQ(poses.size(), reference.size());
+  for (size_t i = 0; i < poses.size(); ++i)
+  {
+    EXPECT_EQ(poses[i].Pos().X(), reference[i].Pos().X());
+    EXPECT_EQ(poses[i].Pos().Y(), reference[i].Pos().Y());
+    EXPECT_EQ(poses[i].Pos().Z(), reference[i].Pos().Z());
+    EXPECT_EQ(poses[i].Rot().W(), reference[i].Rot().W());
+    EXPECT_EQ(poses[i].Rot().X(), reference[i].Rot().X());
+    EXPECT_EQ(poses[i].Rot().Y(), reference[i].Rot().Y());
+    EXPECT_EQ(poses[i].Rot().Z(), reference[i].Rot().Z());
+  }
+
+  EXPECT_TRUE(physics->SetParam("vectorized_rows", false));
+  EXPECT_TRUE(physics->SetParam("colored_rows", false));
+  EXPECT_TRUE(physics->SetParam("quickstep_threads", 0));
+}
+
+/////////////////////////////////////////////////
+TEST_F(QuickStepColoredRowsTest, StackedBoxes)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  const unsigned int initialCount = world->ModelCount();
+  this->SpawnStacks(6, 6);
+  this->WaitForModels(world, initialCount + 36);
+
+  this->Compare(world, "stacked boxes");
+}
+
+/////////////////////////////////////////////////
+TEST_F(QuickStepColoredRowsTest, MultiRobot)
+{
+  Load("worlds/empty.world", true, "ode");
+  physics::WorldPtr world = physics::get_world("default");
+  ASSERT_TRUE(world != NULL);
+
+  const unsigned int initialCount = world->ModelCount();
+  this->SpawnRobots(16, 6);
+  this->WaitForModels(world, initialCount + 16);
+
+  this->Compare(world, "multi robot");
+}
+
+/////////////////////////////////////////////////
+/// Main
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
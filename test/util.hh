@@ -23,6 +23,7 @@
 
 #include <boost/filesystem.hpp>
 #include "gazebo/common/Console.hh"
+#include "gazebo/common/MeshCache.hh"
 
 using namespace gazebo;
 
@@ -85,6 +86,38 @@ namespace gazebo
       /// \brief String with the full path to log directory
       private: std::string logDirectory;
     };
+
+    /// \brief Points the mesh cache to an empty temporary directory for
+    /// the lifetime of the object, so that meshes are extruded for real
+    /// instead of being read from the cache of other runs. Declare it as a
+    /// member of the test fixture, it then outlives the fixture TearDown.
+    class TemporaryMeshCache
+    {
+      /// \brief Constructor.
+      public: TemporaryMeshCache()
+        : previousPath(common::MeshCache::Instance()->Path()),
+          path(boost::filesystem::temp_directory_path() /
+               boost::filesystem::unique_path("gz_mesh_cache_%%%%%%%%"))
+      {
+        common::MeshCache::Instance()->SetPath(this->path.string());
+        common::MeshCache::Instance()->Clear();
+      }
+
+      /// \brief Destructor. Restores the previous cache directory.
+      public: ~TemporaryMeshCache()
+      {
+        common::MeshCache::Instance()->Clear();
+        common::MeshCache::Instance()->SetPath(this->previousPath);
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(this->path, ec);
+      }
+
+      /// \brief Cache directory before this object was created.
+      private: std::string previousPath;
+
+      /// \brief Temporary cache directory.
+      private: boost::filesystem::path path;
+    };
   }
 }
 
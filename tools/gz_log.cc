@@ -21,6 +21,15 @@
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <boost/filesystem.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
 
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
@@ -38,6 +47,31 @@ FilterBase::FilterBase(bool _xmlOutput, const std::string &_stamp)
 {
 }
 
+/////////////////////////////////////////////////
+void FilterBase::SetFields(Fields *_fields)
+{
+  this->fields = _fields;
+}
+
+/////////////////////////////////////////////////
+void FilterBase::AddField(const std::string &_name, const double _value)
+{
+  if (this->fields)
+    this->fields->emplace_back(_name, _value);
+}
+
+/////////////////////////////////////////////////
+bool FilterBase::Compile(const std::string &_part, boost::regex &_regex)
+{
+  if (_part == "*")
+    return false;
+
+  std::string regexStr = _part;
+  boost::replace_all(regexStr, "*", ".*");
+  _regex.assign(regexStr);
+  return true;
+}
+
 /////////////////////////////////////////////////
 std::ostringstream &FilterBase::Out(std::ostringstream &_stream,
     const gazebo::physics::State &_state)
@@ -65,8 +99,11 @@ std::ostringstream &FilterBase::Out(std::ostringstream &_stream,
 std::string FilterBase::FilterPose(const ignition::math::Pose3d &_pose,
     const std::string &_xmlName,
     std::string _filter,
-    const gazebo::physics::State &_state)
+    const gazebo::physics::State &_state,
+    const std::string &_field)
 {
+  const bool addFields = this->fields && !_field.empty();
+
   std::ostringstream result;
   std::string xmlPrefix, xmlSuffix;
 
@@ -104,28 +141,40 @@ std::string FilterBase::FilterPose(const ignition::math::Pose3d &_pose,
         case 'x':
           this->Out(result, _state) << std::fixed
             << _pose.Pos().X() << " ";
+          if (addFields)
+            this->AddField(_field + ".x", _pose.Pos().X());
           break;
         case 'Y':
         case 'y':
           this->Out(result, _state) << std::fixed
             << _pose.Pos().Y() << " ";
+          if (addFields)
+            this->AddField(_field + ".y", _pose.Pos().Y());
           break;
         case 'Z':
         case 'z':
           this->Out(result, _state) << std::fixed
             << _pose.Pos().Z() << " ";
+          if (addFields)
+            this->AddField(_field + ".z", _pose.Pos().Z());
           break;
         case 'R':
         case 'r':
           this->Out(result, _state) << std::fixed << rpy.X() << " ";
+          if (addFields)
+            this->AddField(_field + ".roll", rpy.X());
           break;
         case 'P':
         case 'p':
           this->Out(result, _state) << std::fixed << rpy.Y() << " ";
+          if (addFields)
+            this->AddField(_field + ".pitch", rpy.Y());
           break;
         case 'A':
         case 'a':
           this->Out(result, _state) << std::fixed << rpy.Z() << " ";
+          if (addFields)
+            this->AddField(_field + ".yaw", rpy.Z());
           break;
         default:
           std::cerr << "Invalid pose value[" << *elemIter << "]\n";
@@ -136,6 +185,16 @@ std::string FilterBase::FilterPose(const ignition::math::Pose3d &_pose,
   }
   else
   {
+    if (addFields)
+    {
+      this->AddField(_field + ".x", _pose.Pos().X());
+      this->AddField(_field + ".y", _pose.Pos().Y());
+      this->AddField(_field + ".z", _pose.Pos().Z());
+      this->AddField(_field + ".roll", rpy.X());
+      this->AddField(_field + ".pitch", rpy.Y());
+      this->AddField(_field + ".yaw", rpy.Z());
+    }
+
     // No filter, so output the whole pose.
     if (!xmlPrefix.empty())
     {
@@ -168,11 +227,16 @@ void JointFilter::Init(const std::string &_filter)
     if (this->parts.empty())
       this->parts.push_back(_filter);
   }
+
+  // The first element in the filter must be a joint name or a star.
+  this->matchAll = this->parts.empty() ||
+    !this->Compile(this->parts.front(), this->regex);
 }
 
 /////////////////////////////////////////////////
 std::string JointFilter::FilterParts(gazebo::physics::JointState &_state,
-              std::list<std::string>::iterator _partIter)
+              std::list<std::string>::iterator _partIter,
+              const std::string &_field)
 {
   std::ostringstream result;
   std::string part = *_partIter;
@@ -212,6 +276,9 @@ std::string JointFilter::FilterParts(gazebo::physics::JointState &_state,
         }
         else
           this->Out(result, _state) << std::fixed << angle << " ";
+
+        if (this->fields && !_field.empty())
+          this->AddField(_field + "." + *elemIter, angle);
       }
       catch(...)
       {
@@ -234,18 +301,23 @@ std::string JointFilter::Filter(gazebo::physics::ModelState &_state)
   /// Get an iterator to the list of the command line parts.
   partIter = this->parts.begin();
 
-  // The first element in the filter must be a link name or a star.
-  std::string regexStr = *partIter;
-  boost::replace_all(regexStr, "*", ".*");
-  boost::regex regex(regexStr);
-  states = _state.GetJointStates(regex);
+  // The joint expression was compiled in Init.
+  if (!this->matchAll)
+    states = _state.GetJointStates(this->regex);
+  else
+    states = _state.GetJointStates();
 
-  ++partIter;
+  if (partIter != this->parts.end())
+    ++partIter;
 
   // Filter all the link states that were found.
   for (gazebo::physics::JointState_M::iterator iter =
       states.begin(); iter != states.end(); ++iter)
   {
+    std::string field;
+    if (this->fields)
+      field = _state.GetName() + "::" + iter->first;
+
     // Filter the elements of the joint (angle).
     // If no filter parts were specified,
     // then output the whole joint state.
@@ -254,13 +326,20 @@ std::string JointFilter::Filter(gazebo::physics::ModelState &_state)
       if (this->xmlOutput)
         result << "<joint name='" << iter->first << "'>\n";
 
-      result << this->FilterParts(iter->second, partIter);
+      result << this->FilterParts(iter->second, partIter, field);
 
       if (this->xmlOutput)
         result << "</joint>\n";
     }
     else
     {
+      for (unsigned int i = 0; this->fields &&
+           i < iter->second.GetAngleCount(); ++i)
+      {
+        this->AddField(field + "." + std::to_string(i),
+            iter->second.Position(i));
+      }
+
       if (!this->xmlOutput && iter->second.GetAngleCount() == 1)
         result << std::fixed << iter->second.Position(0);
       else
@@ -289,11 +368,16 @@ void LinkFilter::Init(const std::string &_filter)
     if (this->parts.empty())
       this->parts.push_back(_filter);
   }
+
+  // The first element in the filter must be a link name or a star.
+  this->matchAll = this->parts.empty() ||
+    !this->Compile(this->parts.front(), this->regex);
 }
 
 /////////////////////////////////////////////////
 std::string LinkFilter::FilterParts(gazebo::physics::LinkState &_state,
-              std::list<std::string>::iterator _partIter)
+              std::list<std::string>::iterator _partIter,
+              const std::string &_field)
 {
   std::ostringstream result;
 
@@ -304,24 +388,29 @@ std::string LinkFilter::FilterParts(gazebo::physics::LinkState &_state,
   if (_partIter != this->parts.end())
     elemParts = *_partIter;
 
+  std::string field;
+  if (this->fields && !_field.empty())
+    field = _field + "." + part;
+
   if (part == "pose")
   {
-    result << this->FilterPose(_state.Pose(), part, elemParts, _state);
+    result << this->FilterPose(_state.Pose(), part, elemParts, _state,
+        field);
   }
   else if (part == "acceleration")
   {
     result << this->FilterPose(_state.Acceleration(), part,
-        elemParts, _state);
+        elemParts, _state, field);
   }
   else if (part == "velocity")
   {
     result << this->FilterPose(_state.Velocity(), part, elemParts,
-        _state);
+        _state, field);
   }
   else if (part == "wrench")
   {
     result << this->FilterPose(_state.Wrench(), part, elemParts,
-        _state);
+        _state, field);
   }
 
   return result.str();
@@ -338,18 +427,14 @@ std::string LinkFilter::Filter(gazebo::physics::ModelState &_state)
   /// Get an iterator to the list of the command line parts.
   partIter = this->parts.begin();
 
-  // The first element in the filter must be a link name or a star.
-  if (*partIter != "*")
-  {
-    std::string regexStr = *partIter;
-    boost::replace_all(regexStr, "*", ".*");
-    boost::regex regex(regexStr);
-    states = _state.GetLinkStates(regex);
-  }
+  // The link expression was compiled in Init.
+  if (!this->matchAll)
+    states = _state.GetLinkStates(this->regex);
   else
     states = _state.GetLinkStates();
 
-  ++partIter;
+  if (partIter != this->parts.end())
+    ++partIter;
 
   // Filter all the link states that were found.
   for (gazebo::physics::LinkState_M::iterator iter =
@@ -363,7 +448,11 @@ std::string LinkFilter::Filter(gazebo::physics::ModelState &_state)
       if (this->xmlOutput)
         result << "<link name='" << iter->second.GetName() << "'>\n";
 
-      result << this->FilterParts(iter->second, partIter);
+      std::string field;
+      if (this->fields)
+        field = _state.GetName() + "::" + iter->second.GetName();
+
+      result << this->FilterParts(iter->second, partIter, field);
 
       if (this->xmlOutput)
         result << "</link>\n";
@@ -417,11 +506,16 @@ void ModelFilter::Init(const std::string &_filter)
 
   mainParts.pop_front();
 
+  // The first element in the filter must be a model name or a star.
+  this->matchAll = this->parts.empty() || this->parts.front().empty() ||
+    !this->Compile(this->parts.front(), this->regex);
+
   // Create the link filter
   if (!mainParts.empty() && !mainParts.front().empty())
   {
     this->linkFilter = new LinkFilter(this->xmlOutput, this->stamp);
     this->linkFilter->Init(mainParts.front());
+    this->linkFilter->SetFields(this->fields);
   }
 
   if (mainParts.empty())
@@ -435,6 +529,114 @@ void ModelFilter::Init(const std::string &_filter)
     this->jointFilter = new JointFilter(this->xmlOutput,
         this->stamp);
     this->jointFilter->Init(mainParts.front());
+    this->jointFilter->SetFields(this->fields);
+  }
+}
+
+/////////////////////////////////////////////////
+void ModelFilter::SetFields(Fields *_fields)
+{
+  FilterBase::SetFields(_fields);
+  if (this->linkFilter)
+    this->linkFilter->SetFields(_fields);
+  if (this->jointFilter)
+    this->jointFilter->SetFields(_fields);
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the next <model> tag in a string.
+/// \param[in] _str String to search.
+/// \param[in] _pos Position where to start searching.
+/// \return Position of the tag, std::string::npos if there is none.
+static size_t FindModelTag(const std::string &_str, size_t _pos)
+{
+  static const std::string tag = "<model";
+  while ((_pos = _str.find(tag, _pos)) != std::string::npos)
+  {
+    // Skip longer tag names such as <model_name>
+    const size_t next = _pos + tag.size();
+    if (next < _str.size() &&
+        (std::isspace(static_cast<unsigned char>(_str[next])) ||
+         _str[next] == '>' || _str[next] == '/'))
+    {
+      return _pos;
+    }
+    _pos = next;
+  }
+  return _pos;
+}
+
+/////////////////////////////////////////////////
+void ModelFilter::Prune(std::string &_stateString) const
+{
+  if (this->matchAll)
+    return;
+
+  static const boost::regex nameRegex("name\\s*=\\s*['\"]([^'\"]*)['\"]");
+  static const std::string endTag = "</model>";
+
+  // Inserted models are complete model descriptions, leave them alone.
+  size_t insertStart = _stateString.find("<insertions>");
+  size_t insertEnd = insertStart == std::string::npos ? std::string::npos :
+    _stateString.find("</insertions>", insertStart);
+
+  size_t pos = 0;
+  while ((pos = FindModelTag(_stateString, pos)) != std::string::npos)
+  {
+    if (insertStart != std::string::npos && pos > insertStart &&
+        pos < insertEnd)
+    {
+      pos = insertEnd;
+      continue;
+    }
+
+    const size_t tagEnd = _stateString.find('>', pos);
+    if (tagEnd == std::string::npos)
+      return;
+
+    // Find the end of the model state, which may hold nested models.
+    size_t end = tagEnd + 1;
+    if (_stateString[tagEnd - 1] != '/')
+    {
+      int depth = 1;
+      while (depth > 0)
+      {
+        const size_t open = FindModelTag(_stateString, end);
+        const size_t close = _stateString.find(endTag, end);
+        if (close == std::string::npos)
+          return;
+
+        if (open < close)
+        {
+          end = _stateString.find('>', open);
+          if (_stateString[end - 1] != '/')
+            ++depth;
+          ++end;
+        }
+        else
+        {
+          --depth;
+          end = close + endTag.size();
+        }
+      }
+    }
+
+    // Keep the models selected by the filter.
+    boost::smatch match;
+    const std::string tag = _stateString.substr(pos, tagEnd - pos);
+    if (!boost::regex_search(tag, match, nameRegex) ||
+        boost::regex_match(match[1].str(), this->regex))
+    {
+      pos = end;
+      continue;
+    }
+
+    _stateString.erase(pos, end - pos);
+    if (insertStart != std::string::npos && insertStart > pos)
+    {
+      insertStart -= end - pos;
+      insertEnd -= end - pos;
+    }
   }
 }
 
@@ -457,7 +659,10 @@ std::string ModelFilter::FilterParts(gazebo::physics::ModelState &_state,
       elemParts = *_partIter;
 
     // Output the filtered pose.
-    result << this->FilterPose(pose, "pose", elemParts, _state);
+    std::string field;
+    if (this->fields)
+      field = _state.GetName() + ".pose";
+    result << this->FilterPose(pose, "pose", elemParts, _state, field);
   }
   else
     std::cerr << "Invalid model state component["
@@ -474,19 +679,14 @@ std::string ModelFilter::Filter(gazebo::physics::WorldState &_state)
   gazebo::physics::ModelState_M states;
   std::list<std::string>::iterator partIter = this->parts.begin();
 
-  // The first element in the filter must be a model name or a star.
-  if (partIter != this->parts.end() && !this->parts.empty() &&
-      !(*partIter).empty() && (*partIter) != "*")
-  {
-    std::string regexStr = *partIter;
-    boost::replace_all(regexStr, "*", ".*");
-    boost::regex regex(regexStr);
-    states = _state.GetModelStates(regex);
-  }
+  // The model expression was compiled in Init.
+  if (!this->matchAll)
+    states = _state.GetModelStates(this->regex);
   else
     states = _state.GetModelStates();
 
-  ++partIter;
+  if (partIter != this->parts.end())
+    ++partIter;
 
   // Filter all the model states that were found.
   for (gazebo::physics::ModelState_M::iterator iter =
@@ -533,29 +733,75 @@ StateFilter::StateFilter(bool _xmlOutput, const std::string &_stamp,
 void StateFilter::Init(const std::string &_filter)
 {
   this->filter.Init(_filter);
+  this->filter.SetFields(this->fields);
+}
+
+/////////////////////////////////////////////////
+void StateFilter::SetFields(Fields *_fields)
+{
+  FilterBase::SetFields(_fields);
+  this->filter.SetFields(_fields);
 }
 
 /////////////////////////////////////////////////
 std::string StateFilter::Filter(const std::string &_stateString)
 {
-  gazebo::physics::WorldState state;
+  gazebo::common::Time simTime;
+  std::string result = this->FilterState(_stateString, simTime);
 
-  // Read and parse the state information
-  g_stateSdf->Clear();
-  sdf::readString(_stateString, g_stateSdf);
-  state.Load(g_stateSdf);
+  if (!this->Accept(simTime))
+    return std::string();
 
-  std::ostringstream result;
+  return result;
+}
 
+/////////////////////////////////////////////////
+bool StateFilter::Accept(const gazebo::common::Time &_simTime)
+{
   if (this->hz > 0.0 && this->prevTime != gazebo::common::Time::Zero)
   {
-    if ((state.GetSimTime() - this->prevTime).Double() <
-        1.0 / this->hz)
-    {
-      return result.str();
-    }
+    if ((_simTime - this->prevTime).Double() < 1.0 / this->hz)
+      return false;
+  }
+
+  this->prevTime = _simTime;
+  return true;
+}
+
+/////////////////////////////////////////////////
+std::string StateFilter::FilterState(std::string _stateString,
+    gazebo::common::Time &_simTime)
+{
+  gazebo::physics::WorldState state;
+
+  // Only parse the models that the filter selects
+  this->filter.Prune(_stateString);
+
+  // Read and parse the state information. Every filter has its own
+  // element, so that states can be parsed in parallel.
+  if (!this->stateSdf)
+    this->stateSdf = g_stateSdf->Clone();
+  this->stateSdf->Clear();
+  sdf::readString(_stateString, this->stateSdf);
+  state.Load(this->stateSdf);
+
+  _simTime = state.GetSimTime();
+
+  // The time stamp is the first value of every state
+  if (this->fields)
+  {
+    if (this->stamp == "real")
+      this->AddField("real_time", state.GetRealTime().Double());
+    else if (this->stamp == "wall")
+      this->AddField("wall_time", state.GetWallTime().Double());
+    else if (this->stamp == "iterations")
+      this->AddField("iterations", state.GetIterations());
+    else
+      this->AddField("sim_time", state.GetSimTime().Double());
   }
 
+  std::ostringstream result;
+
   if (this->xmlOutput)
   {
     result << "<sdf version='" << SDF_VERSION << "'>\n"
@@ -587,7 +833,6 @@ std::string StateFilter::Filter(const std::string &_stateString)
   if (this->xmlOutput)
     result << "</state></sdf>\n";
 
-  this->prevTime = state.GetSimTime();
   return result.str();
 }
 
@@ -622,7 +867,12 @@ LogCommand::LogCommand()
      "Valid in conjunction with the output command. See also the "
      "--output argument.")
     ("filter", po::value<std::string>(),
-     "Filter output. Valid only with the echo, step, and output commands");
+     "Filter output. Valid only with the echo, step, and output commands")
+    ("format", po::value<std::string>(),
+     "Output the filtered values as columns, with one row per state. "
+     "Valid values are csv, for the echo and output commands, and "
+     "columns, for the output command, which writes one file of native "
+     "doubles per value into the output directory.");
 }
 
 /////////////////////////////////////////////////
@@ -668,6 +918,21 @@ bool LogCommand::RunImpl()
 
   raw = this->vm.count("raw");
 
+  // Get format
+  std::string format =
+    this->vm.count("format") ? this->vm["format"].as<std::string>() : "";
+  if (!format.empty() && format != "csv" && format != "columns")
+  {
+    std::cerr << "Invalid format[" << format << "]. "
+      << "Use one of: csv, columns.\n";
+    return false;
+  }
+  if (format == "columns" && !this->vm.count("output"))
+  {
+    std::cerr << "The columns format requires an output directory\n";
+    return false;
+  }
+
   if (!this->vm.count("record"))
   {
     // Load the log file
@@ -698,10 +963,10 @@ bool LogCommand::RunImpl()
       this->vm["encoding"].as<std::string>() : "";
 
     this->Output(this->vm["output"].as<std::string>(), filter, raw, stamp, hz,
-        encoding);
+        encoding, format);
   }
   else if (this->vm.count("echo"))
-    this->Echo(filter, raw, stamp, hz);
+    this->Echo(filter, raw, stamp, hz, format);
   else if (this->vm.count("step"))
     this->Step(filter, raw, stamp, hz);
   else if (this->vm.count("record"))
@@ -820,8 +1085,35 @@ void LogCommand::Info(const std::string &_filename)
 /////////////////////////////////////////////////
 void LogCommand::Output(const std::string &_outFilename,
     const std::string &_filter, const bool _raw,
-    const std::string &_stamp, const double _hz, const std::string &_encoding)
+    const std::string &_stamp, const double _hz, const std::string &_encoding,
+    const std::string &_format)
 {
+  if (!_format.empty())
+  {
+    if (!gazebo::util::LogPlay::Instance()->IsOpen())
+    {
+      std::cerr << "No source log file specified. Use the -f command line "
+        << "argument.\n";
+      return;
+    }
+
+    ColumnWriter writer(_format, _outFilename);
+    if (!writer.Valid())
+    {
+      std::cerr << "Unable to write to [" << _outFilename << "].\n";
+      return;
+    }
+
+    this->FilterLog(_filter, false, _stamp, _hz, true,
+        [&](const unsigned int _index, const FilteredState &_state)
+        {
+          if (_index > 0)
+            writer.Write(_state.fields);
+        });
+    writer.Close();
+    return;
+  }
+
   std::ofstream outFile(_outFilename, std::fstream::out | std::ios::binary);
 
   if (!outFile.is_open())
@@ -838,7 +1130,7 @@ void LogCommand::Output(const std::string &_outFilename,
     return;
   }
 
-  std::string stateString, bufferString;
+  std::string bufferString;
 
   std::string encoding = _encoding.empty() ? play->Encoding() : _encoding;
   if (encoding != "txt" && encoding != "zlib" && encoding != "bz2")
@@ -856,29 +1148,25 @@ void LogCommand::Output(const std::string &_outFilename,
     outFile.write(header.c_str(), header.size());
   }
 
-  StateFilter filter(!_raw, _stamp, _hz);
-  filter.Init(_filter);
-
-  unsigned int i = 0;
-  while (play->Step(stateString))
-  {
-    if (i == 0 && !_raw)
-    {
-      this->OutputWriter(outFile, stateString, _raw, encoding);
-    }
-    else
-    {
-      bufferString += filter.Filter(stateString);
-
-      if (i%1000 == 0 && !bufferString.empty())
+  this->FilterLog(_filter, !_raw, _stamp, _hz, false,
+      [&](const unsigned int _index, const FilteredState &_state)
       {
-        this->OutputWriter(outFile, bufferString, _raw, encoding);
-        bufferString.clear();
-      }
-    }
+        if (_index == 0)
+        {
+          // The world description is copied as is
+          if (!_raw)
+            this->OutputWriter(outFile, _state.text, _raw, encoding);
+          return;
+        }
 
-    ++i;
-  }
+        bufferString += _state.text;
+
+        if (_index % 1000 == 0 && !bufferString.empty())
+        {
+          this->OutputWriter(outFile, bufferString, _raw, encoding);
+          bufferString.clear();
+        }
+      });
 
   if (!bufferString.empty())
     this->OutputWriter(outFile, bufferString, _raw, encoding);
@@ -894,44 +1182,117 @@ void LogCommand::Output(const std::string &_outFilename,
 
 /////////////////////////////////////////////////
 void LogCommand::Echo(const std::string &_filter, bool _raw,
-    const std::string &_stamp, double _hz)
+    const std::string &_stamp, double _hz, const std::string &_format)
 {
   gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
-  std::string stateString;
+
+  if (_format == "csv")
+  {
+    ColumnWriter writer(_format, "");
+    this->FilterLog(_filter, false, _stamp, _hz, true,
+        [&](const unsigned int _index, const FilteredState &_state)
+        {
+          if (_index > 0)
+            writer.Write(_state.fields);
+        });
+    writer.Close();
+    return;
+  }
 
   // Output the header
   if (!_raw)
     std::cout << play->Header() << std::endl;
 
-  StateFilter filter(!_raw, _stamp, _hz);
-  filter.Init(_filter);
-
-  unsigned int i = 0;
-  while (play->Step(stateString))
-  {
-    if (i > 0)
-      stateString = filter.Filter(stateString);
-    else if (i == 0 && _raw)
-      stateString.clear();
+  this->FilterLog(_filter, !_raw, _stamp, _hz, false,
+      [&](const unsigned int _index, const FilteredState &_state)
+      {
+        // The world description is only part of the xml output
+        if (_state.text.empty() || (_index == 0 && _raw))
+          return;
 
-    if (!stateString.empty())
-    {
-      if (!_raw)
-        std::cout << "<chunk encoding='txt'><![CDATA[\n";
+        if (!_raw)
+          std::cout << "<chunk encoding='txt'><![CDATA[\n";
 
-      std::cout << stateString;
+        std::cout << _state.text;
 
-      if (!_raw)
-        std::cout << "]]></chunk>\n";
-    }
-
-    ++i;
-  }
+        if (!_raw)
+          std::cout << "]]></chunk>\n";
+      });
 
   if (!_raw)
     std::cout << "</gazebo_log>\n";
 }
 
+/////////////////////////////////////////////////
+void LogCommand::FilterLog(const std::string &_filter,
+    const bool _xmlOutput, const std::string &_stamp, const double _hz,
+    const bool _fields,
+    const std::function<void(const unsigned int,
+      const FilteredState &)> &_callback)
+{
+  gazebo::util::LogPlay *play = gazebo::util::LogPlay::Instance();
+
+  // Number of states read from the log and filtered together
+  const unsigned int batchSize = 512;
+
+  // Every thread filters with its own filter, compiled once
+  tbb::enumerable_thread_specific<std::shared_ptr<StateFilter> > filters(
+      [&]()
+      {
+        std::shared_ptr<StateFilter> filter(
+          new StateFilter(_xmlOutput, _stamp));
+        filter->Init(_filter);
+        return filter;
+      });
+
+  // The output rate depends on the previous state, so it is applied in
+  // log order
+  StateFilter rate(_xmlOutput, _stamp, _hz);
+
+  std::vector<std::string> input(batchSize);
+  std::vector<FilteredState> output(batchSize);
+
+  unsigned int index = 0;
+  bool more = true;
+  while (more)
+  {
+    // Log chunks are decoded while reading
+    unsigned int count = 0;
+    while (count < batchSize && (more = play->Step(input[count])))
+      ++count;
+
+    const unsigned int first = index;
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, count),
+        [&](const tbb::blocked_range<unsigned int> &_r)
+        {
+          StateFilter &filter = *filters.local();
+          for (unsigned int i = _r.begin(); i != _r.end(); ++i)
+          {
+            FilteredState &state = output[i];
+            state.fields.clear();
+
+            if (first + i == 0)
+            {
+              state.text = input[i];
+              continue;
+            }
+
+            filter.SetFields(_fields ? &state.fields : nullptr);
+            state.text = filter.FilterState(std::move(input[i]),
+                state.simTime);
+          }
+        });
+
+    for (unsigned int i = 0; i < count; ++i, ++index)
+    {
+      if (index > 0 && !rate.Accept(output[i].simTime))
+        continue;
+
+      _callback(index, output[i]);
+    }
+  }
+}
+
 /////////////////////////////////////////////////
 void LogCommand::Step(const std::string &_filter, bool _raw,
     const std::string &_stamp, double _hz)
@@ -1119,3 +1480,170 @@ void LogCommand::OutputWriter(std::ofstream &_outFile,
     _outFile.write(_stateString.c_str(), _stateString.size());
   }
 }
+
+/////////////////////////////////////////////////
+/// \brief Get the name of the file of a column.
+/// \param[in] _name Name of the column.
+/// \param[in] _index Index of the column.
+/// \return File name, which only uses portable characters.
+static std::string ColumnFilename(const std::string &_name,
+    const size_t _index)
+{
+  std::string filename = _name;
+  for (auto &c : filename)
+  {
+    if (!std::isalnum(static_cast<unsigned char>(c)) &&
+        c != '.' && c != '_' && c != '-')
+    {
+      c = '_';
+    }
+  }
+  return filename + "." + std::to_string(_index) + ".f64";
+}
+
+/////////////////////////////////////////////////
+ColumnWriter::ColumnWriter(const std::string &_format,
+    const std::string &_path)
+  : format(_format), path(_path)
+{
+  if (this->format == "csv" && !this->path.empty())
+  {
+    this->csvFile.open(this->path, std::fstream::out | std::fstream::trunc);
+  }
+  else if (this->format == "columns")
+  {
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(this->path, ec);
+  }
+}
+
+/////////////////////////////////////////////////
+ColumnWriter::~ColumnWriter()
+{
+  this->Close();
+}
+
+/////////////////////////////////////////////////
+bool ColumnWriter::Valid() const
+{
+  if (this->format == "csv")
+    return this->path.empty() || this->csvFile.is_open();
+  else if (this->format == "columns")
+    return boost::filesystem::is_directory(this->path);
+
+  return false;
+}
+
+/////////////////////////////////////////////////
+void ColumnWriter::Write(const FilterBase::Fields &_fields)
+{
+  if (this->closed)
+    return;
+
+  // The first state sets the columns
+  if (this->names.empty())
+  {
+    if (_fields.empty())
+      return;
+
+    std::ostream &out = this->csvFile.is_open() ?
+      static_cast<std::ostream &>(this->csvFile) : std::cout;
+
+    for (auto const &field : _fields)
+    {
+      if (this->format == "csv")
+      {
+        out << (this->names.empty() ? "" : ",") << field.first;
+      }
+      else
+      {
+        this->columnFiles.emplace_back(new std::ofstream(
+            (boost::filesystem::path(this->path) /
+             ColumnFilename(field.first, this->names.size())).string(),
+            std::fstream::out | std::fstream::trunc | std::ios::binary));
+      }
+      this->names.push_back(field.first);
+    }
+
+    if (this->format == "csv")
+      out << "\n";
+  }
+
+  // Values usually come in the same order as the columns
+  std::vector<double> row(this->names.size(),
+      std::numeric_limits<double>::quiet_NaN());
+  for (size_t i = 0; i < _fields.size(); ++i)
+  {
+    size_t column = i;
+    if (i >= this->names.size() || this->names[i] != _fields[i].first)
+    {
+      column = std::find(this->names.begin(), this->names.end(),
+          _fields[i].first) - this->names.begin();
+    }
+
+    if (column < row.size())
+      row[column] = _fields[i].second;
+    else
+      this->dropped = true;
+  }
+
+  if (this->format == "csv")
+  {
+    std::ostream &out = this->csvFile.is_open() ?
+      static_cast<std::ostream &>(this->csvFile) : std::cout;
+
+    std::ios_base::fmtflags flags = out.flags();
+    out.setf(std::ios::fixed);
+    for (size_t i = 0; i < row.size(); ++i)
+      out << (i == 0 ? "" : ",") << row[i];
+    out << "\n";
+    out.flags(flags);
+  }
+  else
+  {
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+      this->columnFiles[i]->write(reinterpret_cast<const char *>(&row[i]),
+          sizeof(double));
+    }
+  }
+
+  ++this->rows;
+}
+
+/////////////////////////////////////////////////
+void ColumnWriter::Close()
+{
+  if (this->closed)
+    return;
+  this->closed = true;
+
+  if (this->format == "csv")
+  {
+    if (this->csvFile.is_open())
+      this->csvFile.close();
+    else
+      std::cout.flush();
+  }
+  else
+  {
+    this->columnFiles.clear();
+
+    // Index of the column files, one line per column
+    std::ofstream index(
+        (boost::filesystem::path(this->path) / "columns.txt").string());
+    index << "# rows: " << this->rows << "\n"
+      << "# type: float64, native byte order\n";
+    for (size_t i = 0; i < this->names.size(); ++i)
+    {
+      index << ColumnFilename(this->names[i], i) << " " << this->names[i]
+        << "\n";
+    }
+  }
+
+  if (this->dropped)
+  {
+    std::cerr << "Some values were not part of the first state and were "
+      << "not written.\n";
+  }
+}
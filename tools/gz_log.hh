@@ -17,8 +17,15 @@
 #ifndef GAZEBO_TOOLS_GZLOG_HH_
 #define GAZEBO_TOOLS_GZLOG_HH_
 
+#include <fstream>
+#include <functional>
 #include <string>
 #include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/regex.hpp>
 
 #include <gazebo/physics/WorldState.hh>
 #include "gz.hh"
@@ -34,6 +41,18 @@ namespace gazebo
     /// Valid values are (sim,real,wall)
     public: FilterBase(bool _xmlOutput, const std::string &_stamp);
 
+    /// \brief Destructor
+    public: virtual ~FilterBase() = default;
+
+    /// \brief Named values output by a filter, in output order.
+    public: typedef std::vector<std::pair<std::string, double> > Fields;
+
+    /// \brief Set the list that receives the named values output by the
+    /// filter, in addition to the filtered string. The values are used
+    /// by the csv and columns output formats.
+    /// \param[in] _fields List of values, null to disable.
+    public: virtual void SetFields(Fields *_fields);
+
     /// \brief Output a line of data.
     /// \param[in] _stream The output stream.
     /// \param[in] _state Current state.
@@ -46,15 +65,33 @@ namespace gazebo
     /// \param[in] _xmlName Name of the xml tag.
     /// \param[in] _filter The filter string [x,y,z,r,p,a].
     /// \param[in] _state Current state.
+    /// \param[in] _field Name prefix of the pose values in the field list.
     /// \return Filtered pose string.
     public: std::string FilterPose(const ignition::math::Pose3d &_pose,
                 const std::string &_xmlName,
                 std::string _filter,
-                const gazebo::physics::State &_state);
+                const gazebo::physics::State &_state,
+                const std::string &_field = "");
+
+    /// \brief Add a value to the field list, if there is one.
+    /// \param[in] _name Name of the value.
+    /// \param[in] _value The value.
+    protected: void AddField(const std::string &_name, const double _value);
+
+    /// \brief Compile the name part of a filter, where '*' matches any
+    /// sequence of characters.
+    /// \param[in] _part Name part of the filter.
+    /// \param[out] _regex Compiled expression.
+    /// \return False if the part matches every name.
+    protected: static bool Compile(const std::string &_part,
+                   boost::regex &_regex);
 
     /// \brief True if XML output is requested.
     protected: bool xmlOutput;
 
+    /// \brief List that receives the output values, may be null.
+    protected: Fields *fields = nullptr;
+
     /// \brief Time stamp type
     protected: std::string stamp;
   };
@@ -75,9 +112,11 @@ namespace gazebo
     /// \brief Filter joint parts (angle)
     /// \param[in] _state Link state to filter.
     /// \param[in] _partIter Iterator to the filtered string parts.
+    /// \param[in] _field Name prefix of the values in the field list.
     /// \return Filtered joint string.
     public: std::string FilterParts(gazebo::physics::JointState &_state,
-                std::list<std::string>::iterator _partIter);
+                std::list<std::string>::iterator _partIter,
+                const std::string &_field = "");
 
     /// \brief Filter the joints in a Model state, and output the result
     /// as a string.
@@ -87,6 +126,12 @@ namespace gazebo
 
     /// \brief The list of filter strings.
     public: std::list<std::string> parts;
+
+    /// \brief Expression that selects the joints, compiled once.
+    private: boost::regex regex;
+
+    /// \brief True if every joint is selected.
+    private: bool matchAll = true;
   };
 
   /// \brief Filter for link state.
@@ -105,9 +150,11 @@ namespace gazebo
     /// \brief Filter link parts (pose, velocity, acceleration, wrench)
     /// \param[in] _state Link state to filter.
     /// \param[in] _partIter Iterator to the filtered string parts.
+    /// \param[in] _field Name prefix of the values in the field list.
     /// \return Filtered string
     public: std::string FilterParts(gazebo::physics::LinkState &_state,
-                std::list<std::string>::iterator _partIter);
+                std::list<std::string>::iterator _partIter,
+                const std::string &_field = "");
 
     /// \brief Filter the links in a Model state, and output the result
     /// as a string.
@@ -117,6 +164,12 @@ namespace gazebo
 
     /// \brief The list of filter strings.
     public: std::list<std::string> parts;
+
+    /// \brief Expression that selects the links, compiled once.
+    private: boost::regex regex;
+
+    /// \brief True if every link is selected.
+    private: bool matchAll = true;
   };
 
   /// \brief Filter for model state.
@@ -135,6 +188,14 @@ namespace gazebo
     /// \param[in] _filter The command line filter string.
     public: void Init(const std::string &_filter);
 
+    // Documentation inherited
+    public: virtual void SetFields(Fields *_fields);
+
+    /// \brief Remove from a state string the models that the filter
+    /// doesn't select, so that only the selected models are parsed.
+    /// \param[in,out] _stateString The state string.
+    public: void Prune(std::string &_stateString) const;
+
     /// \brief Filter model parts (pose)
     /// \param[in] _state Model state to filter.
     /// \param[in] _partIter Iterator to the filtered string parts.
@@ -156,6 +217,12 @@ namespace gazebo
 
     /// \brief Pointer to the joint filter.
     public: JointFilter *jointFilter;
+
+    /// \brief Expression that selects the models, compiled once.
+    private: boost::regex regex;
+
+    /// \brief True if every model is selected.
+    private: bool matchAll = true;
   };
 
   /// \brief Filter interface for an entire state.
@@ -172,11 +239,29 @@ namespace gazebo
     /// \param[_in] _filter The filter parameters
     public: void Init(const std::string &_filter);
 
+    // Documentation inherited
+    public: virtual void SetFields(Fields *_fields);
+
     /// \brief Perform filtering
     /// \param[in] _stateString The string to filter.
     /// \return Filtered string
     public: std::string Filter(const std::string &_stateString);
 
+    /// \brief Filter a state without applying the output rate. Filters
+    /// don't share any data, so different filters can be used from
+    /// different threads.
+    /// \param[in] _stateString The string to filter.
+    /// \param[out] _simTime Simulation time of the state.
+    /// \return Filtered string
+    public: std::string FilterState(std::string _stateString,
+                gazebo::common::Time &_simTime);
+
+    /// \brief Apply the output rate to a filtered state. States must be
+    /// passed in log order.
+    /// \param[in] _simTime Simulation time of the state.
+    /// \return True if the state should be output.
+    public: bool Accept(const gazebo::common::Time &_simTime);
+
     /// \brief Filter for a model.
     private: ModelFilter filter;
 
@@ -185,6 +270,75 @@ namespace gazebo
 
     /// \brief Previous time a state was output.
     private: gazebo::common::Time prevTime;
+
+    /// \brief Element used to parse the states.
+    private: sdf::ElementPtr stateSdf;
+  };
+
+  /// \brief Result of filtering one state of a log file.
+  class FilteredState
+  {
+    /// \brief Filtered string.
+    public: std::string text;
+
+    /// \brief Values output by the filter.
+    public: FilterBase::Fields fields;
+
+    /// \brief Simulation time of the state.
+    public: gazebo::common::Time simTime;
+  };
+
+  /// \brief Writes the values of filtered states as columns, either as a
+  /// csv table or as one file of native doubles per value, which analysis
+  /// scripts can map directly into arrays. The columns are set by the
+  /// first state; later values with a new name are dropped and missing
+  /// values are written as NaN.
+  class ColumnWriter
+  {
+    /// \brief Constructor
+    /// \param[in] _format Output format, csv or columns.
+    /// \param[in] _path Output file for csv, empty for the standard
+    /// output. Output directory for columns.
+    public: ColumnWriter(const std::string &_format,
+                const std::string &_path);
+
+    /// \brief Destructor. Closes the output.
+    public: virtual ~ColumnWriter();
+
+    /// \brief Check that the output can be written.
+    /// \return True if the output is valid.
+    public: bool Valid() const;
+
+    /// \brief Write the values of one state.
+    /// \param[in] _fields The values.
+    public: void Write(const FilterBase::Fields &_fields);
+
+    /// \brief Write the values in memory and the column index.
+    public: void Close();
+
+    /// \brief Output format.
+    private: std::string format;
+
+    /// \brief Output path.
+    private: std::string path;
+
+    /// \brief Column names.
+    private: std::vector<std::string> names;
+
+    /// \brief Csv output file.
+    private: std::ofstream csvFile;
+
+    /// \brief Output files of the columns format, one per column.
+    private: std::vector<std::unique_ptr<std::ofstream> > columnFiles;
+
+    /// \brief Number of rows written.
+    private: uint64_t rows = 0;
+
+    /// \brief True if some values were dropped.
+    private: bool dropped = false;
+
+    /// \brief True once closed.
+    private: bool closed = false;
   };
 
   /// \brief Log command
@@ -217,10 +371,13 @@ namespace gazebo
     /// \param[in] _encoding Specify output log file encoding. If empty, the
     /// encoding from the source log file is used.
     /// Valid values include (txt, zlib, bz2)
+    /// \param[in] _format Output format: empty for a log or raw file,
+    /// csv or columns.
     private: void Output(const std::string &_outFilename,
                  const std::string &_filter, const bool _raw,
                  const std::string &_stamp, const double _hz,
-                 const std::string &_encoding = "");
+                 const std::string &_encoding = "",
+                 const std::string &_format = "");
 
     /// \brief Dump the contents of a log file to screen
     /// \param[in] _filter Filter string
@@ -228,8 +385,29 @@ namespace gazebo
     /// \param[in] _stamp Type of stamp to apply.
     /// Valid values are (sim,real,wall)
     /// \param[in] _hz Hertz rate.
+    /// \param[in] _format Output format: empty for xml or raw text, or
+    /// csv.
     private: void Echo(const std::string &_filter,
-                 bool _raw, const std::string &_stamp, double _hz);
+                 bool _raw, const std::string &_stamp, double _hz,
+                 const std::string &_format = "");
+
+    /// \brief Filter the states of the open log file and hand them in log
+    /// order to a callback. States are read in batches and each batch is
+    /// filtered in parallel. The first entry of the log, the world
+    /// description, is handed unfiltered.
+    /// \param[in] _filter Filter string
+    /// \param[in] _xmlOutput True to format output as XML
+    /// \param[in] _stamp Type of stamp to apply.
+    /// \param[in] _hz Hertz rate.
+    /// \param[in] _fields True to also collect the values of the states.
+    /// \param[in] _callback Function called with the index of each log
+    /// entry and its filtered state. States dropped by the rate filter are
+    /// not handed out.
+    private: void FilterLog(const std::string &_filter,
+                 const bool _xmlOutput, const std::string &_stamp,
+                 const double _hz, const bool _fields,
+                 const std::function<void(const unsigned int,
+                   const FilteredState &)> &_callback);
 
     /// \brief Step through a log file.
     /// \param[in] _filter Filter string
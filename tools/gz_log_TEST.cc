@@ -24,6 +24,9 @@
 #include <sdf/sdf_config.h>
 
 #include <stdio.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
 #include <string>
 
 // This header file isn't needed if shasums are used
@@ -331,6 +334,56 @@ TEST(gz_log, RawFilterStamp)
   EXPECT_EQ(validEcho, echo);
 }
 
+/////////////////////////////////////////////////
+/// Check the csv and columns output formats
+TEST(gz_log, Format)
+{
+  // Csv to the standard output
+  std::string echo = custom_exec(std::string(GZ_LOG_PATH +
+        " --echo --format csv --filter pr2.pose.x -f ") +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+  boost::trim_right(echo);
+  EXPECT_EQ("sim_time,pr2.pose.x\n0.021344,0.000000\n0.028958,0.000000",
+      echo);
+
+  // Stamps and the rate filter apply to the rows
+  echo = custom_exec(std::string(GZ_LOG_PATH +
+        " --echo --format csv --stamp real -z 1.0 --filter pr2.pose.z -f ") +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+  boost::trim_right(echo);
+  EXPECT_EQ("real_time,pr2.pose.z\n0.001000,-0.000008", echo);
+
+  // Models that the filter doesn't select are not output
+  echo = custom_exec(std::string(GZ_LOG_PATH +
+        " --echo --format csv --filter no_model.pose.x -f ") +
+      PROJECT_SOURCE_PATH + "/test/data/pr2_state.log");
+  boost::trim_right(echo);
+  EXPECT_EQ("sim_time\n0.021344\n0.028958", echo);
+
+  // One file of doubles per value
+  std::ostringstream dir;
+  dir << "/tmp/__gz_log_columns" << std::this_thread::get_id();
+  custom_exec(std::string(GZ_LOG_PATH + " --format columns -o ") +
+      dir.str() + " --filter pr2.pose.x,y -f " + PROJECT_SOURCE_PATH +
+      "/test/data/pr2_state.log");
+
+  std::ifstream index(dir.str() + "/columns.txt");
+  ASSERT_TRUE(index.is_open());
+  std::string indexStr((std::istreambuf_iterator<char>(index)),
+      std::istreambuf_iterator<char>());
+  EXPECT_NE(indexStr.find("# rows: 2"), std::string::npos);
+  EXPECT_NE(indexStr.find("sim_time.0.f64 sim_time"), std::string::npos);
+  EXPECT_NE(indexStr.find("pr2.pose.y.2.f64 pr2.pose.y"), std::string::npos);
+
+  std::ifstream column(dir.str() + "/sim_time.0.f64", std::ios::binary);
+  ASSERT_TRUE(column.is_open());
+  double values[2] = {0, 0};
+  column.read(reinterpret_cast<char *>(values), sizeof(values));
+  EXPECT_TRUE(column.good());
+  EXPECT_NEAR(values[0], 0.021344, 1e-6);
+  EXPECT_NEAR(values[1], 0.028958, 1e-6);
+}
+
 /////////////////////////////////////////////////
 /// Check to make sure that 'gz log -s' returns correct information
 TEST(gz_log, Step)
@@ -14,6 +14,11 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
 #include <google/protobuf/text_format.h>
 
 #include <gazebo/gui/qt.h>
@@ -52,11 +57,14 @@ TopicCommand::TopicCommand()
      "View topic data using a QT widget.")
     ("hz,z", po::value<std::string>(), "Get publish frequency.")
     ("bw,b", po::value<std::string>(), "Get topic bandwidth.")
+    ("stats,s", po::value<std::string>()->implicit_value(""),
+     "Get the transport statistics of the server, optionally for a single "
+     "topic.")
     ("publish,p", po::value<std::string>(), "Publish message on a topic.")
     ("request,r", po::value<std::string>(), "Send a request.")
     ("unformatted,u", "Output data from echo without formatting.")
     ("duration,d", po::value<uint64_t>(), "Duration (seconds) to run. "
-     "Applicable with echo, hz, and bw")
+     "Applicable with echo, hz, bw and stats")
     ("msg,m", po::value<std::string>(), "Message to send on topic. "
      "Applicable with publish and request")
     ("file,f", po::value<std::string>(), "Path to a file containing the "
@@ -96,6 +104,8 @@ bool TopicCommand::RunImpl()
     this->Hz(this->vm["hz"].as<std::string>());
   else if (this->vm.count("bw"))
     this->Bw(this->vm["bw"].as<std::string>());
+  else if (this->vm.count("stats"))
+    this->Stats(worldName, this->vm["stats"].as<std::string>());
   else if (this->vm.count("view"))
     this->View(this->vm["view"].as<std::string>());
   else if (this->vm.count("publish"))
@@ -347,6 +357,141 @@ void TopicCommand::Bw(const std::string &_topic)
     this->sigCondition.wait(lock);
 }
 
+/////////////////////////////////////////////////
+/// \brief Get a latency percentile from the difference of two latency
+/// histograms of msgs::TopicStatistics.
+/// \param[in] _msg Latest statistics of the topic.
+/// \param[in] _prev Previous statistics of the topic, or nullptr.
+/// \param[in] _fraction Percentile in [0, 1].
+/// \return Upper bound of the bucket holding the percentile in
+/// microseconds, negative if no message was published.
+static double LatencyPercentile(const msgs::TopicStatistics::Topic &_msg,
+    const msgs::TopicStatistics::Topic *_prev, const double _fraction)
+{
+  std::vector<uint64_t> counts(_msg.latency_size(), 0);
+  uint64_t total = 0;
+  for (int i = 0; i < _msg.latency_size(); ++i)
+  {
+    counts[i] = _msg.latency(i);
+    if (_prev && i < _prev->latency_size())
+      counts[i] -= _prev->latency(i);
+    total += counts[i];
+  }
+
+  uint64_t sum = 0;
+  for (size_t i = 0; i < counts.size() && total > 0; ++i)
+  {
+    sum += counts[i];
+    if (sum >= _fraction * total)
+      return std::pow(2.0, static_cast<double>(i));
+  }
+
+  return -1;
+}
+
+/////////////////////////////////////////////////
+bool TopicCommand::Stats(const std::string &_space,
+    const std::string &_topic)
+{
+  // Rates are computed from two samples of the cumulative counters.
+  uint64_t period = 1;
+  if (this->vm.count("duration"))
+    period = std::max(static_cast<uint64_t>(1),
+        this->vm["duration"].as<uint64_t>());
+
+  msgs::TopicStatistics samples[2];
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    if (i > 0)
+      common::Time::Sleep(common::Time(static_cast<int32_t>(period), 0));
+
+    boost::shared_ptr<msgs::Response> response = gazebo::transport::request(
+        _space, "topic_stats", "", gazebo::common::Time(10, 0));
+
+    if (!response || response->type() != samples[i].GetTypeName())
+    {
+      std::cerr << "Unable to get the transport statistics.\n";
+      return false;
+    }
+    samples[i].ParseFromString(response->serialized_data());
+  }
+
+  const msgs::TopicStatistics &prev = samples[0];
+  const msgs::TopicStatistics &curr = samples[1];
+  double dt = (msgs::Convert(curr.stamp()) -
+      msgs::Convert(prev.stamp())).Double();
+  if (dt <= 0)
+    dt = static_cast<double>(period);
+
+  std::map<std::string, const msgs::TopicStatistics::Topic *> prevTopics;
+  for (int i = 0; i < prev.topic_size(); ++i)
+    prevTopics[prev.topic(i).topic()] = &prev.topic(i);
+
+  printf("%-48s %9s %10s %7s %9s %9s %9s %9s\n", "Topic", "Msg/s",
+      "KB/s", "Queue", "Dropped/s", "Ser(us)", "p50(us)", "p99(us)");
+
+  for (int i = 0; i < curr.topic_size(); ++i)
+  {
+    const msgs::TopicStatistics::Topic &topic = curr.topic(i);
+    if (!_topic.empty() &&
+        topic.topic() != this->node->DecodeTopicName(_topic))
+    {
+      continue;
+    }
+
+    auto iter = prevTopics.find(topic.topic());
+    const msgs::TopicStatistics::Topic *old =
+      iter != prevTopics.end() ? iter->second : nullptr;
+
+    uint64_t published = topic.published() - (old ? old->published() : 0);
+    uint64_t received = topic.received() - (old ? old->received() : 0);
+    uint64_t bytes = topic.sent_bytes() + topic.received_bytes() -
+      (old ? old->sent_bytes() + old->received_bytes() : 0);
+    uint64_t dropped = topic.dropped() - (old ? old->dropped() : 0);
+    double serialize = topic.serialize_time() -
+      (old ? old->serialize_time() : 0);
+
+    printf("%-48s %9.1f %10.2f %3u/%-3u %9.1f %9.2f %9.0f %9.0f\n",
+        topic.topic().c_str(), (published + received) / dt,
+        bytes / dt / 1024.0, topic.queue_depth(), topic.max_queue_depth(),
+        dropped / dt,
+        published > 0 ? serialize * 1e6 / published : 0.0,
+        LatencyPercentile(topic, old, 0.5),
+        LatencyPercentile(topic, old, 0.99));
+  }
+
+  if (!_topic.empty())
+    return true;
+
+  std::map<std::string, const msgs::TopicStatistics::Connection *> prevConns;
+  for (int i = 0; i < prev.connection_size(); ++i)
+  {
+    auto const &conn = prev.connection(i);
+    prevConns[conn.local_uri() + conn.remote_uri()] = &conn;
+  }
+
+  printf("\n%-48s %9s %10s %9s %10s %7s\n", "Connection", "Sent/s",
+      "KB/s out", "Recv/s", "KB/s in", "Queue");
+  for (int i = 0; i < curr.connection_size(); ++i)
+  {
+    auto const &conn = curr.connection(i);
+    auto iter = prevConns.find(conn.local_uri() + conn.remote_uri());
+    const msgs::TopicStatistics::Connection *old =
+      iter != prevConns.end() ? iter->second : nullptr;
+
+    printf("%-48s %9.1f %10.2f %9.1f %10.2f %7u\n",
+        conn.remote_uri().c_str(),
+        (conn.sent() - (old ? old->sent() : 0)) / dt,
+        (conn.sent_bytes() - (old ? old->sent_bytes() : 0)) / dt / 1024.0,
+        (conn.received() - (old ? old->received() : 0)) / dt,
+        (conn.received_bytes() - (old ? old->received_bytes() : 0)) / dt /
+        1024.0,
+        conn.write_queue_depth());
+  }
+
+  return true;
+}
+
 /////////////////////////////////////////////////
 void TopicCommand::View(const std::string &_topic)
 {
@@ -72,6 +72,15 @@ namespace gazebo
     /// \param[in] _topic Topic name.
     private: void Bw(const std::string &_topic);
 
+    /// \brief Output the transport statistics of the server: message and
+    /// byte rates, queue depths, drop rates, serialization time and publish
+    /// latency of each topic, and the traffic of each connection.
+    /// \param[in] _space Namespace of all topics.
+    /// \param[in] _topic Only output this topic, empty for all the topics
+    /// and connections.
+    /// \return True on success
+    private: bool Stats(const std::string &_space, const std::string &_topic);
+
     /// \brief View topic information using QT.
     /// \param[in] _topic Name of the topic to view. Empty will bring up
     /// a topic selector.